@@ -11,17 +11,123 @@
 #include "my/serialization/runtime_value_builder.h"
 #include "my/utils/functor.h"
 
+#include <atomic>
 #include <filesystem>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <shared_mutex>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <type_traits>
 
 namespace my {
-    
+
+struct PropertySnapshotNode;
+
+/**
+    @brief Immutable copy of the properties made at the moment of the snapshot publication.
+        Can be read from any thread without locking. Unchanged sections are shared between the subsequent snapshots.
+        String values are stored already expanded (with the variables resolved).
+ */
+class MY_KERNEL_EXPORT PropertySnapshot
+{
+public:
+    PropertySnapshot(std::shared_ptr<const PropertySnapshotNode> root, uint64_t version);
+
+    /**
+        @brief container's version the snapshot was made from (see PropertyContainer::getVersion)
+    */
+    uint64_t getVersion() const;
+
+    /**
+        @brief checks the property at path exists within snapshot
+    */
+    bool contains(std::string_view path) const;
+
+    /**
+        @brief get property at path as read-only runtime value
+        @return value as RuntimeValue or null if property does not exists
+    */
+    RuntimeValuePtr getRead(std::string_view path, IAllocator* allocator = nullptr) const;
+
+    /**
+        @brief getting typed value
+     */
+    template <RuntimeValueRepresentable T>
+    requires(std::is_default_constructible_v<T>)
+    std::optional<T> getValue(std::string_view path) const;
+
+    /**
+        @brief root node, used by the container to make the next snapshot (sharing the unchanged nodes)
+    */
+    const std::shared_ptr<const PropertySnapshotNode>& getRoot() const;
+
+private:
+    const std::shared_ptr<const PropertySnapshotNode> m_root;
+    const uint64_t m_version;
+};
+
+using PropertySnapshotPtr = std::shared_ptr<const PropertySnapshot>;
+
+/**
+    @brief Shared mutex that knows the thread holding the exclusive lock.
+        The modification lock is released by the caller of PropertyContainer::getModify(),
+        so the container checks the ownership before locking (the same thread must not lock it again).
+ */
+class PropertyContainerMutex
+{
+public:
+    void lock()
+    {
+        m_mutex.lock();
+        m_exclusiveOwner.store(std::this_thread::get_id(), std::memory_order_release);
+    }
+
+    bool try_lock()
+    {
+        if (!m_mutex.try_lock())
+        {
+            return false;
+        }
+
+        m_exclusiveOwner.store(std::this_thread::get_id(), std::memory_order_release);
+        return true;
+    }
+
+    void unlock()
+    {
+        m_exclusiveOwner.store(std::thread::id{}, std::memory_order_release);
+        m_mutex.unlock();
+    }
+
+    void lock_shared()
+    {
+        m_mutex.lock_shared();
+    }
+
+    bool try_lock_shared()
+    {
+        return m_mutex.try_lock_shared();
+    }
+
+    void unlock_shared()
+    {
+        m_mutex.unlock_shared();
+    }
+
+    bool isLockedByThisThread() const
+    {
+        return m_exclusiveOwner.load(std::memory_order_acquire) == std::this_thread::get_id();
+    }
+
+private:
+    std::shared_mutex m_mutex;
+    std::atomic<std::thread::id> m_exclusiveOwner;
+};
+
 /**
     @brief Application global properties access
  */
@@ -29,8 +135,8 @@ struct MY_ABSTRACT_TYPE PropertyContainer : IRttiObject
 {
     MY_INTERFACE(my::PropertyContainer, IRttiObject)
 
-    using ModificationLock = std::unique_lock<std::shared_mutex>;
-    using ReadOnlyLock = std::shared_lock<std::shared_mutex>;
+    using ModificationLock = std::unique_lock<PropertyContainerMutex>;
+    using ReadOnlyLock = std::shared_lock<PropertyContainerMutex>;
     using VariableResolverCallback = Functor<std::optional<std::string>(std::string_view)>;
 
     virtual ~PropertyContainer() = default;
@@ -73,6 +179,18 @@ struct MY_ABSTRACT_TYPE PropertyContainer : IRttiObject
      */
     virtual void addVariableResolver(std::string_view kind, VariableResolverCallback resolver) = 0;
 
+    /**
+        @brief get the latest published properties snapshot without locking.
+            Snapshot is published by each set(), mergeWithValue() and addVariableResolver() call.
+            Changes made through getModify() are published by the first getSnapshot() call after the modification lock is released.
+    */
+    virtual PropertySnapshotPtr getSnapshot() const = 0;
+
+    /**
+        @brief properties version, that is changed on each modification. Cheap way to check that the snapshot is outdated.
+    */
+    virtual uint64_t getVersion() const = 0;
+
     /**
         @brief getting typed value
      */
@@ -118,6 +236,80 @@ Result<> PropertyContainer::setValue(std::string_view path, const T& value)
     return set(path, makeValueRef(value));
 }
 
+template <RuntimeValueRepresentable T>
+requires(std::is_default_constructible_v<T>)
+std::optional<T> PropertySnapshot::getValue(std::string_view path) const
+{
+    rtstack_scope;
+
+    RuntimeValuePtr value = getRead(path, GetRtStackAllocatorPtr());
+    if (!value)
+    {
+        return std::nullopt;
+    }
+
+    T resultValue;
+    if (const Result<> applyResult = runtimeValueApply(resultValue, value); !applyResult)
+    {
+        mylog_warn("Fail to apply property value at path({}):{}", path, applyResult.getError()->getMessage());
+        return std::nullopt;
+    }
+
+    return resultValue;
+}
+
+/**
+    @brief Pre-resolved typed property value for the frequently read properties.
+        The value is read from the properties snapshot and is cached until the properties are changed,
+        so the access costs the single atomic load while nothing is changed.
+        The handle itself is not thread safe: it is expected to be owned by the reading code.
+ */
+template <RuntimeValueRepresentable T>
+requires(std::is_default_constructible_v<T>)
+class PropertyHandle
+{
+public:
+    PropertyHandle(const PropertyContainer& properties, std::string path) :
+        m_properties(&properties),
+        m_path(std::move(path))
+    {
+    }
+
+    /**
+        @return Property value or nullopt if property does not exists (or can not be represented as T).
+     */
+    const std::optional<T>& get()
+    {
+        if (m_properties->getVersion() != m_version)
+        {
+            const PropertySnapshotPtr snapshot = m_properties->getSnapshot();
+            m_value = snapshot->getValue<T>(m_path);
+            m_version = snapshot->getVersion();
+        }
+
+        return m_value;
+    }
+
+    T getOr(T defaultValue)
+    {
+        const std::optional<T>& value = get();
+        return value ? *value : std::move(defaultValue);
+    }
+
+    std::string_view getPath() const
+    {
+        return m_path;
+    }
+
+private:
+    static constexpr uint64_t InvalidVersion = std::numeric_limits<uint64_t>::max();
+
+    const PropertyContainer* m_properties;
+    std::string m_path;
+    uint64_t m_version = InvalidVersion;
+    std::optional<T> m_value;
+};
+
 MY_KERNEL_EXPORT
 std::unique_ptr<PropertyContainer> createPropertyContainer();
 
@@ -13,6 +13,7 @@
 #include "my/async/task_base.h"
 #include "my/diag/error.h"
 #include "my/kernel/kernel_config.h"
+#include "my/memory/allocator.h"
 #include "my/utils/cancellation.h"
 #include "my/utils/scope_guard.h"
 #include "my/utils/type_utility.h"
@@ -21,9 +22,38 @@ namespace my::async_detail
 {
 
     /**
+        Coroutine frame allocation.
+        Coroutine which (leading, or next to the object parameter for the member function or lambda) parameters are (std::allocator_arg_t, IAllocator&)
+        allocates its frame from the specified allocator, i.e. from the arena that is attached to the request:
+            Task<> handleRequest(std::allocator_arg_t, IAllocator& arena, Request request);
      */
     struct TaskPromiseTag
     {
+        template <typename... Args>
+        static void* operator new(size_t size, std::allocator_arg_t, IAllocator& allocator, Args&&...)
+        {
+            return allocateCoroutineFrame(size, &allocator);
+        }
+
+        template <typename This, typename... Args>
+        static void* operator new(size_t size, This&&, std::allocator_arg_t, IAllocator& allocator, Args&&...)
+        {
+            return allocateCoroutineFrame(size, &allocator);
+        }
+
+        static void* operator new(size_t size)
+        {
+            return allocateCoroutineFrame(size, nullptr);
+        }
+
+        static void operator delete(void* ptr, size_t size) noexcept
+        {
+            freeCoroutineFrame(ptr, size);
+        }
+
+    private:
+        MY_KERNEL_EXPORT static void* allocateCoroutineFrame(size_t size, IAllocator* allocator);
+        MY_KERNEL_EXPORT static void freeCoroutineFrame(void* ptr, size_t size) noexcept;
     };
 
     /**
@@ -117,7 +147,15 @@ namespace my::async_detail
                 return MakeError("Task is not ready");
             }
 
-            return task.asResult();
+            if constexpr (std::is_void_v<T> || std::is_copy_constructible_v<T>)
+            {
+                return task.asResult();
+            }
+            else
+            {
+                // move only result can be taken only once: it is given to the awaiter
+                return std::move(task).asResult();
+            }
         }
     };
 
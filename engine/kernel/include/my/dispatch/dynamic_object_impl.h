@@ -63,30 +63,19 @@ namespace nau
         }
 
     protected:
-        virtual eastl::unique_ptr<ser_detail::RuntimeObjectState> createRuntimeObjectState() const = 0;
+        /**
+            The state (fields and the fields index) is per type: it is shared by all the instances of the class.
+         */
+        virtual const ser_detail::RuntimeObjectState& getRuntimeObjectState() const = 0;
 
         virtual void* getThis() const = 0;
-
-    private:
-        ser_detail::RuntimeObjectState& getRuntimeObjectState() const
-        {
-            if(!m_runtimeObjectState)
-            {
-                m_runtimeObjectState = createRuntimeObjectState();
-                NAU_FATAL(m_runtimeObjectState);
-            }
-
-            return *m_runtimeObjectState;
-        }
-
-        mutable eastl::unique_ptr<ser_detail::RuntimeObjectState> m_runtimeObjectState;
     };
 
 }  // namespace nau
 
 #define NAU_DECLARE_DYNAMIC_OBJECT                                                                      \
     ::nau::IClassDescriptor::Ptr getClassDescriptor() const override;                                   \
-    eastl::unique_ptr<::nau::ser_detail::RuntimeObjectState> createRuntimeObjectState() const override; \
+    const ::nau::ser_detail::RuntimeObjectState& getRuntimeObjectState() const override;                \
     void* getThis() const override;
 
 #define NAU_IMPLEMENT_DYNAMIC_OBJECT(Class)                                                          \
@@ -95,9 +84,9 @@ namespace nau
         return ::nau::getClassDescriptor<Class>();                                                   \
     }                                                                                                \
                                                                                                      \
-    eastl::unique_ptr<::nau::ser_detail::RuntimeObjectState> Class::createRuntimeObjectState() const \
+    const ::nau::ser_detail::RuntimeObjectState& Class::getRuntimeObjectState() const                \
     {                                                                                                \
-        return eastl::make_unique<::nau::ser_detail::RuntimeObjectStateImpl<Class>>();               \
+        return ::nau::ser_detail::RuntimeObjectStateImpl<Class>::getInstance();                      \
     }                                                                                                \
                                                                                                      \
     void* Class::getThis() const                                                                     \
@@ -2,8 +2,11 @@
 
 #pragma once
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include "my/meta/class_info.h"
-#include "EASTL/vector.h"
 
 /**
  * @brief Defines structures for representing blob data, file entries in asset packs, and asset pack index data.
@@ -11,6 +14,23 @@
 
 namespace my::io
 {
+    /**
+     * @struct AssetPackHeader
+     * @brief Header that is placed at the beginning of the asset pack.
+     * @details Asset pack layout: header, blobs, index (AssetPackIndexData serialized as json).
+     *  All offsets (including BlobData::offset) are counted from the beginning of the asset pack.
+     */
+    struct AssetPackHeader
+    {
+        static constexpr uint32_t Signature = 0x5041594Du;  ///< "MYAP"
+        static constexpr uint32_t CurrentVersion = 1;
+
+        uint32_t signature = Signature;
+        uint32_t version = CurrentVersion;
+        uint64_t indexOffset = 0;  ///< Offset of the index within a asset pack.
+        uint64_t indexSize = 0;    ///< Size of the index.
+    };
+
     /**
      * @struct BlobData
      * @brief Represents a data blob with size and offset information.
@@ -0,0 +1,58 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "my/io/content_compression.h"
+#include "my/io/file_system.h"
+#include "my/io/stream.h"
+#include "my/kernel/kernel_config.h"
+#include "my/utils/result.h"
+
+/**
+ * @brief Provides the function to build an asset pack from the file system content.
+ */
+
+namespace my::io
+{
+    /**
+     * @struct AssetPackBuildSettings
+     * @brief Settings of the asset pack building.
+     */
+    struct AssetPackBuildSettings
+    {
+        std::string version = "1";  ///< Version of the asset pack (AssetPackIndexData::version).
+        std::string description;    ///< Description of the asset pack (AssetPackIndexData::description).
+
+        ContentCompression defaultCompression = ContentCompression::Lz4;                   ///< Compression used for the files without the extension rule.
+        std::unordered_map<std::string, ContentCompression> compressionByExtension = {};  ///< Per extension ("png", "ogg", ...) compression rules, overrides defaultCompression.
+        size_t minCompressionSize = 256;                                                   ///< Smaller files are always stored without compression.
+    };
+
+    /**
+     * @struct AssetPackBuildResult
+     * @brief Statistics of the built asset pack.
+     */
+    struct AssetPackBuildResult
+    {
+        size_t filesCount = 0;            ///< Count of the files within the asset pack.
+        size_t uniqueBlobsCount = 0;      ///< Count of the blobs: files with the identical content share the single blob.
+        size_t compressedBlobsCount = 0;  ///< Count of the blobs stored with the compression.
+        size_t sourceSize = 0;            ///< Total size of the source files.
+        size_t packSize = 0;              ///< Size of the asset pack.
+    };
+
+    /**
+     * @brief Builds an asset pack from all the files of the directory (recursively).
+     * @param source File system with the content.
+     * @param root Directory within the source file system. Files are stored within the asset pack relative to this directory.
+     * @param output Asset pack destination. The stream must support seeking: the header is written after all the blobs.
+     * @param settings Building settings.
+     * @details Files with the identical content are stored once (blobs are deduplicated by the content hash).
+     *  Blob is stored uncompressed when the compression does not reduce its size.
+     */
+    MY_KERNEL_EXPORT
+    Result<AssetPackBuildResult> buildAssetPack(FileSystem& source, const FsPath& root, IStream& output, const AssetPackBuildSettings& settings = {});
+}  // namespace my::io
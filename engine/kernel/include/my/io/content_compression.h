@@ -0,0 +1,81 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string_view>
+
+#include "my/io/stream.h"
+#include "my/kernel/kernel_config.h"
+#include "my/memory/buffer.h"
+#include "my/rtti/ptr.h"
+#include "my/utils/result.h"
+
+/**
+ * @brief Provides content compression codecs used by the asset packs.
+ */
+
+namespace my::io
+{
+    /**
+     * @enum ContentCompression
+     * @brief Compression methods of the asset pack content.
+     *
+     * The names ("none", "lz4", "zstd") are stored in AssetPackFileEntry::contentCompression.
+     * LZ4 content is a sequence of independently compressed chunks (ContentCompressionChunkSize bytes of the decompressed data each),
+     * so it can be decompressed by chunks and seeked without decompressing the preceding data.
+     * Zstd content is a single zstd frame. Zstd is available only when the kernel is built with the zstd library.
+     */
+    enum class ContentCompression
+    {
+        None,
+        Lz4,
+        Zstd
+    };
+
+    inline constexpr size_t ContentCompressionChunkSize = 64 * 1024;
+
+    /**
+     * @brief Gets the name of the compression method as it is stored in the asset pack index.
+     */
+    MY_KERNEL_EXPORT std::string_view getContentCompressionName(ContentCompression compression);
+
+    /**
+     * @brief Parses the compression method name. Empty name means ContentCompression::None.
+     * @return Compression method or std::nullopt if the name is unknown.
+     */
+    MY_KERNEL_EXPORT std::optional<ContentCompression> parseContentCompression(std::string_view name);
+
+    /**
+     * @brief Checks that the compression method is available in the current build.
+     */
+    MY_KERNEL_EXPORT bool isContentCompressionAvailable(ContentCompression compression);
+
+    /**
+     * @brief Compresses the content.
+     * @param compression Compression method.
+     * @param content Data to compress.
+     * @return Compressed content.
+     */
+    MY_KERNEL_EXPORT Result<Buffer> compressContent(ContentCompression compression, std::span<const std::byte> content);
+
+    /**
+     * @brief Decompresses the whole content.
+     * @param compression Compression method.
+     * @param compressedContent Compressed data.
+     * @param output Destination, its size must be equal to the decompressed (client) size.
+     */
+    MY_KERNEL_EXPORT Result<> decompressContent(ContentCompression compression, std::span<const std::byte> compressedContent, std::span<std::byte> output);
+
+    /**
+     * @brief Creates read only stream that decompresses the content on demand, so the whole decompressed data is never kept in memory.
+     * @param compression Compression method.
+     * @param memoryOwner Object that keeps compressed data alive while the stream exists.
+     * @param compressedContent Compressed data.
+     * @param clientSize Decompressed size.
+     * @return Stream or nullptr if the compression method is not available.
+     */
+    MY_KERNEL_EXPORT StreamPtr createDecompressionStream(ContentCompression compression, Ptr<> memoryOwner, std::span<const std::byte> compressedContent, size_t clientSize);
+
+}  // namespace my::io
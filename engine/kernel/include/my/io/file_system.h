@@ -4,7 +4,9 @@
 
 #include <filesystem>
 #include <optional>
+#include <span>
 
+#include "my/io/file_watcher.h"
 #include "my/io/fs_path.h"
 #include "my/io/io_constants.h"
 #include "my/io/stream.h"
@@ -274,6 +276,41 @@ namespace my::io
          * @return Next directory entry.
          */
         virtual FsEntry incrementDirIterator(void*) = 0;
+
+        /**
+         * @brief Reads the next directory entries at once.
+         * @param iteratorState State of the iterator (the first entry is returned by openDirIterator).
+         * @param entries Destination for the entries.
+         * @return Count of the entries that are read, zero at the end of the directory.
+         * @details Default implementation calls incrementDirIterator for each entry,
+         *          file systems that can enumerate a directory in bulk should override it.
+         */
+        virtual size_t readDirEntries(void* iteratorState, std::span<FsEntry> entries)
+        {
+            size_t count = 0;
+            for (; count < entries.size(); ++count)
+            {
+                if (entries[count] = incrementDirIterator(iteratorState); !entries[count])
+                {
+                    break;
+                }
+            }
+
+            return count;
+        }
+
+        /**
+         * @brief Subscribes to the changes of the file or directory.
+         * @param path Path to watch.
+         * @param callback Receives the debounced changes (paths are in terms of this file system).
+         * @param settings Debounce and recursion settings.
+         * @return Watcher that keeps the subscription, or an error if the path can not be watched.
+         * @details Default implementation reports that watching is not supported (i.e. immutable archives).
+         */
+        virtual Result<FileWatcherPtr> watch([[maybe_unused]] const FsPath& path, [[maybe_unused]] FileChangeCallback callback, [[maybe_unused]] FileWatcherSettings settings = {})
+        {
+            return MakeError("File system does not support change watching");
+        }
     };
 
     using FileSystemPtr = my::Ptr<FileSystem>;
@@ -417,6 +454,16 @@ namespace my::io
     MY_KERNEL_EXPORT
     StreamBasePtr createNativeFileStream(std::filesystem::path, AccessModeFlag accessMode, OpenFileMode openMode);
 
+    /**
+     * @brief Opens a native file without the file system (the file can be memory mapped).
+     * @param path Path to the file.
+     * @param accessMode Access mode for the file.
+     * @param openMode Open mode for the file.
+     * @return Pointer to the opened file or nullptr if the file can not be opened.
+     */
+    MY_KERNEL_EXPORT
+    FilePtr openNativeFile(std::filesystem::path, AccessModeFlag accessMode, OpenFileMode openMode);
+
 }  // namespace my::io
 
 namespace my::io_detail
@@ -0,0 +1,84 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <span>
+
+#include "my/io/fs_path.h"
+#include "my/kernel/kernel_config.h"
+#include "my/rtti/rtti_object.h"
+#include "my/runtime/disposable.h"
+#include "my/utils/functor.h"
+#include "my/utils/result.h"
+
+namespace my::io
+{
+    /**
+     * @enum FileChangeKind
+     * @brief Kind of the (coalesced) file system change.
+     */
+    enum class FileChangeKind
+    {
+        Added,     ///< Entry is created (or renamed to the path).
+        Removed,   ///< Entry is removed (or renamed from the path).
+        Modified   ///< Entry content or attributes are changed.
+    };
+
+    /**
+     * @struct FileChangeEvent
+     * @brief Single change of the watched file system.
+     */
+    struct FileChangeEvent
+    {
+        FsPath path;          ///< Path of the changed entry (in terms of the file system that provides the watcher).
+        FileChangeKind kind;  ///< Kind of the change.
+    };
+
+    /**
+     * @brief Receives the debounced batch of changes. Each path appears in the batch at most once.
+     * @details Called from the kernel runtime thread.
+     */
+    using FileChangeCallback = Functor<void(std::span<const FileChangeEvent>)>;
+
+    /**
+     * @struct FileWatcherSettings
+     * @brief Settings of the change watching.
+     */
+    struct FileWatcherSettings
+    {
+        std::chrono::milliseconds debounceTimeout{50};   ///< Changes are reported after the watched path is quiet for this time...
+        std::chrono::milliseconds maxDelay{500};         ///< ... but not later than this time since the first not reported change.
+        bool recursive = true;                           ///< Watch the sub directories too.
+    };
+
+    /**
+     * @struct IFileWatcher
+     * @brief Subscription to the file system changes. Changes are no longer reported after the dispose (or the last reference is released).
+     */
+    struct MY_ABSTRACT_TYPE IFileWatcher : virtual IRefCounted,
+                                           IDisposable
+    {
+        MY_INTERFACE(my::io::IFileWatcher, IRefCounted, IDisposable)
+
+        /**
+         * @brief Gets the watched path.
+         */
+        virtual FsPath getPath() const = 0;
+    };
+
+    using FileWatcherPtr = Ptr<IFileWatcher>;
+
+    /**
+     * @brief Watches the native file or directory with the kernel runtime loop (inotify on Linux, ReadDirectoryChangesW on Windows).
+     * @param nativePath Native path to watch: must exist.
+     * @param basePath Path that is prepended to the reported (relative to the nativePath) paths.
+     * @param callback Receives the changes.
+     * @param settings Debounce and recursion settings.
+     * @details Requires the kernel runtime. Can be called from any thread: the watching is started on the runtime thread before the function returns.
+     */
+    MY_KERNEL_EXPORT
+    Result<FileWatcherPtr> createNativeFileWatcher(std::filesystem::path nativePath, FsPath basePath, FileChangeCallback callback, FileWatcherSettings settings = {});
+
+}  // namespace my::io
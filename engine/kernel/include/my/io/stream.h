@@ -11,6 +11,11 @@
  * @brief Provides base interfaces for stream representations and utility functions for stream operations.
  */
 
+namespace my
+{
+    class Buffer;
+}
+
 namespace my::io
 {
     /**
@@ -117,4 +122,14 @@ namespace my::io
      */
     MY_KERNEL_EXPORT
     Result<size_t> copyStream(IStream& dst, IStream& src);
+
+    /**
+     * @brief Reads a stream from the current position to the end.
+     *
+     * Seekable streams are read by the single read of the remaining size, others are read by the growing blocks until the empty read.
+     * @param src The `IStreamReader` instance to read from.
+     * @return A `Result` containing the buffer with the read data.
+     */
+    MY_KERNEL_EXPORT
+    Result<Buffer> readStreamToEnd(IStream& src);
 }  // namespace my::io
@@ -11,11 +11,30 @@
  */
 
 namespace my::io {
+/**
+ * @struct VfsMountSettings
+ * @brief Settings of the file system mount point.
+ */
+struct VfsMountSettings
+{
+    unsigned priority = 1;  ///< Priority of the mounted file system.
+
+    /**
+     * @brief Keep the snapshot of the directories contents that are enumerated through the virtual file system.
+     * @details Useful for the large content trees that are scanned many times. Snapshots are invalidated by the write operations
+     *          made through the virtual file system, by the changes reported to the virtual file system watchers
+     *          and by IVirtualFileSystem::invalidateDirectoryCache.
+     */
+    bool cacheDirectoryContent = false;
+};
+
 /**
  * @interface IVirtualFileSystem
  * @brief Interface for a virtual file system that supports mounting and unmounting of other file systems.
  * @details This interface extends both `IMutableFileSystem` and `INativeFileSystem`. It provides functionalities
  *          for managing multiple file systems as a unified virtual file system.
+ *          FileSystem::watch subscribes to the changes of the file systems mounted at (or below) the path at the moment of the call:
+ *          the changes are reported with the virtual paths and invalidate the cached directory content.
  */
 struct MY_ABSTRACT_TYPE IVirtualFileSystem : IMutableFileSystem,
                                              INativeFileSystem
@@ -30,13 +49,32 @@ struct MY_ABSTRACT_TYPE IVirtualFileSystem : IMutableFileSystem,
      * @return Result of the operation.
      * @details If multiple file systems are mounted at the same path, the one with the highest priority will be used.
      */
-    virtual Result<> mount(const FsPath&, FileSystemPtr, unsigned priority = 1) = 0;
+    Result<> mount(const FsPath& path, FileSystemPtr fileSystem, unsigned priority = 1)
+    {
+        return mount(path, std::move(fileSystem), VfsMountSettings{.priority = priority});
+    }
+
+    /**
+     * @brief Mounts a file system to a specified path within the virtual file system.
+     * @param path Path at which the file system will be mounted.
+     * @param fileSystem Pointer to the file system to mount.
+     * @param settings Mount point settings.
+     * @return Result of the operation.
+     */
+    virtual Result<> mount(const FsPath&, FileSystemPtr, VfsMountSettings settings) = 0;
 
     /**
      * @brief Unmounts a previously mounted file system.
      * @param fileSystem Pointer to the file system to unmount.
      */
     virtual void unmount(FileSystemPtr) = 0;
+
+    /**
+     * @brief Drops the cached directory content snapshots for the path.
+     * @param path Changed file or directory.
+     * @details Must be called when the content of the mounted file system is modified not through the virtual file system.
+     */
+    virtual void invalidateDirectoryCache(const FsPath& path) = 0;
 };
 
 using VirtualFileSystemPtr = my::Ptr<IVirtualFileSystem>;  ///< Type alias for a pointer to an `VirtualFileSystem`.
@@ -0,0 +1,66 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "my/async/executor.h"
+#include "my/async/task.h"
+#include "my/io/file_system.h"
+#include "my/io/stream.h"
+#include "my/kernel/kernel_config.h"
+#include "my/rtti/ptr.h"
+
+/**
+ * @brief Provides the settings for zip archive file systems and a function to create a zip archive file system.
+ */
+
+namespace my::io
+{
+    /**
+     * @struct ZipArchiveFileSystemSettings
+     * @brief Settings for configuring a zip archive file system.
+     */
+    struct ZipArchiveFileSystemSettings
+    {
+        std::string basePath;                                            ///< Optional directory within the archive used as the file system root.
+        async::ExecutorPtr inflateExecutor;                              ///< Executor used to inflate entries in parallel (default executor if not set).
+        size_t maxCacheSize = 16 * 1024 * 1024;                          ///< Maximum size of the inflated entries kept in cache (in bytes).
+        std::chrono::seconds lifetimeOfCache = std::chrono::minutes(1);  ///< Lifetime of cache entries.
+    };
+
+    /**
+     * @struct IZipArchiveFileSystem
+     * @brief Zip archive specific extension of the file system.
+     */
+    struct MY_ABSTRACT_TYPE IZipArchiveFileSystem : virtual FileSystem
+    {
+        MY_INTERFACE(my::io::IZipArchiveFileSystem, FileSystem)
+
+        /**
+         * @brief Inflates the specified entries in parallel on the inflate executor and puts them into the cache.
+         *        Stored (not compressed) entries and unknown paths are ignored.
+         * @param paths Paths of the entries within the archive.
+         * @return Task that is completed when all entries are inflated.
+         */
+        virtual async::Task<> prefetch(std::vector<FsPath> paths) = 0;
+
+        /**
+         * @brief Gets the number of the entries within the archive: files and directories.
+         *        Directories are counted also when they are not stored in the archive explicitly, but are implied by the entry paths.
+         */
+        virtual size_t getEntriesCount() const = 0;
+    };
+
+    /**
+     * @brief Creates a zip archive file system.
+     * @param stream Stream to read the zip archive from. Memory streams are used in place (without copy), other streams are read at once.
+     * @param settings Configuration settings for the zip archive file system.
+     * @return Pointer to the created file system or nullptr if the archive can not be read.
+     */
+    MY_KERNEL_EXPORT
+    FileSystemPtr createZipArchiveFileSystem(StreamPtr stream, ZipArchiveFileSystemSettings settings);
+
+}  // namespace my::io
@@ -0,0 +1,42 @@
+// #my_engine_source_file
+#pragma once
+#include "my/kernel/kernel_config.h"
+#include "my/memory/allocator.h"
+#include "my/memory/mem_base.h"
+
+namespace my {
+
+/**
+    Monotonic (bump pointer) allocator.
+    Memory is never released by free() (except the most recent allocation), instead all allocations are released at once with reset().
+    Intended for the per-request workloads: everything that is allocated while serving one request (runtime values, buffers, coroutine frames)
+    is released with a single reset() call when the request is completed.
+
+    Arena does not track the lifetime of the allocated objects:
+    all objects (including Ptr<> to the runtime values and Buffers) allocated from the arena must be released before reset() or arena's destruction.
+ */
+struct MY_ABSTRACT_TYPE IArenaAllocator : IAllocator
+{
+    MY_INTERFACE(my::IArenaAllocator, IAllocator)
+
+    /**
+        Releases all allocations.
+        Does not depend on the number of allocations: standard chunks are retained for the reuse, only oversized blocks are returned back.
+     */
+    virtual void reset() = 0;
+
+    /**
+        @returns Total size of the memory occupied by allocations since the last reset().
+     */
+    virtual size_t getUsedSize() const = 0;
+};
+
+using ArenaAllocatorPtr = Ptr<IArenaAllocator>;
+
+/**
+    @param chunkSize Size of the memory chunk that arena takes at once. Chunks are recycled through the process wide chunk pool.
+    @param threadSafe Arena can be used concurrently from the multiple threads. Not required for a coroutine that is resumed on different threads.
+ */
+MY_KERNEL_EXPORT ArenaAllocatorPtr createArenaAllocator(Byte chunkSize = Kilobyte(64), bool threadSafe = false);
+
+}  // namespace my
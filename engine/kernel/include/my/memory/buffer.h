@@ -9,6 +9,7 @@
 
 namespace my {
 
+struct IAllocator;
 class BufferBase;
 class Buffer;
 class ReadOnlyBuffer;
@@ -109,9 +110,10 @@ public:
      * @brief Constructs a buffer with the specified size.
      *
      * @param size The size of the buffer.
-     * @param allocator Optional allocator for the buffer.
+     * @param allocator Optional allocator for the buffer. Buffer keeps the allocator (not a reference) for the whole storage lifetime,
+     *        if not specified then the default buffer allocator is used.
      */
-    explicit Buffer(size_t size);
+    explicit Buffer(size_t size, IAllocator* allocator = nullptr);
 
     Buffer(const Buffer& buffer) = delete;
 
@@ -328,7 +330,13 @@ struct MY_KERNEL_EXPORT BufferStorage
 {
     /**
      */
-    static BufferHandle allocate(size_t size);
+    static BufferHandle allocate(size_t size, IAllocator* allocator = nullptr);
+
+    /**
+        Size of the memory block (including buffer's header) that is requested from the allocator for the buffer of the specified size.
+        Allows to setup the fixed size block allocator for the buffers.
+     */
+    static size_t getStorageSize(size_t size);
 
     /**
      */
@@ -50,9 +50,10 @@ private:
     Allocator& m_allocator;
 };
 
-template <typename T>
-class AllocatorWithMemResource : public IAllocator
+template <typename T, typename AllocatorInterface = IAllocator>
+class AllocatorWithMemResource : public AllocatorInterface
 {
+    static_assert(std::is_base_of_v<IAllocator, AllocatorInterface>);
 
 public:
     std::pmr::memory_resource* GetMemoryResource() const final
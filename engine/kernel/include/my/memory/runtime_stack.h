@@ -12,8 +12,23 @@ class MY_KERNEL_EXPORT RuntimeStackGuard
 public:
     static IAllocator& getAllocator();
 
+    /**
+        @returns Peak size of the runtime stack memory (including heap fallback blocks) used by the current thread
+        since the thread start or the last resetThreadHighWaterMark() call. Use it to right-size the initial reservation.
+     */
+    static size_t getThreadHighWaterMark();
+
+    static void resetThreadHighWaterMark();
+
     RuntimeStackGuard();
-    RuntimeStackGuard(Kilobyte size);
+
+    /**
+        Creates new runtime stack.
+        @param size Size of the stack segment. When the segment is exhausted the next one is chained, so size is not a hard limit.
+        @param heapFallback Single allocation that is larger than half of the segment is served by the heap (and released when the scope is left).
+            Otherwise such allocation is placed into the dedicated segment.
+     */
+    RuntimeStackGuard(Kilobyte size, bool heapFallback = true);
     ~RuntimeStackGuard();
     RuntimeStackGuard(const RuntimeStackGuard&) = delete;
     RuntimeStackGuard& operator=(const RuntimeStackGuard&) = delete;
@@ -24,8 +39,11 @@ private:
     AllocatorPtr m_allocator;
     const uintptr_t m_top = 0;
 #if MY_DEBUG_ASSERT_ENABLED
-
+    // Allocations that are made while this guard is current and are not freed yet.
+    size_t m_liveAllocationsCount = 0;
 #endif
+
+    friend class RuntimeStackAllocator;
 };
 
 struct MY_ABSTRACT_TYPE IStackAllocatorInfo
@@ -35,6 +53,11 @@ struct MY_ABSTRACT_TYPE IStackAllocatorInfo
     virtual ~IStackAllocatorInfo() = default;
 
     virtual uintptr_t getAllocationOffset() const = 0;
+
+    /**
+        @returns Peak size of the memory used by the stack allocator.
+     */
+    virtual size_t getHighWaterMark() const = 0;
 };
 
 inline IAllocator& GetRtStackAllocator()
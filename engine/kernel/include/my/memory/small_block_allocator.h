@@ -0,0 +1,22 @@
+// #my_engine_source_file
+#pragma once
+#include "my/kernel/kernel_config.h"
+#include "my/memory/allocator.h"
+#include "my/memory/host_memory.h"
+
+namespace my {
+
+/**
+    Segregated-fit, thread-caching allocator for general purpose (small object) allocations.
+
+    Requests up to 32 Kb are served from per-thread heaps without any locks:
+    each size class owns spans carved from segments that are taken from the host memory.
+    Blocks freed by a non-owner thread are pushed to the owner heap's remote free list and reclaimed by the owner.
+    Spans that become empty are returned to the shared pool, fully unused segments are released back to the host memory.
+    Larger requests are forwarded directly to the host memory.
+
+    @param hostMemory Thread safe host memory, if null the CRT host memory is used.
+ */
+MY_KERNEL_EXPORT AllocatorPtr createSmallBlockAllocator(HostMemoryPtr hostMemory = nullptr);
+
+}  // namespace my
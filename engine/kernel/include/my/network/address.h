@@ -80,6 +80,13 @@ public:
     iterator begin() const;
     iterator end() const;
 
+    /**
+        Inet addresses are compared by value, other addresses by identity.
+     */
+    bool operator==(const Address&) const;
+
+    size_t getHash() const;
+
 private:
     Ptr<IAddress> m_address;
 };
@@ -89,3 +96,12 @@ MY_KERNEL_EXPORT Result<Address> AddressFromString(std::string_view);
 MY_KERNEL_EXPORT async::Task<Address> ResolveAddress(std::string_view);
 
 }  // namespace my::network
+
+template <>
+struct std::hash<my::network::Address>
+{
+    size_t operator()(const my::network::Address& address) const
+    {
+        return address.getHash();
+    }
+};
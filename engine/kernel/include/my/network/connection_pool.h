@@ -0,0 +1,59 @@
+// #my_engine_source_file
+#pragma once
+
+#include "my/network/network.h"
+
+#include <chrono>
+
+namespace my::network {
+
+/**
+ */
+struct ConnectionPoolSettings
+{
+    // Connections to the same address (in use, idle and being connected), acquire() waits when the limit is reached.
+    size_t maxConnectionsPerHost = 6;
+
+    // Idle connection is closed when it is not used for this time.
+    std::chrono::milliseconds idleTimeout{60'000};
+};
+
+/**
+ */
+struct ConnectionPoolStats
+{
+    size_t connectionsCount = 0;
+    size_t idleCount = 0;
+    size_t waitersCount = 0;
+};
+
+/**
+    Pool of the client (network::connect) connections keyed by the remote address.
+
+    Acquired stream is the lease of the pooled connection: the connection returns to the pool when the last reference to the stream is released
+    and can be reused by the next acquire() for the same address.
+    The connection is closed instead of being returned when the stream is disposed, any read/write fails, or the remote side closes the connection.
+    The caller must dispose the stream if it leaves the connection in an unknown protocol state (i.e. a response is not completely read).
+
+    Idle connections are kept under the read: the connection closed by the remote side (or failed) while idle is never given out.
+    Waiters for the connection to the same address are served in the order of their acquire() calls.
+ */
+struct MY_ABSTRACT_TYPE IConnectionPool : virtual IRefCounted, IDisposable
+{
+    MY_INTERFACE(my::network::IConnectionPool, IRefCounted, IDisposable)
+
+    /**
+        Returns idle connection to the address or establishes the new one while the address limit allows,
+        otherwise waits for the connection released by the other caller.
+        @param expiration Limits the waiting and the connecting time.
+     */
+    virtual async::Task<io::AsyncStreamPtr> acquire(Address address, Expiration expiration = Expiration::never()) = 0;
+
+    virtual ConnectionPoolStats getStats(const Address& address) const = 0;
+};
+
+using ConnectionPoolPtr = Ptr<IConnectionPool>;
+
+MY_KERNEL_EXPORT ConnectionPoolPtr createConnectionPool(ConnectionPoolSettings settings = {});
+
+}  // namespace my::network
@@ -0,0 +1,179 @@
+// #my_engine_source_file
+#pragma once
+
+#include "my/async/task.h"
+#include "my/kernel/kernel_config.h"
+#include "my/memory/buffer.h"
+#include "my/network/http_parser.h"
+#include "my/utils/functor.h"
+#include "my/utils/result.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace my::network {
+
+/**
+ */
+struct HttpHeader
+{
+    std::string name;
+    std::string value;
+};
+
+/**
+    HTTP/1.x request.
+    Body is kept as the chain of the received buffers: chunked body is kept as received chunks, no additional copy is made to join them.
+ */
+struct MY_KERNEL_EXPORT HttpRequest
+{
+    std::string method;
+    std::string target;  // request target: path and query
+    unsigned versionMinor = 1;  // HTTP/1.x
+    std::vector<HttpHeader> headers;
+    std::vector<Buffer> body;
+
+    /**
+        Returns value of the header (case insensitive name), empty string if there is no such header.
+     */
+    std::string_view getHeader(std::string_view name) const;
+
+    std::string_view getPath() const;
+
+    std::string_view getQuery() const;
+
+    size_t getBodySize() const;
+
+    std::string getBodyAsString() const;
+
+    /**
+        HTTP/1.1 connections are persistent unless "Connection: close", HTTP/1.0 requires "Connection: keep-alive".
+     */
+    bool isKeepAlive() const;
+};
+
+/**
+    Produces the next part of the streamed response body, empty buffer means end of the body.
+ */
+using HttpBodyStream = Functor<async::Task<ReadOnlyBuffer>()>;
+
+/**
+ */
+struct MY_KERNEL_EXPORT HttpResponse
+{
+    unsigned status = 200;
+    std::vector<HttpHeader> headers;
+    std::vector<ReadOnlyBuffer> body;
+
+    /**
+        Optional streamed body: the response is sent with the chunked transfer encoding, the buffers of the 'body' (if any) are sent first.
+     */
+    HttpBodyStream bodyStream;
+
+    HttpResponse() = default;
+
+    HttpResponse(unsigned status, std::string_view content = {}, std::string_view contentType = "text/plain");
+
+    HttpResponse(HttpResponse&&) = default;
+
+    HttpResponse& operator=(HttpResponse&&) = default;
+
+    /**
+        Replaces the value of the existing header (case insensitive name) or adds the new one.
+     */
+    HttpResponse& setHeader(std::string_view name, std::string value);
+
+    std::string_view getHeader(std::string_view name) const;
+
+    bool isChunked() const;
+};
+
+/**
+    Returns reason phrase for the status code, "Unknown" for the not known codes.
+ */
+MY_KERNEL_EXPORT std::string_view getHttpStatusReason(unsigned status);
+
+/**
+    Serializes status line and headers of the response (with the framing headers: Content-Length or Transfer-Encoding) including the final empty line.
+ */
+MY_KERNEL_EXPORT Buffer serializeHttpResponseHead(const HttpResponse& response, bool keepAlive);
+
+/**
+    Incremental reader of the HTTP/1.x requests from the connection's byte stream.
+
+    Data is appended as it is received: request head can be split across any number of reads,
+    and one read can contain several (pipelined) requests. Head parsing (HttpParser::parse) is resumed from where the previous attempt stopped,
+    so the data already scanned is not searched again.
+ */
+class MY_KERNEL_EXPORT HttpRequestReader
+{
+public:
+    struct Limits
+    {
+        size_t maxHeadersSize = 64 * 1024;
+        size_t maxBodySize = 16 * 1024 * 1024;
+    };
+
+    HttpRequestReader();
+
+    HttpRequestReader(Limits limits);
+
+    HttpRequestReader(const HttpRequestReader&) = delete;
+
+    HttpRequestReader& operator=(const HttpRequestReader&) = delete;
+
+    void append(const Buffer& data);
+
+    void append(std::string_view data);
+
+    /**
+        Returns the next complete request or std::nullopt if more data is required.
+        Error means malformed (or too large) request: the connection must be closed after the response with getErrorStatus().
+     */
+    Result<std::optional<HttpRequest>> next();
+
+    /**
+        Status code that describes the last error of next(): 400, 413, 431, 501 or 505.
+     */
+    unsigned getErrorStatus() const;
+
+    /**
+        Returns true if there is received data of the not completed request.
+     */
+    bool hasPendingData() const;
+
+private:
+    enum class State
+    {
+        Head,
+        Body,
+        ChunkSize,
+        ChunkData,
+        ChunkDataEnd,
+        Trailers
+    };
+
+    Result<> parseHead(const HttpParser& head);
+    std::string_view pendingData() const;
+    void consume(size_t size);
+    void releaseConsumedData();
+    Buffer takeBytes(size_t size);
+    ErrorPtr fail(unsigned status, std::string_view message);
+    std::optional<std::string_view> takeLine();
+
+    const Limits m_limits;
+    Buffer m_data;
+    size_t m_offset = 0;      // consumed bytes of m_data
+    size_t m_scanOffset = 0;  // bytes (after m_offset) that are already scanned for the end of the current chunk size/trailer line
+    HttpParser m_headParser;  // parser of the current request head, keeps its scan position between the reads
+
+    State m_state = State::Head;
+    HttpRequest m_request;
+    size_t m_remainingSize = 0;  // of the Body or ChunkData
+    size_t m_chunkedBodySize = 0;  // total size of the chunks of the current request
+    unsigned m_errorStatus = 0;
+};
+
+}  // namespace my::network
@@ -4,8 +4,10 @@
 #include "my/utils/result.h"
 #include "my/kernel/kernel_config.h"
 // #include <runtime/diagnostics/mylog.h>
-#include <optional>
+#include <cstdint>
+#include <iterator>
 #include <string_view>
+#include <vector>
 
 namespace my {
 
@@ -13,8 +15,11 @@ namespace my {
     see
     - https://www.rfc-editor.org/rfc/rfc9110.html  (old: https://www.w3.org/Protocols/rfc2616/rfc2616.html)
 
+    Parser instance indexes the whole head (optional start line and all header fields) in a single pass: lookups and iteration do not rescan the buffer.
+    Parsing can be resumed when more data is received (see parse()), the already scanned bytes are not scanned again.
+    Static helpers work directly on the buffer and rescan it on every call.
 */
-class HttpParser
+class MY_KERNEL_EXPORT HttpParser
 {
 public:
     struct Header
@@ -30,6 +35,13 @@ public:
         bool operator==(std::string_view) const;
     };
 
+    enum class ParseStatus
+    {
+        NeedMoreData,
+        Complete,
+        Invalid
+    };
+
     constexpr static std::string_view EndOfLine{"\r\n"};
 
     constexpr static std::string_view EndOfHeaders{"\r\n\r\n"};
@@ -44,9 +56,10 @@ public:
 
         const HttpParser* parser = nullptr;
         value_type value;
+        size_t index = 0;
 
         HeaderIterator();
-        HeaderIterator(const HttpParser& parser, const Header&);
+        HeaderIterator(const HttpParser& parser, size_t index);
         bool operator==(const HeaderIterator&) const;
         bool operator!=(const HeaderIterator&) const;
         HeaderIterator& operator++();
@@ -80,10 +93,27 @@ public:
     // static boost::optional<RequestData> parseRequestData(std::string_view buffer);
 
     HttpParser();
-    HttpParser(const HttpParser&) noexcept = default;
+    HttpParser(const HttpParser&) = default;
+    HttpParser(HttpParser&&) noexcept = default;
     HttpParser(std::string_view buffer);
 
-    HttpParser& operator=(const HttpParser&) noexcept = default;
+    HttpParser& operator=(const HttpParser&) = default;
+    HttpParser& operator=(HttpParser&&) noexcept = default;
+
+    /**
+        Parses (or continues to parse) the head.
+        The buffer must start with the same data that was passed to the previous call, but it can be relocated (i.e. after the reallocation of the receive buffer).
+        Once the status is Complete or Invalid, subsequent calls do nothing.
+        Lines are terminated with CRLF (bare LF is tolerated). The first line is treated as the start (request/status) line when it is not a header field.
+     */
+    ParseStatus parse(std::string_view buffer);
+
+    ParseStatus getStatus() const;
+
+    /**
+        Request or status line, empty if the head starts with the header field.
+     */
+    std::string_view getStartLine() const;
 
     explicit operator bool() const;
 
@@ -93,6 +123,10 @@ public:
 
     std::string_view operator[](std::string_view) const;
 
+    size_t headersCount() const;
+
+    Header headerAt(size_t index) const;
+
     iterator begin() const;
 
     iterator end() const;
@@ -100,8 +134,27 @@ public:
     bool hasHeader(std::string_view) const;
 
 private:
+    struct HeaderOffsets
+    {
+        uint32_t keyOffset;
+        uint32_t keySize;
+        uint32_t valueOffset;
+        uint32_t valueSize;
+    };
+
+    bool completeLine(size_t lineEnd);
+
     std::string_view m_buffer;
-    mutable std::optional<size_t> m_contentLength;
+    std::vector<HeaderOffsets> m_headers;
+    ParseStatus m_status = ParseStatus::NeedMoreData;
+    size_t m_scanOffset = 0;
+    size_t m_lineOffset = 0;
+    size_t m_colonOffset = std::string_view::npos;  // first ':' of the current line
+    size_t m_lineCount = 0;
+    size_t m_startLineSize = 0;
+    size_t m_headersLength = 0;
+    size_t m_contentLength = 0;
+    bool m_hasContentLength = false;
 };
 
 }  // namespace my
@@ -0,0 +1,54 @@
+// #my_engine_source_file
+#pragma once
+
+#include "my/network/http_message.h"
+#include "my/network/network.h"
+
+#include <chrono>
+
+namespace my::network {
+
+/**
+    Request handler. Handlers are called concurrently for the different connections.
+ */
+using HttpHandler = Functor<async::Task<HttpResponse>(HttpRequest)>;
+
+/**
+ */
+struct HttpServerOptions
+{
+    // Connections above the limit are answered with 503 and closed.
+    size_t maxConnections = 1024;
+
+    // Connection is closed when there is no incoming data (between or inside the requests) for this time.
+    std::chrono::milliseconds idleTimeout{30'000};
+
+    size_t maxHeadersSize = 64 * 1024;
+    size_t maxBodySize = 16 * 1024 * 1024;
+};
+
+/**
+    Embedded HTTP/1.1 server: persistent connections, pipelined requests (responses are sent in the request order),
+    chunked request and response bodies.
+ */
+struct MY_ABSTRACT_TYPE IHttpServer : IEndPoint, IDisposable
+{
+    MY_INTERFACE(my::network::IHttpServer, IEndPoint, IDisposable)
+
+    /**
+        Adds the request route.
+        @param method Request method, empty string matches any method.
+        @param path Exact request path or the path prefix when ends with '*' (i.e. "/metrics/*"). The longest matching route is used.
+        Requests without matching route are answered with 404.
+     */
+    virtual void addRoute(std::string method, std::string path, HttpHandler handler) = 0;
+
+    virtual size_t getConnectionsCount() const = 0;
+};
+
+/**
+    Starts listening the address. Server works until it is disposed (or the kernel runtime is shut down).
+ */
+MY_KERNEL_EXPORT async::Task<Ptr<IHttpServer>> startHttpServer(Address address, HttpServerOptions options = {});
+
+}  // namespace my::network
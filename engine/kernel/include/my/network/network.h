@@ -9,6 +9,7 @@
 #include "my/runtime/disposable.h"
 #include "my/utils/cancellation.h"
 
+#include <vector>
 // #include <tuple>
 
 namespace my::network {
@@ -48,13 +49,104 @@ struct MY_ABSTRACT_TYPE IListener : IEndPoint, IDisposable
     virtual async::Task<io::AsyncStreamPtr> accept() = 0;
 };
 
+/**
+    How the listener distributes accepted connections across the network I/O threads (see startNetworkThreads).
+    Without I/O threads all connections are served by the runtime thread.
+ */
+enum class ConnectionDistribution
+{
+    // The listener accepts connections on the runtime thread and passes them to the I/O threads in turn.
+    RoundRobin,
+
+    // Each I/O thread listens its own socket bound with SO_REUSEPORT, the system balances connections between them.
+    // Falls back to RoundRobin where SO_REUSEPORT is not available.
+    ReusePort
+};
+
 struct ListenOptions
 {
     unsigned backlog = 0;
+    ConnectionDistribution distribution = ConnectionDistribution::RoundRobin;
 };
 
+/**
+    Starts the network I/O threads, each one runs its own event loop.
+    Sockets are distributed across these threads: accepted connections (see ConnectionDistribution) and established by connect() in turn.
+    Socket's operations are performed on its thread, the awaiting code is resumed on its own executor.
+    Can be called once, before the sockets are created.
+ */
+MY_KERNEL_EXPORT async::Task<> startNetworkThreads(size_t threadsCount);
+
 MY_KERNEL_EXPORT async::Task<Ptr<IListener>> listen(Address address, ListenOptions = {});
 
 MY_KERNEL_EXPORT async::Task<io::AsyncStreamPtr> connect(Address address, Address bindAddress = {}, Expiration expiration = Expiration::never());
 
+/**
+    Inbound datagram.
+ */
+struct Datagram
+{
+    Buffer data;
+    Address address;  // sender's address
+};
+
+/**
+ */
+struct OutboundDatagram
+{
+    ReadOnlyBuffer data;
+    Address address;  // destination address
+};
+
+/**
+    Connectionless (UDP) socket.
+ */
+struct MY_ABSTRACT_TYPE IDatagramSocket : IEndPoint, IDisposable
+{
+    MY_INTERFACE(my::network::IDatagramSocket, IEndPoint, IDisposable)
+
+    /**
+        Receives next datagram.
+        Datagrams that arrive while there is no pending receive() are queued (up to DatagramSocketOptions::receiveQueueSize, the rest are dropped).
+        Each datagram is copied out of the socket's receive buffer into its own buffer (default buffer allocator),
+        so the received data can be kept and resized independently of the socket.
+     */
+    virtual async::Task<Datagram> receive() = 0;
+
+    virtual async::Task<> send(ReadOnlyBuffer data, Address address) = 0;
+
+    /**
+        Sends multiple datagrams at once.
+        While socket's send queue is empty datagrams are sent immediately (with a single system call where the platform allows),
+        the rest are queued and the task is completed when all datagrams are sent.
+     */
+    virtual async::Task<> send(std::vector<OutboundDatagram> datagrams) = 0;
+
+    /**
+        @param groupAddress Multicast group address.
+        @param interfaceAddress Address of the local interface, the system chooses the interface when not specified.
+     */
+    virtual async::Task<> joinMulticastGroup(Address groupAddress, Address interfaceAddress = {}) = 0;
+
+    virtual async::Task<> leaveMulticastGroup(Address groupAddress, Address interfaceAddress = {}) = 0;
+};
+
+/**
+ */
+struct DatagramSocketOptions
+{
+    // Maximum size of the received datagram, larger datagrams are truncated.
+    size_t maxDatagramSize = 1500;
+    size_t receiveQueueSize = 256;
+    bool reuseAddress = false;
+    bool broadcast = false;
+    bool multicastLoopback = true;
+    unsigned multicastTtl = 1;
+};
+
+/**
+    Creates datagram socket bound to the address. Use port 0 to bind to the port chosen by the system (see IEndPoint::getLocalAddress).
+ */
+MY_KERNEL_EXPORT async::Task<Ptr<IDatagramSocket>> bindDatagramSocket(Address address, DatagramSocketOptions options = {});
+
 }  // namespace my::network
@@ -0,0 +1,57 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include "my/io/file_system.h"
+#include "my/io/stream.h"
+#include "my/kernel/kernel_config.h"
+#include "my/memory/allocator.h"
+#include "my/memory/buffer.h"
+#include "my/serialization/runtime_value.h"
+#include "my/utils/result.h"
+
+#include <span>
+#include <string_view>
+
+namespace my::serialization {
+
+/**
+    Content type of the compiled config blob (see configBlobWrite).
+ */
+inline constexpr std::string_view ConfigBlobContentType = "application/x-my-config-blob";
+
+/**
+    File extension of the compiled config blob.
+ */
+inline constexpr std::string_view ConfigBlobFileExtension = ".mycfg";
+
+/**
+    Compiles the runtime value (usually parsed json config) into the flat read-only image:
+    the header, typed 16 byte value records, dictionary members sorted by key and the deduplicated string table.
+    All the references inside the image are offsets, so it is used directly from the mapped memory without parsing.
+ */
+MY_KERNEL_EXPORT
+Result<> configBlobWrite(io::IStream&, const RuntimeValuePtr&);
+
+/**
+    Checks the header only.
+ */
+MY_KERNEL_EXPORT
+bool isConfigBlob(std::span<const std::byte>);
+
+/**
+    Opens the image created by configBlobWrite. Only the header is checked while opening, nothing is parsed or copied:
+    returned values are read-only views into the buffer (the buffer is kept alive by the values),
+    dictionaries lookup the keys with binary search, containers create the element values on access.
+ */
+MY_KERNEL_EXPORT
+Result<RuntimeValuePtr> configBlobOpen(ReadOnlyBuffer, IAllocator* = nullptr);
+
+/**
+    Opens the image directly from the file memory mapping (the file is kept mapped while any of the returned values is alive).
+    The file that does not support memory mapping is read by the single read call.
+ */
+MY_KERNEL_EXPORT
+Result<RuntimeValuePtr> configBlobOpenFile(io::IFile&, IAllocator* = nullptr);
+
+}  // namespace my::serialization
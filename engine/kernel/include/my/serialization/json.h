@@ -15,6 +15,10 @@
 #include <string>
 #include <string_view>
 
+namespace my::io {
+struct IFile;
+}
+
 namespace my::serialization {
 /**
  */
@@ -39,6 +43,41 @@ Result<RuntimeValuePtr> jsonParse(io::IStream&, IAllocator* = nullptr);
 MY_KERNEL_EXPORT
 Result<RuntimeValuePtr> jsonParseString(std::string_view, IAllocator* = nullptr);
 
+/**
+    Json parsing backend.
+ */
+enum class JsonParser
+{
+    /**
+        jsoncpp DOM, values are dictionaries/collections wrapping the Json::Value (same as jsonParse without the parser argument).
+     */
+    JsonCpp,
+
+    /**
+        Two stage parser: SIMD structural index, then the flat tape within the single allocation.
+        Values are read-only (ReadonlyDictionary/ReadonlyCollection), comments are not supported.
+        Object keys are sorted and the last of the duplicate keys wins, the same as jsoncpp.
+     */
+    Tape
+};
+
+/**
+ */
+MY_KERNEL_EXPORT
+Result<RuntimeValuePtr> jsonParse(io::IStream&, JsonParser, IAllocator* = nullptr);
+
+/**
+ */
+MY_KERNEL_EXPORT
+Result<RuntimeValuePtr> jsonParseString(std::string_view, JsonParser, IAllocator* = nullptr);
+
+/**
+    Parses the whole file. The file is memory mapped when it is supported, otherwise it is read by the single read call.
+    The default parser is JsonCpp (same as jsonParse/jsonParseString): the tape parser does not accept comments.
+ */
+MY_KERNEL_EXPORT
+Result<RuntimeValuePtr> jsonParseFile(io::IFile&, JsonParser = JsonParser::JsonCpp, IAllocator* = nullptr);
+
 /**
  */
 struct MY_ABSTRACT_TYPE JsonValueHolder
@@ -0,0 +1,1529 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include "my/io/stream_utils.h"
+#include "my/meta/class_info.h"
+#include "my/rtti/type_info.h"
+#include "my/serialization/json.h"
+#include "my/serialization/native_runtime_value/native_value_forwards.h"
+#include "my/serialization/serialization.h"
+#include "my/utils/perfect_hash.h"
+#include "my/utils/scope_guard.h"
+#include "my/utils/string_utils.h"
+#include "my/utils/to_string.h"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+namespace my::ser_detail {
+
+/**
+ */
+enum class JsonToken
+{
+    End,
+    Invalid,
+    Null,
+    Boolean,
+    Number,
+    String,
+    Array,
+    Object
+};
+
+inline std::string_view getJsonTokenName(JsonToken token)
+{
+    switch (token)
+    {
+        case JsonToken::Null:
+            return "null";
+        case JsonToken::Boolean:
+            return "boolean";
+        case JsonToken::Number:
+            return "number";
+        case JsonToken::String:
+            return "string";
+        case JsonToken::Array:
+            return "array";
+        case JsonToken::Object:
+            return "object";
+        case JsonToken::End:
+            return "end of text";
+        default:
+            return "invalid";
+    }
+}
+
+/**
+    Forward only pull reader over the JSON text.
+    Accepts comments and trailing commas (as the jsoncpp based parser does).
+    Strings without escape sequences are returned as views into the source text.
+ */
+class JsonTextReader
+{
+public:
+    static constexpr size_t MaxDepth = 512;
+
+    JsonTextReader(std::string_view text) :
+        m_text(text)
+    {
+    }
+
+    JsonToken peekToken()
+    {
+        skipSpace();
+        if (m_pos >= m_text.size())
+        {
+            return JsonToken::End;
+        }
+
+        switch (m_text[m_pos])
+        {
+            case '{':
+                return JsonToken::Object;
+            case '[':
+                return JsonToken::Array;
+            case '"':
+                return JsonToken::String;
+            case 't':
+            case 'f':
+                return JsonToken::Boolean;
+            case 'n':
+                return JsonToken::Null;
+            case '-':
+            case '0':
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
+                return JsonToken::Number;
+            default:
+                return JsonToken::Invalid;
+        }
+    }
+
+    bool isEnd()
+    {
+        return peekToken() == JsonToken::End;
+    }
+
+    bool tryConsume(char c)
+    {
+        skipSpace();
+        if (m_pos < m_text.size() && m_text[m_pos] == c)
+        {
+            ++m_pos;
+            return true;
+        }
+
+        return false;
+    }
+
+    Result<> expect(char c)
+    {
+        if (!tryConsume(c))
+        {
+            return makeError(std::format("Expected '{}'", c));
+        }
+
+        return kResultSuccess;
+    }
+
+    Result<> readNull()
+    {
+        return readLiteral("null");
+    }
+
+    Result<bool> readBoolean()
+    {
+        skipSpace();
+        if (m_text.substr(m_pos).starts_with("true"))
+        {
+            m_pos += 4;
+            return true;
+        }
+
+        CheckResult(readLiteral("false"));
+        return false;
+    }
+
+    /**
+        @param isFloat Set to true if the literal contains fraction or exponent part.
+        @return Text of the number literal.
+     */
+    Result<std::string_view> readNumber(bool& isFloat)
+    {
+        skipSpace();
+        isFloat = false;
+
+        const size_t start = m_pos;
+        if (m_pos < m_text.size() && m_text[m_pos] == '-')
+        {
+            ++m_pos;
+        }
+
+        const size_t integerStart = m_pos;
+        skipDigits();
+        if (m_pos == integerStart)
+        {
+            return makeError("Invalid number");
+        }
+
+        if (m_pos < m_text.size() && m_text[m_pos] == '.')
+        {
+            isFloat = true;
+            ++m_pos;
+
+            const size_t fractionStart = m_pos;
+            skipDigits();
+            if (m_pos == fractionStart)
+            {
+                return makeError("Invalid number: fraction digits expected");
+            }
+        }
+
+        if (m_pos < m_text.size() && (m_text[m_pos] == 'e' || m_text[m_pos] == 'E'))
+        {
+            isFloat = true;
+            ++m_pos;
+            if (m_pos < m_text.size() && (m_text[m_pos] == '+' || m_text[m_pos] == '-'))
+            {
+                ++m_pos;
+            }
+
+            const size_t exponentStart = m_pos;
+            skipDigits();
+            if (m_pos == exponentStart)
+            {
+                return makeError("Invalid number: exponent digits expected");
+            }
+        }
+
+        return m_text.substr(start, m_pos - start);
+    }
+
+    /**
+        @param buffer Storage for the decoded string, used only if the string contains escape sequences.
+        @return View into the source text or into the buffer.
+     */
+    Result<std::string_view> readString(std::string& buffer)
+    {
+        if (!tryConsume('"'))
+        {
+            return makeError("Expected string");
+        }
+
+        const size_t start = m_pos;
+        for (; m_pos < m_text.size(); ++m_pos)
+        {
+            const char c = m_text[m_pos];
+            if (c == '"')
+            {
+                return m_text.substr(start, m_pos++ - start);
+            }
+
+            if (c == '\\')
+            {
+                break;
+            }
+        }
+
+        buffer.assign(m_text.data() + start, m_pos - start);
+
+        while (m_pos < m_text.size())
+        {
+            const char c = m_text[m_pos++];
+            if (c == '"')
+            {
+                return std::string_view{buffer};
+            }
+
+            if (c != '\\')
+            {
+                buffer.push_back(c);
+                continue;
+            }
+
+            if (m_pos >= m_text.size())
+            {
+                break;
+            }
+
+            switch (const char escaped = m_text[m_pos++]; escaped)
+            {
+                case '"':
+                case '\\':
+                case '/':
+                    buffer.push_back(escaped);
+                    break;
+                case 'b':
+                    buffer.push_back('\b');
+                    break;
+                case 'f':
+                    buffer.push_back('\f');
+                    break;
+                case 'n':
+                    buffer.push_back('\n');
+                    break;
+                case 'r':
+                    buffer.push_back('\r');
+                    break;
+                case 't':
+                    buffer.push_back('\t');
+                    break;
+                case 'u':
+                    CheckResult(readUnicodeEscape(buffer));
+                    break;
+                default:
+                    return makeError("Invalid escape sequence");
+            }
+        }
+
+        return MakeErrorT(serialization::EndOfStreamError)();
+    }
+
+    /**
+        Reads the object and calls readField(std::string_view key) -> Result<> for each of the object's keys.
+        readField must read (or skip) the key's value.
+     */
+    template <typename F>
+    Result<> readObject(F&& readField)
+    {
+        CheckResult(expect('{'));
+        CheckResult(enterScope());
+        scope_on_leave
+        {
+            --m_depth;
+        };
+
+        for (bool isFirst = true;; isFirst = false)
+        {
+            if (tryConsume('}'))
+            {
+                return kResultSuccess;
+            }
+
+            if (!isFirst)
+            {
+                CheckResult(expect(','));
+                if (tryConsume('}'))
+                {
+                    return kResultSuccess;
+                }
+            }
+
+            Result<std::string_view> key = readString(m_keyBuffer);
+            CheckResult(key);
+            CheckResult(expect(':'));
+            CheckResult(readField(*key));
+        }
+    }
+
+    /**
+        Reads the array and calls readElement() -> Result<> for each of the array's elements.
+     */
+    template <typename F>
+    Result<> readArray(F&& readElement)
+    {
+        CheckResult(expect('['));
+        CheckResult(enterScope());
+        scope_on_leave
+        {
+            --m_depth;
+        };
+
+        for (bool isFirst = true;; isFirst = false)
+        {
+            if (tryConsume(']'))
+            {
+                return kResultSuccess;
+            }
+
+            if (!isFirst)
+            {
+                CheckResult(expect(','));
+                if (tryConsume(']'))
+                {
+                    return kResultSuccess;
+                }
+            }
+
+            CheckResult(readElement());
+        }
+    }
+
+    Result<> skipValue()
+    {
+        switch (peekToken())
+        {
+            case JsonToken::Null:
+                return readNull();
+            case JsonToken::Boolean:
+            {
+                CheckResult(readBoolean());
+                return kResultSuccess;
+            }
+            case JsonToken::Number:
+            {
+                bool isFloat = false;
+                CheckResult(readNumber(isFloat));
+                return kResultSuccess;
+            }
+            case JsonToken::String:
+            {
+                std::string buffer;
+                CheckResult(readString(buffer));
+                return kResultSuccess;
+            }
+            case JsonToken::Array:
+                return readArray([this]
+                {
+                    return skipValue();
+                });
+            case JsonToken::Object:
+                return readObject([this](std::string_view)
+                {
+                    return skipValue();
+                });
+            case JsonToken::End:
+                return MakeErrorT(serialization::EndOfStreamError)();
+            default:
+                return makeError("Unexpected character");
+        }
+    }
+
+    size_t getPosition()
+    {
+        skipSpace();
+        return m_pos;
+    }
+
+    std::string_view getText(size_t from, size_t to) const
+    {
+        return m_text.substr(from, to - from);
+    }
+
+    ErrorPtr makeError(std::string_view message) const
+    {
+        size_t line = 1;
+        size_t lineStart = 0;
+        for (size_t i = 0; i < m_pos && i < m_text.size(); ++i)
+        {
+            if (m_text[i] == '\n')
+            {
+                ++line;
+                lineStart = i + 1;
+            }
+        }
+
+        return MakeErrorT(serialization::SerializationError)(std::format("{} (line:{}, column:{})", message, line, m_pos - lineStart + 1));
+    }
+
+private:
+    void skipSpace()
+    {
+        while (m_pos < m_text.size())
+        {
+            const char c = m_text[m_pos];
+            if (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+            {
+                ++m_pos;
+            }
+            else if (c == '/' && m_pos + 1 < m_text.size() && m_text[m_pos + 1] == '/')
+            {
+                const size_t lineEnd = m_text.find('\n', m_pos);
+                m_pos = lineEnd == std::string_view::npos ? m_text.size() : lineEnd + 1;
+            }
+            else if (c == '/' && m_pos + 1 < m_text.size() && m_text[m_pos + 1] == '*')
+            {
+                const size_t commentEnd = m_text.find("*/", m_pos + 2);
+                m_pos = commentEnd == std::string_view::npos ? m_text.size() : commentEnd + 2;
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    void skipDigits()
+    {
+        while (m_pos < m_text.size() && m_text[m_pos] >= '0' && m_text[m_pos] <= '9')
+        {
+            ++m_pos;
+        }
+    }
+
+    Result<> readLiteral(std::string_view literal)
+    {
+        skipSpace();
+        if (!m_text.substr(m_pos).starts_with(literal))
+        {
+            return makeError(std::format("Expected ({})", literal));
+        }
+
+        m_pos += literal.size();
+        return kResultSuccess;
+    }
+
+    std::optional<uint32_t> readHex4()
+    {
+        if (m_text.size() - m_pos < 4)
+        {
+            return std::nullopt;
+        }
+
+        uint32_t value = 0;
+        const char* const begin = m_text.data() + m_pos;
+        if (const auto [ptr, err] = std::from_chars(begin, begin + 4, value, 16); err != std::errc{} || ptr != begin + 4)
+        {
+            return std::nullopt;
+        }
+
+        m_pos += 4;
+        return value;
+    }
+
+    Result<> readUnicodeEscape(std::string& buffer)
+    {
+        std::optional<uint32_t> codePoint = readHex4();
+        if (!codePoint)
+        {
+            return makeError("Invalid unicode escape sequence");
+        }
+
+        if (*codePoint >= 0xD800 && *codePoint <= 0xDBFF)
+        {
+            if (!m_text.substr(m_pos).starts_with("\\u"))
+            {
+                return makeError("Expected low surrogate");
+            }
+
+            m_pos += 2;
+            const std::optional<uint32_t> lowSurrogate = readHex4();
+            if (!lowSurrogate || *lowSurrogate < 0xDC00 || *lowSurrogate > 0xDFFF)
+            {
+                return makeError("Invalid low surrogate");
+            }
+
+            codePoint = 0x10000 + ((*codePoint - 0xD800) << 10) + (*lowSurrogate - 0xDC00);
+        }
+
+        const uint32_t cp = *codePoint;
+        if (cp < 0x80)
+        {
+            buffer.push_back(static_cast<char>(cp));
+        }
+        else if (cp < 0x800)
+        {
+            buffer.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            buffer.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        else if (cp < 0x10000)
+        {
+            buffer.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            buffer.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            buffer.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        else
+        {
+            buffer.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            buffer.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            buffer.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            buffer.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+
+        return kResultSuccess;
+    }
+
+    Result<> enterScope()
+    {
+        if (++m_depth > MaxDepth)
+        {
+            --m_depth;
+            return makeError("Maximum nesting depth exceeded");
+        }
+
+        return kResultSuccess;
+    }
+
+    const std::string_view m_text;
+    size_t m_pos = 0;
+    size_t m_depth = 0;
+    std::string m_keyBuffer;
+};
+
+/**
+    Appends JSON text to the string or writes it into the stream.
+    Stream output is collected within the block sized buffer and written by the whole blocks, flush() must be called at the end.
+ */
+class JsonTextWriter
+{
+public:
+    static constexpr size_t StreamBlockSize = 16 * 1024;
+
+    JsonTextWriter(std::string& output, serialization::JsonSettings settings) :
+        m_output(output),
+        m_settings(settings)
+    {
+    }
+
+    JsonTextWriter(io::IStream& stream, serialization::JsonSettings settings) :
+        m_output(m_streamBuffer),
+        m_settings(settings),
+        m_stream(&stream)
+    {
+        MY_DEBUG_ASSERT(stream.canWrite());
+        m_streamBuffer.reserve(StreamBlockSize + StreamBlockSize / 4);
+    }
+
+    JsonTextWriter(const JsonTextWriter&) = delete;
+    JsonTextWriter& operator=(const JsonTextWriter&) = delete;
+
+    /**
+        Writes the buffered text into the stream.
+        @return First error of the stream writes.
+     */
+    Result<> flush()
+    {
+        if (m_stream)
+        {
+            writeToStream();
+        }
+
+        if (m_streamError)
+        {
+            return m_streamError;
+        }
+
+        return kResultSuccess;
+    }
+
+    const serialization::JsonSettings& getSettings() const
+    {
+        return m_settings;
+    }
+
+    void beginObject()
+    {
+        beginValue();
+        m_output.push_back('{');
+        ++m_depth;
+        m_isFirst = true;
+    }
+
+    void endObject()
+    {
+        endScope('}');
+        flushFullBlock();
+    }
+
+    void beginArray()
+    {
+        beginValue();
+        m_output.push_back('[');
+        ++m_depth;
+        m_isFirst = true;
+    }
+
+    void endArray()
+    {
+        endScope(']');
+        flushFullBlock();
+    }
+
+    void writeKey(std::string_view key)
+    {
+        beginValue();
+        writeQuoted(key);
+        m_output.append(m_settings.pretty ? ": " : ":");
+        m_isAfterKey = true;
+    }
+
+    void writeNull()
+    {
+        beginValue();
+        m_output.append("null");
+        flushFullBlock();
+    }
+
+    void writeBoolean(bool value)
+    {
+        beginValue();
+        m_output.append(value ? "true" : "false");
+        flushFullBlock();
+    }
+
+    template <typename T>
+    requires(std::is_arithmetic_v<T>)
+    void writeNumber(T value)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            if (!std::isfinite(value))
+            {
+                writeNull();
+                return;
+            }
+        }
+
+        beginValue();
+        char buffer[64];
+        const auto [ptr, err] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        MY_DEBUG_ASSERT(err == std::errc{});
+        m_output.append(buffer, ptr);
+
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            // keep the number floating point after the parsing (the same as jsoncpp writes the integral doubles)
+            if (std::string_view{buffer, ptr}.find_first_of(".e") == std::string_view::npos)
+            {
+                m_output.append(".0");
+            }
+        }
+
+        flushFullBlock();
+    }
+
+    void writeString(std::string_view str)
+    {
+        beginValue();
+        writeQuoted(str);
+        flushFullBlock();
+    }
+
+    /**
+        Writes already formatted JSON value.
+     */
+    void writeRawValue(std::string_view json)
+    {
+        beginValue();
+        m_output.append(json);
+        flushFullBlock();
+    }
+
+private:
+    void flushFullBlock()
+    {
+        if (m_stream && m_output.size() >= StreamBlockSize)
+        {
+            writeToStream();
+        }
+    }
+
+    void writeToStream()
+    {
+        if (!m_streamError && !m_output.empty())
+        {
+            const auto* const data = reinterpret_cast<const std::byte*>(m_output.data());
+            for (size_t offset = 0; offset < m_output.size();)
+            {
+                Result<size_t> written = m_stream->write(data + offset, m_output.size() - offset);
+                if (!written || *written == 0)
+                {
+                    m_streamError = written ? MakeErrorT(serialization::SerializationError)("Stream write failed") : written.getError();
+                    break;
+                }
+
+                offset += *written;
+            }
+        }
+
+        m_output.clear();
+    }
+
+    void beginValue()
+    {
+        if (m_isAfterKey)
+        {
+            m_isAfterKey = false;
+            return;
+        }
+
+        if (!m_isFirst)
+        {
+            m_output.push_back(',');
+        }
+
+        m_isFirst = false;
+        if (m_settings.pretty && m_depth > 0)
+        {
+            newLine();
+        }
+    }
+
+    void endScope(char closing)
+    {
+        MY_DEBUG_ASSERT(m_depth > 0);
+        --m_depth;
+        if (m_settings.pretty && !m_isFirst)
+        {
+            newLine();
+        }
+
+        m_output.push_back(closing);
+        m_isFirst = false;
+    }
+
+    void newLine()
+    {
+        m_output.push_back('\n');
+        m_output.append(m_depth, '\t');
+    }
+
+    void writeQuoted(std::string_view str)
+    {
+        constexpr std::string_view HexDigits = "0123456789abcdef";
+
+        m_output.push_back('"');
+
+        size_t chunkStart = 0;
+        for (size_t i = 0; i < str.size(); ++i)
+        {
+            const auto c = static_cast<unsigned char>(str[i]);
+            if (c >= 0x20 && c != '"' && c != '\\')
+            {
+                continue;
+            }
+
+            m_output.append(str.data() + chunkStart, i - chunkStart);
+            chunkStart = i + 1;
+
+            switch (c)
+            {
+                case '"':
+                    m_output.append("\\\"");
+                    break;
+                case '\\':
+                    m_output.append("\\\\");
+                    break;
+                case '\b':
+                    m_output.append("\\b");
+                    break;
+                case '\f':
+                    m_output.append("\\f");
+                    break;
+                case '\n':
+                    m_output.append("\\n");
+                    break;
+                case '\r':
+                    m_output.append("\\r");
+                    break;
+                case '\t':
+                    m_output.append("\\t");
+                    break;
+                default:
+                    m_output.append("\\u00");
+                    m_output.push_back(HexDigits[c >> 4]);
+                    m_output.push_back(HexDigits[c & 0xF]);
+            }
+        }
+
+        m_output.append(str.data() + chunkStart, str.size() - chunkStart);
+        m_output.push_back('"');
+    }
+
+    std::string m_streamBuffer;
+    std::string& m_output;
+    const serialization::JsonSettings m_settings;
+    io::IStream* const m_stream = nullptr;
+    ErrorPtr m_streamError;
+    size_t m_depth = 0;
+    bool m_isFirst = true;
+    bool m_isAfterKey = false;
+};
+
+/**
+    Writes the runtime value directly with the writer, without building the json value tree.
+ */
+MY_KERNEL_EXPORT
+void jsonWriteRuntimeValue(JsonTextWriter& writer, const RuntimeValuePtr& value);
+
+template <typename T>
+Result<> jsonReadValue(JsonTextReader& reader, T& value, serialization::TypeCoercion typeCoercion);
+
+template <typename T>
+void jsonWriteValue(JsonTextWriter& writer, const T& value);
+
+template <typename T>
+bool jsonIsEmptyValue(const T& value)
+{
+    if constexpr (std::is_same_v<T, RuntimeValuePtr>)
+    {
+        return !value;
+    }
+    else if constexpr (LikeStdOptional<T>)
+    {
+        return !value.has_value();
+    }
+    else if constexpr (std::is_same_v<T, std::string> || LikeStdCollection<T> || LikeSet<T> || LikeStdMap<T>)
+    {
+        return value.empty();
+    }
+    else
+    {
+        return false;
+    }
+}
+
+/**
+    Per type reflected fields and the perfect hash over the field names.
+    Built once on first use of the type (at runtime: the field names of MY_CLASS_FIELDS are not constant expressions).
+ */
+template <typename T>
+class JsonClassCodec
+{
+public:
+    static const JsonClassCodec& getInstance()
+    {
+        static const JsonClassCodec instance;
+        return instance;
+    }
+
+    Result<> read(JsonTextReader& reader, T& object, serialization::TypeCoercion typeCoercion) const
+    {
+        std::array<bool, FieldsCount> isFieldRead{};
+
+        CheckResult(reader.readObject([&](std::string_view key) -> Result<>
+        {
+            const size_t index = m_fieldsIndex.find(key);
+            if (index == StringPerfectHash::NotFound)
+            {
+                return reader.skipValue();
+            }
+
+            isFieldRead[index] = true;
+            return readField(reader, object, index, typeCoercion, std::make_index_sequence<FieldsCount>{});
+        }));
+
+        return checkRequiredFields(isFieldRead, std::make_index_sequence<FieldsCount>{});
+    }
+
+    void write(JsonTextWriter& writer, const T& object) const
+    {
+        writer.beginObject();
+        writeFields(writer, object, std::make_index_sequence<FieldsCount>{});
+        writer.endObject();
+    }
+
+private:
+    using Fields = decltype(meta::getClassAllFields<T>());
+
+    static constexpr size_t FieldsCount = std::tuple_size_v<Fields>;
+
+    static std::string getTypeName()
+    {
+        if constexpr (rtti::HasTypeInfo<T>)
+        {
+            return std::string{rtti::getTypeInfo<T>().getTypeName()};
+        }
+        else
+        {
+            return typeid(T).name();
+        }
+    }
+
+    template <typename Field>
+    static serialization::TypeCoercion getFieldTypeCoercion(const Field& field, serialization::TypeCoercion defaultTypeCoercion)
+    {
+        if constexpr (Field::template HasAttribute<serialization::TypeCoercion>)
+        {
+            return std::get<serialization::TypeCoercion>(field.getAttributes());
+        }
+        else
+        {
+            return defaultTypeCoercion;
+        }
+    }
+
+    JsonClassCodec() :
+        m_fields(meta::getClassAllFields<T>()),
+        m_fieldsIndex(makeFieldsIndex(m_fields))
+    {
+    }
+
+    static StringPerfectHash makeFieldsIndex(const Fields& fields)
+    {
+        const std::array<std::string_view, FieldsCount> names = std::apply([](const auto&... field)
+        {
+            return std::array<std::string_view, FieldsCount>{field.getName()...};
+        }, fields);
+
+        return StringPerfectHash{names};
+    }
+
+    template <size_t I>
+    Result<> readFieldAt(JsonTextReader& reader, T& object, serialization::TypeCoercion typeCoercion) const
+    {
+        const auto& field = std::get<I>(m_fields);
+        auto& fieldValue = field.getValue(object);
+
+        if constexpr (std::is_const_v<std::remove_reference_t<decltype(fieldValue)>>)
+        {
+            return reader.skipValue();
+        }
+        else
+        {
+            return jsonReadValue(reader, fieldValue, getFieldTypeCoercion(field, typeCoercion));
+        }
+    }
+
+    template <size_t... I>
+    Result<> readField(JsonTextReader& reader, T& object, size_t index, serialization::TypeCoercion typeCoercion, std::index_sequence<I...>) const
+    {
+        Result<> result;
+        [[maybe_unused]] const bool isFound = ((index == I ? (result = readFieldAt<I>(reader, object, typeCoercion), true) : false) || ...);
+        MY_DEBUG_ASSERT(isFound);
+
+        return result;
+    }
+
+    template <size_t... I>
+    Result<> checkRequiredFields(const std::array<bool, FieldsCount>& isFieldRead, std::index_sequence<I...>) const
+    {
+        Result<> result;
+
+        const auto checkField = [&]<size_t Index>(std::integral_constant<size_t, Index>)
+        {
+            using Field = std::tuple_element_t<Index, Fields>;
+            if constexpr (Field::template HasAttribute<serialization::RequiredFieldAttribute>)
+            {
+                if (!isFieldRead[Index])
+                {
+                    result = MakeErrorT(serialization::RequiredFieldMissedError)(getTypeName(), std::string{std::get<Index>(m_fields).getName()});
+                    return false;
+                }
+            }
+
+            return true;
+        };
+
+        (checkField(std::integral_constant<size_t, I>{}) && ...);
+        return result;
+    }
+
+    template <size_t... I>
+    void writeFields(JsonTextWriter& writer, const T& object, std::index_sequence<I...>) const
+    {
+        const auto writeField = [&]<size_t Index>(std::integral_constant<size_t, Index>)
+        {
+            const auto& field = std::get<Index>(m_fields);
+            using Field = std::remove_cvref_t<decltype(field)>;
+
+            const auto& fieldValue = field.getValue(object);
+            using FieldValue = std::remove_cvref_t<decltype(fieldValue)>;
+
+            constexpr bool CanBeNull = LikeStdOptional<FieldValue> || std::is_same_v<FieldValue, RuntimeValuePtr>;
+            if constexpr (Field::template HasAttribute<serialization::IgnoreEmptyFieldAttribute>)
+            {
+                if (jsonIsEmptyValue(fieldValue))
+                {
+                    return;
+                }
+            }
+            else if constexpr (CanBeNull)
+            {
+                if (!writer.getSettings().writeNulls && jsonIsEmptyValue(fieldValue))
+                {
+                    return;
+                }
+            }
+
+            writer.writeKey(field.getName());
+            jsonWriteValue(writer, fieldValue);
+        };
+
+        (writeField(std::integral_constant<size_t, I>{}), ...);
+    }
+
+    const Fields m_fields;
+    const StringPerfectHash m_fieldsIndex;
+};
+
+inline Result<> jsonCheckTypeCoercion(JsonToken actual, std::string_view expected, serialization::TypeCoercion typeCoercion)
+{
+    if (typeCoercion == serialization::TypeCoercion::Strict)
+    {
+        return MakeErrorT(serialization::TypeMismatchError)(std::string{expected}, std::string{getJsonTokenName(actual)});
+    }
+
+    return kResultSuccess;
+}
+
+template <typename T>
+Result<> jsonParseNumber(std::string_view str, T& value)
+{
+    const auto [ptr, err] = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (err == std::errc::result_out_of_range || (std::is_unsigned_v<T> && err == std::errc::invalid_argument && str.starts_with('-')))
+    {
+        return MakeErrorT(serialization::NumericOverflowError)();
+    }
+
+    if (err != std::errc{} || ptr != str.data() + str.size())
+    {
+        return MakeErrorT(serialization::SerializationError)(std::format("Invalid number:({})", str));
+    }
+
+    return kResultSuccess;
+}
+
+template <std::integral T>
+Result<> jsonReadInteger(JsonTextReader& reader, T& value, serialization::TypeCoercion typeCoercion)
+{
+    const JsonToken token = reader.peekToken();
+    if (token == JsonToken::String)
+    {
+        CheckResult(jsonCheckTypeCoercion(token, "number", typeCoercion));
+        std::string buffer;
+        Result<std::string_view> str = reader.readString(buffer);
+        CheckResult(str);
+
+        return jsonParseNumber(*str, value);
+    }
+
+    bool isFloat = false;
+    Result<std::string_view> number = reader.readNumber(isFloat);
+    CheckResult(number);
+
+    if (!isFloat)
+    {
+        return jsonParseNumber(*number, value);
+    }
+
+    if (typeCoercion == serialization::TypeCoercion::Strict)
+    {
+        return MakeErrorT(serialization::TypeMismatchError)("integer", "float");
+    }
+
+    double floatValue = 0.;
+    CheckResult(jsonParseNumber(*number, floatValue));
+
+    // max() is not representable by double (for 64 bit integers it is rounded up to 2^63 or 2^64),
+    // so the exact power of two is used as the exclusive upper bound.
+    constexpr double UpperBound = 2. * static_cast<double>(std::numeric_limits<T>::max() / 2 + 1);
+
+    floatValue = std::floor(floatValue);
+    if (!(floatValue >= static_cast<double>(std::numeric_limits<T>::min()) && floatValue < UpperBound))
+    {
+        return MakeErrorT(serialization::NumericOverflowError)();
+    }
+
+    value = static_cast<T>(floatValue);
+    return kResultSuccess;
+}
+
+template <std::floating_point T>
+Result<> jsonReadFloat(JsonTextReader& reader, T& value, serialization::TypeCoercion typeCoercion)
+{
+    const JsonToken token = reader.peekToken();
+    if (token == JsonToken::String)
+    {
+        CheckResult(jsonCheckTypeCoercion(token, "number", typeCoercion));
+        std::string buffer;
+        Result<std::string_view> str = reader.readString(buffer);
+        CheckResult(str);
+
+        return jsonParseNumber(*str, value);
+    }
+
+    bool isFloat = false;
+    Result<std::string_view> number = reader.readNumber(isFloat);
+    CheckResult(number);
+
+    return jsonParseNumber(*number, value);
+}
+
+inline Result<> jsonReadBoolean(JsonTextReader& reader, bool& value, serialization::TypeCoercion typeCoercion)
+{
+    const JsonToken token = reader.peekToken();
+    if (token == JsonToken::String)
+    {
+        CheckResult(jsonCheckTypeCoercion(token, "boolean", typeCoercion));
+        std::string buffer;
+        Result<std::string_view> str = reader.readString(buffer);
+        CheckResult(str);
+
+        if (str->empty() || strings::icaseEqual(*str, "false"))
+        {
+            value = false;
+        }
+        else if (strings::icaseEqual(*str, "true"))
+        {
+            value = true;
+        }
+        else
+        {
+            return MakeErrorT(serialization::SerializationError)(std::format("Invalid boolean value:({})", *str));
+        }
+
+        return kResultSuccess;
+    }
+
+    Result<bool> boolValue = reader.readBoolean();
+    CheckResult(boolValue);
+    value = *boolValue;
+
+    return kResultSuccess;
+}
+
+inline Result<> jsonReadString(JsonTextReader& reader, std::string& value, serialization::TypeCoercion typeCoercion)
+{
+    const JsonToken token = reader.peekToken();
+    if (token == JsonToken::String)
+    {
+        Result<std::string_view> str = reader.readString(value);
+        CheckResult(str);
+
+        // the string was decoded into the value itself if it contains escape sequences
+        if (str->data() != value.data())
+        {
+            value.assign(*str);
+        }
+
+        return kResultSuccess;
+    }
+
+    if (token == JsonToken::Number)
+    {
+        CheckResult(jsonCheckTypeCoercion(token, "string", typeCoercion));
+        bool isFloat = false;
+        Result<std::string_view> number = reader.readNumber(isFloat);
+        CheckResult(number);
+        value.assign(*number);
+
+        return kResultSuccess;
+    }
+
+    if (token == JsonToken::Boolean)
+    {
+        CheckResult(jsonCheckTypeCoercion(token, "string", typeCoercion));
+        Result<bool> boolValue = reader.readBoolean();
+        CheckResult(boolValue);
+        value.assign(*boolValue ? "true" : "false");
+
+        return kResultSuccess;
+    }
+
+    return MakeErrorT(serialization::TypeMismatchError)("string", std::string{getJsonTokenName(token)});
+}
+
+template <typename T>
+Result<> jsonReadValue(JsonTextReader& reader, T& value, serialization::TypeCoercion typeCoercion)
+{
+    const JsonToken token = reader.peekToken();
+
+    if constexpr (std::is_same_v<T, RuntimeValuePtr>)
+    {
+        if (token == JsonToken::Null)
+        {
+            value = nullptr;
+            return reader.readNull();
+        }
+
+        const size_t start = reader.getPosition();
+        CheckResult(reader.skipValue());
+
+        Result<RuntimeValuePtr> parseResult = serialization::jsonParseString(reader.getText(start, reader.getPosition()));
+        CheckResult(parseResult);
+        value = *std::move(parseResult);
+
+        return kResultSuccess;
+    }
+    else if constexpr (LikeStdOptional<T>)
+    {
+        if (token == JsonToken::Null)
+        {
+            value.reset();
+            return reader.readNull();
+        }
+
+        if (!value.has_value())
+        {
+            value.emplace();
+        }
+
+        return jsonReadValue(reader, *value, typeCoercion);
+    }
+    else
+    {
+        if (token == JsonToken::Null)
+        {
+            if constexpr (std::is_same_v<T, std::string> || LikeStdCollection<T> || LikeSet<T> || LikeStdMap<T>)
+            {
+                value.clear();
+            }
+
+            return reader.readNull();
+        }
+
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            return jsonReadBoolean(reader, value, typeCoercion);
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            return jsonReadInteger(reader, value, typeCoercion);
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            return jsonReadFloat(reader, value, typeCoercion);
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+        {
+            return jsonReadString(reader, value, typeCoercion);
+        }
+        else if constexpr (NauClassWithFields<T>)
+        {
+            return JsonClassCodec<T>::getInstance().read(reader, value, typeCoercion);
+        }
+        else if constexpr (StringParsable<T>)
+        {
+            std::string buffer;
+            Result<std::string_view> str = reader.readString(buffer);
+            CheckResult(str);
+
+            return parse(*str, value);
+        }
+        else if constexpr (LikeStdMap<T>)
+        {
+            using Key = typename T::key_type;
+
+            value.clear();
+            return reader.readObject([&](std::string_view key) -> Result<>
+            {
+                Key mapKey{};
+                if constexpr (std::is_constructible_v<Key, std::string_view>)
+                {
+                    mapKey = Key{key};
+                }
+                else
+                {
+                    static_assert(StringParsable<Key>, "Dictionary key type must be constructible from string or be string parsable");
+                    CheckResult(parse(key, mapKey));
+                }
+
+                auto [iter, emplaced] = value.try_emplace(std::move(mapKey));
+                return jsonReadValue(reader, iter->second, typeCoercion);
+            });
+        }
+        else if constexpr (LikeStdCollection<T>)
+        {
+            value.clear();
+            return reader.readArray([&]
+            {
+                return jsonReadValue(reader, value.emplace_back(), typeCoercion);
+            });
+        }
+        else if constexpr (LikeSet<T>)
+        {
+            value.clear();
+            return reader.readArray([&]() -> Result<>
+            {
+                typename T::value_type element{};
+                CheckResult(jsonReadValue(reader, element, typeCoercion));
+                value.insert(std::move(element));
+
+                return kResultSuccess;
+            });
+        }
+        else if constexpr (LikeTuple<T>)
+        {
+            size_t index = 0;
+            return reader.readArray([&]() -> Result<>
+            {
+                Result<> result;
+                const bool isElementRead = std::apply([&](auto&... element)
+                {
+                    size_t elementIndex = 0;
+                    return ((index == elementIndex++ ? (result = jsonReadValue(reader, element, typeCoercion), true) : false) || ...);
+                }, value);
+
+                ++index;
+                return isElementRead ? result : reader.skipValue();
+            });
+        }
+        else if constexpr (LikeUniformTuple<T>)
+        {
+            size_t index = 0;
+            return reader.readArray([&]
+            {
+                return index < value.size() ? jsonReadValue(reader, value[index++], typeCoercion) : reader.skipValue();
+            });
+        }
+        else
+        {
+            static_assert(std::is_same_v<T, void>, "Type is not supported by the json codec");
+        }
+    }
+}
+
+template <typename T>
+void jsonWriteValue(JsonTextWriter& writer, const T& value)
+{
+    if constexpr (std::is_same_v<T, RuntimeValuePtr>)
+    {
+        jsonWriteRuntimeValue(writer, value);
+    }
+    else if constexpr (LikeStdOptional<T>)
+    {
+        if (value.has_value())
+        {
+            jsonWriteValue(writer, *value);
+        }
+        else
+        {
+            writer.writeNull();
+        }
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        writer.writeBoolean(value);
+    }
+    else if constexpr (std::is_arithmetic_v<T>)
+    {
+        writer.writeNumber(value);
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+    {
+        writer.writeString(value);
+    }
+    else if constexpr (NauClassWithFields<T>)
+    {
+        JsonClassCodec<T>::getInstance().write(writer, value);
+    }
+    else if constexpr (StringConvertible<T>)
+    {
+        writer.writeString(toString(value));
+    }
+    else if constexpr (LikeStdMap<T>)
+    {
+        using Key = typename T::key_type;
+
+        writer.beginObject();
+        for (const auto& [key, element] : value)
+        {
+            if constexpr (std::is_convertible_v<const Key&, std::string_view>)
+            {
+                writer.writeKey(key);
+            }
+            else
+            {
+                static_assert(StringConvertible<Key>, "Dictionary key type must be convertible to string");
+                writer.writeKey(toString(key));
+            }
+
+            jsonWriteValue(writer, element);
+        }
+        writer.endObject();
+    }
+    else if constexpr (LikeStdCollection<T> || LikeSet<T> || LikeUniformTuple<T>)
+    {
+        writer.beginArray();
+        for (const auto& element : value)
+        {
+            jsonWriteValue(writer, element);
+        }
+        writer.endArray();
+    }
+    else if constexpr (LikeTuple<T>)
+    {
+        writer.beginArray();
+        std::apply([&writer](const auto&... element)
+        {
+            (jsonWriteValue(writer, element), ...);
+        }, value);
+        writer.endArray();
+    }
+    else
+    {
+        static_assert(std::is_same_v<T, void>, "Type is not supported by the json codec");
+    }
+}
+
+}  // namespace my::ser_detail
+
+namespace my::serialization {
+
+/**
+    Reflection based JSON codec: reads and writes MY_CLASS_FIELDS types (and the standard containers of them)
+    directly from/to the JSON text without building the json or the runtime value trees.
+
+    Field lookup goes through the per type perfect hash over the field names, that is built on the first use of the type.
+    Supports RequiredFieldAttribute, IgnoreEmptyFieldAttribute and TypeCoercion field attributes.
+    Unlike the runtime value path, the TypeCoercion::Strict is respected.
+    RuntimeValuePtr fields are parsed/written through the generic runtime value path.
+ */
+struct JsonCodec
+{
+    template <typename T>
+    static Result<> parse(T& value, std::string_view jsonString)
+    {
+        ser_detail::JsonTextReader reader{jsonString};
+        if (reader.isEnd())
+        {
+            return MakeErrorT(EndOfStreamError)();
+        }
+
+        CheckResult(ser_detail::jsonReadValue(reader, value, TypeCoercion::Default));
+        if (!reader.isEnd())
+        {
+            return reader.makeError("Unexpected data after the root value");
+        }
+
+        return kResultSuccess;
+    }
+
+    template <typename T>
+    static Result<T> parse(std::string_view jsonString)
+    {
+        T value{};
+        CheckResult(parse(value, jsonString));
+
+        return value;
+    }
+
+    template <typename T>
+    static void stringify(std::string& output, const T& value, JsonSettings settings = {})
+    {
+        ser_detail::JsonTextWriter writer{output, settings};
+        ser_detail::jsonWriteValue(writer, value);
+    }
+
+    template <typename T>
+    static std::string stringify(const T& value, JsonSettings settings = {})
+    {
+        std::string output;
+        stringify(output, value, settings);
+
+        return output;
+    }
+
+    /**
+        Writes the value into the stream by the JsonTextWriter::StreamBlockSize blocks.
+     */
+    template <typename T>
+    static Result<> stringify(io::IStream& stream, const T& value, JsonSettings settings = {})
+    {
+        ser_detail::JsonTextWriter writer{stream, settings};
+        ser_detail::jsonWriteValue(writer, value);
+
+        return writer.flush();
+    }
+};
+
+}  // namespace my::serialization
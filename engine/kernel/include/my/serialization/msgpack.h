@@ -0,0 +1,1317 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include "my/io/stream.h"
+#include "my/kernel/kernel_config.h"
+#include "my/memory/allocator.h"
+#include "my/memory/buffer.h"
+#include "my/meta/class_info.h"
+#include "my/rtti/type_info.h"
+#include "my/serialization/native_runtime_value/native_value_forwards.h"
+#include "my/serialization/runtime_value.h"
+#include "my/serialization/serialization.h"
+#include "my/utils/perfect_hash.h"
+#include "my/utils/result.h"
+#include "my/utils/to_string.h"
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+namespace my::serialization {
+
+/**
+    Read-only view of the MessagePack 'bin' value.
+    Also is a collection of the uint8_t values, so it can be assigned to std::vector<uint8_t> through the runtime value path.
+ */
+struct MY_ABSTRACT_TYPE MsgPackBinary : ReadonlyCollection
+{
+    MY_INTERFACE(my::serialization::MsgPackBinary, ReadonlyCollection)
+
+    /**
+        @return View into the buffer the value was parsed from (the buffer is kept alive by the value).
+     */
+    virtual std::span<const std::byte> getBytes() const = 0;
+};
+
+/**
+    Writes the runtime value as MessagePack.
+    Dictionaries are written as maps with the string keys, MsgPackBinary values are written as 'bin'.
+ */
+MY_KERNEL_EXPORT
+Result<> msgpackWrite(io::IStream&, const RuntimeValuePtr&);
+
+/**
+    Parses the MessagePack data, the whole buffer must contain the single value.
+    Returned values are read-only views into the buffer: strings, dictionary keys and binaries are not copied while parsing,
+    containers decode their elements on access.
+ */
+MY_KERNEL_EXPORT
+Result<RuntimeValuePtr> msgpackParse(ReadOnlyBuffer, IAllocator* = nullptr);
+
+/**
+    Reads the stream to the end and parses it (see msgpackParse(ReadOnlyBuffer)).
+ */
+MY_KERNEL_EXPORT
+Result<RuntimeValuePtr> msgpackParse(io::IStream&, IAllocator* = nullptr);
+
+}  // namespace my::serialization
+
+namespace my::ser_detail {
+
+/**
+ */
+enum class MsgPackType
+{
+    End,
+    Invalid,
+    Nil,
+    Boolean,
+    Integer,
+    Float,
+    String,
+    Binary,
+    Array,
+    Map,
+    Extension
+};
+
+inline std::string_view getMsgPackTypeName(MsgPackType type)
+{
+    switch (type)
+    {
+        case MsgPackType::End:
+            return "end of data";
+        case MsgPackType::Nil:
+            return "nil";
+        case MsgPackType::Boolean:
+            return "boolean";
+        case MsgPackType::Integer:
+            return "integer";
+        case MsgPackType::Float:
+            return "float";
+        case MsgPackType::String:
+            return "string";
+        case MsgPackType::Binary:
+            return "binary";
+        case MsgPackType::Array:
+            return "array";
+        case MsgPackType::Map:
+            return "map";
+        case MsgPackType::Extension:
+            return "extension";
+        default:
+            return "invalid";
+    }
+}
+
+/**
+    Integer of any MessagePack width.
+ */
+struct MsgPackInteger
+{
+    uint64_t bits = 0;
+    bool isNegative = false;
+
+    int64_t asInt64() const
+    {
+        return static_cast<int64_t>(bits);
+    }
+};
+
+/**
+    MessagePack reader over the memory block. Never copies strings or binaries.
+ */
+class MsgPackReader
+{
+public:
+    static constexpr size_t MaxDepth = 512;
+
+    explicit MsgPackReader(std::span<const std::byte> data) :
+        m_data(data)
+    {
+    }
+
+    bool isEnd() const
+    {
+        return m_pos >= m_data.size();
+    }
+
+    size_t getPosition() const
+    {
+        return m_pos;
+    }
+
+    MsgPackType peekType() const
+    {
+        if (isEnd())
+        {
+            return MsgPackType::End;
+        }
+
+        const auto marker = static_cast<uint8_t>(m_data[m_pos]);
+        if (marker <= 0x7f || marker >= 0xe0)
+        {
+            return MsgPackType::Integer;
+        }
+
+        if (marker <= 0x8f)
+        {
+            return MsgPackType::Map;
+        }
+
+        if (marker <= 0x9f)
+        {
+            return MsgPackType::Array;
+        }
+
+        if (marker <= 0xbf)
+        {
+            return MsgPackType::String;
+        }
+
+        switch (marker)
+        {
+            case 0xc0:
+                return MsgPackType::Nil;
+            case 0xc2:
+            case 0xc3:
+                return MsgPackType::Boolean;
+            case 0xc4:
+            case 0xc5:
+            case 0xc6:
+                return MsgPackType::Binary;
+            case 0xc7:
+            case 0xc8:
+            case 0xc9:
+            case 0xd4:
+            case 0xd5:
+            case 0xd6:
+            case 0xd7:
+            case 0xd8:
+                return MsgPackType::Extension;
+            case 0xca:
+            case 0xcb:
+                return MsgPackType::Float;
+            case 0xcc:
+            case 0xcd:
+            case 0xce:
+            case 0xcf:
+            case 0xd0:
+            case 0xd1:
+            case 0xd2:
+            case 0xd3:
+                return MsgPackType::Integer;
+            case 0xd9:
+            case 0xda:
+            case 0xdb:
+                return MsgPackType::String;
+            case 0xdc:
+            case 0xdd:
+                return MsgPackType::Array;
+            case 0xde:
+            case 0xdf:
+                return MsgPackType::Map;
+            default:
+                return MsgPackType::Invalid;
+        }
+    }
+
+    Result<> readNil()
+    {
+        CheckResult(expectType(MsgPackType::Nil));
+        ++m_pos;
+
+        return kResultSuccess;
+    }
+
+    Result<bool> readBoolean()
+    {
+        CheckResult(expectType(MsgPackType::Boolean));
+        return static_cast<uint8_t>(m_data[m_pos++]) == 0xc3;
+    }
+
+    Result<MsgPackInteger> readInteger()
+    {
+        CheckResult(expectType(MsgPackType::Integer));
+
+        const auto marker = static_cast<uint8_t>(m_data[m_pos++]);
+        if (marker <= 0x7f)
+        {
+            return MsgPackInteger{marker, false};
+        }
+
+        if (marker >= 0xe0)
+        {
+            return MsgPackInteger{static_cast<uint64_t>(static_cast<int64_t>(static_cast<int8_t>(marker))), true};
+        }
+
+        switch (marker)
+        {
+            case 0xcc:
+                return readUnsigned<uint8_t>();
+            case 0xcd:
+                return readUnsigned<uint16_t>();
+            case 0xce:
+                return readUnsigned<uint32_t>();
+            case 0xcf:
+                return readUnsigned<uint64_t>();
+            case 0xd0:
+                return readSigned<int8_t>();
+            case 0xd1:
+                return readSigned<int16_t>();
+            case 0xd2:
+                return readSigned<int32_t>();
+            default:
+                return readSigned<int64_t>();
+        }
+    }
+
+    /**
+        @param isSingle Set to true if the value is stored as float32.
+     */
+    Result<double> readFloat(bool* isSingle = nullptr)
+    {
+        CheckResult(expectType(MsgPackType::Float));
+
+        const bool single = static_cast<uint8_t>(m_data[m_pos++]) == 0xca;
+        if (isSingle)
+        {
+            *isSingle = single;
+        }
+
+        if (single)
+        {
+            Result<uint32_t> bits = readBigEndian<uint32_t>();
+            CheckResult(bits);
+            return static_cast<double>(std::bit_cast<float>(*bits));
+        }
+
+        Result<uint64_t> bits = readBigEndian<uint64_t>();
+        CheckResult(bits);
+        return std::bit_cast<double>(*bits);
+    }
+
+    /**
+        @return View into the reader's data.
+     */
+    Result<std::string_view> readString()
+    {
+        CheckResult(expectType(MsgPackType::String));
+
+        const auto marker = static_cast<uint8_t>(m_data[m_pos++]);
+        Result<size_t> size = marker <= 0xbf ? Result<size_t>{static_cast<size_t>(marker & 0x1f)} : readLength(marker - 0xd9);
+        CheckResult(size);
+
+        Result<std::span<const std::byte>> bytes = readBytes(*size);
+        CheckResult(bytes);
+        return std::string_view{reinterpret_cast<const char*>(bytes->data()), bytes->size()};
+    }
+
+    /**
+        @return View into the reader's data.
+     */
+    Result<std::span<const std::byte>> readBinary()
+    {
+        CheckResult(expectType(MsgPackType::Binary));
+
+        const auto marker = static_cast<uint8_t>(m_data[m_pos++]);
+        Result<size_t> size = readLength(marker - 0xc4);
+        CheckResult(size);
+
+        return readBytes(*size);
+    }
+
+    Result<size_t> readArrayHeader()
+    {
+        CheckResult(expectType(MsgPackType::Array));
+
+        const auto marker = static_cast<uint8_t>(m_data[m_pos++]);
+        return marker <= 0x9f ? Result<size_t>{static_cast<size_t>(marker & 0x0f)} : readLength(marker - 0xdc + 1);
+    }
+
+    Result<size_t> readMapHeader()
+    {
+        CheckResult(expectType(MsgPackType::Map));
+
+        const auto marker = static_cast<uint8_t>(m_data[m_pos++]);
+        return marker <= 0x8f ? Result<size_t>{static_cast<size_t>(marker & 0x0f)} : readLength(marker - 0xde + 1);
+    }
+
+    Result<> skipValue()
+    {
+        return skipValue(0);
+    }
+
+    /**
+        Skips the value.
+        @return Encoded bytes of the skipped value.
+     */
+    Result<std::span<const std::byte>> readRawValue()
+    {
+        const size_t start = m_pos;
+        CheckResult(skipValue(0));
+
+        return m_data.subspan(start, m_pos - start);
+    }
+
+    ErrorPtr makeError(std::string_view message) const
+    {
+        return MakeErrorT(serialization::SerializationError)(std::format("{} (offset:{})", message, m_pos));
+    }
+
+private:
+    /**
+        @param lengthKind 0, 1, 2 for the 8, 16, 32 bits lengths.
+     */
+    Result<size_t> readLength(int lengthKind)
+    {
+        switch (lengthKind)
+        {
+            case 0:
+                return toSize(readBigEndian<uint8_t>());
+            case 1:
+                return toSize(readBigEndian<uint16_t>());
+            default:
+                return toSize(readBigEndian<uint32_t>());
+        }
+    }
+
+    template <typename T>
+    static Result<size_t> toSize(Result<T> value)
+    {
+        CheckResult(value);
+        return static_cast<size_t>(*value);
+    }
+
+    Result<> expectType(MsgPackType type) const
+    {
+        if (const MsgPackType actualType = peekType(); actualType != type)
+        {
+            if (actualType == MsgPackType::End)
+            {
+                return MakeErrorT(serialization::EndOfStreamError)();
+            }
+
+            return MakeErrorT(serialization::TypeMismatchError)(std::string{getMsgPackTypeName(type)}, std::string{getMsgPackTypeName(actualType)});
+        }
+
+        return kResultSuccess;
+    }
+
+    Result<std::span<const std::byte>> readBytes(size_t size)
+    {
+        if (m_data.size() - m_pos < size)
+        {
+            return MakeErrorT(serialization::EndOfStreamError)();
+        }
+
+        const std::span<const std::byte> bytes = m_data.subspan(m_pos, size);
+        m_pos += size;
+
+        return bytes;
+    }
+
+    template <typename T>
+    Result<T> readBigEndian()
+    {
+        Result<std::span<const std::byte>> bytes = readBytes(sizeof(T));
+        CheckResult(bytes);
+
+        T value;
+        std::memcpy(&value, bytes->data(), sizeof(T));
+        if constexpr (std::endian::native == std::endian::little && sizeof(T) > 1)
+        {
+            value = std::byteswap(value);
+        }
+
+        return value;
+    }
+
+    template <typename T>
+    Result<MsgPackInteger> readUnsigned()
+    {
+        Result<T> value = readBigEndian<T>();
+        CheckResult(value);
+
+        return MsgPackInteger{static_cast<uint64_t>(*value), false};
+    }
+
+    template <typename T>
+    Result<MsgPackInteger> readSigned()
+    {
+        Result<std::make_unsigned_t<T>> value = readBigEndian<std::make_unsigned_t<T>>();
+        CheckResult(value);
+
+        const auto signedValue = static_cast<int64_t>(static_cast<T>(*value));
+        return MsgPackInteger{static_cast<uint64_t>(signedValue), signedValue < 0};
+    }
+
+    Result<> skipValue(size_t depth)
+    {
+        if (depth > MaxDepth)
+        {
+            return makeError("Maximum nesting depth exceeded");
+        }
+
+        switch (const MsgPackType type = peekType(); type)
+        {
+            case MsgPackType::Nil:
+                return readNil();
+            case MsgPackType::Boolean:
+            {
+                Result<bool> value = readBoolean();
+                CheckResult(value);
+                return kResultSuccess;
+            }
+            case MsgPackType::Integer:
+            {
+                Result<MsgPackInteger> value = readInteger();
+                CheckResult(value);
+                return kResultSuccess;
+            }
+            case MsgPackType::Float:
+            {
+                Result<double> value = readFloat();
+                CheckResult(value);
+                return kResultSuccess;
+            }
+            case MsgPackType::String:
+            {
+                Result<std::string_view> value = readString();
+                CheckResult(value);
+                return kResultSuccess;
+            }
+            case MsgPackType::Binary:
+            {
+                Result<std::span<const std::byte>> value = readBinary();
+                CheckResult(value);
+                return kResultSuccess;
+            }
+            case MsgPackType::Array:
+            case MsgPackType::Map:
+            {
+                Result<size_t> size = type == MsgPackType::Array ? readArrayHeader() : readMapHeader();
+                CheckResult(size);
+
+                const size_t elementsCount = type == MsgPackType::Array ? *size : *size * 2;
+                for (size_t i = 0; i < elementsCount; ++i)
+                {
+                    CheckResult(skipValue(depth + 1));
+                }
+
+                return kResultSuccess;
+            }
+            case MsgPackType::End:
+                return MakeErrorT(serialization::EndOfStreamError)();
+            default:
+                return makeError(std::format("Unsupported value type ({})", getMsgPackTypeName(type)));
+        }
+    }
+
+    const std::span<const std::byte> m_data;
+    size_t m_pos = 0;
+};
+
+/**
+    Writes MessagePack into the stream by the block sized portions, flush() must be called at the end.
+    Integers are written with the smallest encoding that keeps the value.
+ */
+class MsgPackWriter
+{
+public:
+    static constexpr size_t StreamBlockSize = 16 * 1024;
+
+    explicit MsgPackWriter(io::IStream& stream) :
+        m_stream(stream)
+    {
+        MY_DEBUG_ASSERT(stream.canWrite());
+        m_buffer.reserve(StreamBlockSize + StreamBlockSize / 4);
+    }
+
+    MsgPackWriter(const MsgPackWriter&) = delete;
+    MsgPackWriter& operator=(const MsgPackWriter&) = delete;
+
+    /**
+        Writes the buffered data into the stream.
+        @return First error of the stream writes.
+     */
+    Result<> flush()
+    {
+        writeToStream();
+        if (m_streamError)
+        {
+            return m_streamError;
+        }
+
+        return kResultSuccess;
+    }
+
+    void writeNil()
+    {
+        putByte(0xc0);
+        flushFullBlock();
+    }
+
+    void writeBoolean(bool value)
+    {
+        putByte(value ? 0xc3 : 0xc2);
+        flushFullBlock();
+    }
+
+    template <std::integral T>
+    void writeInteger(T value)
+    {
+        if constexpr (std::is_signed_v<T>)
+        {
+            if (value < 0)
+            {
+                writeNegative(static_cast<int64_t>(value));
+                return;
+            }
+        }
+
+        writeUnsigned(static_cast<uint64_t>(value));
+    }
+
+    void writeFloat(float value)
+    {
+        putByte(0xca);
+        putBigEndian(std::bit_cast<uint32_t>(value));
+        flushFullBlock();
+    }
+
+    void writeDouble(double value)
+    {
+        putByte(0xcb);
+        putBigEndian(std::bit_cast<uint64_t>(value));
+        flushFullBlock();
+    }
+
+    void writeString(std::string_view str)
+    {
+        putHeader(str.size(), 0xa0, 31, 0xd9, true);
+        m_buffer.append(str);
+        flushFullBlock();
+    }
+
+    void writeBinary(std::span<const std::byte> bytes)
+    {
+        putHeader(bytes.size(), 0, 0, 0xc4, true);
+        m_buffer.append(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        flushFullBlock();
+    }
+
+    /**
+        Array header, must be followed by the 'size' values.
+     */
+    void beginArray(size_t size)
+    {
+        putHeader(size, 0x90, 15, 0xdc, false);
+    }
+
+    /**
+        Map header, must be followed by the 'size' key/value pairs.
+     */
+    void beginMap(size_t size)
+    {
+        putHeader(size, 0x80, 15, 0xde, false);
+    }
+
+private:
+    void writeUnsigned(uint64_t value)
+    {
+        if (value <= 0x7f)
+        {
+            putByte(static_cast<uint8_t>(value));
+        }
+        else if (value <= std::numeric_limits<uint8_t>::max())
+        {
+            putByte(0xcc);
+            putByte(static_cast<uint8_t>(value));
+        }
+        else if (value <= std::numeric_limits<uint16_t>::max())
+        {
+            putByte(0xcd);
+            putBigEndian(static_cast<uint16_t>(value));
+        }
+        else if (value <= std::numeric_limits<uint32_t>::max())
+        {
+            putByte(0xce);
+            putBigEndian(static_cast<uint32_t>(value));
+        }
+        else
+        {
+            putByte(0xcf);
+            putBigEndian(value);
+        }
+
+        flushFullBlock();
+    }
+
+    void writeNegative(int64_t value)
+    {
+        if (value >= -32)
+        {
+            putByte(static_cast<uint8_t>(static_cast<int8_t>(value)));
+        }
+        else if (value >= std::numeric_limits<int8_t>::min())
+        {
+            putByte(0xd0);
+            putByte(static_cast<uint8_t>(static_cast<int8_t>(value)));
+        }
+        else if (value >= std::numeric_limits<int16_t>::min())
+        {
+            putByte(0xd1);
+            putBigEndian(static_cast<uint16_t>(static_cast<int16_t>(value)));
+        }
+        else if (value >= std::numeric_limits<int32_t>::min())
+        {
+            putByte(0xd2);
+            putBigEndian(static_cast<uint32_t>(static_cast<int32_t>(value)));
+        }
+        else
+        {
+            putByte(0xd3);
+            putBigEndian(static_cast<uint64_t>(value));
+        }
+
+        flushFullBlock();
+    }
+
+    /**
+        @param fixMarker, fixMaxSize Marker and the max size of the fixed encoding (fixMaxSize == 0 if there is no fixed encoding).
+        @param marker Marker of the first sized encoding (the next markers are for the wider sizes).
+        @param hasSize8 Whether the 8 bits size encoding exists.
+     */
+    void putHeader(size_t size, uint8_t fixMarker, size_t fixMaxSize, uint8_t marker, bool hasSize8)
+    {
+        MY_DEBUG_ASSERT(size <= std::numeric_limits<uint32_t>::max());
+
+        if (size <= fixMaxSize)
+        {
+            putByte(static_cast<uint8_t>(fixMarker | size));
+            return;
+        }
+
+        if (hasSize8)
+        {
+            if (size <= std::numeric_limits<uint8_t>::max())
+            {
+                putByte(marker);
+                putByte(static_cast<uint8_t>(size));
+                return;
+            }
+
+            ++marker;
+        }
+
+        if (size <= std::numeric_limits<uint16_t>::max())
+        {
+            putByte(marker);
+            putBigEndian(static_cast<uint16_t>(size));
+        }
+        else
+        {
+            putByte(marker + 1);
+            putBigEndian(static_cast<uint32_t>(size));
+        }
+    }
+
+    void putByte(uint8_t value)
+    {
+        m_buffer.push_back(static_cast<char>(value));
+    }
+
+    template <typename T>
+    void putBigEndian(T value)
+    {
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            value = std::byteswap(value);
+        }
+
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        m_buffer.append(bytes, sizeof(T));
+    }
+
+    void flushFullBlock()
+    {
+        if (m_buffer.size() >= StreamBlockSize)
+        {
+            writeToStream();
+        }
+    }
+
+    void writeToStream()
+    {
+        if (!m_streamError && !m_buffer.empty())
+        {
+            const auto* const data = reinterpret_cast<const std::byte*>(m_buffer.data());
+            for (size_t offset = 0; offset < m_buffer.size();)
+            {
+                Result<size_t> written = m_stream.write(data + offset, m_buffer.size() - offset);
+                if (!written || *written == 0)
+                {
+                    m_streamError = written ? MakeErrorT(serialization::SerializationError)("Stream write failed") : written.getError();
+                    break;
+                }
+
+                offset += *written;
+            }
+        }
+
+        m_buffer.clear();
+    }
+
+    io::IStream& m_stream;
+    std::string m_buffer;
+    ErrorPtr m_streamError;
+};
+
+/**
+    Writes the runtime value with the writer.
+ */
+MY_KERNEL_EXPORT
+void msgpackWriteRuntimeValue(MsgPackWriter& writer, const RuntimeValuePtr& value);
+
+template <typename T>
+Result<> msgpackReadValue(MsgPackReader& reader, T& value, serialization::TypeCoercion typeCoercion);
+
+template <typename T>
+void msgpackWriteValue(MsgPackWriter& writer, const T& value);
+
+template <typename T>
+inline constexpr bool IsMsgPackBinaryCollection = LikeStdCollection<T> && std::is_same_v<typename T::value_type, std::byte>;
+
+/**
+    Reflected fields are written as the map keyed by the field names (readable by the runtime value path).
+    Reading looks up the fields through the perfect hash built on first use of the type.
+ */
+template <typename T>
+class MsgPackClassCodec
+{
+public:
+    static const MsgPackClassCodec& getInstance()
+    {
+        static const MsgPackClassCodec instance;
+        return instance;
+    }
+
+    Result<> read(MsgPackReader& reader, T& object, serialization::TypeCoercion typeCoercion) const
+    {
+        Result<size_t> size = reader.readMapHeader();
+        CheckResult(size);
+
+        std::array<bool, FieldsCount> isFieldRead{};
+        for (size_t i = 0; i < *size; ++i)
+        {
+            Result<std::string_view> key = reader.readString();
+            CheckResult(key);
+
+            const size_t index = m_fieldsIndex.find(*key);
+            if (index == StringPerfectHash::NotFound)
+            {
+                CheckResult(reader.skipValue());
+                continue;
+            }
+
+            isFieldRead[index] = true;
+            CheckResult(readField(reader, object, index, typeCoercion, std::make_index_sequence<FieldsCount>{}));
+        }
+
+        return checkRequiredFields(isFieldRead, std::make_index_sequence<FieldsCount>{});
+    }
+
+    void write(MsgPackWriter& writer, const T& object) const
+    {
+        writer.beginMap(FieldsCount);
+        std::apply([&](const auto&... field)
+        {
+            ((writer.writeString(field.getName()), msgpackWriteValue(writer, field.getValue(object))), ...);
+        }, m_fields);
+    }
+
+private:
+    using Fields = decltype(meta::getClassAllFields<T>());
+
+    static constexpr size_t FieldsCount = std::tuple_size_v<Fields>;
+
+    static std::string getTypeName()
+    {
+        if constexpr (rtti::HasTypeInfo<T>)
+        {
+            return std::string{rtti::getTypeInfo<T>().getTypeName()};
+        }
+        else
+        {
+            return typeid(T).name();
+        }
+    }
+
+    template <typename Field>
+    static serialization::TypeCoercion getFieldTypeCoercion(const Field& field, serialization::TypeCoercion defaultTypeCoercion)
+    {
+        if constexpr (Field::template HasAttribute<serialization::TypeCoercion>)
+        {
+            return std::get<serialization::TypeCoercion>(field.getAttributes());
+        }
+        else
+        {
+            return defaultTypeCoercion;
+        }
+    }
+
+    MsgPackClassCodec() :
+        m_fields(meta::getClassAllFields<T>()),
+        m_fieldsIndex(makeFieldsIndex(m_fields))
+    {
+    }
+
+    static StringPerfectHash makeFieldsIndex(const Fields& fields)
+    {
+        const std::array<std::string_view, FieldsCount> names = std::apply([](const auto&... field)
+        {
+            return std::array<std::string_view, FieldsCount>{field.getName()...};
+        }, fields);
+
+        return StringPerfectHash{names};
+    }
+
+    template <size_t I>
+    Result<> readFieldAt(MsgPackReader& reader, T& object, serialization::TypeCoercion typeCoercion) const
+    {
+        const auto& field = std::get<I>(m_fields);
+        auto& fieldValue = field.getValue(object);
+
+        if constexpr (std::is_const_v<std::remove_reference_t<decltype(fieldValue)>>)
+        {
+            return reader.skipValue();
+        }
+        else
+        {
+            return msgpackReadValue(reader, fieldValue, getFieldTypeCoercion(field, typeCoercion));
+        }
+    }
+
+    template <size_t... I>
+    Result<> readField(MsgPackReader& reader, T& object, size_t index, serialization::TypeCoercion typeCoercion, std::index_sequence<I...>) const
+    {
+        Result<> result;
+        [[maybe_unused]] const bool isFound = ((index == I ? (result = readFieldAt<I>(reader, object, typeCoercion), true) : false) || ...);
+        MY_DEBUG_ASSERT(isFound);
+
+        return result;
+    }
+
+    template <size_t... I>
+    Result<> checkRequiredFields(const std::array<bool, FieldsCount>& isFieldRead, std::index_sequence<I...>) const
+    {
+        Result<> result;
+
+        const auto checkField = [&]<size_t Index>(std::integral_constant<size_t, Index>)
+        {
+            using Field = std::tuple_element_t<Index, Fields>;
+            if constexpr (Field::template HasAttribute<serialization::RequiredFieldAttribute>)
+            {
+                if (!isFieldRead[Index])
+                {
+                    result = MakeErrorT(serialization::RequiredFieldMissedError)(getTypeName(), std::string{std::get<Index>(m_fields).getName()});
+                    return false;
+                }
+            }
+
+            return true;
+        };
+
+        (checkField(std::integral_constant<size_t, I>{}) && ...);
+        return result;
+    }
+
+    const Fields m_fields;
+    const StringPerfectHash m_fieldsIndex;
+};
+
+template <std::integral T>
+Result<> msgpackReadInteger(MsgPackReader& reader, T& value, serialization::TypeCoercion typeCoercion)
+{
+    if (reader.peekType() == MsgPackType::Float && typeCoercion != serialization::TypeCoercion::Strict)
+    {
+        Result<double> floatValue = reader.readFloat();
+        CheckResult(floatValue);
+
+        if (*floatValue < static_cast<double>(std::numeric_limits<T>::min()) || *floatValue > static_cast<double>(std::numeric_limits<T>::max()))
+        {
+            return MakeErrorT(serialization::NumericOverflowError)();
+        }
+
+        value = static_cast<T>(*floatValue);
+        return kResultSuccess;
+    }
+
+    Result<MsgPackInteger> integer = reader.readInteger();
+    CheckResult(integer);
+
+    if (integer->isNegative)
+    {
+        if (!std::is_signed_v<T> || integer->asInt64() < static_cast<int64_t>(std::numeric_limits<T>::min()))
+        {
+            return MakeErrorT(serialization::NumericOverflowError)();
+        }
+    }
+    else if (integer->bits > static_cast<uint64_t>(std::numeric_limits<T>::max()))
+    {
+        return MakeErrorT(serialization::NumericOverflowError)();
+    }
+
+    value = static_cast<T>(integer->bits);
+    return kResultSuccess;
+}
+
+template <std::floating_point T>
+Result<> msgpackReadFloat(MsgPackReader& reader, T& value, serialization::TypeCoercion typeCoercion)
+{
+    if (reader.peekType() == MsgPackType::Integer && typeCoercion != serialization::TypeCoercion::Strict)
+    {
+        Result<MsgPackInteger> integer = reader.readInteger();
+        CheckResult(integer);
+
+        value = integer->isNegative ? static_cast<T>(integer->asInt64()) : static_cast<T>(integer->bits);
+        return kResultSuccess;
+    }
+
+    Result<double> floatValue = reader.readFloat();
+    CheckResult(floatValue);
+
+    value = static_cast<T>(*floatValue);
+    return kResultSuccess;
+}
+
+template <typename T>
+Result<> msgpackReadValue(MsgPackReader& reader, T& value, serialization::TypeCoercion typeCoercion)
+{
+    const MsgPackType type = reader.peekType();
+
+    if constexpr (std::is_same_v<T, RuntimeValuePtr>)
+    {
+        // parsed runtime values are views into their buffer, so the value is copied into the own buffer
+        Result<std::span<const std::byte>> bytes = reader.readRawValue();
+        CheckResult(bytes);
+
+        if (type == MsgPackType::Nil)
+        {
+            value = nullptr;
+            return kResultSuccess;
+        }
+
+        Buffer buffer{bytes->size()};
+        std::memcpy(buffer.data(), bytes->data(), bytes->size());
+
+        Result<RuntimeValuePtr> parseResult = serialization::msgpackParse(buffer.toReadOnly());
+        CheckResult(parseResult);
+        value = *std::move(parseResult);
+
+        return kResultSuccess;
+    }
+    else if constexpr (LikeStdOptional<T>)
+    {
+        if (type == MsgPackType::Nil)
+        {
+            value.reset();
+            return reader.readNil();
+        }
+
+        if (!value.has_value())
+        {
+            value.emplace();
+        }
+
+        return msgpackReadValue(reader, *value, typeCoercion);
+    }
+    else
+    {
+        if (type == MsgPackType::Nil)
+        {
+            if constexpr (std::is_same_v<T, std::string> || LikeStdCollection<T> || LikeSet<T> || LikeStdMap<T>)
+            {
+                value.clear();
+            }
+
+            return reader.readNil();
+        }
+
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            Result<bool> boolValue = reader.readBoolean();
+            CheckResult(boolValue);
+            value = *boolValue;
+
+            return kResultSuccess;
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            return msgpackReadInteger(reader, value, typeCoercion);
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            return msgpackReadFloat(reader, value, typeCoercion);
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+        {
+            Result<std::string_view> str = reader.readString();
+            CheckResult(str);
+            value.assign(*str);
+
+            return kResultSuccess;
+        }
+        else if constexpr (NauClassWithFields<T>)
+        {
+            return MsgPackClassCodec<T>::getInstance().read(reader, value, typeCoercion);
+        }
+        else if constexpr (StringParsable<T>)
+        {
+            Result<std::string_view> str = reader.readString();
+            CheckResult(str);
+
+            return parse(*str, value);
+        }
+        else if constexpr (LikeStdMap<T>)
+        {
+            using Key = typename T::key_type;
+
+            Result<size_t> size = reader.readMapHeader();
+            CheckResult(size);
+
+            value.clear();
+            for (size_t i = 0; i < *size; ++i)
+            {
+                Result<std::string_view> key = reader.readString();
+                CheckResult(key);
+
+                Key mapKey{};
+                if constexpr (std::is_constructible_v<Key, std::string_view>)
+                {
+                    mapKey = Key{*key};
+                }
+                else
+                {
+                    static_assert(StringParsable<Key>, "Dictionary key type must be constructible from string or be string parsable");
+                    CheckResult(parse(*key, mapKey));
+                }
+
+                auto [iter, emplaced] = value.try_emplace(std::move(mapKey));
+                CheckResult(msgpackReadValue(reader, iter->second, typeCoercion));
+            }
+
+            return kResultSuccess;
+        }
+        else if constexpr (IsMsgPackBinaryCollection<T>)
+        {
+            Result<std::span<const std::byte>> bytes = reader.readBinary();
+            CheckResult(bytes);
+
+            const auto* const data = reinterpret_cast<const typename T::value_type*>(bytes->data());
+            value.assign(data, data + bytes->size());
+
+            return kResultSuccess;
+        }
+        else if constexpr (LikeStdCollection<T> || LikeSet<T>)
+        {
+            Result<size_t> size = reader.readArrayHeader();
+            CheckResult(size);
+
+            value.clear();
+            if constexpr (requires { value.reserve(*size); })
+            {
+                value.reserve(*size);
+            }
+
+            for (size_t i = 0; i < *size; ++i)
+            {
+                if constexpr (LikeStdCollection<T>)
+                {
+                    CheckResult(msgpackReadValue(reader, value.emplace_back(), typeCoercion));
+                }
+                else
+                {
+                    typename T::value_type element{};
+                    CheckResult(msgpackReadValue(reader, element, typeCoercion));
+                    value.insert(std::move(element));
+                }
+            }
+
+            return kResultSuccess;
+        }
+        else if constexpr (LikeTuple<T> || LikeUniformTuple<T>)
+        {
+            Result<size_t> size = reader.readArrayHeader();
+            CheckResult(size);
+
+            if (*size != std::tuple_size_v<T>)
+            {
+                return reader.makeError(std::format("Expected ({}) elements, but ({}) found", std::tuple_size_v<T>, *size));
+            }
+
+            return std::apply([&](auto&... element)
+            {
+                Result<> result;
+                ((result = msgpackReadValue(reader, element, typeCoercion)) && ...);
+                return result;
+            }, value);
+        }
+        else
+        {
+            static_assert(std::is_same_v<T, void>, "Type is not supported by the msgpack codec");
+        }
+    }
+}
+
+template <typename T>
+void msgpackWriteValue(MsgPackWriter& writer, const T& value)
+{
+    if constexpr (std::is_same_v<T, RuntimeValuePtr>)
+    {
+        msgpackWriteRuntimeValue(writer, value);
+    }
+    else if constexpr (LikeStdOptional<T>)
+    {
+        if (value.has_value())
+        {
+            msgpackWriteValue(writer, *value);
+        }
+        else
+        {
+            writer.writeNil();
+        }
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        writer.writeBoolean(value);
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        writer.writeInteger(value);
+    }
+    else if constexpr (std::is_same_v<T, float>)
+    {
+        writer.writeFloat(value);
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        writer.writeDouble(static_cast<double>(value));
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+    {
+        writer.writeString(value);
+    }
+    else if constexpr (NauClassWithFields<T>)
+    {
+        MsgPackClassCodec<T>::getInstance().write(writer, value);
+    }
+    else if constexpr (StringConvertible<T>)
+    {
+        writer.writeString(toString(value));
+    }
+    else if constexpr (LikeStdMap<T>)
+    {
+        using Key = typename T::key_type;
+
+        writer.beginMap(value.size());
+        for (const auto& [key, element] : value)
+        {
+            if constexpr (std::is_convertible_v<const Key&, std::string_view>)
+            {
+                writer.writeString(key);
+            }
+            else
+            {
+                static_assert(StringConvertible<Key>, "Dictionary key type must be convertible to string");
+                writer.writeString(toString(key));
+            }
+
+            msgpackWriteValue(writer, element);
+        }
+    }
+    else if constexpr (IsMsgPackBinaryCollection<T>)
+    {
+        writer.writeBinary(std::as_bytes(std::span{value}));
+    }
+    else if constexpr (LikeStdCollection<T> || LikeSet<T> || LikeUniformTuple<T>)
+    {
+        writer.beginArray(static_cast<size_t>(std::distance(std::begin(value), std::end(value))));
+        for (const auto& element : value)
+        {
+            msgpackWriteValue(writer, element);
+        }
+    }
+    else if constexpr (LikeTuple<T>)
+    {
+        writer.beginArray(std::tuple_size_v<T>);
+        std::apply([&writer](const auto&... element)
+        {
+            (msgpackWriteValue(writer, element), ...);
+        }, value);
+    }
+    else
+    {
+        static_assert(std::is_same_v<T, void>, "Type is not supported by the msgpack codec");
+    }
+}
+
+}  // namespace my::ser_detail
+
+namespace my::serialization {
+
+/**
+    MessagePack codec for the MY_CLASS_FIELDS types (and the standard containers of them):
+    reads and writes directly without building the runtime value tree (the same as JsonCodec does for json).
+    Objects are written as maps keyed by the field names, so the data is also readable by msgpackParse.
+    Collections of std::byte are written as 'bin'.
+ */
+struct MsgPackCodec
+{
+    template <typename T>
+    static Result<> parse(T& value, std::span<const std::byte> data)
+    {
+        ser_detail::MsgPackReader reader{data};
+        CheckResult(ser_detail::msgpackReadValue(reader, value, TypeCoercion::Default));
+        if (!reader.isEnd())
+        {
+            return reader.makeError("Unexpected data after the root value");
+        }
+
+        return kResultSuccess;
+    }
+
+    template <typename T>
+    static Result<T> parse(std::span<const std::byte> data)
+    {
+        T value{};
+        CheckResult(parse(value, data));
+
+        return value;
+    }
+
+    template <typename T>
+    static Result<> write(io::IStream& stream, const T& value)
+    {
+        ser_detail::MsgPackWriter writer{stream};
+        ser_detail::msgpackWriteValue(writer, value);
+
+        return writer.flush();
+    }
+};
+
+}  // namespace my::serialization
@@ -58,17 +58,17 @@ namespace my
     */
     inline Ptr<BooleanValue> makeValueRef(bool& value, IAllocator* allocator)
     {
-        return rtti::createInstanceWithAllocator<NativeBooleanValue<bool&>>(allocator, value);
+        return ser_detail::createNativeValue<NativeBooleanValue<bool&>>(allocator, value);
     }
 
     inline Ptr<BooleanValue> makeValueRef(const bool& value, IAllocator* allocator)
     {
-        return rtti::createInstanceWithAllocator<NativeBooleanValue<const bool&>>(std::move(allocator), value);
+        return ser_detail::createNativeValue<NativeBooleanValue<const bool&>>(allocator, value);
     }
 
     inline Ptr<BooleanValue> makeValueCopy(bool value, IAllocator* allocator)
     {
-        return rtti::createInstanceWithAllocator<NativeBooleanValue<bool>>(std::move(allocator), value);
+        return ser_detail::createNativeValue<NativeBooleanValue<bool>>(allocator, value);
     }
 
 }  // namespace my
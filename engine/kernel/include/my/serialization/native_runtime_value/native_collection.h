@@ -60,7 +60,7 @@ namespace my::ser_detail
         {
             MY_DEBUG_ASSERT(index < m_collection.size());
 
-            return this->makeChildValue(makeValueRef(m_collection[index]));
+            return this->makeChildValue(makeValueRef(m_collection[index]), index);
         }
 
         Result<> setAt(size_t index, const RuntimeValuePtr& value) override
@@ -68,6 +68,7 @@ namespace my::ser_detail
             MY_DEBUG_ASSERT(value);
             MY_DEBUG_ASSERT(index < m_collection.size());
 
+            child_value_changes_scope(index);
             return RuntimeValue::assign(makeValueRef(m_collection[index]), value);
         }
 
@@ -175,7 +176,7 @@ namespace my::ser_detail
             auto element = m_collection.begin();
             std::advance(element, index);
 
-            return this->makeChildValue(makeValueRef(*element));
+            return this->makeChildValue(makeValueRef(*element), index);
         }
 
         Result<> setAt(size_t index, const RuntimeValuePtr& value) override
@@ -186,6 +187,7 @@ namespace my::ser_detail
             auto element = m_collection.begin();
             std::advance(element, index);
 
+            child_value_changes_scope(index);
             return RuntimeValue::assign(makeValueRef(*element), value);
         }
 
@@ -287,7 +289,7 @@ namespace my::ser_detail
             auto element = m_collection.begin();
             std::advance(element, index);
 
-            return this->makeChildValue(makeValueRef(*element));
+            return this->makeChildValue(makeValueRef(*element), index);
         }
 
         Result<> setAt(size_t index, const RuntimeValuePtr& value) override
@@ -298,6 +300,7 @@ namespace my::ser_detail
             auto element = m_collection.begin();
             std::advance(element, index);
 
+            child_value_changes_scope(index);
             return RuntimeValue::assign(makeValueRef(*element), value);
         }
 
@@ -358,7 +361,7 @@ namespace my
     {
         using Collection = ser_detail::VectorLikeNativeCollection<T&>;
 
-        return rtti::createInstanceWithAllocator<Collection>(allocator, collection);
+        return ser_detail::createNativeValue<Collection>(allocator, collection);
     }
 
     template <LikeStdVector T>
@@ -366,7 +369,7 @@ namespace my
     {
         using Collection = ser_detail::VectorLikeNativeCollection<const T&>;
 
-        return rtti::createInstanceWithAllocator<Collection>(allocator, collection);
+        return ser_detail::createNativeValue<Collection>(allocator, collection);
     }
 
     template <LikeStdVector T>
@@ -374,7 +377,7 @@ namespace my
     {
         using Collection = ser_detail::VectorLikeNativeCollection<T>;
 
-        return rtti::createInstanceWithAllocator<Collection>(allocator, collection);
+        return ser_detail::createNativeValue<Collection>(allocator, collection);
     }
 
     template <LikeStdVector T>
@@ -382,7 +385,7 @@ namespace my
     {
         using Collection = ser_detail::VectorLikeNativeCollection<T>;
 
-        return rtti::createInstanceWithAllocator<Collection>(std::move(allocator), std::move(collection));
+        return ser_detail::createNativeValue<Collection>(allocator, std::move(collection));
     }
 
     template <LikeStdList T>
@@ -390,7 +393,7 @@ namespace my
     {
         using Collection = ser_detail::ListLikeNativeCollection<T&>;
 
-        return rtti::createInstanceWithAllocator<Collection>(allocator, collection);
+        return ser_detail::createNativeValue<Collection>(allocator, collection);
     }
 
     template <LikeStdList T>
@@ -398,7 +401,7 @@ namespace my
     {
         using Collection = ser_detail::ListLikeNativeCollection<const T&>;
 
-        return rtti::createInstanceWithAllocator<Collection>(allocator, collection);
+        return ser_detail::createNativeValue<Collection>(allocator, collection);
     }
 
     template <LikeStdList T>
@@ -406,7 +409,7 @@ namespace my
     {
         using Collection = ser_detail::ListLikeNativeCollection<T>;
 
-        return rtti::createInstanceWithAllocator<Collection>(allocator, collection);
+        return ser_detail::createNativeValue<Collection>(allocator, collection);
     }
 
     template <LikeStdList T>
@@ -414,7 +417,7 @@ namespace my
     {
         using Collection = ser_detail::ListLikeNativeCollection<T>;
 
-        return rtti::createInstanceWithAllocator<Collection>(std::move(allocator), std::move(collection));
+        return ser_detail::createNativeValue<Collection>(allocator, std::move(collection));
     }
 
     template <LikeSet T>
@@ -422,7 +425,7 @@ namespace my
     {
         using Collection = ser_detail::SetLikeNativeCollection<T&>;
 
-        return rtti::createInstanceWithAllocator<Collection>(allocator, collection);
+        return ser_detail::createNativeValue<Collection>(allocator, collection);
     }
 
     template <LikeSet T>
@@ -430,7 +433,7 @@ namespace my
     {
         using Collection = ser_detail::SetLikeNativeCollection<const T&>;
 
-        return rtti::createInstanceWithAllocator<Collection>(allocator, collection);
+        return ser_detail::createNativeValue<Collection>(allocator, collection);
     }
 
     template <LikeSet T>
@@ -438,7 +441,7 @@ namespace my
     {
         using Collection = ser_detail::SetLikeNativeCollection<T>;
 
-        return rtti::createInstanceWithAllocator<Collection>(allocator, collection);
+        return ser_detail::createNativeValue<Collection>(allocator, collection);
     }
 
     template <LikeSet T>
@@ -446,6 +449,6 @@ namespace my
     {
         using Collection = ser_detail::SetLikeNativeCollection<T>;
 
-        return rtti::createInstanceWithAllocator<Collection>(std::move(allocator), std::move(collection));
+        return ser_detail::createNativeValue<Collection>(allocator, std::move(collection));
     }    
 }  // namespace my
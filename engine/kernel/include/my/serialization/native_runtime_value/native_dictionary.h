@@ -70,7 +70,7 @@ namespace my::ser_detail
                 return nullptr;
             }
 
-            return this->makeChildValue(makeValueRef(iter->second));
+            return this->makeChildValue(makeValueRef(iter->second), std::string_view{iter->first.data(), iter->first.size()});
         }
 
         bool containsKey(std::string_view key) const override
@@ -97,7 +97,7 @@ namespace my::ser_detail
         {
             if constexpr(IsMutable)
             {
-                value_changes_scope;
+                child_value_changes_scope(key);
 
                 auto iter = m_dict.find(typename DictionaryType::key_type{key.data(), key.size()});
                 if(iter == m_dict.end())
@@ -121,9 +121,20 @@ namespace my::ser_detail
         {
             if constexpr(IsMutable)
             {
-                // value_changes_scope;
-                // DictionaryValueOperations<DictionaryType>::
-                MY_DEBUG_FAILURE("NativeDictionary::erase not implemented");
+                auto iter = m_dict.find(typename DictionaryType::key_type{key.data(), key.size()});
+                if(iter == m_dict.end())
+                {
+                    return nullptr;
+                }
+
+                MY_DEBUG_FATAL(!this->hasChildren(), "Attempt to modify Runtime Dictionary while there is still referenced children");
+
+                child_value_changes_scope(key);
+                // the erased value is returned as the detached copy
+                RuntimeValuePtr erasedValue = makeValueCopy(std::move(iter->second));
+                m_dict.erase(iter);
+
+                return erasedValue;
             }
             else
             {
@@ -145,7 +156,7 @@ namespace my
     {
         using Dict = ser_detail::MapLikeNativeDictionary<T&>;
 
-        return rtti::createInstanceWithAllocator<Dict>(allocator, dict);
+        return ser_detail::createNativeValue<Dict>(allocator, dict);
     }
 
     template <LikeStdMap T>
@@ -153,7 +164,7 @@ namespace my
     {
         using Dict = ser_detail::MapLikeNativeDictionary<const T&>;
 
-        return rtti::createInstanceWithAllocator<Dict>(allocator, dict);
+        return ser_detail::createNativeValue<Dict>(allocator, dict);
     }
 
     template <LikeStdMap T>
@@ -161,7 +172,7 @@ namespace my
     {
         using Dict = ser_detail::MapLikeNativeDictionary<T>;
 
-        return rtti::createInstanceWithAllocator<Dict>(allocator, dict);
+        return ser_detail::createNativeValue<Dict>(allocator, dict);
     }
 
     template <LikeStdMap T>
@@ -169,7 +180,7 @@ namespace my
     {
         using Dict = ser_detail::MapLikeNativeDictionary<T>;
 
-        return rtti::createInstanceWithAllocator<Dict>(allocator, std::move(dict));
+        return ser_detail::createNativeValue<Dict>(allocator, std::move(dict));
     }
 
 }  // namespace my
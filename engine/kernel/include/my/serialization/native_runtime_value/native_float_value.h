@@ -90,18 +90,18 @@ namespace my
     template <std::floating_point T>
     Ptr<FloatValue> makeValueRef(T& value, IAllocator* allocator)
     {
-        return rtti::createInstanceWithAllocator<ser_detail::NativeFloatValue<T&>>(allocator, value);
+        return ser_detail::createNativeValue<ser_detail::NativeFloatValue<T&>>(allocator, value);
     }
 
     template <std::floating_point T>
     Ptr<FloatValue> makeValueRef(const T& value, IAllocator* allocator)
     {
-        return rtti::createInstanceWithAllocator<ser_detail::NativeFloatValue<const T&>>(allocator, value);
+        return ser_detail::createNativeValue<ser_detail::NativeFloatValue<const T&>>(allocator, value);
     }
 
     template <std::floating_point T>
     Ptr<FloatValue> makeValueCopy(T value, IAllocator* allocator)
     {
-        return rtti::createInstanceWithAllocator<ser_detail::NativeFloatValue<T>>(allocator, value);
+        return ser_detail::createNativeValue<ser_detail::NativeFloatValue<T>>(allocator, value);
     }
 }  // namespace my
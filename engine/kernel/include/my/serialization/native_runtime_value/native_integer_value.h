@@ -95,18 +95,18 @@ namespace my
     template <std::integral T>
     Ptr<IntegerValue> makeValueRef(T& value, IAllocator* allocator)
     {
-        return rtti::createInstanceWithAllocator<ser_detail::NativeIntegerValue<T&>>(allocator, value);
+        return ser_detail::createNativeValue<ser_detail::NativeIntegerValue<T&>>(allocator, value);
     }
 
     template <std::integral T>
     Ptr<IntegerValue> makeValueRef(const T& value, IAllocator* allocator)
     {
-        return rtti::createInstanceWithAllocator<ser_detail::NativeIntegerValue<const T&>>(allocator, value);
+        return ser_detail::createNativeValue<ser_detail::NativeIntegerValue<const T&>>(allocator, value);
     }
 
     template <std::integral T>
     Ptr<IntegerValue> makeValueCopy(T value, IAllocator* allocator)
     {
-        return rtti::createInstanceWithAllocator<ser_detail::NativeIntegerValue<T>>(allocator, value);
+        return ser_detail::createNativeValue<ser_detail::NativeIntegerValue<T>>(allocator, value);
     }
 }  // namespace my
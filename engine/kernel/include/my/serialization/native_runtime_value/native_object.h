@@ -11,6 +11,7 @@
 #include "my/rtti/weak_ptr.h"
 #include "my/serialization/native_runtime_value/native_value_base.h"
 #include "my/serialization/native_runtime_value/native_value_forwards.h"
+#include "my/utils/perfect_hash.h"
 #include "my/utils/string_utils.h"
 
 
@@ -51,23 +52,40 @@ namespace my::ser_detail
     class MY_KERNEL_EXPORT MY_ABSTRACT_TYPE RuntimeObjectState
     {
     public:
+        static constexpr size_t NotFound = StringPerfectHash::NotFound;
+
         virtual ~RuntimeObjectState() = default;
 
         virtual size_t getSize() const = 0;
 
         std::string_view getKey(size_t index) const;
 
+        /**
+            Field names are matched case insensitive.
+            @return Index of the field or NotFound.
+         */
+        size_t findFieldIndex(std::string_view key) const;
+
+        RuntimeValuePtr getValueAt(const RuntimeValue& parent, const void* obj, size_t index) const;
+
         RuntimeValuePtr getValue(const RuntimeValue& parent, const void* obj, std::string_view key) const;
 
         bool containsKey(std::string_view key) const;
 
-        Result<> setFieldValue(const RuntimeValue& parent, const void* obj, std::string_view key, const RuntimeValuePtr& value);
+        Result<> setFieldValue(const RuntimeValue& parent, const void* obj, std::string_view key, const RuntimeValuePtr& value) const;
 
     protected:
         virtual std::span<RuntimeFieldAccessor> getFields() const = 0;
 
+        /**
+            Must be called by the implementation once the fields are known.
+         */
+        void buildFieldsIndex();
+
     private:
-        RuntimeFieldAccessor* findField(std::string_view key) const;
+        StringPerfectHash m_fieldsIndex;
+        // field names that are differ only by case can not be hashed case insensitive, the fields are scanned linearly.
+        bool m_useLinearLookup = false;
     };
 
     /**
@@ -77,15 +95,29 @@ namespace my::ser_detail
     {
         using FieldFactory = RuntimeFieldAccessor::FieldFactory;
         using FieldsInfo = decltype(meta::getClassAllFields<T>());
+
+    public:
         static constexpr size_t FieldsCount = std::tuple_size_v<FieldsInfo>;
 
+    private:
         using FieldsArray = std::array<RuntimeFieldAccessor, FieldsCount>;
 
     public:
+        /**
+            The state does not depend on the object instance, so it is shared by all the runtime values of the type T.
+            The fields index (perfect hash) is built at runtime, once per type on first use.
+         */
+        static const RuntimeObjectStateImpl<T>& getInstance()
+        {
+            static const RuntimeObjectStateImpl<T> instance;
+            return instance;
+        }
+
         RuntimeObjectStateImpl() :
             m_fieldInfos(meta::getClassAllFields<T>()),
             m_fields(RuntimeObjectStateImpl<T>::makeFields(m_fieldInfos))
         {
+            buildFieldsIndex();
         }
 
         inline size_t getSize() const override
@@ -121,7 +153,7 @@ namespace my::ser_detail
                 {
                     if (auto* const parentValue = parent.template as<const NativeParentValue*>())
                     {
-                        childValue->setParent(parentValue->getThisMutabilityGuard());
+                        childValue->setParent(parentValue->getThisMutabilityGuard(), fieldMetaInfo->getName());
                     }
                 }
 
@@ -154,6 +186,7 @@ namespace my::ser_detail
     {
         using Base = ser_detail::NativeRuntimeValueBase<RuntimeObject>;
         using ValueType = std::decay_t<T>;
+        using State = ser_detail::RuntimeObjectStateImpl<ValueType>;
 
         MY_REFCOUNTED_CLASS(NativeObject<T>, Base, RuntimeNativeValue)
 
@@ -189,22 +222,23 @@ namespace my::ser_detail
 
         size_t getSize() const override
         {
-            return m_state.getSize();
+            return State::FieldsCount;
         }
 
         std::string_view getKey(size_t index) const override
         {
-            return m_state.getKey(index);
+            return State::getInstance().getKey(index);
         }
 
         RuntimeValuePtr getValue(std::string_view key) override
         {
-            return m_state.getValue(*this, &m_object, key);
+            const size_t index = State::getInstance().findFieldIndex(key);
+            return index != State::NotFound ? getFieldValue(index) : nullptr;
         }
 
         bool containsKey(std::string_view key) const override
         {
-            return m_state.containsKey(key);
+            return State::getInstance().findFieldIndex(key) != State::NotFound;
         }
 
         Result<> setValue(std::string_view key, const RuntimeValuePtr& value) override
@@ -215,9 +249,15 @@ namespace my::ser_detail
             }
             else
             {
-                value_changes_scope;
+                const size_t index = State::getInstance().findFieldIndex(key);
+                if (index == State::NotFound)
+                {
+                    return MakeError("Class does not contains field:({})", key);
+                }
+
+                child_value_changes_scope(State::getInstance().getKey(index));
 
-                return m_state.setFieldValue(*this, &m_object, key, value);
+                return RuntimeValue::assign(getFieldValue(index), value);
             }
         }
 
@@ -255,8 +295,25 @@ namespace my::ser_detail
         }
 
     private:
+        /**
+            Field values are cached while someone holds them, so the repeated access to the same field does not create a new value.
+            The cache can not hold strong references: a field value keeps its parent (this object) alive through the mutability guard.
+         */
+        RuntimeValuePtr getFieldValue(size_t index)
+        {
+            WeakPtr<RuntimeValue>& fieldValueRef = m_fieldValues[index];
+            if (RuntimeValuePtr fieldValue = fieldValueRef.acquire())
+            {
+                return fieldValue;
+            }
+
+            RuntimeValuePtr fieldValue = State::getInstance().getValueAt(*this, &m_object, index);
+            fieldValueRef = fieldValue;
+            return fieldValue;
+        }
+
         T m_object;
-        ser_detail::RuntimeObjectStateImpl<ValueType> m_state;
+        std::array<WeakPtr<RuntimeValue>, State::FieldsCount> m_fieldValues;
     };
 }  // namespace my::ser_detail
 
@@ -267,7 +324,7 @@ namespace my
     {
         using Object = ser_detail::NativeObject<T&>;
 
-        return rtti::createInstanceWithAllocator<Object>(allocator, obj);
+        return ser_detail::createNativeValue<Object>(allocator, obj);
     }
 
     template <NauClassWithFields T>
@@ -275,7 +332,7 @@ namespace my
     {
         using Object = ser_detail::NativeObject<const T&>;
 
-        return rtti::createInstanceWithAllocator<Object>(allocator, obj);
+        return ser_detail::createNativeValue<Object>(allocator, obj);
     }
 
     template <NauClassWithFields T>
@@ -283,7 +340,7 @@ namespace my
     {
         using Object = ser_detail::NativeObject<T>;
 
-        return rtti::createInstanceWithAllocator<Object>(allocator, obj);
+        return ser_detail::createNativeValue<Object>(allocator, obj);
     }
 
     template <NauClassWithFields T>
@@ -291,6 +348,6 @@ namespace my
     {
         using Object = ser_detail::NativeObject<T>;
 
-        return rtti::createInstanceWithAllocator<Object>(allocator, std::move(obj));
+        return ser_detail::createNativeValue<Object>(allocator, std::move(obj));
     }
 }  // namespace my
@@ -107,7 +107,7 @@ namespace my
     {
         using Optional = ser_detail::StdOptionalValue<T&>;
 
-        return rtti::createInstanceWithAllocator<Optional>(allocator, opt);
+        return ser_detail::createNativeValue<Optional>(allocator, opt);
     }
 
     template <LikeStdOptional T>
@@ -115,7 +115,7 @@ namespace my
     {
         using Optional = ser_detail::StdOptionalValue<const T&>;
 
-        return rtti::createInstanceWithAllocator<Optional>(allocator, opt);
+        return ser_detail::createNativeValue<Optional>(allocator, opt);
     }
 
     template <LikeStdOptional T>
@@ -123,7 +123,7 @@ namespace my
     {
         using Optional = ser_detail::StdOptionalValue<T>;
 
-        return rtti::createInstanceWithAllocator<Optional>(allocator, opt);
+        return ser_detail::createNativeValue<Optional>(allocator, opt);
     }
 
     template <LikeStdOptional T>
@@ -131,6 +131,6 @@ namespace my
     {
         using Optional = ser_detail::StdOptionalValue<T>;
 
-        return rtti::createInstanceWithAllocator<Optional>(std::move(allocator), std::move(opt));
+        return ser_detail::createNativeValue<Optional>(allocator, std::move(opt));
     }
 }  // namespace my
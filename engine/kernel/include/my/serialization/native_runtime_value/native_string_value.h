@@ -2,7 +2,10 @@
 
 #pragma once
 #include <concepts>
+#include <cstring>
+#include <memory>
 #include <type_traits>
+#include <utility>
 
 #include "my/diag/logging.h"
 #include "my/rtti/rtti_impl.h"
@@ -11,6 +14,114 @@
 
 namespace my::ser_detail
 {
+    /**
+        Storage for the string copies: short strings (names, keys, most of the dispatch arguments) are kept immediately within the value wrapper,
+        only longer strings require a separate heap block.
+     */
+    class NativeInlineString
+    {
+    public:
+        using value_type = char;
+
+        static constexpr size_t InlineCapacity = 47;
+
+        NativeInlineString() = default;
+
+        NativeInlineString(const char* data, size_t size)
+        {
+            assign(data, size);
+        }
+
+        NativeInlineString(const NativeInlineString& other)
+        {
+            assign(other.data(), other.size());
+        }
+
+        NativeInlineString(NativeInlineString&& other) noexcept
+        {
+            *this = std::move(other);
+        }
+
+        NativeInlineString& operator=(const NativeInlineString& other)
+        {
+            if (this != &other)
+            {
+                assign(other.data(), other.size());
+            }
+
+            return *this;
+        }
+
+        NativeInlineString& operator=(NativeInlineString&& other) noexcept
+        {
+            if (this == &other)
+            {
+                return *this;
+            }
+
+            if (other.m_heap)
+            {
+                m_heap = std::move(other.m_heap);
+                m_heapCapacity = std::exchange(other.m_heapCapacity, 0);
+                m_size = std::exchange(other.m_size, 0);
+            }
+            else
+            {
+                assign(other.data(), other.size());
+            }
+
+            return *this;
+        }
+
+        void assign(const char* data, size_t size)
+        {
+            if (size == 0)
+            {
+                m_size = 0;
+                return;
+            }
+
+            if (!m_heap && size <= InlineCapacity)
+            {
+                std::memmove(m_inline, data, size);
+            }
+            else if (m_heap && size <= m_heapCapacity)
+            {
+                std::memmove(m_heap.get(), data, size);
+            }
+            else
+            {
+                // data can point into the current buffer, so it is released only after the copy.
+                auto heap = std::make_unique_for_overwrite<char[]>(size);
+                std::memcpy(heap.get(), data, size);
+                m_heap = std::move(heap);
+                m_heapCapacity = size;
+            }
+
+            m_size = size;
+        }
+
+        const char* data() const
+        {
+            return m_heap ? m_heap.get() : m_inline;
+        }
+
+        size_t size() const
+        {
+            return m_size;
+        }
+
+        bool isInline() const
+        {
+            return !m_heap;
+        }
+
+    private:
+        std::unique_ptr<char[]> m_heap;
+        size_t m_heapCapacity = 0;
+        size_t m_size = 0;
+        char m_inline[InlineCapacity];
+    };
 
     template <typename T>
     class NativeBasicStringValue : public ser_detail::NativePrimitiveRuntimeValueBase<StringValue>
@@ -164,7 +275,7 @@ namespace my
     {
         using StringType = ser_detail::NativeBasicStringValue<std::basic_string<char, Traits...>&>;
 
-        return rtti::createInstanceWithAllocator<StringType>(std::move(allocator), str);
+        return ser_detail::createNativeValue<StringType>(allocator, str);
     }
 
     template <typename... Traits>
@@ -172,14 +283,14 @@ namespace my
     {
         using StringType = ser_detail::NativeBasicStringValue<const std::basic_string<char, Traits...>&>;
 
-        return rtti::createInstanceWithAllocator<StringType>(std::move(allocator), str);
+        return ser_detail::createNativeValue<StringType>(allocator, str);
     }
 
     inline Ptr<StringValue> makeValueCopy(std::string_view str, IAllocator* allocator)
     {
-        using StringType = ser_detail::NativeBasicStringValue<std::basic_string<char>>;
+        using StringType = ser_detail::NativeBasicStringValue<ser_detail::NativeInlineString>;
 
-        return rtti::createInstanceWithAllocator<StringType>(std::move(allocator), str.data(), str.size());
+        return ser_detail::createNativeValue<StringType>(allocator, str.data(), str.size());
     }
 
     // template <typename C, typename... Traits>
@@ -188,7 +299,7 @@ namespace my
     // {
     //     using StringType = ser_detail::NativeBasicStringValue<std::basic_string<C, Traits...>&>;
 
-    //     return rtti::createInstanceWithAllocator<StringType>(std::move(allocator), str);
+    //     return ser_detail::createNativeValue<StringType>(allocator, str);
     // }
 
     // template <typename C, typename... Traits>
@@ -197,21 +308,21 @@ namespace my
     // {
     //     using StringType = ser_detail::NativeBasicStringValue<const std::basic_string<C, Traits...>&>;
 
-    //     return rtti::createInstanceWithAllocator<StringType>(std::move(allocator), str);
+    //     return ser_detail::createNativeValue<StringType>(allocator, str);
     // }
 
     // inline Ptr<StringValue> makeValueCopy(std::string_view str, IAllocator* allocator)
     // {
     //     using StringType = ser_detail::NativeBasicStringValue<std::basic_string<char>>;
 
-    //     return rtti::createInstanceWithAllocator<StringType>(std::move(allocator), str.data(), str.size());
+    //     return ser_detail::createNativeValue<StringType>(allocator, str.data(), str.size());
     // }
 
     // inline Ptr<StringValue> makeValueCopy(std::u8string_view str, IAllocator* allocator)
     // {
     //     using StringType = ser_detail::NativeBasicStringValue<std::basic_string<char>>;
 
-    //     return rtti::createInstanceWithAllocator<StringType>(std::move(allocator), reinterpret_cast<const char*>(str.data()), str.size());
+    //     return ser_detail::createNativeValue<StringType>(allocator, reinterpret_cast<const char*>(str.data()), str.size());
     // }
 
     template <AutoStringRepresentable T>
@@ -219,7 +330,7 @@ namespace my
     {
         using Type = ser_detail::NativeStringParsableValue<T&>;
 
-        return rtti::createInstanceWithAllocator<Type>(std::move(allocator), value);
+        return ser_detail::createNativeValue<Type>(allocator, value);
     }
 
     template <AutoStringRepresentable T>
@@ -227,7 +338,7 @@ namespace my
     {
         using Type = ser_detail::NativeStringParsableValue<const T&>;
 
-        return rtti::createInstanceWithAllocator<Type>(std::move(allocator), value);
+        return ser_detail::createNativeValue<Type>(allocator, value);
     }
 
     template <AutoStringRepresentable T>
@@ -235,7 +346,7 @@ namespace my
     {
         using Type = ser_detail::NativeStringParsableValue<T>;
 
-        return rtti::createInstanceWithAllocator<Type>(std::move(allocator), value);
+        return ser_detail::createNativeValue<Type>(allocator, value);
     }
 
     template <AutoStringRepresentable T>
@@ -243,7 +354,7 @@ namespace my
     {
         using Type = ser_detail::NativeStringParsableValue<T>;
 
-        return rtti::createInstanceWithAllocator<Type>(std::move(allocator), std::move(value));
+        return ser_detail::createNativeValue<Type>(allocator, std::move(value));
     }
 
 }  // namespace my
\ No newline at end of file
@@ -80,7 +80,7 @@ namespace my::ser_detail
         static RuntimeValuePtr wrapElementAsRuntimeValue(const NativeTuple<T>& self, std::add_lvalue_reference_t<T> container)
         {
             decltype(auto) el = TupleValueOperations1<TupleType>::template element<I>(container);
-            return self.makeChildValue(makeValueRef(el));
+            return self.makeChildValue(makeValueRef(el), I);
         }
 
         T m_tuple;
@@ -129,7 +129,7 @@ namespace my::ser_detail
         {
             decltype(auto) el = UniformTupleValueOperations<TupleType>::element(m_tuple, index);
 
-            return this->makeChildValue(makeValueRef(el));
+            return this->makeChildValue(makeValueRef(el), index);
         }
 
         Result<> setAt(size_t index, const RuntimeValuePtr& value) override
@@ -139,6 +139,7 @@ namespace my::ser_detail
 
             decltype(auto) el = UniformTupleValueOperations<TupleType>::element(m_tuple, index);
 
+            child_value_changes_scope(index);
             return RuntimeValue::assign(makeValueRef(el), value);
         }
 
@@ -154,55 +155,55 @@ namespace my
     Ptr<ReadonlyCollection> makeValueRef(T& tup, IAllocator* allocator)
     {
         using Tuple = ser_detail::NativeTuple<T&>;
-        return rtti::createInstanceWithAllocator<Tuple>(allocator, tup);
+        return ser_detail::createNativeValue<Tuple>(allocator, tup);
     }
 
     template <LikeTuple T>
     Ptr<ReadonlyCollection> makeValueRef(const T& tup, IAllocator* allocator)
     {
         using Tuple = ser_detail::NativeTuple<const T&>;
-        return rtti::createInstanceWithAllocator<Tuple>(allocator, tup);
+        return ser_detail::createNativeValue<Tuple>(allocator, tup);
     }
 
     template <LikeTuple T>
     Ptr<ReadonlyCollection> makeValueCopy(const T& tup, IAllocator* allocator)
     {
         using Tuple = ser_detail::NativeTuple<T>;
-        return rtti::createInstanceWithAllocator<Tuple>(allocator, tup);
+        return ser_detail::createNativeValue<Tuple>(allocator, tup);
     }
 
     template <LikeTuple T>
     Ptr<ReadonlyCollection> makeValueCopy(T&& tup, IAllocator* allocator)
     {
         using Tuple = ser_detail::NativeTuple<T>;
-        return rtti::createInstanceWithAllocator<Tuple>(allocator, std::move(tup));
+        return ser_detail::createNativeValue<Tuple>(allocator, std::move(tup));
     }
 
     template <LikeUniformTuple T>
     Ptr<ReadonlyCollection> makeValueRef(T& tup, IAllocator* allocator)
     {
         using Tuple = ser_detail::NativeUniformTuple<T&>;
-        return rtti::createInstanceWithAllocator<Tuple>(allocator, tup);
+        return ser_detail::createNativeValue<Tuple>(allocator, tup);
     }
 
     template <LikeUniformTuple T>
     Ptr<ReadonlyCollection> makeValueRef(const T& tup, IAllocator* allocator)
     {
         using Tuple = ser_detail::NativeUniformTuple<const T&>;
-        return rtti::createInstanceWithAllocator<Tuple>(allocator, tup);
+        return ser_detail::createNativeValue<Tuple>(allocator, tup);
     }
 
     template <LikeUniformTuple T>
     Ptr<ReadonlyCollection> makeValueCopy(const T& tup, IAllocator* allocator)
     {
         using Tuple = ser_detail::NativeUniformTuple<T>;
-        return rtti::createInstanceWithAllocator<Tuple>(allocator, tup);
+        return ser_detail::createNativeValue<Tuple>(allocator, tup);
     }
 
     template <LikeUniformTuple T>
     Ptr<ReadonlyCollection> makeValueCopy(T&& tup, IAllocator* allocator)
     {
         using Tuple = ser_detail::NativeUniformTuple<T>;
-        return rtti::createInstanceWithAllocator<Tuple>(allocator, std::move(tup));
+        return ser_detail::createNativeValue<Tuple>(allocator, std::move(tup));
     }
 }  // namespace my
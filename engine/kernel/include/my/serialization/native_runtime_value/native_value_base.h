@@ -2,15 +2,33 @@
 
 #pragma once
 
+#include <array>
+#include <charconv>
 #include <concepts>
 
 #include "my/diag/assert.h"
+#include "my/kernel/kernel_config.h"
+#include "my/memory/allocator.h"
+#include "my/rtti/rtti_impl.h"
 #include "my/rtti/weak_ptr.h"
 #include "my/serialization/runtime_value.h"
 #include "my/serialization/runtime_value_events.h"
 
 namespace my::ser_detail
 {
+    /**
+        Allocator that is used for the native runtime value wrappers when no allocator is passed to makeValueRef/makeValueCopy.
+        Wrappers are small, short living and created in large numbers (dispatch arguments, collection elements, object fields),
+        so they are served from the own size class pool instead of the general purpose heap.
+     */
+    MY_KERNEL_EXPORT IAllocator& getNativeValueAllocator();
+
+    template <typename ClassImpl, typename Itf = ClassImpl, typename... Args>
+    Ptr<Itf> createNativeValue(IAllocator* allocator, Args&&... args)
+    {
+        return rtti::createInstanceWithAllocator<ClassImpl, Itf>(allocator ? allocator : &getNativeValueAllocator(), std::forward<Args>(args)...);
+    }
+
     /**
      */
     class RuntimeValueEventsBase : public virtual IRuntimeValueEvents,
@@ -44,18 +62,26 @@ namespace my::ser_detail
 
 
     protected:
-        void notifyChanged(const RuntimeValue* source = nullptr) final
+        void notifyChanged(const RuntimeValue* source = nullptr, const RuntimeValueChangePath* sourcePath = nullptr) final
         {
-            const std::string_view fieldName = source ? findFieldName(*source) : std::string_view{};
+            // path is built on the stack while the notification goes up to the top parent
+            RuntimeValueChangePath pathFromThis;
+            const RuntimeValueChangePath* path = sourcePath;
+            if(source)
+            {
+                pathFromThis = {findFieldName(*source), sourcePath};
+                path = &pathFromThis;
+            }
+
             const RuntimeValue& thisAsRuntimeValue = this->as<const RuntimeValue&>();
 
-            notifyHandlers(thisAsRuntimeValue, fieldName);
+            notifyHandlers(thisAsRuntimeValue, path);
 
             if(auto parent = getParent())
             {
                 if(auto* const parentEvents = parent->as<IRuntimeValueEventsSource*>())
                 {
-                    parentEvents->notifyChanged(&thisAsRuntimeValue);
+                    parentEvents->notifyChanged(&thisAsRuntimeValue, path);
                 }
             }
         }
@@ -76,7 +102,7 @@ namespace my::ser_detail
     private:
         using ChangesHandlerEntry = std::tuple<my::Ptr<IRuntimeValueChangesHandler>, uint32_t>;
 
-        void notifyHandlers(const RuntimeValue& thisAsRuntimeValue, std::string_view childKey)
+        void notifyHandlers(const RuntimeValue& thisAsRuntimeValue, const RuntimeValueChangePath* path)
         {
 #if MY_DEBUG_ASSERT_ENABLED
             MY_DEBUG_ASSERT(m_concurrentCheckFlag.exchange(true, std::memory_order_acquire) == false);
@@ -86,12 +112,15 @@ namespace my::ser_detail
             };
 #endif
 
+            const std::string_view childKey = path ? path->key : std::string_view{};
+
             onThisValueChanged(childKey);
 
             for(auto& handlerEntry : m_changeHandlers)
             {
                 auto& handler = std::get<0>(handlerEntry);
                 handler->onValueChanged(thisAsRuntimeValue, childKey);
+                handler->onValueTreeChanged(thisAsRuntimeValue, path);
             }
         }
 
@@ -152,10 +181,27 @@ namespace my::ser_detail
         MY_TYPEID(my::ser_detail::NativeChildValue)
 
     public:
-        void setParent(my::Ptr<ParentMutabilityGuard>&& parentGuard)
+        /**
+            @param key Key of this value within the parent. The key must be kept by the parent (i.e. dictionary key or field name).
+         */
+        void setParent(my::Ptr<ParentMutabilityGuard>&& parentGuard, std::string_view key = {})
         {
             MY_DEBUG_ASSERT(!m_parentGuard);
             m_parentGuard = std::move(parentGuard);
+            m_key = key;
+        }
+
+        void setParent(my::Ptr<ParentMutabilityGuard>&& parentGuard, size_t index)
+        {
+            const auto [end, errc] = std::to_chars(m_indexKey.data(), m_indexKey.data() + m_indexKey.size(), index);
+            MY_DEBUG_ASSERT(errc == std::errc{});
+
+            setParent(std::move(parentGuard), std::string_view{m_indexKey.data(), static_cast<size_t>(end - m_indexKey.data())});
+        }
+
+        std::string_view getKey() const
+        {
+            return m_key;
         }
 
     private:
@@ -165,6 +211,8 @@ namespace my::ser_detail
         }
 
         my::Ptr<ParentMutabilityGuard> m_parentGuard;
+        std::string_view m_key;
+        std::array<char, 20> m_indexKey;
 
         template <std::derived_from<RuntimeValue> T>
         friend class NativeRuntimeValueBase;
@@ -207,17 +255,17 @@ namespace my::ser_detail
         MY_INTERFACE(my::ser_detail::NativeRuntimeValueBase<T>, T, NativeChildValue, NativeParentValue, RuntimeValueEventsBase)
 
     protected:
-        template <std::derived_from<RuntimeValue> U>
-        my::Ptr<U>& makeChildValue(my::Ptr<U>& value) const
+        template <std::derived_from<RuntimeValue> U, typename... Key>
+        my::Ptr<U>& makeChildValue(my::Ptr<U>& value, Key... key) const
         {
-            setThisAsParent(value);
+            setThisAsParent(value, key...);
             return (value);
         }
 
-        template <std::derived_from<RuntimeValue> U>
-        my::Ptr<U> makeChildValue(my::Ptr<U>&& value) const
+        template <std::derived_from<RuntimeValue> U, typename... Key>
+        my::Ptr<U> makeChildValue(my::Ptr<U>&& value, Key... key) const
         {
-            setThisAsParent(value);
+            setThisAsParent(value, key...);
             return value;
         }
 
@@ -226,13 +274,15 @@ namespace my::ser_detail
             return !m_mutabilityGuardRef.isDead();
         }
 
-        template <std::derived_from<RuntimeValue> U>
-        void setThisAsParent(my::Ptr<U>& value) const
+        template <std::derived_from<RuntimeValue> U, typename... Key>
+        void setThisAsParent(my::Ptr<U>& value, Key... key) const
         {
+            static_assert(sizeof...(Key) <= 1);
+
             MY_DEBUG_ASSERT(value);
             if(NativeChildValue* const childValue = value->template as<NativeChildValue*>())
             {
-                childValue->setParent(getThisMutabilityGuard());
+                childValue->setParent(getThisMutabilityGuard(), key...);
             }
         }
 
@@ -254,6 +304,12 @@ namespace my::ser_detail
             return this->getParentObject();
         }
 
+        std::string_view findFieldName(const RuntimeValue& value) const final
+        {
+            const auto* const childValue = value.as<const NativeChildValue*>();
+            return childValue ? childValue->getKey() : std::string_view{};
+        }
+
         my::Ptr<ParentMutabilityGuard> getThisMutabilityGuard() const final
         {
             auto guard = m_mutabilityGuardRef.lock();
@@ -0,0 +1,68 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include "my/kernel/kernel_config.h"
+#include "my/rtti/ptr.h"
+#include "my/serialization/runtime_value.h"
+#include "my/serialization/runtime_value_events.h"
+#include "my/utils/result.h"
+
+namespace my::ser_detail {
+class RuntimeValueChangesCollector;
+}
+
+namespace my::serialization {
+
+/**
+    Tracks the changed parts of the runtime value tree and encodes them as JSON Patch (RFC 6902).
+
+    Only the root value is subscribed: nested native values report their changes to the parents together with the path,
+    so the tracking cost depends on the number of changes, not on the tree size.
+    Changes with the unknown child key (i.e. collection append/clear) mark the whole container as changed.
+ */
+class MY_KERNEL_EXPORT RuntimeValueChangesTracker
+{
+public:
+    /**
+        @param root Value that provides IRuntimeValueEvents. Otherwise the root is always reported as changed.
+     */
+    explicit RuntimeValueChangesTracker(RuntimeValuePtr root);
+
+    RuntimeValueChangesTracker(RuntimeValueChangesTracker&&);
+
+    RuntimeValueChangesTracker(const RuntimeValueChangesTracker&) = delete;
+
+    ~RuntimeValueChangesTracker();
+
+    RuntimeValueChangesTracker& operator=(RuntimeValueChangesTracker&&);
+
+    RuntimeValueChangesTracker& operator=(const RuntimeValueChangesTracker&) = delete;
+
+    bool hasChanges() const;
+
+    /**
+        Forgets the collected changes (i.e. after the patch is sent).
+     */
+    void reset();
+
+    /**
+        Makes the patch operations ('add', 'replace' and 'remove') for the changes collected since construction or the last reset().
+        Values are copied into the patch, so it can be serialized later with any codec (json or msgpack).
+     */
+    Ptr<Collection> makeJsonPatch() const;
+
+private:
+    RuntimeValuePtr m_root;
+    Ptr<ser_detail::RuntimeValueChangesCollector> m_collector;
+    IRuntimeValueEvents::SubscriptionHandle m_subscription;
+};
+
+/**
+    Applies the JSON Patch operations ('add', 'replace' and 'remove') to the target value.
+    Inserting into the middle of a collection and removing collection elements are not supported.
+ */
+MY_KERNEL_EXPORT
+Result<> applyJsonPatch(RuntimeValue& target, ReadonlyCollection& patch);
+
+}  // namespace my::serialization
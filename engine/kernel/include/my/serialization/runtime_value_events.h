@@ -1,7 +1,9 @@
 // #my_engine_source_file
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <charconv>
 #include <concepts>
 #include <string_view>
 #include <type_traits>
@@ -17,6 +19,17 @@
 
 namespace my
 {
+    /**
+        Path from the notified value down to the value that was actually changed.
+        Segments are linked from the notified value to the changed one and are valid only during the notification call.
+        The segment key can be empty when the parent does not know the child's key.
+     */
+    struct RuntimeValueChangePath
+    {
+        std::string_view key;
+        const RuntimeValueChangePath* next = nullptr;
+    };
+
     /**
      */
     struct MY_ABSTRACT_TYPE IRuntimeValueChangesHandler : virtual IRefCounted
@@ -24,6 +37,14 @@ namespace my
         MY_INTERFACE(my::IRuntimeValueChangesHandler, IRefCounted)
 
         virtual void onValueChanged(const RuntimeValue& target, std::string_view childKey) = 0;
+
+        /**
+            Called after onValueChanged with the full path to the changed value.
+            @param path Path relative to the target, nullptr means that the target itself was changed.
+         */
+        virtual void onValueTreeChanged([[maybe_unused]] const RuntimeValue& target, [[maybe_unused]] const RuntimeValueChangePath* path)
+        {
+        }
     };
 
     /**
@@ -124,7 +145,11 @@ namespace my
     {
         MY_INTERFACE(my::IRuntimeValueEventsSource, IRefCounted)
 
-        virtual void notifyChanged(const RuntimeValue* source = nullptr) = 0;
+        /**
+            @param source Changed child value, nullptr if this value was changed itself.
+            @param sourcePath Path to the changed value relative to the source (or to this value if there is no source).
+         */
+        virtual void notifyChanged(const RuntimeValue* source = nullptr, const RuntimeValueChangePath* sourcePath = nullptr) = 0;
     };
 
 }  // namespace my
@@ -169,6 +194,37 @@ namespace my::ser_detail
         }
     };
 
+    /**
+        Notifies that the specific child (dictionary key or collection element) was changed.
+     */
+    struct ChildValueChangesScopeHelper
+    {
+        IRuntimeValueEventsSource& value;
+        RuntimeValueChangePath path;
+        std::array<char, 24> indexKey;
+
+        ChildValueChangesScopeHelper(IRuntimeValueEventsSource& inValue, std::string_view key) :
+            value(inValue),
+            path{key}
+        {
+        }
+
+        ChildValueChangesScopeHelper(IRuntimeValueEventsSource& inValue, size_t index) :
+            value(inValue)
+        {
+            const auto [end, errc] = std::to_chars(indexKey.data(), indexKey.data() + indexKey.size(), index);
+            MY_DEBUG_ASSERT(errc == std::errc{});
+            path.key = std::string_view{indexKey.data(), static_cast<size_t>(end - indexKey.data())};
+        }
+
+        ChildValueChangesScopeHelper(const ChildValueChangesScopeHelper&) = delete;
+
+        ~ChildValueChangesScopeHelper()
+        {
+            value.notifyChanged(nullptr, &path);
+        }
+    };
+
 }  // namespace my::ser_detail
 
 namespace my
@@ -185,4 +241,5 @@ namespace my
 
 // clang-format off
 #define value_changes_scope const ::my::ser_detail::ValueChangesScopeHelper ANONYMOUS_VAR(changesScope__) {*this}
+#define child_value_changes_scope(key) const ::my::ser_detail::ChildValueChangesScopeHelper ANONYMOUS_VAR(changesScope__) {*this, key}
 // clang-format on
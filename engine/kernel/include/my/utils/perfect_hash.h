@@ -0,0 +1,155 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include "my/diag/assert.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace my {
+
+/**
+    Perfect hash over a fixed set of the string keys.
+
+    Each key is mapped to its own slot, so a lookup costs a single hash and a single key compare.
+    The seed is searched at construction time, that is expected to happen once per key set (i.e. per reflected type).
+    Keys are not copied: the referenced strings must outlive the hash object (string literals are the primary use case).
+ */
+class StringPerfectHash
+{
+public:
+    static constexpr size_t NotFound = std::numeric_limits<size_t>::max();
+
+    StringPerfectHash() = default;
+
+    /**
+        @param keys Unique keys. The index of a key within this span is returned by find().
+        @param ignoreCase Use ASCII case insensitive hashing and compare.
+     */
+    StringPerfectHash(std::span<const std::string_view> keys, bool ignoreCase = false) :
+        m_keys(keys.begin(), keys.end()),
+        m_ignoreCase(ignoreCase)
+    {
+        if (m_keys.empty())
+        {
+            return;
+        }
+
+        constexpr uint32_t MaxSeedAttempts = 64;
+        constexpr size_t MaxTableSizeFactor = 1024;
+
+        for (size_t tableSize = std::bit_ceil(m_keys.size() * 2); tableSize <= m_keys.size() * MaxTableSizeFactor; tableSize *= 2)
+        {
+            m_slots.resize(tableSize);
+            m_mask = static_cast<uint32_t>(tableSize - 1);
+
+            for (uint32_t seed = 1; seed <= MaxSeedAttempts; ++seed)
+            {
+                if (tryBuild(seed))
+                {
+                    m_seed = seed;
+                    return;
+                }
+            }
+        }
+
+        MY_FATAL_FAILURE("Perfect hash can not be built, keys must be unique");
+    }
+
+    /**
+        @return Index of the key or NotFound.
+     */
+    size_t find(std::string_view key) const
+    {
+        if (m_slots.empty())
+        {
+            return NotFound;
+        }
+
+        const uint32_t index = m_slots[hash(key, m_seed, m_ignoreCase) & m_mask];
+        if (index == EmptySlot || !equal(m_keys[index], key, m_ignoreCase))
+        {
+            return NotFound;
+        }
+
+        return index;
+    }
+
+    size_t size() const
+    {
+        return m_keys.size();
+    }
+
+private:
+    static constexpr uint32_t EmptySlot = std::numeric_limits<uint32_t>::max();
+
+    static constexpr char toLower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    static uint32_t hash(std::string_view key, uint32_t seed, bool ignoreCase)
+    {
+        uint32_t h = 0x811c9dc5 ^ (seed * 0x9e3779b9);
+        for (const char c : key)
+        {
+            h ^= static_cast<uint8_t>(ignoreCase ? toLower(c) : c);
+            h *= 0x01000193;
+        }
+
+        h ^= h >> 16;
+        h *= 0x85ebca6b;
+        h ^= h >> 13;
+        return h;
+    }
+
+    static bool equal(std::string_view left, std::string_view right, bool ignoreCase)
+    {
+        if (!ignoreCase || left.size() != right.size())
+        {
+            return left == right;
+        }
+
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            if (toLower(left[i]) != toLower(right[i]))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool tryBuild(uint32_t seed)
+    {
+        std::fill(m_slots.begin(), m_slots.end(), EmptySlot);
+
+        for (size_t i = 0; i < m_keys.size(); ++i)
+        {
+            uint32_t& slot = m_slots[hash(m_keys[i], seed, m_ignoreCase) & m_mask];
+            if (slot != EmptySlot)
+            {
+                return false;
+            }
+
+            slot = static_cast<uint32_t>(i);
+        }
+
+        return true;
+    }
+
+    std::vector<std::string_view> m_keys;
+    std::vector<uint32_t> m_slots;
+    uint32_t m_mask = 0;
+    uint32_t m_seed = 0;
+    bool m_ignoreCase = false;
+};
+
+}  // namespace my
@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <charconv>
 #include <concepts>
+#include <functional>
 #include <iterator>
 #include <string>
 #include <string_view>
@@ -348,6 +349,20 @@ struct CiStringComparer
     }
 };
 
+/**
+    Transparent hash: unordered containers with the std::string keys can be searched by std::string_view without the key copy.
+    Must be used together with std::equal_to<>.
+ */
+struct StringHash
+{
+    using is_transparent = void;
+
+    size_t operator()(std::string_view str) const noexcept
+    {
+        return std::hash<std::string_view>{}(str);
+    }
+};
+
 template <typename Number>
 Number lexicalCast(std::string_view str)
 requires(std::is_arithmetic_v<Number>)
@@ -2,8 +2,11 @@
 
 #include "property_container_impl.h"
 
+#include "property_snapshot.h"
+
 #include "my/io/file_system.h"
 #include "my/io/stream_utils.h"
+#include "my/serialization/config_blob.h"
 #include "my/serialization/json.h"
 #include "my/utils/string_utils.h"
 
@@ -26,6 +29,59 @@ namespace my
 
             return {parentPath, propName};
         }
+
+        /**
+            $kind{value} entry within the config string.
+         */
+        struct ConfigVariable
+        {
+            std::string_view text;
+            std::string_view kind;
+            std::string_view value;
+        };
+
+        inline bool isConfigVariableChar(char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-' || c == '/';
+        }
+
+        std::optional<ConfigVariable> findConfigVariable(std::string_view str)
+        {
+            for (size_t pos = str.find('$'); pos != std::string_view::npos; pos = str.find('$', pos + 1))
+            {
+                size_t kindEnd = pos + 1;
+                while (kindEnd < str.size() && isConfigVariableChar(str[kindEnd]))
+                {
+                    ++kindEnd;
+                }
+
+                if (kindEnd == str.size() || str[kindEnd] != '{')
+                {
+                    continue;
+                }
+
+                size_t valueEnd = kindEnd + 1;
+                while (valueEnd < str.size() && isConfigVariableChar(str[valueEnd]))
+                {
+                    ++valueEnd;
+                }
+
+                if (valueEnd == str.size() || str[valueEnd] != '}')
+                {
+                    continue;
+                }
+
+                return ConfigVariable{
+                    .text = str.substr(pos, valueEnd + 1 - pos),
+                    .kind = str.substr(pos + 1, kindEnd - pos - 1),
+                    .value = str.substr(kindEnd + 1, valueEnd - kindEnd - 1)};
+            }
+
+            return std::nullopt;
+        }
+
+        // set while the string is expanded if any of its variables (also within the referenced properties) is expanded by the custom resolver
+        thread_local bool t_usesVariableResolvers = false;
     }  // namespace
 
     // this function is used to access to the GlobalProperties instance from test projects only
@@ -42,6 +98,10 @@ namespace my
         {
             return expandConfigString(str);
         });
+
+        auto emptyRoot = std::make_shared<PropertySnapshotNode>();
+        emptyRoot->value = PropertySnapshotNode::Members{};
+        storeSnapshot(std::make_shared<const PropertySnapshot>(std::move(emptyRoot), 0));
     }
 
     RuntimeValuePtr PropertyContainerImpl::findValueAtPath(std::string_view valuePath) const
@@ -123,82 +183,213 @@ namespace my
 
     std::optional<std::string> PropertyContainerImpl::expandConfigString(std::string_view str) const
     {
-        //  \$([a-zA-Z_0-9\-]*)\{([a-zA-Z_0-9/\-/]*)\}
-        //  will parse strings like $[VAR_NAME]{[VAR_VALUE]}
-        std::regex re(R"-(\$([a-zA-Z_0-9\-/]*)\{([a-zA-Z_0-9\-/]*)\})-", std::regex_constants::ECMAScript | std::regex_constants::icase);
-        std::cmatch match;
+        // common case: string without variables is returned as is without any allocation and locking
+        if (str.find('$') == std::string_view::npos)
+        {
+            return std::nullopt;
+        }
 
-        std::string_view currentStr = str;
-        std::string result;
+        if (!m_expandedStringsSuspended)
+        {
+            const std::lock_guard lock(m_expandedStringsMutex);
+            if (auto iter = m_expandedStrings.find(str); iter != m_expandedStrings.end())
+            {
+                return iter->second;
+            }
+        }
 
-        while (std::regex_search(currentStr.data(), currentStr.data() + currentStr.size(), match, re))
+        // the cache is not locked while expanding: referenced properties can also contain variables (expanded by the nested calls)
+        const bool outerUsesResolvers = std::exchange(t_usesVariableResolvers, false);
+        std::optional<std::string> result = expandConfigVariables(str);
+        const bool usesResolvers = t_usesVariableResolvers;
+        t_usesVariableResolvers = outerUsesResolvers || usesResolvers;
+
+        if (!usesResolvers && !m_expandedStringsSuspended)
         {
-            MY_FATAL(match.size() >= 3);
+            const std::lock_guard lock(m_expandedStringsMutex);
+            // the cache is cleared on each change, so it is not evicted when full: the rest of the strings are just not cached
+            if (m_expandedStrings.size() < MaxExpandedStringsCount)
+            {
+                m_expandedStrings.try_emplace(std::string{str}, result);
+            }
+        }
 
-            std::string_view varKind{match[1].first, static_cast<size_t>(match[1].length())};
-            std::string_view varValue{match[2].first, static_cast<size_t>(match[2].length())};
+        return result;
+    }
 
-            std::string replacementStr;
+    std::optional<std::string> PropertyContainerImpl::expandConfigVariables(std::string_view str) const
+    {
+        // parses strings like $[VAR_KIND]{[VAR_VALUE]}, both kind and value can contain [a-zA-Z_0-9-/]
+        std::string result;
+        std::string_view currentStr = str;
+
+        while (const std::optional<ConfigVariable> variable = findConfigVariable(currentStr))
+        {
+            result.append(currentStr.data(), variable->text.data());
 
-            if (varKind.empty())
+            if (variable->kind.empty())
             {
-                auto propValue = findValueAtPath(varValue);
+                auto propValue = findValueAtPath(variable->value);
                 if (propValue && propValue->is<StringValue>())
                 {
-                    std::string strValue = propValue->as<const StringValue&>().getString();
-                    replacementStr.assign(strValue.data(), strValue.size());
+                    result.append(propValue->as<const StringValue&>().getString());
                 }
             }
-            else if (auto resolver = m_variableResolvers.find(varKind); resolver != m_variableResolvers.end())
+            else if (auto resolver = m_variableResolvers.find(variable->kind); resolver != m_variableResolvers.end())
             {
-                std::optional<std::string> resolvedStr = resolver->second(varValue);
-                if (resolvedStr)
-                {
-                    replacementStr = *std::move(resolvedStr);
-                }
-                else
-                {
-                    replacementStr.assign(match[0].first, static_cast<size_t>(match[0].length()));
-                }
+                t_usesVariableResolvers = true;
+                std::optional<std::string> resolvedStr = resolver->second(variable->value);
+                result.append(resolvedStr ? std::string_view{*resolvedStr} : variable->text);
             }
             else
             {
-                replacementStr.assign(match[0].first, static_cast<size_t>(match[0].length()));
+                result.append(variable->text);
             }
 
-            if (const auto& prefix = match.prefix(); prefix.length() > 0)
+            currentStr = currentStr.substr(variable->text.data() + variable->text.size() - currentStr.data());
+        }
+
+        if (result.empty())
+        {
+            return std::nullopt;
+        }
+
+        result.append(currentStr);
+        return result;
+    }
+
+    void PropertyContainerImpl::invalidateExpandedStrings(bool suspend) const
+    {
+        const std::lock_guard lock(m_expandedStringsMutex);
+        m_expandedStrings.clear();
+        if (suspend)
+        {
+            m_expandedStringsSuspended = true;
+        }
+    }
+
+    void PropertyContainerImpl::resumeExpandedStrings() const
+    {
+        // properties can not be modified while the read lock is held, so the cache can be used again
+        if (m_expandedStringsSuspended)
+        {
+            const std::lock_guard lock(m_expandedStringsMutex);
+            m_expandedStrings.clear();
+            m_expandedStringsSuspended = false;
+        }
+    }
+
+    void PropertyContainerImpl::publishSnapshot(std::string_view changedPath) const
+    {
+        // BE AWARE: publishSnapshot requires m_mutex to be locked !
+        std::vector<std::string_view> pathComponents;
+        for (const std::string_view propName : strings::Split(changedPath, std::string_view{"/"}))
+        {
+            if (!propName.empty())
             {
-                result.append(prefix.first, static_cast<size_t>(prefix.length()));
+                pathComponents.push_back(propName);
             }
+        }
 
-            result.append(replacementStr.data(), replacementStr.size());
+        PropertySnapshotNode::NodePtr root;
+        if (!pathComponents.empty() && !m_isSnapshotOutdated)
+        {
+            std::string normalizedPath;
+            for (const std::string_view propName : pathComponents)
+            {
+                normalizedPath.append("/").append(propName);
+            }
+
+            const auto isWithinChangedPath = [&normalizedPath](std::string_view path)
+            {
+                return path.starts_with(normalizedPath) && (path.size() == normalizedPath.size() || path[normalizedPath.size()] == '/');
+            };
+
+            // strings within the changed property are collected again, while its node is made
+            std::erase_if(m_variableStringPaths, isWithinChangedPath);
+            const size_t unchangedPathsCount = m_variableStringPaths.size();
+
+            PropertySnapshotNode::NodePtr node = makePropertySnapshotNode(findValueAtPath(changedPath), &m_variableStringPaths, normalizedPath);
+            root = replacePropertySnapshotNode(loadSnapshot()->getRoot(), pathComponents, std::move(node));
+
+            // the changed property can be referenced by the strings outside of it
+            for (size_t i = 0; i < unchangedPathsCount; ++i)
+            {
+                const std::string& path = m_variableStringPaths[i];
 
-            const auto& suffix = match.suffix();
-            currentStr = std::string_view{suffix.first, static_cast<size_t>(suffix.length())};
+                std::vector<std::string_view> components;
+                for (const std::string_view propName : strings::Split(path, std::string_view{"/"}))
+                {
+                    if (!propName.empty())
+                    {
+                        components.push_back(propName);
+                    }
+                }
+
+                root = replacePropertySnapshotNode(root, components, makePropertySnapshotNode(findValueAtPath(path)));
+            }
+        }
+        else
+        {
+            m_isSnapshotOutdated = false;
+            m_variableStringPaths.clear();
+            root = makePropertySnapshotNode(m_propsRoot, &m_variableStringPaths);
         }
 
-        if (result.empty())
+        storeSnapshot(std::make_shared<const PropertySnapshot>(std::move(root), m_version.load()));
+    }
+
+    PropertySnapshotPtr PropertyContainerImpl::loadSnapshot() const
+    {
+        const std::lock_guard lock(m_snapshotPtrMutex);
+        return m_snapshot;
+    }
+
+    void PropertyContainerImpl::storeSnapshot(PropertySnapshotPtr snapshot) const
+    {
+        // the previous snapshot is released outside of the lock
         {
-            return std::nullopt;
+            const std::lock_guard lock(m_snapshotPtrMutex);
+            m_snapshot.swap(snapshot);
         }
+    }
 
-        if (!currentStr.empty())
+    PropertySnapshotPtr PropertyContainerImpl::getSnapshot() const
+    {
+        // the modification lock can be held by the caller (through getModify), the previous snapshot is returned in that case
+        if (m_isSnapshotOutdated && !m_mutex.isLockedByThisThread())
         {
-            result.append(currentStr.data(), currentStr.size());
+            // try-lock: other thread can modify the properties, the previous snapshot is returned without waiting
+            if (const std::shared_lock lock{m_mutex, std::try_to_lock}; lock.owns_lock())
+            {
+                const std::lock_guard snapshotLock(m_snapshotMutex);
+                if (m_isSnapshotOutdated)
+                {
+                    resumeExpandedStrings();
+                    publishSnapshot();
+                }
+            }
         }
 
-        return result;
+        return loadSnapshot();
+    }
+
+    uint64_t PropertyContainerImpl::getVersion() const
+    {
+        return m_version.load();
     }
 
     bool PropertyContainerImpl::contains(std::string_view path) const
     {
         const std::shared_lock lock(m_mutex);
+        resumeExpandedStrings();
         return findValueAtPath(path) != nullptr;
     }
 
     RuntimeValuePtr PropertyContainerImpl::getRead(std::string_view path, ReadOnlyLock& lock, [[maybe_unused]] IAllocator* allocator) const
     {
         lock = std::shared_lock{m_mutex};
+        resumeExpandedStrings();
         return findValueAtPath(path);
     }
 
@@ -207,6 +398,10 @@ namespace my
         MY_FATAL(m_propsRoot);
 
         lock = std::unique_lock{m_mutex};
+        // returned container can be modified after this call, so the cache is not used until the next read access
+        invalidateExpandedStrings(true);
+        ++m_version;
+        m_isSnapshotOutdated = true;
 
         auto [parentPath, propName] = split_property_path(path);
 
@@ -240,6 +435,7 @@ namespace my
         MY_FATAL(m_propsRoot);
 
         const std::lock_guard lock(m_mutex);
+        invalidateExpandedStrings();
 
         auto [parentPath, propName] = split_property_path(path);
 
@@ -247,7 +443,12 @@ namespace my
         CheckResult(parentDict);
         MY_FATAL(*parentDict);
 
-        return (*parentDict)->setValue(propName, value);
+        CheckResult((*parentDict)->setValue(propName, value));
+
+        ++m_version;
+        publishSnapshot(path);
+
+        return kResultSuccess;
     }
 
     Result<> PropertyContainerImpl::mergeWithValue(const RuntimeValue& value)
@@ -260,9 +461,16 @@ namespace my
         }
 
         const std::lock_guard lock(m_mutex);
+        invalidateExpandedStrings();
 
         // const_cast<> is a temporary hack:. currently RuntimeValue::assign accepts Ptr<> that require only non-const values.
-        return RuntimeValue::assign(m_propsRoot, Ptr{&const_cast<RuntimeValue&>(value)}, ValueAssignOption::MergeCollection);
+        const Result<> assignResult = RuntimeValue::assign(m_propsRoot, Ptr{&const_cast<RuntimeValue&>(value)}, ValueAssignOption::MergeCollection);
+
+        // merge can be partially applied even on failure
+        ++m_version;
+        publishSnapshot();
+
+        return assignResult;
     }
 
     void PropertyContainerImpl::addVariableResolver(std::string_view kind, VariableResolverCallback resolver)
@@ -276,8 +484,19 @@ namespace my
         }
 
         const std::lock_guard lock(m_mutex);
+        invalidateExpandedStrings();
         [[maybe_unused]] auto [iter, emplaceOk] = m_variableResolvers.emplace(kind, std::move(resolver));
         MY_DEBUG_ASSERT(emplaceOk, "Variable resolver ({}) already exists", kind);
+
+        ++m_version;
+        if (!m_variableStringPaths.empty() || m_isSnapshotOutdated)
+        {
+            publishSnapshot();
+        }
+        else
+        {
+            storeSnapshot(std::make_shared<const PropertySnapshot>(loadSnapshot()->getRoot(), m_version.load()));
+        }
     }
 
     std::unique_ptr<PropertyContainer> createPropertyContainer()
@@ -290,10 +509,20 @@ namespace my
         if (strings::icaseEqual(contentType, "application/json"))
         {
             Result<RuntimeValuePtr> parseResult = serialization::jsonParse(stream);
-            CheckResult(parseResult)
+            CheckResult(parseResult);
 
             return properties.mergeWithValue(**parseResult);
         }
+        else if (strings::icaseEqual(contentType, serialization::ConfigBlobContentType))
+        {
+            Result<Buffer> buffer = io::readStreamToEnd(stream);
+            CheckResult(buffer);
+
+            Result<RuntimeValuePtr> blobResult = serialization::configBlobOpen(buffer->toReadOnly());
+            CheckResult(blobResult);
+
+            return properties.mergeWithValue(**blobResult);
+        }
         else
         {
             return MakeError("Unknown config's content type:({})", contentType);
@@ -314,20 +543,39 @@ namespace my
 
         if (contentType.empty())
         {
+            const fs::path extensionPath = filePath.extension();
 #ifdef _WIN32
-            if (strings::icaseEqual(std::wstring_view{filePath.extension().c_str()}, std::wstring_view{L".json"}))
+            const std::wstring_view extension{extensionPath.c_str()};
+            if (strings::icaseEqual(extension, std::wstring_view{L".json"}))
 #else
-            if (strings::icaseEqual(std::string_view{filePath.extension().c_str()}, std::string_view{".json"}))
+            const std::string_view extension{extensionPath.c_str()};
+            if (strings::icaseEqual(extension, std::string_view{".json"}))
 #endif
             {
                 contentType = "application/json";
             }
+            else if (strings::icaseEqual(extension.begin(), extension.end(), serialization::ConfigBlobFileExtension.begin(), serialization::ConfigBlobFileExtension.end()))
+            {
+                contentType = serialization::ConfigBlobContentType;
+            }
             else
             {
                 return MakeError("Can not determine file's content type:({})", filePath.string());
             }
         }
 
+        if (strings::icaseEqual(contentType, serialization::ConfigBlobContentType))
+        {
+            // compiled config is used directly from the file mapping, the values are copied only by merge.
+            if (const FilePtr file = openNativeFile(filePath, AccessMode::Read, OpenFileMode::OpenExisting))
+            {
+                Result<RuntimeValuePtr> blobResult = serialization::configBlobOpenFile(*file);
+                CheckResult(blobResult);
+
+                return properties.mergeWithValue(**blobResult);
+            }
+        }
+
         StreamPtr fileStream = createNativeFileStream(filePath, AccessMode::Read, OpenFileMode::OpenExisting);
         if (!fileStream)
         {
@@ -4,8 +4,13 @@
 
 #include "my/app/property_container.h"
 #include "my/rtti/rtti_impl.h"
+#include "my/threading/spin_lock.h"
 #include "my/utils/string_utils.h"
 
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
 namespace my
 {
     /**
@@ -29,6 +34,10 @@ namespace my
 
         void addVariableResolver(std::string_view kind, VariableResolverCallback resolver) override;
 
+        PropertySnapshotPtr getSnapshot() const override;
+
+        uint64_t getVersion() const override;
+
     private:
         RuntimeValuePtr findValueAtPath(std::string_view valuePath) const;
 
@@ -36,8 +45,53 @@ namespace my
 
         std::optional<std::string> expandConfigString(std::string_view str) const;
 
+        std::optional<std::string> expandConfigVariables(std::string_view str) const;
+
+        void invalidateExpandedStrings(bool suspend = false) const;
+
+        void resumeExpandedStrings() const;
+
+        /**
+            Publishes the new snapshot, requires m_mutex to be locked.
+            @param changedPath The only changed property: the snapshot is made by replacing its node and the nodes of the strings with variables
+                (other nodes are shared with the previous snapshot). Empty path means that the whole snapshot must be rebuilt.
+         */
+        void publishSnapshot(std::string_view changedPath = {}) const;
+
+        PropertySnapshotPtr loadSnapshot() const;
+
+        void storeSnapshot(PropertySnapshotPtr snapshot) const;
+
+        struct StringHash
+        {
+            using is_transparent = void;
+
+            size_t operator()(std::string_view str) const
+            {
+                return std::hash<std::string_view>{}(str);
+            }
+        };
+
         Ptr<Dictionary> m_propsRoot;
         std::map<std::string, VariableResolverCallback, strings::CiStringComparer<std::string_view>> m_variableResolvers;
-        mutable std::shared_mutex m_mutex;
+        mutable PropertyContainerMutex m_mutex;
+
+        // Expanded strings are cached by the source string text. Only the strings that reference the properties (${/path}) are cached:
+        // custom resolvers are not required to be pure (environment, time), so their results are expanded on each access.
+        // The cache is suspended while the properties can be modified through getModify(), until the next read access.
+        static constexpr size_t MaxExpandedStringsCount = 1024;
+        mutable std::unordered_map<std::string, std::optional<std::string>, StringHash, std::equal_to<>> m_expandedStrings;
+        mutable std::mutex m_expandedStringsMutex;
+        mutable std::atomic<bool> m_expandedStringsSuspended = false;
+
+        // std::atomic<std::shared_ptr> is not provided by all the standard libraries: the pointer is guarded by the spin lock (held only to copy the pointer)
+        mutable PropertySnapshotPtr m_snapshot;
+        mutable threading::SpinLock m_snapshotPtrMutex;
+        mutable std::mutex m_snapshotMutex;
+        std::atomic<uint64_t> m_version = 0;
+        // changes are made through getModify(): the snapshot is published on the next getSnapshot() call
+        mutable std::atomic<bool> m_isSnapshotOutdated = false;
+        // strings with variables can reference any property: their snapshot nodes are remade on each change (guarded by m_mutex, as publishSnapshot)
+        mutable std::vector<std::string> m_variableStringPaths;
     };
 }  // namespace my
@@ -0,0 +1,362 @@
+// #my_engine_source_file
+
+#include "property_snapshot.h"
+
+#include "my/rtti/rtti_impl.h"
+#include "my/serialization/json.h"
+#include "my/utils/string_utils.h"
+
+#include <algorithm>
+
+namespace my
+{
+    namespace
+    {
+        using NodePtr = PropertySnapshotNode::NodePtr;
+
+        constexpr std::string_view NonMutableValueError = "Attempt to modify properties snapshot value";
+
+        RuntimeValuePtr makeNodeValue(const NodePtr& node, IAllocator* allocator);
+
+        /**
+         */
+        class PropertySnapshotNull final : public OptionalValue
+        {
+            MY_REFCOUNTED_CLASS(my::PropertySnapshotNull, OptionalValue)
+
+        public:
+            bool isMutable() const override
+            {
+                return false;
+            }
+
+            bool hasValue() const override
+            {
+                return false;
+            }
+
+            RuntimeValuePtr getValue() override
+            {
+                return nullptr;
+            }
+
+            Result<> setValue([[maybe_unused]] RuntimeValuePtr value) override
+            {
+                return MakeError(NonMutableValueError);
+            }
+        };
+
+        /**
+         */
+        class PropertySnapshotCollection final : public ReadonlyCollection
+        {
+            MY_REFCOUNTED_CLASS(my::PropertySnapshotCollection, ReadonlyCollection)
+
+        public:
+            PropertySnapshotCollection(NodePtr node, IAllocator* allocator) :
+                m_node(std::move(node)),
+                m_elements(std::get<PropertySnapshotNode::Elements>(m_node->value)),
+                m_allocator(allocator)
+            {
+            }
+
+            bool isMutable() const override
+            {
+                return false;
+            }
+
+            size_t getSize() const override
+            {
+                return m_elements.size();
+            }
+
+            RuntimeValuePtr getAt(size_t index) override
+            {
+                MY_DEBUG_ASSERT(index < m_elements.size(), "Invalid index [{}]", index);
+                if (index >= m_elements.size())
+                {
+                    return nullptr;
+                }
+
+                return makeNodeValue(m_elements[index], m_allocator);
+            }
+
+            Result<> setAt([[maybe_unused]] size_t index, [[maybe_unused]] const RuntimeValuePtr& value) override
+            {
+                return MakeError(NonMutableValueError);
+            }
+
+        private:
+            const NodePtr m_node;
+            const PropertySnapshotNode::Elements& m_elements;
+            IAllocator* const m_allocator;
+        };
+
+        /**
+         */
+        class PropertySnapshotDictionary final : public ReadonlyDictionary
+        {
+            MY_REFCOUNTED_CLASS(my::PropertySnapshotDictionary, ReadonlyDictionary)
+
+        public:
+            PropertySnapshotDictionary(NodePtr node, IAllocator* allocator) :
+                m_node(std::move(node)),
+                m_members(std::get<PropertySnapshotNode::Members>(m_node->value)),
+                m_allocator(allocator)
+            {
+            }
+
+            bool isMutable() const override
+            {
+                return false;
+            }
+
+            size_t getSize() const override
+            {
+                return m_members.size();
+            }
+
+            std::string_view getKey(size_t index) const override
+            {
+                MY_DEBUG_ASSERT(index < m_members.size(), "Invalid index ({}) > size:({})", index, m_members.size());
+                return m_members[index].first;
+            }
+
+            RuntimeValuePtr getValue(std::string_view key) override
+            {
+                const NodePtr* const member = m_node->findMember(key);
+                return member ? makeNodeValue(*member, m_allocator) : nullptr;
+            }
+
+            Result<> setValue([[maybe_unused]] std::string_view key, [[maybe_unused]] const RuntimeValuePtr& value) override
+            {
+                return MakeError(NonMutableValueError);
+            }
+
+            bool containsKey(std::string_view key) const override
+            {
+                return m_node->findMember(key) != nullptr;
+            }
+
+        private:
+            const NodePtr m_node;
+            const PropertySnapshotNode::Members& m_members;
+            IAllocator* const m_allocator;
+        };
+
+        RuntimeValuePtr makeNodeValue(const NodePtr& node, IAllocator* allocator)
+        {
+            return std::visit([&]<typename T>(const T& value) -> RuntimeValuePtr
+            {
+                if constexpr (std::is_same_v<T, std::monostate>)
+                {
+                    return rtti::createInstanceWithAllocator<PropertySnapshotNull>(allocator);
+                }
+                else if constexpr (std::is_same_v<T, PropertySnapshotNode::Elements>)
+                {
+                    return rtti::createInstanceWithAllocator<PropertySnapshotCollection>(allocator, node, allocator);
+                }
+                else if constexpr (std::is_same_v<T, PropertySnapshotNode::Members>)
+                {
+                    return rtti::createInstanceWithAllocator<PropertySnapshotDictionary>(allocator, node, allocator);
+                }
+                else
+                {
+                    return makeValueCopy(value, allocator);
+                }
+            }, node->value);
+        }
+
+        const PropertySnapshotNode* findNodeAtPath(const PropertySnapshotNode* node, std::string_view path)
+        {
+            for (const std::string_view propName : strings::Split(path, std::string_view{"/"}))
+            {
+                if (propName.empty())
+                {
+                    continue;
+                }
+
+                const NodePtr* const member = node->findMember(propName);
+                if (!member)
+                {
+                    return nullptr;
+                }
+
+                node = member->get();
+            }
+
+            return node;
+        }
+    }  // namespace
+
+    const PropertySnapshotNode::NodePtr* PropertySnapshotNode::findMember(std::string_view key) const
+    {
+        const auto* const members = std::get_if<Members>(&value);
+        if (!members)
+        {
+            return nullptr;
+        }
+
+        const auto iter = std::lower_bound(members->begin(), members->end(), key, [](const auto& member, std::string_view key)
+        {
+            return std::string_view{member.first} < key;
+        });
+
+        return iter != members->end() && iter->first == key ? &iter->second : nullptr;
+    }
+
+    PropertySnapshotNode::NodePtr makePropertySnapshotNode(const RuntimeValuePtr& value, VariableStringPaths* variableStringPaths, std::string_view path)
+    {
+        auto node = std::make_shared<PropertySnapshotNode>();
+        if (!value)
+        {
+            return node;
+        }
+
+        if (OptionalValue* const optionalValue = value->as<OptionalValue*>())
+        {
+            return optionalValue->hasValue() ? makePropertySnapshotNode(optionalValue->getValue(), variableStringPaths, path) : node;
+        }
+
+        if (RuntimeValueRef* const refValue = value->as<RuntimeValueRef*>())
+        {
+            return makePropertySnapshotNode(refValue->getValue(), variableStringPaths, path);
+        }
+
+        if (const auto* const integer = value->as<const IntegerValue*>())
+        {
+            if (integer->isSigned())
+            {
+                node->value = integer->getInt64();
+            }
+            else
+            {
+                node->value = integer->getUint64();
+            }
+        }
+        else if (const auto* const floatPoint = value->as<const FloatValue*>())
+        {
+            node->value = floatPoint->getDouble();
+        }
+        else if (const auto* const boolValue = value->as<const BooleanValue*>())
+        {
+            node->value = boolValue->getBool();
+        }
+        else if (const auto* const str = value->as<const StringValue*>())
+        {
+            // the string returned by the value is already expanded, variables are looked for within the source json string
+            if (const auto* const jsonHolder = value->as<const serialization::JsonValueHolder*>(); jsonHolder && variableStringPaths)
+            {
+                const char* begin = nullptr;
+                const char* end = nullptr;
+                if (jsonHolder->getThisJsonValue().getString(&begin, &end) && std::string_view{begin, static_cast<size_t>(end - begin)}.find('$') != std::string_view::npos)
+                {
+                    variableStringPaths->emplace_back(path);
+                }
+            }
+
+            node->value = str->getString();
+        }
+        else if (ReadonlyCollection* const collection = value->as<ReadonlyCollection*>())
+        {
+            VariableStringPaths elementsVariableStrings;
+            VariableStringPaths* const elementsVariableStringsPtr = variableStringPaths ? &elementsVariableStrings : nullptr;
+
+            PropertySnapshotNode::Elements elements;
+            elements.reserve(collection->getSize());
+            for (size_t i = 0, size = collection->getSize(); i < size; ++i)
+            {
+                elements.push_back(makePropertySnapshotNode(collection->getAt(i), elementsVariableStringsPtr, path));
+            }
+
+            if (!elementsVariableStrings.empty())
+            {
+                variableStringPaths->emplace_back(path);
+            }
+
+            node->value = std::move(elements);
+        }
+        else if (ReadonlyDictionary* const dict = value->as<ReadonlyDictionary*>())
+        {
+            PropertySnapshotNode::Members members;
+            members.reserve(dict->getSize());
+            for (size_t i = 0, size = dict->getSize(); i < size; ++i)
+            {
+                const std::string_view key = dict->getKey(i);
+                const std::string memberPath = variableStringPaths ? std::format("{}/{}", path, key) : std::string{};
+                members.emplace_back(std::string{key}, makePropertySnapshotNode(dict->getValue(key), variableStringPaths, memberPath));
+            }
+
+            std::sort(members.begin(), members.end(), [](const auto& left, const auto& right)
+            {
+                return left.first < right.first;
+            });
+
+            node->value = std::move(members);
+        }
+
+        return node;
+    }
+
+    PropertySnapshotNode::NodePtr replacePropertySnapshotNode(const PropertySnapshotNode::NodePtr& root, std::span<const std::string_view> path, PropertySnapshotNode::NodePtr node)
+    {
+        if (path.empty())
+        {
+            return node;
+        }
+
+        const auto* const sourceMembers = root ? std::get_if<PropertySnapshotNode::Members>(&root->value) : nullptr;
+        PropertySnapshotNode::Members members = sourceMembers ? *sourceMembers : PropertySnapshotNode::Members{};
+
+        auto iter = std::lower_bound(members.begin(), members.end(), path.front(), [](const auto& member, std::string_view key)
+        {
+            return std::string_view{member.first} < key;
+        });
+
+        if (iter == members.end() || iter->first != path.front())
+        {
+            iter = members.emplace(iter, std::string{path.front()}, nullptr);
+        }
+
+        iter->second = replacePropertySnapshotNode(iter->second, path.subspan(1), std::move(node));
+
+        auto newRoot = std::make_shared<PropertySnapshotNode>();
+        newRoot->value = std::move(members);
+        return newRoot;
+    }
+
+    PropertySnapshot::PropertySnapshot(std::shared_ptr<const PropertySnapshotNode> root, uint64_t version) :
+        m_root(std::move(root)),
+        m_version(version)
+    {
+        MY_DEBUG_ASSERT(m_root);
+    }
+
+    uint64_t PropertySnapshot::getVersion() const
+    {
+        return m_version;
+    }
+
+    const std::shared_ptr<const PropertySnapshotNode>& PropertySnapshot::getRoot() const
+    {
+        return m_root;
+    }
+
+    bool PropertySnapshot::contains(std::string_view path) const
+    {
+        return findNodeAtPath(m_root.get(), path) != nullptr;
+    }
+
+    RuntimeValuePtr PropertySnapshot::getRead(std::string_view path, IAllocator* allocator) const
+    {
+        const PropertySnapshotNode* const node = findNodeAtPath(m_root.get(), path);
+        if (!node)
+        {
+            return nullptr;
+        }
+
+        // the node is owned by the snapshot: the returned value must keep it alive by the aliasing pointer
+        return makeNodeValue(NodePtr{m_root, node}, allocator);
+    }
+
+}  // namespace my
@@ -0,0 +1,52 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include "my/app/property_container.h"
+
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace my
+{
+    /**
+        Immutable properties tree node. Nodes are never changed after creation, so they are shared between the snapshots.
+     */
+    struct PropertySnapshotNode
+    {
+        using NodePtr = std::shared_ptr<const PropertySnapshotNode>;
+
+        // sorted by the key
+        using Members = std::vector<std::pair<std::string, NodePtr>>;
+        using Elements = std::vector<NodePtr>;
+
+        std::variant<std::monostate, bool, int64_t, uint64_t, double, std::string, Elements, Members> value;
+
+        const NodePtr* findMember(std::string_view key) const;
+    };
+
+    /**
+        Property paths of the strings with variables ($kind{value}). Expanded values of such strings depend on the other properties and on the variable resolvers.
+        Collection elements are not addressable by the property path, so strings within a collection are reported by the collection path.
+     */
+    using VariableStringPaths = std::vector<std::string>;
+
+    /**
+        Makes the snapshot subtree from the runtime value (a deep copy).
+        @param variableStringPaths If not null, receives the paths of the strings with variables found within the value.
+        @param path Property path of the value, used as the prefix for the collected paths.
+     */
+    PropertySnapshotNode::NodePtr makePropertySnapshotNode(const RuntimeValuePtr& value, VariableStringPaths* variableStringPaths = nullptr, std::string_view path = {});
+
+    /**
+        @return New tree with the node at path replaced with the 'node'.
+            Only the nodes along the path are copied, all the other nodes are shared with the source tree.
+     */
+    PropertySnapshotNode::NodePtr replacePropertySnapshotNode(const PropertySnapshotNode::NodePtr& root, std::span<const std::string_view> path, PropertySnapshotNode::NodePtr node);
+
+}  // namespace my
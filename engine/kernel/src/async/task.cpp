@@ -8,6 +8,40 @@
 using namespace my::my_literals;
 
 namespace my::async_detail {
+
+namespace {
+// The allocator that owns the frame is kept right after the (aligned) frame.
+size_t getCoroutineFrameSize(size_t size)
+{
+    return alignedSize(size, alignof(IAllocator*));
+}
+}  // namespace
+
+void* TaskPromiseTag::allocateCoroutineFrame(size_t size, IAllocator* allocator)
+{
+    const size_t frameSize = getCoroutineFrameSize(size);
+    const size_t storageSize = frameSize + sizeof(IAllocator*);
+
+    void* const ptr = allocator ? allocator->alloc(storageSize) : ::operator new(storageSize);
+    MY_FATAL(ptr, "Fail to allocate coroutine frame ({}) bytes", storageSize);
+
+    *reinterpret_cast<IAllocator**>(reinterpret_cast<std::byte*>(ptr) + frameSize) = allocator;
+    return ptr;
+}
+
+void TaskPromiseTag::freeCoroutineFrame(void* ptr, size_t size) noexcept
+{
+    IAllocator* const allocator = *reinterpret_cast<IAllocator**>(reinterpret_cast<std::byte*>(ptr) + getCoroutineFrameSize(size));
+    if (allocator)
+    {
+        allocator->free(ptr);
+    }
+    else
+    {
+        ::operator delete(ptr);
+    }
+}
+
 #pragma region CoreTaskLinkedList
 
 bool operator==(const CoreTaskLinkedList::iterator& iter1, const CoreTaskLinkedList::iterator& iter2)
@@ -28,7 +28,10 @@ async::Task<RawPacket> readHttpPacket(io::IAsyncStream& stream)
             co_return MakeError("Unexpected end of steram");
         }
 
-        http = HttpParser{asStringView(packet)};
+        if (http.parse(asStringView(packet)) == HttpParser::ParseStatus::Invalid)
+        {
+            co_return MakeError("Invalid packet: malformed http head");
+        }
     }
 
     if (!http.hasHeader("Content-Length"))
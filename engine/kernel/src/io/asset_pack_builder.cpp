@@ -0,0 +1,288 @@
+// #my_engine_source_file
+
+#include "my/io/asset_pack_builder.h"
+
+#include "my/io/asset_pack.h"
+#include "my/serialization/json_utils.h"
+#include "my/utils/scope_guard.h"
+#include "my/utils/string_utils.h"
+
+namespace my::io
+{
+    namespace
+    {
+        struct SourceFile
+        {
+            FsPath path;           // path within the source file system
+            std::string packPath;  // path within the asset pack (relative to the root)
+        };
+
+        /**
+            Blob identity: identical files are detected by the hash, then confirmed by the byte comparison.
+         */
+        struct BlobKey
+        {
+            size_t size;
+            size_t hash;
+
+            bool operator==(const BlobKey&) const = default;
+        };
+
+        struct BlobKeyHash
+        {
+            size_t operator()(const BlobKey& key) const
+            {
+                return key.hash ^ (key.size * 0x9E3779B97F4A7C15ull);
+            }
+        };
+
+        struct PackedBlob
+        {
+            size_t sourceFileIndex;  // first file with such content: used to confirm that the content is identical
+            std::string compression;
+            BlobData blobData;
+        };
+
+        Result<> collectFiles(FileSystem& source, const FsPath& dirPath, const std::string& packDirPath, std::vector<SourceFile>& files)
+        {
+            FileSystem::OpenDirResult openResult = source.openDirIterator(dirPath);
+            CheckResult(openResult);
+
+            auto& [iteratorState, firstEntry] = *openResult;
+            scope_on_leave
+            {
+                source.closeDirIterator(iteratorState);
+            };
+
+            std::vector<std::tuple<FsPath, std::string>> subDirectories;
+            for (FsEntry entry = std::move(firstEntry); entry; entry = source.incrementDirIterator(iteratorState))
+            {
+                std::string packPath = packDirPath.empty() ? std::string{entry.path.getName()} : std::format("{}/{}", packDirPath, entry.path.getName());
+                if (entry.kind == FsEntryKind::Directory)
+                {
+                    subDirectories.emplace_back(std::move(entry.path), std::move(packPath));
+                }
+                else
+                {
+                    files.emplace_back(std::move(entry.path), std::move(packPath));
+                }
+            }
+
+            for (const auto& [subDirectoryPath, subDirectoryPackPath] : subDirectories)
+            {
+                CheckResult(collectFiles(source, subDirectoryPath, subDirectoryPackPath, files));
+            }
+
+            return kResultSuccess;
+        }
+
+        Result<Buffer> readFileContent(FileSystem& source, const FsPath& path)
+        {
+            const FilePtr file = source.openFile(path, AccessMode::Read, OpenFileMode::OpenExisting);
+            if (!file)
+            {
+                return MakeError("Fail to open source file ({})", path.getString());
+            }
+
+            const StreamPtr stream = file->createStream(AccessMode::Read);
+            if (!stream)
+            {
+                return MakeError("Fail to read source file ({})", path.getString());
+            }
+
+            const size_t size = file->getSize();
+            Buffer content{size};
+            Result<size_t> readResult = copyFromStream(content.data(), size, *stream);
+            CheckResult(readResult);
+
+            if (*readResult != size)
+            {
+                return MakeError("Unexpected end of source file ({})", path.getString());
+            }
+
+            return content;
+        }
+
+        Result<> writeContent(IStream& output, std::span<const std::byte> content)
+        {
+            size_t writeOffset = 0;
+            while (writeOffset < content.size())
+            {
+                Result<size_t> writeResult = output.write(content.data() + writeOffset, content.size() - writeOffset);
+                CheckResult(writeResult);
+                if (*writeResult == 0)
+                {
+                    return MakeError("Fail to write asset pack");
+                }
+
+                writeOffset += *writeResult;
+            }
+
+            return kResultSuccess;
+        }
+
+        ContentCompression getFileCompression(const AssetPackBuildSettings& settings, std::string_view packPath, size_t size)
+        {
+            if (size < settings.minCompressionSize)
+            {
+                return ContentCompression::None;
+            }
+
+            const FsPath path{packPath};
+            std::string_view extension = path.getExtension();
+            if (extension.starts_with('.'))
+            {
+                extension.remove_prefix(1);
+            }
+
+            for (const auto& [ruleExtension, compression] : settings.compressionByExtension)
+            {
+                std::string_view normalizedRuleExtension = ruleExtension;
+                if (normalizedRuleExtension.starts_with('.'))
+                {
+                    normalizedRuleExtension.remove_prefix(1);
+                }
+
+                if (strings::icaseEqual(extension, normalizedRuleExtension))
+                {
+                    return compression;
+                }
+            }
+
+            return settings.defaultCompression;
+        }
+    }  // namespace
+
+    Result<AssetPackBuildResult> buildAssetPack(FileSystem& source, const FsPath& root, IStream& output, const AssetPackBuildSettings& settings)
+    {
+        if (!output.canSeek() || !output.canWrite())
+        {
+            return MakeError("Asset pack output stream must be writable and seekable");
+        }
+
+        for (const ContentCompression compression : {settings.defaultCompression, ContentCompression::None})
+        {
+            if (!isContentCompressionAvailable(compression))
+            {
+                return MakeError("Content compression ({}) is not available", getContentCompressionName(compression));
+            }
+        }
+
+        for (const auto& [extension, compression] : settings.compressionByExtension)
+        {
+            if (!isContentCompressionAvailable(compression))
+            {
+                return MakeError("Content compression ({}) for ({}) is not available", getContentCompressionName(compression), extension);
+            }
+        }
+
+        std::vector<SourceFile> files;
+        CheckResult(collectFiles(source, root, {}, files));
+
+        // Sorted content gives the reproducible asset pack for the same source.
+        std::sort(files.begin(), files.end(), [](const SourceFile& left, const SourceFile& right)
+        {
+            return left.packPath < right.packPath;
+        });
+
+        const size_t startPosition = output.getPosition();
+        const auto getPackOffset = [&output, startPosition]
+        {
+            return output.getPosition() - startPosition;
+        };
+
+        // header placeholder: the index location is known only when all the blobs are written
+        const AssetPackHeader headerPlaceholder{};
+        CheckResult(writeContent(output, std::as_bytes(std::span{&headerPlaceholder, 1})));
+
+        AssetPackBuildResult buildResult;
+        AssetPackIndexData index{.version = settings.version, .description = settings.description};
+        index.content.reserve(files.size());
+
+        std::unordered_multimap<BlobKey, PackedBlob, BlobKeyHash> blobs;
+
+        for (size_t fileIndex = 0; fileIndex < files.size(); ++fileIndex)
+        {
+            const SourceFile& file = files[fileIndex];
+
+            Result<Buffer> content = readFileContent(source, file.path);
+            CheckResult(content);
+
+            const std::span<const std::byte> contentData{content->data(), content->size()};
+            const BlobKey blobKey{
+                .size = contentData.size(),
+                .hash = std::hash<std::string_view>{}(std::string_view{reinterpret_cast<const char*>(contentData.data()), contentData.size()})};
+
+            buildResult.sourceSize += contentData.size();
+
+            const PackedBlob* packedBlob = nullptr;
+            for (auto [iter, end] = blobs.equal_range(blobKey); iter != end; ++iter)
+            {
+                // Hash collision is unlikely, but the pack must never substitute the content: confirm by the bytes.
+                Result<Buffer> blobContent = readFileContent(source, files[iter->second.sourceFileIndex].path);
+                CheckResult(blobContent);
+                if (blobContent->size() == contentData.size() && memcmp(blobContent->data(), contentData.data(), contentData.size()) == 0)
+                {
+                    packedBlob = &iter->second;
+                    break;
+                }
+            }
+
+            if (!packedBlob)
+            {
+                ContentCompression compression = getFileCompression(settings, file.packPath, contentData.size());
+                std::span<const std::byte> blobData = contentData;
+
+                Buffer compressedContent;
+                if (compression != ContentCompression::None)
+                {
+                    Result<Buffer> compressResult = compressContent(compression, contentData);
+                    CheckResult(compressResult);
+
+                    compressedContent = std::move(*compressResult);
+                    if (compressedContent.size() < contentData.size())
+                    {
+                        blobData = {compressedContent.data(), compressedContent.size()};
+                        ++buildResult.compressedBlobsCount;
+                    }
+                    else
+                    {
+                        compression = ContentCompression::None;
+                    }
+                }
+
+                PackedBlob newBlob{
+                    .sourceFileIndex = fileIndex,
+                    .compression = compression == ContentCompression::None ? std::string{} : std::string{getContentCompressionName(compression)},
+                    .blobData = {.size = blobData.size(), .offset = getPackOffset()}};
+
+                CheckResult(writeContent(output, blobData));
+
+                packedBlob = &blobs.emplace(blobKey, std::move(newBlob))->second;
+                ++buildResult.uniqueBlobsCount;
+            }
+
+            index.content.push_back(AssetPackFileEntry{
+                .filePath = file.packPath,
+                .contentCompression = packedBlob->compression,
+                .clientSize = contentData.size(),
+                .blobData = packedBlob->blobData});
+        }
+
+        const std::string indexString = serialization::JsonUtils::stringify(index);
+        const AssetPackHeader header{
+            .indexOffset = getPackOffset(),
+            .indexSize = indexString.size()};
+
+        CheckResult(writeContent(output, std::as_bytes(std::span{indexString})));
+        buildResult.packSize = getPackOffset();
+        buildResult.filesCount = files.size();
+
+        output.setPosition(OffsetOrigin::Begin, static_cast<int64_t>(startPosition));
+        CheckResult(writeContent(output, std::as_bytes(std::span{&header, 1})));
+        output.setPosition(OffsetOrigin::Begin, static_cast<int64_t>(startPosition + buildResult.packSize));
+        output.flush();
+
+        return buildResult;
+    }
+}  // namespace my::io
@@ -0,0 +1,504 @@
+// #my_engine_source_file
+
+#include "my/io/asset_pack_file_system.h"
+
+#include <unordered_set>
+
+#include "io/decompressed_content_cache.h"
+#include "io/memory_view_file.h"
+#include "my/diag/logging.h"
+#include "my/io/asset_pack.h"
+#include "my/io/content_compression.h"
+#include "my/rtti/rtti_impl.h"
+#include "my/serialization/json_utils.h"
+
+namespace my::io
+{
+    namespace
+    {
+        /**
+            Whole asset pack memory: the pack's file is mapped once (or read at once when the memory mapping is not supported).
+            All opened files are views into this memory.
+         */
+        class AssetPackStorage final : public virtual IRefCounted
+        {
+            MY_REFCOUNTED_CLASS(my::io::AssetPackStorage, IRefCounted)
+
+        public:
+            static Result<Ptr<AssetPackStorage>> open(const std::filesystem::path& packPath)
+            {
+                const std::filesystem::path basePath = packPath.has_parent_path() ? packPath.parent_path() : std::filesystem::current_path();
+                const FileSystemPtr nativeFs = createNativeFileSystem(basePath);
+                if (!nativeFs)
+                {
+                    return MakeError("Asset pack directory ({}) not exists", basePath.string());
+                }
+
+                FilePtr file = nativeFs->openFile(packPath.filename().string(), AccessMode::Read, OpenFileMode::OpenExisting);
+                if (!file)
+                {
+                    return MakeError("Fail to open asset pack ({})", packPath.string());
+                }
+
+                auto storage = rtti::createInstance<AssetPackStorage>();
+                const size_t packSize = file->getSize();
+
+                if (IMemoryMappableObject* const mappable = file->as<IMemoryMappableObject*>(); mappable && file->supports(IFile::FileFeature::MemoryMapping))
+                {
+                    void* const ptr = packSize > 0 ? mappable->memMap(0, packSize) : nullptr;
+                    if (packSize > 0 && !ptr)
+                    {
+                        return MakeError("Fail to map asset pack ({})", packPath.string());
+                    }
+
+                    storage->m_mappedPtr = ptr;
+                    storage->m_data = {reinterpret_cast<const std::byte*>(ptr), packSize};
+                }
+                else
+                {
+                    const StreamPtr stream = file->createStream(AccessMode::Read);
+                    if (!stream)
+                    {
+                        return MakeError("Fail to read asset pack ({})", packPath.string());
+                    }
+
+                    storage->m_buffer = Buffer{packSize};
+                    size_t readCount = 0;
+                    while (readCount < packSize)
+                    {
+                        const Result<size_t> readResult = stream->read(storage->m_buffer.data() + readCount, packSize - readCount);
+                        CheckResult(readResult);
+                        if (*readResult == 0)
+                        {
+                            return MakeError("Unexpected end of asset pack ({})", packPath.string());
+                        }
+                        readCount += *readResult;
+                    }
+
+                    storage->m_data = {storage->m_buffer.data(), packSize};
+                }
+
+                storage->m_file = std::move(file);
+                return storage;
+            }
+
+            ~AssetPackStorage()
+            {
+                if (m_mappedPtr)
+                {
+                    m_file->as<IMemoryMappableObject&>().memUnmap(m_mappedPtr);
+                }
+            }
+
+            std::span<const std::byte> getData() const
+            {
+                return m_data;
+            }
+
+        private:
+            FilePtr m_file;
+            void* m_mappedPtr = nullptr;
+            Buffer m_buffer;
+            std::span<const std::byte> m_data;
+        };
+
+        /**
+            Compressed file that is too large for the decompressed content cache:
+            the content is decompressed on demand by the stream, the whole decompressed data is never kept in memory.
+         */
+        class CompressedContentFile final : public IFile,
+                                            public io_detail::IFileInternal
+        {
+            MY_REFCOUNTED_CLASS(my::io::CompressedContentFile, IFile, io_detail::IFileInternal)
+
+        public:
+            CompressedContentFile(FsPath path, Ptr<> memoryOwner, ContentCompression compression, std::span<const std::byte> compressedContent, size_t clientSize) :
+                m_path(std::move(path)),
+                m_memoryOwner(std::move(memoryOwner)),
+                m_compression(compression),
+                m_compressedContent(compressedContent),
+                m_clientSize(clientSize)
+            {
+            }
+
+            bool supports(FileFeature) const override
+            {
+                return false;
+            }
+
+            bool isOpened() const override
+            {
+                return true;
+            }
+
+            StreamBasePtr createStream(std::optional<AccessModeFlag> accessMode) override
+            {
+                if (accessMode && accessMode->has(AccessMode::Write))
+                {
+                    MY_DEBUG_FAILURE("Asset pack file is read only");
+                    return nullptr;
+                }
+
+                return createDecompressionStream(m_compression, m_memoryOwner, m_compressedContent, m_clientSize);
+            }
+
+            AccessModeFlag getAccessMode() const override
+            {
+                return AccessMode::Read;
+            }
+
+            size_t getSize() const override
+            {
+                return m_clientSize;
+            }
+
+            FsPath getPath() const override
+            {
+                return m_path;
+            }
+
+            void setVfsPath(FsPath path) override
+            {
+                m_path = std::move(path);
+            }
+
+        private:
+            FsPath m_path;
+            const Ptr<> m_memoryOwner;
+            const ContentCompression m_compression;
+            const std::span<const std::byte> m_compressedContent;
+            const size_t m_clientSize;
+        };
+
+        std::string_view getNormalizedPath(std::string_view path)
+        {
+            while (!path.empty() && path.front() == '/')
+            {
+                path.remove_prefix(1);
+            }
+
+            while (!path.empty() && path.back() == '/')
+            {
+                path.remove_suffix(1);
+            }
+
+            return path;
+        }
+    }  // namespace
+
+    /**
+     */
+    class AssetPackFileSystem final : public FileSystem
+    {
+        MY_REFCOUNTED_CLASS(my::io::AssetPackFileSystem, FileSystem)
+
+    public:
+        AssetPackFileSystem(Ptr<AssetPackStorage> storage, AssetPackFileSystemSettings settings) :
+            m_storage(std::move(storage)),
+            m_maxCacheSize(settings.maxCacheSize),
+            m_cache(settings.maxCacheSize, settings.lifetimeOfCache)
+        {
+        }
+
+        Result<> loadIndex();
+
+        bool isReadOnly() const override
+        {
+            return true;
+        }
+
+        bool exists(const FsPath& path, std::optional<FsEntryKind> kind) override;
+
+        size_t getLastWriteTime(const FsPath&) override
+        {
+            return 0;
+        }
+
+        FilePtr openFile(const FsPath& path, AccessModeFlag accessMode, OpenFileMode openMode) override;
+
+        OpenDirResult openDirIterator(const FsPath& path) override;
+
+        void closeDirIterator(void*) override;
+
+        FsEntry incrementDirIterator(void*) override;
+
+    private:
+        struct PackEntry
+        {
+            std::string path;
+            std::optional<ContentCompression> compression;  // nullopt if compression is not supported
+            size_t clientSize;
+            BlobData blob;
+        };
+
+        struct DirIteratorState
+        {
+            FsPath basePath;
+            std::string prefix;  // "dir/" or empty for the root
+            size_t index;
+        };
+
+        FsEntry nextDirEntry(DirIteratorState& state) const;
+
+        const Ptr<AssetPackStorage> m_storage;
+        const size_t m_maxCacheSize;
+        DecompressedContentCache m_cache;
+
+        std::vector<PackEntry> m_entries;                          // sorted by path
+        std::unordered_map<std::string_view, size_t> m_fileIndex;  // keys are views into m_entries
+        std::unordered_set<std::string> m_directories;
+    };
+
+    Result<> AssetPackFileSystem::loadIndex()
+    {
+        const std::span<const std::byte> packData = m_storage->getData();
+
+        AssetPackHeader header;
+        if (packData.size() < sizeof(header))
+        {
+            return MakeError("Invalid asset pack: too small");
+        }
+
+        memcpy(&header, packData.data(), sizeof(header));
+        if (header.signature != AssetPackHeader::Signature)
+        {
+            return MakeError("Invalid asset pack signature");
+        }
+
+        if (header.version != AssetPackHeader::CurrentVersion)
+        {
+            return MakeError("Unsupported asset pack version: ({})", header.version);
+        }
+
+        if (header.indexOffset > packData.size() || header.indexSize > packData.size() - header.indexOffset)
+        {
+            return MakeError("Invalid asset pack index location");
+        }
+
+        const std::string_view indexString{reinterpret_cast<const char*>(packData.data() + header.indexOffset), static_cast<size_t>(header.indexSize)};
+        Result<AssetPackIndexData> indexData = serialization::JsonUtils::parse<AssetPackIndexData>(indexString);
+        CheckResult(indexData);
+
+        m_entries.reserve(indexData->content.size());
+        for (AssetPackFileEntry& fileEntry : indexData->content)
+        {
+            const BlobData& blob = fileEntry.blobData;
+            if (blob.offset > packData.size() || blob.size > packData.size() - blob.offset)
+            {
+                return MakeError("Invalid blob location for ({})", fileEntry.filePath);
+            }
+
+            std::optional<ContentCompression> compression = parseContentCompression(fileEntry.contentCompression);
+            if (compression && !isContentCompressionAvailable(*compression))
+            {
+                compression.reset();
+            }
+
+            if (!compression)
+            {
+                // The pack still can be mounted: only such entries can not be opened.
+                mylog_warn("Asset pack content compression ({}) is not supported, required for ({})", fileEntry.contentCompression, fileEntry.filePath);
+            }
+            else if (*compression == ContentCompression::None && blob.size != fileEntry.clientSize)
+            {
+                return MakeError("Invalid stored content size for ({})", fileEntry.filePath);
+            }
+
+            std::string path = makePreferredPathString(fileEntry.filePath);
+            path = getNormalizedPath(path);
+
+            m_entries.emplace_back(std::move(path), compression, fileEntry.clientSize, blob);
+        }
+
+        std::sort(m_entries.begin(), m_entries.end(), [](const PackEntry& left, const PackEntry& right)
+        {
+            return left.path < right.path;
+        });
+
+        m_fileIndex.reserve(m_entries.size());
+        m_directories.emplace();
+
+        for (size_t i = 0; i < m_entries.size(); ++i)
+        {
+            const std::string_view path = m_entries[i].path;
+            if (!m_fileIndex.emplace(path, i).second)
+            {
+                return MakeError("Duplicate asset pack entry ({})", path);
+            }
+
+            for (size_t pos = path.find('/'); pos != std::string_view::npos; pos = path.find('/', pos + 1))
+            {
+                m_directories.emplace(path.substr(0, pos));
+            }
+        }
+
+        return kResultSuccess;
+    }
+
+    bool AssetPackFileSystem::exists(const FsPath& path, std::optional<FsEntryKind> kind)
+    {
+        const std::string pathString = path.getString();
+        const std::string_view normalizedPath = getNormalizedPath(pathString);
+
+        if (kind != FsEntryKind::Directory && m_fileIndex.contains(normalizedPath))
+        {
+            return true;
+        }
+
+        return kind != FsEntryKind::File && m_directories.contains(std::string{normalizedPath});
+    }
+
+    FilePtr AssetPackFileSystem::openFile(const FsPath& path, AccessModeFlag accessMode, [[maybe_unused]] OpenFileMode openMode)
+    {
+        if (accessMode.has(AccessMode::Write))
+        {
+            MY_DEBUG_FAILURE("Asset pack file system is read only");
+            return nullptr;
+        }
+
+        const std::string pathString = path.getString();
+        const auto iter = m_fileIndex.find(getNormalizedPath(pathString));
+        if (iter == m_fileIndex.end())
+        {
+            return nullptr;
+        }
+
+        const size_t entryIndex = iter->second;
+        const PackEntry& entry = m_entries[entryIndex];
+        const std::span<const std::byte> blobData = m_storage->getData().subspan(entry.blob.offset, entry.blob.size);
+
+        if (!entry.compression)
+        {
+            mylog_error("Fail to open asset pack file ({}): content compression is not supported", entry.path);
+            return nullptr;
+        }
+
+        if (*entry.compression == ContentCompression::None)
+        {
+            return rtti::createInstance<MemoryViewFile>(path, m_storage, ReadOnlyBuffer{}, blobData);
+        }
+
+        if (entry.clientSize > m_maxCacheSize)
+        {
+            return rtti::createInstance<CompressedContentFile>(path, m_storage, *entry.compression, blobData, entry.clientSize);
+        }
+
+        ReadOnlyBuffer content = m_cache.get(entryIndex);
+        if (!content)
+        {
+            Buffer decompressedContent{entry.clientSize};
+            if (Result<> decompressResult = decompressContent(*entry.compression, blobData, {decompressedContent.data(), decompressedContent.size()}); !decompressResult)
+            {
+                mylog_error("Fail to open asset pack file ({}): {}", entry.path, decompressResult.getError()->getMessage());
+                return nullptr;
+            }
+
+            content = decompressedContent.toReadOnly();
+            m_cache.put(entryIndex, content);
+        }
+
+        const std::span<const std::byte> contentData{content.data(), content.size()};
+        return rtti::createInstance<MemoryViewFile>(path, nullptr, std::move(content), contentData);
+    }
+
+    FileSystem::OpenDirResult AssetPackFileSystem::openDirIterator(const FsPath& path)
+    {
+        const std::string pathString = path.getString();
+        const std::string_view normalizedPath = getNormalizedPath(pathString);
+        if (!m_directories.contains(std::string{normalizedPath}))
+        {
+            return {};
+        }
+
+        std::string prefix{normalizedPath};
+        if (!prefix.empty())
+        {
+            prefix.push_back('/');
+        }
+
+        const auto first = std::lower_bound(m_entries.begin(), m_entries.end(), prefix, [](const PackEntry& entry, const std::string& value)
+        {
+            return entry.path < value;
+        });
+
+        auto* const state = new DirIteratorState{path, std::move(prefix), static_cast<size_t>(first - m_entries.begin())};
+        FsEntry firstEntry = nextDirEntry(*state);
+
+        return {state, std::move(firstEntry)};
+    }
+
+    void AssetPackFileSystem::closeDirIterator(void* ptr)
+    {
+        delete reinterpret_cast<DirIteratorState*>(ptr);
+    }
+
+    FsEntry AssetPackFileSystem::incrementDirIterator(void* ptr)
+    {
+        if (!ptr)
+        {
+            return {};
+        }
+
+        return nextDirEntry(*reinterpret_cast<DirIteratorState*>(ptr));
+    }
+
+    FsEntry AssetPackFileSystem::nextDirEntry(DirIteratorState& state) const
+    {
+        if (state.index >= m_entries.size())
+        {
+            return {};
+        }
+
+        const PackEntry& entry = m_entries[state.index];
+        if (!entry.path.starts_with(state.prefix))
+        {
+            state.index = m_entries.size();
+            return {};
+        }
+
+        const std::string_view name = std::string_view{entry.path}.substr(state.prefix.size());
+        const size_t separatorPos = name.find('/');
+        if (separatorPos == std::string_view::npos)
+        {
+            ++state.index;
+            return FsEntry{
+                .path = state.basePath / name,
+                .kind = FsEntryKind::File,
+                .size = entry.clientSize,
+                .lastWriteTime = 0};
+        }
+
+        // Entries are sorted, so all the content of the sub directory is contiguous: skip it at once.
+        const std::string_view directoryName = name.substr(0, separatorPos);
+        const std::string_view directoryPrefix = std::string_view{entry.path}.substr(0, state.prefix.size() + separatorPos + 1);
+        do
+        {
+            ++state.index;
+        } while (state.index < m_entries.size() && m_entries[state.index].path.starts_with(directoryPrefix));
+
+        return FsEntry{
+            .path = state.basePath / directoryName,
+            .kind = FsEntryKind::Directory,
+            .size = 0,
+            .lastWriteTime = 0};
+    }
+
+    FileSystemPtr createAssetPackFileSystem(std::u8string_view assetPackPath, AssetPackFileSystemSettings settings)
+    {
+        Result<Ptr<AssetPackStorage>> storage = AssetPackStorage::open(std::filesystem::path{assetPackPath});
+        if (!storage)
+        {
+            mylog_error("Fail to open asset pack: {}", storage.getError()->getMessage());
+            return nullptr;
+        }
+
+        auto fileSystem = rtti::createInstance<AssetPackFileSystem>(std::move(*storage), settings);
+        if (Result<> loadResult = fileSystem->loadIndex(); !loadResult)
+        {
+            mylog_error("Fail to load asset pack index: {}", loadResult.getError()->getMessage());
+            return nullptr;
+        }
+
+        return fileSystem;
+    }
+}  // namespace my::io
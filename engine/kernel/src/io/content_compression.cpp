@@ -0,0 +1,477 @@
+// #my_engine_source_file
+
+#include "my/io/content_compression.h"
+
+#include "io/lz4_block.h"
+#include "my/rtti/rtti_impl.h"
+#include "my/utils/string_utils.h"
+
+#if MY_WITH_ZSTD
+    #include <zstd.h>
+#endif
+
+namespace my::io
+{
+    namespace
+    {
+        /**
+            LZ4 content chunk header: compressed size of the chunk.
+            Incompressible chunks are stored as is, that is marked with the highest bit.
+         */
+        constexpr uint32_t Lz4StoredChunkFlag = 0x80000000u;
+        constexpr size_t Lz4ChunkHeaderSize = sizeof(uint32_t);
+
+#if MY_WITH_ZSTD
+        constexpr int ZstdCompressionLevel = 9;
+#endif
+
+        struct Lz4Chunk
+        {
+            std::span<const std::byte> data;
+            bool isStored;
+        };
+
+        /**
+            Splits the LZ4 content into the chunks (without decompression).
+         */
+        Result<std::vector<Lz4Chunk>> getLz4Chunks(std::span<const std::byte> compressedContent, size_t clientSize)
+        {
+            std::vector<Lz4Chunk> chunks;
+            chunks.reserve((clientSize + ContentCompressionChunkSize - 1) / ContentCompressionChunkSize);
+
+            while (!compressedContent.empty())
+            {
+                if (compressedContent.size() < Lz4ChunkHeaderSize)
+                {
+                    return MakeError("Invalid LZ4 content chunk header");
+                }
+
+                uint32_t header;
+                memcpy(&header, compressedContent.data(), sizeof(header));
+                compressedContent = compressedContent.subspan(Lz4ChunkHeaderSize);
+
+                const size_t chunkSize = header & ~Lz4StoredChunkFlag;
+                if (chunkSize > compressedContent.size())
+                {
+                    return MakeError("LZ4 content chunk is out of bounds");
+                }
+
+                chunks.push_back(Lz4Chunk{compressedContent.first(chunkSize), (header & Lz4StoredChunkFlag) != 0});
+                compressedContent = compressedContent.subspan(chunkSize);
+            }
+
+            if (chunks.size() != (clientSize + ContentCompressionChunkSize - 1) / ContentCompressionChunkSize)
+            {
+                return MakeError("LZ4 content chunks count mismatch");
+            }
+
+            return chunks;
+        }
+
+        Result<> decompressLz4Chunk(const Lz4Chunk& chunk, std::span<std::byte> output)
+        {
+            if (chunk.isStored)
+            {
+                if (chunk.data.size() != output.size())
+                {
+                    return MakeError("LZ4 stored chunk size mismatch");
+                }
+
+                memcpy(output.data(), chunk.data.data(), output.size());
+                return kResultSuccess;
+            }
+
+            Result<size_t> decompressedSize = decompressLz4Block(chunk.data, output);
+            CheckResult(decompressedSize);
+
+            if (*decompressedSize != output.size())
+            {
+                return MakeError("LZ4 chunk size mismatch");
+            }
+
+            return kResultSuccess;
+        }
+
+        Result<Buffer> compressLz4(std::span<const std::byte> content)
+        {
+            Buffer result;
+            std::vector<std::byte> chunkBuffer(getLz4BlockMaxCompressedSize(ContentCompressionChunkSize));
+
+            for (size_t offset = 0; offset < content.size(); offset += ContentCompressionChunkSize)
+            {
+                const std::span<const std::byte> chunk = content.subspan(offset, std::min(ContentCompressionChunkSize, content.size() - offset));
+                const size_t compressedSize = compressLz4Block(chunk, chunkBuffer);
+
+                const bool storeChunk = compressedSize >= chunk.size();
+                const std::span<const std::byte> chunkData = storeChunk ? chunk : std::span<const std::byte>{chunkBuffer.data(), compressedSize};
+                const uint32_t header = static_cast<uint32_t>(chunkData.size()) | (storeChunk ? Lz4StoredChunkFlag : 0);
+
+                std::byte* const ptr = result.append(Lz4ChunkHeaderSize + chunkData.size());
+                memcpy(ptr, &header, sizeof(header));
+                memcpy(ptr + Lz4ChunkHeaderSize, chunkData.data(), chunkData.size());
+            }
+
+            return result;
+        }
+
+        Result<> decompressLz4(std::span<const std::byte> compressedContent, std::span<std::byte> output)
+        {
+            Result<std::vector<Lz4Chunk>> chunks = getLz4Chunks(compressedContent, output.size());
+            CheckResult(chunks);
+
+            for (size_t i = 0; i < chunks->size(); ++i)
+            {
+                const size_t offset = i * ContentCompressionChunkSize;
+                CheckResult(decompressLz4Chunk((*chunks)[i], output.subspan(offset, std::min(ContentCompressionChunkSize, output.size() - offset))));
+            }
+
+            return kResultSuccess;
+        }
+
+#if MY_WITH_ZSTD
+        Result<Buffer> compressZstd(std::span<const std::byte> content)
+        {
+            Buffer result{ZSTD_compressBound(content.size())};
+            const size_t compressedSize = ZSTD_compress(result.data(), result.size(), content.data(), content.size(), ZstdCompressionLevel);
+            if (ZSTD_isError(compressedSize))
+            {
+                return MakeError("Zstd compression error: {}", ZSTD_getErrorName(compressedSize));
+            }
+
+            result.resize(compressedSize);
+            return result;
+        }
+
+        Result<> decompressZstd(std::span<const std::byte> compressedContent, std::span<std::byte> output)
+        {
+            const size_t decompressedSize = ZSTD_decompress(output.data(), output.size(), compressedContent.data(), compressedContent.size());
+            if (ZSTD_isError(decompressedSize))
+            {
+                return MakeError("Zstd decompression error: {}", ZSTD_getErrorName(decompressedSize));
+            }
+
+            if (decompressedSize != output.size())
+            {
+                return MakeError("Zstd content size mismatch");
+            }
+
+            return kResultSuccess;
+        }
+#endif
+
+        /**
+            Base of the read only decompression streams: position management.
+         */
+        class DecompressionStreamBase : public IStream
+        {
+            MY_INTERFACE(my::io::DecompressionStreamBase, IStream)
+
+        public:
+            DecompressionStreamBase(Ptr<> memoryOwner, std::span<const std::byte> compressedContent, size_t clientSize) :
+                m_memoryOwner(std::move(memoryOwner)),
+                m_compressedContent(compressedContent),
+                m_clientSize(clientSize)
+            {
+            }
+
+            size_t getPosition() const override
+            {
+                return m_pos;
+            }
+
+            size_t setPosition(OffsetOrigin origin, int64_t offset) override
+            {
+                int64_t newPos = offset;  // OffsetOrigin::Begin
+                if (origin == OffsetOrigin::Current)
+                {
+                    newPos = static_cast<int64_t>(m_pos) + offset;
+                }
+                else if (origin == OffsetOrigin::End)
+                {
+                    newPos = static_cast<int64_t>(m_clientSize) + offset;
+                }
+
+                m_pos = static_cast<size_t>(std::clamp<int64_t>(newPos, 0, static_cast<int64_t>(m_clientSize)));
+                return m_pos;
+            }
+
+            Result<size_t> write(const std::byte*, size_t) override
+            {
+                return MakeError("Decompression stream is read only");
+            }
+
+            void flush() override
+            {
+            }
+
+            bool canSeek() const override
+            {
+                return true;
+            }
+
+            bool canRead() const override
+            {
+                return true;
+            }
+
+            bool canWrite() const override
+            {
+                return false;
+            }
+
+        protected:
+            const Ptr<> m_memoryOwner;
+            const std::span<const std::byte> m_compressedContent;
+            const size_t m_clientSize;
+            size_t m_pos = 0;
+        };
+
+        /**
+            Decompresses one LZ4 chunk at time: seeking is just a switch to the other chunk.
+         */
+        class Lz4DecompressionStream final : public DecompressionStreamBase
+        {
+            MY_REFCOUNTED_CLASS(my::io::Lz4DecompressionStream, DecompressionStreamBase)
+
+        public:
+            Lz4DecompressionStream(Ptr<> memoryOwner, std::span<const std::byte> compressedContent, size_t clientSize, std::vector<Lz4Chunk> chunks) :
+                DecompressionStreamBase(std::move(memoryOwner), compressedContent, clientSize),
+                m_chunks(std::move(chunks))
+            {
+            }
+
+            Result<size_t> read(std::byte* buffer, size_t count) override
+            {
+                size_t readCount = 0;
+                while (readCount < count && m_pos < m_clientSize)
+                {
+                    const size_t chunkIndex = m_pos / ContentCompressionChunkSize;
+                    if (m_currentChunkIndex != chunkIndex)
+                    {
+                        const size_t chunkOffset = chunkIndex * ContentCompressionChunkSize;
+                        m_chunkBuffer.resize(std::min(ContentCompressionChunkSize, m_clientSize - chunkOffset));
+                        CheckResult(decompressLz4Chunk(m_chunks[chunkIndex], m_chunkBuffer));
+                        m_currentChunkIndex = chunkIndex;
+                    }
+
+                    const size_t offsetInChunk = m_pos % ContentCompressionChunkSize;
+                    const size_t copyCount = std::min(count - readCount, m_chunkBuffer.size() - offsetInChunk);
+                    memcpy(buffer + readCount, m_chunkBuffer.data() + offsetInChunk, copyCount);
+
+                    readCount += copyCount;
+                    m_pos += copyCount;
+                }
+
+                return readCount;
+            }
+
+        private:
+            const std::vector<Lz4Chunk> m_chunks;
+            std::vector<std::byte> m_chunkBuffer;
+            std::optional<size_t> m_currentChunkIndex;
+        };
+
+#if MY_WITH_ZSTD
+        /**
+            Zstd frame can be decoded only forward: seeking backward restarts the decompression.
+         */
+        class ZstdDecompressionStream final : public DecompressionStreamBase
+        {
+            MY_REFCOUNTED_CLASS(my::io::ZstdDecompressionStream, DecompressionStreamBase)
+
+        public:
+            ZstdDecompressionStream(Ptr<> memoryOwner, std::span<const std::byte> compressedContent, size_t clientSize) :
+                DecompressionStreamBase(std::move(memoryOwner), compressedContent, clientSize),
+                m_stream(ZSTD_createDStream())
+            {
+                ZSTD_initDStream(m_stream);
+            }
+
+            ~ZstdDecompressionStream()
+            {
+                ZSTD_freeDStream(m_stream);
+            }
+
+            Result<size_t> read(std::byte* buffer, size_t count) override
+            {
+                if (m_pos < m_decodedPos)
+                {
+                    ZSTD_DCtx_reset(m_stream, ZSTD_reset_session_only);
+                    m_input = {m_compressedContent.data(), m_compressedContent.size(), 0};
+                    m_decodedPos = 0;
+                }
+
+                // skip the data before the current position (after forward seek)
+                std::array<std::byte, 4096> skipBuffer;
+                while (m_decodedPos < m_pos)
+                {
+                    Result<size_t> skipped = decode(skipBuffer.data(), std::min(skipBuffer.size(), m_pos - m_decodedPos));
+                    CheckResult(skipped);
+                    if (*skipped == 0)
+                    {
+                        return MakeError("Unexpected end of zstd content");
+                    }
+                }
+
+                count = std::min(count, m_clientSize - m_pos);
+                size_t readCount = 0;
+                while (readCount < count)
+                {
+                    Result<size_t> decoded = decode(buffer + readCount, count - readCount);
+                    CheckResult(decoded);
+                    if (*decoded == 0)
+                    {
+                        return MakeError("Unexpected end of zstd content");
+                    }
+
+                    readCount += *decoded;
+                }
+
+                m_pos += readCount;
+                return readCount;
+            }
+
+        private:
+            Result<size_t> decode(std::byte* buffer, size_t count)
+            {
+                ZSTD_outBuffer output{buffer, count, 0};
+                while (output.pos == 0)
+                {
+                    // the decoder can still have buffered output when the whole input is consumed
+                    const size_t inputPos = m_input.pos;
+                    const size_t result = ZSTD_decompressStream(m_stream, &output, &m_input);
+                    if (ZSTD_isError(result))
+                    {
+                        return MakeError("Zstd decompression error: {}", ZSTD_getErrorName(result));
+                    }
+
+                    if (output.pos == 0 && m_input.pos == inputPos)
+                    {
+                        break;
+                    }
+                }
+
+                m_decodedPos += output.pos;
+                return output.pos;
+            }
+
+            ZSTD_DStream* const m_stream;
+            ZSTD_inBuffer m_input{m_compressedContent.data(), m_compressedContent.size(), 0};
+            size_t m_decodedPos = 0;
+        };
+#endif
+
+    }  // namespace
+
+    std::string_view getContentCompressionName(ContentCompression compression)
+    {
+        switch (compression)
+        {
+            case ContentCompression::Lz4:
+                return "lz4";
+            case ContentCompression::Zstd:
+                return "zstd";
+            default:
+                return "none";
+        }
+    }
+
+    std::optional<ContentCompression> parseContentCompression(std::string_view name)
+    {
+        for (const ContentCompression compression : {ContentCompression::None, ContentCompression::Lz4, ContentCompression::Zstd})
+        {
+            if (strings::icaseEqual(name, getContentCompressionName(compression)))
+            {
+                return compression;
+            }
+        }
+
+        if (name.empty())
+        {
+            return ContentCompression::None;
+        }
+
+        return std::nullopt;
+    }
+
+    bool isContentCompressionAvailable(ContentCompression compression)
+    {
+#if MY_WITH_ZSTD
+        return true;
+#else
+        return compression != ContentCompression::Zstd;
+#endif
+    }
+
+    Result<Buffer> compressContent(ContentCompression compression, std::span<const std::byte> content)
+    {
+        if (compression == ContentCompression::Lz4)
+        {
+            return compressLz4(content);
+        }
+#if MY_WITH_ZSTD
+        if (compression == ContentCompression::Zstd)
+        {
+            return compressZstd(content);
+        }
+#endif
+        if (compression == ContentCompression::None)
+        {
+            Buffer result{content.size()};
+            memcpy(result.data(), content.data(), content.size());
+            return result;
+        }
+
+        return MakeError("Content compression ({}) is not available", getContentCompressionName(compression));
+    }
+
+    Result<> decompressContent(ContentCompression compression, std::span<const std::byte> compressedContent, std::span<std::byte> output)
+    {
+        if (compression == ContentCompression::Lz4)
+        {
+            return decompressLz4(compressedContent, output);
+        }
+#if MY_WITH_ZSTD
+        if (compression == ContentCompression::Zstd)
+        {
+            return decompressZstd(compressedContent, output);
+        }
+#endif
+        if (compression == ContentCompression::None)
+        {
+            if (compressedContent.size() != output.size())
+            {
+                return MakeError("Content size mismatch");
+            }
+
+            memcpy(output.data(), compressedContent.data(), output.size());
+            return kResultSuccess;
+        }
+
+        return MakeError("Content compression ({}) is not available", getContentCompressionName(compression));
+    }
+
+    StreamPtr createDecompressionStream(ContentCompression compression, Ptr<> memoryOwner, std::span<const std::byte> compressedContent, size_t clientSize)
+    {
+        if (compression == ContentCompression::Lz4)
+        {
+            Result<std::vector<Lz4Chunk>> chunks = getLz4Chunks(compressedContent, clientSize);
+            if (!chunks)
+            {
+                return nullptr;
+            }
+
+            return rtti::createInstance<Lz4DecompressionStream>(std::move(memoryOwner), compressedContent, clientSize, std::move(*chunks));
+        }
+#if MY_WITH_ZSTD
+        if (compression == ContentCompression::Zstd)
+        {
+            return rtti::createInstance<ZstdDecompressionStream>(std::move(memoryOwner), compressedContent, clientSize);
+        }
+#endif
+
+        MY_DEBUG_ASSERT(compression != ContentCompression::None, "Uncompressed content does not require decompression stream");
+        return nullptr;
+    }
+
+}  // namespace my::io
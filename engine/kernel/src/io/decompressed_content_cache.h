@@ -0,0 +1,102 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include "my/memory/buffer.h"
+
+namespace my::io
+{
+    /**
+        LRU cache of the decompressed content (used by the archive like file systems).
+        Entries are evicted when total size exceeds maxCacheSize or when an entry is not accessed longer than lifetimeOfCache.
+     */
+    class DecompressedContentCache
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        DecompressedContentCache(size_t maxSize, std::chrono::seconds lifetime) :
+            m_maxSize(maxSize),
+            m_lifetime(lifetime)
+        {
+        }
+
+        ReadOnlyBuffer get(size_t entryIndex)
+        {
+            const std::lock_guard lock(m_mutex);
+
+            const auto now = Clock::now();
+            evictExpired(now);
+
+            const auto iter = m_index.find(entryIndex);
+            if (iter == m_index.end())
+            {
+                return {};
+            }
+
+            // move to the front as the most recently used
+            m_entries.splice(m_entries.begin(), m_entries, iter->second);
+            iter->second->lastAccessTime = now;
+
+            return iter->second->content;
+        }
+
+        void put(size_t entryIndex, ReadOnlyBuffer content)
+        {
+            const size_t contentSize = content.size();
+            if (contentSize > m_maxSize)
+            {
+                return;
+            }
+
+            const std::lock_guard lock(m_mutex);
+            if (m_index.contains(entryIndex))
+            {
+                return;
+            }
+
+            const auto now = Clock::now();
+            evictExpired(now);
+
+            while (!m_entries.empty() && m_totalSize + contentSize > m_maxSize)
+            {
+                removeLast();
+            }
+
+            m_entries.emplace_front(entryIndex, std::move(content), now);
+            m_index.emplace(entryIndex, m_entries.begin());
+            m_totalSize += contentSize;
+        }
+
+    private:
+        struct CacheEntry
+        {
+            size_t entryIndex;
+            ReadOnlyBuffer content;
+            Clock::time_point lastAccessTime;
+        };
+
+        void evictExpired(Clock::time_point now)
+        {
+            while (!m_entries.empty() && m_entries.back().lastAccessTime + m_lifetime < now)
+            {
+                removeLast();
+            }
+        }
+
+        void removeLast()
+        {
+            CacheEntry& entry = m_entries.back();
+            m_totalSize -= entry.content.size();
+            m_index.erase(entry.entryIndex);
+            m_entries.pop_back();
+        }
+
+        const size_t m_maxSize;
+        const std::chrono::seconds m_lifetime;
+        std::list<CacheEntry> m_entries;  // most recently used are at the front
+        std::unordered_map<size_t, std::list<CacheEntry>::iterator> m_index;
+        size_t m_totalSize = 0;
+        std::mutex m_mutex;
+    };
+}  // namespace my::io
@@ -0,0 +1,120 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "my/io/file_system.h"
+#include "my/utils/string_utils.h"
+
+namespace my::io
+{
+    /**
+        Snapshots of the directories content of the single file system (used by the vfs mount points).
+        Snapshot is read at once with FileSystem::readDirEntries; absent directories are cached too (as nullptr).
+     */
+    class DirectoryContentCache
+    {
+    public:
+        using Content = std::shared_ptr<const std::vector<FsEntry>>;
+
+        static constexpr size_t MaxDirectoriesCount = 1024;
+
+        /**
+            Returns the directory content (paths are the same as returned by the file system) or nullptr if there is no such directory.
+         */
+        Content getContent(FileSystem& fs, const FsPath& path)
+        {
+            const std::string_view pathString{path.getCStr()};
+            uint64_t generation = 0;
+            {
+                const std::lock_guard lock(m_mutex);
+                if (auto iter = m_directories.find(pathString); iter != m_directories.end())
+                {
+                    return iter->second;
+                }
+
+                generation = m_generation;
+            }
+
+            // The directory is read without lock: the concurrent readers of the same directory can read it twice, the result is the same.
+            Content content = readContent(fs, path);
+
+            const std::lock_guard lock(m_mutex);
+
+            // the content can be already outdated if any invalidation happens while reading: it is returned, but not cached.
+            if (generation != m_generation)
+            {
+                return content;
+            }
+
+            if (m_directories.size() >= MaxDirectoriesCount)
+            {
+                m_directories.clear();
+            }
+
+            m_directories.emplace(pathString, content);
+            return content;
+        }
+
+        /**
+            Drops the snapshot of the directory (changed directory) and of its parent (the directory itself is an entry of the parent).
+         */
+        void invalidate(const FsPath& path)
+        {
+            const std::lock_guard lock(m_mutex);
+            ++m_generation;
+            m_directories.erase(std::string{path.getCStr()});
+            m_directories.erase(path.getParentPath().getString());
+        }
+
+        void invalidateAll()
+        {
+            const std::lock_guard lock(m_mutex);
+            ++m_generation;
+            m_directories.clear();
+        }
+
+    private:
+        static Content readContent(FileSystem& fs, const FsPath& path)
+        {
+            FileSystem::OpenDirResult openResult = fs.openDirIterator(path);
+            if (!openResult)
+            {
+                return nullptr;
+            }
+
+            auto& [iteratorState, firstEntry] = *openResult;
+            if (!iteratorState)
+            {
+                return firstEntry ? std::make_shared<const std::vector<FsEntry>>(1, std::move(firstEntry)) : nullptr;
+            }
+
+            constexpr size_t BatchSize = 64;
+
+            auto content = std::make_shared<std::vector<FsEntry>>();
+            if (firstEntry)
+            {
+                content->push_back(std::move(firstEntry));
+            }
+
+            for (size_t count = content->empty() ? 0 : BatchSize; count == BatchSize;)
+            {
+                const size_t offset = content->size();
+                content->resize(offset + BatchSize);
+                count = fs.readDirEntries(iteratorState, std::span{*content}.subspan(offset));
+                content->resize(offset + count);
+            }
+
+            fs.closeDirIterator(iteratorState);
+            return content;
+        }
+
+        std::mutex m_mutex;
+        std::unordered_map<std::string, Content, strings::StringHash, std::equal_to<>> m_directories;
+        uint64_t m_generation = 0;
+    };
+}  // namespace my::io
@@ -0,0 +1,509 @@
+// #my_engine_source_file
+
+#include "io/inflate.h"
+
+namespace my::io
+{
+    namespace
+    {
+        constexpr unsigned MaxCodeBits = 15;
+        constexpr unsigned MaxLengthCodes = 286;
+        constexpr unsigned MaxDistanceCodes = 30;
+        constexpr unsigned FixedLengthCodes = 288;
+        constexpr unsigned FastLookupBits = 9;
+
+        constexpr std::array<uint16_t, 29> LengthBase = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        constexpr std::array<uint8_t, 29> LengthExtraBits = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        constexpr std::array<uint16_t, 30> DistanceBase = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+        constexpr std::array<uint8_t, 30> DistanceExtraBits = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+        constexpr std::array<uint8_t, 19> CodeLengthOrder = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+        /**
+            LSB-first bit reader over the deflate stream.
+            Reading past the end of the input produces zero bits, the overrun is checked with isOverrun().
+         */
+        class BitReader
+        {
+        public:
+            BitReader(std::span<const std::byte> input) :
+                m_ptr(reinterpret_cast<const uint8_t*>(input.data())),
+                m_end(m_ptr + input.size())
+            {
+            }
+
+            uint32_t peek(unsigned count)
+            {
+                MY_DEBUG_ASSERT(count <= 32);
+                if (m_bitCount < count)
+                {
+                    refill();
+                }
+
+                return static_cast<uint32_t>(m_bits & ((uint64_t{1} << count) - 1));
+            }
+
+            void skip(unsigned count)
+            {
+                MY_DEBUG_ASSERT(count <= m_bitCount);
+                m_bits >>= count;
+                m_bitCount -= count;
+            }
+
+            uint32_t read(unsigned count)
+            {
+                const uint32_t value = peek(count);
+                skip(count);
+                return value;
+            }
+
+            void alignToByte()
+            {
+                skip(m_bitCount % 8);
+            }
+
+            bool readBytes(std::byte* output, size_t count)
+            {
+                MY_DEBUG_ASSERT(m_bitCount % 8 == 0);
+
+                // first take the bytes that are already in the bit buffer (except the padding)
+                for (; count > 0 && m_bitCount > m_padBytes * 8; --count)
+                {
+                    *output++ = static_cast<std::byte>(read(8));
+                }
+
+                if (count == 0)
+                {
+                    return true;
+                }
+
+                if (static_cast<size_t>(m_end - m_ptr) < count)
+                {
+                    return false;
+                }
+
+                memcpy(output, m_ptr, count);
+                m_ptr += count;
+                return true;
+            }
+
+            bool isOverrun() const
+            {
+                return m_padBytes * 8 > m_bitCount;
+            }
+
+        private:
+            void refill()
+            {
+                while (m_bitCount <= 56)
+                {
+                    if (m_ptr < m_end)
+                    {
+                        m_bits |= static_cast<uint64_t>(*m_ptr++) << m_bitCount;
+                    }
+                    else
+                    {
+                        ++m_padBytes;
+                    }
+                    m_bitCount += 8;
+                }
+            }
+
+            const uint8_t* m_ptr;
+            const uint8_t* const m_end;
+            uint64_t m_bits = 0;
+            unsigned m_bitCount = 0;
+            size_t m_padBytes = 0;
+        };
+
+        /**
+            Canonical huffman decoding table.
+            Codes up to FastLookupBits are decoded with a single lookup, the longer ones are decoded bit by bit.
+         */
+        struct HuffmanTable
+        {
+            std::array<uint16_t, MaxCodeBits + 1> count;
+            std::array<uint16_t, FixedLengthCodes> symbol;
+            std::array<uint16_t, 1 << FastLookupBits> fastLookup;  // (symbol << 4) | codeLength, zero when code is longer
+
+            bool build(const uint8_t* lengths, unsigned symbolCount)
+            {
+                count.fill(0);
+                fastLookup.fill(0);
+
+                for (unsigned s = 0; s < symbolCount; ++s)
+                {
+                    ++count[lengths[s]];
+                }
+
+                if (count[0] == symbolCount)
+                {  // no codes: valid for the distance table of the literal only blocks
+                    return true;
+                }
+
+                int left = 1;
+                for (unsigned len = 1; len <= MaxCodeBits; ++len)
+                {
+                    left = (left << 1) - count[len];
+                    if (left < 0)
+                    {  // over-subscribed
+                        return false;
+                    }
+                }
+
+                std::array<uint16_t, MaxCodeBits + 1> offsets;
+                offsets[1] = 0;
+                for (unsigned len = 1; len < MaxCodeBits; ++len)
+                {
+                    offsets[len + 1] = offsets[len] + count[len];
+                }
+
+                for (unsigned s = 0; s < symbolCount; ++s)
+                {
+                    if (lengths[s] != 0)
+                    {
+                        symbol[offsets[lengths[s]]++] = static_cast<uint16_t>(s);
+                    }
+                }
+
+                uint32_t code = 0;
+                unsigned index = 0;
+                for (unsigned len = 1; len <= FastLookupBits; ++len)
+                {
+                    for (unsigned i = 0; i < count[len]; ++i, ++code)
+                    {
+                        const uint16_t entry = static_cast<uint16_t>((symbol[index++] << 4) | len);
+                        for (uint32_t r = reverseBits(code, len); r < fastLookup.size(); r += (1u << len))
+                        {
+                            fastLookup[r] = entry;
+                        }
+                    }
+                    code <<= 1;
+                }
+
+                return true;
+            }
+
+            int decode(BitReader& reader) const
+            {
+                const uint32_t bits = reader.peek(MaxCodeBits);
+                if (const uint16_t entry = fastLookup[bits & (fastLookup.size() - 1)]; entry != 0)
+                {
+                    reader.skip(entry & 0xF);
+                    return entry >> 4;
+                }
+
+                int code = 0;
+                int first = 0;
+                int index = 0;
+                for (unsigned len = 1; len <= MaxCodeBits; ++len)
+                {
+                    code |= static_cast<int>((bits >> (len - 1)) & 1);
+                    const int codeCount = count[len];
+                    if (code - codeCount < first)
+                    {
+                        reader.skip(len);
+                        return symbol[index + (code - first)];
+                    }
+
+                    index += codeCount;
+                    first = (first + codeCount) << 1;
+                    code <<= 1;
+                }
+
+                return -1;
+            }
+
+            static uint32_t reverseBits(uint32_t code, unsigned len)
+            {
+                uint32_t result = 0;
+                for (unsigned i = 0; i < len; ++i, code >>= 1)
+                {
+                    result = (result << 1) | (code & 1);
+                }
+
+                return result;
+            }
+        };
+
+        struct FixedTables
+        {
+            HuffmanTable lengths;
+            HuffmanTable distances;
+
+            FixedTables()
+            {
+                std::array<uint8_t, FixedLengthCodes> codeLengths;
+                std::fill_n(codeLengths.begin(), 144, uint8_t{8});
+                std::fill_n(codeLengths.begin() + 144, 112, uint8_t{9});
+                std::fill_n(codeLengths.begin() + 256, 24, uint8_t{7});
+                std::fill_n(codeLengths.begin() + 280, 8, uint8_t{8});
+                [[maybe_unused]] const bool lengthsOk = lengths.build(codeLengths.data(), FixedLengthCodes);
+
+                std::fill_n(codeLengths.begin(), MaxDistanceCodes, uint8_t{5});
+                [[maybe_unused]] const bool distancesOk = distances.build(codeLengths.data(), MaxDistanceCodes);
+
+                MY_DEBUG_ASSERT(lengthsOk && distancesOk);
+            }
+        };
+
+        class Inflater
+        {
+        public:
+            Inflater(std::span<const std::byte> input, std::span<std::byte> output) :
+                m_reader(input),
+                m_outBegin(output.data()),
+                m_out(output.data()),
+                m_outEnd(output.data() + output.size())
+            {
+            }
+
+            Result<size_t> run()
+            {
+                bool lastBlock = false;
+                do
+                {
+                    lastBlock = m_reader.read(1) != 0;
+                    const uint32_t blockType = m_reader.read(2);
+
+                    Result<> blockResult;
+                    if (blockType == 0)
+                    {
+                        blockResult = storedBlock();
+                    }
+                    else if (blockType == 1)
+                    {
+                        static const FixedTables fixedTables;
+                        blockResult = decodeBlock(fixedTables.lengths, fixedTables.distances);
+                    }
+                    else if (blockType == 2)
+                    {
+                        blockResult = dynamicBlock();
+                    }
+                    else
+                    {
+                        return MakeError("Invalid deflate block type");
+                    }
+
+                    CheckResult(blockResult);
+
+                    if (m_reader.isOverrun())
+                    {
+                        return MakeError("Unexpected end of deflate stream");
+                    }
+                } while (!lastBlock);
+
+                return static_cast<size_t>(m_out - m_outBegin);
+            }
+
+        private:
+            Result<> storedBlock()
+            {
+                m_reader.alignToByte();
+                const uint32_t length = m_reader.read(16);
+                const uint32_t lengthComplement = m_reader.read(16);
+                if (length != (~lengthComplement & 0xFFFF))
+                {
+                    return MakeError("Invalid stored block length");
+                }
+
+                if (length > static_cast<size_t>(m_outEnd - m_out))
+                {
+                    return MakeError("Deflate output overflow");
+                }
+
+                if (!m_reader.readBytes(m_out, length))
+                {
+                    return MakeError("Unexpected end of deflate stream");
+                }
+
+                m_out += length;
+                return kResultSuccess;
+            }
+
+            Result<> dynamicBlock()
+            {
+                const unsigned lengthCount = m_reader.read(5) + 257;
+                const unsigned distanceCount = m_reader.read(5) + 1;
+                const unsigned codeLengthCount = m_reader.read(4) + 4;
+                if (lengthCount > MaxLengthCodes || distanceCount > MaxDistanceCodes)
+                {
+                    return MakeError("Invalid dynamic block header");
+                }
+
+                std::array<uint8_t, MaxLengthCodes + MaxDistanceCodes> codeLengths{};
+                for (unsigned i = 0; i < codeLengthCount; ++i)
+                {
+                    codeLengths[CodeLengthOrder[i]] = static_cast<uint8_t>(m_reader.read(3));
+                }
+
+                HuffmanTable codeLengthTable;
+                if (!codeLengthTable.build(codeLengths.data(), static_cast<unsigned>(CodeLengthOrder.size())))
+                {
+                    return MakeError("Invalid code lengths table");
+                }
+
+                std::fill(codeLengths.begin(), codeLengths.end(), uint8_t{0});
+                for (unsigned index = 0; index < lengthCount + distanceCount;)
+                {
+                    const int symbol = codeLengthTable.decode(m_reader);
+                    if (symbol < 0)
+                    {
+                        return MakeError("Invalid code length");
+                    }
+
+                    if (symbol < 16)
+                    {
+                        codeLengths[index++] = static_cast<uint8_t>(symbol);
+                        continue;
+                    }
+
+                    uint8_t repeatLength = 0;
+                    unsigned repeatCount = 0;
+                    if (symbol == 16)
+                    {
+                        if (index == 0)
+                        {
+                            return MakeError("Repeat of the missing code length");
+                        }
+                        repeatLength = codeLengths[index - 1];
+                        repeatCount = 3 + m_reader.read(2);
+                    }
+                    else if (symbol == 17)
+                    {
+                        repeatCount = 3 + m_reader.read(3);
+                    }
+                    else
+                    {
+                        repeatCount = 11 + m_reader.read(7);
+                    }
+
+                    if (index + repeatCount > lengthCount + distanceCount)
+                    {
+                        return MakeError("Too many code lengths");
+                    }
+
+                    std::fill_n(codeLengths.begin() + index, repeatCount, repeatLength);
+                    index += repeatCount;
+                }
+
+                if (codeLengths[256] == 0)
+                {
+                    return MakeError("Missing end of block code");
+                }
+
+                HuffmanTable lengthTable;
+                HuffmanTable distanceTable;
+                if (!lengthTable.build(codeLengths.data(), lengthCount) || !distanceTable.build(codeLengths.data() + lengthCount, distanceCount))
+                {
+                    return MakeError("Invalid huffman tables");
+                }
+
+                return decodeBlock(lengthTable, distanceTable);
+            }
+
+            Result<> decodeBlock(const HuffmanTable& lengthTable, const HuffmanTable& distanceTable)
+            {
+                for (;;)
+                {
+                    const int symbol = lengthTable.decode(m_reader);
+                    if (symbol < 256)
+                    {
+                        if (symbol < 0)
+                        {
+                            return MakeError("Invalid literal/length code");
+                        }
+
+                        if (m_out == m_outEnd)
+                        {
+                            return MakeError("Deflate output overflow");
+                        }
+
+                        *m_out++ = static_cast<std::byte>(symbol);
+                        continue;
+                    }
+
+                    if (symbol == 256)
+                    {
+                        return kResultSuccess;
+                    }
+
+                    const unsigned lengthIndex = static_cast<unsigned>(symbol) - 257;
+                    if (lengthIndex >= LengthBase.size())
+                    {
+                        return MakeError("Invalid length code");
+                    }
+
+                    const size_t length = LengthBase[lengthIndex] + m_reader.read(LengthExtraBits[lengthIndex]);
+
+                    const int distanceSymbol = distanceTable.decode(m_reader);
+                    if (distanceSymbol < 0 || distanceSymbol >= static_cast<int>(MaxDistanceCodes))
+                    {
+                        return MakeError("Invalid distance code");
+                    }
+
+                    const size_t distance = DistanceBase[distanceSymbol] + m_reader.read(DistanceExtraBits[distanceSymbol]);
+                    if (distance > static_cast<size_t>(m_out - m_outBegin))
+                    {
+                        return MakeError("Distance is too far back");
+                    }
+
+                    if (length > static_cast<size_t>(m_outEnd - m_out))
+                    {
+                        return MakeError("Deflate output overflow");
+                    }
+
+                    // source and destination can overlap (distance < length): copy byte by byte
+                    const std::byte* from = m_out - distance;
+                    for (size_t i = 0; i < length; ++i)
+                    {
+                        *m_out++ = *from++;
+                    }
+
+                    if (m_reader.isOverrun())
+                    {
+                        return MakeError("Unexpected end of deflate stream");
+                    }
+                }
+            }
+
+            BitReader m_reader;
+            std::byte* const m_outBegin;
+            std::byte* m_out;
+            std::byte* const m_outEnd;
+        };
+
+        constexpr std::array<uint32_t, 256> Crc32Table = []
+        {
+            std::array<uint32_t, 256> table{};
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t value = i;
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+                }
+                table[i] = value;
+            }
+
+            return table;
+        }();
+
+    }  // namespace
+
+    Result<size_t> inflateRaw(std::span<const std::byte> input, std::span<std::byte> output)
+    {
+        return Inflater{input, output}.run();
+    }
+
+    uint32_t computeCrc32(std::span<const std::byte> data, uint32_t crc)
+    {
+        crc = ~crc;
+        for (const std::byte b : data)
+        {
+            crc = Crc32Table[(crc ^ static_cast<uint32_t>(b)) & 0xFF] ^ (crc >> 8);
+        }
+
+        return ~crc;
+    }
+
+}  // namespace my::io
@@ -0,0 +1,23 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "my/utils/result.h"
+
+namespace my::io
+{
+    /**
+        Decodes raw deflate stream (RFC 1951, without zlib/gzip wrapping) into the output of the known size.
+        Returns the actual decoded size.
+     */
+    Result<size_t> inflateRaw(std::span<const std::byte> input, std::span<std::byte> output);
+
+    /**
+        Computes CRC-32 (ISO 3309, the one used by zip) of the data. The previous value can be passed to continue computation.
+     */
+    uint32_t computeCrc32(std::span<const std::byte> data, uint32_t crc = 0);
+
+}  // namespace my::io
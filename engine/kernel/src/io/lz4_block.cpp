@@ -0,0 +1,206 @@
+// #my_engine_source_file
+
+#include "io/lz4_block.h"
+
+namespace my::io
+{
+    namespace
+    {
+        constexpr size_t MinMatch = 4;
+        constexpr size_t LastLiterals = 5;       // the last bytes of the block are always literals
+        constexpr size_t MatchSearchLimit = 12;  // the last match must start at least this number of bytes before the end
+        constexpr size_t MaxOffset = 65535;
+        constexpr unsigned HashBits = 12;
+
+        uint32_t read32(const uint8_t* ptr)
+        {
+            uint32_t value;
+            memcpy(&value, ptr, sizeof(value));
+            return value;
+        }
+
+        uint32_t hashSequence(uint32_t sequence)
+        {
+            return (sequence * 2654435761u) >> (32 - HashBits);
+        }
+
+        uint8_t* writeLength(uint8_t* out, size_t length)
+        {
+            for (; length >= 255; length -= 255)
+            {
+                *out++ = 255;
+            }
+
+            *out++ = static_cast<uint8_t>(length);
+            return out;
+        }
+
+        uint8_t* writeSequence(uint8_t* out, const uint8_t* literals, size_t literalsLength, size_t offset, size_t matchLength)
+        {
+            uint8_t* const token = out++;
+            *token = static_cast<uint8_t>(std::min<size_t>(literalsLength, 15) << 4);
+            if (literalsLength >= 15)
+            {
+                out = writeLength(out, literalsLength - 15);
+            }
+
+            memcpy(out, literals, literalsLength);
+            out += literalsLength;
+
+            if (matchLength == 0)
+            {  // last sequence: literals only
+                return out;
+            }
+
+            *out++ = static_cast<uint8_t>(offset & 0xFF);
+            *out++ = static_cast<uint8_t>(offset >> 8);
+
+            const size_t matchCode = matchLength - MinMatch;
+            *token |= static_cast<uint8_t>(std::min<size_t>(matchCode, 15));
+            if (matchCode >= 15)
+            {
+                out = writeLength(out, matchCode - 15);
+            }
+
+            return out;
+        }
+    }  // namespace
+
+    size_t compressLz4Block(std::span<const std::byte> input, std::span<std::byte> output)
+    {
+        MY_DEBUG_ASSERT(output.size() >= getLz4BlockMaxCompressedSize(input.size()));
+
+        const auto* const begin = reinterpret_cast<const uint8_t*>(input.data());
+        const auto* const end = begin + input.size();
+        auto* const outBegin = reinterpret_cast<uint8_t*>(output.data());
+        uint8_t* out = outBegin;
+
+        const uint8_t* anchor = begin;
+
+        if (input.size() > MatchSearchLimit)
+        {
+            std::array<uint32_t, 1 << HashBits> hashTable{};
+            const uint8_t* const matchEndLimit = end - LastLiterals;
+            const uint8_t* const matchStartLimit = end - MatchSearchLimit;
+
+            for (const uint8_t* ptr = begin; ptr < matchStartLimit;)
+            {
+                const uint32_t sequence = read32(ptr);
+                uint32_t& hashEntry = hashTable[hashSequence(sequence)];
+                const uint8_t* const candidate = begin + hashEntry;
+                hashEntry = static_cast<uint32_t>(ptr - begin);
+
+                if (candidate >= ptr || static_cast<size_t>(ptr - candidate) > MaxOffset || read32(candidate) != sequence)
+                {
+                    ++ptr;
+                    continue;
+                }
+
+                size_t matchLength = MinMatch;
+                while (ptr + matchLength < matchEndLimit && ptr[matchLength] == candidate[matchLength])
+                {
+                    ++matchLength;
+                }
+
+                out = writeSequence(out, anchor, static_cast<size_t>(ptr - anchor), static_cast<size_t>(ptr - candidate), matchLength);
+                ptr += matchLength;
+                anchor = ptr;
+            }
+        }
+
+        out = writeSequence(out, anchor, static_cast<size_t>(end - anchor), 0, 0);
+        return static_cast<size_t>(out - outBegin);
+    }
+
+    Result<size_t> decompressLz4Block(std::span<const std::byte> input, std::span<std::byte> output)
+    {
+        const auto* in = reinterpret_cast<const uint8_t*>(input.data());
+        const auto* const inEnd = in + input.size();
+        auto* const outBegin = reinterpret_cast<uint8_t*>(output.data());
+        auto* const outEnd = outBegin + output.size();
+        uint8_t* out = outBegin;
+
+        const auto readLength = [&in, inEnd](size_t& length) -> bool
+        {
+            uint8_t value = 255;
+            while (value == 255)
+            {
+                if (in == inEnd)
+                {
+                    return false;
+                }
+
+                value = *in++;
+                length += value;
+            }
+
+            return true;
+        };
+
+        while (in < inEnd)
+        {
+            const uint8_t token = *in++;
+
+            size_t literalsLength = token >> 4;
+            if (literalsLength == 15 && !readLength(literalsLength))
+            {
+                return MakeError("Invalid LZ4 literals length");
+            }
+
+            if (literalsLength > static_cast<size_t>(inEnd - in) || literalsLength > static_cast<size_t>(outEnd - out))
+            {
+                return MakeError("LZ4 literals are out of bounds");
+            }
+
+            memcpy(out, in, literalsLength);
+            in += literalsLength;
+            out += literalsLength;
+
+            if (in == inEnd)
+            {  // last sequence
+                break;
+            }
+
+            if (inEnd - in < 2)
+            {
+                return MakeError("Invalid LZ4 match offset");
+            }
+
+            const size_t offset = static_cast<size_t>(in[0]) | (static_cast<size_t>(in[1]) << 8);
+            in += 2;
+            if (offset == 0 || offset > static_cast<size_t>(out - outBegin))
+            {
+                return MakeError("Invalid LZ4 match offset");
+            }
+
+            size_t matchLength = token & 0xF;
+            if (matchLength == 15 && !readLength(matchLength))
+            {
+                return MakeError("Invalid LZ4 match length");
+            }
+            matchLength += MinMatch;
+
+            if (matchLength > static_cast<size_t>(outEnd - out))
+            {
+                return MakeError("LZ4 match is out of bounds");
+            }
+
+            const uint8_t* match = out - offset;
+            if (offset >= matchLength)
+            {
+                memcpy(out, match, matchLength);
+                out += matchLength;
+            }
+            else
+            {  // overlapped copy (repeated pattern)
+                for (size_t i = 0; i < matchLength; ++i)
+                {
+                    *out++ = *match++;
+                }
+            }
+        }
+
+        return static_cast<size_t>(out - outBegin);
+    }
+
+}  // namespace my::io
@@ -0,0 +1,31 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "my/utils/result.h"
+
+namespace my::io
+{
+    /**
+        Worst case size of the LZ4 compressed block (incompressible input).
+     */
+    constexpr size_t getLz4BlockMaxCompressedSize(size_t inputSize)
+    {
+        return inputSize + inputSize / 255 + 16;
+    }
+
+    /**
+        Compresses data into the single LZ4 block (raw block format, without frame).
+        Output must be at least getLz4BlockMaxCompressedSize(input.size()) bytes. Returns the compressed size.
+     */
+    size_t compressLz4Block(std::span<const std::byte> input, std::span<std::byte> output);
+
+    /**
+        Decompresses the single LZ4 block. Returns the decompressed size (that must fit into the output).
+     */
+    Result<size_t> decompressLz4Block(std::span<const std::byte> input, std::span<std::byte> output);
+
+}  // namespace my::io
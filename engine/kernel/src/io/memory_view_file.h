@@ -0,0 +1,185 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include "my/io/file_system.h"
+#include "my/io/memory_stream.h"
+#include "my/memory/buffer.h"
+#include "my/rtti/rtti_impl.h"
+
+namespace my::io
+{
+    /**
+        Read only stream over the memory owned by the other object (archive mapping, decompressed content), keeps the memory alive.
+     */
+    class MemoryViewStream final : public MemoryStream
+    {
+        MY_REFCOUNTED_CLASS(my::io::MemoryViewStream, MemoryStream)
+
+    public:
+        MemoryViewStream(Ptr<> memoryOwner, ReadOnlyBuffer content, std::span<const std::byte> data) :
+            m_memoryOwner(std::move(memoryOwner)),
+            m_content(std::move(content)),
+            m_data(data)
+        {
+        }
+
+        size_t getPosition() const override
+        {
+            return m_pos;
+        }
+
+        size_t setPosition(OffsetOrigin origin, int64_t offset) override
+        {
+            int64_t newPos = offset;  // OffsetOrigin::Begin
+            if (origin == OffsetOrigin::Current)
+            {
+                newPos = static_cast<int64_t>(m_pos) + offset;
+            }
+            else if (origin == OffsetOrigin::End)
+            {
+                newPos = static_cast<int64_t>(m_data.size()) + offset;
+            }
+
+            m_pos = static_cast<size_t>(std::clamp<int64_t>(newPos, 0, static_cast<int64_t>(m_data.size())));
+            return m_pos;
+        }
+
+        Result<size_t> read(std::byte* buffer, size_t count) override
+        {
+            MY_FATAL(m_pos <= m_data.size());
+
+            const size_t actualReadCount = std::min(m_data.size() - m_pos, count);
+            if (actualReadCount > 0)
+            {
+                memcpy(buffer, m_data.data() + m_pos, actualReadCount);
+                m_pos += actualReadCount;
+            }
+
+            return actualReadCount;
+        }
+
+        Result<size_t> write(const std::byte*, size_t) override
+        {
+            return MakeError("Memory view stream is read only");
+        }
+
+        void flush() override
+        {
+        }
+
+        bool canSeek() const override
+        {
+            return true;
+        }
+
+        bool canRead() const override
+        {
+            return true;
+        }
+
+        bool canWrite() const override
+        {
+            return false;
+        }
+
+        std::span<const std::byte> getBufferAsSpan(size_t offset, std::optional<size_t> size) const override
+        {
+            MY_DEBUG_ASSERT(offset <= m_data.size(), "Invalid offset");
+            MY_DEBUG_ASSERT(!size || (offset + *size <= m_data.size()));
+
+            const size_t actualOffset = std::min(offset, m_data.size());
+            const size_t actualSize = std::min(size.value_or(m_data.size() - actualOffset), m_data.size() - actualOffset);
+
+            return m_data.subspan(actualOffset, actualSize);
+        }
+
+    private:
+        const Ptr<> m_memoryOwner;
+        const ReadOnlyBuffer m_content;
+        const std::span<const std::byte> m_data;
+        size_t m_pos = 0;
+    };
+
+    /**
+        Read only file that is a view into the memory owned by the other object (archive mapping, decompressed content).
+        Supports memory mapping without copy.
+     */
+    class MemoryViewFile final : public IFile,
+                                public IMemoryMappableObject,
+                                public io_detail::IFileInternal
+    {
+        MY_REFCOUNTED_CLASS(my::io::MemoryViewFile, IFile, IMemoryMappableObject, io_detail::IFileInternal)
+
+    public:
+        MemoryViewFile(FsPath path, Ptr<> memoryOwner, ReadOnlyBuffer content, std::span<const std::byte> data) :
+            m_path(std::move(path)),
+            m_memoryOwner(std::move(memoryOwner)),
+            m_content(std::move(content)),
+            m_data(data)
+        {
+        }
+
+        bool supports(FileFeature feature) const override
+        {
+            return feature == FileFeature::MemoryMapping;
+        }
+
+        bool isOpened() const override
+        {
+            return true;
+        }
+
+        StreamBasePtr createStream(std::optional<AccessModeFlag> accessMode) override
+        {
+            if (accessMode && accessMode->has(AccessMode::Write))
+            {
+                MY_DEBUG_FAILURE("Memory view file is read only");
+                return nullptr;
+            }
+
+            return rtti::createInstance<MemoryViewStream>(m_memoryOwner, m_content, m_data);
+        }
+
+        AccessModeFlag getAccessMode() const override
+        {
+            return AccessMode::Read;
+        }
+
+        size_t getSize() const override
+        {
+            return m_data.size();
+        }
+
+        FsPath getPath() const override
+        {
+            return m_path;
+        }
+
+        void* memMap(size_t offset, size_t count) override
+        {
+            MY_DEBUG_ASSERT(offset + count <= m_data.size());
+            if (offset + count > m_data.size())
+            {
+                return nullptr;
+            }
+
+            return const_cast<std::byte*>(m_data.data() + offset);
+        }
+
+        void memUnmap(const void*) override
+        {
+        }
+
+        void setVfsPath(FsPath path) override
+        {
+            m_path = std::move(path);
+        }
+
+    private:
+        FsPath m_path;
+        const Ptr<> m_memoryOwner;
+        const ReadOnlyBuffer m_content;
+        const std::span<const std::byte> m_data;
+    };
+}  // namespace my::io
@@ -0,0 +1,346 @@
+// #my_engine_source_file
+
+#include <map>
+
+#include "my/async/task.h"
+#include "my/diag/logging.h"
+#include "my/io/file_watcher.h"
+#include "my/rtti/rtti_impl.h"
+#include "my/runtime/internal/runtime_object_registry.h"
+#include "my/utils/scope_guard.h"
+#include "network/disposable_runtime_object.h"
+#include "runtime/kernel_runtime_impl.h"
+#include "runtime/uv_handle.h"
+#include "runtime/uv_utils.h"
+
+namespace fs = std::filesystem;
+
+namespace my::io
+{
+    namespace
+    {
+#if defined(_WIN32) || defined(__APPLE__)
+        constexpr bool HasRecursiveFsEvents = true;
+#else
+        // inotify does not watch the sub directories: each directory requires its own fs event handle.
+        constexpr bool HasRecursiveFsEvents = false;
+#endif
+
+        std::string toUtf8String(const fs::path& path)
+        {
+            const std::u8string str = path.u8string();
+            return {reinterpret_cast<const char*>(str.data()), str.size()};
+        }
+
+        std::string joinRelativePath(std::string_view directory, std::string_view name)
+        {
+            std::string result;
+            result.reserve(directory.size() + name.size() + 1);
+            result.append(directory);
+            if (!result.empty() && !name.empty())
+            {
+                result.push_back('/');
+            }
+
+            for (const char c : name)
+            {
+                result.push_back(c == '\\' ? '/' : c);
+            }
+
+            return result;
+        }
+
+        /**
+            Watches the native file or directory with the libuv fs events on the kernel runtime thread.
+            Raw events are accumulated per path and reported by the debounce timer, so the bursts of the writes (or editor save sequences)
+            are reported as a single change.
+         */
+        class NativeFileWatcher final : public IFileWatcher,
+                                        public DisposableRuntimeObject
+        {
+            MY_REFCOUNTED_CLASS(my::io::NativeFileWatcher, IFileWatcher)
+
+        public:
+            NativeFileWatcher(fs::path&& nativePath, FsPath&& basePath, FileChangeCallback&& callback, FileWatcherSettings settings) :
+                m_nativePath(std::move(nativePath)),
+                m_basePath(std::move(basePath)),
+                m_callback(std::move(callback)),
+                m_settings(settings),
+                m_runtimeReg{*this}
+            {
+            }
+
+            ~NativeFileWatcher()
+            {
+                closeWatcher(true);
+            }
+
+            void dispose() override
+            {
+                closeWatcher(false);
+            }
+
+            FsPath getPath() const override
+            {
+                return m_basePath;
+            }
+
+            Result<> start();
+
+        private:
+            struct WatchedDirectory
+            {
+                NativeFileWatcher* const watcher;
+                const std::string relativePath;
+                UvHandle<uv_fs_event_t> handle;
+            };
+
+            /**
+                Raw libuv events of the single path: rename means "appeared or disappeared", the actual kind is checked when the change is reported.
+             */
+            struct PendingChange
+            {
+                bool renamed = false;
+            };
+
+            Result<> watchDirectory(const std::string& relativePath);
+
+            void watchSubDirectories(const std::string& relativePath);
+
+            void unwatchDirectory(std::string_view relativePath);
+
+            void onFsEvent(const WatchedDirectory& directory, const char* fileName, int events);
+
+            void flushPendingChanges();
+
+            void closeWatcher(bool fromDestructor);
+
+            const fs::path m_nativePath;
+            const FsPath m_basePath;
+            const FileChangeCallback m_callback;
+            const FileWatcherSettings m_settings;
+            bool m_isDirectory = false;
+            std::map<std::string, std::unique_ptr<WatchedDirectory>, std::less<>> m_directories;
+            std::map<std::string, PendingChange> m_pendingChanges;
+            uint64_t m_firstPendingChangeTime = 0;
+            UvHandle<uv_timer_t> m_debounceTimer = nullptr;
+            RuntimeObjectRegistration m_runtimeReg;
+        };
+
+        Result<> NativeFileWatcher::start()
+        {
+            MY_DEBUG_ASSERT(getKernelRuntime().isRuntimeThread());
+
+            std::error_code ec;
+            const fs::file_status status = fs::status(m_nativePath, ec);
+            if (!fs::exists(status))
+            {
+                return MakeError("Path to watch does not exist: ({})", toUtf8String(m_nativePath));
+            }
+
+            m_isDirectory = fs::is_directory(status);
+
+            m_debounceTimer = UvHandle<uv_timer_t>{};
+            UV_VERIFY(uv_timer_init(getKernelRuntimeImpl().uv(), m_debounceTimer));
+            m_debounceTimer.setData(this);
+
+            CheckResult(watchDirectory({}));
+            if (m_isDirectory && m_settings.recursive && !HasRecursiveFsEvents)
+            {
+                watchSubDirectories({});
+            }
+
+            return kResultSuccess;
+        }
+
+        Result<> NativeFileWatcher::watchDirectory(const std::string& relativePath)
+        {
+            auto directory = std::make_unique<WatchedDirectory>(this, relativePath);
+            UV_VERIFY(uv_fs_event_init(getKernelRuntimeImpl().uv(), directory->handle));
+            directory->handle.setData(directory.get());
+
+            const std::string path = toUtf8String(relativePath.empty() ? m_nativePath : m_nativePath / relativePath);
+            const unsigned flags = m_isDirectory && m_settings.recursive && HasRecursiveFsEvents ? UV_FS_EVENT_RECURSIVE : 0;
+
+            const int startResult = uv_fs_event_start(directory->handle, [](uv_fs_event_t* handle, const char* fileName, int events, int status) noexcept
+            {
+                const auto* const directory = reinterpret_cast<const WatchedDirectory*>(uv_handle_get_data(reinterpret_cast<uv_handle_t*>(handle)));
+                if (!directory)
+                {
+                    return;
+                }
+
+                if (status < 0)
+                {
+                    mylog_warn("File watching failure ({}):({})", directory->relativePath, getUVErrorMessage(status));
+                    return;
+                }
+
+                directory->watcher->onFsEvent(*directory, fileName, events);
+            }, path.c_str(), flags);
+
+            if (startResult != 0)
+            {
+                return MakeError("fs_event_start failure ({}):({})", path, getUVErrorMessage(startResult));
+            }
+
+            m_directories.insert_or_assign(relativePath, std::move(directory));
+            return kResultSuccess;
+        }
+
+        void NativeFileWatcher::watchSubDirectories(const std::string& relativePath)
+        {
+            std::error_code ec;
+            const fs::path nativePath = relativePath.empty() ? m_nativePath : m_nativePath / relativePath;
+            for (fs::recursive_directory_iterator iter{nativePath, fs::directory_options::skip_permission_denied, ec}, end; !ec && iter != end; iter.increment(ec))
+            {
+                if (!iter->is_directory(ec))
+                {
+                    continue;
+                }
+
+                const std::string subDirectory = toUtf8String(fs::relative(iter->path(), m_nativePath, ec).generic_u8string());
+                if (Result<> watchResult = watchDirectory(subDirectory); !watchResult)
+                {
+                    mylog_warn("Sub directory is not watched: ({})", watchResult.getError()->getMessage());
+                }
+            }
+        }
+
+        void NativeFileWatcher::unwatchDirectory(std::string_view relativePath)
+        {
+            for (auto iter = m_directories.lower_bound(relativePath); iter != m_directories.end();)
+            {
+                const std::string_view path = iter->first;
+                const bool isSubPath = path.starts_with(relativePath) && (path.size() == relativePath.size() || path[relativePath.size()] == '/');
+                if (!isSubPath)
+                {
+                    break;
+                }
+
+                iter = m_directories.erase(iter);
+            }
+        }
+
+        void NativeFileWatcher::onFsEvent(const WatchedDirectory& directory, const char* fileName, int events)
+        {
+            if (isDisposed())
+            {
+                return;
+            }
+
+            // The watched file itself is reported by its name.
+            std::string path = m_isDirectory && fileName ? joinRelativePath(directory.relativePath, fileName) : directory.relativePath;
+
+            const uint64_t now = uv_now(getKernelRuntimeImpl().uv());
+            if (m_pendingChanges.empty())
+            {
+                m_firstPendingChangeTime = now;
+            }
+
+            PendingChange& change = m_pendingChanges[std::move(path)];
+            change.renamed = change.renamed || (events & UV_RENAME) != 0;
+
+            // Debounce: each event postpones the report, but the report is not delayed longer than maxDelay.
+            const uint64_t debounceTimeout = static_cast<uint64_t>(m_settings.debounceTimeout.count());
+            const uint64_t maxDelay = std::max(static_cast<uint64_t>(m_settings.maxDelay.count()), debounceTimeout);
+            const uint64_t elapsed = now - m_firstPendingChangeTime;
+            const uint64_t timeout = elapsed < maxDelay ? std::min(debounceTimeout, maxDelay - elapsed) : 0;
+
+            UV_VERIFY(uv_timer_start(m_debounceTimer, [](uv_timer_t* timer) noexcept
+            {
+                if (auto* const self = reinterpret_cast<NativeFileWatcher*>(uv_handle_get_data(reinterpret_cast<uv_handle_t*>(timer))))
+                {
+                    self->flushPendingChanges();
+                }
+            }, timeout, 0));
+        }
+
+        void NativeFileWatcher::flushPendingChanges()
+        {
+            if (isDisposed() || m_pendingChanges.empty())
+            {
+                return;
+            }
+
+            std::vector<FileChangeEvent> events;
+            events.reserve(m_pendingChanges.size());
+
+            for (auto& [relativePath, change] : std::exchange(m_pendingChanges, {}))
+            {
+                std::error_code ec;
+                const fs::file_status status = fs::status(relativePath.empty() ? m_nativePath : m_nativePath / relativePath, ec);
+                const bool exists = fs::exists(status);
+
+                const FileChangeKind kind = !exists ? FileChangeKind::Removed : (change.renamed ? FileChangeKind::Added : FileChangeKind::Modified);
+
+                if (m_isDirectory && m_settings.recursive && !HasRecursiveFsEvents && !relativePath.empty())
+                {
+                    if (kind == FileChangeKind::Removed)
+                    {
+                        unwatchDirectory(relativePath);
+                    }
+                    else if (kind == FileChangeKind::Added && fs::is_directory(status) && !m_directories.contains(relativePath))
+                    {
+                        if (watchDirectory(relativePath))
+                        {
+                            watchSubDirectories(relativePath);
+                        }
+                    }
+                }
+
+                events.push_back({relativePath.empty() ? m_basePath : m_basePath / relativePath, kind});
+            }
+
+            // The subscriber is allowed to release the watcher within the callback.
+            addRef();
+            scope_on_leave
+            {
+                releaseRef();
+            };
+
+            m_callback(events);
+        }
+
+        void NativeFileWatcher::closeWatcher(bool fromDestructor)
+        {
+            doDispose(fromDestructor, *this, [](IRefCounted& refCountedSelf) noexcept
+            {
+                NativeFileWatcher& self = refCountedSelf.as<NativeFileWatcher&>();
+                self.m_directories.clear();
+                self.m_pendingChanges.clear();
+                self.m_debounceTimer.reset();
+            });
+        }
+    }  // namespace
+
+    Result<FileWatcherPtr> createNativeFileWatcher(fs::path nativePath, FsPath basePath, FileChangeCallback callback, FileWatcherSettings settings)
+    {
+        MY_DEBUG_ASSERT(callback);
+        if (nativePath.empty() || !callback)
+        {
+            return MakeError("Invalid file watcher arguments");
+        }
+
+        Ptr<NativeFileWatcher> watcher = rtti::createInstance<NativeFileWatcher>(std::move(nativePath), std::move(basePath), std::move(callback), settings);
+
+        if (getKernelRuntime().isRuntimeThread())
+        {
+            CheckResult(watcher->start());
+        }
+        else
+        {
+            Result<> startResult;
+            async::Task<> task = [](NativeFileWatcher& watcher, Result<>& startResult) -> async::Task<>
+            {
+                co_await getKernelRuntime().getRuntimeExecutor();
+                startResult = watcher.start();
+            }(*watcher, startResult);
+
+            async::wait(task);
+            CheckResult(startResult);
+        }
+
+        return watcher;
+    }
+}  // namespace my::io
@@ -102,4 +102,52 @@ namespace my::io
 
         return totalRead;
     }
+
+    Result<Buffer> readStreamToEnd(IStream& src)
+    {
+        MY_DEBUG_ASSERT(src.canRead());
+
+        Buffer buffer;
+
+        if(src.canSeek())
+        {
+            const size_t position = src.getPosition();
+            const size_t endPosition = src.setPosition(OffsetOrigin::End, 0);
+            src.setPosition(OffsetOrigin::Begin, static_cast<int64_t>(position));
+
+            if(endPosition > position)
+            {
+                buffer.resize(endPosition - position);
+
+                auto readResult = copyFromStream(buffer.data(), buffer.size(), src);
+                CheckResult(readResult);
+                buffer.resize(*readResult);
+
+                return buffer;
+            }
+        }
+
+        size_t blockSize = 4096;
+        size_t totalRead = 0;
+
+        do
+        {
+            std::byte* const ptr = buffer.append(blockSize);
+            auto readResult = src.read(ptr, blockSize);
+            CheckResult(readResult);
+
+            totalRead += *readResult;
+            buffer.resize(totalRead);
+
+            if(*readResult == 0)
+            {
+                break;
+            }
+
+            blockSize = std::min<size_t>(blockSize * 2, 1024 * 1024);
+
+        } while(true);
+
+        return buffer;
+    }
 }  // namespace my::io
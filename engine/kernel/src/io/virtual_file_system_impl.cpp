@@ -2,170 +2,233 @@
 
 #include "virtual_file_system_impl.h"
 
-#include "my/threading/lock_guard.h"
-
 namespace fs = std::filesystem;
 
 namespace my::io
 {
     namespace
     {
+        /**
+            Iterator reads the entries by batches, the single entry iteration (incrementDirIterator) is a batch of one entry.
+         */
         struct MY_ABSTRACT_TYPE DirIteratorImplBase
         {
-            using FsNode = VirtualFileSystemImpl::FsNode;
-
             virtual ~DirIteratorImplBase() = default;
 
-            virtual bool isEnd() = 0;
-
-            virtual bool increment() = 0;
-
-            virtual FsEntry getCurrent() = 0;
+            virtual size_t read(std::span<FsEntry> entries) = 0;
         };
 
         class InnerDirIteratorImpl final : public DirIteratorImplBase
         {
         public:
-            InnerDirIteratorImpl(FsPath basePath, FsNode& dir) :
+            InnerDirIteratorImpl(FsPath basePath, std::vector<std::string_view> childNames) :
                 m_basePath(std::move(basePath)),
-                m_dir(dir)
+                m_childNames(std::move(childNames))
             {
                 MY_DEBUG_ASSERT(m_basePath.isAbsolute());
-                m_current = m_dir.getNextChild();
-            }
-
-            bool isEnd() override
-            {
-                return m_current == nullptr;
-            }
-
-            bool increment() override
-            {
-                if(m_current)
-                {
-                    m_current = m_dir.getNextChild(m_current);
-                }
-
-                return m_current != nullptr;
             }
 
-            FsEntry getCurrent() override
+            size_t read(std::span<FsEntry> entries) override
             {
-                if(!m_current)
+                size_t count = 0;
+                for(; count < entries.size() && m_index < m_childNames.size(); ++count, ++m_index)
                 {
-                    return {};
+                    entries[count] = FsEntry{
+                        .path = m_basePath / m_childNames[m_index],
+                        .kind = FsEntryKind::Directory,
+                        .size = 0,
+                        .lastWriteTime = 0};
                 }
 
-                return FsEntry{
-                    .path = m_basePath / m_current->getName(),
-                    .kind = FsEntryKind::Directory,
-                    .size = 0,
-                    .lastWriteTime = 0};
+                return count;
             }
 
         private:
             const FsPath m_basePath;
-            FsNode& m_dir;
-            const FsNode* m_current = nullptr;
+            const std::vector<std::string_view> m_childNames;  // interned names: stay valid while the vfs exists
+            size_t m_index = 0;
         };
 
+        /**
+            Enumerates the directory of all the file systems mounted at the same point.
+            Mount points with the directory cache are read from the content snapshot, others are read by batches directly.
+         */
         class MultiFsDirIteratorImpl final : public DirIteratorImplBase
         {
         public:
-            MultiFsDirIteratorImpl(FsPath basePath, FsPath relativePath, FsNode& dir) :
+            MultiFsDirIteratorImpl(FsPath basePath, FsPath relativePath, VirtualFileSystemImpl::MountedFsList mountedFs) :
                 m_basePath(std::move(basePath)),
                 m_relativePath(std::move(relativePath)),
-                m_dir(dir)
+                m_mountedFs(std::move(mountedFs))
             {
                 MY_DEBUG_ASSERT(m_basePath.isAbsolute());
 
-                m_iter = getNextFsIterator();
+                openNextSource();
             }
 
             ~MultiFsDirIteratorImpl()
             {
-                auto& [fs, fsIter, fsEntry] = m_iter;
-                if(fs && fsIter)
-                {
-                    fs->closeDirIterator(fsIter);
-                }
+                closeCurrentSource();
             }
 
-            bool isEnd() override
+            size_t read(std::span<FsEntry> entries) override
             {
-                return std::get<2>(m_iter).isEmpty();
-            }
+                size_t count = 0;
 
-            bool increment() override
-            {
-                auto fs = std::get<0>(m_iter);
-                auto fsIter = std::get<1>(m_iter);
-
-                if(!(fs && fsIter))
+                while(count < entries.size())
                 {
-                    return false;
+                    if(m_snapshot)
+                    {
+                        const size_t snapshotCount = std::min(entries.size() - count, m_snapshot->size() - m_snapshotIndex);
+                        for(size_t i = 0; i < snapshotCount; ++i)
+                        {
+                            const FsEntry& snapshotEntry = (*m_snapshot)[m_snapshotIndex + i];
+                            entries[count + i] = FsEntry{
+                                .path = m_basePath / snapshotEntry.path,
+                                .kind = snapshotEntry.kind,
+                                .size = snapshotEntry.size,
+                                .lastWriteTime = snapshotEntry.lastWriteTime};
+                        }
+
+                        count += snapshotCount;
+                        m_snapshotIndex += snapshotCount;
+                        if(m_snapshotIndex == m_snapshot->size())
+                        {
+                            closeCurrentSource();
+                            openNextSource();
+                        }
+                    }
+                    else if(m_fsIter)
+                    {
+                        size_t readCount = 0;
+                        if(m_pendingEntry)
+                        {
+                            entries[count] = std::move(m_pendingEntry);
+                            m_pendingEntry = {};
+                            readCount = 1;
+                        }
+                        else
+                        {
+                            readCount = m_fs->readDirEntries(m_fsIter, entries.subspan(count));
+                        }
+
+                        for(size_t i = count; i < count + readCount; ++i)
+                        {
+                            entries[i].path = m_basePath / entries[i].path;
+                        }
+
+                        count += readCount;
+                        if(readCount == 0)
+                        {
+                            closeCurrentSource();
+                            openNextSource();
+                        }
+                    }
+                    else
+                    {
+                        break;
+                    }
                 }
 
-                FsEntry& fsEntry = std::get<2>(m_iter);
+                return count;
+            }
 
-                if(fsEntry = fs->incrementDirIterator(fsIter); fsEntry)
+        private:
+            void openNextSource()
+            {
+                while(m_nextFsIndex < m_mountedFs->size())
                 {
-                    fsEntry.path = m_basePath / fsEntry.path;
-                    return true;
+                    const auto& mountedFs = (*m_mountedFs)[m_nextFsIndex++];
+
+                    if(mountedFs.directoryCache)
+                    {
+                        m_snapshot = mountedFs.directoryCache->getContent(*mountedFs.fs, m_relativePath);
+                        m_snapshotIndex = 0;
+                        if(m_snapshot && !m_snapshot->empty())
+                        {
+                            return;
+                        }
+
+                        m_snapshot.reset();
+                        continue;
+                    }
+
+                    // not existing directory is reported by the empty iterator: no need to check with exists() first
+                    auto openResult = mountedFs.fs->openDirIterator(m_relativePath);
+                    if(!openResult)
+                    {
+                        continue;
+                    }
+
+                    auto& [fsIter, fsEntry] = *openResult;
+                    if(!fsIter)
+                    {
+                        continue;
+                    }
+
+                    m_fs = mountedFs.fs;
+                    m_fsIter = fsIter;
+                    m_pendingEntry = std::move(fsEntry);
+                    return;
                 }
-
-                fs->closeDirIterator(std::exchange(fsIter, nullptr));
-
-                m_iter = getNextFsIterator();
-
-                return !std::get<2>(m_iter).isEmpty();
             }
 
-            FsEntry getCurrent() override
+            void closeCurrentSource()
             {
-                return std::move(std::get<2>(m_iter));
+                if(m_fs && m_fsIter)
+                {
+                    m_fs->closeDirIterator(m_fsIter);
+                }
+
+                m_fs.reset();
+                m_fsIter = nullptr;
+                m_pendingEntry = {};
+                m_snapshot.reset();
             }
 
-        private:
-            using Iterator = std::tuple<FileSystemPtr, void*, FsEntry>;
+            const FsPath m_basePath;
+            const FsPath m_relativePath;
+            const VirtualFileSystemImpl::MountedFsList m_mountedFs;
+            size_t m_nextFsIndex = 0;
 
-            FileSystemPtr getNextFsContainingPath() const
-            {
-                auto fileSystem = std::get<0>(m_iter);
+            FileSystemPtr m_fs;
+            void* m_fsIter = nullptr;
+            FsEntry m_pendingEntry;  // first entry returned by openDirIterator
 
-                do
-                {
-                    fileSystem = m_dir.getNextMountedFs(fileSystem.get());
-                } while(fileSystem && !fileSystem->exists(m_relativePath, FsEntryKind::Directory));
+            DirectoryContentCache::Content m_snapshot;
+            size_t m_snapshotIndex = 0;
+        };
 
-                return fileSystem;
-            }
+        /**
+            Keeps the watchers of all the file systems mounted at (or below) the watched vfs path.
+         */
+        class VirtualFileWatcher final : public IFileWatcher
+        {
+            MY_REFCOUNTED_CLASS(my::io::VirtualFileWatcher, IFileWatcher)
 
-            Iterator getNextFsIterator() const
+        public:
+            VirtualFileWatcher(FsPath path, std::vector<FileWatcherPtr> watchers) :
+                m_path(std::move(path)),
+                m_watchers(std::move(watchers))
             {
-                auto fs = getNextFsContainingPath();
-                if(!fs)
-                {
-                    return {};
-                }
+            }
 
-                auto [fsIter, fsEntry] = *fs->openDirIterator(m_relativePath);
-                if(!fsIter || !fsEntry)
+            void dispose() override
+            {
+                for(const FileWatcherPtr& watcher : m_watchers)
                 {
-                    return Iterator{nullptr, nullptr, FsEntry{}};
+                    watcher->dispose();
                 }
+            }
 
-                MY_DEBUG_ASSERT(fsIter);
-
-                fsEntry.path = m_basePath / fsEntry.path;
-
-                return {std::move(fs), fsIter, std::move(fsEntry)};
+            FsPath getPath() const override
+            {
+                return m_path;
             }
 
-            const FsPath m_basePath;
-            const FsPath m_relativePath;
-            FsNode& m_dir;
-            Iterator m_iter;
+        private:
+            const FsPath m_path;
+            const std::vector<FileWatcherPtr> m_watchers;
         };
     }  // namespace
 
@@ -174,92 +237,65 @@ namespace my::io
         return m_name;
     }
 
-    Result<VirtualFileSystemImpl::FsNode*> VirtualFileSystemImpl::FsNode::getChild(std::string_view name)
+    VirtualFileSystemImpl::FsNode* VirtualFileSystemImpl::FsNode::findChild(std::string_view name) const
     {
-        const std::lock_guard lock(m_mutex);
+        auto iter = m_children.find(name);
+        return iter != m_children.end() ? iter->second.get() : nullptr;
+    }
 
-        auto iter = findChildIter(name);
-        if(iter != m_children.end())
+    Result<VirtualFileSystemImpl::FsNode*> VirtualFileSystemImpl::FsNode::getChild(std::string_view internedName)
+    {
+        if(FsNode* const child = findChild(internedName))
         {
-            return &(*iter);
+            return child;
         }
 
-        MY_DEBUG_ASSERT(m_mountedFs.empty());
-        if(!m_mountedFs.empty())
+        MY_DEBUG_ASSERT(!hasMounts());
+        if(hasMounts())
         {
             return MakeError("Already has mounted fs");
         }
 
-        m_children.emplace_back(std::string{name});
-
-        return &m_children.back();
-    }
-
-    VirtualFileSystemImpl::FsNode* VirtualFileSystemImpl::FsNode::findChild(std::string_view name)
-    {
-        const std::lock_guard lock(m_mutex);
-
-        auto iter = findChildIter(name);
-
-        return iter != m_children.end() ? &(*iter) : nullptr;
+        auto iter = m_children.emplace(internedName, std::make_unique<FsNode>(internedName)).first;
+        return iter->second.get();
     }
 
-    VirtualFileSystemImpl::FsNode* VirtualFileSystemImpl::FsNode::getNextChild(const FsNode* current)
+    std::vector<std::string_view> VirtualFileSystemImpl::FsNode::getChildNames() const
     {
-        const std::lock_guard lock(m_mutex);
-        if(current == nullptr)
+        std::vector<std::string_view> names;
+        names.reserve(m_children.size());
+        for(const auto& [name, child] : m_children)
         {
-            return !m_children.empty() ? &m_children.front() : nullptr;
+            names.push_back(name);
         }
 
-        auto nextChild = m_children.end();
-
-        for(auto iter = m_children.begin(); iter != m_children.end(); ++iter)
-        {
-            if(&(*iter) == current)
-            {
-                nextChild = ++iter;
-                break;
-            }
-        }
-
-        return nextChild != m_children.end() ? &(*nextChild) : nullptr;
+        std::sort(names.begin(), names.end());
+        return names;
     }
 
-    FileSystemPtr VirtualFileSystemImpl::FsNode::getNextMountedFs(FileSystem* current)
+    const VirtualFileSystemImpl::MountedFsList& VirtualFileSystemImpl::FsNode::getMountedFs() const
     {
-        const std::lock_guard lock(m_mutex);
-
-        if(current == nullptr)
-        {
-            return !m_mountedFs.empty() ? m_mountedFs.front().fs : nullptr;
-        }
-
-        auto nextFs = m_mountedFs.end();
-        for(auto iter = m_mountedFs.begin(); iter != m_mountedFs.end(); ++iter)
-        {
-            if(iter->fs.get() == current)
-            {
-                nextFs = ++iter;
-                break;
-            }
-        }
+        return m_mountedFs;
+    }
 
-        return nextFs != m_mountedFs.end() ? nextFs->fs : nullptr;
+    bool VirtualFileSystemImpl::FsNode::hasMounts() const
+    {
+        return m_mountedFs && !m_mountedFs->empty();
     }
 
-    Result<> VirtualFileSystemImpl::FsNode::mount(FileSystemPtr&& fileSystem, unsigned priority)
+    Result<> VirtualFileSystemImpl::FsNode::mount(FileSystemPtr&& fileSystem, const VfsMountSettings& settings)
     {
-        const std::lock_guard lock(m_mutex);
         MY_DEBUG_ASSERT(m_children.empty());
         if(!m_children.empty())
         {
             return MakeError("Already child directories");
         }
 
+        auto mountedFs = m_mountedFs ? std::make_shared<std::vector<FileSystemEntry>>(*m_mountedFs) : std::make_shared<std::vector<FileSystemEntry>>();
+
         if(!fileSystem->isReadOnly())
         {
-            const bool hasMutableFs = std::any_of(m_mountedFs.begin(), m_mountedFs.end(), [](const FileSystemEntry& entry)
+            const bool hasMutableFs = std::any_of(mountedFs->begin(), mountedFs->end(), [](const FileSystemEntry& entry)
             {
                 return !entry.fs->isReadOnly();
             });
@@ -271,23 +307,77 @@ namespace my::io
             }
         }
 
-        m_mountedFs.emplace_back(std::move(fileSystem), priority);
+        // Higher priority file systems are queried first, the same priority keeps the mount order.
+        const auto position = std::upper_bound(mountedFs->begin(), mountedFs->end(), settings.priority, [](unsigned value, const FileSystemEntry& entry)
+        {
+            return value > entry.priority;
+        });
+
+        auto directoryCache = settings.cacheDirectoryContent ? std::make_shared<DirectoryContentCache>() : nullptr;
+        mountedFs->emplace(position, std::move(fileSystem), settings.priority, std::move(directoryCache));
+        m_mountedFs = std::move(mountedFs);
+
         return {};
     }
-    void VirtualFileSystemImpl::FsNode::unmount(const FileSystemPtr&)
+
+    bool VirtualFileSystemImpl::FsNode::unmount(const FileSystemPtr& fileSystem)
     {
+        bool unmounted = false;
+
+        if(hasMounts())
+        {
+            const auto iter = std::find_if(m_mountedFs->begin(), m_mountedFs->end(), [&fileSystem](const FileSystemEntry& entry)
+            {
+                return entry.fs == fileSystem;
+            });
+
+            if(iter != m_mountedFs->end())
+            {
+                auto mountedFs = std::make_shared<std::vector<FileSystemEntry>>(*m_mountedFs);
+                mountedFs->erase(mountedFs->begin() + (iter - m_mountedFs->begin()));
+                m_mountedFs = std::move(mountedFs);
+                unmounted = true;
+            }
+        }
+
+        for(auto& [name, child] : m_children)
+        {
+            unmounted = child->unmount(fileSystem) || unmounted;
+        }
+
+        return unmounted;
     }
 
-    std::vector<VirtualFileSystemImpl::FileSystemEntry> VirtualFileSystemImpl::FsNode::getMountedFs()
+    void VirtualFileSystemImpl::FsNode::invalidateDirectoryCache(const FsPath& relativePath) const
     {
-        const std::lock_guard lock(m_mutex);
-        return m_mountedFs;
+        if(!hasMounts())
+        {
+            return;
+        }
+
+        for(const FileSystemEntry& entry : *m_mountedFs)
+        {
+            if(entry.directoryCache)
+            {
+                entry.directoryCache->invalidate(relativePath);
+            }
+        }
     }
 
-    bool VirtualFileSystemImpl::FsNode::hasMounts()
+    void VirtualFileSystemImpl::FsNode::collectMountPoints(const FsPath& nodePath, std::vector<WatchedMountPoint>& mountPoints) const
     {
-        const std::lock_guard lock(m_mutex);
-        return !m_mountedFs.empty();
+        if(hasMounts())
+        {
+            for(const FileSystemEntry& entry : *m_mountedFs)
+            {
+                mountPoints.push_back({nodePath, FsPath{}, entry});
+            }
+        }
+
+        for(const auto& [name, child] : m_children)
+        {
+            child->collectMountPoints(nodePath / name, mountPoints);
+        }
     }
 
     VirtualFileSystemImpl::VirtualFileSystemImpl() :
@@ -302,24 +392,26 @@ namespace my::io
 
     bool VirtualFileSystemImpl::exists(const FsPath& path, std::optional<FsEntryKind> kind)
     {
-        auto [basePath, fsNode] = findFsNodeForPath(path);
+        const std::optional<ResolvedPath> resolvedPath = resolvePath(path);
+        if(!resolvedPath)
+        {
+            return false;
+        }
 
         // first check only vurtual path (can be only directory)
-        if(basePath == path)
+        if(resolvedPath->isVirtualDirectory())
         {
             return !kind || (*kind == FsEntryKind::Directory);
         }
 
-        if(!fsNode || !fsNode->hasMounts())
+        if(!resolvedPath->mountedFs)
         {
             return false;
         }
 
-        auto mountedFs = fsNode->getMountedFs();
-
-        return std::any_of(mountedFs.begin(), mountedFs.end(), [relativePath = path.getRelativePath(basePath), kind](const FileSystemEntry& fsEntry)
+        return std::any_of(resolvedPath->mountedFs->begin(), resolvedPath->mountedFs->end(), [&resolvedPath, kind](const FileSystemEntry& fsEntry)
         {
-            return fsEntry.fs->exists(relativePath, kind);
+            return fsEntry.fs->exists(resolvedPath->relativePath, kind);
         });
     }
 
@@ -332,28 +424,31 @@ namespace my::io
     {
         MY_DEBUG_ASSERT((openMode == OpenFileMode::OpenExisting || accessMode && AccessMode::Write), "Specified openMode requires write access also");
 
-        auto [basePath, fsNode] = findFsNodeForPath(path);
-
-        if(!fsNode)
+        const std::optional<ResolvedPath> resolvedPath = resolvePath(path);
+        if(!resolvedPath || !resolvedPath->mountedFs)
         {
             return nullptr;
         }
 
-        auto relativePath = path.getRelativePath(basePath);
-
         const bool requireMutableAccess =
             accessMode && AccessMode::Write ||
             openMode != OpenFileMode::OpenExisting;
 
-        for(const auto& mountedFs : fsNode->getMountedFs())
+        for(const auto& mountedFs : *resolvedPath->mountedFs)
         {
             if(requireMutableAccess && mountedFs.fs->isReadOnly())
             {
                 continue;
             }
 
-            if(auto file = mountedFs.fs->openFile(relativePath, accessMode, openMode))
+            if(auto file = mountedFs.fs->openFile(resolvedPath->relativePath, accessMode, openMode))
             {
+                if(requireMutableAccess && mountedFs.directoryCache)
+                {
+                    // the file can be created or its size is changed
+                    mountedFs.directoryCache->invalidate(resolvedPath->relativePath);
+                }
+
                 auto* const fileInternal = file->as<io_detail::IFileInternal*>();
                 MY_DEBUG_ASSERT(fileInternal, "io_detail::IFileInternal must be implemented");
                 if(fileInternal)
@@ -370,26 +465,33 @@ namespace my::io
 
     FileSystem::OpenDirResult VirtualFileSystemImpl::openDirIterator(const FsPath& path)
     {
-        auto [basePath, fsNode] = findFsNodeForPath(path);
-        if(!fsNode)
+        const std::optional<ResolvedPath> resolvedPath = resolvePath(path);
+        if(!resolvedPath)
         {
             return MakeError("Directory does not exists");
         }
 
         DirIteratorImplBase* dirIteratorImpl = nullptr;
 
-        if(!fsNode->hasMounts())
+        if(!resolvedPath->mountedFs)
         {
-            MY_DEBUG_ASSERT(basePath == path);
-            dirIteratorImpl = new InnerDirIteratorImpl(std::move(basePath), *fsNode);
+            MY_DEBUG_ASSERT(resolvedPath->isVirtualDirectory());
+
+            std::vector<std::string_view> childNames;
+            {
+                const std::shared_lock lock(m_treeMutex);
+                childNames = resolvedPath->node->getChildNames();
+            }
+
+            dirIteratorImpl = new InnerDirIteratorImpl(resolvedPath->basePath, std::move(childNames));
         }
         else
         {
-            auto relativePath = path.getRelativePath(basePath);
-            dirIteratorImpl = new MultiFsDirIteratorImpl(std::move(basePath), std::move(relativePath), *fsNode);
+            dirIteratorImpl = new MultiFsDirIteratorImpl(resolvedPath->basePath, resolvedPath->relativePath, resolvedPath->mountedFs);
         }
 
-        if(dirIteratorImpl->isEnd())
+        FsEntry firstEntry;
+        if(dirIteratorImpl->read({&firstEntry, 1}) == 0)
         {
             delete dirIteratorImpl;
             return {};
@@ -397,7 +499,7 @@ namespace my::io
 
         std::tuple result = {
             reinterpret_cast<void*>(dirIteratorImpl),
-            dirIteratorImpl->getCurrent()};
+            std::move(firstEntry)};
 
         return std::move(result);
     }
@@ -421,13 +523,20 @@ namespace my::io
             return {};
         }
 
-        auto* const iterImpl = reinterpret_cast<DirIteratorImplBase*>(state);
-        if(iterImpl->increment())
+        FsEntry entry;
+        reinterpret_cast<DirIteratorImplBase*>(state)->read({&entry, 1});
+        return entry;
+    }
+
+    size_t VirtualFileSystemImpl::readDirEntries(void* state, std::span<FsEntry> entries)
+    {
+        MY_DEBUG_ASSERT(state);
+        if(!state)
         {
-            return iterImpl->getCurrent();
+            return 0;
         }
 
-        return {};
+        return reinterpret_cast<DirIteratorImplBase*>(state)->read(entries);
     }
 
     Result<> VirtualFileSystemImpl::createDirectory(const FsPath&)
@@ -442,52 +551,202 @@ namespace my::io
         return MakeError("Method not implemented");
     }
 
-    Result<> VirtualFileSystemImpl::mount(const FsPath& path, FileSystemPtr fileSystem, unsigned priority)
+    Result<> VirtualFileSystemImpl::mount(const FsPath& path, FileSystemPtr fileSystem, VfsMountSettings settings)
     {
+        const std::lock_guard lock(m_treeMutex);
+
         FsNode* fsNode = &m_root;
 
         for(auto name : path.splitElements())
         {
-            auto res = fsNode->getChild(name);
+            auto res = fsNode->getChild(internPathSegment(name));
             CheckResult(res);
             fsNode = *res;
             MY_DEBUG_ASSERT(fsNode);
         }
 
-        return fsNode->mount(std::move(fileSystem), priority);
+        // new virtual directories can be created even if the mount itself fails
+        invalidateResolvedPaths();
+
+        return fsNode->mount(std::move(fileSystem), settings);
+    }
+
+    void VirtualFileSystemImpl::unmount(FileSystemPtr fileSystem)
+    {
+        const std::lock_guard lock(m_treeMutex);
+
+        if(m_root.unmount(fileSystem))
+        {
+            invalidateResolvedPaths();
+        }
     }
 
-    void VirtualFileSystemImpl::unmount(FileSystemPtr)
+    void VirtualFileSystemImpl::invalidateDirectoryCache(const FsPath& path)
     {
+        if(const std::optional<ResolvedPath> resolvedPath = resolvePath(path); resolvedPath && resolvedPath->mountedFs)
+        {
+            resolvedPath->node->invalidateDirectoryCache(resolvedPath->relativePath);
+        }
+    }
+
+    Result<FileWatcherPtr> VirtualFileSystemImpl::watch(const FsPath& path, FileChangeCallback callback, FileWatcherSettings settings)
+    {
+        const std::optional<ResolvedPath> resolvedPath = resolvePath(path);
+        if(!resolvedPath)
+        {
+            return MakeError("Path is not mounted ({})", path.getString());
+        }
+
+        std::vector<WatchedMountPoint> mountPoints;
+        if(resolvedPath->mountedFs)
+        {
+            for(const FileSystemEntry& entry : *resolvedPath->mountedFs)
+            {
+                mountPoints.push_back({resolvedPath->basePath, resolvedPath->relativePath, entry});
+            }
+        }
+        else if(settings.recursive)
+        {
+            const std::shared_lock lock(m_treeMutex);
+            resolvedPath->node->collectMountPoints(resolvedPath->basePath, mountPoints);
+        }
+
+        // The callback is shared by the watchers of all the mount points (all of them report from the runtime thread).
+        auto sharedCallback = std::make_shared<FileChangeCallback>(std::move(callback));
+
+        std::vector<FileWatcherPtr> watchers;
+        for(WatchedMountPoint& mountPoint : mountPoints)
+        {
+            auto onChanges = [sharedCallback, basePath = mountPoint.basePath, directoryCache = mountPoint.entry.directoryCache](std::span<const FileChangeEvent> changes)
+            {
+                std::vector<FileChangeEvent> vfsChanges;
+                vfsChanges.reserve(changes.size());
+
+                for(const FileChangeEvent& change : changes)
+                {
+                    if(directoryCache)
+                    {
+                        directoryCache->invalidate(change.path);
+                    }
+
+                    vfsChanges.push_back({basePath / change.path, change.kind});
+                }
+
+                (*sharedCallback)(vfsChanges);
+            };
+
+            // Read-only archives can not be watched: their content is not changed.
+            if(Result<FileWatcherPtr> watchResult = mountPoint.entry.fs->watch(mountPoint.fsPath, std::move(onChanges), settings); watchResult)
+            {
+                watchers.push_back(std::move(*watchResult));
+            }
+        }
+
+        if(watchers.empty())
+        {
+            return MakeError("There is no watchable file system mounted at ({})", path.getString());
+        }
+
+        return rtti::createInstance<VirtualFileWatcher, IFileWatcher>(path, std::move(watchers));
     }
 
     fs::path VirtualFileSystemImpl::resolveToNativePath(const FsPath& path)
     {
-        auto [basePath, fsNode] = findFsNodeForPath(path);
-        if(!fsNode || !fsNode->hasMounts())
+        const std::optional<ResolvedPath> resolvedPath = resolvePath(path);
+        if(!resolvedPath || !resolvedPath->mountedFs)
         {
             return {};
         }
 
-        auto fs = fsNode->getNextMountedFs();
-        if(INativeFileSystem* const nativeFs = (fs ? fs->as<INativeFileSystem*>() : nullptr); nativeFs)
+        const FileSystemPtr& fs = resolvedPath->mountedFs->front().fs;
+        if(INativeFileSystem* const nativeFs = fs->as<INativeFileSystem*>(); nativeFs)
         {
-            return nativeFs->resolveToNativePath(path.getRelativePath(basePath));
+            return nativeFs->resolveToNativePath(resolvedPath->relativePath);
         }
 
         return {};
     }
 
-    std::tuple<FsPath, VirtualFileSystemImpl::FsNode*> VirtualFileSystemImpl::findFsNodeForPath(const FsPath& path)
+    std::optional<VirtualFileSystemImpl::ResolvedPath> VirtualFileSystemImpl::resolvePath(const FsPath& path)
     {
-        FsNode* fsNode = &m_root;
+        const std::string_view pathString{path.getCStr()};
+        // The directory path keeps its trailing separator, so "/name" resolves the directory "/" and "name" resolves the directory "".
+        const size_t nameIndex = pathString.rfind('/') + 1;  // npos + 1 == 0
+        const std::string_view directoryPath = pathString.substr(0, nameIndex);
+        const std::string_view name = pathString.substr(nameIndex);
+
+        // The tree lock is held while the directory is resolved and cached: mount/unmount can not invalidate the cache in the middle.
+        const std::shared_lock treeLock(m_treeMutex);
+
+        auto [fsNode, basePath, isNode] = resolveDirectory(directoryPath);
+
+        bool isVirtualDirectory = isNode && name.empty();
+        if(isNode && !name.empty())
+        {
+            if(FsNode* const child = fsNode->findChild(name))
+            {
+                fsNode = child;
+                basePath /= name;
+                isVirtualDirectory = true;
+            }
+        }
+
+        if(!isVirtualDirectory && !fsNode->hasMounts())
+        {
+            return std::nullopt;
+        }
+
+        FsPath relativePath = isVirtualDirectory ? FsPath{} : path.getRelativePath(basePath);
+
+        return ResolvedPath{
+            .basePath = std::move(basePath),
+            .relativePath = std::move(relativePath),
+            .node = fsNode,
+            .mountedFs = fsNode->hasMounts() ? fsNode->getMountedFs() : nullptr};
+    }
+
+    VirtualFileSystemImpl::ResolvedDirectory VirtualFileSystemImpl::resolveDirectory(std::string_view directoryPath)
+    {
+        bool isCacheFull = false;
+        {
+            const std::shared_lock lock(m_resolvedDirectoriesMutex);
+            if(auto iter = m_resolvedDirectories.find(directoryPath); iter != m_resolvedDirectories.end())
+            {
+                return iter->second;
+            }
+
+            isCacheFull = m_resolvedDirectories.size() >= MaxResolvedDirectoryCacheSize;
+        }
+
+        ResolvedDirectory directory = findFsNodeForDirectory(directoryPath);
+
+        // The cache is not evicted when it is full: the rest of the directories are resolved by the tree walk.
+        if(!isCacheFull)
+        {
+            const std::lock_guard lock(m_resolvedDirectoriesMutex);
+            if(m_resolvedDirectories.size() < MaxResolvedDirectoryCacheSize)
+            {
+                m_resolvedDirectories.try_emplace(std::string{directoryPath}, directory);
+            }
+        }
+
+        return directory;
+    }
+
+    VirtualFileSystemImpl::ResolvedDirectory VirtualFileSystemImpl::findFsNodeForDirectory(std::string_view directoryPath) const
+    {
+        const FsNode* fsNode = &m_root;
         FsPath basePath{"/"};
+        bool isNode = true;
 
-        for(auto name : path.splitElements())
+        // Walks the same segments as FsPath::splitElements for the full path (except the last one): every segment here ends with the separator.
+        for(size_t start = 0, separatorIndex = directoryPath.find('/'); separatorIndex != std::string_view::npos; start = separatorIndex + 1, separatorIndex = directoryPath.find('/', start))
         {
+            const std::string_view name = directoryPath.substr(start, separatorIndex - start);
             auto* const next = fsNode->findChild(name);
             if(!next)
             {
+                isNode = false;
                 break;
             }
 
@@ -495,17 +754,26 @@ namespace my::io
             basePath /= name;
         }
 
-        if(!fsNode)
-        {
-            return {};
-        }
+        return ResolvedDirectory{
+            .node = const_cast<FsNode*>(fsNode),
+            .basePath = std::move(basePath),
+            .isNode = isNode};
+    }
 
-        if(basePath != path && !fsNode->hasMounts())
+    std::string_view VirtualFileSystemImpl::internPathSegment(std::string_view segment)
+    {
+        if(auto iter = m_pathSegments.find(segment); iter != m_pathSegments.end())
         {
-            return {};
+            return *iter;
         }
 
-        return std::tuple{std::move(basePath), fsNode};
+        return *m_pathSegments.emplace(segment).first;
+    }
+
+    void VirtualFileSystemImpl::invalidateResolvedPaths()
+    {
+        const std::lock_guard lock(m_resolvedDirectoriesMutex);
+        m_resolvedDirectories.clear();
     }
 
     VirtualFileSystemPtr createVirtualFileSystem()
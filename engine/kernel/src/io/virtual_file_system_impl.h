@@ -1,8 +1,12 @@
 // #my_engine_source_file
 
+#include <optional>
+#include <shared_mutex>
+#include <unordered_set>
+
+#include "io/directory_content_cache.h"
 #include "my/io/virtual_file_system.h"
 #include "my/rtti/rtti_impl.h"
-#include "my/threading/spin_lock.h"
 
 
 namespace my::io
@@ -10,56 +14,87 @@ namespace my::io
     class VirtualFileSystemImpl final : public IVirtualFileSystem
     {
         MY_REFCOUNTED_CLASS(my::io::VirtualFileSystemImpl, IVirtualFileSystem)
-        
+
     private:
         struct FileSystemEntry
         {
             FileSystemPtr fs;
             unsigned priority;
+            std::shared_ptr<DirectoryContentCache> directoryCache;  // nullptr if the directory content is not cached
+        };
+
+        /**
+            File system mounted at (or below) the watched vfs path.
+         */
+        struct WatchedMountPoint
+        {
+            FsPath basePath;  // vfs path of the mount point
+            FsPath fsPath;    // path to watch within the file system
+            FileSystemEntry entry;
         };
 
     public:
+        /**
+            Mounted file systems are replaced (never modified) on mount/unmount,
+            so the readers keep the snapshot without holding the lock.
+         */
+        using MountedFsList = std::shared_ptr<const std::vector<FileSystemEntry>>;
+
+        /**
+            Node of the mount tree. The tree is guarded by VirtualFileSystemImpl::m_treeMutex:
+            nodes are modified only by mount/unmount (exclusive lock) and are never deleted, so the pointers to nodes stay valid.
+         */
         class FsNode
         {
         public:
-            FsNode(std::string name): m_name(std::move(name))
+            FsNode(std::string_view name): m_name(name)
             {}
 
             FsNode(const FsNode&) = delete;
 
             std::string_view getName() const;
 
-            Result<FsNode*> getChild(std::string_view name);
+            FsNode* findChild(std::string_view name) const;
+
+            Result<FsNode*> getChild(std::string_view internedName);
 
-            FsNode* findChild(std::string_view name);
+            std::vector<std::string_view> getChildNames() const;
 
-            FsNode* getNextChild(const FsNode* current = nullptr);
+            const MountedFsList& getMountedFs() const;
 
-            FileSystemPtr getNextMountedFs(FileSystem* current = nullptr);
+            bool hasMounts() const;
 
-            Result<> mount(FileSystemPtr&&, unsigned priority);
+            Result<> mount(FileSystemPtr&&, const VfsMountSettings& settings);
 
-            void unmount(const FileSystemPtr&);
+            bool unmount(const FileSystemPtr&);
 
-            std::vector<FileSystemEntry> getMountedFs();
+            void invalidateDirectoryCache(const FsPath& relativePath) const;
 
-            bool hasMounts();
+            /**
+                Collects the file systems mounted at this node and at all its descendants.
+             */
+            void collectMountPoints(const FsPath& nodePath, std::vector<WatchedMountPoint>& mountPoints) const;
 
         private:
-            
-            decltype(auto) findChildIter(std::string_view name)
-            {
-                return std::find_if(m_children.begin(), m_children.end(), [name](const FsNode& c)
-                    {
-                        return c.m_name == name;
-                    });
-            }
+            const std::string_view m_name;  // interned by VirtualFileSystemImpl::internPathSegment
+            std::unordered_map<std::string_view, std::unique_ptr<FsNode>> m_children;
+            MountedFsList m_mountedFs;
+        };
 
+        /**
+            Result of the path resolution: the mount tree node and the path within its mounted file systems.
+         */
+        struct ResolvedPath
+        {
+            FsPath basePath;      // path of the node
+            FsPath relativePath;  // path within the mounted file systems
+            FsNode* node;
+            MountedFsList mountedFs;
 
-            const std::string m_name;
-            std::list<FsNode> m_children;
-            std::vector<FileSystemEntry> m_mountedFs;
-            threading::SpinLock m_mutex;
+            bool isVirtualDirectory() const
+            {
+                return relativePath.isEmpty();
+            }
         };
 
         VirtualFileSystemImpl();
@@ -78,19 +113,65 @@ namespace my::io
 
         FsEntry incrementDirIterator(void*) override;
 
+        size_t readDirEntries(void*, std::span<FsEntry> entries) override;
+
         Result<> createDirectory(const FsPath&) override;
 
         Result<> remove(const FsPath&, bool recursive = false) override;
 
-        Result<> mount(const FsPath&, FileSystemPtr, unsigned priority) override;
+        using IVirtualFileSystem::mount;
+
+        Result<> mount(const FsPath&, FileSystemPtr, VfsMountSettings settings) override;
 
         void unmount(FileSystemPtr) override;
 
+        void invalidateDirectoryCache(const FsPath& path) override;
+
+        Result<FileWatcherPtr> watch(const FsPath& path, FileChangeCallback callback, FileWatcherSettings settings) override;
+
         std::filesystem::path resolveToNativePath(const FsPath& path) override;
 
     private:
+        /**
+            Mount tree lookup result for a directory path: the deepest mount tree node on that path.
+         */
+        struct ResolvedDirectory
+        {
+            FsNode* node;
+            FsPath basePath;  // path of the node
+            bool isNode;      // every segment of the directory path is a mount tree node: the directory is the node itself
+        };
+
+        /**
+            Keyed by the parent directory (not by the full file path), so the cache size is bounded by the count of the distinct directories.
+            There are no negative entries: any directory resolves at least to the root node.
+         */
+        using ResolvedDirectoryCache = std::unordered_map<std::string, ResolvedDirectory, strings::StringHash, std::equal_to<>>;
+
+        static constexpr size_t MaxResolvedDirectoryCacheSize = 4096;
+
+        /**
+            Resolves the path through the resolved directory cache.
+            Returns std::nullopt if the path does not belong to any mount point (or virtual directory).
+         */
+        std::optional<ResolvedPath> resolvePath(const FsPath& path);
+
+        /**
+            Must be called with the shared lock of m_treeMutex held.
+         */
+        ResolvedDirectory resolveDirectory(std::string_view directoryPath);
+
+        ResolvedDirectory findFsNodeForDirectory(std::string_view directoryPath) const;
+
+        std::string_view internPathSegment(std::string_view segment);
+
+        void invalidateResolvedPaths();
 
-        std::tuple<FsPath, FsNode*> findFsNodeForPath(const FsPath& path);
         FsNode m_root;
+        std::unordered_set<std::string, strings::StringHash, std::equal_to<>> m_pathSegments;
+        std::shared_mutex m_treeMutex;
+
+        ResolvedDirectoryCache m_resolvedDirectories;
+        std::shared_mutex m_resolvedDirectoriesMutex;
     };
 }  // namespace my::io
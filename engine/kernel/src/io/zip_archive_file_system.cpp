@@ -1,448 +1,691 @@
 // #my_engine_source_file
 
-#include "my/io/file_system.h"
-#include "my/rtti/rtti_impl.h"
-#include "my/utils/scope_guard.h"
+#include "my/io/zip_archive_file_system.h"
+
+#include <condition_variable>
+#include <unordered_set>
 
-#if 0
+#include "io/decompressed_content_cache.h"
+#include "io/inflate.h"
+#include "io/memory_view_file.h"
+#include "my/diag/logging.h"
+#include "my/io/memory_stream.h"
+#include "my/rtti/rtti_impl.h"
 
 namespace my::io
 {
-    class ZipArchiveFileSystem final : public FileSystem
+    namespace
     {
-        MY_CLASS_(my::io::ZipArchiveFileSystem, FileSystem)
+        static_assert(std::endian::native == std::endian::little, "Zip headers are read as little endian values");
 
-    public:
-        ZipArchiveFileSystem(IStreamReader::Ptr);
-        ~ZipArchiveFileSystem();
+        constexpr uint32_t LocalHeaderSignature = 0x04034B50;
+        constexpr uint32_t CentralHeaderSignature = 0x02014B50;
+        constexpr uint32_t EndOfCentralDirSignature = 0x06054B50;
+        constexpr uint32_t Zip64EndOfCentralDirSignature = 0x06064B50;
+        constexpr uint32_t Zip64EndOfCentralDirLocatorSignature = 0x07064B50;
 
-        bool isReadOnly() const override;
-        bool exists(const FsPath&, std::optional<FsEntryKind>) override;
-        size_t getLastWriteTime(const FsPath&) override;
-        IFile::Ptr openFile(const FsPath&, AccessModeFlag accessMode, OpenFileMode openMode) override;
+        constexpr size_t LocalHeaderSize = 30;
+        constexpr size_t CentralHeaderSize = 46;
+        constexpr size_t EndOfCentralDirSize = 22;
+        constexpr size_t Zip64EndOfCentralDirSize = 56;
+        constexpr size_t Zip64EndOfCentralDirLocatorSize = 20;
+        constexpr size_t MaxArchiveCommentSize = 0xFFFF;
 
-        OpenDirResult openDirIterator(const FsPath& path) override;
-        void closeDirIterator(void*) override;
-        FsEntry incrementDirIterator(void*) override;
+        constexpr uint16_t Zip64ExtraFieldId = 0x0001;
+        constexpr uint16_t EncryptedEntryFlag = 0x0001;
 
-    private:
-        struct ZipFsEntry : io::FsEntry
+        constexpr uint16_t StoredMethod = 0;
+        constexpr uint16_t DeflatedMethod = 8;
+
+        template <typename T>
+        T readValue(const std::byte* ptr)
         {
-            ::unz64_file_pos zipPos;
-            std::vector<std::byte> buffer;
-        };
+            T value;
+            memcpy(&value, ptr, sizeof(T));
+            return value;
+        }
 
-        struct DirIteratorState
+        size_t dosDateTimeToUnixTime(uint16_t dosDate, uint16_t dosTime)
         {
-            const std::vector<const ZipFsEntry*> entries;
-            const FsPath path;
-            size_t currentIndex = 0;
+            using namespace std::chrono;
 
+            const year_month_day date{year{1980 + (dosDate >> 9)}, month{static_cast<unsigned>((dosDate >> 5) & 0xF)}, day{static_cast<unsigned>(dosDate & 0x1F)}};
+            if (!date.ok())
+            {
+                return 0;
+            }
 
-            DirIteratorState(std::vector<const ZipFsEntry*>&& inEntries, FsPath inPath) :
-                entries(std::move(inEntries)),
-                path(std::move(inPath))
-            {}
+            const auto timePoint = sys_days{date} + hours{dosTime >> 11} + minutes{(dosTime >> 5) & 0x3F} + seconds{(dosTime & 0x1F) * 2};
+            return static_cast<size_t>(duration_cast<seconds>(timePoint.time_since_epoch()).count());
+        }
 
-            FsEntry getCurrentFsEntry() const
+        std::string_view getNormalizedPath(std::string_view path)
+        {
+            while (!path.empty() && path.front() == '/')
             {
-                if (entries.size() <= currentIndex)
-                {
-                    return {};
-                }
+                path.remove_prefix(1);
+            }
 
-                const ZipFsEntry& zipEntry = *entries[currentIndex];
+            while (!path.empty() && path.back() == '/')
+            {
+                path.remove_suffix(1);
+            }
 
-                //FsEntry entry = zipEntry;
-                //entry.path = path / zipEntry.path;
+            return path;
+        }
+    }  // namespace
+
+    /**
+        Zip archive is kept entirely in memory (the memory streams are used in place).
+        The central directory is parsed once into a flat index sorted by path: stored entries are opened as views into the archive memory,
+        deflated entries are inflated on demand (or in parallel with prefetch) and kept in the cache.
+     */
+    class ZipArchiveFileSystem final : public IZipArchiveFileSystem
+    {
+        MY_REFCOUNTED_CLASS(my::io::ZipArchiveFileSystem, IZipArchiveFileSystem)
 
-                return zipEntry;
-            }
-        };
+    public:
+        ZipArchiveFileSystem(Ptr<> archiveOwner, ReadOnlyBuffer archiveBuffer, std::span<const std::byte> archiveData, ZipArchiveFileSystemSettings settings) :
+            m_archiveOwner(std::move(archiveOwner)),
+            m_archiveBuffer(std::move(archiveBuffer)),
+            m_archiveData(archiveData),
+            m_inflateExecutor(std::move(settings.inflateExecutor)),
+            m_cache(settings.maxCacheSize, settings.lifetimeOfCache)
+        {
+        }
 
+        Result<> loadIndex(std::string_view basePath);
 
-        static void* zipOpen(void* opaque, const void*, int mode) noexcept
+        bool isReadOnly() const override
         {
-            MY_DEBUG_ASSERT(opaque);
-            auto& self = *reinterpret_cast<ZipArchiveFileSystem*>(opaque);
+            return true;
+        }
+
+        bool exists(const FsPath& path, std::optional<FsEntryKind> kind) override;
+
+        size_t getLastWriteTime(const FsPath& path) override;
+
+        FilePtr openFile(const FsPath& path, AccessModeFlag accessMode, OpenFileMode openMode) override;
+
+        OpenDirResult openDirIterator(const FsPath& path) override;
+
+        void closeDirIterator(void*) override;
+
+        FsEntry incrementDirIterator(void*) override;
+
+        async::Task<> prefetch(std::vector<FsPath> paths) override;
 
-            MY_DEBUG_ASSERT(self.m_stream);
-            return self.m_stream.get();
+        size_t getEntriesCount() const override
+        {
+            return m_entries.size() + m_directories.size() - 1;
         }
 
-        static int zipClose([[maybe_unused]] void* opaque, [[maybe_unused]] void* StreamBasePtr) noexcept
+    private:
+        struct ZipEntry
         {
-            MY_DEBUG_ASSERT(opaque);
-            MY_DEBUG_ASSERT(StreamBasePtr);
+            std::string path;
+            uint64_t localHeaderOffset;
+            uint64_t compressedSize;
+            uint64_t size;
+            uint32_t crc32;
+            uint16_t method;
+            uint16_t flags;
+            size_t lastWriteTime;
+        };
 
-            return 0;
-        }
+        struct DirIteratorState
+        {
+            FsPath basePath;
+            std::string prefix;  // "dir/" or empty for the root
+            size_t index;
+        };
 
-        static uint32_t zipRead(void*, void* StreamBasePtr, void* buf, uint32_t count) noexcept
+        /**
+            Inflate that is currently in progress: concurrent requests of the same entry are waiting for the single result.
+         */
+        struct PendingInflate
         {
-            auto* const stream = reinterpret_cast<IStreamBase*>(StreamBasePtr);
-            MY_DEBUG_ASSERT(stream);
+            std::mutex mutex;
+            std::condition_variable signal;
+            bool isReady = false;
+            Result<ReadOnlyBuffer> result;
+        };
 
-            auto& streamReader = stream->as<IStreamReader&>();
+        std::optional<size_t> findEntry(const FsPath& path) const;
+        Result<std::span<const std::byte>> getEntryData(const ZipEntry& entry) const;
+        Result<ReadOnlyBuffer> getInflatedContent(size_t entryIndex);
+        Result<ReadOnlyBuffer> inflateEntry(const ZipEntry& entry) const;
+        FsEntry nextDirEntry(DirIteratorState& state) const;
 
-            const auto actualRead = streamReader.read(reinterpret_cast<std::byte*>(buf), static_cast<size_t>(count));
-            if(!actualRead)
-            {  // report error ?
-                return 0;
-            }
+        const Ptr<> m_archiveOwner;
+        const ReadOnlyBuffer m_archiveBuffer;
+        const std::span<const std::byte> m_archiveData;
+        const async::ExecutorPtr m_inflateExecutor;
+        DecompressedContentCache m_cache;
 
-            return static_cast<uint32_t>(*actualRead);
-        }
+        std::vector<ZipEntry> m_entries;                           // files only, sorted by path
+        std::unordered_map<std::string_view, size_t> m_fileIndex;  // keys are views into m_entries
+        std::unordered_set<std::string> m_directories;
+
+        std::mutex m_pendingMutex;
+        std::unordered_map<size_t, std::shared_ptr<PendingInflate>> m_pendingInflates;
+    };
 
-        static uint32_t zipWrite(void*, void*, const void*, uint32_t) noexcept
+    Result<> ZipArchiveFileSystem::loadIndex(std::string_view basePath)
+    {
+        const std::byte* const data = m_archiveData.data();
+        const size_t dataSize = m_archiveData.size();
+
+        if (dataSize < EndOfCentralDirSize)
         {
-            MY_DEBUG_ASSERT("Zip write is not supported");
-            return 0;
+            return MakeError("Invalid zip archive: too small");
         }
 
-        static uint64_t zipTell(void*, void* StreamBasePtr) noexcept
+        // The end of central directory record is followed by the variable length comment: search it backward.
+        std::optional<size_t> endOfCentralDirPos;
+        const size_t searchLimit = dataSize - EndOfCentralDirSize - std::min(dataSize - EndOfCentralDirSize, MaxArchiveCommentSize);
+        for (size_t pos = dataSize - EndOfCentralDirSize + 1; pos-- > searchLimit;)
         {
-            auto* const stream = reinterpret_cast<IStreamBase*>(StreamBasePtr);
-            MY_DEBUG_ASSERT(stream);
-
-            return stream->getOffset();
+            if (readValue<uint32_t>(data + pos) == EndOfCentralDirSignature)
+            {
+                endOfCentralDirPos = pos;
+                break;
+            }
         }
 
-        static long zipSeek(void*, void* StreamBasePtr, uint64_t offset, int origin) noexcept
+        if (!endOfCentralDirPos)
         {
-            auto* const stream = reinterpret_cast<IStreamBase*>(StreamBasePtr);
-            MY_DEBUG_ASSERT(stream);
+            return MakeError("Invalid zip archive: end of central directory is not found");
+        }
 
-            const auto seekOrigin = EXPR_Block -> OffsetOrigin
+        const std::byte* const endOfCentralDir = data + *endOfCentralDirPos;
+        uint64_t entriesCount = readValue<uint16_t>(endOfCentralDir + 10);
+        uint64_t centralDirSize = readValue<uint32_t>(endOfCentralDir + 12);
+        uint64_t centralDirOffset = readValue<uint32_t>(endOfCentralDir + 16);
+
+        const bool mayBeZip64 = entriesCount == 0xFFFF || centralDirSize == 0xFFFFFFFF || centralDirOffset == 0xFFFFFFFF;
+        if (mayBeZip64 && *endOfCentralDirPos >= Zip64EndOfCentralDirLocatorSize)
+        {
+            const std::byte* const locator = endOfCentralDir - Zip64EndOfCentralDirLocatorSize;
+            if (readValue<uint32_t>(locator) == Zip64EndOfCentralDirLocatorSignature)
             {
-                if(origin == ZLIB_FILEFUNC_SEEK_END)
-                {
-                    return OffsetOrigin::End;
-                }
-                else if(origin == ZLIB_FILEFUNC_SEEK_CUR)
+                const uint64_t zip64EndOffset = readValue<uint64_t>(locator + 8);
+                if (zip64EndOffset > dataSize - Zip64EndOfCentralDirSize || readValue<uint32_t>(data + zip64EndOffset) != Zip64EndOfCentralDirSignature)
                 {
-                    return OffsetOrigin::Current;
+                    return MakeError("Invalid zip64 end of central directory");
                 }
 
-                MY_DEBUG_ASSERT(origin == ZLIB_FILEFUNC_SEEK_SET);
-                return OffsetOrigin::Begin;
-            };
-
-            [[maybe_unused]]
-            const auto newOffset = stream->setOffset(seekOrigin, offset);
-
-            return 0;
+                const std::byte* const zip64End = data + zip64EndOffset;
+                entriesCount = readValue<uint64_t>(zip64End + 32);
+                centralDirSize = readValue<uint64_t>(zip64End + 40);
+                centralDirOffset = readValue<uint64_t>(zip64End + 48);
+            }
         }
 
-        static int zipError(void*, void*) noexcept
+        if (centralDirOffset > dataSize || centralDirSize > dataSize - centralDirOffset)
         {
-            return 0;
+            return MakeError("Invalid zip archive: central directory is out of bounds");
         }
 
-        static zlib_filefunc64_def_s getZipFileFuncs(void* opaque)
+        std::string basePrefix = makePreferredPathString(basePath);
+        basePrefix = getNormalizedPath(basePrefix);
+        if (!basePrefix.empty())
         {
-            zlib_filefunc64_def_s fileFuncs{};
+            basePrefix.push_back('/');
+        }
 
-            fileFuncs.zopen64_file = zipOpen;
-            fileFuncs.zread_file = zipRead;
-            fileFuncs.zwrite_file = zipWrite;
-            fileFuncs.ztell64_file = zipTell;
-            fileFuncs.zseek64_file = zipSeek;
-            fileFuncs.zclose_file = zipClose;
-            fileFuncs.zerror_file = zipError;
-            fileFuncs.opaque = opaque;
+        m_entries.reserve(static_cast<size_t>(std::min<uint64_t>(entriesCount, centralDirSize / CentralHeaderSize)));
+        m_directories.emplace();
 
-            return fileFuncs;
-        }
+        const std::byte* header = data + centralDirOffset;
+        const std::byte* const centralDirEnd = header + centralDirSize;
 
-        StreamBasePtr m_stream;
-        ::unzFile m_zipArchive = nullptr;
+        for (uint64_t i = 0; i < entriesCount; ++i)
+        {
+            if (static_cast<size_t>(centralDirEnd - header) < CentralHeaderSize || readValue<uint32_t>(header) != CentralHeaderSignature)
+            {
+                return MakeError("Invalid zip central directory entry ({})", i);
+            }
 
-        std::vector<ZipFsEntry> m_index;
-        std::mutex m_mutex;
+            const uint16_t nameSize = readValue<uint16_t>(header + 28);
+            const uint16_t extraSize = readValue<uint16_t>(header + 30);
+            const uint16_t commentSize = readValue<uint16_t>(header + 32);
+            const size_t headerSize = CentralHeaderSize + nameSize + extraSize + commentSize;
+            if (static_cast<size_t>(centralDirEnd - header) < headerSize)
+            {
+                return MakeError("Invalid zip central directory entry ({})", i);
+            }
 
-        friend class ArchiveFile;
-    };
+            ZipEntry entry{
+                .localHeaderOffset = readValue<uint32_t>(header + 42),
+                .compressedSize = readValue<uint32_t>(header + 20),
+                .size = readValue<uint32_t>(header + 24),
+                .crc32 = readValue<uint32_t>(header + 16),
+                .method = readValue<uint16_t>(header + 10),
+                .flags = readValue<uint16_t>(header + 8),
+                .lastWriteTime = dosDateTimeToUnixTime(readValue<uint16_t>(header + 14), readValue<uint16_t>(header + 12))};
+
+            // zip64 extended information: only the fields that are overflowed in the header are present (in the fixed order)
+            const std::byte* extra = header + CentralHeaderSize + nameSize;
+            const std::byte* const extraEnd = extra + extraSize;
+            while (extraEnd - extra >= 4)
+            {
+                const uint16_t fieldId = readValue<uint16_t>(extra);
+                const uint16_t fieldSize = readValue<uint16_t>(extra + 2);
+                const std::byte* field = extra + 4;
+                extra = field + std::min<size_t>(fieldSize, extraEnd - field);
 
-    ZipArchiveFileSystem::ZipArchiveFileSystem(IStreamReader::Ptr stream) :
-        m_stream(std::move(stream))
-    {
-        auto fileFuncs = getZipFileFuncs(this);
-        m_zipArchive = ::unzOpen2_64("internal", &fileFuncs);
-        MY_DEBUG_ASSERT(m_zipArchive);
-        if(!m_zipArchive)
-        {
-            return;
-        }
+                if (fieldId != Zip64ExtraFieldId)
+                {
+                    continue;
+                }
 
-        const auto makeForwardSlashPath = [](char* path, size_t pathLen)
-        {
-            for(size_t i = 0; i < pathLen; ++i)
+                for (uint64_t* const value : {&entry.size, &entry.compressedSize, &entry.localHeaderOffset})
+                {
+                    if (*value == 0xFFFFFFFF && extra - field >= 8)
+                    {
+                        *value = readValue<uint64_t>(field);
+                        field += 8;
+                    }
+                }
+            }
+
+            const std::string fullPath = makePreferredPathString({reinterpret_cast<const char*>(header + CentralHeaderSize), nameSize});
+            const bool isDirectory = fullPath.ends_with('/');
+            header += headerSize;
+
+            std::string_view path = getNormalizedPath(fullPath);
+            if (!basePrefix.empty())
             {
-                if(path[i] == '\\')
+                if (!path.starts_with(basePrefix))
                 {
-                    path[i] = '/';
+                    continue;
                 }
+                path.remove_prefix(basePrefix.size());
             }
-        };
 
-        m_index.reserve(10);
+            if (path.empty())
+            {
+                continue;
+            }
 
-        constexpr size_t NameLenMax = 500;
-        std::array<char, NameLenMax + 1> nameBuffer;
+            for (size_t pos = path.find('/'); pos != std::string_view::npos; pos = path.find('/', pos + 1))
+            {
+                m_directories.emplace(path.substr(0, pos));
+            }
 
-        for(int code = ::unzGoToFirstFile(m_zipArchive); code == UNZ_OK; code = ::unzGoToNextFile(m_zipArchive))
-        {
-            unz_file_info64 zipFileInfo;
-            if(::unzGetCurrentFileInfo64(m_zipArchive, &zipFileInfo, nameBuffer.data(), static_cast<uint16_t>(nameBuffer.size()), nullptr, 0, nullptr, 0) != UNZ_OK)
+            if (isDirectory)
             {
-                break;
+                m_directories.emplace(path);
+                continue;
             }
 
-            const size_t fileNameLen = static_cast<size_t>(zipFileInfo.size_filename);
-            makeForwardSlashPath(nameBuffer.data(), fileNameLen);
+            entry.path = path;
+            m_entries.emplace_back(std::move(entry));
+        }
 
-            ZipFsEntry& arcEntry = m_index.emplace_back();
-            arcEntry.size = static_cast<size_t>(zipFileInfo.uncompressed_size);
-            arcEntry.kind = (arcEntry.size > 0) ? FsEntryKind::File : FsEntryKind::Directory;
-            arcEntry.lastWriteTime = static_cast<size_t>(zipFileInfo.dos_date);
+        // stable: for the duplicate paths the first entry of the archive is the one that is used (see below)
+        std::stable_sort(m_entries.begin(), m_entries.end(), [](const ZipEntry& left, const ZipEntry& right)
+        {
+            return left.path < right.path;
+        });
 
-            std::string_view innerPath = {nameBuffer.data(), fileNameLen};
-            if (innerPath.ends_with('/'))
+        m_fileIndex.reserve(m_entries.size());
+        for (size_t i = 0; i < m_entries.size(); ++i)
+        {
+            if (!m_fileIndex.emplace(m_entries[i].path, i).second)
             {
-                innerPath.remove_suffix(1);
+                mylog_warn("Duplicate zip entry ({}), only the first one is used", m_entries[i].path);
             }
-            
-            arcEntry.path = innerPath;
+        }
 
-            ::unzGetFilePos64(m_zipArchive, &arcEntry.zipPos);
+        return kResultSuccess;
+    }
+
+    std::optional<size_t> ZipArchiveFileSystem::findEntry(const FsPath& path) const
+    {
+        const std::string pathString = path.getString();
+        if (const auto iter = m_fileIndex.find(getNormalizedPath(pathString)); iter != m_fileIndex.end())
+        {
+            return iter->second;
         }
 
-        std::sort(m_index.begin(), m_index.end());
+        return std::nullopt;
     }
 
-    class ArchiveFile final : public io::IFile, public io_detail::IFileInternal
+    Result<std::span<const std::byte>> ZipArchiveFileSystem::getEntryData(const ZipEntry& entry) const
     {
-        MY_CLASS_(my::io::ArchiveFile, io::IFile, io_detail::IFileInternal)
+        const size_t dataSize = m_archiveData.size();
+        if (entry.localHeaderOffset > dataSize || dataSize - entry.localHeaderOffset < LocalHeaderSize)
+        {
+            return MakeError("Invalid zip local header location ({})", entry.path);
+        }
 
-    public:
-        ArchiveFile(my::Ptr<ZipArchiveFileSystem>&& archiveFileSystem, const ZipArchiveFileSystem::ZipFsEntry& fsEntry) :
-            m_archiveFileSystem(std::move(archiveFileSystem)),
-            m_fsEntry(fsEntry)
+        const std::byte* const localHeader = m_archiveData.data() + entry.localHeaderOffset;
+        if (readValue<uint32_t>(localHeader) != LocalHeaderSignature)
         {
+            return MakeError("Invalid zip local header signature ({})", entry.path);
         }
 
-        ~ArchiveFile()
+        // local header's name and extra field sizes can differ from the central directory's ones
+        const uint64_t dataOffset = entry.localHeaderOffset + LocalHeaderSize + readValue<uint16_t>(localHeader + 26) + readValue<uint16_t>(localHeader + 28);
+        if (dataOffset > dataSize || entry.compressedSize > dataSize - dataOffset)
         {
+            return MakeError("Invalid zip entry data location ({})", entry.path);
         }
 
-        bool supports(FileFeature) const override
+        return m_archiveData.subspan(static_cast<size_t>(dataOffset), static_cast<size_t>(entry.compressedSize));
+    }
+
+    Result<ReadOnlyBuffer> ZipArchiveFileSystem::inflateEntry(const ZipEntry& entry) const
+    {
+        Result<std::span<const std::byte>> compressedData = getEntryData(entry);
+        CheckResult(compressedData);
+
+        Buffer content{static_cast<size_t>(entry.size)};
+        Result<size_t> inflatedSize = inflateRaw(*compressedData, {content.data(), content.size()});
+        if (!inflatedSize)
         {
-            return false;
+            return MakeError("Fail to inflate zip entry ({}): {}", entry.path, inflatedSize.getError()->getMessage());
         }
 
-        bool isOpened() const override
+        if (*inflatedSize != entry.size)
         {
-            return true;
+            return MakeError("Zip entry ({}) size mismatch", entry.path);
         }
 
-        AccessModeFlag getAccessMode() const override
+        if (computeCrc32({content.data(), content.size()}) != entry.crc32)
         {
-            return AccessMode::Read;
+            return MakeError("Zip entry ({}) checksum mismatch", entry.path);
         }
 
-        FsPath getPath() const override
+        return content.toReadOnly();
+    }
+
+    Result<ReadOnlyBuffer> ZipArchiveFileSystem::getInflatedContent(size_t entryIndex)
+    {
+        if (ReadOnlyBuffer content = m_cache.get(entryIndex))
         {
-            return m_vfsPath;
+            return content;
         }
 
-        StreamBasePtr createStream(std::optional<AccessModeFlag>) override
+        std::shared_ptr<PendingInflate> pending;
+        bool isInflateOwner = false;
         {
-            auto result = EXPR_Block->Result<std::tuple<const void*, size_t>>
+            const std::lock_guard lock(m_pendingMutex);
+            auto [iter, emplaced] = m_pendingInflates.try_emplace(entryIndex);
+            if (emplaced)
             {
-                const std::lock_guard lock(m_archiveFileSystem->m_mutex);
+                iter->second = std::make_shared<PendingInflate>();
+            }
 
-                if(m_uncompressedBuffer.empty())
-                {
-                    auto archive = m_archiveFileSystem->m_zipArchive;
+            pending = iter->second;
+            isInflateOwner = emplaced;
+        }
 
-                    ::unzGoToFilePos64(archive, &m_fsEntry.zipPos);
-                    ::unzOpenCurrentFile(archive);
+        if (!isInflateOwner)
+        {
+            std::unique_lock lock(pending->mutex);
+            pending->signal.wait(lock, [&pending]
+            {
+                return pending->isReady;
+            });
 
-                    scope_on_leave
-                    {
-                        ::unzCloseCurrentFile(archive);
-                    };
+            return pending->result;
+        }
 
-                    m_uncompressedBuffer.resize(m_fsEntry.size);
-                    size_t readOffset = 0;
+        // the entry could be inflated by the other thread right before the pending state is created
+        ReadOnlyBuffer cachedContent = m_cache.get(entryIndex);
+        Result<ReadOnlyBuffer> result = cachedContent ? Result<ReadOnlyBuffer>{std::move(cachedContent)} : inflateEntry(m_entries[entryIndex]);
+        if (result)
+        {
+            m_cache.put(entryIndex, *result);
+        }
 
-                    constexpr size_t ZipReadMaxBytes = UINT16_MAX;
+        {
+            const std::lock_guard lock(pending->mutex);
+            pending->result = result;
+            pending->isReady = true;
+        }
+        pending->signal.notify_all();
 
-                    for(; readOffset < m_uncompressedBuffer.size();)
-                    {
-                        void* const ptr = m_uncompressedBuffer.data() + readOffset;
-                        const size_t readCount = std::min(m_uncompressedBuffer.size() - readOffset, ZipReadMaxBytes);
-                        const int readResult = ::unzReadCurrentFile(archive, ptr, static_cast<uint32_t>(readCount));
-
-                        MY_DEBUG_ASSERT(readResult >= 0);
-                        if(readResult < 0)
-                        {
-                            return MakeError("Read zip entry error");
-                        }
-                        if(readResult == 0)
-                        {
-                            break;
-                        }
-
-                        readOffset += static_cast<size_t>(readResult);
-                    }
+        {
+            const std::lock_guard lock(m_pendingMutex);
+            m_pendingInflates.erase(entryIndex);
+        }
 
-                    if(readOffset < m_uncompressedBuffer.size())
-                    {
-                        m_uncompressedBuffer.resize(readOffset);
-                    }
-                }
+        return result;
+    }
 
-                return {m_uncompressedBuffer.data(), m_uncompressedBuffer.size()};
-            };
+    bool ZipArchiveFileSystem::exists(const FsPath& path, std::optional<FsEntryKind> kind)
+    {
+        if (kind != FsEntryKind::Directory && findEntry(path))
+        {
+            return true;
+        }
 
-            if (!result)
-            {
-                return nullptr;
-            }
-            
-            const auto [ptr, size] = *result;
-    
-            return io::createReadOnlyMemoryStream(ptr, size, rtti::Acquire {as<IRefCounted*>()});
+        const std::string pathString = path.getString();
+        return kind != FsEntryKind::File && m_directories.contains(std::string{getNormalizedPath(pathString)});
+    }
+
+    size_t ZipArchiveFileSystem::getLastWriteTime(const FsPath& path)
+    {
+        const std::optional<size_t> entryIndex = findEntry(path);
+        return entryIndex ? m_entries[*entryIndex].lastWriteTime : 0;
+    }
+
+    FilePtr ZipArchiveFileSystem::openFile(const FsPath& path, AccessModeFlag accessMode, [[maybe_unused]] OpenFileMode openMode)
+    {
+        if (accessMode.has(AccessMode::Write))
+        {
+            MY_DEBUG_FAILURE("Zip archive file system is read only");
+            return nullptr;
         }
 
-        uint64_t getSize() const override
+        const std::optional<size_t> entryIndex = findEntry(path);
+        if (!entryIndex)
         {
-            return m_fsEntry.size;
+            return nullptr;
         }
-  
-    private:
-        void setVfsPath(io::FsPath vfsPath) override
+
+        const ZipEntry& entry = m_entries[*entryIndex];
+        if ((entry.flags & EncryptedEntryFlag) != 0)
         {
-            m_vfsPath = std::move(vfsPath);
+            mylog_error("Encrypted zip entries are not supported ({})", entry.path);
+            return nullptr;
         }
 
-        my::Ptr<ZipArchiveFileSystem> m_archiveFileSystem;
-        const ZipArchiveFileSystem::ZipFsEntry& m_fsEntry;
-        std::vector<std::byte> m_uncompressedBuffer;
-        FsPath m_vfsPath;
-    };
+        if (entry.method == StoredMethod)
+        {
+            Result<std::span<const std::byte>> entryData = getEntryData(entry);
+            if (!entryData)
+            {
+                mylog_error("Fail to open zip entry: {}", entryData.getError()->getMessage());
+                return nullptr;
+            }
 
-    ZipArchiveFileSystem::~ZipArchiveFileSystem()
-    {
-        if(m_zipArchive)
+            return rtti::createInstance<MemoryViewFile>(path, m_archiveOwner, m_archiveBuffer, *entryData);
+        }
+
+        if (entry.method != DeflatedMethod)
         {
-            ::unzClose(m_zipArchive);
+            mylog_error("Unsupported zip compression method ({}) for ({})", entry.method, entry.path);
+            return nullptr;
         }
-    }
 
-    bool ZipArchiveFileSystem::isReadOnly() const
-    {
-        return true;
+        Result<ReadOnlyBuffer> content = getInflatedContent(*entryIndex);
+        if (!content)
+        {
+            mylog_error("Fail to open zip entry: {}", content.getError()->getMessage());
+            return nullptr;
+        }
+
+        const std::span<const std::byte> contentData{content->data(), content->size()};
+        return rtti::createInstance<MemoryViewFile>(path, nullptr, std::move(*content), contentData);
     }
 
-    bool ZipArchiveFileSystem::exists(const FsPath& path, [[maybe_unused]] std::optional<FsEntryKind> kind)
+    async::Task<> ZipArchiveFileSystem::prefetch(std::vector<FsPath> paths)
     {
-        struct OperatorLess
+        const Ptr<ZipArchiveFileSystem> selfRef{this};
+
+        std::vector<async::Task<>> inflateTasks;
+        for (const FsPath& path : paths)
         {
-            bool operator()(const FsEntry& fs, const FsPath& path) const
+            const std::optional<size_t> entryIndex = findEntry(path);
+            if (!entryIndex || m_entries[*entryIndex].method != DeflatedMethod)
             {
-                return fs.path < path;
+                continue;
             }
 
-            bool operator()(const FsPath& path, const FsEntry& fs) const
+            inflateTasks.emplace_back(async::run([this, entryIndex = *entryIndex]
             {
-                return path < fs.path;
-            }
-        };
+                // errors are reported when the file is opened
+                [[maybe_unused]] Result<ReadOnlyBuffer> content = getInflatedContent(entryIndex);
+            }, m_inflateExecutor));
+        }
 
-        if (path.isEmpty())
-        { // root
-            return true;
+        co_await async::whenAll(inflateTasks);
+    }
+
+    FileSystem::OpenDirResult ZipArchiveFileSystem::openDirIterator(const FsPath& path)
+    {
+        const std::string pathString = path.getString();
+        const std::string_view normalizedPath = getNormalizedPath(pathString);
+        if (!m_directories.contains(std::string{normalizedPath}))
+        {
+            return {};
         }
 
+        std::string prefix{normalizedPath};
+        if (!prefix.empty())
+        {
+            prefix.push_back('/');
+        }
 
-        return std::binary_search(m_index.begin(), m_index.end(), path, OperatorLess{});
+        const auto first = std::lower_bound(m_entries.begin(), m_entries.end(), prefix, [](const ZipEntry& entry, const std::string& value)
+        {
+            return entry.path < value;
+        });
+
+        auto* const state = new DirIteratorState{path, std::move(prefix), static_cast<size_t>(first - m_entries.begin())};
+        FsEntry firstEntry = nextDirEntry(*state);
+
+        return {state, std::move(firstEntry)};
     }
 
-    size_t ZipArchiveFileSystem::getLastWriteTime(const FsPath&)
+    void ZipArchiveFileSystem::closeDirIterator(void* ptr)
     {
-        return 0;
+        delete reinterpret_cast<DirIteratorState*>(ptr);
     }
 
-    IFile::Ptr ZipArchiveFileSystem::openFile(const FsPath& path, AccessModeFlag accessMode, OpenFileMode openMode)
+    FsEntry ZipArchiveFileSystem::incrementDirIterator(void* ptr)
     {
-        MY_DEBUG_ASSERT(openMode == OpenFileMode::OpenExisting);
-        MY_DEBUG_ASSERT(!(accessMode && AccessMode::Write));
-
-        // m_index is not mutable.
-        auto iter = std::find_if(m_index.begin(), m_index.end(), [&path](const ZipFsEntry& entry)
-                                 {
-                                     return entry.path == path;
-                                 });
-
-        if(iter == m_index.end())
+        if (!ptr)
         {
-            return nullptr;
+            return {};
         }
 
-        return rtti::createInstance<ArchiveFile>(rtti::Acquire{this}, *iter);
+        return nextDirEntry(*reinterpret_cast<DirIteratorState*>(ptr));
     }
 
-    FileSystem::OpenDirResult ZipArchiveFileSystem::openDirIterator(const FsPath& path)
+    FsEntry ZipArchiveFileSystem::nextDirEntry(DirIteratorState& state) const
     {
-        std::vector<const ZipFsEntry*> entries;
-        for (const auto& entry : m_index)
+        if (state.index >= m_entries.size())
         {
-            if (entry.path.getParentPath() == path)
-            {
-                entries.push_back(&entry);
-            }
+            return {};
         }
 
-        if (entries.empty())
+        const ZipEntry& entry = m_entries[state.index];
+        if (!entry.path.starts_with(state.prefix))
         {
+            state.index = m_entries.size();
             return {};
         }
 
-        auto* const state = new DirIteratorState {std::move(entries), path };
+        const std::string_view name = std::string_view{entry.path}.substr(state.prefix.size());
+        const size_t separatorPos = name.find('/');
+        if (separatorPos == std::string_view::npos)
+        {
+            ++state.index;
+            return FsEntry{
+                .path = state.basePath / name,
+                .kind = FsEntryKind::File,
+                .size = static_cast<size_t>(entry.size),
+                .lastWriteTime = entry.lastWriteTime};
+        }
 
-        return { state, state->getCurrentFsEntry() };
+        // Entries are sorted, so all the content of the sub directory is contiguous: skip it at once.
+        const std::string_view directoryName = name.substr(0, separatorPos);
+        const std::string_view directoryPrefix = std::string_view{entry.path}.substr(0, state.prefix.size() + separatorPos + 1);
+        do
+        {
+            ++state.index;
+        } while (state.index < m_entries.size() && m_entries[state.index].path.starts_with(directoryPrefix));
+
+        return FsEntry{
+            .path = state.basePath / directoryName,
+            .kind = FsEntryKind::Directory,
+            .size = 0,
+            .lastWriteTime = 0};
     }
 
-    void ZipArchiveFileSystem::closeDirIterator(void* statePtr)
+    FileSystemPtr createZipArchiveFileSystem(StreamPtr stream, ZipArchiveFileSystemSettings settings)
     {
-        if (statePtr)
+        MY_DEBUG_ASSERT(stream);
+        if (!stream)
         {
-            auto* const state = reinterpret_cast<DirIteratorState*>(statePtr);
-            delete state;
+            return nullptr;
         }
-    }
 
-    FsEntry ZipArchiveFileSystem::incrementDirIterator(void* statePtr)
-    {
-        MY_DEBUG_ASSERT(statePtr);
-        auto* const state = reinterpret_cast<DirIteratorState*>(statePtr);
+        Ptr<> archiveOwner;
+        ReadOnlyBuffer archiveBuffer;
+        std::span<const std::byte> archiveData;
 
-        if (++state->currentIndex >= state->entries.size())
+        if (MemoryStream* const memoryStream = stream->as<MemoryStream*>())
         {
-            return {};
+            archiveData = memoryStream->getBufferAsSpan(0, std::nullopt);
+            archiveOwner = std::move(stream);
         }
+        else
+        {
+            Buffer buffer;
+            stream->setPosition(OffsetOrigin::Begin, 0);
 
-        return state->getCurrentFsEntry();
+            constexpr size_t ReadChunkSize = 1024 * 1024;
+            for (;;)
+            {
+                std::byte* const ptr = buffer.append(ReadChunkSize);
+                const Result<size_t> readResult = stream->read(ptr, ReadChunkSize);
+                if (!readResult)
+                {
+                    mylog_error("Fail to read zip archive: {}", readResult.getError()->getMessage());
+                    return nullptr;
+                }
+
+                buffer.resize(buffer.size() - ReadChunkSize + *readResult);
+                if (*readResult == 0)
+                {
+                    break;
+                }
+            }
+
+            archiveBuffer = std::move(buffer);
+            archiveData = {archiveBuffer.data(), archiveBuffer.size()};
+        }
+
+        const std::string basePath = std::move(settings.basePath);
+        auto fileSystem = rtti::createInstance<ZipArchiveFileSystem>(std::move(archiveOwner), std::move(archiveBuffer), archiveData, std::move(settings));
+        if (Result<> loadResult = fileSystem->loadIndex(basePath); !loadResult)
+        {
+            mylog_error("Fail to load zip archive index: {}", loadResult.getError()->getMessage());
+            return nullptr;
+        }
+
+        return fileSystem;
     }
 
-    FileSystemPtr createZipArchiveFileSystem(IStreamReader::Ptr stream, [[maybe_unused]] std::string basePath)
+    FileSystemPtr createZipArchiveFileSystem(StreamPtr stream, std::string basePath)
     {
-        MY_DEBUG_ASSERT(basePath.empty(), "Archive base/inner path is not supported yet");
-        return rtti::createInstance<ZipArchiveFileSystem>(std::move(stream));
+        return createZipArchiveFileSystem(std::move(stream), ZipArchiveFileSystemSettings{.basePath = std::move(basePath)});
     }
 }  // namespace my::io
-
-#endif
@@ -1,12 +1,17 @@
 // #my_engine_source_file
 #include "crt_allocator.h"
+#include "small_block_allocator_impl.h"
 
 
 namespace my {
 
 IAllocator& getDefaultAllocator()
 {
+#if MY_SMALL_BLOCK_DEFAULT_ALLOCATOR
+    static AllocatorPtr allocator = mem_detail::createSmallBlockAllocatorSingleton();
+#else
     static Ptr<CrtAllocator> allocator = rtti::createInstanceSingleton<CrtAllocator>();
+#endif
     return *allocator;
 }
 
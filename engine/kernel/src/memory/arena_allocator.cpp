@@ -0,0 +1,402 @@
+// #my_engine_source_file
+
+#include "my/memory/arena_allocator.h"
+
+#include "my/memory/host_memory.h"
+#include "my/memory/internal/allocator_base.h"
+#include "my/rtti/rtti_impl.h"
+#include "my/threading/lock_guard.h"
+#include "my/threading/mutex_no_lock.h"
+#include "my/threading/spin_lock.h"
+
+namespace my {
+namespace {
+
+constexpr size_t ArenaMaxAlignment = 64;
+
+/**
+    Chunk header is placed at the beginning of the chunk's memory.
+ */
+struct alignas(ArenaMaxAlignment) ArenaChunk
+{
+    ArenaChunk* next = nullptr;
+    std::byte* top = nullptr;  // end of the used memory, valid only for the chunks that are not current
+    size_t size = 0;
+
+    std::byte* begin()
+    {
+        return reinterpret_cast<std::byte*>(this + 1);
+    }
+
+    std::byte* end()
+    {
+        return reinterpret_cast<std::byte*>(this) + size;
+    }
+
+    bool contains(const void* ptr)
+    {
+        return begin() <= ptr && ptr < end();
+    }
+};
+
+/**
+    Process wide pool of the standard sized chunks: arenas that are created per request do not touch the host memory in the steady state.
+ */
+class ArenaChunkPool
+{
+public:
+    static constexpr size_t MinPooledChunkSize = Kilobyte(16);
+    static constexpr size_t MaxPooledChunkSize = Megabyte(1);
+    static constexpr size_t MaxPooledChunksPerSize = 64;
+
+    static ArenaChunkPool& instance()
+    {
+        static ArenaChunkPool pool;
+        return pool;
+    }
+
+    static bool isPooledSize(size_t size)
+    {
+        return isPowerOf2(size) && MinPooledChunkSize <= size && size <= MaxPooledChunkSize;
+    }
+
+    ArenaChunk* acquire(size_t size)
+    {
+        if (isPooledSize(size))
+        {
+            const std::lock_guard lock(m_mutex);
+            FreeList& freeList = getFreeList(size);
+            if (ArenaChunk* const chunk = freeList.head)
+            {
+                freeList.head = chunk->next;
+                --freeList.count;
+                chunk->next = nullptr;
+                return chunk;
+            }
+        }
+
+        IHostMemory::MemRegion pages = m_hostMemory->allocPages(size);
+        if (!pages)
+        {
+            return nullptr;
+        }
+
+        MY_DEBUG_ASSERT(reinterpret_cast<uintptr_t>(pages.basePtr()) % alignof(ArenaChunk) == 0);
+        ArenaChunk* const chunk = new(pages.basePtr()) ArenaChunk;
+        chunk->size = size;
+        return chunk;
+    }
+
+    void release(ArenaChunk* chunk)
+    {
+        if (isPooledSize(chunk->size))
+        {
+            const std::lock_guard lock(m_mutex);
+            FreeList& freeList = getFreeList(chunk->size);
+            if (freeList.count < MaxPooledChunksPerSize)
+            {
+                chunk->next = std::exchange(freeList.head, chunk);
+                ++freeList.count;
+                return;
+            }
+        }
+
+        m_hostMemory->freePages(IHostMemory::MemRegion{chunk, chunk->size});
+    }
+
+private:
+    struct FreeList
+    {
+        ArenaChunk* head = nullptr;
+        size_t count = 0;
+    };
+
+    static constexpr size_t PooledSizesCount = std::bit_width(MaxPooledChunkSize) - std::bit_width(MinPooledChunkSize) + 1;
+
+    FreeList& getFreeList(size_t size)
+    {
+        return m_freeLists[std::bit_width(size) - std::bit_width(MinPooledChunkSize)];
+    }
+
+    const HostMemoryPtr m_hostMemory = createCrtHostMemory(true);
+    threading::SpinLock m_mutex;
+    std::array<FreeList, PooledSizesCount> m_freeLists;
+};
+
+/**
+ */
+template <typename Mutex>
+class ArenaAllocator final : public AllocatorWithMemResource<ArenaAllocator<Mutex>, IArenaAllocator>
+{
+    MY_REFCOUNTED_CLASS(ArenaAllocator, IArenaAllocator)
+
+public:
+    // Chunks that are retained by arena after reset(), the rest are returned to the pool.
+    static constexpr size_t MaxRetainedChunks = 4;
+
+    ArenaAllocator(size_t chunkSize) :
+        m_chunkSize(chunkSize)
+    {
+    }
+
+    ~ArenaAllocator()
+    {
+        releaseOversizedBlocks();
+        releaseChunks(m_firstChunk);
+    }
+
+    void* alloc(size_t size, size_t align) override
+    {
+        MY_DEBUG_FATAL(checkAllocAlignment(align, ArenaMaxAlignment), "Invalid alignment ({})", align);
+
+        const std::lock_guard lock(m_mutex);
+        return allocateInternal(size, align == IAllocator::UnspecifiedValue ? IAllocator::DefaultAlignment : align);
+    }
+
+    void* realloc(void* oldPtr, size_t size, size_t align) override
+    {
+        MY_DEBUG_FATAL(checkAllocAlignment(align, ArenaMaxAlignment), "Invalid alignment ({})", align);
+
+        const std::lock_guard lock(m_mutex);
+        align = align == IAllocator::UnspecifiedValue ? IAllocator::DefaultAlignment : align;
+
+        if (!oldPtr)
+        {
+            return allocateInternal(size, align);
+        }
+
+        // The most recent allocation can be resized in place.
+        if (oldPtr == m_lastAllocation && reinterpret_cast<uintptr_t>(oldPtr) % align == 0 && size <= static_cast<size_t>(m_end - m_lastAllocation))
+        {
+            m_usedSize += size;
+            m_usedSize -= static_cast<size_t>(m_top - m_lastAllocation);
+            m_top = m_lastAllocation + size;
+            return oldPtr;
+        }
+
+        // Arena does not keep allocation sizes: copy what can belong to the old block (bounded by the used part of the owner chunk).
+        const size_t availableSize = getAvailableSizeFrom(reinterpret_cast<std::byte*>(oldPtr));
+        void* const newPtr = allocateInternal(size, align);
+        if (newPtr)
+        {
+            memcpy(newPtr, oldPtr, std::min(size, availableSize));
+        }
+
+        return newPtr;
+    }
+
+    void free(void* ptr, [[maybe_unused]] size_t size, [[maybe_unused]] size_t align) override
+    {
+        MY_DEBUG_FATAL(checkAllocAlignment(align, ArenaMaxAlignment), "Invalid alignment ({})", align);
+
+        if (!ptr)
+        {
+            return;
+        }
+
+        const std::lock_guard lock(m_mutex);
+        if (ptr == m_lastAllocation)
+        {
+            m_usedSize -= static_cast<size_t>(m_top - m_lastAllocation);
+            m_top = std::exchange(m_lastAllocation, nullptr);
+        }
+    }
+
+    size_t getMaxAlignment() const override
+    {
+        return ArenaMaxAlignment;
+    }
+
+    void reset() override
+    {
+        const std::lock_guard lock(m_mutex);
+
+        releaseOversizedBlocks();
+
+        ArenaChunk* lastRetained = m_firstChunk;
+        for (size_t i = 1; lastRetained && i < MaxRetainedChunks; ++i)
+        {
+            lastRetained = lastRetained->next;
+        }
+
+        if (lastRetained)
+        {
+            releaseChunks(std::exchange(lastRetained->next, nullptr));
+        }
+
+        m_currentChunk = m_firstChunk;
+        m_top = m_currentChunk ? m_currentChunk->begin() : nullptr;
+        m_end = m_currentChunk ? m_currentChunk->end() : nullptr;
+        m_lastAllocation = nullptr;
+        m_usedSize = 0;
+    }
+
+    size_t getUsedSize() const override
+    {
+        const std::lock_guard lock(m_mutex);
+        return m_usedSize;
+    }
+
+private:
+    void* allocateInternal(size_t size, size_t align)
+    {
+        MY_DEBUG_ASSERT(isPowerOf2(align));
+
+        std::byte* ptr = alignPtr(m_top, align);
+        if (!m_top || ptr > m_end || size > static_cast<size_t>(m_end - ptr))
+        {
+            if (size + align > getChunkCapacity() / 2)
+            {
+                return allocateOversized(size, align);
+            }
+
+            if (!switchToNextChunk())
+            {
+                return nullptr;
+            }
+
+            ptr = alignPtr(m_top, align);
+        }
+
+        MY_DEBUG_ASSERT(ptr + size <= m_end);
+
+        m_usedSize += static_cast<size_t>(ptr + size - m_top);
+        m_top = ptr + size;
+        m_lastAllocation = ptr;
+
+        return ptr;
+    }
+
+    void* allocateOversized(size_t size, size_t align)
+    {
+        ArenaChunk* const chunk = ArenaChunkPool::instance().acquire(alignedSize(sizeof(ArenaChunk) + size + align, mem::PageSize));
+        if (!chunk)
+        {
+            return nullptr;
+        }
+
+        chunk->next = std::exchange(m_oversizedChunks, chunk);
+        std::byte* const ptr = alignPtr(chunk->begin(), align);
+        chunk->top = ptr + size;
+        m_usedSize += size;
+
+        return ptr;
+    }
+
+    bool switchToNextChunk()
+    {
+        ArenaChunk* nextChunk = m_currentChunk ? m_currentChunk->next : m_firstChunk;
+        if (!nextChunk)
+        {
+            nextChunk = ArenaChunkPool::instance().acquire(m_chunkSize);
+            if (!nextChunk)
+            {
+                return false;
+            }
+
+            if (m_currentChunk)
+            {
+                m_currentChunk->next = nextChunk;
+            }
+            else
+            {
+                m_firstChunk = nextChunk;
+            }
+        }
+
+        if (m_currentChunk)
+        {
+            m_currentChunk->top = m_top;
+        }
+
+        m_currentChunk = nextChunk;
+        m_top = nextChunk->begin();
+        m_end = nextChunk->end();
+        m_lastAllocation = nullptr;
+
+        return true;
+    }
+
+    size_t getAvailableSizeFrom(std::byte* ptr)
+    {
+        if (m_currentChunk && m_currentChunk->contains(ptr))
+        {
+            return static_cast<size_t>(m_top - ptr);
+        }
+
+        for (ArenaChunk* chunk = m_firstChunk; chunk && chunk != m_currentChunk; chunk = chunk->next)
+        {
+            if (chunk->contains(ptr))
+            {
+                return static_cast<size_t>(chunk->top - ptr);
+            }
+        }
+
+        for (ArenaChunk* chunk = m_oversizedChunks; chunk; chunk = chunk->next)
+        {
+            if (chunk->contains(ptr))
+            {
+                return static_cast<size_t>(chunk->top - ptr);
+            }
+        }
+
+        MY_DEBUG_FAILURE("Pointer does not belong to the arena");
+        return 0;
+    }
+
+    void releaseOversizedBlocks()
+    {
+        releaseChunks(std::exchange(m_oversizedChunks, nullptr));
+    }
+
+    static void releaseChunks(ArenaChunk* chunk)
+    {
+        while (chunk)
+        {
+            ArenaChunk* const next = chunk->next;
+            ArenaChunkPool::instance().release(chunk);
+            chunk = next;
+        }
+    }
+
+    size_t getChunkCapacity() const
+    {
+        return m_chunkSize - sizeof(ArenaChunk);
+    }
+
+    static std::byte* alignPtr(std::byte* ptr, size_t align)
+    {
+        return reinterpret_cast<std::byte*>(alignedSize(reinterpret_cast<uintptr_t>(ptr), align));
+    }
+
+    const size_t m_chunkSize;
+    ArenaChunk* m_firstChunk = nullptr;
+    ArenaChunk* m_currentChunk = nullptr;
+    ArenaChunk* m_oversizedChunks = nullptr;
+    std::byte* m_top = nullptr;
+    std::byte* m_end = nullptr;
+    std::byte* m_lastAllocation = nullptr;
+    size_t m_usedSize = 0;
+    mutable Mutex m_mutex;
+};
+
+}  // namespace
+
+ArenaAllocatorPtr createArenaAllocator(Byte chunkSize, bool threadSafe)
+{
+    MY_DEBUG_ASSERT(chunkSize >= sizeof(ArenaChunk) * 2, "Arena chunk size is too small: ({})", static_cast<size_t>(chunkSize));
+
+    const size_t alignedChunkSize = alignedSize(chunkSize, mem::PageSize);
+
+    using ThreadSafeAllocator = ArenaAllocator<threading::SpinLock>;
+    using ThreadUnsafeAllocator = ArenaAllocator<threading::NoLockMutex>;
+
+    if (threadSafe)
+    {
+        return rtti::createInstance<ThreadSafeAllocator>(alignedChunkSize);
+    }
+
+    return rtti::createInstance<ThreadUnsafeAllocator>(alignedChunkSize);
+}
+
+}  // namespace my
@@ -18,6 +18,7 @@ struct BufferBase::Header
 {
     inline static constexpr uint32_t BufferToken = 0x11AA22BBu;
 
+    IAllocator* allocator = nullptr;  // null for the buffers allocated by the default (pooled) buffer allocator
     std::atomic<uint32_t> refs{1u};
     uint32_t capacity = 0;
     uint32_t size = 0;
@@ -140,24 +141,35 @@ IAllocator& getBufferAllocator(const BufferBase::Header& header)
 {
     MY_DEBUG_FATAL(header.capacity > 0);
 
+    if (header.allocator)
+    {
+        return *header.allocator;
+    }
+
     const size_t storageSize = HeaderSize + header.capacity;
     return getBufferAllocator(storageSize);
 }
 
 }  // namespace
 
-BufferHandle BufferStorage::allocate(size_t clientSize)
+size_t BufferStorage::getStorageSize(size_t clientSize)
 {
     const size_t granuleSize = (clientSize < BigAllocationThreshold) ? AllocationGranularity : BigAllocationGranularity;
-    const size_t storageSize = alignedSize(HeaderSize + clientSize, granuleSize);
+    return alignedSize(HeaderSize + clientSize, granuleSize);
+}
+
+BufferHandle BufferStorage::allocate(size_t clientSize, IAllocator* customAllocator)
+{
+    const size_t storageSize = getStorageSize(clientSize);
     const size_t capacity = storageSize - HeaderSize;
 
-    IAllocator& allocator = getBufferAllocator(storageSize);
+    IAllocator& allocator = customAllocator ? *customAllocator : getBufferAllocator(storageSize);
     void* const storage = allocator.alloc(storageSize);
     MY_FATAL(storage);
     MY_FATAL(reinterpret_cast<ptrdiff_t>(storage) % HeaderAlignment == 0);
 
     BufferHeader* header = new(storage) BufferHeader;
+    header->allocator = customAllocator;
     header->capacity = static_cast<uint32_t>(capacity);
     header->size = static_cast<uint32_t>(clientSize);
 
@@ -181,7 +193,7 @@ BufferHandle BufferStorage::reallocate(BufferHandle buffer, size_t newSize)
         return buffer;
     }
 
-    BufferHandle newHandle = BufferStorage::allocate(newSize);
+    BufferHandle newHandle = BufferStorage::allocate(newSize, header->allocator);
     memcpy(clientData(newHandle), clientData(buffer), header->size);
     getBufferAllocator(*header).free(buffer);
     return newHandle;
@@ -313,9 +325,9 @@ const BufferBase::Header& BufferBase::header() const
 
 Buffer::Buffer() = default;
 
-Buffer::Buffer(size_t size)
+Buffer::Buffer(size_t size, IAllocator* allocator)
 {
-    m_storage = BufferStorage::allocate(size);
+    m_storage = BufferStorage::allocate(size, allocator);
 }
 
 Buffer::Buffer(Buffer&& buffer) noexcept :
@@ -125,7 +125,7 @@ namespace my
         }
     };
 
-    HostMemoryPtr createHostCrtMemory([[maybe_unused]] Byte maxSize)
+    HostMemoryPtr createCrtHostMemory([[maybe_unused]] bool threadSafe)
     {
         return std::make_shared<HostCrtMemory>();
     }
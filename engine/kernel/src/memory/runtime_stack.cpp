@@ -5,74 +5,30 @@
 #include "my/memory/runtime_stack.h"
 #include "my/rtti/rtti_impl.h"
 
-#include <compare>
-
-// #include <unordered_set>
-
 namespace my {
 namespace {
 
 static thread_local RuntimeStackGuard* s_currentStackGuard = nullptr;
+static thread_local size_t s_threadHighWaterMark = 0;
 
 #if MY_DEBUG_ASSERT_ENABLED
-struct AllocationEntry
+/**
+    Debug header that precedes each allocation, the tail canary immediately follows the allocated block.
+    Allows to detect overruns, double frees and leaks (through the per-guard counters) in constant time.
+ */
+struct alignas(16) DebugAllocationHeader
 {
-    uintptr_t marker = 0;
-    uintptr_t mem = 0;
-
-    AllocationEntry() = default;
-    AllocationEntry(void* ptr) :
-        marker(s_currentStackGuard->getMyTop()),
-        mem(reinterpret_cast<uintptr_t>(ptr))
-    {
-    }
-
-    std::strong_ordering operator<=>(const AllocationEntry& other) const noexcept
-    {
-        // MY_DEBUG_ASSERT(other.mem != mem || other.marker == marker);
-        return mem <=> other.mem;
-    }
+    RuntimeStackGuard* guard;
+    uint32_t size;
+    uint32_t canary;
 };
 
-static thread_local std::set<AllocationEntry> s_trackedAllocations;
-
-inline void notifyAllocation(void* mem)
-{
-    if (s_currentStackGuard != nullptr)
-    {
-        const auto [iter, emplaceOk] = s_trackedAllocations.emplace(mem);
-        MY_DEBUG_ASSERT(emplaceOk, "Stack allocation duplication");
-    }
-}
-
-inline void notifyFree(void* mem)
-{
-    const auto count = s_trackedAllocations.erase(AllocationEntry{mem});
-    MY_DEBUG_ASSERT(count == 1);
-}
-
-inline void checkNonFreedPointers(uintptr_t marker)
-{
-    const size_t nonFreedAllocationsCount = std::erase_if(s_trackedAllocations, [marker](const AllocationEntry& entry)
-    {
-        return entry.marker == marker;
-    });
-
-    MY_DEBUG_ASSERT(nonFreedAllocationsCount == 0, "There is ({}) non freed allocations", nonFreedAllocationsCount);
-}
-
-// void
-#else
-inline void notifyAllocation(void*)
-{
-}
-inline void notifyFree(void*)
-{
-}
-inline void checkNonFreedPointers(uintptr_t)
-{
-}
+constexpr uint32_t AllocatedCanary = 0xA110CA7Eu;
+constexpr uint32_t FreedCanary = 0xF4EEDB1Cu;
+constexpr uint32_t TailCanary = 0x7A11CA9Eu;
 
+constexpr size_t DebugHeaderSize = sizeof(DebugAllocationHeader);
+constexpr size_t DebugTailSize = sizeof(TailCanary);
 #endif
 }  // namespace
 
@@ -85,155 +41,337 @@ public:
     using Base = AllocatorWithMemResource<RuntimeStackAllocator>;
     static constexpr size_t MaxAlignment = 16;
 
-    RuntimeStackAllocator(const Kilobyte size) :
+    // Segments that are kept (not returned to the host memory) beyond the current one after the stack is restored.
+    static constexpr size_t MaxSpareSegments = 1;
+
+    RuntimeStackAllocator(const Kilobyte segmentSize, const bool heapFallback) :
         Base(),
-        m_pageAllocator(createHostVirtualMemory(size, false))
+        m_hostMemory(createCrtHostMemory(false)),
+        m_segmentSize(alignedSize(static_cast<size_t>(segmentSize), mem::PageSize)),
+        m_heapFallback(heapFallback)
     {
     }
 
     ~RuntimeStackAllocator()
     {
-        // std::cout << "max rt size: " << m_allocator.allocatedSize() << std::endl;
-    }
-
-    void restore(uintptr_t offset)
-    {
-#ifdef _DEBUG
-        MY_DEBUG_ASSERT(m_allocOffset >= offset);
-        if (const uintptr_t size = m_allocOffset - offset; size > 0)
+        restore(0);
+        for (Segment& segment : m_segments)
         {
-            void* const ptr = reinterpret_cast<std::byte*>(m_allocatedRegion.basePtr()) + offset;
-            memset(ptr, 0, size);
+            m_hostMemory->freePages(std::move(segment.region));
         }
-#endif
-        m_allocOffset = offset;
     }
 
+    void restore(uintptr_t offset);
+
     size_t getOffset() const
     {
         return m_allocOffset;
     }
 
     void* alloc(size_t size, size_t align) override;
-    // {
-    //     return reallocAligned(nullptr, size, DefaultAlignment);
-    // }
 
     void* realloc(void* oldPtr, size_t size, size_t align) override;
-    // {
-    //     return reallocAligned(oldPtr, size, DefaultAlignment);
-    // }
 
     void free(void* ptr, size_t size, size_t align) override;
-    // {
-    //     freeAligned(ptr, DefaultAlignment);
-    // }
 
     size_t getMaxAlignment() const override
     {
         return MaxAlignment;
     }
 
-    // void* allocAligned(size_t size, size_t alignment) override
-    // {
-    //     return reallocAligned(nullptr, size, alignment);
-    // }
-
-    // void* reallocAligned(void* oldPtr, size_t size, size_t alignment) override;
-
-    // void freeAligned(void* ptr, size_t alignment) override;
-
     uintptr_t getAllocationOffset() const override
     {
         return m_allocOffset;
     }
 
+    size_t getHighWaterMark() const override
+    {
+        return m_highWaterMark;
+    }
+
 private:
-    HostMemoryPtr m_pageAllocator;
-    IHostMemory::MemRegion m_allocatedRegion;
+    /**
+        Segment is a contiguous memory region that is chained when the previous one is exhausted.
+        Allocation offset is a logical offset through all the segments: segment is placed at the offset where it starts to be used,
+        so the offsets that are kept by the guards stay valid regardless of the segments layout.
+     */
+    struct Segment
+    {
+        IHostMemory::MemRegion region;
+        uintptr_t baseOffset = 0;
+        // Logical offset where the segment was left, meaningful only for the segments preceding the current one.
+        uintptr_t endOffset = 0;
+
+        std::byte* basePtr() const
+        {
+            return reinterpret_cast<std::byte*>(region.basePtr());
+        }
+
+        bool contains(const void* ptr) const
+        {
+            return basePtr() <= ptr && ptr < basePtr() + region.size();
+        }
+    };
+
+    /**
+        Oversized allocation that is served by the heap.
+        The record itself is allocated from the stack, so it is released (with the heap block) when the owning scope is left.
+     */
+    struct HeapBlock
+    {
+        HeapBlock* next;
+        void* ptr;
+        size_t size;
+        uintptr_t offset;
+    };
+
+    void* allocateStackBlock(size_t size);
+    void* allocateHeapBlock(size_t size);
+    IHostMemory::MemRegion allocateSegmentRegion(size_t size);
+    void updateHighWaterMark();
+
+#if MY_DEBUG_ASSERT_ENABLED
+    void* trackAllocation(void* blockPtr, size_t size);
+    void untrackAllocation(void* ptr);
+    bool isLiveAllocation(const void* blockPtr) const;
+#endif
+
+    const HostMemoryPtr m_hostMemory;
+    const size_t m_segmentSize;
+    const bool m_heapFallback;
+    std::vector<Segment> m_segments;
+    size_t m_currentSegment = 0;
     uintptr_t m_allocOffset = 0;
+    HeapBlock* m_heapBlocks = nullptr;
+    size_t m_heapAllocatedSize = 0;
+    size_t m_highWaterMark = 0;
 };
 
-void* RuntimeStackAllocator::alloc(const size_t size, [[maybe_unused]] const size_t targetAlignment)
+void RuntimeStackAllocator::restore(uintptr_t offset)
 {
-    MY_DEBUG_ASSERT(checkAllocAlignment(targetAlignment, MaxAlignment), "Invalid alignment ({}), max alignment ({})", targetAlignment, MaxAlignment);
+    MY_DEBUG_ASSERT(m_allocOffset >= offset);
 
-    constexpr size_t alignment = MaxAlignment;
-    const size_t allocationSize = alignedSize(size, alignment);
-    const size_t newAllocOffset = m_allocOffset + allocationSize;
+    while (m_heapBlocks && m_heapBlocks->offset >= offset)
+    {
+        HeapBlock* const block = std::exchange(m_heapBlocks, m_heapBlocks->next);
+        m_heapAllocatedSize -= block->size;
+        getDefaultAllocator().free(block->ptr, block->size, MaxAlignment);
+    }
 
-    if (!m_allocatedRegion)
+    // The latest segment that starts at or before the offset: a segment that was entered exactly at the offset holds nothing yet.
+    while (m_currentSegment > 0 && m_segments[m_currentSegment].baseOffset > offset)
     {
-        m_allocatedRegion = m_pageAllocator->allocPages(allocationSize);
-        MY_FATAL(m_allocatedRegion);
+        --m_currentSegment;
     }
-    else if (m_allocatedRegion.size() < newAllocOffset)
+
+    m_allocOffset = offset;
+
+    while (m_segments.size() > m_currentSegment + 1 + MaxSpareSegments)
+    {
+        m_hostMemory->freePages(std::move(m_segments.back().region));
+        m_segments.pop_back();
+    }
+}
+
+IHostMemory::MemRegion RuntimeStackAllocator::allocateSegmentRegion(size_t size)
+{
+    IHostMemory::MemRegion region = m_hostMemory->allocPages(std::max(m_segmentSize, alignedSize(size, mem::PageSize)));
+    MY_FATAL(region, "Fail to allocate runtime stack segment ({}) bytes", size);
+    MY_DEBUG_FATAL(reinterpret_cast<uintptr_t>(region.basePtr()) % MaxAlignment == 0);
+
+    return region;
+}
+
+void* RuntimeStackAllocator::allocateStackBlock(const size_t size)
+{
+    if (m_segments.empty())
+    {
+        m_segments.emplace_back(allocateSegmentRegion(size), m_allocOffset);
+        m_currentSegment = 0;
+    }
+
+    Segment* segment = &m_segments[m_currentSegment];
+    uintptr_t segmentOffset = m_allocOffset - segment->baseOffset;
+
+    if (segment->region.size() - segmentOffset < size)
     {
-        IHostMemory::MemRegion nextRegion = m_pageAllocator->allocPages(allocationSize);
-        MY_FATAL(nextRegion);
-        MY_FATAL(IHostMemory::MemRegion::isAdjacent(m_allocatedRegion, nextRegion));
+        // The rest of the current segment is skipped, next (spare or new) segment is chained.
+        segment->endOffset = m_allocOffset;
+
+        const size_t nextSegment = m_currentSegment + 1;
+        if (nextSegment < m_segments.size() && m_segments[nextSegment].region.size() < size)
+        {
+            while (m_segments.size() > nextSegment)
+            {
+                m_hostMemory->freePages(std::move(m_segments.back().region));
+                m_segments.pop_back();
+            }
+        }
+
+        if (nextSegment == m_segments.size())
+        {
+            m_segments.emplace_back(allocateSegmentRegion(size));
+        }
 
-        m_allocatedRegion += std::move(nextRegion);
+        m_currentSegment = nextSegment;
+        segment = &m_segments[nextSegment];
+        segment->baseOffset = m_allocOffset;
+        segmentOffset = 0;
     }
 
-    void* const newPtr = reinterpret_cast<std::byte*>(m_allocatedRegion.basePtr()) + std::exchange(m_allocOffset, newAllocOffset);
+    void* const ptr = segment->basePtr() + segmentOffset;
+    m_allocOffset += size;
+
+    return ptr;
+}
+
+void* RuntimeStackAllocator::allocateHeapBlock(const size_t size)
+{
+    const uintptr_t offset = m_allocOffset;
+    void* const record = allocateStackBlock(alignedSize(sizeof(HeapBlock), MaxAlignment));
+
+    void* const ptr = getDefaultAllocator().alloc(size, MaxAlignment);
+    MY_FATAL(ptr, "Fail to allocate runtime stack heap block ({}) bytes", size);
+
+    m_heapBlocks = new(record) HeapBlock{m_heapBlocks, ptr, size, offset};
+    m_heapAllocatedSize += size;
+
+    return ptr;
+}
+
+void RuntimeStackAllocator::updateHighWaterMark()
+{
+    const size_t usedSize = m_allocOffset + m_heapAllocatedSize;
+    m_highWaterMark = std::max(m_highWaterMark, usedSize);
+    s_threadHighWaterMark = std::max(s_threadHighWaterMark, usedSize);
+}
+
+void* RuntimeStackAllocator::alloc(const size_t size, [[maybe_unused]] const size_t targetAlignment)
+{
+    MY_DEBUG_ASSERT(checkAllocAlignment(targetAlignment, MaxAlignment), "Invalid alignment ({}), max alignment ({})", targetAlignment, MaxAlignment);
+
+    constexpr size_t alignment = MaxAlignment;
+#if MY_DEBUG_ASSERT_ENABLED
+    const size_t allocationSize = DebugHeaderSize + alignedSize(size + DebugTailSize, alignment);
+#else
+    const size_t allocationSize = alignedSize(size, alignment);
+#endif
+
+    // Oversized allocation does not waste the stack segments: it goes either to the heap or to the dedicated segment.
+    const bool useHeap = m_heapFallback && allocationSize > m_segmentSize / 2;
+    void* const newPtr = useHeap ? allocateHeapBlock(allocationSize) : allocateStackBlock(allocationSize);
 
     MY_DEBUG_FATAL(reinterpret_cast<uintptr_t>(newPtr) % alignment == 0);
     MY_DEBUG_FATAL(m_allocOffset % MaxAlignment == 0);
 
-    notifyAllocation(newPtr);
+    updateHighWaterMark();
+
+#if MY_DEBUG_ASSERT_ENABLED
+    return trackAllocation(newPtr, size);
+#else
     return newPtr;
+#endif
 }
 
-void* RuntimeStackAllocator::realloc([[maybe_unused]] void* oldPtr, const size_t size, [[maybe_unused]] const size_t alignment)
+#if MY_DEBUG_ASSERT_ENABLED
+void* RuntimeStackAllocator::trackAllocation(void* blockPtr, size_t size)
 {
-    // can not realloc, because don't known allocation actual size
-    MY_DEBUG_ASSERT(oldPtr == nullptr, "Reallocation for stack allocator is not implemented");
-    return alloc(size, alignment);
+    MY_DEBUG_ASSERT(size <= std::numeric_limits<uint32_t>::max());
 
-    // constexpr size_t
+    RuntimeStackGuard* const guard = s_currentStackGuard;
+    new(blockPtr) DebugAllocationHeader{guard, static_cast<uint32_t>(size), AllocatedCanary};
 
-    // MY_DEBUG_ASSERT(oldPtr == nullptr, "Reallocation for stack allocator is not implemented");
-    // MY_DEBUG_ASSERT(isPowerOf2(alignment), "Alignment must be power of two");
-    // MY_DEBUG_ASSERT(alignment <= MaxAlignment, "Requested alignment ({}) exceed max alignment ({})", alignment, MaxAlignment);
+    std::byte* const clientPtr = reinterpret_cast<std::byte*>(blockPtr) + DebugHeaderSize;
+    memcpy(clientPtr + size, &TailCanary, DebugTailSize);
 
-    // const size_t d = m_allocOffset % alignment;
-    // const size_t padding = d == 0 ? 0 : (alignment - d);
-    // const size_t allocationSize = alignedSize(size, alignment) + padding;
-    // const size_t newAllocOffset = m_allocOffset + allocationSize;
+    if (guard)
+    {
+        ++guard->m_liveAllocationsCount;
+    }
 
-    // if (!m_allocatedRegion)
-    // {
-    //     m_allocatedRegion = m_pageAllocator->allocPages(allocationSize);
-    //     MY_FATAL(m_allocatedRegion);
-    // }
-    // else if (m_allocatedRegion.size() < newAllocOffset)
-    // {
-    //     IHostMemory::MemRegion nextRegion = m_pageAllocator->allocPages(allocationSize);
-    //     MY_FATAL(nextRegion);
-    //     MY_FATAL(IHostMemory::MemRegion::isAdjacent(m_allocatedRegion, nextRegion));
+    return clientPtr;
+}
 
-    //     m_allocatedRegion += std::move(nextRegion);
-    // }
+bool RuntimeStackAllocator::isLiveAllocation(const void* blockPtr) const
+{
+    if (m_segments.empty())
+    {
+        return false;
+    }
 
-    // void* const newPtr = reinterpret_cast<std::byte*>(m_allocatedRegion.basePtr()) + m_allocOffset + padding;
-    // m_allocOffset = newAllocOffset;
+    for (size_t i = 0; i <= m_currentSegment; ++i)
+    {
+        const Segment& segment = m_segments[i];
+        if (segment.contains(blockPtr))
+        {
+            const uintptr_t blockOffset = segment.baseOffset + static_cast<uintptr_t>(reinterpret_cast<const std::byte*>(blockPtr) - segment.basePtr());
+            const uintptr_t endOffset = i == m_currentSegment ? m_allocOffset : segment.endOffset;
+            return blockOffset < endOffset;
+        }
+    }
+
+    for (const HeapBlock* block = m_heapBlocks; block; block = block->next)
+    {
+        if (block->ptr == blockPtr)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void RuntimeStackAllocator::untrackAllocation(void* ptr)
+{
+    auto* const header = reinterpret_cast<DebugAllocationHeader*>(reinterpret_cast<std::byte*>(ptr) - DebugHeaderSize);
+
+    if (!isLiveAllocation(header))
+    {
+        MY_DEBUG_FAILURE("Runtime stack allocation is freed after its scope has been left");
+        return;
+    }
+
+    if (header->canary == FreedCanary)
+    {
+        MY_DEBUG_FAILURE("Runtime stack allocation is freed twice");
+        return;
+    }
+
+    if (header->canary != AllocatedCanary)
+    {
+        MY_DEBUG_FAILURE("Runtime stack allocation header is corrupted (or pointer is not allocated by the runtime stack)");
+        return;
+    }
+
+    const std::byte* const tailPtr = reinterpret_cast<const std::byte*>(ptr) + header->size;
+    MY_DEBUG_ASSERT(memcmp(tailPtr, &TailCanary, DebugTailSize) == 0, "Runtime stack allocation overrun, block size: ({})", header->size);
 
-    // notifyAllocation(newPtr);
-    // return newPtr;
+    header->canary = FreedCanary;
+
+    if (RuntimeStackGuard* const guard = header->guard)
+    {
+        MY_DEBUG_ASSERT(guard->m_liveAllocationsCount > 0);
+        --guard->m_liveAllocationsCount;
+    }
+}
+#endif
+
+void* RuntimeStackAllocator::realloc([[maybe_unused]] void* oldPtr, const size_t size, [[maybe_unused]] const size_t alignment)
+{
+    // can not realloc, because don't known allocation actual size
+    MY_DEBUG_ASSERT(oldPtr == nullptr, "Reallocation for stack allocator is not implemented");
+    return alloc(size, alignment);
 }
 
-void RuntimeStackAllocator::free(void* ptr, [[maybe_unused]] size_t size, [[maybe_unused]] size_t alignment)
+void RuntimeStackAllocator::free([[maybe_unused]] void* ptr, [[maybe_unused]] size_t size, [[maybe_unused]] size_t alignment)
 {
     MY_DEBUG_ASSERT(checkAllocAlignment(alignment, MaxAlignment), "Invalid alignment");
+#if MY_DEBUG_ASSERT_ENABLED
     if (ptr)
     {
-        [[maybe_unused]] const auto offset = reinterpret_cast<uintptr_t>(ptr);
-        [[maybe_unused]] const auto base = reinterpret_cast<uintptr_t>(m_allocatedRegion.basePtr());
-
-        MY_DEBUG_ASSERT(base <= offset && offset < base + m_allocatedRegion.size());
-        notifyFree(ptr);
+        untrackAllocation(ptr);
     }
+#endif
 }
 
 RuntimeStackGuard::RuntimeStackGuard() :
@@ -246,9 +384,9 @@ RuntimeStackGuard::RuntimeStackGuard() :
     }
 }
 
-RuntimeStackGuard::RuntimeStackGuard(Kilobyte size) :
+RuntimeStackGuard::RuntimeStackGuard(Kilobyte size, bool heapFallback) :
     m_prev(std::exchange(s_currentStackGuard, this)),
-    m_allocator(rtti::createInstance<RuntimeStackAllocator, IAllocator>(size)),
+    m_allocator(rtti::createInstance<RuntimeStackAllocator, IAllocator>(size, heapFallback)),
     m_top(m_allocator->as<const RuntimeStackAllocator&>().getOffset())
 {
 }
@@ -256,7 +394,7 @@ RuntimeStackGuard::RuntimeStackGuard(Kilobyte size) :
 RuntimeStackGuard::~RuntimeStackGuard()
 {
 #if MY_DEBUG_ASSERT_ENABLED
-    checkNonFreedPointers(m_top);
+    MY_DEBUG_ASSERT(m_liveAllocationsCount == 0, "There is ({}) non freed allocations", m_liveAllocationsCount);
 #endif
     if (m_allocator)
     {
@@ -280,4 +418,14 @@ IAllocator& RuntimeStackGuard::getAllocator()
 
     return getDefaultAllocator();
 }
+
+size_t RuntimeStackGuard::getThreadHighWaterMark()
+{
+    return s_threadHighWaterMark;
+}
+
+void RuntimeStackGuard::resetThreadHighWaterMark()
+{
+    s_threadHighWaterMark = 0;
+}
 }  // namespace my
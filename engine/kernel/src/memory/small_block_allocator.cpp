@@ -0,0 +1,807 @@
+// #my_engine_source_file
+
+#include "my/memory/small_block_allocator.h"
+
+#include "small_block_allocator_impl.h"
+#include "my/memory/internal/allocator_base.h"
+#include "my/rtti/rtti_impl.h"
+
+namespace my {
+namespace {
+
+constexpr size_t SmallBlockAlignment = 16;
+constexpr size_t SmallBlockMaxSize = Kilobyte(32);
+
+constexpr size_t SpanShift = 18;
+constexpr size_t SpanSize = size_t{1} << SpanShift;  // 256 Kb
+constexpr size_t SegmentSpanCount = 32;
+constexpr size_t SegmentSize = SpanSize * SegmentSpanCount;  // 8 Mb
+
+// Fully unused segments that are kept by allocator instead of returning it to the host memory.
+constexpr size_t SpareSegmentsCount = 1;
+
+constexpr size_t LinearSizeClassCount = 8;
+constexpr size_t LinearSizeClassMax = LinearSizeClassCount * SmallBlockAlignment;  // 128
+constexpr size_t SubClassesPerPowerOf2 = 4;
+constexpr size_t SizeClassCount = LinearSizeClassCount + (std::bit_width(SmallBlockMaxSize - 1) - std::bit_width(LinearSizeClassMax - 1)) * SubClassesPerPowerOf2;
+
+/**
+    Size classes: 16 .. 128 with 16 bytes step, then four classes per each power of two up to 32 Kb.
+ */
+constexpr inline size_t getSizeClass(size_t size)
+{
+    if (size <= LinearSizeClassMax)
+    {
+        return size == 0 ? 0 : (size - 1) / SmallBlockAlignment;
+    }
+
+    const size_t log2 = std::bit_width(size - 1) - 1;
+    const size_t subClass = ((size - 1) >> (log2 - 2)) - SubClassesPerPowerOf2;
+
+    return LinearSizeClassCount + (log2 - 7) * SubClassesPerPowerOf2 + subClass;
+}
+
+constexpr inline size_t getSizeClassBlockSize(size_t sizeClass)
+{
+    if (sizeClass < LinearSizeClassCount)
+    {
+        return (sizeClass + 1) * SmallBlockAlignment;
+    }
+
+    const size_t log2 = (sizeClass - LinearSizeClassCount) / SubClassesPerPowerOf2 + 7;
+    const size_t subClass = (sizeClass - LinearSizeClassCount) % SubClassesPerPowerOf2;
+
+    return (subClass + SubClassesPerPowerOf2 + 1) << (log2 - 2);
+}
+
+static_assert(SizeClassCount == 40);
+static_assert(getSizeClassBlockSize(SizeClassCount - 1) == SmallBlockMaxSize);
+static_assert(getSizeClass(SmallBlockMaxSize) == SizeClassCount - 1);
+static_assert(getSizeClass(129) == LinearSizeClassCount && getSizeClassBlockSize(LinearSizeClassCount) == 160);
+static_assert(getSizeClass(257) == getSizeClass(320) && getSizeClassBlockSize(getSizeClass(257)) == 320);
+
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+struct ThreadHeap;
+struct Segment;
+
+/**
+    Span is a SpanSize aligned memory range that serves blocks of the single size class.
+    Span metadata is kept out of band (within the owner segment) and looked up through the page map.
+ */
+struct Span
+{
+    Segment* segment = nullptr;
+    std::byte* basePtr = nullptr;
+    ThreadHeap* heap = nullptr;
+
+    // Intrusive link within heap's list of spans that have available blocks.
+    Span* prev = nullptr;
+    Span* next = nullptr;
+    bool isListed = false;
+
+    FreeBlock* freeList = nullptr;
+    uint32_t sizeClass = 0;
+    uint32_t blockSize = 0;
+    uint32_t capacity = 0;
+    uint32_t carvedCount = 0;
+    uint32_t usedCount = 0;
+
+    bool isFull() const
+    {
+        return usedCount == capacity;
+    }
+
+    void* allocateBlock()
+    {
+        MY_DEBUG_ASSERT(!isFull());
+
+        void* ptr = nullptr;
+        if (freeList)
+        {
+            ptr = std::exchange(freeList, freeList->next);
+        }
+        else
+        {
+            MY_DEBUG_ASSERT(carvedCount < capacity);
+            ptr = basePtr + static_cast<size_t>(carvedCount++) * blockSize;
+        }
+
+        ++usedCount;
+        return ptr;
+    }
+
+    void freeBlock(void* ptr)
+    {
+        MY_DEBUG_ASSERT(usedCount > 0);
+        MY_DEBUG_ASSERT((reinterpret_cast<std::byte*>(ptr) - basePtr) % blockSize == 0, "Pointer does not belong to the block start");
+
+        FreeBlock* const block = reinterpret_cast<FreeBlock*>(ptr);
+        block->next = freeList;
+        freeList = block;
+        --usedCount;
+    }
+};
+
+/**
+ */
+struct Segment
+{
+    IHostMemory::MemRegion pages;
+    std::byte* basePtr = nullptr;
+    std::array<Span, SegmentSpanCount> spans;
+    std::array<uint32_t, SegmentSpanCount> freeSpans;
+    uint32_t freeSpanCount = 0;
+};
+
+/**
+    Global (process wide) two-level radix map: SpanSize granule -> Span.
+    Only granules that belong to the segments are mapped, so a missing entry means that pointer refers to a large block.
+ */
+class SpanPageMap
+{
+    static constexpr size_t AddressBits = 48;
+    static constexpr size_t IndexBits = AddressBits - SpanShift;
+    static constexpr size_t LeafBits = IndexBits / 2;
+    static constexpr size_t RootBits = IndexBits - LeafBits;
+    static constexpr size_t LeafSize = size_t{1} << LeafBits;
+    static constexpr size_t RootSize = size_t{1} << RootBits;
+
+    using Leaf = std::array<std::atomic<Span*>, LeafSize>;
+
+public:
+    static Span* find(const void* ptr)
+    {
+        const uintptr_t index = reinterpret_cast<uintptr_t>(ptr) >> SpanShift;
+        const Leaf* const leaf = s_root[(index >> LeafBits) & (RootSize - 1)].load(std::memory_order_acquire);
+
+        return leaf ? (*leaf)[index & (LeafSize - 1)].load(std::memory_order_acquire) : nullptr;
+    }
+
+    static void set(const void* ptr, Span* span)
+    {
+        const uintptr_t index = reinterpret_cast<uintptr_t>(ptr) >> SpanShift;
+        MY_DEBUG_FATAL((index >> IndexBits) == 0, "Address is out of supported range");
+
+        std::atomic<Leaf*>& leafRef = s_root[index >> LeafBits];
+        Leaf* leaf = leafRef.load(std::memory_order_acquire);
+        if (!leaf)
+        {
+            const std::lock_guard lock(s_mutex);
+            leaf = leafRef.load(std::memory_order_relaxed);
+            if (!leaf)
+            {
+                // Leafs are never released: zeroed memory is a valid (empty) leaf.
+                leaf = reinterpret_cast<Leaf*>(std::calloc(1, sizeof(Leaf)));
+                MY_FATAL(leaf);
+                leafRef.store(leaf, std::memory_order_release);
+            }
+        }
+
+        (*leaf)[index & (LeafSize - 1)].store(span, std::memory_order_release);
+    }
+
+private:
+    static inline std::array<std::atomic<Leaf*>, RootSize> s_root{};
+    static inline std::mutex s_mutex;
+};
+
+/**
+    Per-thread allocation state. Heaps are never destroyed while allocator is alive:
+    heap of the finished thread is abandoned and later adopted by the new thread,
+    so pointer to the heap (stored within the spans) is always valid for the remote free.
+ */
+struct ThreadHeap
+{
+    std::array<Span*, SizeClassCount> availableSpans{};
+    std::atomic<FreeBlock*> remoteFreeList = nullptr;
+
+    void linkSpan(Span* span)
+    {
+        MY_DEBUG_ASSERT(!span->isListed);
+
+        Span*& head = availableSpans[span->sizeClass];
+        span->prev = nullptr;
+        span->next = head;
+        if (head)
+        {
+            head->prev = span;
+        }
+        head = span;
+        span->isListed = true;
+    }
+
+    void unlinkSpan(Span* span)
+    {
+        MY_DEBUG_ASSERT(span->isListed);
+
+        if (span->prev)
+        {
+            span->prev->next = span->next;
+        }
+        else
+        {
+            availableSpans[span->sizeClass] = span->next;
+        }
+
+        if (span->next)
+        {
+            span->next->prev = span->prev;
+        }
+
+        span->prev = span->next = nullptr;
+        span->isListed = false;
+    }
+
+    void pushRemoteFree(void* ptr)
+    {
+        FreeBlock* const block = reinterpret_cast<FreeBlock*>(ptr);
+        block->next = remoteFreeList.load(std::memory_order_relaxed);
+        while (!remoteFreeList.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+};
+
+/**
+    Large blocks are allocated directly from the host memory and prefixed with the header.
+ */
+struct alignas(SmallBlockAlignment) LargeBlockHeader
+{
+    void* basePtr;
+    size_t size;
+};
+
+class SmallBlockAllocator;
+
+/**
+    Live allocators, used to hand over the heaps of the finished threads.
+ */
+struct AllocatorRegistry
+{
+    std::mutex mutex;
+    std::vector<SmallBlockAllocator*> allocators;
+
+    static AllocatorRegistry& instance()
+    {
+        // Intentionally leaked: allocator that is used as the default one can outlive any static object.
+        static AllocatorRegistry& registry = *new AllocatorRegistry;
+        return registry;
+    }
+};
+
+/**
+    Thread local cache of the heaps: one entry per allocator used by the thread.
+ */
+class ThreadHeapCache
+{
+public:
+    static constexpr size_t MaxEntries = 16;
+
+    struct Entry
+    {
+        uint64_t allocatorId = 0;
+        ThreadHeap* heap = nullptr;
+    };
+
+    ~ThreadHeapCache();
+
+    ThreadHeap* find(uint64_t allocatorId) const
+    {
+        for (size_t i = 0; i < m_count; ++i)
+        {
+            if (m_entries[i].allocatorId == allocatorId)
+            {
+                return m_entries[i].heap;
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool add(uint64_t allocatorId, ThreadHeap* heap)
+    {
+        if (m_count == MaxEntries)
+        {
+            return false;
+        }
+
+        m_entries[m_count++] = {allocatorId, heap};
+        return true;
+    }
+
+    /**
+        Removes the entries of the destroyed allocators (their heaps are already deleted).
+     */
+    template <typename IsAlive>
+    void removeDeadEntries(IsAlive isAlive)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < m_count; ++i)
+        {
+            if (isAlive(m_entries[i].allocatorId))
+            {
+                m_entries[count++] = m_entries[i];
+            }
+        }
+
+        m_count = count;
+    }
+
+private:
+    std::array<Entry, MaxEntries> m_entries;
+    size_t m_count = 0;
+};
+
+// Becomes true after thread local cache destruction: the late allocations (from other thread local destructors) are served by shared heap.
+static thread_local bool s_threadHeapCacheDestroyed = false;
+static thread_local ThreadHeapCache s_threadHeapCache;
+
+/**
+ */
+class SmallBlockAllocator final : public AllocatorWithMemResource<SmallBlockAllocator>
+{
+    MY_REFCOUNTED_CLASS(my::SmallBlockAllocator, IAllocator)
+
+public:
+    static void abandonThreadHeap(uint64_t allocatorId, ThreadHeap* heap)
+    {
+        AllocatorRegistry& registry = AllocatorRegistry::instance();
+        const std::lock_guard lock(registry.mutex);
+
+        auto iter = std::find_if(registry.allocators.begin(), registry.allocators.end(), [allocatorId](const SmallBlockAllocator* allocator)
+        {
+            return allocator->m_id == allocatorId;
+        });
+
+        if (iter != registry.allocators.end())
+        {
+            (*iter)->abandonHeap(heap);
+        }
+    }
+
+    static bool isAlive(uint64_t allocatorId)
+    {
+        AllocatorRegistry& registry = AllocatorRegistry::instance();
+        const std::lock_guard lock(registry.mutex);
+
+        return std::any_of(registry.allocators.begin(), registry.allocators.end(), [allocatorId](const SmallBlockAllocator* allocator)
+        {
+            return allocator->m_id == allocatorId;
+        });
+    }
+
+    SmallBlockAllocator(HostMemoryPtr hostMemory) :
+        m_hostMemory(std::move(hostMemory)),
+        m_id(s_nextId.fetch_add(1, std::memory_order_relaxed))
+    {
+        MY_DEBUG_ASSERT(m_hostMemory);
+
+        AllocatorRegistry& registry = AllocatorRegistry::instance();
+        const std::lock_guard lock(registry.mutex);
+        registry.allocators.push_back(this);
+    }
+
+    ~SmallBlockAllocator()
+    {
+        {
+            AllocatorRegistry& registry = AllocatorRegistry::instance();
+            const std::lock_guard lock(registry.mutex);
+            std::erase(registry.allocators, this);
+        }
+
+        for (Segment* segment : m_segments)
+        {
+            releaseSegment(segment);
+        }
+
+        for (ThreadHeap* heap : m_heaps)
+        {
+            delete heap;
+        }
+    }
+
+    void* alloc(size_t size, [[maybe_unused]] size_t align) override
+    {
+        MY_DEBUG_FATAL(checkAllocAlignment(align, SmallBlockAlignment), "Invalid alignment ({})", align);
+
+        if (size > SmallBlockMaxSize)
+        {
+            return allocateLarge(size);
+        }
+
+        const size_t sizeClass = getSizeClass(size);
+
+        if (ThreadHeap* const heap = getThreadHeap())
+        {
+            return allocateSmall(*heap, sizeClass);
+        }
+
+        const std::lock_guard lock(m_sharedHeapMutex);
+        return allocateSmall(m_sharedHeap, sizeClass);
+    }
+
+    void* realloc(void* oldPtr, size_t size, [[maybe_unused]] size_t align) override
+    {
+        MY_DEBUG_FATAL(checkAllocAlignment(align, SmallBlockAlignment), "Invalid alignment ({})", align);
+
+        if (!oldPtr)
+        {
+            return alloc(size, align);
+        }
+
+        size_t oldSize = 0;
+        if (const Span* const span = SpanPageMap::find(oldPtr))
+        {
+            if (size <= SmallBlockMaxSize && getSizeClass(size) == span->sizeClass)
+            {
+                return oldPtr;
+            }
+
+            oldSize = span->blockSize;
+        }
+        else
+        {
+            oldSize = getLargeBlockHeader(oldPtr)->size - sizeof(LargeBlockHeader);
+            if (size > SmallBlockMaxSize && size <= oldSize)
+            {
+                return oldPtr;
+            }
+        }
+
+        void* const newPtr = alloc(size, align);
+        if (newPtr)
+        {
+            memcpy(newPtr, oldPtr, std::min(size, oldSize));
+            free(oldPtr, oldSize, align);
+        }
+
+        return newPtr;
+    }
+
+    void free(void* ptr, [[maybe_unused]] size_t size, [[maybe_unused]] size_t align) override
+    {
+        MY_DEBUG_FATAL(checkAllocAlignment(align, SmallBlockAlignment), "Invalid alignment ({})", align);
+
+        if (!ptr)
+        {
+            return;
+        }
+
+        Span* const span = SpanPageMap::find(ptr);
+        if (!span)
+        {
+            freeLarge(ptr);
+            return;
+        }
+
+        MY_DEBUG_ASSERT(span->segment && span->heap, "Pointer does not belong to the allocated span");
+        MY_DEBUG_ASSERT(size == IAllocator::UnspecifiedValue || size <= span->blockSize);
+
+        if (span->heap == &m_sharedHeap)
+        {
+            const std::lock_guard lock(m_sharedHeapMutex);
+            freeSmall(m_sharedHeap, span, ptr);
+        }
+        else if (span->heap == findThreadHeap())
+        {
+            freeSmall(*span->heap, span, ptr);
+        }
+        else
+        {
+            span->heap->pushRemoteFree(ptr);
+        }
+    }
+
+    size_t getMaxAlignment() const override
+    {
+        return SmallBlockAlignment;
+    }
+
+private:
+    static LargeBlockHeader* getLargeBlockHeader(void* ptr)
+    {
+        return reinterpret_cast<LargeBlockHeader*>(ptr) - 1;
+    }
+
+    ThreadHeap* findThreadHeap() const
+    {
+        return s_threadHeapCacheDestroyed ? nullptr : s_threadHeapCache.find(m_id);
+    }
+
+    ThreadHeap* getThreadHeap()
+    {
+        if (s_threadHeapCacheDestroyed)
+        {
+            return nullptr;
+        }
+
+        if (ThreadHeap* const heap = s_threadHeapCache.find(m_id))
+        {
+            return heap;
+        }
+
+        ThreadHeap* heap = nullptr;
+        {
+            const std::lock_guard lock(m_mutex);
+            if (!m_abandonedHeaps.empty())
+            {
+                heap = m_abandonedHeaps.back();
+                m_abandonedHeaps.pop_back();
+            }
+            else
+            {
+                heap = m_heaps.emplace_back(new ThreadHeap);
+            }
+        }
+
+        if (!s_threadHeapCache.add(m_id, heap))
+        {
+            s_threadHeapCache.removeDeadEntries(&SmallBlockAllocator::isAlive);
+        }
+
+        if (!s_threadHeapCache.add(m_id, heap))
+        {
+            // Too many allocators are used by the single thread: fallback to the shared heap.
+            abandonHeap(heap);
+            return nullptr;
+        }
+
+        return heap;
+    }
+
+    void abandonHeap(ThreadHeap* heap)
+    {
+        const std::lock_guard lock(m_mutex);
+        m_abandonedHeaps.push_back(heap);
+    }
+
+    void* allocateSmall(ThreadHeap& heap, size_t sizeClass)
+    {
+        Span* span = heap.availableSpans[sizeClass];
+        if (!span)
+        {
+            collectRemoteFrees(heap);
+            span = heap.availableSpans[sizeClass];
+            if (!span)
+            {
+                span = acquireSpan(heap, sizeClass);
+                if (!span)
+                {
+                    return nullptr;
+                }
+
+                heap.linkSpan(span);
+            }
+        }
+
+        void* const ptr = span->allocateBlock();
+        if (span->isFull())
+        {
+            heap.unlinkSpan(span);
+        }
+
+        MY_DEBUG_ASSERT(reinterpret_cast<uintptr_t>(ptr) % SmallBlockAlignment == 0);
+        return ptr;
+    }
+
+    void freeSmall(ThreadHeap& heap, Span* span, void* ptr)
+    {
+        const bool wasFull = span->isFull();
+        span->freeBlock(ptr);
+
+        if (wasFull)
+        {
+            heap.linkSpan(span);
+        }
+
+        // Keep at least one span per size class to avoid alloc/free ping-pong through the shared span pool.
+        if (span->usedCount == 0 && (span->prev || span->next))
+        {
+            heap.unlinkSpan(span);
+            releaseSpan(span);
+        }
+    }
+
+    void collectRemoteFrees(ThreadHeap& heap)
+    {
+        FreeBlock* block = heap.remoteFreeList.exchange(nullptr, std::memory_order_acquire);
+        while (block)
+        {
+            FreeBlock* const next = block->next;
+            freeSmall(heap, SpanPageMap::find(block), block);
+            block = next;
+        }
+    }
+
+    Span* acquireSpan(ThreadHeap& heap, size_t sizeClass)
+    {
+        const std::lock_guard lock(m_mutex);
+
+        Segment* segment = nullptr;
+        for (Segment* const s : m_segments)
+        {
+            if (s->freeSpanCount > 0)
+            {
+                segment = s;
+                // Prefer partially used segments: fully unused ones can be returned to the host memory.
+                if (s->freeSpanCount < SegmentSpanCount)
+                {
+                    break;
+                }
+            }
+        }
+
+        if (!segment)
+        {
+            segment = allocateSegment();
+            if (!segment)
+            {
+                return nullptr;
+            }
+        }
+        else if (segment->freeSpanCount == SegmentSpanCount)
+        {
+            MY_DEBUG_ASSERT(m_unusedSegmentCount > 0);
+            --m_unusedSegmentCount;
+        }
+
+        Span* const span = &segment->spans[segment->freeSpans[--segment->freeSpanCount]];
+        MY_DEBUG_ASSERT(span->heap == nullptr);
+
+        span->heap = &heap;
+        span->freeList = nullptr;
+        span->sizeClass = static_cast<uint32_t>(sizeClass);
+        span->blockSize = static_cast<uint32_t>(getSizeClassBlockSize(sizeClass));
+        span->capacity = static_cast<uint32_t>(SpanSize / span->blockSize);
+        span->carvedCount = 0;
+        span->usedCount = 0;
+
+        return span;
+    }
+
+    void releaseSpan(Span* span)
+    {
+        MY_DEBUG_ASSERT(span->usedCount == 0);
+        MY_DEBUG_ASSERT(!span->isListed);
+
+        const std::lock_guard lock(m_mutex);
+
+        Segment* const segment = span->segment;
+        span->heap = nullptr;
+        span->freeList = nullptr;
+        segment->freeSpans[segment->freeSpanCount++] = static_cast<uint32_t>(span - segment->spans.data());
+
+        if (segment->freeSpanCount < SegmentSpanCount)
+        {
+            return;
+        }
+
+        if (m_unusedSegmentCount < SpareSegmentsCount)
+        {
+            ++m_unusedSegmentCount;
+            return;
+        }
+
+        std::erase(m_segments, segment);
+        releaseSegment(segment);
+    }
+
+    Segment* allocateSegment()
+    {
+        // Host memory does not guarantee span alignment: reserve extra span to align segment's base.
+        IHostMemory::MemRegion pages = m_hostMemory->allocPages(SegmentSize + SpanSize);
+        if (!pages)
+        {
+            return nullptr;
+        }
+
+        Segment* const segment = new Segment;
+        segment->basePtr = reinterpret_cast<std::byte*>(alignedSize(reinterpret_cast<uintptr_t>(pages.basePtr()), SpanSize));
+        segment->pages = std::move(pages);
+
+        for (size_t i = 0; i < SegmentSpanCount; ++i)
+        {
+            Span& span = segment->spans[i];
+            span.segment = segment;
+            span.basePtr = segment->basePtr + i * SpanSize;
+
+            // Spans are taken in the address order.
+            segment->freeSpans[i] = static_cast<uint32_t>(SegmentSpanCount - 1 - i);
+            SpanPageMap::set(span.basePtr, &span);
+        }
+
+        segment->freeSpanCount = SegmentSpanCount;
+
+        // The segment is used right away: it is counted as unused only when all its spans are released.
+        m_segments.push_back(segment);
+
+        return segment;
+    }
+
+    void releaseSegment(Segment* segment)
+    {
+        for (Span& span : segment->spans)
+        {
+            SpanPageMap::set(span.basePtr, nullptr);
+        }
+
+        m_hostMemory->freePages(std::move(segment->pages));
+        delete segment;
+    }
+
+    void* allocateLarge(size_t size)
+    {
+        IHostMemory::MemRegion pages = m_hostMemory->allocPages(sizeof(LargeBlockHeader) + size);
+        if (!pages)
+        {
+            return nullptr;
+        }
+
+        MY_DEBUG_ASSERT(reinterpret_cast<uintptr_t>(pages.basePtr()) % SmallBlockAlignment == 0);
+
+        LargeBlockHeader* const header = reinterpret_cast<LargeBlockHeader*>(pages.basePtr());
+        header->basePtr = pages.basePtr();
+        header->size = pages.size();
+
+        return header + 1;
+    }
+
+    void freeLarge(void* ptr)
+    {
+        const LargeBlockHeader* const header = getLargeBlockHeader(ptr);
+        MY_DEBUG_ASSERT(header->basePtr == header, "Pointer is not allocated by this allocator");
+
+        m_hostMemory->freePages(IHostMemory::MemRegion{header->basePtr, header->size});
+    }
+
+    static inline std::atomic<uint64_t> s_nextId = 1;
+
+    const HostMemoryPtr m_hostMemory;
+    const uint64_t m_id;
+
+    std::mutex m_mutex;
+    std::vector<Segment*> m_segments;
+    std::vector<ThreadHeap*> m_heaps;
+    std::vector<ThreadHeap*> m_abandonedHeaps;
+    size_t m_unusedSegmentCount = 0;
+
+    std::mutex m_sharedHeapMutex;
+    ThreadHeap m_sharedHeap;
+};
+
+ThreadHeapCache::~ThreadHeapCache()
+{
+    s_threadHeapCacheDestroyed = true;
+
+    for (size_t i = 0; i < m_count; ++i)
+    {
+        SmallBlockAllocator::abandonThreadHeap(m_entries[i].allocatorId, m_entries[i].heap);
+    }
+}
+
+}  // namespace
+
+AllocatorPtr createSmallBlockAllocator(HostMemoryPtr hostMemory)
+{
+    if (!hostMemory)
+    {
+        hostMemory = createCrtHostMemory(true);
+    }
+
+    return rtti::createInstance<SmallBlockAllocator>(std::move(hostMemory));
+}
+
+namespace mem_detail {
+
+AllocatorPtr createSmallBlockAllocatorSingleton()
+{
+    return rtti::createInstanceSingleton<SmallBlockAllocator, IAllocator>(createCrtHostMemory(true));
+}
+
+}  // namespace mem_detail
+
+}  // namespace my
@@ -0,0 +1,12 @@
+// #my_engine_source_file
+#pragma once
+#include "my/memory/allocator.h"
+
+namespace my::mem_detail {
+
+/**
+    Creates allocator instance within the static storage: used when small block allocator is selected as the kernel default allocator.
+ */
+AllocatorPtr createSmallBlockAllocatorSingleton();
+
+}  // namespace my::mem_detail
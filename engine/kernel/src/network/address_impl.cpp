@@ -114,6 +114,31 @@ Result<Address> ParseIpcAddress(std::string_view line)
     return Address{};
 }
 
+bool isSameAddress(IAddress* lhs, IAddress* rhs)
+{
+    if (lhs == rhs)
+    {
+        return true;
+    }
+
+    const InetAddress* const lhsInet = lhs ? lhs->as<const InetAddress*>() : nullptr;
+    const InetAddress* const rhsInet = rhs ? rhs->as<const InetAddress*>() : nullptr;
+
+    // sockaddr is zero initialized when created, so bytes can be compared directly.
+    return lhsInet && rhsInet && memcmp(lhsInet->getSockAddr(), rhsInet->getSockAddr(), sizeof(sockaddr)) == 0;
+}
+
+size_t getAddressHash(IAddress* address)
+{
+    if (const InetAddress* const inetAddress = address ? address->as<const InetAddress*>() : nullptr)
+    {
+        const std::string_view bytes{reinterpret_cast<const char*>(inetAddress->getSockAddr()), sizeof(sockaddr)};
+        return std::hash<std::string_view>{}(bytes);
+    }
+
+    return std::hash<IAddress*>{}(address);
+}
+
 }  // namespace
 
 InetAddress::InetAddress(sockaddr sockAddr) :
@@ -219,6 +244,36 @@ Address::iterator Address::end() const
     return {};
 }
 
+bool Address::operator==(const Address& other) const
+{
+    const size_t size = getSize();
+    if (size != other.getSize())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (!isSameAddress((*this)[i], other[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t Address::getHash() const
+{
+    size_t hash = 0;
+    for (size_t i = 0, size = getSize(); i < size; ++i)
+    {
+        hash = hash * 31 + getAddressHash((*this)[i]);
+    }
+
+    return hash;
+}
+
 AddressIterator::AddressIterator(const Address* addr_in, size_t index_in) :
     address(addr_in),
     index(index_in)
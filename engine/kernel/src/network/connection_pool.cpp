@@ -0,0 +1,612 @@
+// #my_engine_source_file
+#include "my/network/connection_pool.h"
+
+#include "my/async/task.h"
+#include "my/rtti/rtti_impl.h"
+#include "my/rtti/weak_ptr.h"
+#include "my/runtime/internal/runtime_object_registry.h"
+#include "my/utils/scope_guard.h"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+using namespace my::async;
+
+namespace my::network {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void disposeStream(io::IAsyncStream& stream)
+{
+    if (IDisposable* const disposable = stream.as<IDisposable*>())
+    {
+        disposable->dispose();
+    }
+}
+
+/**
+    Pooled connection with the (optional) read that is issued while the connection is idle:
+    completed read tells that the connection is closed by the remote side (or failed), otherwise it is given to the next user of the connection.
+ */
+struct Connection
+{
+    io::AsyncStreamPtr stream;
+    std::optional<Task<Buffer>> pendingRead;
+    std::shared_ptr<std::atomic<bool>> isClosedWhileIdle;
+
+    static Task<Buffer> readWhileIdle(io::AsyncStreamPtr stream, std::shared_ptr<std::atomic<bool>> isClosed)
+    {
+        Result<Buffer> data = co_await stream->read().doTry();
+        if (!data || data->size() == 0)
+        {
+            isClosed->store(true);
+        }
+
+        if (!data)
+        {
+            co_return data.getError();
+        }
+
+        co_return std::move(*data);
+    }
+
+    void startIdleRead()
+    {
+        MY_DEBUG_ASSERT(stream);
+        isClosedWhileIdle = std::make_shared<std::atomic<bool>>(false);
+        pendingRead.emplace(readWhileIdle(stream, isClosedWhileIdle));
+    }
+
+    bool isClosed() const
+    {
+        return isClosedWhileIdle && isClosedWhileIdle->load();
+    }
+
+    void close()
+    {
+        if (pendingRead)
+        {
+            pendingRead->detach();
+            pendingRead.reset();
+        }
+
+        if (stream)
+        {
+            disposeStream(*stream);
+            stream.reset();
+        }
+    }
+};
+
+}  // namespace
+
+class ConnectionPool;
+
+/**
+    Lease of the pooled connection.
+ */
+class PooledStream final : public io::IAsyncStream,
+                           public IEndPoint,
+                           public IDisposable
+{
+    MY_REFCOUNTED_CLASS(my::network::PooledStream, io::IAsyncStream, IEndPoint, IDisposable)
+
+public:
+    PooledStream(Ptr<ConnectionPool> pool, Address address, Connection connection);
+
+    ~PooledStream();
+
+    void dispose() override;
+
+    size_t getPosition() const override
+    {
+        return 0;
+    }
+
+    size_t setPosition(io::OffsetOrigin, int64_t) override
+    {
+        MY_DEBUG_FAILURE("PooledStream::setPosition() not supported");
+        return 0;
+    }
+
+    void flush() override
+    {
+    }
+
+    bool canSeek() const override
+    {
+        return false;
+    }
+
+    bool canRead() const override
+    {
+        return true;
+    }
+
+    bool canWrite() const override
+    {
+        return true;
+    }
+
+    Task<Buffer> read() override;
+
+    Task<> write(ReadOnlyBuffer buffer) override;
+
+    Address getLocalAddress() const override;
+
+    Address getRemoteAddress() const override;
+
+private:
+    io::AsyncStreamPtr getStream() const;
+
+    void releaseConnection();
+
+    const Ptr<ConnectionPool> m_pool;
+    const Address m_address;
+    Connection m_connection;
+    std::atomic<bool> m_isBroken = false;
+    mutable std::mutex m_mutex;
+};
+
+/**
+ */
+class ConnectionPool final : public IConnectionPool
+{
+    MY_REFCOUNTED_CLASS(my::network::ConnectionPool, IConnectionPool)
+
+public:
+    ConnectionPool(ConnectionPoolSettings settings) :
+        m_settings(settings),
+        m_runtimeReg{*this}
+    {
+        MY_DEBUG_ASSERT(m_settings.maxConnectionsPerHost > 0);
+    }
+
+    ~ConnectionPool()
+    {
+        dispose();
+    }
+
+    void dispose() override
+    {
+        std::vector<Connection> idleConnections;
+        std::vector<std::shared_ptr<Waiter>> waiters;
+        {
+            const std::lock_guard lock(m_mutex);
+            if (m_isDisposed)
+            {
+                return;
+            }
+
+            m_isDisposed = true;
+            for (auto& [address, host] : m_hosts)
+            {
+                host.connectionsCount -= host.idle.size();
+                for (IdleConnection& idle : host.idle)
+                {
+                    idleConnections.push_back(std::move(idle.connection));
+                }
+
+                // served waiters are not rejected again by the expiration
+                for (const std::shared_ptr<Waiter>& waiter : host.waiters)
+                {
+                    waiter->isServed = true;
+                    waiters.push_back(waiter);
+                }
+
+                host.idle.clear();
+                host.waiters.clear();
+            }
+        }
+
+        for (Connection& connection : idleConnections)
+        {
+            connection.close();
+        }
+
+        for (const std::shared_ptr<Waiter>& waiter : waiters)
+        {
+            waiter->source.reject(MakeError("Connection pool is disposed"));
+        }
+    }
+
+    Task<io::AsyncStreamPtr> acquire(Address address, Expiration expiration) override
+    {
+        MY_DEBUG_ASSERT(address);
+
+        const Ptr<ConnectionPool> self{this};
+
+        Connection connection;
+        std::shared_ptr<Waiter> waiter;
+        std::vector<Connection> closedConnections;
+        bool isDisposed = false;
+        {
+            const std::lock_guard lock(m_mutex);
+            if (m_isDisposed)
+            {
+                isDisposed = true;
+            }
+            else
+            {
+                Host& host = m_hosts[address];
+
+                // Most recently used connection first: the rest are more likely to be evicted by the idle timeout.
+                while (!host.idle.empty() && !connection.stream)
+                {
+                    Connection idleConnection = std::move(host.idle.front().connection);
+                    host.idle.pop_front();
+
+                    if (idleConnection.isClosed())
+                    {
+                        --host.connectionsCount;
+                        closedConnections.push_back(std::move(idleConnection));
+                    }
+                    else
+                    {
+                        connection = std::move(idleConnection);
+                    }
+                }
+
+                if (!connection.stream)
+                {
+                    if (host.connectionsCount < m_settings.maxConnectionsPerHost)
+                    {
+                        ++host.connectionsCount;
+                    }
+                    else
+                    {
+                        waiter = std::make_shared<Waiter>();
+                        host.waiters.push_back(waiter);
+                    }
+                }
+            }
+        }
+
+        for (Connection& closedConnection : closedConnections)
+        {
+            closedConnection.close();
+        }
+
+        if (isDisposed)
+        {
+            co_return MakeError("Connection pool is disposed");
+        }
+
+        if (waiter)
+        {
+            Task<Connection> waitTask = waiter->source.getTask();
+            if (!co_await whenAny(expiration, waitTask))
+            {
+                bool isCancelled = false;
+                {
+                    const std::lock_guard lock(m_mutex);
+                    if (!waiter->isServed)
+                    {
+                        m_hosts[address].waiters.remove(waiter);
+                        isCancelled = true;
+                    }
+                }
+
+                if (isCancelled)
+                {
+                    waiter->source.reject(MakeError("Connection wait is expired"));
+                    [[maybe_unused]] Result<Connection> result = co_await waitTask.doTry();
+                    co_return MakeError("Connection wait is expired");
+                }
+            }
+
+            // Released connection or the free slot (empty connection) to establish the new one.
+            connection = co_await waitTask;
+        }
+
+        if (!connection.stream)
+        {
+            Result<io::AsyncStreamPtr> stream = co_await network::connect(address, {}, expiration).doTry();
+            if (!stream || !*stream)
+            {
+                releaseConnection(address, Connection{}, true);
+                co_return stream ? MakeError("Can not connect to the address") : stream.getError();
+            }
+
+            connection.stream = std::move(*stream);
+        }
+
+        co_return rtti::createInstance<PooledStream, io::IAsyncStream>(self, std::move(address), std::move(connection));
+    }
+
+    ConnectionPoolStats getStats(const Address& address) const override
+    {
+        const std::lock_guard lock(m_mutex);
+        const auto host = m_hosts.find(address);
+        if (host == m_hosts.end())
+        {
+            return {};
+        }
+
+        return {
+            .connectionsCount = host->second.connectionsCount,
+            .idleCount = host->second.idle.size(),
+            .waitersCount = host->second.waiters.size()};
+    }
+
+    /**
+        Returns the connection to the pool (or closes it when broken): the first waiter receives the connection (or the free slot).
+     */
+    void releaseConnection(const Address& address, Connection connection, bool isBroken)
+    {
+        std::shared_ptr<Waiter> waiter;
+        Connection closedConnection;
+        {
+            const std::lock_guard lock(m_mutex);
+            const auto hostIter = m_hosts.find(address);
+            MY_DEBUG_FATAL(hostIter != m_hosts.end());
+            Host& host = hostIter->second;
+
+            if (isBroken || m_isDisposed || !connection.stream)
+            {
+                MY_DEBUG_ASSERT(host.connectionsCount > 0);
+                --host.connectionsCount;
+                closedConnection = std::move(connection);
+                connection = {};
+
+                if (!host.waiters.empty())
+                {
+                    ++host.connectionsCount;
+                    waiter = popWaiter(host);
+                }
+            }
+            else if (!host.waiters.empty())
+            {
+                waiter = popWaiter(host);
+            }
+            else
+            {
+                if (!connection.pendingRead)
+                {
+                    connection.startIdleRead();
+                }
+
+                host.idle.push_front(IdleConnection{std::move(connection), Clock::now()});
+            }
+
+            if (host.connectionsCount == 0 && host.waiters.empty())
+            {
+                m_hosts.erase(hostIter);
+            }
+        }
+
+        // Closing and resolving the waiter can resume the continuations: must not be done under the lock.
+        closedConnection.close();
+
+        if (waiter)
+        {
+            waiter->source.resolve(std::move(connection));
+        }
+    }
+
+    void startEviction()
+    {
+        using namespace std::chrono_literals;
+
+        const std::chrono::milliseconds interval = std::clamp<std::chrono::milliseconds>(m_settings.idleTimeout / 4, 10ms, 5'000ms);
+        evictionLoop(WeakPtr<ConnectionPool>{Ptr<ConnectionPool>{this}}, interval).detach();
+    }
+
+private:
+    struct IdleConnection
+    {
+        Connection connection;
+        Clock::time_point idleSince;
+    };
+
+    struct Waiter
+    {
+        TaskSource<Connection> source;
+        bool isServed = false;
+    };
+
+    struct Host
+    {
+        size_t connectionsCount = 0;
+        std::list<IdleConnection> idle;
+        std::list<std::shared_ptr<Waiter>> waiters;
+    };
+
+    static std::shared_ptr<Waiter> popWaiter(Host& host)
+    {
+        std::shared_ptr<Waiter> waiter = std::move(host.waiters.front());
+        host.waiters.pop_front();
+        waiter->isServed = true;
+        return waiter;
+    }
+
+    static Task<> evictionLoop(WeakPtr<ConnectionPool> poolRef, std::chrono::milliseconds interval)
+    {
+        while (true)
+        {
+            co_await interval;
+
+            Ptr<ConnectionPool> pool = poolRef.acquire();
+            if (!pool || !pool->evictIdleConnections())
+            {
+                break;
+            }
+        }
+    }
+
+    /**
+        Closes connections that are idle for too long or closed by the remote side. Returns false if the pool is disposed.
+     */
+    bool evictIdleConnections()
+    {
+        const Clock::time_point now = Clock::now();
+        std::vector<Connection> evictedConnections;
+        {
+            const std::lock_guard lock(m_mutex);
+            if (m_isDisposed)
+            {
+                return false;
+            }
+
+            for (auto hostIter = m_hosts.begin(); hostIter != m_hosts.end();)
+            {
+                Host& host = hostIter->second;
+                for (auto idle = host.idle.begin(); idle != host.idle.end();)
+                {
+                    if (now - idle->idleSince >= m_settings.idleTimeout || idle->connection.isClosed())
+                    {
+                        evictedConnections.push_back(std::move(idle->connection));
+                        idle = host.idle.erase(idle);
+                        --host.connectionsCount;
+                    }
+                    else
+                    {
+                        ++idle;
+                    }
+                }
+
+                hostIter = host.connectionsCount == 0 && host.waiters.empty() ? m_hosts.erase(hostIter) : std::next(hostIter);
+            }
+        }
+
+        for (Connection& connection : evictedConnections)
+        {
+            connection.close();
+        }
+
+        return true;
+    }
+
+    const ConnectionPoolSettings m_settings;
+    std::unordered_map<Address, Host> m_hosts;
+    bool m_isDisposed = false;
+    mutable std::mutex m_mutex;
+    RuntimeObjectRegistration m_runtimeReg;
+};
+
+PooledStream::PooledStream(Ptr<ConnectionPool> pool, Address address, Connection connection) :
+    m_pool(std::move(pool)),
+    m_address(std::move(address)),
+    m_connection(std::move(connection))
+{
+    MY_DEBUG_ASSERT(m_pool);
+    MY_DEBUG_ASSERT(m_connection.stream);
+}
+
+PooledStream::~PooledStream()
+{
+    releaseConnection();
+}
+
+void PooledStream::dispose()
+{
+    m_isBroken = true;
+    releaseConnection();
+}
+
+void PooledStream::releaseConnection()
+{
+    Connection connection;
+    {
+        const std::lock_guard lock(m_mutex);
+        connection = std::move(m_connection);
+        m_connection = {};
+    }
+
+    if (connection.stream)
+    {
+        m_pool->releaseConnection(m_address, std::move(connection), m_isBroken);
+    }
+}
+
+io::AsyncStreamPtr PooledStream::getStream() const
+{
+    const std::lock_guard lock(m_mutex);
+    return m_connection.stream;
+}
+
+Task<Buffer> PooledStream::read()
+{
+    std::optional<Task<Buffer>> pendingRead;
+    io::AsyncStreamPtr stream;
+    {
+        const std::lock_guard lock(m_mutex);
+        stream = m_connection.stream;
+        pendingRead = std::exchange(m_connection.pendingRead, std::nullopt);
+    }
+
+    if (!stream)
+    {
+        co_return MakeError("Object disposed");
+    }
+
+    this->addRef();
+    scope_on_leave
+    {
+        this->releaseRef();
+    };
+
+    // The read that was issued while the connection was idle is completed by the first read of the new user.
+    Task<Buffer> readTask = pendingRead ? std::move(*pendingRead) : stream->read();
+    Result<Buffer> data = co_await readTask.doTry();
+    if (!data || data->size() == 0)
+    {
+        m_isBroken = true;
+    }
+
+    if (!data)
+    {
+        co_return data.getError();
+    }
+
+    co_return std::move(*data);
+}
+
+Task<> PooledStream::write(ReadOnlyBuffer buffer)
+{
+    io::AsyncStreamPtr stream = getStream();
+    if (!stream)
+    {
+        co_yield MakeError("Object disposed");
+    }
+
+    this->addRef();
+    scope_on_leave
+    {
+        this->releaseRef();
+    };
+
+    if (Result<> result = co_await stream->write(std::move(buffer)).doTry(); !result)
+    {
+        m_isBroken = true;
+        co_yield result.getError();
+    }
+}
+
+Address PooledStream::getLocalAddress() const
+{
+    const io::AsyncStreamPtr stream = getStream();
+    const IEndPoint* const endPoint = stream ? stream->as<const IEndPoint*>() : nullptr;
+    return endPoint ? endPoint->getLocalAddress() : Address{};
+}
+
+Address PooledStream::getRemoteAddress() const
+{
+    const io::AsyncStreamPtr stream = getStream();
+    const IEndPoint* const endPoint = stream ? stream->as<const IEndPoint*>() : nullptr;
+    return endPoint ? endPoint->getRemoteAddress() : m_address;
+}
+
+ConnectionPoolPtr createConnectionPool(ConnectionPoolSettings settings)
+{
+    Ptr<ConnectionPool> pool = rtti::createInstance<ConnectionPool>(settings);
+    pool->startEviction();
+    return pool;
+}
+
+}  // namespace my::network
@@ -0,0 +1,530 @@
+// #my_engine_source_file
+#include "datagram_socket.h"
+
+#include "address_impl.h"
+#include "my/diag/logging.h"
+#include "my/runtime/internal/kernel_runtime.h"
+#include "runtime/uv_utils.h"
+
+using namespace my::async;
+
+namespace my::network {
+
+namespace {
+
+const InetAddress* getInetAddress(const Address& address)
+{
+    for (IAddress* const addr : address)
+    {
+        if (const InetAddress* const inetAddress = addr ? addr->as<const InetAddress*>() : nullptr)
+        {
+            return inetAddress;
+        }
+    }
+
+    return nullptr;
+}
+
+std::string getIpString(const Address& address)
+{
+    const InetAddress* const inetAddress = getInetAddress(address);
+    if (!inetAddress)
+    {
+        return {};
+    }
+
+    char buffer[64] = {};
+    const int result = inetAddress->getFamily() == AF_INET6
+                           ? uv_ip6_name(reinterpret_cast<const sockaddr_in6*>(inetAddress->getSockAddr()), buffer, sizeof(buffer))
+                           : uv_ip4_name(reinterpret_cast<const sockaddr_in*>(inetAddress->getSockAddr()), buffer, sizeof(buffer));
+
+    return result == 0 ? std::string{buffer} : std::string{};
+}
+
+inline uv_buf_t makeUvBuffer(const ReadOnlyBuffer& buffer)
+{
+    // uv does not modify the data being sent.
+    return uv_buf_init(reinterpret_cast<char*>(const_cast<std::byte*>(buffer.data())), static_cast<unsigned>(buffer.size()));
+}
+
+inline bool isSendQueueEmpty(uv_udp_t* udp)
+{
+    return uv_udp_get_send_queue_count(udp) == 0;
+}
+
+// Datagram can not be sent right now, it should be queued with uv_udp_send.
+inline bool isTrySendRejected(int code)
+{
+    return code == UV_EAGAIN || code == UV_ENOSYS;
+}
+
+}  // namespace
+
+DatagramSocket::DatagramSocket(UvHandle<uv_udp_t>&& handle, DatagramSocketOptions options) :
+    m_options(options),
+    m_udp(std::move(handle)),
+    m_runtimeReg{*this}
+{
+    MY_DEBUG_FATAL(m_udp);
+    MY_DEBUG_ASSERT(m_options.maxDatagramSize > 0);
+    m_udp.setData(this);
+}
+
+DatagramSocket::~DatagramSocket()
+{
+    closeSocket(true);
+}
+
+void DatagramSocket::closeSocket(bool fromDestructor)
+{
+    doDispose(fromDestructor, *this, [](IRefCounted& refCountedSelf) noexcept
+    {
+        DatagramSocket& self = refCountedSelf.as<DatagramSocket&>();
+        if (self.m_udp)
+        {
+            [[maybe_unused]] const int recvStopResult = uv_udp_recv_stop(self.m_udp);
+        }
+
+        self.m_udp.reset();
+        self.notifyReceiveAwaiter();
+    });
+}
+
+void DatagramSocket::dispose()
+{
+    closeSocket(false);
+}
+
+Result<> DatagramSocket::applyOptions()
+{
+    MY_DEBUG_ASSERT(getKernelRuntime().isRuntimeThread());
+    MY_DEBUG_ASSERT(m_udp);
+
+    if (m_options.broadcast)
+    {
+        if (const int code = uv_udp_set_broadcast(m_udp, 1); code != 0)
+        {
+            return MakeError("udp_set_broadcast failure:({})", getUVErrorMessage(code));
+        }
+    }
+
+    if (const int code = uv_udp_set_multicast_loop(m_udp, m_options.multicastLoopback ? 1 : 0); code != 0)
+    {
+        return MakeError("udp_set_multicast_loop failure:({})", getUVErrorMessage(code));
+    }
+
+    if (const int code = uv_udp_set_multicast_ttl(m_udp, static_cast<int>(m_options.multicastTtl)); code != 0)
+    {
+        return MakeError("udp_set_multicast_ttl failure:({})", getUVErrorMessage(code));
+    }
+
+    return kResultSuccess;
+}
+
+Address DatagramSocket::getLocalAddress() const
+{
+    if (isDisposed() || !m_udp)
+    {
+        return {};
+    }
+
+    sockaddr_storage storage;
+    int length = static_cast<int>(sizeof(storage));
+    if (uv_udp_getsockname(m_udp, reinterpret_cast<sockaddr*>(&storage), &length) != 0)
+    {
+        return {};
+    }
+
+    return Address{rtti::createInstance<InetAddress, IAddress>(*reinterpret_cast<const sockaddr*>(&storage))};
+}
+
+Address DatagramSocket::getRemoteAddress() const
+{
+    return {};
+}
+
+Result<> DatagramSocket::receiveStart()
+{
+    MY_DEBUG_ASSERT(m_udp);
+
+    if (uv_is_active(m_udp) != 0)
+    {
+        return kResultSuccess;
+    }
+
+    const auto allocateCallback = [](uv_handle_t* handle, [[maybe_unused]] size_t suggestedSize, uv_buf_t* outBuffer) noexcept
+    {
+        MY_DEBUG_FATAL(handle && handle->data);
+        auto& self = *static_cast<DatagramSocket*>(handle->data);
+
+        // The single receive buffer is reused: received data is copied out of it.
+        if (!self.m_receiveBuffer)
+        {
+            self.m_receiveBuffer = Buffer{self.m_options.maxDatagramSize};
+        }
+
+        *outBuffer = uv_buf_init(reinterpret_cast<char*>(self.m_receiveBuffer.data()), static_cast<unsigned>(self.m_receiveBuffer.size()));
+    };
+
+    const auto receiveCallback = [](uv_udp_t* udp, ssize_t nread, [[maybe_unused]] const uv_buf_t* inboundBuffer, const sockaddr* address, unsigned flags) noexcept
+    {
+        MY_DEBUG_FATAL(udp && udp->data);
+        if (!udp->data)
+        {
+            return;
+        }
+
+        auto& self = *static_cast<DatagramSocket*>(udp->data);
+        if (nread < 0)
+        {
+            mylog_warn("UV udp receive error: ({})", getUVErrorMessage(static_cast<int>(nread)));
+            return;
+        }
+
+        // Nothing to read (empty datagram always has the sender's address).
+        if (address == nullptr)
+        {
+            return;
+        }
+
+        MY_DEBUG_ASSERT(self.m_receiveBuffer && self.m_receiveBuffer.data() == reinterpret_cast<std::byte*>(inboundBuffer->base));
+
+        if (self.m_receivedDatagrams.size() >= self.m_options.receiveQueueSize)
+        {
+            mylog_warn("UV udp receive queue is full, datagram is dropped");
+            return;
+        }
+
+        if ((flags & UV_UDP_PARTIAL) != 0)
+        {
+            mylog_warn("UV udp datagram is truncated to ({}) bytes", self.m_options.maxDatagramSize);
+        }
+
+        // The datagram gets its own buffer allocated by the default buffer allocator, so it can be freely resized by the receiver.
+        Buffer data{static_cast<size_t>(nread)};
+        if (nread > 0)
+        {
+            memcpy(data.data(), self.m_receiveBuffer.data(), static_cast<size_t>(nread));
+        }
+
+        self.m_receivedDatagrams.emplace_back(std::move(data), Address{rtti::createInstance<InetAddress, IAddress>(*address)});
+        self.notifyReceiveAwaiter();
+    };
+
+    if (const int code = uv_udp_recv_start(m_udp, allocateCallback, receiveCallback); code != 0)
+    {
+        return MakeError(getUVErrorMessage(code));
+    }
+
+    return kResultSuccess;
+}
+
+void DatagramSocket::notifyReceiveAwaiter()
+{
+    MY_DEBUG_ASSERT(getKernelRuntime().isRuntimeThread());
+    if (m_receiveTaskSource)
+    {
+        std::exchange(m_receiveTaskSource, nullptr).resolve();
+    }
+}
+
+Task<Datagram> DatagramSocket::receive()
+{
+    if (isDisposed())
+    {
+        co_return MakeError("Object disposed");
+    }
+
+    this->addRef();
+    scope_on_leave
+    {
+        this->releaseRef();
+    };
+
+    ASYNC_SWITCH_EXECUTOR(getKernelRuntime().getRuntimeExecutor());
+
+    if (m_receivedDatagrams.empty())
+    {
+        if (!m_udp)
+        {
+            co_return MakeError("Object is not readable");
+        }
+
+        if (m_receiveTaskSource)
+        {
+            MY_DEBUG_FAILURE("receive operation already in progress");
+            co_return MakeError("receive operation already in progress");
+        }
+
+        if (Result<> result = receiveStart(); !result)
+        {
+            co_return result.getError();
+        }
+
+        m_receiveTaskSource = {};
+        co_await m_receiveTaskSource.getTask();
+
+        if (m_receivedDatagrams.empty())
+        {
+            co_return MakeError("Socket is closed");
+        }
+    }
+
+    Datagram datagram = std::move(m_receivedDatagrams.front());
+    m_receivedDatagrams.pop_front();
+
+    co_return datagram;
+}
+
+Task<> DatagramSocket::send(ReadOnlyBuffer data, Address address)
+{
+    if (isDisposed())
+    {
+        co_yield MakeError("Object disposed");
+    }
+
+    this->addRef();
+    scope_on_leave
+    {
+        this->releaseRef();
+    };
+
+    ASYNC_SWITCH_EXECUTOR(getKernelRuntime().getRuntimeExecutor());
+
+    if (!m_udp)
+    {
+        co_yield MakeError("Object is not writable");
+    }
+
+    const InetAddress* const inetAddress = getInetAddress(address);
+    if (!inetAddress)
+    {
+        co_yield MakeError("Datagram destination expected to be Inet Address");
+    }
+
+    // data will keep its reference during call and will be automatically released after leave its scope.
+    uv_buf_t uvBuffer = makeUvBuffer(data);
+
+    if (isSendQueueEmpty(m_udp))
+    {
+        const int trySendResult = uv_udp_try_send(m_udp, &uvBuffer, 1, inetAddress->getSockAddr());
+        if (trySendResult >= 0)
+        {
+            co_return;
+        }
+
+        if (!isTrySendRejected(trySendResult))
+        {
+            co_yield MakeError("udp_try_send failure:({})", getUVErrorMessage(trySendResult));
+        }
+    }
+
+    TaskSource<> taskSource;
+    uv_udp_send_t request;
+    request.data = &taskSource;
+
+    const int sendResult = uv_udp_send(&request, m_udp, &uvBuffer, 1, inetAddress->getSockAddr(), [](uv_udp_send_t* request, int status)
+    {
+        MY_DEBUG_FATAL(request && request->data);
+
+        auto& taskSource = *reinterpret_cast<TaskSource<>*>(request->data);
+        if (status != 0)
+        {
+            taskSource.reject(MakeError(getUVErrorMessage(status)));
+        }
+        else
+        {
+            taskSource.resolve();
+        }
+    });
+
+    if (sendResult != 0)
+    {
+        co_yield MakeError("udp_send failure:({})", getUVErrorMessage(sendResult));
+    }
+
+    co_await taskSource.getTask();
+}
+
+Task<> DatagramSocket::send(std::vector<OutboundDatagram> datagrams)
+{
+    if (isDisposed())
+    {
+        co_yield MakeError("Object disposed");
+    }
+
+    if (datagrams.empty())
+    {
+        co_return;
+    }
+
+    this->addRef();
+    scope_on_leave
+    {
+        this->releaseRef();
+    };
+
+    ASYNC_SWITCH_EXECUTOR(getKernelRuntime().getRuntimeExecutor());
+
+    if (!m_udp)
+    {
+        co_yield MakeError("Object is not writable");
+    }
+
+    const size_t count = datagrams.size();
+    std::vector<uv_buf_t> uvBuffers(count);
+    std::vector<sockaddr*> sockAddrs(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const InetAddress* const inetAddress = getInetAddress(datagrams[i].address);
+        if (!inetAddress)
+        {
+            co_yield MakeError("Datagram destination expected to be Inet Address");
+        }
+
+        uvBuffers[i] = makeUvBuffer(datagrams[i].data);
+        sockAddrs[i] = const_cast<sockaddr*>(inetAddress->getSockAddr());
+    }
+
+    size_t sentCount = 0;
+    if (isSendQueueEmpty(m_udp))
+    {
+#if UV_VERSION_HEX >= 0x013200
+        // uv_udp_try_send2 (libuv 1.50+) sends all datagrams with a single sendmmsg call where it is available.
+        std::vector<uv_buf_t*> uvBufferPtrs(count);
+        std::vector<unsigned> uvBufferCounts(count, 1);
+        for (size_t i = 0; i < count; ++i)
+        {
+            uvBufferPtrs[i] = &uvBuffers[i];
+        }
+
+        const int trySendResult = uv_udp_try_send2(m_udp, static_cast<unsigned>(count), uvBufferPtrs.data(), uvBufferCounts.data(), sockAddrs.data(), 0);
+        if (trySendResult >= 0)
+        {
+            sentCount = static_cast<size_t>(trySendResult);
+        }
+        else if (!isTrySendRejected(trySendResult))
+        {
+            co_yield MakeError("udp_try_send failure:({})", getUVErrorMessage(trySendResult));
+        }
+#else
+        for (; sentCount < count; ++sentCount)
+        {
+            const int trySendResult = uv_udp_try_send(m_udp, &uvBuffers[sentCount], 1, sockAddrs[sentCount]);
+            if (trySendResult < 0)
+            {
+                if (!isTrySendRejected(trySendResult))
+                {
+                    co_yield MakeError("udp_try_send failure:({})", getUVErrorMessage(trySendResult));
+                }
+                break;
+            }
+        }
+#endif
+    }
+
+    if (sentCount == count)
+    {
+        co_return;
+    }
+
+    struct BatchState
+    {
+        TaskSource<> taskSource;
+        size_t pendingCount = 0;
+        int errorCode = 0;
+
+        void complete(int status)
+        {
+            if (status != 0 && errorCode == 0)
+            {
+                errorCode = status;
+            }
+
+            MY_DEBUG_ASSERT(pendingCount > 0);
+            if (--pendingCount > 0)
+            {
+                return;
+            }
+
+            if (errorCode != 0)
+            {
+                taskSource.reject(MakeError(getUVErrorMessage(errorCode)));
+            }
+            else
+            {
+                taskSource.resolve();
+            }
+        }
+    };
+
+    BatchState state;
+    state.pendingCount = count - sentCount;
+    std::vector<uv_udp_send_t> requests(count - sentCount);
+
+    for (size_t i = sentCount; i < count; ++i)
+    {
+        uv_udp_send_t& request = requests[i - sentCount];
+        request.data = &state;
+
+        const int sendResult = uv_udp_send(&request, m_udp, &uvBuffers[i], 1, sockAddrs[i], [](uv_udp_send_t* request, int status)
+        {
+            MY_DEBUG_FATAL(request && request->data);
+            reinterpret_cast<BatchState*>(request->data)->complete(status);
+        });
+
+        if (sendResult != 0)
+        {
+            state.complete(sendResult);
+        }
+    }
+
+    co_await state.taskSource.getTask();
+}
+
+Task<> DatagramSocket::joinMulticastGroup(Address groupAddress, Address interfaceAddress)
+{
+    return setMembership(std::move(groupAddress), std::move(interfaceAddress), UV_JOIN_GROUP);
+}
+
+Task<> DatagramSocket::leaveMulticastGroup(Address groupAddress, Address interfaceAddress)
+{
+    return setMembership(std::move(groupAddress), std::move(interfaceAddress), UV_LEAVE_GROUP);
+}
+
+Task<> DatagramSocket::setMembership(Address groupAddress, Address interfaceAddress, uv_membership membership)
+{
+    if (isDisposed())
+    {
+        co_yield MakeError("Object disposed");
+    }
+
+    this->addRef();
+    scope_on_leave
+    {
+        this->releaseRef();
+    };
+
+    ASYNC_SWITCH_EXECUTOR(getKernelRuntime().getRuntimeExecutor());
+
+    if (!m_udp)
+    {
+        co_yield MakeError("Object is closed");
+    }
+
+    const std::string group = getIpString(groupAddress);
+    if (group.empty())
+    {
+        co_yield MakeError("Multicast group expected to be Inet Address");
+    }
+
+    const std::string interfaceIp = interfaceAddress ? getIpString(interfaceAddress) : std::string{};
+
+    if (const int code = uv_udp_set_membership(m_udp, group.c_str(), interfaceIp.empty() ? nullptr : interfaceIp.c_str(), membership); code != 0)
+    {
+        co_yield MakeError("udp_set_membership ({}) failure:({})", group, getUVErrorMessage(code));
+    }
+}
+
+}  // namespace my::network
@@ -0,0 +1,56 @@
+// #my_engine_source_file
+#pragma once
+
+#include "disposable_runtime_object.h"
+#include "my/network/network.h"
+#include "my/rtti/rtti_impl.h"
+#include "my/runtime/internal/runtime_object_registry.h"
+#include "runtime/uv_handle.h"
+
+#include <deque>
+
+namespace my::network {
+
+/**
+ */
+class DatagramSocket final : public IDatagramSocket,
+                             public DisposableRuntimeObject
+{
+    MY_REFCOUNTED_CLASS(my::network::DatagramSocket, IDatagramSocket)
+
+    DatagramSocket(const DatagramSocket&) = delete;
+    DatagramSocket& operator=(const DatagramSocket&) = delete;
+
+public:
+    DatagramSocket(UvHandle<uv_udp_t>&&, DatagramSocketOptions options);
+    ~DatagramSocket();
+
+    void dispose() override;
+
+    Address getLocalAddress() const override;
+    Address getRemoteAddress() const override;
+
+    async::Task<Datagram> receive() override;
+    async::Task<> send(ReadOnlyBuffer data, Address address) override;
+    async::Task<> send(std::vector<OutboundDatagram> datagrams) override;
+
+    async::Task<> joinMulticastGroup(Address groupAddress, Address interfaceAddress) override;
+    async::Task<> leaveMulticastGroup(Address groupAddress, Address interfaceAddress) override;
+
+    Result<> applyOptions();
+
+private:
+    Result<> receiveStart();
+    void notifyReceiveAwaiter();
+    void closeSocket(bool fromDestructor);
+    async::Task<> setMembership(Address groupAddress, Address interfaceAddress, uv_membership membership);
+
+    const DatagramSocketOptions m_options;
+    UvHandle<uv_udp_t> m_udp;
+    Buffer m_receiveBuffer;
+    std::deque<Datagram> m_receivedDatagrams;
+    async::TaskSource<> m_receiveTaskSource = nullptr;
+    RuntimeObjectRegistration m_runtimeReg;
+};
+
+}  // namespace my::network
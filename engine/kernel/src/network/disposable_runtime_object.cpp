@@ -1,10 +1,25 @@
 // #my_engine_source_file
 #include "disposable_runtime_object.h"
 #include "my/async/task.h"
-#include "my/runtime/internal/kernel_runtime.h"
+#include "runtime/kernel_runtime_impl.h"
 
 namespace my {
 
+DisposableRuntimeObject::DisposableRuntimeObject() :
+    m_loop(getKernelRuntimeImpl().getLoop())
+{
+}
+
+DisposableRuntimeObject::DisposableRuntimeObject(UvLoop& loop) :
+    m_loop(loop)
+{
+}
+
+UvLoop& DisposableRuntimeObject::getLoop() const
+{
+    return m_loop;
+}
+
 bool DisposableRuntimeObject::isDisposed() const
 {
     return m_isDisposed.load(std::memory_order_relaxed);
@@ -17,7 +32,7 @@ void DisposableRuntimeObject::doDispose(bool waitFor, IRefCounted& refCountedSel
         return;
     }
 
-    if (getKernelRuntime().isRuntimeThread())
+    if (m_loop.isLoopThread())
     {
         callback(refCountedSelf);
         return;
@@ -25,11 +40,11 @@ void DisposableRuntimeObject::doDispose(bool waitFor, IRefCounted& refCountedSel
 
     if (waitFor)
     {
-        async::Task<> task = [](IRefCounted& self, decltype(callback) callback) -> async::Task<>
+        async::Task<> task = [](async::ExecutorPtr executor, IRefCounted& self, decltype(callback) callback) -> async::Task<>
         {
-            co_await getKernelRuntime().getRuntimeExecutor();
+            co_await executor;
             callback(self);
-        }(refCountedSelf, callback);
+        }(m_loop.getExecutor(), refCountedSelf, callback);
         async::wait(task);
     }
     else
@@ -38,7 +53,7 @@ void DisposableRuntimeObject::doDispose(bool waitFor, IRefCounted& refCountedSel
         // there is no need to wait task completion, instead
         // can use addRef/releaseRef to guarantee that instance alive during call.
         // In that case instance can be destroyed within scope_on_leave inside callback.
-        async::Task<> task = [](IRefCounted& self, auto callback) -> async::Task<>
+        async::Task<> task = [](async::ExecutorPtr executor, IRefCounted& self, auto callback) -> async::Task<>
         {
             self.addRef();
             scope_on_leave
@@ -46,9 +61,9 @@ void DisposableRuntimeObject::doDispose(bool waitFor, IRefCounted& refCountedSel
                 self.releaseRef();
             };
 
-            co_await getKernelRuntime().getRuntimeExecutor();
+            co_await executor;
             callback(self);
-        }(refCountedSelf, callback);
+        }(m_loop.getExecutor(), refCountedSelf, callback);
         task.detach();
     }
 }
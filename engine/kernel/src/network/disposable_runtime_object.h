@@ -6,13 +6,23 @@
 
 namespace my {
 
+class UvLoop;
+
+/**
+    Object that owns the handles of the single loop: disposal is always performed on the loop's thread.
+ */
 class DisposableRuntimeObject
 {
 protected:
+    DisposableRuntimeObject();  // runtime loop
+    DisposableRuntimeObject(UvLoop& loop);
+
+    UvLoop& getLoop() const;
     bool isDisposed() const;
     void doDispose(bool waitFor, IRefCounted& refCountedSelf, void (*callback)(IRefCounted&) noexcept);
 
 private:
+    UvLoop& m_loop;
     std::atomic<bool> m_isDisposed = false;
 };
 
@@ -0,0 +1,581 @@
+// #my_engine_source_file
+#include "my/network/http_message.h"
+
+#include "my/diag/assert.h"
+#include "my/network/http_parser.h"
+#include "my/utils/string_utils.h"
+
+#include <charconv>
+
+using namespace std::literals;
+
+namespace my::network {
+
+namespace {
+
+// chunk size line or trailer field
+constexpr size_t MaxLineSize = 4096;
+
+bool hasToken(std::string_view headerValue, std::string_view token)
+{
+    while (!headerValue.empty())
+    {
+        const size_t pos = headerValue.find(',');
+        if (strings::icaseEqual(strings::trim(headerValue.substr(0, pos)), token))
+        {
+            return true;
+        }
+
+        headerValue = pos == std::string_view::npos ? std::string_view{} : headerValue.substr(pos + 1);
+    }
+
+    return false;
+}
+
+std::string_view findHeaderValue(const std::vector<HttpHeader>& headers, std::string_view name)
+{
+    for (const HttpHeader& header : headers)
+    {
+        if (strings::icaseEqual(header.name, name))
+        {
+            return header.value;
+        }
+    }
+
+    return {};
+}
+
+bool isFramingHeader(std::string_view name)
+{
+    return strings::icaseEqual(name, "Content-Length") || strings::icaseEqual(name, "Transfer-Encoding") || strings::icaseEqual(name, "Connection");
+}
+
+// 1xx, 204 and 304 responses never have a body
+bool statusAllowsBody(unsigned status)
+{
+    return status >= 200 && status != 204 && status != 304;
+}
+
+std::optional<size_t> parseContentLength(std::string_view value)
+{
+    size_t result = 0;
+    const char* const end = value.data() + value.size();
+    if (const auto [ptr, ec] = std::from_chars(value.data(), end, result); ec != std::errc{} || ptr != end || value.empty())
+    {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+std::string_view HttpRequest::getHeader(std::string_view name) const
+{
+    return findHeaderValue(headers, name);
+}
+
+std::string_view HttpRequest::getPath() const
+{
+    const std::string_view targetView = target;
+    return targetView.substr(0, targetView.find('?'));
+}
+
+std::string_view HttpRequest::getQuery() const
+{
+    const std::string_view targetView = target;
+    const size_t pos = targetView.find('?');
+    return pos == std::string_view::npos ? std::string_view{} : targetView.substr(pos + 1);
+}
+
+size_t HttpRequest::getBodySize() const
+{
+    size_t size = 0;
+    for (const Buffer& buffer : body)
+    {
+        size += buffer.size();
+    }
+
+    return size;
+}
+
+std::string HttpRequest::getBodyAsString() const
+{
+    std::string result;
+    result.reserve(getBodySize());
+    for (const Buffer& buffer : body)
+    {
+        result.append(asStringView(buffer));
+    }
+
+    return result;
+}
+
+bool HttpRequest::isKeepAlive() const
+{
+    const std::string_view connection = getHeader("Connection");
+    if (versionMinor == 0)
+    {
+        return hasToken(connection, "keep-alive");
+    }
+
+    return !hasToken(connection, "close");
+}
+
+//-----------------------------------------------------------------------------
+HttpResponse::HttpResponse(unsigned status_, std::string_view content, std::string_view contentType) :
+    status(status_)
+{
+    if (!content.empty())
+    {
+        body.emplace_back(fromStringView(content));
+        headers.emplace_back("Content-Type", std::string{contentType});
+    }
+}
+
+HttpResponse& HttpResponse::setHeader(std::string_view name, std::string value)
+{
+    for (HttpHeader& header : headers)
+    {
+        if (strings::icaseEqual(header.name, name))
+        {
+            header.value = std::move(value);
+            return *this;
+        }
+    }
+
+    headers.emplace_back(std::string{name}, std::move(value));
+    return *this;
+}
+
+std::string_view HttpResponse::getHeader(std::string_view name) const
+{
+    return findHeaderValue(headers, name);
+}
+
+bool HttpResponse::isChunked() const
+{
+    return static_cast<bool>(bodyStream);
+}
+
+//-----------------------------------------------------------------------------
+std::string_view getHttpStatusReason(unsigned status)
+{
+    switch (status)
+    {
+        case 100:
+            return "Continue";
+        case 101:
+            return "Switching Protocols";
+        case 200:
+            return "OK";
+        case 201:
+            return "Created";
+        case 202:
+            return "Accepted";
+        case 204:
+            return "No Content";
+        case 206:
+            return "Partial Content";
+        case 301:
+            return "Moved Permanently";
+        case 302:
+            return "Found";
+        case 304:
+            return "Not Modified";
+        case 400:
+            return "Bad Request";
+        case 401:
+            return "Unauthorized";
+        case 403:
+            return "Forbidden";
+        case 404:
+            return "Not Found";
+        case 405:
+            return "Method Not Allowed";
+        case 408:
+            return "Request Timeout";
+        case 411:
+            return "Length Required";
+        case 413:
+            return "Content Too Large";
+        case 414:
+            return "URI Too Long";
+        case 431:
+            return "Request Header Fields Too Large";
+        case 500:
+            return "Internal Server Error";
+        case 501:
+            return "Not Implemented";
+        case 503:
+            return "Service Unavailable";
+        case 505:
+            return "HTTP Version Not Supported";
+    }
+
+    return "Unknown";
+}
+
+Buffer serializeHttpResponseHead(const HttpResponse& response, bool keepAlive)
+{
+    std::string head = std::format("HTTP/1.1 {} {}\r\n", response.status, getHttpStatusReason(response.status));
+
+    for (const HttpHeader& header : response.headers)
+    {
+        if (!isFramingHeader(header.name))
+        {
+            head.append(std::format("{}: {}\r\n", header.name, header.value));
+        }
+    }
+
+    if (statusAllowsBody(response.status))
+    {
+        if (response.isChunked())
+        {
+            head.append("Transfer-Encoding: chunked\r\n");
+        }
+        else
+        {
+            size_t contentLength = 0;
+            for (const ReadOnlyBuffer& buffer : response.body)
+            {
+                contentLength += buffer.size();
+            }
+
+            head.append(std::format("Content-Length: {}\r\n", contentLength));
+        }
+    }
+
+    if (!keepAlive)
+    {
+        head.append("Connection: close\r\n");
+    }
+
+    head.append(HttpParser::EndOfLine);
+    return fromStringView(head);
+}
+
+//-----------------------------------------------------------------------------
+HttpRequestReader::HttpRequestReader() :
+    HttpRequestReader(Limits{})
+{
+}
+
+HttpRequestReader::HttpRequestReader(Limits limits) :
+    m_limits(limits)
+{
+}
+
+void HttpRequestReader::append(const Buffer& data)
+{
+    append(asStringView(data));
+}
+
+void HttpRequestReader::append(std::string_view data)
+{
+    if (data.empty())
+    {
+        return;
+    }
+
+    // Consumed data is dropped when it takes more than a half of the buffer: pipelined requests are not copied each time.
+    if (m_offset > 0 && m_offset >= m_data.size() / 2)
+    {
+        const std::string_view pending = pendingData();
+        Buffer compacted{pending.size() + data.size()};
+        memcpy(compacted.data(), pending.data(), pending.size());
+        memcpy(compacted.data() + pending.size(), data.data(), data.size());
+
+        m_data = std::move(compacted);
+        m_offset = 0;
+        return;
+    }
+
+    memcpy(m_data.append(data.size()), data.data(), data.size());
+}
+
+Result<std::optional<HttpRequest>> HttpRequestReader::next()
+{
+    while (true)
+    {
+        // there are no views into the consumed data between the states
+        releaseConsumedData();
+
+        switch (m_state)
+        {
+            case State::Head:
+            {
+                // Empty lines before the request line are allowed (RFC 9112 2.2).
+                while (pendingData().starts_with(HttpParser::EndOfLine))
+                {
+                    consume(HttpParser::EndOfLine.size());
+                    m_headParser = HttpParser{};
+                }
+
+                // Parser resumes from where the previous attempt stopped.
+                const std::string_view data = pendingData();
+                const HttpParser::ParseStatus status = m_headParser.parse(data);
+                if (status == HttpParser::ParseStatus::NeedMoreData)
+                {
+                    if (data.size() > m_limits.maxHeadersSize)
+                    {
+                        return fail(431, "Headers are too large");
+                    }
+
+                    return std::nullopt;
+                }
+
+                if (status == HttpParser::ParseStatus::Invalid)
+                {
+                    return fail(400, "Invalid header field");
+                }
+
+                const size_t headSize = m_headParser.headersLength();
+                if (headSize > m_limits.maxHeadersSize)
+                {
+                    return fail(431, "Headers are too large");
+                }
+
+                if (Result<> parseResult = parseHead(m_headParser); !parseResult)
+                {
+                    return parseResult.getError();
+                }
+
+                m_headParser = HttpParser{};
+                consume(headSize);
+                break;
+            }
+
+            case State::Body:
+            case State::ChunkData:
+            {
+                const size_t size = std::min(m_remainingSize, pendingData().size());
+                if (size > 0)
+                {
+                    m_request.body.emplace_back(takeBytes(size));
+                    m_remainingSize -= size;
+                }
+
+                if (m_remainingSize > 0)
+                {
+                    return std::nullopt;
+                }
+
+                m_state = m_state == State::Body ? State::Head : State::ChunkDataEnd;
+                break;
+            }
+
+            case State::ChunkSize:
+            {
+                const std::optional<std::string_view> line = takeLine();
+                if (!line)
+                {
+                    if (pendingData().size() > MaxLineSize)
+                    {
+                        return fail(400, "Line is too long");
+                    }
+
+                    return std::nullopt;
+                }
+
+                // chunk extensions are ignored
+                const std::string_view sizeString = strings::trim(line->substr(0, line->find(';')));
+                size_t chunkSize = 0;
+                const char* const end = sizeString.data() + sizeString.size();
+                if (const auto [ptr, ec] = std::from_chars(sizeString.data(), end, chunkSize, 16); ec != std::errc{} || ptr != end || sizeString.empty())
+                {
+                    return fail(400, "Invalid chunk size");
+                }
+
+                if (chunkSize > m_limits.maxBodySize - m_chunkedBodySize)
+                {
+                    return fail(413, "Body is too large");
+                }
+
+                m_chunkedBodySize += chunkSize;
+                m_remainingSize = chunkSize;
+                m_state = chunkSize == 0 ? State::Trailers : State::ChunkData;
+                break;
+            }
+
+            case State::ChunkDataEnd:
+            {
+                const std::string_view data = pendingData();
+                if (data.size() < HttpParser::EndOfLine.size())
+                {
+                    return std::nullopt;
+                }
+
+                if (!data.starts_with(HttpParser::EndOfLine))
+                {
+                    return fail(400, "Invalid chunk data");
+                }
+
+                consume(HttpParser::EndOfLine.size());
+                m_state = State::ChunkSize;
+                break;
+            }
+
+            case State::Trailers:
+            {
+                const std::optional<std::string_view> line = takeLine();
+                if (!line)
+                {
+                    if (pendingData().size() > MaxLineSize)
+                    {
+                        return fail(400, "Line is too long");
+                    }
+
+                    return std::nullopt;
+                }
+
+                if (!line->empty())
+                {
+                    // trailer fields are merged into the headers
+                    if (const HttpParser::Header trailer = HttpParser::tryParseHeader(*line))
+                    {
+                        m_request.headers.emplace_back(std::string{trailer.key}, std::string{trailer.value});
+                    }
+
+                    break;
+                }
+
+                m_state = State::Head;
+                break;
+            }
+        }
+
+        if (m_state == State::Head)
+        {
+            releaseConsumedData();
+            m_chunkedBodySize = 0;
+            return std::optional<HttpRequest>{std::exchange(m_request, HttpRequest{})};
+        }
+    }
+}
+
+unsigned HttpRequestReader::getErrorStatus() const
+{
+    return m_errorStatus;
+}
+
+bool HttpRequestReader::hasPendingData() const
+{
+    return m_state != State::Head || !pendingData().empty();
+}
+
+Result<> HttpRequestReader::parseHead(const HttpParser& head)
+{
+    // request-line = method SP request-target SP HTTP-version
+    const std::string_view requestLine = head.getStartLine();
+    const size_t methodEnd = requestLine.find(' ');
+    const size_t targetEnd = requestLine.rfind(' ');
+    if (methodEnd == std::string_view::npos || methodEnd == 0 || targetEnd <= methodEnd + 1)
+    {
+        return fail(400, "Invalid request line");
+    }
+
+    const std::string_view version = requestLine.substr(targetEnd + 1);
+    if (version.size() != "HTTP/1.x"sv.size() || !version.starts_with("HTTP/1.") || (version.back() != '0' && version.back() != '1'))
+    {
+        return fail(version.starts_with("HTTP/") ? 505 : 400, "Unsupported http version");
+    }
+
+    m_request.method = requestLine.substr(0, methodEnd);
+    m_request.target = requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+    m_request.versionMinor = static_cast<unsigned>(version.back() - '0');
+
+    m_request.headers.reserve(head.headersCount());
+    for (const HttpParser::Header& header : head)
+    {
+        m_request.headers.emplace_back(std::string{header.key}, std::string{header.value});
+    }
+
+    if (const std::string_view transferEncoding = m_request.getHeader("Transfer-Encoding"); !transferEncoding.empty())
+    {
+        // chunked must be the final transfer coding, other codings are not supported.
+        if (!strings::icaseEqual(strings::trim(transferEncoding), "chunked"))
+        {
+            return fail(501, "Unsupported transfer encoding");
+        }
+
+        m_state = State::ChunkSize;
+    }
+    else if (const std::string_view contentLength = m_request.getHeader("Content-Length"); !contentLength.empty())
+    {
+        const std::optional<size_t> bodySize = parseContentLength(contentLength);
+        if (!bodySize)
+        {
+            return fail(400, "Invalid Content-Length");
+        }
+
+        if (*bodySize > m_limits.maxBodySize)
+        {
+            return fail(413, "Body is too large");
+        }
+
+        m_remainingSize = *bodySize;
+        m_state = *bodySize > 0 ? State::Body : State::Head;
+    }
+    else
+    {
+        m_state = State::Head;
+    }
+
+    return kResultSuccess;
+}
+
+std::string_view HttpRequestReader::pendingData() const
+{
+    return asStringView(m_data).substr(m_offset);
+}
+
+void HttpRequestReader::consume(size_t size)
+{
+    MY_DEBUG_ASSERT(m_offset + size <= m_data.size());
+
+    // The storage is not released here: the views returned by takeLine() must stay valid until the line is parsed.
+    m_offset += size;
+    m_scanOffset = 0;
+}
+
+void HttpRequestReader::releaseConsumedData()
+{
+    if (m_offset > 0 && m_offset == m_data.size())
+    {
+        m_data = nullptr;
+        m_offset = 0;
+    }
+}
+
+Buffer HttpRequestReader::takeBytes(size_t size)
+{
+    Buffer buffer{size};
+    memcpy(buffer.data(), pendingData().data(), size);
+    consume(size);
+    return buffer;
+}
+
+ErrorPtr HttpRequestReader::fail(unsigned status, std::string_view message)
+{
+    m_errorStatus = status;
+    return MakeError("Invalid http request ({}): {}", status, message);
+}
+
+std::optional<std::string_view> HttpRequestReader::takeLine()
+{
+    const std::string_view data = pendingData();
+    const size_t pos = data.find(HttpParser::EndOfLine, m_scanOffset > 0 ? m_scanOffset - 1 : 0);
+    if (pos == std::string_view::npos)
+    {
+        m_scanOffset = data.size();
+        return std::nullopt;
+    }
+
+    const std::string_view line = data.substr(0, pos);
+    consume(pos + HttpParser::EndOfLine.size());
+    return line;
+}
+
+}  // namespace my::network
@@ -4,14 +4,83 @@
 #include "my/network/http_parser.h"
 #include "my/utils/string_utils.h"
 
+#include <bit>
+#include <charconv>
+#include <utility>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define MY_HTTP_PARSER_SSE2
+#endif
+
 using namespace std::literals;
 
 namespace my {
 
 namespace {
 constexpr char KeyValue_Separator = ':';
+constexpr char LineFeed = '\n';
+constexpr char CarriageReturn = '\r';
+
+/**
+    Returns position of the first LF or 'separator' character, size if there is no such character.
+    Passing LF as the separator searches for the end of line only.
+ */
+size_t findDelimiter(const char* const data, const size_t size, const char separator)
+{
+    size_t offset = 0;
+
+#if defined(__AVX2__)
+    const __m256i lineFeed32 = _mm256_set1_epi8(LineFeed);
+    const __m256i separator32 = _mm256_set1_epi8(separator);
+    for (; offset + 32 <= size; offset += 32)
+    {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+        const __m256i matches = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, lineFeed32), _mm256_cmpeq_epi8(chunk, separator32));
+        if (const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(matches)); mask != 0)
+        {
+            return offset + static_cast<size_t>(std::countr_zero(mask));
+        }
+    }
+#endif
+
+#ifdef MY_HTTP_PARSER_SSE2
+    const __m128i lineFeed16 = _mm_set1_epi8(LineFeed);
+    const __m128i separator16 = _mm_set1_epi8(separator);
+    for (; offset + 16 <= size; offset += 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+        const __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(chunk, lineFeed16), _mm_cmpeq_epi8(chunk, separator16));
+        if (const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(matches)); mask != 0)
+        {
+            return offset + static_cast<size_t>(std::countr_zero(mask));
+        }
+    }
+#endif
+
+    for (; offset < size; ++offset)
+    {
+        if (data[offset] == LineFeed || data[offset] == separator)
+        {
+            return offset;
+        }
+    }
+
+    return size;
+}
+
+bool isHeaderKey(std::string_view key)
+{
+    return !key.empty() && key.find_first_of(" \t") == std::string_view::npos;
 }
 
+}  // namespace
+
 //-----------------------------------------------------------------------------
 HttpParser::Header::Header() = default;
 
@@ -491,20 +560,21 @@ HttpParser::Arguments HttpParser::Request::arguments() const
 //-----------------------------------------------------------------------------
 HttpParser::HeaderIterator::HeaderIterator() = default;
 
-HttpParser::HeaderIterator::HeaderIterator(const HttpParser& parser_, const Header& value_) :
+HttpParser::HeaderIterator::HeaderIterator(const HttpParser& parser_, size_t index_) :
     parser(&parser_),
-    value(value_)
+    value(parser_.headerAt(index_)),
+    index(index_)
 {
 }
 
 bool HttpParser::HeaderIterator::operator==(const HeaderIterator& other) const
 {
-    return value == other.value;
+    return parser == other.parser && (!parser || index == other.index);
 }
 
 bool HttpParser::HeaderIterator::operator!=(const HeaderIterator& other) const
 {
-    return !(value == other.value);
+    return !(*this == other);
 }
 
 HttpParser::HeaderIterator& HttpParser::HeaderIterator::operator++()
@@ -512,9 +582,13 @@ HttpParser::HeaderIterator& HttpParser::HeaderIterator::operator++()
     MY_DEBUG_ASSERT(value, "Invalid http header iterator operation");
     MY_DEBUG_ASSERT(parser);
 
-    if (value = HttpParser::getNextHeader(parser->m_buffer, value); !value)
+    if (++index < parser->headersCount())
     {
-        parser = nullptr;
+        value = parser->headerAt(index);
+    }
+    else
+    {
+        *this = HeaderIterator{};
     }
 
     return *this;
@@ -758,57 +832,178 @@ std::optional<HttpParser::RequestData> HttpParser::parseRequestData(std::string_
 
 HttpParser::HttpParser() = default;
 
-HttpParser::HttpParser(std::string_view buffer) :
-    m_buffer(HttpParser::getHeadersBuffer(buffer))
+HttpParser::HttpParser(std::string_view buffer)
+{
+    parse(buffer);
+}
+
+HttpParser::ParseStatus HttpParser::parse(std::string_view buffer)
+{
+    if (m_status != ParseStatus::NeedMoreData)
+    {
+        return m_status;
+    }
+
+    MY_DEBUG_ASSERT(buffer.size() >= m_scanOffset, "Buffer must contain the previously parsed data");
+    m_buffer = buffer;
+
+    while (m_scanOffset < buffer.size())
+    {
+        // While ':' of the current line is not found, both delimiters are searched with the single pass.
+        const char separator = m_colonOffset == std::string_view::npos ? KeyValue_Separator : LineFeed;
+        const size_t pos = m_scanOffset + findDelimiter(buffer.data() + m_scanOffset, buffer.size() - m_scanOffset, separator);
+        if (pos == buffer.size())
+        {
+            m_scanOffset = pos;
+            break;
+        }
+
+        m_scanOffset = pos + 1;
+        if (buffer[pos] == KeyValue_Separator)
+        {
+            m_colonOffset = pos;
+            continue;
+        }
+
+        if (!completeLine(pos))
+        {
+            m_status = ParseStatus::Invalid;
+            m_buffer = {};
+            m_headers.clear();
+            break;
+        }
+
+        if (m_status == ParseStatus::Complete)
+        {
+            m_headersLength = m_scanOffset;
+            m_buffer = buffer.substr(0, m_headersLength);
+            break;
+        }
+    }
+
+    return m_status;
+}
+
+bool HttpParser::completeLine(size_t lineEnd)
 {
-    if (m_buffer.empty())
+    const size_t lineOffset = std::exchange(m_lineOffset, lineEnd + 1);
+    const size_t colonOffset = std::exchange(m_colonOffset, std::string_view::npos);
+    const size_t lineIndex = m_lineCount++;
+
+    if (lineEnd > lineOffset && m_buffer[lineEnd - 1] == CarriageReturn)
+    {
+        --lineEnd;
+    }
+
+    if (lineEnd == lineOffset)
+    {
+        m_status = ParseStatus::Complete;
+        return true;
+    }
+
+    const std::string_view line = m_buffer.substr(lineOffset, lineEnd - lineOffset);
+    const std::string_view key = colonOffset == std::string_view::npos ? std::string_view{} : strings::trim(m_buffer.substr(lineOffset, colonOffset - lineOffset));
+
+    if (!isHeaderKey(key) || line.front() == ' ' || line.front() == '\t')
     {
-        return;
+        if (lineIndex == 0)
+        {
+            m_startLineSize = line.size();
+            return true;
+        }
+
+        // obsolete line folding is not supported
+        return false;
+    }
+
+    const std::string_view value = strings::trim(m_buffer.substr(colonOffset + 1, lineEnd - colonOffset - 1));
+    m_headers.push_back(HeaderOffsets{
+        .keyOffset = static_cast<uint32_t>(key.data() - m_buffer.data()),
+        .keySize = static_cast<uint32_t>(key.size()),
+        .valueOffset = static_cast<uint32_t>(value.data() - m_buffer.data()),
+        .valueSize = static_cast<uint32_t>(value.size())});
+
+    if (strings::icaseEqual(key, "Content-Length"))
+    {
+        // Invalid or conflicting Content-Length makes the message framing ambiguous (request smuggling): the head is rejected.
+        size_t contentLength = 0;
+        const char* const valueEnd = value.data() + value.size();
+        if (const auto [ptr, ec] = std::from_chars(value.data(), valueEnd, contentLength); ec != std::errc{} || ptr != valueEnd || value.empty())
+        {
+            return false;
+        }
+
+        if (m_hasContentLength && contentLength != m_contentLength)
+        {
+            return false;
+        }
+
+        m_contentLength = contentLength;
+        m_hasContentLength = true;
     }
 
-    MY_DEBUG_ASSERT(m_buffer.size() <= buffer.size());
+    return true;
+}
 
-    // std::string contentLengthStr((*this)["Content-Length"]);
+HttpParser::ParseStatus HttpParser::getStatus() const
+{
+    return m_status;
+}
 
-    // m_contentLength = contentLengthStr.empty() ? size_t{0} : static_cast<size_t>(std::stoul(contentLengthStr));
+std::string_view HttpParser::getStartLine() const
+{
+    return m_buffer.substr(0, m_startLineSize);
 }
 
 HttpParser::operator bool() const
 {
-    return !m_buffer.empty();
+    return m_status == ParseStatus::Complete;
 }
 
 size_t HttpParser::headersLength() const
 {
-    return m_buffer.length();
+    return m_headersLength;
 }
 
 size_t HttpParser::contentLength() const
 {
-    if (!m_contentLength)
+    return m_contentLength;
+}
+
+std::string_view HttpParser::operator[](std::string_view key) const
+{
+    for (size_t i = 0, count = m_headers.size(); i < count; ++i)
     {
-        if (auto contentLengthValue = (*this)["Content-Length"]; !contentLengthValue.empty())
+        if (const Header header = headerAt(i); header == key)
         {
-            const std::string str{contentLengthValue};
-            m_contentLength = static_cast<size_t>(std::stoul(str));
-        }
-        else
-        {
-            m_contentLength = 0;
+            return header.value;
         }
     }
 
-    return *m_contentLength;
+    return {};
 }
 
-std::string_view HttpParser::operator[](std::string_view key) const
+size_t HttpParser::headersCount() const
+{
+    return m_headers.size();
+}
+
+HttpParser::Header HttpParser::headerAt(size_t index) const
 {
-    return findHeader(m_buffer, key).value;
+    MY_DEBUG_ASSERT(index < m_headers.size());
+
+    const HeaderOffsets& header = m_headers[index];
+    return {m_buffer.substr(header.keyOffset, header.keySize), m_buffer.substr(header.valueOffset, header.valueSize)};
 }
 
 HttpParser::HeaderIterator HttpParser::begin() const
 {
-    return {*this, getFirstHeader(m_buffer)};
+    if (m_headers.empty())
+    {
+        return {};
+    }
+
+    return {*this, 0};
 }
 
 HttpParser::HeaderIterator HttpParser::end() const
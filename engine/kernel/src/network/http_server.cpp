@@ -0,0 +1,345 @@
+// #my_engine_source_file
+#include "my/network/http_server.h"
+
+#include "my/diag/logging.h"
+#include "my/network/http_parser.h"
+#include "my/rtti/rtti_impl.h"
+#include "my/runtime/internal/runtime_object_registry.h"
+#include "my/utils/scope_guard.h"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+
+using namespace my::async;
+
+namespace my::network {
+
+namespace {
+
+constexpr std::string_view LastChunk{"0\r\n\r\n"};
+
+ReadOnlyBuffer makeReadOnlyBuffer(std::string_view str)
+{
+    return fromStringView(str).toReadOnly();
+}
+
+Task<> writeChunk(io::IAsyncStream& stream, ReadOnlyBuffer data)
+{
+    co_await stream.write(makeReadOnlyBuffer(std::format("{:x}\r\n", data.size())));
+    co_await stream.write(std::move(data));
+    co_await stream.write(makeReadOnlyBuffer(HttpParser::EndOfLine));
+}
+
+Task<> writeResponse(io::IAsyncStream& stream, HttpResponse response, bool keepAlive, bool withBody)
+{
+    co_await stream.write(serializeHttpResponseHead(response, keepAlive).toReadOnly());
+    if (!withBody)
+    {
+        co_return;
+    }
+
+    if (!response.isChunked())
+    {
+        for (ReadOnlyBuffer& buffer : response.body)
+        {
+            co_await stream.write(std::move(buffer));
+        }
+
+        co_return;
+    }
+
+    for (ReadOnlyBuffer& buffer : response.body)
+    {
+        if (buffer.size() > 0)
+        {
+            co_await writeChunk(stream, std::move(buffer));
+        }
+    }
+
+    while (true)
+    {
+        ReadOnlyBuffer part = co_await response.bodyStream();
+        if (part.size() == 0)
+        {
+            break;
+        }
+
+        co_await writeChunk(stream, std::move(part));
+    }
+
+    co_await stream.write(makeReadOnlyBuffer(LastChunk));
+}
+
+void disposeStream(io::IAsyncStream& stream)
+{
+    if (IDisposable* const disposable = stream.as<IDisposable*>())
+    {
+        disposable->dispose();
+    }
+}
+
+}  // namespace
+
+/**
+ */
+class HttpServerImpl final : public IHttpServer
+{
+    MY_REFCOUNTED_CLASS(my::network::HttpServerImpl, IHttpServer)
+
+public:
+    HttpServerImpl(Ptr<IListener> listener, HttpServerOptions options) :
+        m_listener(std::move(listener)),
+        m_options(options),
+        m_runtimeReg{*this}
+    {
+        MY_DEBUG_ASSERT(m_listener);
+    }
+
+    ~HttpServerImpl()
+    {
+        dispose();
+    }
+
+    Address getLocalAddress() const override
+    {
+        return m_listener->getLocalAddress();
+    }
+
+    Address getRemoteAddress() const override
+    {
+        return {};
+    }
+
+    void dispose() override
+    {
+        std::list<io::AsyncStreamPtr> connections;
+        {
+            const std::lock_guard lock(m_mutex);
+            if (m_isDisposed)
+            {
+                return;
+            }
+
+            m_isDisposed = true;
+            connections = m_connections;
+        }
+
+        m_listener->dispose();
+        for (const io::AsyncStreamPtr& connection : connections)
+        {
+            disposeStream(*connection);
+        }
+    }
+
+    void addRoute(std::string method, std::string path, HttpHandler handler) override
+    {
+        MY_DEBUG_ASSERT(handler);
+
+        const bool isPrefix = path.ends_with('*');
+        if (isPrefix)
+        {
+            path.pop_back();
+        }
+
+        const std::lock_guard lock(m_mutex);
+        m_routes.emplace_back(std::move(method), std::move(path), isPrefix, std::move(handler));
+    }
+
+    size_t getConnectionsCount() const override
+    {
+        const std::lock_guard lock(m_mutex);
+        return m_connections.size();
+    }
+
+    void start()
+    {
+        acceptLoop().detach();
+    }
+
+private:
+    struct Route
+    {
+        std::string method;
+        std::string path;
+        bool isPrefix;
+        HttpHandler handler;
+    };
+
+    /**
+        Routes are never removed: the found route can be used without the lock.
+     */
+    const Route* findRoute(const HttpRequest& request) const
+    {
+        const std::string_view path = request.getPath();
+        const Route* result = nullptr;
+
+        const std::lock_guard lock(m_mutex);
+        for (const Route& route : m_routes)
+        {
+            if (!route.method.empty() && route.method != request.method)
+            {
+                continue;
+            }
+
+            if (route.isPrefix ? !path.starts_with(route.path) : path != route.path)
+            {
+                continue;
+            }
+
+            // the longest path wins, exact route wins over the prefix of the same length
+            if (!result || route.path.size() > result->path.size() || (route.path.size() == result->path.size() && result->isPrefix && !route.isPrefix))
+            {
+                result = &route;
+            }
+        }
+
+        return result;
+    }
+
+    Task<HttpResponse> handleRequest(HttpRequest request)
+    {
+        const Route* const route = findRoute(request);
+        if (!route)
+        {
+            co_return HttpResponse{404, getHttpStatusReason(404)};
+        }
+
+        Result<HttpResponse> response = co_await route->handler(std::move(request)).doTry();
+        if (!response)
+        {
+            mylog_warn("Http request handler failed: ({})", response.getError()->getMessage());
+            co_return HttpResponse{500, getHttpStatusReason(500)};
+        }
+
+        co_return std::move(*response);
+    }
+
+    Task<> acceptLoop()
+    {
+        this->addRef();
+        scope_on_leave
+        {
+            this->releaseRef();
+        };
+
+        while (io::AsyncStreamPtr stream = co_await m_listener->accept())
+        {
+            bool accepted = false;
+            {
+                const std::lock_guard lock(m_mutex);
+                if (m_isDisposed)
+                {
+                    disposeStream(*stream);
+                    break;
+                }
+
+                if (m_connections.size() < m_options.maxConnections)
+                {
+                    m_connections.push_back(stream);
+                    accepted = true;
+                }
+            }
+
+            if (accepted)
+            {
+                serveConnection(std::move(stream)).detach();
+            }
+            else
+            {
+                rejectConnection(std::move(stream)).detach();
+            }
+        }
+    }
+
+    static Task<> rejectConnection(io::AsyncStreamPtr stream)
+    {
+        [[maybe_unused]] Result<> writeResult = co_await writeResponse(*stream, HttpResponse{503, getHttpStatusReason(503)}, false, true).doTry();
+        disposeStream(*stream);
+    }
+
+    Task<> serveConnection(io::AsyncStreamPtr stream)
+    {
+        this->addRef();
+        scope_on_leave
+        {
+            {
+                const std::lock_guard lock(m_mutex);
+                m_connections.remove(stream);
+            }
+
+            disposeStream(*stream);
+            this->releaseRef();
+        };
+
+        HttpRequestReader reader{{.maxHeadersSize = m_options.maxHeadersSize, .maxBodySize = m_options.maxBodySize}};
+
+        while (true)
+        {
+            // Pipelined requests are processed one by one: responses must be sent in the requests order.
+            Result<std::optional<HttpRequest>> nextRequest = reader.next();
+            if (!nextRequest)
+            {
+                const unsigned status = reader.getErrorStatus();
+                [[maybe_unused]] Result<> writeResult = co_await writeResponse(*stream, HttpResponse{status, getHttpStatusReason(status)}, false, true).doTry();
+                break;
+            }
+
+            if (std::optional<HttpRequest>& request = *nextRequest; request)
+            {
+                const bool keepAlive = request->isKeepAlive() && !m_isDisposed;
+                const bool withBody = request->method != "HEAD";
+
+                HttpResponse response = co_await handleRequest(std::move(*request));
+                Result<> writeResult = co_await writeResponse(*stream, std::move(response), keepAlive, withBody).doTry();
+                if (!writeResult || !keepAlive)
+                {
+                    break;
+                }
+
+                continue;
+            }
+
+            Task<Buffer> readTask = stream->read();
+            if (!co_await whenAny(Expiration{m_options.idleTimeout}, readTask))
+            {
+                // Disposed stream completes the pending read.
+                disposeStream(*stream);
+                [[maybe_unused]] Result<Buffer> readResult = co_await readTask.doTry();
+                break;
+            }
+
+            Result<Buffer> data = co_await readTask.doTry();
+            if (!data || data->size() == 0)
+            {
+                break;
+            }
+
+            reader.append(*data);
+        }
+    }
+
+    const Ptr<IListener> m_listener;
+    const HttpServerOptions m_options;
+    std::list<Route> m_routes;
+    std::list<io::AsyncStreamPtr> m_connections;
+    std::atomic<bool> m_isDisposed = false;
+    mutable std::mutex m_mutex;
+    RuntimeObjectRegistration m_runtimeReg;
+};
+
+Task<Ptr<IHttpServer>> startHttpServer(Address address, HttpServerOptions options)
+{
+    Ptr<IListener> listener = co_await network::listen(std::move(address));
+    if (!listener)
+    {
+        co_return MakeError("Fail to listen http server address");
+    }
+
+    Ptr<HttpServerImpl> server = rtti::createInstance<HttpServerImpl>(std::move(listener), options);
+    server->start();
+
+    co_return server;
+}
+
+}  // namespace my::network
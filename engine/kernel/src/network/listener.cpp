@@ -1,7 +1,9 @@
 // #my_engine_source_file
 #include "listener.h"
 #include "my/diag/logging.h"
+#include "my/rtti/weak_ptr.h"
 #include "my/threading/lock_guard.h"
+#include "runtime/kernel_runtime_impl.h"
 #include "runtime/uv_utils.h"
 #include "stream_socket.h"
 
@@ -9,13 +11,11 @@ using namespace my::async;
 
 namespace my::network {
 
-Listener::Listener(Address&& address, UvHandle<uv_stream_t>&& handle, ListenOptions) :
+Listener::Listener(Address&& address, ListenOptions options) :
     m_address(std::move(address)),
-    m_uvServer(std::move(handle)),
+    m_options(options),
     m_runtimeReg{*this}
 {
-    MY_DEBUG_FATAL(m_uvServer);
-    uv_handle_set_data(m_uvServer, this);
 }
 
 Listener::~Listener()
@@ -34,13 +34,49 @@ void Listener::closeListener(bool fromDestructor)
     {
         Listener& self = refCountedSelf.as<Listener&>();
 
-        self.m_uvServer.reset();
-        self.doAccept(nullptr);
+        std::vector<UvHandle<uv_stream_t>> uvServers;
+        {
+            const std::lock_guard lock(self.m_mutex);
+            uvServers = std::move(self.m_uvServers);
+            self.doAccept(nullptr);
+        }
+
+        closeServers(std::move(uvServers));
     });
 }
 
-Result<> Listener::startListen(unsigned backlog)
+void Listener::closeServers(std::vector<UvHandle<uv_stream_t>> uvServers)
+{
+    // Handles of the other loops are closed on theirs threads.
+    for (UvHandle<uv_stream_t>& uvServer : uvServers)
+    {
+        const auto closeServer = [](UvHandle<uv_stream_t>& handle)
+        {
+            IWeakRef* const listenerWeakRef = static_cast<IWeakRef*>(handle.data());
+            handle.reset();
+            listenerWeakRef->releaseRef();
+        };
+
+        UvLoop& loop = UvLoop::fromUv(uvServer->loop);
+        if (loop.isLoopThread())
+        {
+            closeServer(uvServer);
+            continue;
+        }
+
+        [](ExecutorPtr executor, UvHandle<uv_stream_t> handle, auto closeServer) -> Task<>
+        {
+            co_await executor;
+            closeServer(handle);
+        }(loop.getExecutor(), std::move(uvServer), closeServer).detach();
+    }
+}
+
+Result<> Listener::startListen(UvHandle<uv_stream_t>&& handle, unsigned backlog)
 {
+    MY_DEBUG_FATAL(handle);
+    MY_DEBUG_ASSERT(UvLoop::fromUv(handle->loop).isLoopThread());
+
     const auto connectionCallback = [](uv_stream_t* listenerHandle, int status) noexcept
     {
         MY_DEBUG_ASSERT(listenerHandle && listenerHandle->data);
@@ -50,39 +86,100 @@ Result<> Listener::startListen(unsigned backlog)
             return;
         }
 
-        Listener& self = *static_cast<Listener*>(listenerHandle->data);
-        const std::lock_guard lock(self.m_mutex);
-        if (status != 0)
+        // Listener can be released on the other thread while the handle is still open, so the handle refers to it weakly.
+        IRefCounted* const listener = static_cast<IWeakRef*>(listenerHandle->data)->acquire();
+        if (!listener)
         {
-            self.doAccept(nullptr);
             return;
         }
 
-        // Actual uv_accept should not be delayed and stream must be created here:
-        // 1. can call uv_accept and create actual Stream only when called Listener::accept;
-        // 2. if callee will not call Listener::accept for each inbound connection there is possibility that UV will not close sockets for this inbound connections
-        //      and because connection actually established and socket remaining alive remote client will hang forever on read operation
-        //      i.e. Client::connect finished with success and subsequent ::read() will never be finished.
-
-        UvHandle<uv_stream_t> clientHandle = self.initClientHandle();
-        if (const auto acceptResult = uv_accept(listenerHandle, clientHandle); acceptResult != 0)
-        {
-        }
-        else
+        const Ptr<Listener> self = rtti::TakeOwnership{listener->as<Listener*>()};
+        if (status != 0)
         {
-            Ptr<StreamSocket> connection = rtti::createInstance<StreamSocket>(std::move(clientHandle));
-            self.doAccept(std::move(connection));
+            const std::lock_guard lock(self->m_mutex);
+            self->doAccept(nullptr);
+            return;
         }
+
+        self->acceptConnection(listenerHandle);
     };
 
-    if (const int error = uv_listen(m_uvServer, static_cast<int>(backlog), connectionCallback); error != 0)
+    uv_handle_set_data(handle, WeakPtr<Listener>{Ptr<Listener>{this}}.giveUp());
+    if (const int error = uv_listen(handle, static_cast<int>(backlog), connectionCallback); error != 0)
     {
+        static_cast<IWeakRef*>(handle.data())->releaseRef();
         return MakeError(getUVErrorMessage(error));
     }
 
+    const std::lock_guard lock(m_mutex);
+    m_uvServers.emplace_back(std::move(handle));
+
     return kResultSuccess;
 }
 
+void Listener::acceptConnection(uv_stream_t* listenerHandle)
+{
+    // Actual uv_accept should not be delayed and stream must be created here:
+    // 1. can call uv_accept and create actual Stream only when called Listener::accept;
+    // 2. if callee will not call Listener::accept for each inbound connection there is possibility that UV will not close sockets for this inbound connections
+    //      and because connection actually established and socket remaining alive remote client will hang forever on read operation
+    //      i.e. Client::connect finished with success and subsequent ::read() will never be finished.
+
+    UvLoop& loop = UvLoop::fromUv(listenerHandle->loop);
+    UvHandle<uv_stream_t> clientHandle = initClientHandle(loop);
+    if (const auto acceptResult = uv_accept(listenerHandle, clientHandle); acceptResult != 0)
+    {
+        return;
+    }
+
+    if (m_options.distribution == ConnectionDistribution::RoundRobin)
+    {
+        if (UvLoop& targetLoop = getKernelRuntimeImpl().selectIoLoop(); &targetLoop != &loop)
+        {
+            moveConnection(std::move(clientHandle), targetLoop);
+            return;
+        }
+    }
+
+    Ptr<StreamSocket> connection = rtti::createInstance<StreamSocket>(std::move(clientHandle));
+
+    const std::lock_guard lock(m_mutex);
+    doAccept(std::move(connection));
+}
+
+void Listener::moveConnection(UvHandle<uv_stream_t>&& clientHandle, UvLoop& targetLoop)
+{
+    // The handle is not reading yet, so closing it does not shutdown the connection: only the OS socket is closed, the duplicate remains.
+    const Result<uv_os_sock_t> socket = duplicateClientSocket(clientHandle);
+    clientHandle.reset();
+
+    if (!socket)
+    {
+        mylog_warn("Fail to move accepted connection: ({})", socket.getError()->getMessage());
+        return;
+    }
+
+    [](Ptr<Listener> self, UvLoop& loop, uv_os_sock_t socket) -> Task<>
+    {
+        co_await loop.getExecutor();
+
+        Result<UvHandle<uv_stream_t>> handle = self->openClientSocket(loop, socket);
+        if (!handle)
+        {
+            mylog_warn("Fail to open accepted connection: ({})", handle.getError()->getMessage());
+            co_return;
+        }
+
+        Ptr<StreamSocket> connection = rtti::createInstance<StreamSocket>(std::move(*handle));
+
+        const std::lock_guard lock(self->m_mutex);
+        if (!self->isDisposed())
+        {
+            self->doAccept(std::move(connection));
+        }
+    }(Ptr{this}, targetLoop, *socket).detach();
+}
+
 Address Listener::getLocalAddress() const
 {
     return m_address;
@@ -97,7 +194,7 @@ Task<io::AsyncStreamPtr> Listener::accept()
 {
     const std::lock_guard lock(m_mutex);
 
-    if (!m_uvServer)
+    if (isDisposed())
     {
         return Task<io::AsyncStreamPtr>::makeResolved(nullptr);
     }
@@ -5,12 +5,15 @@
 #include "my/runtime/internal/runtime_object_registry.h"
 #include "my/threading/critical_section.h"
 #include "runtime/uv_handle.h"
+#include "runtime/uv_loop.h"
 
 #include <atomic>
 
 namespace my::network {
 
 /**
+    Listener can listen on the several loops (SO_REUSEPORT), connections are accepted on the loop where they arrived.
+    With ConnectionDistribution::RoundRobin accepted connections are moved to the network I/O loops in turn.
  */
 class MY_ABSTRACT_TYPE Listener : public IListener, public DisposableRuntimeObject
 {
@@ -26,19 +29,34 @@ public:
     Address getRemoteAddress() const final;
     void dispose() final;
     async::Task<io::AsyncStreamPtr> accept() final;
-    Result<> startListen(unsigned backlog);
+
+    /**
+        Starts listening on the handle's loop, must be called on the handle's loop thread.
+     */
+    Result<> startListen(UvHandle<uv_stream_t>&& handle, unsigned backlog);
 
 protected:
-    Listener(Address&& address, UvHandle<uv_stream_t>&&, ListenOptions options);
+    Listener(Address&& address, ListenOptions options);
+
+    virtual UvHandle<uv_stream_t> initClientHandle(UvLoop& loop) = 0;
+
+    /**
+        Duplicates OS socket of the accepted connection, so the connection can be opened on the other loop.
+     */
+    virtual Result<uv_os_sock_t> duplicateClientSocket(const UvHandle<uv_stream_t>& handle) = 0;
 
-    virtual UvHandle<uv_stream_t> initClientHandle() = 0;
+    virtual Result<UvHandle<uv_stream_t>> openClientSocket(UvLoop& loop, uv_os_sock_t socket) = 0;
 
 private:
+    void acceptConnection(uv_stream_t* listenerHandle);
+    void moveConnection(UvHandle<uv_stream_t>&& clientHandle, UvLoop& targetLoop);
     void doAccept(io::AsyncStreamPtr);
     void closeListener(bool fromDestructor);
+    static void closeServers(std::vector<UvHandle<uv_stream_t>> uvServers);
 
     const Address m_address;
-    UvHandle<uv_stream_t> m_uvServer;  // stream = tcp, pipe
+    const ListenOptions m_options;
+    std::vector<UvHandle<uv_stream_t>> m_uvServers;  // stream = tcp, pipe
 
     async::TaskSource<io::AsyncStreamPtr> m_acceptTaskSource = nullptr;
     std::list<io::AsyncStreamPtr> m_delayedConnections;
@@ -1,5 +1,6 @@
 // #my_engine_source_file
 #include "address_impl.h"
+#include "datagram_socket.h"
 #include "listener.h"
 #include "tcp.h"
 #include "my/network/network.h"
@@ -14,6 +15,83 @@ using namespace my::async;
 namespace my::network {
 
 
+Task<> startNetworkThreads(size_t threadsCount)
+{
+    KernelRuntimeImpl& runtime = getKernelRuntimeImpl();
+    ASYNC_SWITCH_EXECUTOR(runtime.getRuntimeExecutor());
+
+    if (Result<> result = runtime.startIoThreads(threadsCount); !result)
+    {
+        co_yield result.getError();
+    }
+}
+
+namespace {
+
+/**
+    Each I/O loop listens its own socket (SO_REUSEPORT). The first socket is bound to the requested address,
+    the other sockets are bound to the actually bound address (so port 0 is resolved only once).
+    Returns nullptr when the address can not be bound, so the next resolved address can be tried.
+ */
+Task<Ptr<Listener>> listenOnIoLoops(InetAddress* addr, unsigned backlog, ListenOptions options)
+{
+    const std::vector<UvLoop*> ioLoops = getKernelRuntimeImpl().getIoLoops();
+    MY_DEBUG_ASSERT(!ioLoops.empty());
+
+    Ptr<Listener> listener;
+    Ptr<InetAddress> boundAddress;
+    for (UvLoop* const loop : ioLoops)
+    {
+        co_await loop->getExecutor();
+
+        UvHandle<uv_tcp_t> tcp;
+        UV_VERIFY(uv_tcp_init_ex(loop->uv(), tcp, addr->getSockAddr()->sa_family));
+        if (!tcpSetReusePort(tcp))
+        {
+            if (listener)
+            {
+                listener->dispose();
+            }
+
+            co_return MakeError("Fail to enable SO_REUSEPORT");
+        }
+
+        const sockaddr* const sockAddr = boundAddress ? boundAddress->getSockAddr() : addr->getSockAddr();
+        if (const int bindResult = uv_tcp_bind(tcp, sockAddr, 0); bindResult != 0)
+        {
+            if (!listener)
+            {
+                co_return nullptr;
+            }
+
+            listener->dispose();
+            co_return MakeError("tcp_bind failure:({})", getUVErrorMessage(bindResult));
+        }
+
+        if (!listener)
+        {
+            // The requested port can be 0: the other loops are bound to the port that is actually assigned.
+            boundAddress = tcpGetLocalAddress(tcp);
+            if (!boundAddress)
+            {
+                co_return nullptr;
+            }
+
+            listener = createTcpListener(Address{boundAddress.get()}, options);
+        }
+
+        if (auto res = listener->startListen(std::move(tcp), backlog); !res)
+        {
+            listener->dispose();
+            co_return res.getError();
+        }
+    }
+
+    co_return listener;
+}
+
+}  // namespace
+
 Task<Ptr<IListener>> listen(Address address, ListenOptions options)
 {
     MY_DEBUG_ASSERT(address);
@@ -25,8 +103,12 @@ Task<Ptr<IListener>> listen(Address address, ListenOptions options)
     KernelRuntimeImpl& runtime = getKernelRuntimeImpl();
     ASYNC_SWITCH_EXECUTOR(runtime.getRuntimeExecutor());
 
-    Ptr<Listener> listener;
-    unsigned backlog = options.backlog;
+    const unsigned backlog = options.backlog == 0 ? SOMAXCONN : options.backlog;
+    if (options.distribution == ConnectionDistribution::ReusePort && (runtime.getIoLoops().empty() || !tcpHasReusePort()))
+    {
+        options.distribution = ConnectionDistribution::RoundRobin;
+    }
+
     for (IAddress* const bindAddress : address)
     {
         MY_DEBUG_ASSERT(bindAddress);
@@ -37,40 +119,36 @@ Task<Ptr<IListener>> listen(Address address, ListenOptions options)
 
         if (InetAddress* const addr = bindAddress->as<InetAddress*>())
         {
+            if (options.distribution == ConnectionDistribution::ReusePort)
+            {
+                if (Ptr<Listener> listener = co_await listenOnIoLoops(addr, backlog, options))
+                {
+                    co_return listener;
+                }
+
+                continue;
+            }
+
             UvHandle<uv_tcp_t> tcp;
             UV_VERIFY(uv_tcp_init(runtime.uv(), tcp));
             // When address in use UV_EADDRINUSE will occur only in listen operation (inside startListen).
             if (const int bindResult = uv_tcp_bind(tcp, addr->getSockAddr(), 0); bindResult != 0)
             {
-                
+                continue;
             }
-            else
+
+            Ptr<InetAddress> boundAddress = tcpGetLocalAddress(tcp);
+            Ptr<Listener> listener = createTcpListener(Address{boundAddress ? boundAddress.get() : addr}, options);
+            if (auto res = listener->startListen(std::move(tcp), backlog); !res)
             {
-                if (backlog == 0)
-                {
-                    backlog = SOMAXCONN;
-                }
-                listener = createTcpListener(Address{addr}, std::move(tcp), options);
-                break;
+                co_return res.getError();
             }
-        }
-        else
-        {
-        }
-    }
 
-    if (listener)
-    {
-        if (auto res = listener->startListen(backlog); !res)
-        {
-            co_return res.getError();
+            co_return listener;
         }
     }
-    else
-    {
-    }
 
-    co_return listener;
+    co_return nullptr;
 }
 
 MY_KERNEL_EXPORT Task<io::AsyncStreamPtr> connect(Address address, Address bindAddress, [[maybe_unused]] Expiration expiration)
@@ -81,8 +159,9 @@ MY_KERNEL_EXPORT Task<io::AsyncStreamPtr> connect(Address address, Address bindA
         co_return nullptr;
     }
 
-    KernelRuntimeImpl& runtime = getKernelRuntimeImpl();
-    ASYNC_SWITCH_EXECUTOR(runtime.getRuntimeExecutor());
+    // The connection is served by the I/O loop (in turn), or by the runtime loop when there are no I/O threads.
+    UvLoop& loop = getKernelRuntimeImpl().selectIoLoop();
+    ASYNC_SWITCH_EXECUTOR(loop.getExecutor());
 
     Ptr<StreamSocket> socket;
     for (IAddress* const remoteAddress : address)
@@ -96,7 +175,7 @@ MY_KERNEL_EXPORT Task<io::AsyncStreamPtr> connect(Address address, Address bindA
         if (const InetAddress* const addr = remoteAddress->as<const InetAddress*>())
         {
             UvHandle<uv_tcp_t> tcp;
-            UV_VERIFY(uv_tcp_init(runtime.uv(), tcp));
+            UV_VERIFY(uv_tcp_init(loop.uv(), tcp));
 
             if (bindAddress)
             {
@@ -131,4 +210,52 @@ MY_KERNEL_EXPORT Task<io::AsyncStreamPtr> connect(Address address, Address bindA
     co_return socket;
 }
 
+Task<Ptr<IDatagramSocket>> bindDatagramSocket(Address address, DatagramSocketOptions options)
+{
+    MY_DEBUG_ASSERT(address);
+    if (!address)
+    {
+        co_return nullptr;
+    }
+
+    KernelRuntimeImpl& runtime = getKernelRuntimeImpl();
+    ASYNC_SWITCH_EXECUTOR(runtime.getRuntimeExecutor());
+
+    for (IAddress* const bindAddress : address)
+    {
+        MY_DEBUG_ASSERT(bindAddress);
+        if (!bindAddress)
+        {
+            continue;
+        }
+
+        if (const InetAddress* const addr = bindAddress->as<const InetAddress*>())
+        {
+            UvHandle<uv_udp_t> udp;
+            UV_VERIFY(uv_udp_init(runtime.uv(), udp));
+
+            const unsigned flags = options.reuseAddress ? UV_UDP_REUSEADDR : 0;
+            if (const int bindResult = uv_udp_bind(udp, addr->getSockAddr(), flags); bindResult != 0)
+            {
+                if (bindResult == UV_EADDRINUSE)
+                {
+                    continue;
+                }
+
+                co_return MakeError("udp_bind failure:({})", getUVErrorMessage(bindResult));
+            }
+
+            Ptr<DatagramSocket> socket = rtti::createInstance<DatagramSocket>(std::move(udp), options);
+            if (auto res = socket->applyOptions(); !res)
+            {
+                co_return res.getError();
+            }
+
+            co_return socket;
+        }
+    }
+
+    co_return MakeError("Can not bind datagram socket to specified address");
+}
+
 }  // namespace my::network
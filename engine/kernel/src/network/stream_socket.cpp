@@ -1,5 +1,5 @@
 // #my_engine_source_file
-#include "my/runtime/internal/kernel_runtime.h"
+#include "runtime/uv_loop.h"
 #include "runtime/uv_utils.h"
 #include "stream_socket.h"
 
@@ -10,8 +10,8 @@ namespace my::network {
 constexpr size_t MaxReadBufferSize = 1600;
 
 StreamSocket::StreamSocket(UvHandle<uv_stream_t>&& handle) :
+    DisposableRuntimeObject(UvLoop::fromUv(handle->loop)),
     m_stream(std::move(handle))
-
 {
     MY_DEBUG_FATAL(m_stream);
     m_stream.setData(this);
@@ -147,7 +147,7 @@ Result<> StreamSocket::readStart()
 
 void StreamSocket::notifyReadAwaiter()
 {
-    MY_DEBUG_ASSERT(getKernelRuntime().isRuntimeThread());
+    MY_DEBUG_ASSERT(getLoop().isLoopThread());
     if (m_readTaskSource)
     {
         std::exchange(m_readTaskSource, nullptr).resolve();
@@ -167,7 +167,8 @@ async::Task<Buffer> StreamSocket::read()
         this->releaseRef();
     };
 
-    ASYNC_SWITCH_EXECUTOR(getKernelRuntime().getRuntimeExecutor());
+    // All socket's operations are performed on its loop, the caller is resumed on its own executor.
+    ASYNC_SWITCH_EXECUTOR(getLoop().getExecutor());
 
     if (!m_pendingBuffer.empty())
     {
@@ -216,8 +217,7 @@ async::Task<> StreamSocket::write(ReadOnlyBuffer buffer)
         this->releaseRef();
     };
 
-    IKernelRuntime& runtime = getKernelRuntime();
-    ASYNC_SWITCH_EXECUTOR(runtime.getRuntimeExecutor());
+    ASYNC_SWITCH_EXECUTOR(getLoop().getExecutor());
 
     if (!m_stream || uv_is_writable(m_stream) == 0)
     {
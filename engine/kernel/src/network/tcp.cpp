@@ -7,27 +7,62 @@
 #include "tcp.h"
 // #include "stream_socket.h"
 
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
 using namespace my::async;
 
 namespace my::network {
 
+namespace {
+
+void closeSocket(uv_os_sock_t socket)
+{
+#ifdef _WIN32
+    ::closesocket(socket);
+#else
+    ::close(socket);
+#endif
+}
+
+}  // namespace
+
 class TcpListener final : public Listener
 {
     MY_REFCOUNTED_CLASS(my::network::TcpListener, Listener)
 
 public:
-    TcpListener(Address&& address, UvHandle<uv_stream_t>&& handle, ListenOptions options) :
-        Listener(std::move(address), std::move(handle), options)
+    TcpListener(Address&& address, ListenOptions options) :
+        Listener(std::move(address), options)
     {
     }
 
 private:
-    UvHandle<uv_stream_t> initClientHandle() override
+    UvHandle<uv_stream_t> initClientHandle(UvLoop& loop) override
     {
         UvHandle<uv_tcp_t> tcp;
-        UV_VERIFY(uv_tcp_init(getKernelRuntimeImpl().uv(), tcp));
+        UV_VERIFY(uv_tcp_init(loop.uv(), tcp));
         return tcp;
     }
+
+    Result<uv_os_sock_t> duplicateClientSocket(const UvHandle<uv_stream_t>& handle) override
+    {
+        return tcpDuplicateSocket(handle.as<uv_tcp_t>());
+    }
+
+    Result<UvHandle<uv_stream_t>> openClientSocket(UvLoop& loop, uv_os_sock_t socket) override
+    {
+        UvHandle<uv_tcp_t> tcp;
+        UV_VERIFY(uv_tcp_init(loop.uv(), tcp));
+        if (const int openResult = uv_tcp_open(tcp, socket); openResult != 0)
+        {
+            closeSocket(socket);
+            return MakeError("tcp_open failure:({})", getUVErrorMessage(openResult));
+        }
+
+        return UvHandle<uv_stream_t>{std::move(tcp)};
+    }
 };
 
 Task<bool> tcpConnect(uv_tcp_t* handle, const sockaddr* address)
@@ -100,9 +135,82 @@ Result<bool> tcpBind(uv_tcp_t* handle, const Address& address)
     return false;
 }
 
-Ptr<Listener> createTcpListener(Address&& address, UvHandle<uv_tcp_t>&& handle, ListenOptions options)
+Result<uv_os_sock_t> tcpDuplicateSocket(uv_tcp_t* handle)
+{
+    MY_DEBUG_ASSERT(handle);
+
+    uv_os_fd_t fd;
+    if (const int res = uv_fileno(reinterpret_cast<const uv_handle_t*>(handle), &fd); res != 0)
+    {
+        return MakeError("uv_fileno failure:({})", getUVErrorMessage(res));
+    }
+
+#ifdef _WIN32
+    // The socket is associated with the completion port of its loop, the duplicate is free to be associated with the other one.
+    WSAPROTOCOL_INFOW protocolInfo;
+    if (WSADuplicateSocketW(reinterpret_cast<SOCKET>(fd), GetCurrentProcessId(), &protocolInfo) != 0)
+    {
+        return MakeError("WSADuplicateSocket failure:({})", WSAGetLastError());
+    }
+
+    const SOCKET socket = WSASocketW(FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, &protocolInfo, 0, WSA_FLAG_OVERLAPPED);
+    if (socket == INVALID_SOCKET)
+    {
+        return MakeError("WSASocket failure:({})", WSAGetLastError());
+    }
+
+    return socket;
+#else
+    const int socket = ::dup(fd);
+    if (socket < 0)
+    {
+        return MakeError("dup failure:({})", errno);
+    }
+
+    return socket;
+#endif
+}
+
+Ptr<InetAddress> tcpGetLocalAddress(uv_tcp_t* handle)
+{
+    sockaddr_storage storage;
+    int length = static_cast<int>(sizeof(storage));
+    if (uv_tcp_getsockname(handle, reinterpret_cast<sockaddr*>(&storage), &length) != 0)
+    {
+        return nullptr;
+    }
+
+    return rtti::createInstance<InetAddress>(*reinterpret_cast<const sockaddr*>(&storage));
+}
+
+bool tcpHasReusePort()
+{
+#if defined(SO_REUSEPORT) && !defined(_WIN32)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool tcpSetReusePort([[maybe_unused]] uv_tcp_t* handle)
+{
+#if defined(SO_REUSEPORT) && !defined(_WIN32)
+    uv_os_fd_t fd;
+    if (uv_fileno(reinterpret_cast<const uv_handle_t*>(handle), &fd) != 0)
+    {
+        return false;
+    }
+
+    const int enable = 1;
+    return ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) == 0;
+#else
+    return false;
+#endif
+}
+
+Ptr<Listener> createTcpListener(Address&& address, ListenOptions options)
 {
-    return rtti::createInstance<TcpListener>(std::move(address), std::move(handle), options);
+    return rtti::createInstance<TcpListener>(std::move(address), options);
 }
 
 }  // namespace my::network
@@ -1,6 +1,7 @@
 // #my_engine_source_file
 #pragma once
 
+#include "address_impl.h"
 #include "listener.h"
 #include "my/async/task.h"
 #include "my/network/network.h"
@@ -8,10 +9,32 @@
 
 namespace my::network {
 
-Ptr<Listener> createTcpListener(Address&& address, UvHandle<uv_tcp_t>&& handle, ListenOptions options);
+Ptr<Listener> createTcpListener(Address&& address, ListenOptions options);
 
 async::Task<bool> tcpConnect(uv_tcp_t* handle, const sockaddr* address);
 
 Result<bool> tcpBind(uv_tcp_t* handle, const Address& address);
 
+/**
+    Duplicates OS socket of the handle: the duplicate can be opened (uv_tcp_open) on the other loop.
+ */
+Result<uv_os_sock_t> tcpDuplicateSocket(uv_tcp_t* handle);
+
+/**
+    Returns the address the handle is bound to (with the actual port when the handle is bound to the port 0),
+    or nullptr when the handle is not bound.
+ */
+Ptr<InetAddress> tcpGetLocalAddress(uv_tcp_t* handle);
+
+/**
+    Returns true when the platform provides SO_REUSEPORT.
+ */
+bool tcpHasReusePort();
+
+/**
+    Enables SO_REUSEPORT, the handle must be initialized with the socket (uv_tcp_init_ex) and not bound yet.
+    Returns false when the option is not supported.
+ */
+bool tcpSetReusePort(uv_tcp_t* handle);
+
 }  // namespace my::network
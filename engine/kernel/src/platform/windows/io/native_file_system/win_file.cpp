@@ -467,4 +467,19 @@ namespace my::io
         // return nullptr;
     }
 
+    FilePtr openNativeFile(fs::path path, AccessModeFlag accessMode, OpenFileMode openMode)
+    {
+        if (!accessMode.has(AccessMode::Write) || openMode == OpenFileMode::OpenExisting)
+        {
+            const DWORD attributes = GetFileAttributesW(path.c_str());
+            if (attributes == INVALID_FILE_ATTRIBUTES || (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+            {
+                return nullptr;
+            }
+        }
+
+        auto file = rtti::createInstance<WinFile>(path, accessMode, openMode);
+        return file->isOpened() ? file : nullptr;
+    }
+
 }  // namespace my::io
@@ -191,6 +191,11 @@ namespace my::io
         return {};
     }
 
+    Result<FileWatcherPtr> WinNativeFileSystem::watch(const FsPath& path, FileChangeCallback callback, FileWatcherSettings settings)
+    {
+        return createNativeFileWatcher(resolveToNativePathNoCheck(path), path, std::move(callback), settings);
+    }
+
     fs::path WinNativeFileSystem::resolveToNativePath(const FsPath& path)
     {
         fs::path fullPath = m_basePath;
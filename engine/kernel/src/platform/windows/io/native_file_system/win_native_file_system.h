@@ -32,6 +32,8 @@ namespace my::io
 
         Result<> remove(const FsPath&, bool recursive = false) override;
 
+        Result<FileWatcherPtr> watch(const FsPath& path, FileChangeCallback callback, FileWatcherSettings settings) override;
+
         std::filesystem::path resolveToNativePath(const FsPath& path) override;
 
     private:
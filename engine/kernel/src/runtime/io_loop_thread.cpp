@@ -0,0 +1,73 @@
+// #my_engine_source_file
+#include "io_loop_thread.h"
+
+#include "my/runtime/internal/runtime_object_registry.h"
+#include "my/threading/event.h"
+#include "my/threading/set_thread_name.h"
+#include "runtime/runtime_executor.h"
+
+using namespace my::my_literals;
+
+namespace my {
+
+namespace {
+
+constexpr Byte IoLoopMemorySize = 2_Mb;
+
+}  // namespace
+
+IoLoopThread::IoLoopThread(size_t index) :
+    m_loop(createHostVirtualMemory(IoLoopMemorySize, true))
+{
+    threading::Event loopStarted;
+
+    m_thread = std::thread([](IoLoopThread& self, size_t index, threading::Event& loopStarted)
+    {
+        threading::setThisThreadName(std::format("Network I/O ({})", index + 1));
+
+        self.m_loop.bindToCurrentThread();
+
+        async::ExecutorPtr executor = rtti::createInstance<RuntimeThreadExecutor>(self.m_loop);
+        RuntimeObjectRegistration{executor}.setAutoRemove();
+        self.m_loop.setExecutor(std::move(executor));
+        loopStarted.set();
+
+        while (!self.m_isStopRequested)
+        {
+            uv_run(self.m_loop.uv(), UV_RUN_DEFAULT);
+        }
+
+        self.m_loop.setExecutor(nullptr);
+        self.m_loop.close();
+    }, std::ref(*this), index, std::ref(loopStarted));
+
+    loopStarted.wait();
+}
+
+IoLoopThread::~IoLoopThread()
+{
+    stop();
+}
+
+UvLoop& IoLoopThread::getLoop()
+{
+    return m_loop;
+}
+
+void IoLoopThread::stop()
+{
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+
+    m_isStopRequested = true;
+    m_loop.getExecutor()->execute([](void* loopPtr, void*) noexcept
+    {
+        uv_stop(static_cast<UvLoop*>(loopPtr)->uv());
+    }, &m_loop, nullptr);
+
+    m_thread.join();
+}
+
+}  // namespace my
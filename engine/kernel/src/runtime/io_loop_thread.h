@@ -0,0 +1,34 @@
+// #my_engine_source_file
+#pragma once
+
+#include "runtime/uv_loop.h"
+
+#include <thread>
+
+namespace my {
+
+/**
+    Thread that runs its own libuv loop. Sockets that are created on the loop are served only by this thread.
+ */
+class IoLoopThread
+{
+public:
+    IoLoopThread(size_t index);
+    IoLoopThread(const IoLoopThread&) = delete;
+    ~IoLoopThread();
+
+    UvLoop& getLoop();
+
+    /**
+        Stops the loop and waits the thread completion.
+        Must be called when all the loop's handles (the sockets) are closed.
+     */
+    void stop();
+
+private:
+    UvLoop m_loop;
+    std::thread m_thread;
+    std::atomic<bool> m_isStopRequested = false;
+};
+
+}  // namespace my
@@ -3,7 +3,6 @@
 #include "my/async/async_timer.h"
 #include "my/async/thread_pool_executor.h"
 #include "my/diag/logging.h"
-#include "my/memory/fixed_size_block_allocator.h"
 #include "my/runtime/disposable.h"
 #include "my/runtime/internal/runtime_component.h"
 #include "my/runtime/internal/runtime_object_registry.h"
@@ -40,6 +39,7 @@ KernelRuntimeImpl::KernelRuntimeImpl()
     Executor::setDefault(m_defaultExecutor);
 
     m_runtimeMemory = createHostVirtualMemory(RuntimeMemorySize, true);
+    m_loop.emplace(m_runtimeMemory);
 }
 
 KernelRuntimeImpl::~KernelRuntimeImpl()
@@ -67,17 +67,13 @@ void KernelRuntimeImpl::bindToCurrentThread()
     MY_DEBUG_ASSERT(getState() == RuntimeState::NotInitialized, "Runtime already initialized");
     MY_DEBUG_ASSERT(m_threadId == std::thread::id{});
     m_threadId = std::this_thread::get_id();
-
-    UV_VERIFY(uv_loop_init(&m_uv));
-    const size_t uvHandleBlockSize = getUvHandleMaxSize();
-    m_uvHandleAllocator = createFixedSizeBlockAllocator(m_runtimeMemory, uvHandleBlockSize, false);
-    m_internalHandles = decltype(m_internalHandles){m_uvHandleAllocator->GetMemoryResource()};
+    m_loop->bindToCurrentThread();
 
     ITimerManager::setDefaultInstance();
 
-
-    m_runtimeExecutor = rtti::createInstance<RuntimeThreadExecutor>();
-    RuntimeObjectRegistration{m_runtimeExecutor}.setAutoRemove();
+    async::ExecutorPtr runtimeExecutor = rtti::createInstance<RuntimeThreadExecutor>(*m_loop);
+    RuntimeObjectRegistration{runtimeExecutor}.setAutoRemove();
+    m_loop->setExecutor(std::move(runtimeExecutor));
     m_state = RuntimeState::Operable;
 }
 
@@ -89,8 +85,8 @@ std::thread::id KernelRuntimeImpl::getRuntimeThreadId() const
 
 async::ExecutorPtr KernelRuntimeImpl::getRuntimeExecutor()
 {
-    MY_DEBUG_ASSERT(m_threadId != std::thread::id{} && m_runtimeExecutor);
-    return m_runtimeExecutor;
+    MY_DEBUG_ASSERT(m_threadId != std::thread::id{});
+    return m_loop->getExecutor();
 }
 
 bool KernelRuntimeImpl::poll(RuntimePollMode mode)
@@ -104,7 +100,7 @@ bool KernelRuntimeImpl::poll(RuntimePollMode mode)
     const uv_run_mode runMode =
         (m_state == RuntimeState::Operable && mode == RuntimePollMode::Default) ? UV_RUN_DEFAULT : UV_RUN_NOWAIT;
 
-    [[maybe_unused]] const bool hasReferences = uv_run(&m_uv, runMode) != 0;
+    [[maybe_unused]] const bool hasReferences = uv_run(m_loop->uv(), runMode) != 0;
     if (m_state == RuntimeState::ShutdownProcessed)
     {
         const bool stillHasRuntimeReferences = shutdownStep(true);
@@ -165,7 +161,7 @@ void KernelRuntimeImpl::shutdown()
         }
     });
 
-    m_runtimeExecutor->execute([](void* selfPtr, void*) noexcept
+    m_loop->getExecutor()->execute([](void* selfPtr, void*) noexcept
     {
         KernelRuntimeImpl& self = *static_cast<KernelRuntimeImpl*>(selfPtr);
         self.m_shutdownStartTime = std::chrono::system_clock::now();
@@ -229,16 +225,21 @@ bool KernelRuntimeImpl::shutdownStep(bool doCompleteShutdown)
     // Checking uv external references.
     // (anyway in most cases uv objects existence must correlate with runtime objects)
     auto walkState = std::tuple{this, &externalUvHandlesCount};
-    uv_walk(&m_uv, [](uv_handle_t* handle, void* arg) noexcept
+    uv_walk(m_loop->uv(), [](uv_handle_t* handle, void* arg) noexcept
     {
         auto& [self, handleCounter] = *static_cast<decltype(walkState)*>(arg);
-        const bool isInternalHandle = std::find(self->m_internalHandles.begin(), self->m_internalHandles.end(), handle) != self->m_internalHandles.end();
-        if (!isInternalHandle)
+        if (!self->m_loop->isInternalHandle(handle))
         {
             ++handleCounter;
         }
     }, &walkState);
 
+    // I/O loops can not be walked from the runtime thread: the loops count their handles themselves.
+    for (const std::unique_ptr<IoLoopThread>& ioThread : m_ioThreads)
+    {
+        externalUvHandlesCount += ioThread->getLoop().getExternalHandlesCount();
+    }
+
     bool canCompleteShutdown = !(hasPendingWorks || hasReferencedExecutors || hasReferencedNonExecutors || externalUvHandlesCount > 0);
     if (!canCompleteShutdown && (!hasPendingWorks && !hasReferencedNonExecutors))
     {
@@ -279,17 +280,15 @@ void KernelRuntimeImpl::completeShutdown()
         m_state = RuntimeState::ShutdownCompleted;
     };
 
-    m_runtimeExecutor.reset();
-
-    while (uv_loop_alive(&m_uv) != 0)
+    // I/O threads are stopped first: theirs executors are registered runtime objects and the loops can schedule the work for the runtime thread.
+    for (const std::unique_ptr<IoLoopThread>& ioThread : m_ioThreads)
     {
-        if (uv_run(&m_uv, UV_RUN_NOWAIT) == 0)
-        {
-            break;
-        }
+        ioThread->stop();
     }
+    m_ioThreads.clear();
 
-    [[maybe_unused]] const int res = uv_loop_close(&m_uv);
+    m_loop->setExecutor(nullptr);
+    m_loop->close();
 
     Executor::setDefault(nullptr);
     m_defaultExecutor.reset();
@@ -300,18 +299,67 @@ void KernelRuntimeImpl::completeShutdown()
 
 uv_loop_t* KernelRuntimeImpl::uv()
 {
-    return &m_uv;
+    return m_loop->uv();
+}
+
+UvLoop& KernelRuntimeImpl::getLoop()
+{
+    return *m_loop;
 }
 
 IAllocator& KernelRuntimeImpl::getUvHandleAllocator() const
 {
-    return *m_uvHandleAllocator;
+    return m_loop->getUvHandleAllocator();
 }
 
 void KernelRuntimeImpl::setHandleAsInternal(const uv_handle_t* handle)
 {
-    MY_DEBUG_ASSERT(m_threadId == std::this_thread::get_id());
-    m_internalHandles.push_back(handle);
+    m_loop->setHandleAsInternal(handle);
+}
+
+Result<> KernelRuntimeImpl::startIoThreads(size_t threadsCount)
+{
+    MY_DEBUG_ASSERT(isRuntimeThread());
+    if (m_state != RuntimeState::Operable)
+    {
+        return MakeError("Runtime is not operable");
+    }
+
+    if (!m_ioThreads.empty())
+    {
+        return MakeError("I/O threads already started");
+    }
+
+    m_ioThreads.reserve(threadsCount);
+    for (size_t i = 0; i < threadsCount; ++i)
+    {
+        m_ioThreads.emplace_back(std::make_unique<IoLoopThread>(i));
+    }
+
+    return kResultSuccess;
+}
+
+std::vector<UvLoop*> KernelRuntimeImpl::getIoLoops() const
+{
+    std::vector<UvLoop*> loops;
+    loops.reserve(m_ioThreads.size());
+    for (const std::unique_ptr<IoLoopThread>& ioThread : m_ioThreads)
+    {
+        loops.push_back(&ioThread->getLoop());
+    }
+
+    return loops;
+}
+
+UvLoop& KernelRuntimeImpl::selectIoLoop()
+{
+    if (m_ioThreads.empty())
+    {
+        return *m_loop;
+    }
+
+    const size_t index = m_nextIoThread.fetch_add(1, std::memory_order_relaxed) % m_ioThreads.size();
+    return m_ioThreads[index]->getLoop();
 }
 
 KernelRuntimePtr createKernelRuntime()
@@ -6,6 +6,9 @@
 #include "my/memory/allocator.h"
 #include "my/memory/singleton_memop.h"
 #include "my/runtime/internal/kernel_runtime.h"
+#include "my/utils/result.h"
+#include "runtime/io_loop_thread.h"
+#include "runtime/uv_loop.h"
 
 
 namespace my {
@@ -25,21 +28,36 @@ public:
     void shutdown() override;
 
     uv_loop_t* uv();
+    UvLoop& getLoop();
     IAllocator& getUvHandleAllocator() const;
     void setHandleAsInternal(const uv_handle_t* handle);
 
+    /**
+        Starts I/O threads, each one runs its own loop. Must be called on the runtime thread.
+     */
+    Result<> startIoThreads(size_t threadsCount);
+
+    /**
+        Returns loops of the I/O threads (empty when I/O threads are not started).
+     */
+    std::vector<UvLoop*> getIoLoops() const;
+
+    /**
+        Returns the next I/O loop (round-robin) for the new socket, or the runtime loop when there are no I/O threads.
+     */
+    UvLoop& selectIoLoop();
+
 private:
     bool shutdownStep(bool doCompleteShutdown);
     void completeShutdown();
 
     std::atomic<RuntimeState> m_state = RuntimeState::NotInitialized;
     HostMemoryPtr m_runtimeMemory;
-    AllocatorPtr m_uvHandleAllocator;
     async::ExecutorPtr m_defaultExecutor;
-    async::ExecutorPtr m_runtimeExecutor;
-    uv_loop_t m_uv;
+    std::optional<UvLoop> m_loop;
     std::thread::id m_threadId = std::thread::id{};
-    std::pmr::list<const uv_handle_t*> m_internalHandles;
+    std::vector<std::unique_ptr<IoLoopThread>> m_ioThreads;
+    std::atomic<size_t> m_nextIoThread = 0;
 
     std::chrono::system_clock::time_point m_shutdownStartTime;
     bool m_shutdownTooLongWarningShowed = false;
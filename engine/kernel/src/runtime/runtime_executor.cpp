@@ -2,21 +2,22 @@
 #include "runtime_executor.h"
 
 #include "my/threading/lock_guard.h"
-#include "runtime/kernel_runtime_impl.h"
 
 namespace my {
 
-RuntimeThreadExecutor::RuntimeThreadExecutor() :
-    m_invocations(getKernelRuntimeImpl().getUvHandleAllocator().GetMemoryResource())
+RuntimeThreadExecutor::RuntimeThreadExecutor(UvLoop& loop) :
+    m_invocations(loop.getUvHandleAllocator().GetMemoryResource())
 {
-    uv_async_init(getKernelRuntimeImpl().uv(), m_async, [](uv_async_t* const handle) noexcept
+    MY_DEBUG_ASSERT(loop.isLoopThread());
+
+    uv_async_init(loop.uv(), m_async, [](uv_async_t* const handle) noexcept
     {
         RuntimeThreadExecutor& self = *static_cast<RuntimeThreadExecutor*>(handle->data);
         const Executor::InvokeGuard invokeGuard{self};
 
         while (true)
         {
-            decltype(m_invocations) invocations{getKernelRuntimeImpl().getUvHandleAllocator().GetMemoryResource()};
+            decltype(m_invocations) invocations{self.m_invocations.get_allocator()};
 
             {
                 const std::lock_guard lock(self.m_invocationsMutex);
@@ -43,7 +44,7 @@ RuntimeThreadExecutor::RuntimeThreadExecutor() :
     });
 
     uv_handle_set_data(m_async, this);
-    getKernelRuntimeImpl().setHandleAsInternal(m_async);
+    loop.setHandleAsInternal(m_async);
 }
 
 void RuntimeThreadExecutor::waitAnyActivity() noexcept
@@ -8,16 +8,20 @@
 #include "my/runtime/internal/runtime_component.h"
 #include "my/threading/critical_section.h"
 #include "runtime/uv_handle.h"
+#include "runtime/uv_loop.h"
 
 
 namespace my {
 
+/**
+    Executes invocations on the loop's thread. Must be created on the loop's thread.
+ */
 class RuntimeThreadExecutor final : public async::Executor, public IRuntimeComponent
 {
     MY_REFCOUNTED_CLASS(my::RuntimeThreadExecutor, async::Executor, IRuntimeComponent)
 
 public:
-    RuntimeThreadExecutor();
+    RuntimeThreadExecutor(UvLoop& loop);
 
 private:
     void waitAnyActivity() noexcept override;
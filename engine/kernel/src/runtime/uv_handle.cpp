@@ -10,11 +10,13 @@ static_assert(IsAssignableUvHandles<uv_handle_t, uv_udp_t>);
 static_assert(IsAssignableUvHandles<uv_handle_t, uv_pipe_t>);
 static_assert(IsAssignableUvHandles<uv_handle_t, uv_tty_t>);
 static_assert(IsAssignableUvHandles<uv_handle_t, uv_timer_t>);
+static_assert(IsAssignableUvHandles<uv_handle_t, uv_fs_event_t>);
 static_assert(IsAssignableUvHandles<uv_stream_t, uv_tcp_t>);
 static_assert(IsAssignableUvHandles<uv_stream_t, uv_pipe_t>);
 static_assert(IsAssignableUvHandles<uv_stream_t, uv_tty_t>);
 static_assert(!IsAssignableUvHandles<uv_stream_t, uv_udp_t>);
 static_assert(!IsAssignableUvHandles<uv_stream_t, uv_timer_t>);
+static_assert(!IsAssignableUvHandles<uv_stream_t, uv_fs_event_t>);
 
 static_assert(!IsUvStreamCompatible<uv_timer_t>);
 static_assert(!IsUvStreamCompatible<uv_udp_t>);
@@ -30,19 +32,19 @@ namespace {
 
 constexpr size_t UvHandleBadSize = static_cast<size_t>(-1);
 
-inline void* allocateHandleMem(size_t size)
+/**
+    Handle is allocated from the loop of the current thread (the runtime loop when the current thread has no loop),
+    the handle must be initialized with the same loop.
+ */
+inline UvLoop& getAllocationLoop()
 {
-    void* const mem = getKernelRuntimeImpl().getUvHandleAllocator().alloc(size);
-    MY_DEBUG_FATAL(mem);
-#ifndef NDEBUG
-    memset(mem, 0, size);
-#endif
-    return mem;
+    UvLoop* const currentLoop = UvLoop::getCurrent();
+    return currentLoop ? *currentLoop : getKernelRuntimeImpl().getLoop();
 }
 
-inline void freeHandleMem(void* mem)
+inline void* allocateHandleMem(size_t size)
 {
-    getKernelRuntimeImpl().getUvHandleAllocator().free(mem);
+    return getAllocationLoop().allocateHandleMem(size);
 }
 
 template <typename T>
@@ -64,7 +66,7 @@ inline uv_handle_t* allocateHandle(uv_handle_type type)
 void freeHandle(uv_handle_t* handle)
 {
     MY_DEBUG_ASSERT(handle);
-    freeHandleMem(handle);
+    UvLoop::fromUv(handle->loop).freeHandleMem(handle);
 }
 
 void closeAndFreeUvHandle(uv_handle_t* handle)
@@ -92,7 +94,7 @@ void closeAndFreeUvHandle(uv_handle_t* handle)
             const auto res = uv_shutdown(request, stream, [](uv_shutdown_t* request, [[maybe_unused]] int status) noexcept
             {
                 uv_handle_t* const handle = reinterpret_cast<uv_handle_t*>(request->handle);
-                freeHandleMem(request);
+                UvLoop::fromUv(handle->loop).freeHandleMem(request);
                 uv_close(handle, freeHandle);
             });
 
@@ -103,7 +105,7 @@ void closeAndFreeUvHandle(uv_handle_t* handle)
                 return;
             }
 
-            freeHandleMem(request);
+            UvLoop::fromUv(handle->loop).freeHandleMem(request);
         }
     }
 
@@ -142,18 +144,24 @@ void UvHandleBase::resetInternal(uv_handle_t* newHandle)
 #endif
 
     uv_handle_t* const prevHandle = std::exchange(m_handle, newHandle);
+    if (!prevHandle)
+    {
+        return;
+    }
 
-    if (getKernelRuntimeImpl().isRuntimeThread())
+    // handle must be closed on its loop's thread
+    UvLoop& loop = UvLoop::fromUv(prevHandle->loop);
+    if (loop.isLoopThread())
     {
         closeAndFreeUvHandle(prevHandle);
     }
     else
     {
-        [](uv_handle_t* handle) -> async::Task<>
+        [](async::ExecutorPtr executor, uv_handle_t* handle) -> async::Task<>
         {
-            co_await getKernelRuntimeImpl().getRuntimeExecutor();
+            co_await executor;
             closeAndFreeUvHandle(handle);
-        }(prevHandle).detach();
+        }(loop.getExecutor(), prevHandle).detach();
     }
 }
 
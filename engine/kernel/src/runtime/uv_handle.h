@@ -18,7 +18,8 @@ using KnownUvHandles = TypeList<
     uv_tcp_t,
     uv_pipe_t,
     uv_tty_t,
-    uv_udp_t>;
+    uv_udp_t,
+    uv_fs_event_t>;
 
 namespace kernel_detail {
 
@@ -90,6 +91,10 @@ consteval uv_handle_type getUvHandleType()
     {
         return UV_NAMED_PIPE;
     }
+    else if constexpr (std::is_same_v<T, uv_fs_event_t>)
+    {
+        return UV_FS_EVENT;
+    }
 
     return UV_UNKNOWN_HANDLE;
 }
@@ -0,0 +1,145 @@
+// #my_engine_source_file
+#include "uv_loop.h"
+
+#include "my/memory/fixed_size_block_allocator.h"
+#include "runtime/uv_handle.h"
+#include "runtime/uv_utils.h"
+
+namespace my {
+
+namespace {
+
+thread_local UvLoop* s_currentLoop = nullptr;
+
+}  // namespace
+
+UvLoop& UvLoop::fromUv(const uv_loop_t* loop)
+{
+    MY_DEBUG_FATAL(loop && loop->data);
+    return *static_cast<UvLoop*>(loop->data);
+}
+
+UvLoop* UvLoop::getCurrent()
+{
+    return s_currentLoop;
+}
+
+UvLoop::UvLoop(HostMemoryPtr memory) :
+    m_memory(std::move(memory))
+{
+    MY_DEBUG_ASSERT(m_memory);
+}
+
+UvLoop::~UvLoop()
+{
+    MY_DEBUG_ASSERT(m_threadId == std::thread::id{}, "Loop is not closed");
+}
+
+void UvLoop::bindToCurrentThread()
+{
+    MY_DEBUG_ASSERT(m_threadId == std::thread::id{}, "Loop already bound to thread");
+    MY_DEBUG_ASSERT(s_currentLoop == nullptr, "Thread already has the loop");
+
+    m_threadId = std::this_thread::get_id();
+    s_currentLoop = this;
+
+    UV_VERIFY(uv_loop_init(&m_uv));
+    m_uv.data = this;
+
+    const size_t uvHandleBlockSize = getUvHandleMaxSize();
+    m_uvHandleAllocator = createFixedSizeBlockAllocator(m_memory, uvHandleBlockSize, false);
+}
+
+void UvLoop::close()
+{
+    MY_DEBUG_ASSERT(isLoopThread());
+    MY_DEBUG_ASSERT(!m_executor, "Executor must be released before the loop is closed");
+
+    while (uv_loop_alive(&m_uv) != 0)
+    {
+        if (uv_run(&m_uv, UV_RUN_NOWAIT) == 0)
+        {
+            break;
+        }
+    }
+
+    [[maybe_unused]] const int res = uv_loop_close(&m_uv);
+
+    s_currentLoop = nullptr;
+    m_threadId = std::thread::id{};
+}
+
+uv_loop_t* UvLoop::uv()
+{
+    return &m_uv;
+}
+
+IAllocator& UvLoop::getUvHandleAllocator() const
+{
+    MY_DEBUG_ASSERT(m_uvHandleAllocator);
+    return *m_uvHandleAllocator;
+}
+
+std::thread::id UvLoop::getThreadId() const
+{
+    return m_threadId;
+}
+
+bool UvLoop::isLoopThread() const
+{
+    return m_threadId == std::this_thread::get_id();
+}
+
+async::ExecutorPtr UvLoop::getExecutor() const
+{
+    MY_DEBUG_ASSERT(m_executor);
+    return m_executor;
+}
+
+void UvLoop::setExecutor(async::ExecutorPtr executor)
+{
+    MY_DEBUG_ASSERT(isLoopThread());
+    m_executor = std::move(executor);
+}
+
+void UvLoop::setHandleAsInternal(const uv_handle_t* handle)
+{
+    MY_DEBUG_ASSERT(isLoopThread());
+    m_internalHandles.push_back(handle);
+    m_internalCount.fetch_add(1);
+}
+
+bool UvLoop::isInternalHandle(const uv_handle_t* handle) const
+{
+    return std::find(m_internalHandles.begin(), m_internalHandles.end(), handle) != m_internalHandles.end();
+}
+
+size_t UvLoop::getExternalHandlesCount() const
+{
+    const size_t allocatedCount = m_allocatedCount.load();
+    const size_t internalCount = m_internalCount.load();
+    return allocatedCount > internalCount ? allocatedCount - internalCount : 0;
+}
+
+void* UvLoop::allocateHandleMem(size_t size)
+{
+    void* const mem = getUvHandleAllocator().alloc(size);
+    MY_DEBUG_FATAL(mem);
+#ifndef NDEBUG
+    memset(mem, 0, size);
+#endif
+
+    m_allocatedCount.fetch_add(1);
+    return mem;
+}
+
+void UvLoop::freeHandleMem(void* mem)
+{
+    MY_DEBUG_ASSERT(isLoopThread());
+    MY_DEBUG_ASSERT(m_allocatedCount > 0);
+
+    getUvHandleAllocator().free(mem);
+    m_allocatedCount.fetch_sub(1);
+}
+
+}  // namespace my
@@ -0,0 +1,79 @@
+// #my_engine_source_file
+#pragma once
+
+#include "my/async/executor.h"
+#include "my/memory/allocator.h"
+#include "my/memory/host_memory.h"
+
+#include <uv.h>
+
+#include <atomic>
+#include <list>
+#include <thread>
+
+namespace my {
+
+/**
+    libuv loop bound to the single thread.
+    The loop is attached to uv_loop_t::data, so any handle knows its loop (see UvLoop::fromUv(handle->loop)).
+    Handles of the loop are allocated from the loop's own allocator and must be used and closed only on the loop's thread.
+ */
+class UvLoop
+{
+public:
+    /**
+        Returns loop of the handle.
+     */
+    static UvLoop& fromUv(const uv_loop_t* loop);
+
+    /**
+        Returns loop that is bound to the current thread or nullptr.
+     */
+    static UvLoop* getCurrent();
+
+    UvLoop(HostMemoryPtr memory);
+    UvLoop(const UvLoop&) = delete;
+    ~UvLoop();
+
+    /**
+        Initializes loop and binds it to the current thread.
+     */
+    void bindToCurrentThread();
+
+    /**
+        Runs the loop until all close callbacks are invoked and closes the loop.
+     */
+    void close();
+
+    uv_loop_t* uv();
+    IAllocator& getUvHandleAllocator() const;
+    std::thread::id getThreadId() const;
+    bool isLoopThread() const;
+
+    async::ExecutorPtr getExecutor() const;
+    void setExecutor(async::ExecutorPtr executor);
+
+    void setHandleAsInternal(const uv_handle_t* handle);
+    bool isInternalHandle(const uv_handle_t* handle) const;
+
+    /**
+        Handles (and requests) that are allocated from the loop and still not freed, except internal handles.
+        Can be called from any thread.
+     */
+    size_t getExternalHandlesCount() const;
+
+    void* allocateHandleMem(size_t size);
+    void freeHandleMem(void* mem);
+
+private:
+    HostMemoryPtr m_memory;
+    AllocatorPtr m_uvHandleAllocator;
+    async::ExecutorPtr m_executor;
+    uv_loop_t m_uv;
+    std::thread::id m_threadId = std::thread::id{};
+    std::list<const uv_handle_t*> m_internalHandles;
+    std::atomic<size_t> m_allocatedCount = 0;
+    std::atomic<size_t> m_internalCount = 0;
+};
+
+}  // namespace my
@@ -0,0 +1,679 @@
+// #my_engine_source_file
+
+#include "my/serialization/config_blob.h"
+
+#include "my/rtti/rtti_impl.h"
+#include "my/serialization/runtime_value_builder.h"
+#include "my/serialization/serialization.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace my::config_blob_detail
+{
+    namespace
+    {
+        // the image is used directly from the memory: all the records are stored in the native (little endian) layout.
+        static_assert(std::endian::native == std::endian::little);
+
+        constexpr std::array<char, 4> BlobMagic = {'M', 'Y', 'C', 'B'};
+        constexpr uint32_t BlobVersion = 1;
+        constexpr size_t MaxDepth = 512;
+
+        constexpr std::string_view NonMutableValueError = "Attempt to modify non mutable config blob value";
+
+        enum class BlobValueType : uint8_t
+        {
+            Null,
+            Boolean,
+            Integer,
+            UnsignedInteger,
+            Float,
+            String,
+            Collection,
+            Dictionary
+        };
+
+        /**
+            Scalars are stored inplace (payload), strings refer to the string table (payload: offset, size: length),
+            containers refer to the records array (payload: offset from the image begin, size: elements count).
+         */
+        struct BlobValue
+        {
+            BlobValueType type = BlobValueType::Null;
+            std::array<uint8_t, 3> reserved = {};
+            uint32_t size = 0;
+            uint64_t payload = 0;
+        };
+
+        /**
+            Dictionary members are sorted by key (byte-wise).
+         */
+        struct BlobMember
+        {
+            uint32_t keyOffset = 0;
+            uint32_t keySize = 0;
+            BlobValue value;
+        };
+
+        struct BlobHeader
+        {
+            std::array<char, 4> magic = BlobMagic;
+            uint32_t version = BlobVersion;
+            uint32_t size = 0;
+            uint32_t stringsOffset = 0;
+            uint32_t stringsSize = 0;
+            uint32_t reserved = 0;
+            BlobValue root;
+        };
+
+        static_assert(sizeof(BlobValue) == 16);
+        static_assert(sizeof(BlobMember) == 24);
+        static_assert(sizeof(BlobHeader) == 40);
+        static_assert(std::is_trivially_copyable_v<BlobHeader> && std::is_trivially_copyable_v<BlobMember>);
+
+        constexpr size_t BlobAlignment = alignof(BlobHeader);
+
+        Result<> validateHeader(std::span<const std::byte> data)
+        {
+            if (data.size() < sizeof(BlobHeader))
+            {
+                return MakeErrorT(serialization::EndOfStreamError)();
+            }
+
+            if (reinterpret_cast<uintptr_t>(data.data()) % BlobAlignment != 0)
+            {
+                return MakeError("Config blob data is not aligned");
+            }
+
+            const auto& header = *reinterpret_cast<const BlobHeader*>(data.data());
+            if (header.magic != BlobMagic)
+            {
+                return MakeError("Data is not a config blob");
+            }
+
+            if (header.version != BlobVersion)
+            {
+                return MakeError("Unsupported config blob version ({})", header.version);
+            }
+
+            const bool isValidLayout = header.size <= data.size() &&
+                                       header.stringsOffset >= sizeof(BlobHeader) &&
+                                       header.stringsOffset % BlobAlignment == 0 &&
+                                       static_cast<uint64_t>(header.stringsOffset) + header.stringsSize <= header.size;
+
+            if (!isValidLayout)
+            {
+                return MakeError("Config blob is corrupted");
+            }
+
+            return kResultSuccess;
+        }
+
+        /**
+            Builds the image: records area grows after the header, strings are collected separately and appended at the end.
+         */
+        class ConfigBlobWriter
+        {
+        public:
+            ConfigBlobWriter()
+            {
+                m_records.resize(sizeof(BlobHeader));
+            }
+
+            Result<> writeRoot(const RuntimeValuePtr& value)
+            {
+                Result<BlobValue> root = encodeValue(value, 0);
+                CheckResult(root);
+
+                BlobHeader header;
+                header.root = *root;
+                header.stringsOffset = static_cast<uint32_t>(m_records.size());
+                header.stringsSize = static_cast<uint32_t>(m_strings.size());
+
+                const uint64_t size = static_cast<uint64_t>(m_records.size()) + m_strings.size();
+                if (size > std::numeric_limits<uint32_t>::max())
+                {
+                    return MakeError("Config blob is too large ({} bytes)", size);
+                }
+
+                header.size = static_cast<uint32_t>(size);
+                storeRecord(0, header);
+
+                return kResultSuccess;
+            }
+
+            Result<> writeToStream(io::IStream& stream) const
+            {
+                CheckResult(writeBytes(stream, m_records.data(), m_records.size()));
+                return writeBytes(stream, reinterpret_cast<const std::byte*>(m_strings.data()), m_strings.size());
+            }
+
+        private:
+            static Result<> writeBytes(io::IStream& stream, const std::byte* data, size_t size)
+            {
+                for (size_t offset = 0; offset < size;)
+                {
+                    Result<size_t> written = stream.write(data + offset, size - offset);
+                    CheckResult(written);
+                    if (*written == 0)
+                    {
+                        return MakeErrorT(serialization::SerializationError)("Stream write failed");
+                    }
+
+                    offset += *written;
+                }
+
+                return kResultSuccess;
+            }
+
+            template <typename T>
+            Result<uint32_t> allocateRecords(size_t count)
+            {
+                const size_t offset = m_records.size();
+                const size_t size = offset + sizeof(T) * count;
+                if (size > std::numeric_limits<uint32_t>::max())
+                {
+                    return MakeError("Config blob is too large");
+                }
+
+                m_records.resize(size);
+                return static_cast<uint32_t>(offset);
+            }
+
+            // records are addressed by offset: encoding the nested values reallocates the storage.
+            template <typename T>
+            void storeRecord(size_t offset, const T& record)
+            {
+                MY_DEBUG_ASSERT(offset + sizeof(T) <= m_records.size());
+                memcpy(m_records.data() + offset, &record, sizeof(T));
+            }
+
+            Result<std::pair<uint32_t, uint32_t>> addString(std::string_view str)
+            {
+                if (str.size() > std::numeric_limits<uint32_t>::max())
+                {
+                    return MakeError("String is too long");
+                }
+
+                const uint32_t size = static_cast<uint32_t>(str.size());
+                if (auto iter = m_stringOffsets.find(str); iter != m_stringOffsets.end())
+                {
+                    return std::pair{iter->second, size};
+                }
+
+                if (m_strings.size() + str.size() + 1 > std::numeric_limits<uint32_t>::max())
+                {
+                    return MakeError("Config blob is too large");
+                }
+
+                // strings are zero terminated, so the views can be passed to the C api as is.
+                const uint32_t offset = static_cast<uint32_t>(m_strings.size());
+                m_strings.append(str);
+                m_strings.push_back('\0');
+                m_stringOffsets.emplace(std::string{str}, offset);
+
+                return std::pair{offset, size};
+            }
+
+            Result<BlobValue> encodeValue(const RuntimeValuePtr& value, size_t depth)
+            {
+                if (depth > MaxDepth)
+                {
+                    return MakeError("Maximum nesting depth exceeded");
+                }
+
+                BlobValue result;
+
+                if (!value)
+                {
+                    result.type = BlobValueType::Null;
+                }
+                else if (OptionalValue* const optionalValue = value->as<OptionalValue*>())
+                {
+                    return encodeValue(optionalValue->hasValue() ? optionalValue->getValue() : nullptr, depth);
+                }
+                else if (RuntimeValueRef* const refValue = value->as<RuntimeValueRef*>())
+                {
+                    return encodeValue(refValue->getValue(), depth);
+                }
+                else if (const auto* const integer = value->as<const IntegerValue*>())
+                {
+                    result.type = integer->isSigned() ? BlobValueType::Integer : BlobValueType::UnsignedInteger;
+                    result.payload = integer->isSigned() ? static_cast<uint64_t>(integer->getInt64()) : integer->getUint64();
+                }
+                else if (const auto* const floatPoint = value->as<const FloatValue*>())
+                {
+                    result.type = BlobValueType::Float;
+                    result.payload = std::bit_cast<uint64_t>(floatPoint->getDouble());
+                }
+                else if (const auto* const boolValue = value->as<const BooleanValue*>())
+                {
+                    result.type = BlobValueType::Boolean;
+                    result.payload = boolValue->getBool() ? 1 : 0;
+                }
+                else if (const auto* const str = value->as<const StringValue*>())
+                {
+                    Result<std::pair<uint32_t, uint32_t>> strRef = addString(str->getString());
+                    CheckResult(strRef);
+
+                    result.type = BlobValueType::String;
+                    result.payload = strRef->first;
+                    result.size = strRef->second;
+                }
+                else if (ReadonlyCollection* const collection = value->as<ReadonlyCollection*>())
+                {
+                    const size_t size = collection->getSize();
+                    Result<uint32_t> offset = allocateRecords<BlobValue>(size);
+                    CheckResult(offset);
+
+                    for (size_t i = 0; i < size; ++i)
+                    {
+                        Result<BlobValue> element = encodeValue(collection->getAt(i), depth + 1);
+                        CheckResult(element);
+                        storeRecord(*offset + i * sizeof(BlobValue), *element);
+                    }
+
+                    result.type = BlobValueType::Collection;
+                    result.payload = *offset;
+                    result.size = static_cast<uint32_t>(size);
+                }
+                else if (ReadonlyDictionary* const dict = value->as<ReadonlyDictionary*>())
+                {
+                    const size_t size = dict->getSize();
+                    std::vector<std::string> keys;
+                    keys.reserve(size);
+                    for (size_t i = 0; i < size; ++i)
+                    {
+                        keys.emplace_back(dict->getKey(i));
+                    }
+
+                    std::sort(keys.begin(), keys.end());
+
+                    Result<uint32_t> offset = allocateRecords<BlobMember>(size);
+                    CheckResult(offset);
+
+                    for (size_t i = 0; i < size; ++i)
+                    {
+                        Result<std::pair<uint32_t, uint32_t>> keyRef = addString(keys[i]);
+                        CheckResult(keyRef);
+
+                        Result<BlobValue> memberValue = encodeValue(dict->getValue(keys[i]), depth + 1);
+                        CheckResult(memberValue);
+
+                        storeRecord(*offset + i * sizeof(BlobMember), BlobMember{keyRef->first, keyRef->second, *memberValue});
+                    }
+
+                    result.type = BlobValueType::Dictionary;
+                    result.payload = *offset;
+                    result.size = static_cast<uint32_t>(size);
+                }
+                else
+                {
+                    // native values (RuntimeNativeValue) can not be represented by the image
+                    return MakeErrorT(serialization::SerializationError)(std::format("Unsupported runtime value type ({})", typeid(*value).name()));
+                }
+
+                return result;
+            }
+
+            std::vector<std::byte> m_records;
+            std::string m_strings;
+            std::map<std::string, uint32_t, std::less<>> m_stringOffsets;
+        };
+
+        /**
+            Keeps the image memory alive (the buffer or the file mapping), all the values are the views into it.
+         */
+        class ConfigBlobDocument final : public virtual IRefCounted
+        {
+            MY_REFCOUNTED_CLASS(my::config_blob_detail::ConfigBlobDocument, IRefCounted)
+
+        public:
+            ConfigBlobDocument(ReadOnlyBuffer buffer, IAllocator* allocator) :
+                m_buffer(std::move(buffer)),
+                m_data(m_buffer.data(), m_buffer.size()),
+                m_allocator(allocator)
+            {
+            }
+
+            ConfigBlobDocument(Ptr<io::IMemoryMappableObject> mapping, std::span<const std::byte> data, IAllocator* allocator) :
+                m_mapping(std::move(mapping)),
+                m_data(data),
+                m_allocator(allocator)
+            {
+            }
+
+            ~ConfigBlobDocument()
+            {
+                if (m_mapping)
+                {
+                    m_mapping->memUnmap(m_data.data());
+                }
+            }
+
+            const BlobHeader& getHeader() const
+            {
+                return *reinterpret_cast<const BlobHeader*>(m_data.data());
+            }
+
+            IAllocator* getAllocator() const
+            {
+                return m_allocator;
+            }
+
+            std::string_view getString(uint64_t offset, uint32_t size) const
+            {
+                const BlobHeader& header = getHeader();
+                MY_DEBUG_ASSERT(offset + size <= header.stringsSize, "Invalid config blob string");
+                if (offset + size > header.stringsSize)
+                {
+                    return {};
+                }
+
+                return {reinterpret_cast<const char*>(m_data.data()) + header.stringsOffset + offset, size};
+            }
+
+            /**
+                Records are accessed in place: the range is checked to be inside the records area.
+             */
+            template <typename T>
+            std::span<const T> getRecords(uint64_t offset, uint32_t count) const
+            {
+                const BlobHeader& header = getHeader();
+                const bool isValid = offset >= sizeof(BlobHeader) && offset % alignof(T) == 0 && offset + uint64_t{count} * sizeof(T) <= header.stringsOffset;
+                MY_DEBUG_ASSERT(isValid, "Invalid config blob records");
+                if (!isValid)
+                {
+                    return {};
+                }
+
+                return {reinterpret_cast<const T*>(m_data.data() + offset), count};
+            }
+
+            RuntimeValuePtr getValue(const BlobValue& value);
+
+        private:
+            const ReadOnlyBuffer m_buffer;
+            const Ptr<io::IMemoryMappableObject> m_mapping;
+            const std::span<const std::byte> m_data;
+            IAllocator* const m_allocator;
+        };
+
+        /**
+         */
+        class ConfigBlobNull final : public OptionalValue
+        {
+            MY_REFCOUNTED_CLASS(my::config_blob_detail::ConfigBlobNull, OptionalValue)
+
+        public:
+            bool isMutable() const override
+            {
+                return false;
+            }
+
+            bool hasValue() const override
+            {
+                return false;
+            }
+
+            RuntimeValuePtr getValue() override
+            {
+                return nullptr;
+            }
+
+            Result<> setValue([[maybe_unused]] RuntimeValuePtr value) override
+            {
+                return MakeError(NonMutableValueError);
+            }
+        };
+
+        /**
+            String view into the string table.
+         */
+        class ConfigBlobString final : public StringValue
+        {
+            MY_REFCOUNTED_CLASS(my::config_blob_detail::ConfigBlobString, StringValue)
+
+        public:
+            ConfigBlobString(Ptr<ConfigBlobDocument> document, std::string_view str) :
+                m_document(std::move(document)),
+                m_str(str)
+            {
+            }
+
+            bool isMutable() const override
+            {
+                return false;
+            }
+
+            Result<> setString([[maybe_unused]] std::string_view str) override
+            {
+                return MakeError(NonMutableValueError);
+            }
+
+            std::string getString() const override
+            {
+                return std::string{m_str};
+            }
+
+        private:
+            const Ptr<ConfigBlobDocument> m_document;
+            const std::string_view m_str;
+        };
+
+        /**
+         */
+        class ConfigBlobCollection final : public ReadonlyCollection
+        {
+            MY_REFCOUNTED_CLASS(my::config_blob_detail::ConfigBlobCollection, ReadonlyCollection)
+
+        public:
+            ConfigBlobCollection(Ptr<ConfigBlobDocument> document, std::span<const BlobValue> elements) :
+                m_document(std::move(document)),
+                m_elements(elements)
+            {
+            }
+
+            bool isMutable() const override
+            {
+                return false;
+            }
+
+            size_t getSize() const override
+            {
+                return m_elements.size();
+            }
+
+            RuntimeValuePtr getAt(size_t index) override
+            {
+                MY_DEBUG_ASSERT(index < m_elements.size(), "Invalid index [{}]", index);
+                if (index >= m_elements.size())
+                {
+                    return nullptr;
+                }
+
+                return m_document->getValue(m_elements[index]);
+            }
+
+            Result<> setAt([[maybe_unused]] size_t index, [[maybe_unused]] const RuntimeValuePtr& value) override
+            {
+                return MakeError(NonMutableValueError);
+            }
+
+        private:
+            const Ptr<ConfigBlobDocument> m_document;
+            const std::span<const BlobValue> m_elements;
+        };
+
+        /**
+            Members are sorted by key: lookup is the binary search over the image without any intermediate index.
+         */
+        class ConfigBlobDictionary final : public ReadonlyDictionary
+        {
+            MY_REFCOUNTED_CLASS(my::config_blob_detail::ConfigBlobDictionary, ReadonlyDictionary)
+
+        public:
+            ConfigBlobDictionary(Ptr<ConfigBlobDocument> document, std::span<const BlobMember> members) :
+                m_document(std::move(document)),
+                m_members(members)
+            {
+            }
+
+            bool isMutable() const override
+            {
+                return false;
+            }
+
+            size_t getSize() const override
+            {
+                return m_members.size();
+            }
+
+            std::string_view getKey(size_t index) const override
+            {
+                MY_DEBUG_ASSERT(index < m_members.size(), "Invalid index ({}) > size:({})", index, m_members.size());
+                return getMemberKey(m_members[index]);
+            }
+
+            RuntimeValuePtr getValue(std::string_view key) override
+            {
+                const BlobMember* const member = findMember(key);
+                return member ? m_document->getValue(member->value) : nullptr;
+            }
+
+            Result<> setValue([[maybe_unused]] std::string_view key, [[maybe_unused]] const RuntimeValuePtr& value) override
+            {
+                return MakeError(NonMutableValueError);
+            }
+
+            bool containsKey(std::string_view key) const override
+            {
+                return findMember(key) != nullptr;
+            }
+
+        private:
+            std::string_view getMemberKey(const BlobMember& member) const
+            {
+                return m_document->getString(member.keyOffset, member.keySize);
+            }
+
+            const BlobMember* findMember(std::string_view key) const
+            {
+                const auto iter = std::lower_bound(m_members.begin(), m_members.end(), key, [this](const BlobMember& member, std::string_view searchKey)
+                {
+                    return getMemberKey(member) < searchKey;
+                });
+
+                return iter != m_members.end() && getMemberKey(*iter) == key ? &(*iter) : nullptr;
+            }
+
+            const Ptr<ConfigBlobDocument> m_document;
+            const std::span<const BlobMember> m_members;
+        };
+
+        RuntimeValuePtr ConfigBlobDocument::getValue(const BlobValue& value)
+        {
+            switch (value.type)
+            {
+                case BlobValueType::Null:
+                    return rtti::createInstanceWithAllocator<ConfigBlobNull>(m_allocator);
+                case BlobValueType::Boolean:
+                    return makeValueCopy(value.payload != 0, m_allocator);
+                case BlobValueType::Integer:
+                    return makeValueCopy(static_cast<int64_t>(value.payload), m_allocator);
+                case BlobValueType::UnsignedInteger:
+                    return makeValueCopy(value.payload, m_allocator);
+                case BlobValueType::Float:
+                    return makeValueCopy(std::bit_cast<double>(value.payload), m_allocator);
+                case BlobValueType::String:
+                    return rtti::createInstanceWithAllocator<ConfigBlobString>(m_allocator, Ptr{this}, getString(value.payload, value.size));
+                case BlobValueType::Collection:
+                    return rtti::createInstanceWithAllocator<ConfigBlobCollection>(m_allocator, Ptr{this}, getRecords<BlobValue>(value.payload, value.size));
+                case BlobValueType::Dictionary:
+                    return rtti::createInstanceWithAllocator<ConfigBlobDictionary>(m_allocator, Ptr{this}, getRecords<BlobMember>(value.payload, value.size));
+                default:
+                    break;
+            }
+
+            MY_DEBUG_FAILURE("Unexpected config blob value type ({})", static_cast<int>(value.type));
+            return nullptr;
+        }
+    }  // namespace
+}  // namespace my::config_blob_detail
+
+namespace my::serialization
+{
+    Result<> configBlobWrite(io::IStream& stream, const RuntimeValuePtr& value)
+    {
+        config_blob_detail::ConfigBlobWriter writer;
+        CheckResult(writer.writeRoot(value));
+
+        return writer.writeToStream(stream);
+    }
+
+    bool isConfigBlob(std::span<const std::byte> data)
+    {
+        return static_cast<bool>(config_blob_detail::validateHeader(data));
+    }
+
+    Result<RuntimeValuePtr> configBlobOpen(ReadOnlyBuffer buffer, IAllocator* allocator)
+    {
+        using namespace my::config_blob_detail;
+
+        CheckResult(validateHeader({buffer.data(), buffer.size()}));
+
+        auto document = rtti::createInstanceWithAllocator<ConfigBlobDocument>(allocator, std::move(buffer), allocator);
+        return document->getValue(document->getHeader().root);
+    }
+
+    Result<RuntimeValuePtr> configBlobOpenFile(io::IFile& file, IAllocator* allocator)
+    {
+        using namespace my::config_blob_detail;
+
+        const size_t size = file.getSize();
+        if (size == 0)
+        {
+            return MakeError("Empty file");
+        }
+
+        auto* const mappable = file.as<io::IMemoryMappableObject*>();
+        if (!mappable || !file.supports(io::IFile::FileFeature::MemoryMapping))
+        {
+            const io::StreamPtr stream = file.createStream(io::AccessMode::Read);
+            if (!stream)
+            {
+                return MakeError("Can not read the file ({})", file.getPath().getString());
+            }
+
+            Result<Buffer> buffer = io::readStreamToEnd(*stream);
+            CheckResult(buffer);
+
+            return configBlobOpen(buffer->toReadOnly(), allocator);
+        }
+
+        const void* const mappedPtr = mappable->memMap(0, size);
+        if (!mappedPtr)
+        {
+            return MakeError("Can not map the file ({})", file.getPath().getString());
+        }
+
+        const std::span data{reinterpret_cast<const std::byte*>(mappedPtr), size};
+        if (Result<> checkResult = validateHeader(data); !checkResult)
+        {
+            mappable->memUnmap(mappedPtr);
+            return checkResult.getError();
+        }
+
+        auto document = rtti::createInstanceWithAllocator<ConfigBlobDocument>(allocator, Ptr{mappable}, data, allocator);
+        return document->getValue(document->getHeader().root);
+    }
+
+}  // namespace my::serialization
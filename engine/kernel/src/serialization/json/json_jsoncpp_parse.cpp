@@ -1,8 +1,6 @@
 // #my_engine_source_file
 
 #include "json_to_runtime_value.h"
-#include "my/io/stream.h"
-#include "my/memory/buffer.h"
 
 namespace my::json_detail
 {
@@ -21,36 +19,6 @@ namespace my::serialization
         return (*parser);
     }
 
-    Result<RuntimeValuePtr> jsonParse(io::IStream& reader, IAllocator* allocator)
-    {
-        MY_DEBUG_ASSERT(reader.canRead());
-
-        constexpr size_t BlockSize = 256;
-
-        Buffer buffer;
-        size_t totalRead = 0;
-
-        do
-        {
-            std::byte* const ptr = reinterpret_cast<std::byte*>(buffer.append(BlockSize));
-            auto readResult = reader.read(ptr, BlockSize);
-            CheckResult(readResult);
-
-            const size_t actualRead = *readResult;
-            totalRead += actualRead;
-
-            if (actualRead < BlockSize)
-            {
-                buffer.resize(totalRead);
-                break;
-            }
-
-        } while (true);
-
-        std::string_view str{reinterpret_cast<const char*>(buffer.data()), buffer.size()};
-        return jsonParseString(str, allocator);
-    }
-
     Result<Json::Value> jsonParseToValue(std::string_view str)
     {
         if (str.empty())
@@ -69,21 +37,21 @@ namespace my::serialization
         return root;
     }
 
-    Result<RuntimeValuePtr> jsonParseString(std::string_view str, IAllocator*)
+    Result<RuntimeValuePtr> jsonParseString(std::string_view str, IAllocator* allocator)
     {
         auto root = jsonParseToValue(str);
         CheckResult(root);
 
         if (root->isObject())
         {
-            return json_detail::createJsonDictionary(*std::move(root));
+            return json_detail::createJsonDictionary(*std::move(root), allocator);
         }
         else if (root->isArray())
         {
-            return json_detail::createJsonCollection(*std::move(root));
+            return json_detail::createJsonCollection(*std::move(root), allocator);
         }
 
-        return json_detail::getValueFromJson(nullptr, *root);
+        return json_detail::getValueFromJson(nullptr, *root, allocator);
     }
 
 }  // namespace my::serialization
@@ -39,29 +39,50 @@ namespace my::serialization
             return settings.pretty ? prepareWriter(prettyWriter, settings) : prepareWriter(writer, settings);
         }
 
+        /**
+            Collects the output within the put area and writes it into the stream by the whole blocks.
+         */
         class WriterStreambuf final : public std::streambuf
         {
         public:
             WriterStreambuf(io::IStream& writer) :
                 m_writer(writer)
             {
+                setp(m_buffer, m_buffer + sizeof(m_buffer));
             }
 
-            std::streamsize xsputn(const char_type* s, std::streamsize n) override
+            ~WriterStreambuf()
             {
-                static_assert(sizeof(char_type) == sizeof(std::byte));
-                m_writer.write(reinterpret_cast<const std::byte*>(s), n).ignore();
-                return n;
-            };
+                sync();
+            }
 
             int_type overflow(int_type ch) override
             {
-                m_writer.write(reinterpret_cast<const std::byte*>(&ch), 1).ignore();
-                return 1;
+                sync();
+                if (!traits_type::eq_int_type(ch, traits_type::eof()))
+                {
+                    *pptr() = traits_type::to_char_type(ch);
+                    pbump(1);
+                }
+
+                return traits_type::not_eof(ch);
+            }
+
+            int sync() override
+            {
+                static_assert(sizeof(char_type) == sizeof(std::byte));
+                if (pptr() != pbase())
+                {
+                    m_writer.write(reinterpret_cast<const std::byte*>(pbase()), static_cast<size_t>(pptr() - pbase())).ignore();
+                    setp(m_buffer, m_buffer + sizeof(m_buffer));
+                }
+
+                return 0;
             }
 
         private:
             io::IStream& m_writer;
+            char m_buffer[16 * 1024];
         };
 
         void makeJsonPrimitiveValue(Json::Value& jValue, const PrimitiveValue& value)
@@ -171,7 +192,7 @@ namespace my::serialization
                         }
                     }
 
-                    if(auto result = makeJsonValue(jValue[key.data()], member, settings); !result)
+                    if(auto result = makeJsonValue(*jValue.demand(key.data(), key.data() + key.size()), member, settings); !result)
                     {
                         return result;
                     }
@@ -190,23 +211,11 @@ namespace my::serialization
         WriterStreambuf buf{writer};
         std::ostream stream(&buf);
         getJsonWriter(settings).write(value, &stream);
+        stream.flush();
 
         return kResultSuccess;
     }
 
-    Result<> jsonWrite(io::IStream& writer, const RuntimeValuePtr& value, JsonSettings settings)
-    {
-        MY_DEBUG_ASSERT(writer.canWrite());
-
-        Json::Value root;
-        if(auto result = makeJsonValue(root, value, settings); !result)
-        {
-            return result;
-        }
-
-        return jsonWrite(writer, root, settings);
-    }
-
     Result<> runtimeApplyToJsonValue(Json::Value& jsonValue, const RuntimeValuePtr& runtimeValue, JsonSettings settings)
     {
         return makeJsonValue(jsonValue, runtimeValue, settings);
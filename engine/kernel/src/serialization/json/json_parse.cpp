@@ -0,0 +1,88 @@
+// #my_engine_source_file
+
+#include "json_tape.h"
+#include "my/io/file_system.h"
+#include "my/io/memory_stream.h"
+#include "my/memory/buffer.h"
+#include "my/serialization/json.h"
+
+namespace my::json_detail
+{
+    namespace
+    {
+        /**
+            Returns the stream's content from the current position to the end.
+            Memory streams are not copied, other streams are read by io::readStreamToEnd.
+         */
+        Result<std::string_view> readStreamText(io::IStream& stream, Buffer& buffer)
+        {
+            MY_DEBUG_ASSERT(stream.canRead());
+
+            if (const auto* const memoryStream = stream.as<const io::MemoryStream*>())
+            {
+                const std::span<const std::byte> bytes = memoryStream->getBufferAsSpan(stream.getPosition());
+                stream.setPosition(io::OffsetOrigin::Current, static_cast<int64_t>(bytes.size()));
+
+                return std::string_view{reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+            }
+
+            Result<Buffer> data = io::readStreamToEnd(stream);
+            CheckResult(data);
+            buffer = *std::move(data);
+
+            return std::string_view{reinterpret_cast<const char*>(buffer.data()), buffer.size()};
+        }
+    }  // namespace
+}  // namespace my::json_detail
+
+namespace my::serialization
+{
+    Result<RuntimeValuePtr> jsonParse(io::IStream& reader, IAllocator* allocator)
+    {
+        return jsonParse(reader, JsonParser::JsonCpp, allocator);
+    }
+
+    Result<RuntimeValuePtr> jsonParse(io::IStream& reader, JsonParser parser, IAllocator* allocator)
+    {
+        Buffer buffer;
+        Result<std::string_view> text = json_detail::readStreamText(reader, buffer);
+        CheckResult(text);
+
+        return jsonParseString(*text, parser, allocator);
+    }
+
+    Result<RuntimeValuePtr> jsonParseString(std::string_view text, JsonParser parser, IAllocator* allocator)
+    {
+        if (parser == JsonParser::Tape)
+        {
+            return json_detail::jsonParseTape(text, allocator);
+        }
+
+        return jsonParseString(text, allocator);
+    }
+
+    Result<RuntimeValuePtr> jsonParseFile(io::IFile& file, JsonParser parser, IAllocator* allocator)
+    {
+        const size_t size = file.getSize();
+        if (size == 0)
+        {
+            return MakeError("Empty file");
+        }
+
+        // Parsers do not keep references to the source text, so the mapping is released right after the parsing.
+        if (auto* const mappable = file.as<io::IMemoryMappableObject*>(); mappable && file.supports(io::IFile::FileFeature::MemoryMapping))
+        {
+            const io::MemoryMap memoryMap{*mappable, 0, size};
+            return jsonParseString(std::string_view{reinterpret_cast<const char*>(memoryMap.ptr), size}, parser, allocator);
+        }
+
+        const io::StreamPtr stream = file.createStream(io::AccessMode::Read);
+        if (!stream)
+        {
+            return MakeError("Can not read the file ({})", file.getPath().getString());
+        }
+
+        return jsonParse(*stream, parser, allocator);
+    }
+
+}  // namespace my::serialization
@@ -0,0 +1,223 @@
+// #my_engine_source_file
+
+#include "json_structural_index.h"
+
+#include "my/diag/error.h"
+#include "my/serialization/serialization.h"
+
+#include <bit>
+#include <cstring>
+#include <limits>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define MY_JSON_SSE2
+#endif
+
+namespace my::json_detail
+{
+    namespace
+    {
+        constexpr size_t BlockSize = 64;
+
+        /**
+            64 bytes of the text, each compare produces bit mask: bit N is set if byte N is equal to the requested character.
+         */
+        class TextBlock
+        {
+        public:
+            TextBlock(const char* data)
+            {
+#if defined(__AVX2__)
+                m_chunks[0] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+                m_chunks[1] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32));
+#elif defined(MY_JSON_SSE2)
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    m_chunks[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16));
+                }
+#else
+                m_data = data;
+#endif
+            }
+
+            uint64_t eq(char c) const
+            {
+#if defined(__AVX2__)
+                const __m256i value = _mm256_set1_epi8(c);
+                const uint64_t low = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(m_chunks[0], value)));
+                const uint64_t high = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(m_chunks[1], value)));
+                return low | (high << 32);
+#elif defined(MY_JSON_SSE2)
+                const __m128i value = _mm_set1_epi8(c);
+                uint64_t mask = 0;
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    const auto chunkMask = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(m_chunks[i], value)));
+                    mask |= static_cast<uint64_t>(chunkMask) << (i * 16);
+                }
+                return mask;
+#else
+                uint64_t mask = 0;
+                for (size_t i = 0; i < BlockSize; ++i)
+                {
+                    mask |= static_cast<uint64_t>(m_data[i] == c) << i;
+                }
+                return mask;
+#endif
+            }
+
+        private:
+#if defined(__AVX2__)
+            __m256i m_chunks[2];
+#elif defined(MY_JSON_SSE2)
+            __m128i m_chunks[4];
+#else
+            const char* m_data;
+#endif
+        };
+
+        /**
+            Bit N of the result is the xor of the bits 0..N of the mask.
+         */
+        inline uint64_t prefixXor(uint64_t mask)
+        {
+            mask ^= mask << 1;
+            mask ^= mask << 2;
+            mask ^= mask << 4;
+            mask ^= mask << 8;
+            mask ^= mask << 16;
+            mask ^= mask << 32;
+            return mask;
+        }
+
+        class StructuralIndexer
+        {
+        public:
+            StructuralIndexer(std::vector<uint32_t>& positions) :
+                m_positions(positions)
+            {
+            }
+
+            void indexBlock(const char* data, uint32_t blockOffset)
+            {
+                const TextBlock block{data};
+
+                const uint64_t escaped = findEscaped(block.eq('\\'));
+                const uint64_t quotes = block.eq('"') & ~escaped;
+                const uint64_t inString = prefixXor(quotes) ^ m_inStringCarry;
+                m_inStringCarry = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+
+                const uint64_t structuralChars = block.eq('{') | block.eq('}') | block.eq('[') | block.eq(']') | block.eq(':') | block.eq(',');
+                const uint64_t whitespace = block.eq(' ') | block.eq('\t') | block.eq('\n') | block.eq('\r');
+
+                // quotes are included into inString at the opening and excluded at the closing position
+                const uint64_t openingQuotes = quotes & inString;
+                const uint64_t scalars = ~(structuralChars | whitespace | quotes | inString);
+                const uint64_t scalarStarts = scalars & ~((scalars << 1) | m_scalarCarry);
+                m_scalarCarry = scalars >> 63;
+
+                appendPositions((structuralChars & ~inString) | openingQuotes | scalarStarts, blockOffset);
+            }
+
+            bool isInString() const
+            {
+                return m_inStringCarry != 0;
+            }
+
+        private:
+            /**
+                Returns mask of the characters that are escaped by the backslash.
+                Backslashes are rare within the most documents, so they are processed one by one.
+             */
+            uint64_t findEscaped(uint64_t backslashes)
+            {
+                uint64_t escaped = m_escapeCarry;
+                m_escapeCarry = 0;
+
+                for (; backslashes != 0; backslashes &= backslashes - 1)
+                {
+                    const int index = std::countr_zero(backslashes);
+                    const uint64_t bit = uint64_t{1} << index;
+                    if ((escaped & bit) != 0)
+                    {
+                        continue;
+                    }
+
+                    if (static_cast<size_t>(index) == BlockSize - 1)
+                    {
+                        m_escapeCarry = 1;
+                    }
+                    else
+                    {
+                        escaped |= bit << 1;
+                    }
+                }
+
+                return escaped;
+            }
+
+            void appendPositions(uint64_t mask, uint32_t blockOffset)
+            {
+                if (mask == 0)
+                {
+                    return;
+                }
+
+                size_t count = m_positions.size();
+                m_positions.resize(count + static_cast<size_t>(std::popcount(mask)));
+
+                uint32_t* const positions = m_positions.data();
+                for (; mask != 0; mask &= mask - 1)
+                {
+                    positions[count++] = blockOffset + static_cast<uint32_t>(std::countr_zero(mask));
+                }
+            }
+
+            std::vector<uint32_t>& m_positions;
+            uint64_t m_escapeCarry = 0;
+            uint64_t m_inStringCarry = 0;
+            uint64_t m_scalarCarry = 0;
+        };
+
+    }  // namespace
+
+    Result<> jsonBuildStructuralIndex(std::string_view text, std::vector<uint32_t>& positions)
+    {
+        if (text.size() >= std::numeric_limits<uint32_t>::max())
+        {
+            return MakeErrorT(serialization::SerializationError)("Json text is too large");
+        }
+
+        positions.reserve(positions.size() + text.size() / 8);
+
+        StructuralIndexer indexer{positions};
+
+        const size_t fullBlocksSize = text.size() - text.size() % BlockSize;
+        for (size_t offset = 0; offset < fullBlocksSize; offset += BlockSize)
+        {
+            indexer.indexBlock(text.data() + offset, static_cast<uint32_t>(offset));
+        }
+
+        if (fullBlocksSize < text.size())
+        {
+            char lastBlock[BlockSize];
+            std::memset(lastBlock, ' ', BlockSize);
+            std::memcpy(lastBlock, text.data() + fullBlocksSize, text.size() - fullBlocksSize);
+            indexer.indexBlock(lastBlock, static_cast<uint32_t>(fullBlocksSize));
+        }
+
+        if (indexer.isInString())
+        {
+            return MakeErrorT(serialization::SerializationError)("Unterminated string");
+        }
+
+        return kResultSuccess;
+    }
+
+}  // namespace my::json_detail
@@ -0,0 +1,22 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include "my/utils/result.h"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace my::json_detail
+{
+    /**
+        First stage of the tape parser: collects positions of the structural characters ({ } [ ] : ,),
+        opening quotes of the strings and first characters of the scalars (numbers and literals), skipping the string contents.
+        Text is classified by 64 bytes blocks with AVX2/SSE2 compares when available (scalar fallback otherwise).
+
+        Positions are appended to the 'positions' in the text order, no syntax validation is performed except the unterminated strings check.
+     */
+    Result<> jsonBuildStructuralIndex(std::string_view text, std::vector<uint32_t>& positions);
+
+}  // namespace my::json_detail
@@ -0,0 +1,754 @@
+// #my_engine_source_file
+
+#include "json_tape.h"
+
+#include "json_structural_index.h"
+#include "my/rtti/rtti_impl.h"
+#include "my/serialization/runtime_value_builder.h"
+#include "my/serialization/serialization.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <span>
+
+namespace my::json_detail
+{
+    namespace
+    {
+        enum class TapeNodeType : uint8_t
+        {
+            Null,
+            Boolean,
+            Int64,
+            Uint64,
+            Double,
+            String,
+            Array,
+            Object
+        };
+
+        /**
+            String: value is the offset within the strings block, size is the string length.
+            Array/Object: value is the offset within the children table, size is the children count.
+            Object's children are the key nodes, value node always goes right after its key node.
+            Scalars: value keeps the bits of the scalar.
+         */
+        struct TapeNode
+        {
+            TapeNodeType type;
+            uint32_t size;
+            uint64_t value;
+        };
+
+        constexpr size_t MaxDepth = 512;
+
+        inline bool isJsonDelimiter(char c)
+        {
+            switch (c)
+            {
+                case ' ':
+                case '\t':
+                case '\n':
+                case '\r':
+                case ',':
+                case ':':
+                case '{':
+                case '}':
+                case '[':
+                case ']':
+                case '"':
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        /**
+            Owns the memory block with the tape nodes, children tables and decoded strings.
+         */
+        class JsonTapeDocument final : public virtual IRefCounted
+        {
+            MY_REFCOUNTED_CLASS(my::json_detail::JsonTapeDocument, IRefCounted)
+
+        public:
+            JsonTapeDocument(IAllocator& allocator, size_t nodesCapacity, size_t stringsCapacity) :
+                m_allocator(&allocator),
+                m_memorySize(nodesCapacity * (sizeof(TapeNode) + sizeof(uint32_t)) + stringsCapacity)
+            {
+                m_memory = m_allocator->alloc(m_memorySize, alignof(TapeNode));
+                m_nodes = reinterpret_cast<TapeNode*>(m_memory);
+                m_children = reinterpret_cast<uint32_t*>(m_nodes + nodesCapacity);
+                m_strings = reinterpret_cast<char*>(m_children + nodesCapacity);
+            }
+
+            ~JsonTapeDocument()
+            {
+                m_allocator->free(m_memory, m_memorySize, alignof(TapeNode));
+            }
+
+            IAllocator* getAllocator() const
+            {
+                return m_allocator.get();
+            }
+
+            const TapeNode& getNode(uint32_t index) const
+            {
+                MY_DEBUG_ASSERT(index < m_nodesCount);
+                return m_nodes[index];
+            }
+
+            std::span<const uint32_t> getChildren(const TapeNode& node) const
+            {
+                MY_DEBUG_ASSERT(node.type == TapeNodeType::Array || node.type == TapeNodeType::Object);
+                return {m_children + node.value, node.size};
+            }
+
+            std::string_view getString(const TapeNode& node) const
+            {
+                MY_DEBUG_ASSERT(node.type == TapeNodeType::String);
+                return {m_strings + node.value, node.size};
+            }
+
+            RuntimeValuePtr getValue(uint32_t index);
+
+        private:
+            const AllocatorPtr m_allocator;
+            const size_t m_memorySize;
+            void* m_memory = nullptr;
+            TapeNode* m_nodes = nullptr;
+            uint32_t* m_children = nullptr;
+            char* m_strings = nullptr;
+            uint32_t m_nodesCount = 0;
+            uint32_t m_childrenCount = 0;
+            uint32_t m_stringsSize = 0;
+
+            friend class JsonTapeBuilder;
+        };
+
+        /**
+         */
+        class JsonTapeNull final : public OptionalValue
+        {
+            MY_REFCOUNTED_CLASS(my::json_detail::JsonTapeNull, OptionalValue)
+
+        public:
+            bool isMutable() const override
+            {
+                return false;
+            }
+
+            bool hasValue() const override
+            {
+                return false;
+            }
+
+            RuntimeValuePtr getValue() override
+            {
+                return nullptr;
+            }
+
+            Result<> setValue([[maybe_unused]] RuntimeValuePtr value) override
+            {
+                return MakeError("Attempt to modify non mutable json value");
+            }
+        };
+
+        /**
+         */
+        class JsonTapeCollection final : public ReadonlyCollection
+        {
+            MY_REFCOUNTED_CLASS(my::json_detail::JsonTapeCollection, ReadonlyCollection)
+
+        public:
+            JsonTapeCollection(Ptr<JsonTapeDocument> document, uint32_t nodeIndex) :
+                m_document(std::move(document)),
+                m_elements(m_document->getChildren(m_document->getNode(nodeIndex)))
+            {
+            }
+
+            bool isMutable() const override
+            {
+                return false;
+            }
+
+            size_t getSize() const override
+            {
+                return m_elements.size();
+            }
+
+            RuntimeValuePtr getAt(size_t index) override
+            {
+                MY_DEBUG_ASSERT(index < m_elements.size(), "Invalid index [{}]", index);
+                if (index >= m_elements.size())
+                {
+                    return nullptr;
+                }
+
+                return m_document->getValue(m_elements[index]);
+            }
+
+            Result<> setAt([[maybe_unused]] size_t index, [[maybe_unused]] const RuntimeValuePtr& value) override
+            {
+                return MakeError("Attempt to modify non mutable json value");
+            }
+
+        private:
+            const Ptr<JsonTapeDocument> m_document;
+            const std::span<const uint32_t> m_elements;
+        };
+
+        /**
+         */
+        class JsonTapeDictionary final : public ReadonlyDictionary
+        {
+            MY_REFCOUNTED_CLASS(my::json_detail::JsonTapeDictionary, ReadonlyDictionary)
+
+        public:
+            JsonTapeDictionary(Ptr<JsonTapeDocument> document, uint32_t nodeIndex) :
+                m_document(std::move(document)),
+                m_keys(m_document->getChildren(m_document->getNode(nodeIndex)))
+            {
+            }
+
+            bool isMutable() const override
+            {
+                return false;
+            }
+
+            size_t getSize() const override
+            {
+                return m_keys.size();
+            }
+
+            std::string_view getKey(size_t index) const override
+            {
+                MY_DEBUG_ASSERT(index < m_keys.size(), "Invalid index ({}) > size:({})", index, m_keys.size());
+                return m_document->getString(m_document->getNode(m_keys[index]));
+            }
+
+            RuntimeValuePtr getValue(std::string_view key) override
+            {
+                const uint32_t keyIndex = findKey(key);
+                return keyIndex != NotFound ? m_document->getValue(keyIndex + 1) : nullptr;
+            }
+
+            Result<> setValue([[maybe_unused]] std::string_view key, [[maybe_unused]] const RuntimeValuePtr& value) override
+            {
+                return MakeError("Attempt to modify non mutable json value");
+            }
+
+            bool containsKey(std::string_view key) const override
+            {
+                return findKey(key) != NotFound;
+            }
+
+        private:
+            static constexpr uint32_t NotFound = std::numeric_limits<uint32_t>::max();
+
+            /**
+                Keys are sorted and unique (see JsonTapeBuilder::sortObjectKeys).
+             */
+            uint32_t findKey(std::string_view key) const
+            {
+                const auto iter = std::lower_bound(m_keys.begin(), m_keys.end(), key, [this](uint32_t keyIndex, std::string_view value)
+                {
+                    return m_document->getString(m_document->getNode(keyIndex)) < value;
+                });
+
+                if (iter == m_keys.end() || m_document->getString(m_document->getNode(*iter)) != key)
+                {
+                    return NotFound;
+                }
+
+                return *iter;
+            }
+
+            const Ptr<JsonTapeDocument> m_document;
+            const std::span<const uint32_t> m_keys;
+        };
+
+        RuntimeValuePtr JsonTapeDocument::getValue(uint32_t index)
+        {
+            const TapeNode& node = getNode(index);
+            IAllocator* const allocator = m_allocator.get();
+
+            switch (node.type)
+            {
+                case TapeNodeType::Null:
+                    return rtti::createInstanceWithAllocator<JsonTapeNull>(allocator);
+                case TapeNodeType::Boolean:
+                    return makeValueCopy(node.value != 0, allocator);
+                case TapeNodeType::Int64:
+                    return makeValueCopy(std::bit_cast<int64_t>(node.value), allocator);
+                case TapeNodeType::Uint64:
+                    return makeValueCopy(node.value, allocator);
+                case TapeNodeType::Double:
+                    return makeValueCopy(std::bit_cast<double>(node.value), allocator);
+                case TapeNodeType::String:
+                    return makeValueCopy(getString(node), allocator);
+                case TapeNodeType::Array:
+                    return rtti::createInstanceWithAllocator<JsonTapeCollection>(allocator, Ptr{this}, index);
+                case TapeNodeType::Object:
+                    return rtti::createInstanceWithAllocator<JsonTapeDictionary>(allocator, Ptr{this}, index);
+            }
+
+            MY_FAILURE("Unknown tape node type");
+            return nullptr;
+        }
+
+        /**
+            Second stage of the parsing: walks over the structural positions and fills the document's tape.
+            Each json value starts at the structural position, so the positions count is the upper bound of the nodes count.
+         */
+        class JsonTapeBuilder
+        {
+        public:
+            JsonTapeBuilder(std::string_view text, std::span<const uint32_t> positions, JsonTapeDocument& document) :
+                m_text(text),
+                m_positions(positions),
+                m_document(document)
+            {
+            }
+
+            Result<> build()
+            {
+                CheckResult(parseValue(0));
+                if (m_index < m_positions.size())
+                {
+                    return makeError(m_positions[m_index], "Unexpected data after the root value");
+                }
+
+                return kResultSuccess;
+            }
+
+        private:
+            ErrorPtr makeError(size_t offset, std::string_view message) const
+            {
+                return MakeErrorT(serialization::SerializationError)(std::format("{} (offset:{})", message, offset));
+            }
+
+            char peekChar() const
+            {
+                return m_index < m_positions.size() ? m_text[m_positions[m_index]] : '\0';
+            }
+
+            Result<> expect(char c)
+            {
+                if (m_index >= m_positions.size())
+                {
+                    return makeError(m_text.size(), std::format("Expected ({}), but end of text reached", c));
+                }
+
+                const uint32_t position = m_positions[m_index++];
+                if (m_text[position] != c)
+                {
+                    return makeError(position, std::format("Expected ({})", c));
+                }
+
+                return kResultSuccess;
+            }
+
+            TapeNode& addNode(TapeNodeType type, uint32_t size = 0, uint64_t value = 0)
+            {
+                return m_document.m_nodes[m_document.m_nodesCount++] = TapeNode{type, size, value};
+            }
+
+            Result<> parseValue(size_t depth)
+            {
+                if (m_index >= m_positions.size())
+                {
+                    return makeError(m_text.size(), "Unexpected end of text");
+                }
+
+                const uint32_t position = m_positions[m_index++];
+                switch (m_text[position])
+                {
+                    case '{':
+                        return parseObject(depth + 1);
+                    case '[':
+                        return parseArray(depth + 1);
+                    case '"':
+                        return parseString(position);
+                    case 't':
+                        return parseLiteral(position, "true", TapeNodeType::Boolean, 1);
+                    case 'f':
+                        return parseLiteral(position, "false", TapeNodeType::Boolean, 0);
+                    case 'n':
+                        return parseLiteral(position, "null", TapeNodeType::Null, 0);
+                    default:
+                        return parseNumber(position);
+                }
+            }
+
+            Result<> parseObject(size_t depth)
+            {
+                if (depth > MaxDepth)
+                {
+                    return makeError(m_positions[m_index - 1], "Max depth exceeded");
+                }
+
+                const uint32_t nodeIndex = m_document.m_nodesCount;
+                addNode(TapeNodeType::Object);
+                const size_t stackBase = m_childrenStack.size();
+
+                while (peekChar() != '}')
+                {
+                    const uint32_t keyPosition = m_index < m_positions.size() ? m_positions[m_index++] : static_cast<uint32_t>(m_text.size());
+                    if (keyPosition >= m_text.size() || m_text[keyPosition] != '"')
+                    {
+                        return makeError(keyPosition, "Expected object key");
+                    }
+
+                    m_childrenStack.push_back(m_document.m_nodesCount);
+                    CheckResult(parseString(keyPosition));
+                    CheckResult(expect(':'));
+                    CheckResult(parseValue(depth));
+
+                    if (peekChar() != ',')
+                    {
+                        break;
+                    }
+                    ++m_index;
+                }
+
+                CheckResult(expect('}'));
+                sortObjectKeys(stackBase);
+                closeContainer(nodeIndex, stackBase);
+
+                return kResultSuccess;
+            }
+
+            Result<> parseArray(size_t depth)
+            {
+                if (depth > MaxDepth)
+                {
+                    return makeError(m_positions[m_index - 1], "Max depth exceeded");
+                }
+
+                const uint32_t nodeIndex = m_document.m_nodesCount;
+                addNode(TapeNodeType::Array);
+                const size_t stackBase = m_childrenStack.size();
+
+                while (peekChar() != ']')
+                {
+                    m_childrenStack.push_back(m_document.m_nodesCount);
+                    CheckResult(parseValue(depth));
+
+                    if (peekChar() != ',')
+                    {
+                        break;
+                    }
+                    ++m_index;
+                }
+
+                CheckResult(expect(']'));
+                closeContainer(nodeIndex, stackBase);
+
+                return kResultSuccess;
+            }
+
+            /**
+                Object keys are stored the same way as the jsoncpp object members: sorted, and the last of the duplicate keys overrides the previous ones.
+                So the keys are enumerated in the same order by both parsers, and the key lookup is the binary search.
+                Values of the overridden keys stay on the tape, but they are not referenced.
+             */
+            void sortObjectKeys(size_t stackBase)
+            {
+                const auto getKey = [this](uint32_t keyIndex)
+                {
+                    return m_document.getString(m_document.getNode(keyIndex));
+                };
+
+                const auto keys = std::span{m_childrenStack}.subspan(stackBase);
+                std::stable_sort(keys.begin(), keys.end(), [&getKey](uint32_t left, uint32_t right)
+                {
+                    return getKey(left) < getKey(right);
+                });
+
+                size_t count = 0;
+                for (size_t i = 0; i < keys.size(); ++i)
+                {
+                    if (i + 1 < keys.size() && getKey(keys[i]) == getKey(keys[i + 1]))
+                    {
+                        continue;
+                    }
+
+                    keys[count++] = keys[i];
+                }
+
+                m_childrenStack.resize(stackBase + count);
+            }
+
+            /**
+                Children of the nested containers are already moved to the children table, so the container's children are contiguous on the stack.
+             */
+            void closeContainer(uint32_t nodeIndex, size_t stackBase)
+            {
+                const auto count = static_cast<uint32_t>(m_childrenStack.size() - stackBase);
+                TapeNode& node = m_document.m_nodes[nodeIndex];
+                node.value = m_document.m_childrenCount;
+                node.size = count;
+
+                if (count > 0)
+                {
+                    std::memcpy(m_document.m_children + m_document.m_childrenCount, m_childrenStack.data() + stackBase, count * sizeof(uint32_t));
+                    m_document.m_childrenCount += count;
+                    m_childrenStack.resize(stackBase);
+                }
+            }
+
+            Result<> parseLiteral(uint32_t position, std::string_view literal, TapeNodeType type, uint64_t value)
+            {
+                const std::string_view text = m_text.substr(position);
+                if (!text.starts_with(literal) || (text.size() > literal.size() && !isJsonDelimiter(text[literal.size()])))
+                {
+                    return makeError(position, "Invalid literal");
+                }
+
+                addNode(type, 0, value);
+                return kResultSuccess;
+            }
+
+            Result<> parseNumber(uint32_t position)
+            {
+                const char* const begin = m_text.data() + position;
+                const char* const textEnd = m_text.data() + m_text.size();
+
+                const char* end = begin;
+                bool isFloat = false;
+                for (; end != textEnd && !isJsonDelimiter(*end); ++end)
+                {
+                    isFloat = isFloat || *end == '.' || *end == 'e' || *end == 'E';
+                }
+
+                const char* const digits = *begin == '-' ? begin + 1 : begin;
+                if (digits == end || *digits < '0' || *digits > '9')
+                {
+                    return makeError(position, "Unexpected character");
+                }
+
+                if (!isFloat)
+                {
+                    int64_t intValue = 0;
+                    if (const auto [ptr, err] = std::from_chars(begin, end, intValue); err == std::errc{} && ptr == end)
+                    {
+                        addNode(TapeNodeType::Int64, 0, std::bit_cast<uint64_t>(intValue));
+                        return kResultSuccess;
+                    }
+
+                    uint64_t uintValue = 0;
+                    if (const auto [ptr, err] = std::from_chars(begin, end, uintValue); err == std::errc{} && ptr == end)
+                    {
+                        addNode(TapeNodeType::Uint64, 0, uintValue);
+                        return kResultSuccess;
+                    }
+                }
+
+                double floatValue = 0.;
+                if (const auto [ptr, err] = std::from_chars(begin, end, floatValue); err != std::errc{} || ptr != end)
+                {
+                    return makeError(position, "Invalid number");
+                }
+
+                addNode(TapeNodeType::Double, 0, std::bit_cast<uint64_t>(floatValue));
+                return kResultSuccess;
+            }
+
+            /**
+                Decodes the string into the document's strings block.
+                Decoded string with the terminating zero is never longer than its quoted source text, so the block sized by the text is always enough.
+             */
+            Result<> parseString(uint32_t position)
+            {
+                const char* src = m_text.data() + position + 1;
+                const char* const textEnd = m_text.data() + m_text.size();
+                char* const begin = m_document.m_strings + m_document.m_stringsSize;
+                char* dst = begin;
+
+                while (true)
+                {
+                    const char* const chunkEnd = findSpecialChar(src, textEnd);
+                    std::memcpy(dst, src, static_cast<size_t>(chunkEnd - src));
+                    dst += chunkEnd - src;
+                    src = chunkEnd;
+
+                    if (src == textEnd)
+                    {
+                        return makeError(position, "Unterminated string");
+                    }
+
+                    if (*src == '"')
+                    {
+                        break;
+                    }
+
+                    if (*src != '\\')
+                    {
+                        return makeError(static_cast<size_t>(src - m_text.data()), "Control character within the string");
+                    }
+
+                    if (++src == textEnd)
+                    {
+                        return makeError(position, "Unterminated string");
+                    }
+
+                    switch (const char escaped = *src++; escaped)
+                    {
+                        case '"':
+                        case '\\':
+                        case '/':
+                            *dst++ = escaped;
+                            break;
+                        case 'b':
+                            *dst++ = '\b';
+                            break;
+                        case 'f':
+                            *dst++ = '\f';
+                            break;
+                        case 'n':
+                            *dst++ = '\n';
+                            break;
+                        case 'r':
+                            *dst++ = '\r';
+                            break;
+                        case 't':
+                            *dst++ = '\t';
+                            break;
+                        case 'u':
+                            if (!decodeUnicodeEscape(src, textEnd, dst))
+                            {
+                                return makeError(static_cast<size_t>(src - m_text.data()), "Invalid unicode escape sequence");
+                            }
+                            break;
+                        default:
+                            return makeError(static_cast<size_t>(src - m_text.data()) - 1, "Invalid escape sequence");
+                    }
+                }
+
+                // zero terminated the same as the strings of the jsoncpp values: dictionary keys can be used as c-strings
+                *dst = '\0';
+
+                const auto size = static_cast<uint32_t>(dst - begin);
+                addNode(TapeNodeType::String, size, m_document.m_stringsSize);
+                m_document.m_stringsSize += size + 1;
+
+                return kResultSuccess;
+            }
+
+            static const char* findSpecialChar(const char* src, const char* end)
+            {
+                for (; src != end; ++src)
+                {
+                    const auto c = static_cast<unsigned char>(*src);
+                    if (c == '"' || c == '\\' || c < 0x20)
+                    {
+                        break;
+                    }
+                }
+
+                return src;
+            }
+
+            static std::optional<uint32_t> readHex4(const char*& src, const char* end)
+            {
+                uint32_t value = 0;
+                if (end - src < 4)
+                {
+                    return std::nullopt;
+                }
+
+                if (const auto [ptr, err] = std::from_chars(src, src + 4, value, 16); err != std::errc{} || ptr != src + 4)
+                {
+                    return std::nullopt;
+                }
+
+                src += 4;
+                return value;
+            }
+
+            static bool decodeUnicodeEscape(const char*& src, const char* end, char*& dst)
+            {
+                std::optional<uint32_t> codePoint = readHex4(src, end);
+                if (!codePoint)
+                {
+                    return false;
+                }
+
+                if (*codePoint >= 0xD800 && *codePoint <= 0xDBFF)
+                {
+                    if (end - src < 2 || src[0] != '\\' || src[1] != 'u')
+                    {
+                        return false;
+                    }
+
+                    src += 2;
+                    const std::optional<uint32_t> lowSurrogate = readHex4(src, end);
+                    if (!lowSurrogate || *lowSurrogate < 0xDC00 || *lowSurrogate > 0xDFFF)
+                    {
+                        return false;
+                    }
+
+                    codePoint = 0x10000 + ((*codePoint - 0xD800) << 10) + (*lowSurrogate - 0xDC00);
+                }
+
+                const uint32_t cp = *codePoint;
+                if (cp < 0x80)
+                {
+                    *dst++ = static_cast<char>(cp);
+                }
+                else if (cp < 0x800)
+                {
+                    *dst++ = static_cast<char>(0xC0 | (cp >> 6));
+                    *dst++ = static_cast<char>(0x80 | (cp & 0x3F));
+                }
+                else if (cp < 0x10000)
+                {
+                    *dst++ = static_cast<char>(0xE0 | (cp >> 12));
+                    *dst++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                    *dst++ = static_cast<char>(0x80 | (cp & 0x3F));
+                }
+                else
+                {
+                    *dst++ = static_cast<char>(0xF0 | (cp >> 18));
+                    *dst++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                    *dst++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                    *dst++ = static_cast<char>(0x80 | (cp & 0x3F));
+                }
+
+                return true;
+            }
+
+            const std::string_view m_text;
+            const std::span<const uint32_t> m_positions;
+            JsonTapeDocument& m_document;
+            size_t m_index = 0;
+            std::vector<uint32_t> m_childrenStack;
+        };
+
+    }  // namespace
+
+    Result<RuntimeValuePtr> jsonParseTape(std::string_view text, IAllocator* allocator)
+    {
+        if (text.empty())
+        {
+            return MakeError("Empty string");
+        }
+
+        std::vector<uint32_t> positions;
+        CheckResult(jsonBuildStructuralIndex(text, positions));
+        if (positions.empty())
+        {
+            return MakeErrorT(serialization::SerializationError)("Json text contains no value");
+        }
+
+        IAllocator& documentAllocator = allocator ? *allocator : getDefaultAllocator();
+        auto document = rtti::createInstanceWithAllocator<JsonTapeDocument>(&documentAllocator, documentAllocator, positions.size(), text.size());
+
+        CheckResult(JsonTapeBuilder(text, positions, *document).build());
+
+        return document->getValue(0);
+    }
+
+}  // namespace my::json_detail
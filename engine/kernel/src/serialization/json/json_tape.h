@@ -0,0 +1,25 @@
+// #my_engine_source_file
+
+#pragma once
+
+#include "my/memory/allocator.h"
+#include "my/serialization/runtime_value.h"
+#include "my/utils/result.h"
+
+#include <string_view>
+
+namespace my::json_detail
+{
+    /**
+        Parses the text into the read-only tape document.
+
+        Parsing goes in two stages: the structural index is built over the whole text (see jsonBuildStructuralIndex),
+        then the tape (flat array of the nodes) is filled by walking over the structural positions.
+        Tape nodes, container children tables and decoded strings are kept within the single block allocated from the allocator.
+        Dictionaries and collections are exposed as ReadonlyDictionary/ReadonlyCollection views over the tape.
+
+        The parser is strict: comments are not supported, trailing commas are accepted.
+     */
+    Result<RuntimeValuePtr> jsonParseTape(std::string_view text, IAllocator* allocator);
+
+}  // namespace my::json_detail
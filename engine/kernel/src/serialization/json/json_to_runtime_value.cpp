@@ -103,35 +103,40 @@ namespace my::json_detail
         return kResultSuccess;
     }
 
-    RuntimeValuePtr getValueFromJson(const my::Ptr<JsonValueHolderImpl>& root, Json::Value& jsonValue)
+    RuntimeValuePtr getValueFromJson(const my::Ptr<JsonValueHolderImpl>& root, Json::Value& jsonValue, IAllocator* allocator)
     {
+        if (root)
+        {
+            allocator = root->getAllocator();
+        }
+
         if (jsonValue.isNull())
         {
             return createJsonNullValue(root);
         }
         else if (jsonValue.isUInt())
         {
-            return makeValueCopy(jsonValue.asUInt());
+            return makeValueCopy(jsonValue.asUInt(), allocator);
         }
         else if (jsonValue.isInt())
         {
-            return makeValueCopy(jsonValue.asInt());
+            return makeValueCopy(jsonValue.asInt(), allocator);
         }
         else if (jsonValue.isUInt64())
         {
-            return makeValueCopy(jsonValue.asUInt64());
+            return makeValueCopy(jsonValue.asUInt64(), allocator);
         }
         else if (jsonValue.isInt64())
         {
-            return makeValueCopy(jsonValue.asInt64());
+            return makeValueCopy(jsonValue.asInt64(), allocator);
         }
         else if (jsonValue.isDouble())
         {
-            return makeValueCopy(jsonValue.asDouble());
+            return makeValueCopy(jsonValue.asDouble(), allocator);
         }
         else if (jsonValue.isBool())
         {
-            return makeValueCopy(jsonValue.asBool());
+            return makeValueCopy(jsonValue.asBool(), allocator);
         }
         else if (jsonValue.isString())
         {
@@ -141,11 +146,11 @@ namespace my::json_detail
             {
                 if (std::optional<std::string> newString = root->transformString(str); newString)
                 {
-                    return makeValueCopy(std::move(*newString));
+                    return makeValueCopy(std::move(*newString), allocator);
                 }
             }
 
-            return makeValueCopy(std::move(str));
+            return makeValueCopy(std::move(str), allocator);
         }
         else if (jsonValue.isArray())
         {
@@ -406,74 +411,82 @@ namespace my::json_detail
 
     RuntimeValuePtr wrapJsonValueAsCollection(const Ptr<JsonValueHolderImpl>& root, Json::Value& jsonValue)
     {
-        return rtti::createInstance<JsonCollection>(root, jsonValue);
+        return rtti::createInstanceWithAllocator<JsonCollection>(root->getAllocator(), root, jsonValue);
     }
 
     RuntimeValuePtr wrapJsonValueAsDictionary(const Ptr<JsonValueHolderImpl>& root, Json::Value& jsonValue)
     {
-        return rtti::createInstance<JsonDictionary>(root, jsonValue);
+        return rtti::createInstanceWithAllocator<JsonDictionary>(root->getAllocator(), root, jsonValue);
     }
 
     RuntimeValuePtr createJsonNullValue(const Ptr<JsonValueHolderImpl>& root)
     {
-        return rtti::createInstance<JsonNull>(root);
+        return rtti::createInstanceWithAllocator<JsonNull>(root ? root->getAllocator() : nullptr, root);
+    }
+
+    template <typename T, typename... Args>
+    Ptr<T> createJsonRoot(IAllocator* allocator, Args&&... args)
+    {
+        auto holder = rtti::createInstanceWithAllocator<T>(allocator, std::forward<Args>(args)...);
+        holder->setAllocator(allocator);
+        return holder;
     }
 
-    Ptr<Dictionary> createJsonDictionary(Json::Value&& jsonValue)
+    Ptr<Dictionary> createJsonDictionary(Json::Value&& jsonValue, IAllocator* allocator)
     {
-        return rtti::createInstance<JsonDictionary>(std::move(jsonValue));
+        return createJsonRoot<JsonDictionary>(allocator, std::move(jsonValue));
     }
 
-    Ptr<Collection> createJsonCollection(Json::Value&& jsonValue)
+    Ptr<Collection> createJsonCollection(Json::Value&& jsonValue, IAllocator* allocator)
     {
-        return rtti::createInstance<JsonCollection>(std::move(jsonValue));
+        return createJsonRoot<JsonCollection>(allocator, std::move(jsonValue));
     }
 
-    Ptr<Dictionary> wrapJsonDictionary(Json::Value& jsonValue)
+    Ptr<Dictionary> wrapJsonDictionary(Json::Value& jsonValue, IAllocator* allocator)
     {
-        return rtti::createInstance<JsonDictionary>(jsonValue);
+        return createJsonRoot<JsonDictionary>(allocator, jsonValue);
     }
 
-    Ptr<Collection> wrapJsonCollection(Json::Value& jsonValue)
+    Ptr<Collection> wrapJsonCollection(Json::Value& jsonValue, IAllocator* allocator)
     {
-        return rtti::createInstance<JsonCollection>(jsonValue);
+        return createJsonRoot<JsonCollection>(allocator, jsonValue);
     }
 
 }  // namespace my::json_detail
 
 namespace my::serialization
 {
-    RuntimeValuePtr jsonToRuntimeValue(Json::Value&& root, IAllocator*)
+    RuntimeValuePtr jsonToRuntimeValue(Json::Value&& root, IAllocator* allocator)
     {
         if (root.isObject())
         {
-            return json_detail::createJsonDictionary(std::move(root));
+            return json_detail::createJsonDictionary(std::move(root), allocator);
         }
         else if (root.isArray())
         {
-            return json_detail::createJsonCollection(std::move(root));
+            return json_detail::createJsonCollection(std::move(root), allocator);
         }
 
-        return json_detail::getValueFromJson(nullptr, root);
+        return json_detail::getValueFromJson(nullptr, root, allocator);
     }
 
-    RuntimeValuePtr jsonAsRuntimeValue(Json::Value& root, IAllocator*)
+    RuntimeValuePtr jsonAsRuntimeValue(Json::Value& root, IAllocator* allocator)
     {
         if (root.isObject())
         {
-            return json_detail::wrapJsonDictionary(root);
+            return json_detail::wrapJsonDictionary(root, allocator);
         }
         else if (root.isArray())
         {
-            return json_detail::wrapJsonCollection(root);
+            return json_detail::wrapJsonCollection(root, allocator);
         }
 
         return nullptr;
     }
 
-    RuntimeValuePtr jsonAsRuntimeValue(const Json::Value& root, IAllocator*)
+    RuntimeValuePtr jsonAsRuntimeValue(const Json::Value& root, IAllocator* allocator)
     {
-        auto value = jsonAsRuntimeValue(const_cast<Json::Value&>(root));
+        auto value = jsonAsRuntimeValue(const_cast<Json::Value&>(root), allocator);
         value->as<json_detail::JsonValueHolderImpl&>().setMutable(false);
 
         return value;
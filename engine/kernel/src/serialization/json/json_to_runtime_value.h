@@ -54,7 +54,21 @@ namespace my::json_detail
         {
             m_isMutable = isMutable;
         }
-        
+
+        /**
+            Allocator for the values that are created while the json document is accessed. Only the root holder keeps it.
+         */
+        IAllocator* getAllocator() const
+        {
+            return m_root ? m_root->m_allocator : m_allocator;
+        }
+
+        void setAllocator(IAllocator* allocator)
+        {
+            MY_DEBUG_ASSERT(!m_root);
+            m_allocator = allocator;
+        }
+
 
     protected:
         JsonValueHolderImpl()
@@ -127,16 +141,20 @@ namespace my::json_detail
         std::variant<Json::Value, Json::Value*> m_jsonValue;
         bool m_isMutable = true;
         GetStringCallback m_getStringCallback;
+        IAllocator* m_allocator = nullptr;
     };
 
-    RuntimeValuePtr getValueFromJson(const my::Ptr<JsonValueHolderImpl>& root, Json::Value& jsonValue);
+    /**
+        @param allocator Used only when there is no root, otherwise the root's allocator is used.
+     */
+    RuntimeValuePtr getValueFromJson(const my::Ptr<JsonValueHolderImpl>& root, Json::Value& jsonValue, IAllocator* allocator = nullptr);
 
-    Ptr<Dictionary> createJsonDictionary(Json::Value&& jsonValue);
+    Ptr<Dictionary> createJsonDictionary(Json::Value&& jsonValue, IAllocator* allocator = nullptr);
     
-    Ptr<Collection> createJsonCollection(Json::Value&& jsonValue);
+    Ptr<Collection> createJsonCollection(Json::Value&& jsonValue, IAllocator* allocator = nullptr);
 
-    Ptr<Dictionary> wrapJsonDictionary(Json::Value& jsonValue);
+    Ptr<Dictionary> wrapJsonDictionary(Json::Value& jsonValue, IAllocator* allocator = nullptr);
     
-    Ptr<Collection> wrapJsonCollection(Json::Value& jsonValue);
+    Ptr<Collection> wrapJsonCollection(Json::Value& jsonValue, IAllocator* allocator = nullptr);
 
 }  // namespace my::json_detail
@@ -0,0 +1,127 @@
+// #my_engine_source_file
+
+#include "my/serialization/json.h"
+#include "my/serialization/json_codec.h"
+
+namespace my::ser_detail
+{
+    namespace
+    {
+        void writePrimitiveValue(JsonTextWriter& writer, const PrimitiveValue& value)
+        {
+            if (const auto* const integer = value.as<const IntegerValue*>())
+            {
+                if (integer->isSigned())
+                {
+                    writer.writeNumber(integer->getInt64());
+                }
+                else
+                {
+                    writer.writeNumber(integer->getUint64());
+                }
+            }
+            else if (const auto* const floatPoint = value.as<const FloatValue*>())
+            {
+                if (floatPoint->getBitsCount() == sizeof(double))
+                {
+                    writer.writeNumber(floatPoint->getDouble());
+                }
+                else
+                {
+                    writer.writeNumber(floatPoint->getSingle());
+                }
+            }
+            else if (const auto* const str = value.as<const StringValue*>())
+            {
+                writer.writeString(str->getString());
+            }
+            else if (const auto* const boolValue = value.as<const BooleanValue*>())
+            {
+                writer.writeBoolean(boolValue->getBool());
+            }
+            else
+            {
+                writer.writeNull();
+            }
+        }
+
+        bool isNullValue(RuntimeValue& value)
+        {
+            if (const auto* const optionalValue = value.as<const OptionalValue*>())
+            {
+                return !optionalValue->hasValue();
+            }
+
+            if (const auto* const refValue = value.as<const RuntimeValueRef*>())
+            {
+                return !static_cast<bool>(refValue->getValue());
+            }
+
+            return false;
+        }
+    }  // namespace
+
+    void jsonWriteRuntimeValue(JsonTextWriter& writer, const RuntimeValuePtr& value)
+    {
+        if (!value)
+        {
+            writer.writeNull();
+        }
+        else if (OptionalValue* const optionalValue = value->as<OptionalValue*>())
+        {
+            jsonWriteRuntimeValue(writer, optionalValue->hasValue() ? optionalValue->getValue() : nullptr);
+        }
+        else if (RuntimeValueRef* const refValue = value->as<RuntimeValueRef*>())
+        {
+            jsonWriteRuntimeValue(writer, refValue->getValue());
+        }
+        else if (const PrimitiveValue* const primitiveValue = value->as<const PrimitiveValue*>())
+        {
+            writePrimitiveValue(writer, *primitiveValue);
+        }
+        else if (ReadonlyCollection* const collection = value->as<ReadonlyCollection*>())
+        {
+            writer.beginArray();
+            for (size_t i = 0, size = collection->getSize(); i < size; ++i)
+            {
+                jsonWriteRuntimeValue(writer, collection->getAt(i));
+            }
+            writer.endArray();
+        }
+        else if (ReadonlyDictionary* const dict = value->as<ReadonlyDictionary*>())
+        {
+            const bool writeNulls = writer.getSettings().writeNulls;
+
+            writer.beginObject();
+            for (size_t i = 0, size = dict->getSize(); i < size; ++i)
+            {
+                const std::string_view key = dict->getKey(i);
+                const RuntimeValuePtr member = dict->getValue(key);
+                if (!writeNulls && (!member || isNullValue(*member)))
+                {
+                    continue;
+                }
+
+                writer.writeKey(key);
+                jsonWriteRuntimeValue(writer, member);
+            }
+            writer.endObject();
+        }
+        else
+        {
+            writer.writeNull();
+        }
+    }
+}  // namespace my::ser_detail
+
+namespace my::serialization
+{
+    Result<> jsonWrite(io::IStream& stream, const RuntimeValuePtr& value, JsonSettings settings)
+    {
+        ser_detail::JsonTextWriter writer{stream, settings};
+        ser_detail::jsonWriteRuntimeValue(writer, value);
+
+        return writer.flush();
+    }
+
+}  // namespace my::serialization
@@ -0,0 +1,494 @@
+// #my_engine_source_file
+
+#include "my/rtti/rtti_impl.h"
+#include "my/serialization/msgpack.h"
+#include "my/serialization/runtime_value_builder.h"
+
+#include <algorithm>
+
+namespace my::msgpack_detail
+{
+    namespace
+    {
+        using ser_detail::MsgPackReader;
+        using ser_detail::MsgPackType;
+
+        constexpr std::string_view NonMutableValueError = "Attempt to modify non mutable msgpack value";
+
+        /**
+            Keeps the parsed data alive: all the values are decoded directly from the buffer on access.
+         */
+        class MsgPackDocument final : public virtual IRefCounted
+        {
+            MY_REFCOUNTED_CLASS(my::msgpack_detail::MsgPackDocument, IRefCounted)
+
+        public:
+            MsgPackDocument(ReadOnlyBuffer buffer, IAllocator* allocator) :
+                m_buffer(std::move(buffer)),
+                m_allocator(allocator)
+            {
+            }
+
+            std::span<const std::byte> getData() const
+            {
+                return {m_buffer.data(), m_buffer.size()};
+            }
+
+            MsgPackReader getReader(size_t offset) const
+            {
+                return MsgPackReader{getData().subspan(offset)};
+            }
+
+            IAllocator* getAllocator() const
+            {
+                return m_allocator;
+            }
+
+            RuntimeValuePtr getValue(size_t offset);
+
+        private:
+            const ReadOnlyBuffer m_buffer;
+            IAllocator* const m_allocator;
+        };
+
+        /**
+         */
+        class MsgPackNull final : public OptionalValue
+        {
+            MY_REFCOUNTED_CLASS(my::msgpack_detail::MsgPackNull, OptionalValue)
+
+        public:
+            bool isMutable() const override
+            {
+                return false;
+            }
+
+            bool hasValue() const override
+            {
+                return false;
+            }
+
+            RuntimeValuePtr getValue() override
+            {
+                return nullptr;
+            }
+
+            Result<> setValue([[maybe_unused]] RuntimeValuePtr value) override
+            {
+                return MakeError(NonMutableValueError);
+            }
+        };
+
+        /**
+            String view into the document. StringValue returns std::string, so the copy happens only on getString().
+         */
+        class MsgPackString final : public StringValue
+        {
+            MY_REFCOUNTED_CLASS(my::msgpack_detail::MsgPackString, StringValue)
+
+        public:
+            MsgPackString(Ptr<MsgPackDocument> document, std::string_view str) :
+                m_document(std::move(document)),
+                m_str(str)
+            {
+            }
+
+            bool isMutable() const override
+            {
+                return false;
+            }
+
+            Result<> setString([[maybe_unused]] std::string_view str) override
+            {
+                return MakeError(NonMutableValueError);
+            }
+
+            std::string getString() const override
+            {
+                return std::string{m_str};
+            }
+
+        private:
+            const Ptr<MsgPackDocument> m_document;
+            const std::string_view m_str;
+        };
+
+        /**
+         */
+        class MsgPackBinaryImpl final : public serialization::MsgPackBinary
+        {
+            MY_REFCOUNTED_CLASS(my::msgpack_detail::MsgPackBinaryImpl, serialization::MsgPackBinary)
+
+        public:
+            MsgPackBinaryImpl(Ptr<MsgPackDocument> document, std::span<const std::byte> bytes) :
+                m_document(std::move(document)),
+                m_bytes(bytes)
+            {
+            }
+
+            bool isMutable() const override
+            {
+                return false;
+            }
+
+            size_t getSize() const override
+            {
+                return m_bytes.size();
+            }
+
+            RuntimeValuePtr getAt(size_t index) override
+            {
+                MY_DEBUG_ASSERT(index < m_bytes.size(), "Invalid index [{}]", index);
+                if (index >= m_bytes.size())
+                {
+                    return nullptr;
+                }
+
+                return makeValueCopy(static_cast<uint8_t>(m_bytes[index]), m_document->getAllocator());
+            }
+
+            Result<> setAt([[maybe_unused]] size_t index, [[maybe_unused]] const RuntimeValuePtr& value) override
+            {
+                return MakeError(NonMutableValueError);
+            }
+
+            std::span<const std::byte> getBytes() const override
+            {
+                return m_bytes;
+            }
+
+        private:
+            const Ptr<MsgPackDocument> m_document;
+            const std::span<const std::byte> m_bytes;
+        };
+
+        /**
+            Elements offsets are collected on creation, the elements itself are decoded on access.
+         */
+        class MsgPackCollection final : public ReadonlyCollection
+        {
+            MY_REFCOUNTED_CLASS(my::msgpack_detail::MsgPackCollection, ReadonlyCollection)
+
+        public:
+            MsgPackCollection(Ptr<MsgPackDocument> document, size_t offset) :
+                m_document(std::move(document))
+            {
+                MsgPackReader reader = m_document->getReader(offset);
+
+                // the document is validated before any value is created
+                const size_t size = *reader.readArrayHeader();
+                m_offsets.reserve(size);
+                for (size_t i = 0; i < size; ++i)
+                {
+                    m_offsets.push_back(offset + reader.getPosition());
+                    reader.skipValue().ignore();
+                }
+            }
+
+            bool isMutable() const override
+            {
+                return false;
+            }
+
+            size_t getSize() const override
+            {
+                return m_offsets.size();
+            }
+
+            RuntimeValuePtr getAt(size_t index) override
+            {
+                MY_DEBUG_ASSERT(index < m_offsets.size(), "Invalid index [{}]", index);
+                if (index >= m_offsets.size())
+                {
+                    return nullptr;
+                }
+
+                return m_document->getValue(m_offsets[index]);
+            }
+
+            Result<> setAt([[maybe_unused]] size_t index, [[maybe_unused]] const RuntimeValuePtr& value) override
+            {
+                return MakeError(NonMutableValueError);
+            }
+
+        private:
+            const Ptr<MsgPackDocument> m_document;
+            std::vector<size_t> m_offsets;
+        };
+
+        /**
+            Keys are the views into the document, values are decoded on access.
+         */
+        class MsgPackDictionary final : public ReadonlyDictionary
+        {
+            MY_REFCOUNTED_CLASS(my::msgpack_detail::MsgPackDictionary, ReadonlyDictionary)
+
+        public:
+            MsgPackDictionary(Ptr<MsgPackDocument> document, size_t offset) :
+                m_document(std::move(document))
+            {
+                MsgPackReader reader = m_document->getReader(offset);
+
+                // the document is validated before any value is created
+                const size_t size = *reader.readMapHeader();
+                m_members.reserve(size);
+                for (size_t i = 0; i < size; ++i)
+                {
+                    const std::string_view key = *reader.readString();
+                    m_members.emplace_back(key, offset + reader.getPosition());
+                    reader.skipValue().ignore();
+                }
+            }
+
+            bool isMutable() const override
+            {
+                return false;
+            }
+
+            size_t getSize() const override
+            {
+                return m_members.size();
+            }
+
+            std::string_view getKey(size_t index) const override
+            {
+                MY_DEBUG_ASSERT(index < m_members.size(), "Invalid index ({}) > size:({})", index, m_members.size());
+                return m_members[index].first;
+            }
+
+            RuntimeValuePtr getValue(std::string_view key) override
+            {
+                const auto member = findMember(key);
+                return member != m_members.end() ? m_document->getValue(member->second) : nullptr;
+            }
+
+            Result<> setValue([[maybe_unused]] std::string_view key, [[maybe_unused]] const RuntimeValuePtr& value) override
+            {
+                return MakeError(NonMutableValueError);
+            }
+
+            bool containsKey(std::string_view key) const override
+            {
+                return findMember(key) != m_members.end();
+            }
+
+        private:
+            using Members = std::vector<std::pair<std::string_view, size_t>>;
+
+            Members::const_iterator findMember(std::string_view key) const
+            {
+                return std::find_if(m_members.begin(), m_members.end(), [key](const auto& member)
+                {
+                    return member.first == key;
+                });
+            }
+
+            const Ptr<MsgPackDocument> m_document;
+            Members m_members;
+        };
+
+        RuntimeValuePtr MsgPackDocument::getValue(size_t offset)
+        {
+            MsgPackReader reader = getReader(offset);
+
+            // values are decoded only from the validated document, so the reads can not fail
+            switch (reader.peekType())
+            {
+                case MsgPackType::Nil:
+                    return rtti::createInstanceWithAllocator<MsgPackNull>(m_allocator);
+                case MsgPackType::Boolean:
+                    return makeValueCopy(*reader.readBoolean(), m_allocator);
+                case MsgPackType::Integer:
+                {
+                    const ser_detail::MsgPackInteger integer = *reader.readInteger();
+                    if (integer.isNegative || integer.bits <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+                    {
+                        return makeValueCopy(integer.asInt64(), m_allocator);
+                    }
+
+                    return makeValueCopy(integer.bits, m_allocator);
+                }
+                case MsgPackType::Float:
+                {
+                    bool isSingle = false;
+                    const double value = *reader.readFloat(&isSingle);
+                    return isSingle ? makeValueCopy(static_cast<float>(value), m_allocator) : makeValueCopy(value, m_allocator);
+                }
+                case MsgPackType::String:
+                    return rtti::createInstanceWithAllocator<MsgPackString>(m_allocator, Ptr{this}, *reader.readString());
+                case MsgPackType::Binary:
+                    return rtti::createInstanceWithAllocator<MsgPackBinaryImpl>(m_allocator, Ptr{this}, *reader.readBinary());
+                case MsgPackType::Array:
+                    return rtti::createInstanceWithAllocator<MsgPackCollection>(m_allocator, Ptr{this}, offset);
+                case MsgPackType::Map:
+                    return rtti::createInstanceWithAllocator<MsgPackDictionary>(m_allocator, Ptr{this}, offset);
+                default:
+                    break;
+            }
+
+            MY_FAILURE("Unexpected msgpack value type");
+            return nullptr;
+        }
+
+        /**
+            Checks the whole value before any runtime value is created:
+            bounds, nesting depth, supported types and that all the map keys are strings.
+         */
+        Result<> validateValue(MsgPackReader& reader, size_t depth)
+        {
+            if (depth > MsgPackReader::MaxDepth)
+            {
+                return reader.makeError("Maximum nesting depth exceeded");
+            }
+
+            const MsgPackType type = reader.peekType();
+            if (type == MsgPackType::Array || type == MsgPackType::Map)
+            {
+                Result<size_t> size = type == MsgPackType::Array ? reader.readArrayHeader() : reader.readMapHeader();
+                CheckResult(size);
+
+                for (size_t i = 0; i < *size; ++i)
+                {
+                    if (type == MsgPackType::Map)
+                    {
+                        if (reader.peekType() != MsgPackType::String)
+                        {
+                            return reader.makeError(std::format("Map key must be string, but ({}) found", ser_detail::getMsgPackTypeName(reader.peekType())));
+                        }
+
+                        CheckResult(reader.skipValue());
+                    }
+
+                    CheckResult(validateValue(reader, depth + 1));
+                }
+
+                return kResultSuccess;
+            }
+
+            if (type == MsgPackType::Extension || type == MsgPackType::Invalid)
+            {
+                return reader.makeError(std::format("Unsupported value type ({})", ser_detail::getMsgPackTypeName(type)));
+            }
+
+            return reader.skipValue();
+        }
+    }  // namespace
+}  // namespace my::msgpack_detail
+
+namespace my::ser_detail
+{
+    void msgpackWriteRuntimeValue(MsgPackWriter& writer, const RuntimeValuePtr& value)
+    {
+        if (!value)
+        {
+            writer.writeNil();
+        }
+        else if (OptionalValue* const optionalValue = value->as<OptionalValue*>())
+        {
+            msgpackWriteRuntimeValue(writer, optionalValue->hasValue() ? optionalValue->getValue() : nullptr);
+        }
+        else if (RuntimeValueRef* const refValue = value->as<RuntimeValueRef*>())
+        {
+            msgpackWriteRuntimeValue(writer, refValue->getValue());
+        }
+        else if (const auto* const integer = value->as<const IntegerValue*>())
+        {
+            if (integer->isSigned())
+            {
+                writer.writeInteger(integer->getInt64());
+            }
+            else
+            {
+                writer.writeInteger(integer->getUint64());
+            }
+        }
+        else if (const auto* const floatPoint = value->as<const FloatValue*>())
+        {
+            if (floatPoint->getBitsCount() == sizeof(double))
+            {
+                writer.writeDouble(floatPoint->getDouble());
+            }
+            else
+            {
+                writer.writeFloat(floatPoint->getSingle());
+            }
+        }
+        else if (const auto* const str = value->as<const StringValue*>())
+        {
+            writer.writeString(str->getString());
+        }
+        else if (const auto* const boolValue = value->as<const BooleanValue*>())
+        {
+            writer.writeBoolean(boolValue->getBool());
+        }
+        else if (const auto* const binary = value->as<const serialization::MsgPackBinary*>())
+        {
+            writer.writeBinary(binary->getBytes());
+        }
+        else if (ReadonlyCollection* const collection = value->as<ReadonlyCollection*>())
+        {
+            const size_t size = collection->getSize();
+            writer.beginArray(size);
+            for (size_t i = 0; i < size; ++i)
+            {
+                msgpackWriteRuntimeValue(writer, collection->getAt(i));
+            }
+        }
+        else if (ReadonlyDictionary* const dict = value->as<ReadonlyDictionary*>())
+        {
+            // map header requires the members count, so the null members are also written (as nil)
+            const size_t size = dict->getSize();
+            writer.beginMap(size);
+            for (size_t i = 0; i < size; ++i)
+            {
+                const std::string_view key = dict->getKey(i);
+                writer.writeString(key);
+                msgpackWriteRuntimeValue(writer, dict->getValue(key));
+            }
+        }
+        else
+        {
+            writer.writeNil();
+        }
+    }
+}  // namespace my::ser_detail
+
+namespace my::serialization
+{
+    Result<> msgpackWrite(io::IStream& stream, const RuntimeValuePtr& value)
+    {
+        ser_detail::MsgPackWriter writer{stream};
+        ser_detail::msgpackWriteRuntimeValue(writer, value);
+
+        return writer.flush();
+    }
+
+    Result<RuntimeValuePtr> msgpackParse(ReadOnlyBuffer buffer, IAllocator* allocator)
+    {
+        using namespace my::msgpack_detail;
+
+        if (buffer.size() == 0)
+        {
+            return MakeErrorT(EndOfStreamError)();
+        }
+
+        ser_detail::MsgPackReader reader{std::span{buffer.data(), buffer.size()}};
+        CheckResult(validateValue(reader, 0));
+        if (!reader.isEnd())
+        {
+            return reader.makeError("Unexpected data after the root value");
+        }
+
+        auto document = rtti::createInstanceWithAllocator<MsgPackDocument>(allocator, std::move(buffer), allocator);
+        return document->getValue(0);
+    }
+
+    Result<RuntimeValuePtr> msgpackParse(io::IStream& stream, IAllocator* allocator)
+    {
+        Result<Buffer> buffer = io::readStreamToEnd(stream);
+        CheckResult(buffer);
+
+        return msgpackParse(buffer->toReadOnly(), allocator);
+    }
+
+}  // namespace my::serialization
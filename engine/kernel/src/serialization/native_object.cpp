@@ -12,43 +12,76 @@ namespace my::ser_detail
         return fields[index].getName();
     }
 
-    RuntimeValuePtr RuntimeObjectState::getValue(const RuntimeValue& parent, const void* obj, std::string_view key) const
+    size_t RuntimeObjectState::findFieldIndex(std::string_view key) const
     {
-        auto fields = getFields();
+        if (!m_useLinearLookup)
+        {
+            return m_fieldsIndex.find(key);
+        }
+
+        const std::span<RuntimeFieldAccessor> fields = getFields();
 
         auto field = std::find_if(fields.begin(), fields.end(), [key](const RuntimeFieldAccessor& field)
         {
             return strings::icaseEqual(field.getName(), key);
         });
 
-        return field != fields.end() ? field->getRuntimeValue(parent, const_cast<void*>(obj)) : nullptr;
+        return field != fields.end() ? static_cast<size_t>(field - fields.begin()) : NotFound;
+    }
+
+    RuntimeValuePtr RuntimeObjectState::getValueAt(const RuntimeValue& parent, const void* obj, size_t index) const
+    {
+        auto fields = getFields();
+
+        MY_DEBUG_ASSERT(index < fields.size());
+        return fields[index].getRuntimeValue(parent, const_cast<void*>(obj));
+    }
+
+    RuntimeValuePtr RuntimeObjectState::getValue(const RuntimeValue& parent, const void* obj, std::string_view key) const
+    {
+        const size_t index = findFieldIndex(key);
+        return index != NotFound ? getValueAt(parent, obj, index) : nullptr;
     }
 
     bool RuntimeObjectState::containsKey(std::string_view key) const
     {
-        return findField(key) != nullptr;
+        return findFieldIndex(key) != NotFound;
     }
 
-    Result<> RuntimeObjectState::setFieldValue(const RuntimeValue& parent, const void* obj, std::string_view key, const RuntimeValuePtr& value)
+    Result<> RuntimeObjectState::setFieldValue(const RuntimeValue& parent, const void* obj, std::string_view key, const RuntimeValuePtr& value) const
     {
-        auto* const field = findField(key);
-        if (field == nullptr)
+        const size_t index = findFieldIndex(key);
+        if (index == NotFound)
         {
             return MakeError("Class does not contains field:({})", key);
         }
 
-        return RuntimeValue::assign(field->getRuntimeValue(parent, const_cast<void*>(obj)), value);
+        return RuntimeValue::assign(getValueAt(parent, obj, index), value);
     }
 
-    RuntimeFieldAccessor* RuntimeObjectState::findField(std::string_view key) const
+    void RuntimeObjectState::buildFieldsIndex()
     {
         const std::span<RuntimeFieldAccessor> fields = getFields();
 
-        auto field = std::find_if(fields.begin(), fields.end(), [key](const RuntimeFieldAccessor& field)
+        std::vector<std::string_view> names;
+        names.reserve(fields.size());
+
+        for (const RuntimeFieldAccessor& field : fields)
         {
-            return strings::icaseEqual(field.getName(), key);
-        });
+            const bool isDuplicate = std::any_of(names.begin(), names.end(), [&field](std::string_view name)
+            {
+                return strings::icaseEqual(name, field.getName());
+            });
+
+            if (isDuplicate)
+            {
+                m_useLinearLookup = true;
+                return;
+            }
+
+            names.push_back(field.getName());
+        }
 
-        return field != fields.end() ? &(*field) : nullptr;
+        m_fieldsIndex = StringPerfectHash{names, true};
     }
 }  // namespace my::ser_detail
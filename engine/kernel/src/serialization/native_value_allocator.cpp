@@ -0,0 +1,21 @@
+// #my_engine_source_file
+#include "my/memory/small_block_allocator.h"
+#include "my/serialization/native_runtime_value/native_value_base.h"
+#include "my/utils/scope_guard.h"
+
+namespace my::ser_detail
+{
+    IAllocator& getNativeValueAllocator()
+    {
+        // The allocator is never released: runtime values can be kept by the static objects
+        // that are destroyed after this function's local statics.
+        static IAllocator* const allocator = EXPR_Block->IAllocator*
+        {
+            AllocatorPtr smallBlockAllocator = createSmallBlockAllocator();
+            smallBlockAllocator->setName("NativeRuntimeValues");
+            return smallBlockAllocator.giveUp();
+        };
+
+        return *allocator;
+    }
+}  // namespace my::ser_detail
@@ -0,0 +1,395 @@
+// #my_engine_source_file
+
+#include "my/serialization/runtime_value_delta.h"
+
+#include "my/rtti/rtti_impl.h"
+#include "my/serialization/json.h"
+#include "my/serialization/runtime_value_builder.h"
+
+#include <charconv>
+#include <map>
+#include <string>
+
+namespace my::ser_detail
+{
+    /**
+        Changed parts of the tree: the node is either changed entirely or keeps the changed children.
+     */
+    struct ChangedNode
+    {
+        bool isChanged = false;
+        std::map<std::string, ChangedNode, std::less<>> children;
+
+        void markChanged()
+        {
+            isChanged = true;
+            children.clear();
+        }
+
+        bool hasChanges() const
+        {
+            return isChanged || !children.empty();
+        }
+    };
+
+    /**
+     */
+    class RuntimeValueChangesCollector final : public IRuntimeValueChangesHandler
+    {
+        MY_REFCOUNTED_CLASS(my::ser_detail::RuntimeValueChangesCollector, IRuntimeValueChangesHandler)
+
+    public:
+        const ChangedNode& getChanges() const
+        {
+            return m_root;
+        }
+
+        ChangedNode& getChanges()
+        {
+            return m_root;
+        }
+
+    private:
+        void onValueChanged(const RuntimeValue&, std::string_view) override
+        {
+        }
+
+        void onValueTreeChanged(const RuntimeValue&, const RuntimeValueChangePath* path) override
+        {
+            ChangedNode* node = &m_root;
+
+            // a segment without key means that the parent can not address the changed child, so the parent is changed entirely.
+            for (; path && !path->key.empty(); path = path->next)
+            {
+                if (node->isChanged)
+                {
+                    return;
+                }
+
+                auto child = node->children.find(path->key);
+                if (child == node->children.end())
+                {
+                    child = node->children.emplace(std::string{path->key}, ChangedNode{}).first;
+                }
+
+                node = &child->second;
+            }
+
+            node->markChanged();
+        }
+
+        ChangedNode m_root;
+    };
+
+}  // namespace my::ser_detail
+
+namespace my::serialization
+{
+    namespace
+    {
+        constexpr std::string_view OpAdd = "add";
+        constexpr std::string_view OpReplace = "replace";
+        constexpr std::string_view OpRemove = "remove";
+
+        void appendPathSegment(std::string& path, std::string_view key)
+        {
+            path.push_back('/');
+            for (const char c : key)
+            {
+                if (c == '~')
+                {
+                    path.append("~0");
+                }
+                else if (c == '/')
+                {
+                    path.append("~1");
+                }
+                else
+                {
+                    path.push_back(c);
+                }
+            }
+        }
+
+        std::string unescapePathSegment(std::string_view segment)
+        {
+            std::string key;
+            key.reserve(segment.size());
+
+            for (size_t i = 0; i < segment.size(); ++i)
+            {
+                if (segment[i] == '~' && i + 1 < segment.size() && (segment[i + 1] == '0' || segment[i + 1] == '1'))
+                {
+                    key.push_back(segment[++i] == '0' ? '~' : '/');
+                }
+                else
+                {
+                    key.push_back(segment[i]);
+                }
+            }
+
+            return key;
+        }
+
+        std::optional<size_t> parseIndex(std::string_view key)
+        {
+            size_t index = 0;
+            const auto [end, errc] = std::from_chars(key.data(), key.data() + key.size(), index);
+            if (errc != std::errc{} || end != key.data() + key.size())
+            {
+                return std::nullopt;
+            }
+
+            return index;
+        }
+
+        RuntimeValuePtr findChild(RuntimeValue& value, std::string_view key)
+        {
+            if (auto* const dict = value.as<ReadonlyDictionary*>())
+            {
+                return dict->containsKey(key) ? dict->getValue(key) : nullptr;
+            }
+
+            if (auto* const collection = value.as<ReadonlyCollection*>())
+            {
+                const std::optional<size_t> index = parseIndex(key);
+                return index && *index < collection->getSize() ? collection->getAt(*index) : nullptr;
+            }
+
+            return nullptr;
+        }
+
+        void addPatchOperation(Collection& patch, std::string_view op, const std::string& path, const RuntimeValuePtr& value)
+        {
+            Ptr<Dictionary> operation = jsonCreateDictionary();
+            operation->setValue("op", makeValueCopy(op)).ignore();
+            operation->setValue("path", makeValueCopy(std::string_view{path})).ignore();
+            if (value)
+            {
+                operation->setValue("value", value).ignore();
+            }
+
+            patch.append(operation).ignore();
+        }
+
+        void writeChanges(Collection& patch, const RuntimeValuePtr& value, const ser_detail::ChangedNode& node, std::string& path, bool isCollectionElement)
+        {
+            if (node.isChanged)
+            {
+                // 'add' also replaces the existing dictionary member, but inserts into the collection.
+                const std::string_view op = path.empty() || isCollectionElement ? OpReplace : OpAdd;
+                addPatchOperation(patch, op, path, value);
+                return;
+            }
+
+            const bool isCollection = value->is<ReadonlyCollection>();
+
+            for (const auto& [key, childNode] : node.children)
+            {
+                const size_t pathSize = path.size();
+                appendPathSegment(path, key);
+
+                if (RuntimeValuePtr childValue = findChild(*value, key))
+                {
+                    writeChanges(patch, childValue, childNode, path, isCollection);
+                }
+                else
+                {
+                    addPatchOperation(patch, OpRemove, path, nullptr);
+                }
+
+                path.resize(pathSize);
+            }
+        }
+
+        Result<std::string> getOperationString(ReadonlyDictionary& operation, std::string_view name)
+        {
+            RuntimeValuePtr value = operation.containsKey(name) ? operation.getValue(name) : nullptr;
+            auto* const str = value ? value->as<StringValue*>() : nullptr;
+            if (!str)
+            {
+                return MakeError("Patch operation does not contains string ({})", name);
+            }
+
+            return str->getString();
+        }
+
+        Result<> applyOperation(RuntimeValue& target, std::string_view op, std::string_view path, const RuntimeValuePtr& value)
+        {
+            const bool isRemove = op == OpRemove;
+            if (!isRemove && op != OpAdd && op != OpReplace)
+            {
+                return MakeError("Unsupported patch operation ({})", op);
+            }
+
+            if (!isRemove && !value)
+            {
+                return MakeError("Patch operation ({}) at ({}) has no value", op, path);
+            }
+
+            if (path.empty())
+            {
+                if (isRemove)
+                {
+                    return MakeError("Can not remove the root value");
+                }
+
+                return RuntimeValue::assign(RuntimeValuePtr{&target}, value);
+            }
+
+            if (path.front() != '/')
+            {
+                return MakeError("Invalid patch path ({})", path);
+            }
+
+            // walk down to the parent of the last segment
+            RuntimeValuePtr parent{&target};
+            std::string_view rest = path.substr(1);
+            for (size_t separator = rest.find('/'); separator != std::string_view::npos; separator = rest.find('/'))
+            {
+                parent = findChild(*parent, unescapePathSegment(rest.substr(0, separator)));
+                if (!parent)
+                {
+                    return MakeError("Patch path ({}) does not exists", path);
+                }
+
+                rest.remove_prefix(separator + 1);
+            }
+
+            const std::string key = unescapePathSegment(rest);
+
+            if (auto* const dict = parent->as<ReadonlyDictionary*>())
+            {
+                if (!isRemove)
+                {
+                    return dict->setValue(key, value);
+                }
+
+                auto* const mutableDict = parent->as<Dictionary*>();
+                if (!mutableDict)
+                {
+                    return MakeError("Can not remove ({}): the value does not support erase", path);
+                }
+
+                if (!mutableDict->erase(key))
+                {
+                    return MakeError("Can not remove ({}): the value does not exists", path);
+                }
+
+                return kResultSuccess;
+            }
+
+            if (auto* const collection = parent->as<ReadonlyCollection*>())
+            {
+                const std::optional<size_t> index = key == "-" ? collection->getSize() : parseIndex(key);
+                if (!index || *index > collection->getSize())
+                {
+                    return MakeError("Invalid collection index at ({})", path);
+                }
+
+                if (isRemove)
+                {
+                    return MakeError("Removing collection elements is not supported ({})", path);
+                }
+
+                if (*index < collection->getSize())
+                {
+                    if (op == OpAdd)
+                    {
+                        return MakeError("Inserting into collection is not supported ({})", path);
+                    }
+
+                    return collection->setAt(*index, value);
+                }
+
+                auto* const mutableCollection = parent->as<Collection*>();
+                if (op != OpAdd || !mutableCollection)
+                {
+                    return MakeError("Can not append ({})", path);
+                }
+
+                return mutableCollection->append(value);
+            }
+
+            return MakeError("Patch path ({}) does not refer to the container", path);
+        }
+
+    }  // namespace
+
+    RuntimeValueChangesTracker::RuntimeValueChangesTracker(RuntimeValuePtr root) :
+        m_root(std::move(root)),
+        m_collector(rtti::createInstance<ser_detail::RuntimeValueChangesCollector>())
+    {
+        MY_DEBUG_FATAL(m_root);
+
+        if (auto* const events = m_root->as<IRuntimeValueEvents*>())
+        {
+            m_subscription = events->subscribeOnChanges(m_collector);
+        }
+        else
+        {
+            m_collector->getChanges().markChanged();
+        }
+    }
+
+    RuntimeValueChangesTracker::RuntimeValueChangesTracker(RuntimeValueChangesTracker&&) = default;
+
+    RuntimeValueChangesTracker::~RuntimeValueChangesTracker() = default;
+
+    RuntimeValueChangesTracker& RuntimeValueChangesTracker::operator=(RuntimeValueChangesTracker&&) = default;
+
+    bool RuntimeValueChangesTracker::hasChanges() const
+    {
+        return m_collector && m_collector->getChanges().hasChanges();
+    }
+
+    void RuntimeValueChangesTracker::reset()
+    {
+        MY_DEBUG_FATAL(m_collector);
+
+        ser_detail::ChangedNode& changes = m_collector->getChanges();
+        changes = {};
+
+        // there is no way to track the changes, the root is always reported as changed.
+        if (!m_subscription)
+        {
+            changes.markChanged();
+        }
+    }
+
+    Ptr<Collection> RuntimeValueChangesTracker::makeJsonPatch() const
+    {
+        MY_DEBUG_FATAL(m_collector);
+
+        Ptr<Collection> patch = jsonCreateCollection();
+        std::string path;
+        writeChanges(*patch, m_root, m_collector->getChanges(), path, false);
+
+        return patch;
+    }
+
+    Result<> applyJsonPatch(RuntimeValue& target, ReadonlyCollection& patch)
+    {
+        for (size_t i = 0, size = patch.getSize(); i < size; ++i)
+        {
+            RuntimeValuePtr operationValue = patch.getAt(i);
+            auto* const operation = operationValue ? operationValue->as<ReadonlyDictionary*>() : nullptr;
+            if (!operation)
+            {
+                return MakeError("Patch operation ({}) is not a dictionary", i);
+            }
+
+            Result<std::string> op = getOperationString(*operation, "op");
+            CheckResult(op);
+
+            Result<std::string> path = getOperationString(*operation, "path");
+            CheckResult(path);
+
+            RuntimeValuePtr value = operation->containsKey("value") ? operation->getValue("value") : nullptr;
+            CheckResult(applyOperation(target, *op, *path, value));
+        }
+
+        return kResultSuccess;
+    }
+
+}  // namespace my::serialization
@@ -0,0 +1,131 @@
+// #my_engine_source_file
+#include "my/io/memory_stream.h"
+#include "my/io/virtual_file_system.h"
+#include "my/io/zip_archive_file_system.h"
+#include "my/test/helpers/zip_archive_builder.h"
+
+namespace my::benchmark
+{
+    namespace
+    {
+        constexpr size_t FilesPerMountCount = 16;
+
+        std::string makeFilePath(size_t mountIndex, size_t fileIndex)
+        {
+            return std::format("/content/packs/pack_{}/data/file_{}.bin", mountIndex, fileIndex);
+        }
+
+        /**
+            Vfs with the given count of sibling mount points (mount tree width).
+         */
+        io::VirtualFileSystemPtr makeVfs(size_t mountsCount, bool cacheDirectoryContent = false)
+        {
+            test::ZipArchiveBuilder builder;
+            for (size_t i = 0; i < FilesPerMountCount; ++i)
+            {
+                builder.addFile(std::format("data/file_{}.bin", i), "content");
+            }
+
+            const Buffer archive = builder.build();
+
+            io::VirtualFileSystemPtr vfs = io::createVirtualFileSystem();
+            for (size_t i = 0; i < mountsCount; ++i)
+            {
+                io::FileSystemPtr fs = io::createZipArchiveFileSystem(io::createReadonlyMemoryStream({archive.data(), archive.size()}));
+                [[maybe_unused]] Result<> mountResult = vfs->mount(std::format("/content/packs/pack_{}", i), std::move(fs), io::VfsMountSettings{.cacheDirectoryContent = cacheDirectoryContent});
+            }
+
+            return vfs;
+        }
+    }  // namespace
+
+    /**
+        exists() for the files of all mount points: parallel asset loading lookup pattern.
+     */
+    static void BM_VfsExists(::benchmark::State& state)
+    {
+        const size_t mountsCount = static_cast<size_t>(state.range(0));
+
+        static io::VirtualFileSystemPtr vfs;
+        static std::vector<io::FsPath> paths;
+        if (state.thread_index() == 0)
+        {
+            vfs = makeVfs(mountsCount);
+            paths.clear();
+            for (size_t i = 0; i < mountsCount * FilesPerMountCount; ++i)
+            {
+                paths.emplace_back(makeFilePath(i % mountsCount, i / mountsCount));
+            }
+        }
+
+        size_t index = static_cast<size_t>(state.thread_index());
+        for (auto _ : state)
+        {
+            const bool exists = vfs->exists(paths[index % paths.size()], io::FsEntryKind::File);
+            ::benchmark::DoNotOptimize(exists);
+            index += 7;
+        }
+
+        state.SetItemsProcessed(state.iterations());
+
+        if (state.thread_index() == 0)
+        {
+            vfs.reset();
+        }
+    }
+
+    /**
+        Recursive scan of the whole content tree by batches, with and without the directory content cache.
+     */
+    static void BM_VfsScanContent(::benchmark::State& state)
+    {
+        const io::VirtualFileSystemPtr vfs = makeVfs(64, state.range(0) != 0);
+
+        for (auto _ : state)
+        {
+            size_t filesCount = 0;
+            std::vector<io::FsPath> directories{"/content"};
+            std::array<io::FsEntry, 64> batch;
+
+            while (!directories.empty())
+            {
+                const io::FsPath path = std::move(directories.back());
+                directories.pop_back();
+
+                auto openResult = vfs->openDirIterator(path);
+                if (!openResult || !std::get<0>(*openResult))
+                {
+                    continue;
+                }
+
+                auto& [iter, firstEntry] = *openResult;
+                batch[0] = std::move(firstEntry);
+                for (size_t count = 1; count > 0; count = vfs->readDirEntries(iter, batch))
+                {
+                    for (io::FsEntry& entry : std::span{batch}.first(count))
+                    {
+                        if (entry.kind == io::FsEntryKind::Directory)
+                        {
+                            directories.push_back(std::move(entry.path));
+                        }
+                        else
+                        {
+                            ++filesCount;
+                        }
+                    }
+                }
+
+                vfs->closeDirIterator(iter);
+            }
+
+            ::benchmark::DoNotOptimize(filesCount);
+        }
+
+        state.SetItemsProcessed(state.iterations() * 64 * FilesPerMountCount);
+        state.SetLabel(state.range(0) != 0 ? "cached" : "uncached");
+    }
+
+    BENCHMARK(BM_VfsExists)->Arg(4)->Arg(64)->Arg(512)->Threads(1)->Threads(8)->UseRealTime();
+    BENCHMARK(BM_VfsScanContent)->Arg(0)->Arg(1)->Unit(::benchmark::kMicrosecond);
+
+}  // namespace my::benchmark
@@ -0,0 +1,139 @@
+// #my_engine_source_file
+#include "my/async/thread_pool_executor.h"
+#include "my/io/memory_stream.h"
+#include "my/io/zip_archive_file_system.h"
+#include "my/test/helpers/zip_archive_builder.h"
+
+namespace my::benchmark
+{
+    namespace
+    {
+        constexpr size_t SmallEntriesCount = 10'000;
+
+        using Method = test::ZipArchiveBuilder::Method;
+
+        std::string makeEntryPath(size_t index)
+        {
+            return std::format("assets/group_{}/entry_{}.txt", index % 100, index);
+        }
+
+        const Buffer& getArchive(Method method)
+        {
+            const auto build = [](Method method)
+            {
+                test::ZipArchiveBuilder builder;
+                for (size_t i = 0; i < SmallEntriesCount; ++i)
+                {
+                    builder.addFile(makeEntryPath(i), std::format("small entry content [{}] {}", i, std::string(64 + i % 128, 'x')), method);
+                }
+
+                return builder.build();
+            };
+
+            static const Buffer storedArchive = build(Method::Stored);
+            static const Buffer deflatedArchive = build(Method::Deflated);
+
+            return method == Method::Stored ? storedArchive : deflatedArchive;
+        }
+
+        io::FileSystemPtr openArchive(Method method, io::ZipArchiveFileSystemSettings settings = {})
+        {
+            const Buffer& archive = getArchive(method);
+            return io::createZipArchiveFileSystem(io::createReadonlyMemoryStream({archive.data(), archive.size()}), std::move(settings));
+        }
+
+        size_t readEntry(io::FileSystem& fs, const io::FsPath& path)
+        {
+            const io::FilePtr file = fs.openFile(path, io::AccessMode::Read, io::OpenFileMode::OpenExisting);
+            const std::span<const std::byte> content = file->createStream(io::AccessMode::Read)->as<io::MemoryStream&>().getBufferAsSpan(0, std::nullopt);
+            return content.size();
+        }
+
+        std::vector<io::FsPath> getEntryPaths()
+        {
+            std::vector<io::FsPath> paths;
+            paths.reserve(SmallEntriesCount);
+            for (size_t i = 0; i < SmallEntriesCount; ++i)
+            {
+                paths.emplace_back(makeEntryPath(i));
+            }
+
+            return paths;
+        }
+    }  // namespace
+
+    /**
+        Parse of the central directory with 10k entries.
+     */
+    static void BM_ZipMount(::benchmark::State& state)
+    {
+        for (auto _ : state)
+        {
+            io::FileSystemPtr fs = openArchive(Method::Stored);
+            ::benchmark::DoNotOptimize(fs);
+        }
+
+        state.SetItemsProcessed(state.iterations() * SmallEntriesCount);
+    }
+
+    /**
+        Open + read of all the 10k entries (archive is mounted for every iteration, so the cache is cold).
+     */
+    static void BM_ZipOpenRead(::benchmark::State& state)
+    {
+        const Method method = static_cast<Method>(state.range(0));
+        const std::vector<io::FsPath> paths = getEntryPaths();
+
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            const io::FileSystemPtr fs = openArchive(method, {.maxCacheSize = 64 * 1024 * 1024});
+            state.ResumeTiming();
+
+            size_t totalSize = 0;
+            for (const io::FsPath& path : paths)
+            {
+                totalSize += readEntry(*fs, path);
+            }
+
+            ::benchmark::DoNotOptimize(totalSize);
+        }
+
+        state.SetItemsProcessed(state.iterations() * SmallEntriesCount);
+        state.SetLabel(method == Method::Stored ? "stored" : "deflated");
+    }
+
+    /**
+        Parallel inflate of all the 10k deflated entries with prefetch, then open + read.
+     */
+    static void BM_ZipPrefetchOpenRead(::benchmark::State& state)
+    {
+        const std::vector<io::FsPath> paths = getEntryPaths();
+        const async::ExecutorPtr executor = async::createThreadPoolExecutor(static_cast<size_t>(state.range(0)));
+
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            const io::FileSystemPtr fs = openArchive(Method::Deflated, {.inflateExecutor = executor, .maxCacheSize = 64 * 1024 * 1024});
+            state.ResumeTiming();
+
+            async::Task<> prefetchTask = fs->as<io::IZipArchiveFileSystem&>().prefetch(paths);
+            async::wait(prefetchTask);
+
+            size_t totalSize = 0;
+            for (const io::FsPath& path : paths)
+            {
+                totalSize += readEntry(*fs, path);
+            }
+
+            ::benchmark::DoNotOptimize(totalSize);
+        }
+
+        state.SetItemsProcessed(state.iterations() * SmallEntriesCount);
+    }
+
+    BENCHMARK(BM_ZipMount)->Unit(::benchmark::kMillisecond);
+    BENCHMARK(BM_ZipOpenRead)->Arg(static_cast<int>(Method::Stored))->Arg(static_cast<int>(Method::Deflated))->Unit(::benchmark::kMillisecond);
+    BENCHMARK(BM_ZipPrefetchOpenRead)->Arg(1)->Arg(4)->Arg(8)->Unit(::benchmark::kMillisecond)->UseRealTime();
+
+}  // namespace my::benchmark
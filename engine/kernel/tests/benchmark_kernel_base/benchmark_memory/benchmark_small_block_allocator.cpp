@@ -0,0 +1,131 @@
+// #my_engine_source_file
+#include "my/memory/small_block_allocator.h"
+
+namespace my::benchmark
+{
+    namespace
+    {
+        struct CrtMalloc
+        {
+            void* alloc(size_t size)
+            {
+                return ::malloc(size);
+            }
+
+            void free(void* ptr)
+            {
+                ::free(ptr);
+            }
+        };
+
+        struct SmallBlock
+        {
+            void* alloc(size_t size)
+            {
+                return getAllocator().alloc(size);
+            }
+
+            void free(void* ptr)
+            {
+                getAllocator().free(ptr);
+            }
+
+            static IAllocator& getAllocator()
+            {
+                static const AllocatorPtr allocator = createSmallBlockAllocator();
+                return *allocator;
+            }
+        };
+
+        /**
+            Shared exchange of the blocks between benchmark threads: used to produce cross thread frees.
+         */
+        class BlockExchange
+        {
+        public:
+            static constexpr size_t SlotCount = 4096;
+
+            void* exchange(size_t slot, void* ptr)
+            {
+                return m_slots[slot % SlotCount].exchange(ptr, std::memory_order_acq_rel);
+            }
+
+            template <typename Allocator>
+            void clear(Allocator& allocator)
+            {
+                for (auto& slot : m_slots)
+                {
+                    allocator.free(slot.exchange(nullptr));
+                }
+            }
+
+        private:
+            std::array<std::atomic<void*>, SlotCount> m_slots{};
+        };
+
+        template <typename Allocator>
+        BlockExchange& getBlockExchange()
+        {
+            static BlockExchange blockExchange;
+            return blockExchange;
+        }
+    }  // namespace
+
+    /**
+        Each thread keeps a working set of live blocks and continuously replaces random ones.
+        range(0): max block size, range(1): percent of blocks released by a non-owner thread.
+     */
+    template <typename Allocator>
+    static void BM_AllocatorChurn(::benchmark::State& state)
+    {
+        constexpr size_t WorkingSetSize = 1024;
+
+        const size_t maxBlockSize = static_cast<size_t>(state.range(0));
+        const unsigned remoteFreePercent = static_cast<unsigned>(state.range(1));
+
+        Allocator allocator;
+        BlockExchange& blockExchange = getBlockExchange<Allocator>();
+        std::mt19937 random(static_cast<unsigned>(state.thread_index()));
+        std::uniform_int_distribution<size_t> sizeDistribution(8, maxBlockSize);
+
+        std::vector<void*> workingSet(WorkingSetSize, nullptr);
+
+        for (auto _ : state)
+        {
+            const size_t index = random() % WorkingSetSize;
+            void* ptr = allocator.alloc(sizeDistribution(random));
+            ::benchmark::DoNotOptimize(ptr);
+
+            if (random() % 100 < remoteFreePercent)
+            {
+                ptr = blockExchange.exchange(random(), ptr);
+            }
+
+            allocator.free(std::exchange(workingSet[index], ptr));
+        }
+
+        for (void* ptr : workingSet)
+        {
+            allocator.free(ptr);
+        }
+
+        // All threads are finished the iterations at this point.
+        if (state.thread_index() == 0)
+        {
+            blockExchange.clear(allocator);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    static void applyChurnArguments(::benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->ArgNames({"max_size", "remote_free_pct"});
+        benchmark->Args({256, 0})->Args({256, 25})->Args({4096, 0})->Args({4096, 25})->Args({32768, 10});
+        benchmark->ThreadRange(1, 16)->UseRealTime();
+    }
+
+    BENCHMARK_TEMPLATE(BM_AllocatorChurn, CrtMalloc)->Apply(applyChurnArguments);
+    BENCHMARK_TEMPLATE(BM_AllocatorChurn, SmallBlock)->Apply(applyChurnArguments);
+
+}  // namespace my::benchmark
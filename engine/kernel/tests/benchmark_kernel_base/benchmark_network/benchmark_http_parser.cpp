@@ -0,0 +1,117 @@
+// #my_engine_source_file
+#include "my/network/http_parser.h"
+
+using namespace std::literals;
+
+namespace my::benchmark
+{
+    namespace
+    {
+        constexpr std::array LookupKeys = {"Host"sv, "Content-Type"sv, "Content-Length"sv, "Connection"sv, "X-Missing"sv};
+
+        /**
+            Typical request head: well known headers at the end, range of the custom headers before.
+         */
+        std::string makeHead(size_t customHeadersCount)
+        {
+            std::string head = "POST /api/v1/resource?id=42 HTTP/1.1\r\nUser-Agent: benchmark/1.0\r\nAccept: */*\r\n";
+            for (size_t i = 0; i < customHeadersCount; ++i)
+            {
+                head.append(std::format("X-Custom-Header-{}: value-{}-{}\r\n", i, i, std::string(24, 'v')));
+            }
+
+            head.append("Host: localhost:8080\r\nContent-Type: application/json\r\nContent-Length: 1024\r\nConnection: keep-alive\r\n\r\n");
+            return head;
+        }
+    }  // namespace
+
+    /**
+        Lookups with the buffer based helpers: each lookup scans the head from the start.
+     */
+    static void BM_HttpHeaderLookupRescan(::benchmark::State& state)
+    {
+        const std::string head = makeHead(static_cast<size_t>(state.range(0)));
+        const std::string_view headersBuffer = HttpParser::getHeadersBuffer(head);
+
+        for (auto _ : state)
+        {
+            ::benchmark::DoNotOptimize(HttpParser::headersCount(headersBuffer));
+            for (const std::string_view key : LookupKeys)
+            {
+                ::benchmark::DoNotOptimize(HttpParser::findHeader(headersBuffer, key));
+            }
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * head.size()));
+    }
+
+    /**
+        Single pass indexing, lookups do not touch the buffer.
+     */
+    static void BM_HttpHeaderLookupIndexed(::benchmark::State& state)
+    {
+        const std::string head = makeHead(static_cast<size_t>(state.range(0)));
+
+        for (auto _ : state)
+        {
+            const HttpParser parser{head};
+            ::benchmark::DoNotOptimize(parser.headersCount());
+            for (const std::string_view key : LookupKeys)
+            {
+                ::benchmark::DoNotOptimize(parser[key]);
+            }
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * head.size()));
+    }
+
+    /**
+        Head is received by the parts of range(1) bytes, the parser is recreated after each part.
+     */
+    static void BM_HttpHeadPartialReadsRestart(::benchmark::State& state)
+    {
+        const std::string head = makeHead(static_cast<size_t>(state.range(0)));
+        const size_t readSize = static_cast<size_t>(state.range(1));
+
+        for (auto _ : state)
+        {
+            HttpParser parser;
+            for (size_t received = readSize; !parser; received += readSize)
+            {
+                parser = HttpParser{std::string_view{head}.substr(0, received)};
+            }
+
+            ::benchmark::DoNotOptimize(parser.headersLength());
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * head.size()));
+    }
+
+    /**
+        Head is received by the parts of range(1) bytes, parsing is resumed after each part.
+     */
+    static void BM_HttpHeadPartialReadsIncremental(::benchmark::State& state)
+    {
+        const std::string head = makeHead(static_cast<size_t>(state.range(0)));
+        const size_t readSize = static_cast<size_t>(state.range(1));
+
+        for (auto _ : state)
+        {
+            HttpParser parser;
+            for (size_t received = readSize; !parser; received += readSize)
+            {
+                parser.parse(std::string_view{head}.substr(0, received));
+            }
+
+            ::benchmark::DoNotOptimize(parser.headersLength());
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * head.size()));
+    }
+
+    BENCHMARK(BM_HttpHeaderLookupRescan)->ArgName("custom_headers")->Arg(0)->Arg(8)->Arg(32);
+    BENCHMARK(BM_HttpHeaderLookupIndexed)->ArgName("custom_headers")->Arg(0)->Arg(8)->Arg(32);
+    BENCHMARK(BM_HttpHeadPartialReadsRestart)->ArgNames({"custom_headers", "read_size"})->ArgsProduct({{8, 32}, {64, 512}});
+    BENCHMARK(BM_HttpHeadPartialReadsIncremental)->ArgNames({"custom_headers", "read_size"})->ArgsProduct({{8, 32}, {64, 512}});
+
+}  // namespace my::benchmark
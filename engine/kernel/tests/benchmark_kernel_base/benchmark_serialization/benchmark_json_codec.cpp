@@ -0,0 +1,103 @@
+// #my_engine_source_file
+#include "my/io/asset_pack.h"
+#include "my/serialization/json_codec.h"
+#include "my/serialization/json_utils.h"
+
+namespace my::benchmark
+{
+    namespace
+    {
+        /**
+            Asset pack index with range(0) file entries.
+         */
+        io::AssetPackIndexData makeIndexData(size_t entriesCount)
+        {
+            io::AssetPackIndexData indexData{
+                .version = "1.0",
+                .description = "benchmark asset pack"};
+
+            size_t offset = sizeof(io::AssetPackHeader);
+            for (size_t i = 0; i < entriesCount; ++i)
+            {
+                const size_t size = 1024 + i * 16;
+                indexData.content.push_back(io::AssetPackFileEntry{
+                    .filePath = std::format("content/textures/group_{}/texture_{}.dds", i % 16, i),
+                    .contentCompression = i % 2 == 0 ? "zstd" : "",
+                    .clientSize = size * 2,
+                    .blobData = {.size = size, .offset = offset}});
+
+                offset += size;
+            }
+
+            return indexData;
+        }
+    }  // namespace
+
+    /**
+        Parsing through the json DOM and the runtime value wrappers.
+     */
+    static void BM_JsonParseRuntimeValue(::benchmark::State& state)
+    {
+        const std::string json = serialization::JsonCodec::stringify(makeIndexData(static_cast<size_t>(state.range(0))));
+
+        for (auto _ : state)
+        {
+            Result<io::AssetPackIndexData> indexData = serialization::JsonUtils::parse<io::AssetPackIndexData>(json);
+            ::benchmark::DoNotOptimize(indexData);
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * json.size()));
+    }
+
+    /**
+        Parsing directly into the reflected type.
+     */
+    static void BM_JsonParseCodec(::benchmark::State& state)
+    {
+        const std::string json = serialization::JsonCodec::stringify(makeIndexData(static_cast<size_t>(state.range(0))));
+
+        for (auto _ : state)
+        {
+            Result<io::AssetPackIndexData> indexData = serialization::JsonCodec::parse<io::AssetPackIndexData>(json);
+            ::benchmark::DoNotOptimize(indexData);
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * json.size()));
+    }
+
+    static void BM_JsonStringifyRuntimeValue(::benchmark::State& state)
+    {
+        const io::AssetPackIndexData indexData = makeIndexData(static_cast<size_t>(state.range(0)));
+        size_t bytesProcessed = 0;
+
+        for (auto _ : state)
+        {
+            const std::string json = serialization::JsonUtils::stringify(indexData);
+            bytesProcessed += json.size();
+            ::benchmark::DoNotOptimize(json.data());
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(bytesProcessed));
+    }
+
+    static void BM_JsonStringifyCodec(::benchmark::State& state)
+    {
+        const io::AssetPackIndexData indexData = makeIndexData(static_cast<size_t>(state.range(0)));
+        size_t bytesProcessed = 0;
+
+        for (auto _ : state)
+        {
+            const std::string json = serialization::JsonCodec::stringify(indexData);
+            bytesProcessed += json.size();
+            ::benchmark::DoNotOptimize(json.data());
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(bytesProcessed));
+    }
+
+    BENCHMARK(BM_JsonParseRuntimeValue)->ArgName("entries")->Arg(16)->Arg(1024);
+    BENCHMARK(BM_JsonParseCodec)->ArgName("entries")->Arg(16)->Arg(1024);
+    BENCHMARK(BM_JsonStringifyRuntimeValue)->ArgName("entries")->Arg(16)->Arg(1024);
+    BENCHMARK(BM_JsonStringifyCodec)->ArgName("entries")->Arg(16)->Arg(1024);
+
+}  // namespace my::benchmark
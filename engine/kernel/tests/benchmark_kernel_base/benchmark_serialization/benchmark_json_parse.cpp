@@ -0,0 +1,62 @@
+// #my_engine_source_file
+#include "my/io/asset_pack.h"
+#include "my/serialization/json.h"
+#include "my/serialization/json_codec.h"
+
+namespace my::benchmark
+{
+    namespace
+    {
+        /**
+            Asset pack index json with entriesCount file entries.
+         */
+        std::string makeIndexJson(size_t entriesCount)
+        {
+            io::AssetPackIndexData indexData{
+                .version = "1.0",
+                .description = "benchmark \"asset\" pack"};
+
+            size_t offset = sizeof(io::AssetPackHeader);
+            for (size_t i = 0; i < entriesCount; ++i)
+            {
+                const size_t size = 1024 + i * 16;
+                indexData.content.push_back(io::AssetPackFileEntry{
+                    .filePath = std::format("content\\textures\\group_{}\\texture_{}.dds", i % 16, i),
+                    .contentCompression = i % 2 == 0 ? "zstd" : "",
+                    .clientSize = size * 2,
+                    .blobData = {.size = size, .offset = offset}});
+
+                offset += size;
+            }
+
+            return serialization::JsonCodec::stringify(indexData, {.pretty = true});
+        }
+
+        void parseJson(::benchmark::State& state, serialization::JsonParser parser)
+        {
+            const std::string json = makeIndexJson(static_cast<size_t>(state.range(0)));
+
+            for (auto _ : state)
+            {
+                Result<RuntimeValuePtr> value = serialization::jsonParseString(json, parser);
+                ::benchmark::DoNotOptimize(value);
+            }
+
+            state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * json.size()));
+        }
+    }  // namespace
+
+    static void BM_JsonParseJsonCpp(::benchmark::State& state)
+    {
+        parseJson(state, serialization::JsonParser::JsonCpp);
+    }
+
+    static void BM_JsonParseTape(::benchmark::State& state)
+    {
+        parseJson(state, serialization::JsonParser::Tape);
+    }
+
+    BENCHMARK(BM_JsonParseJsonCpp)->ArgName("entries")->Arg(16)->Arg(1024)->Arg(16384);
+    BENCHMARK(BM_JsonParseTape)->ArgName("entries")->Arg(16)->Arg(1024)->Arg(16384);
+
+}  // namespace my::benchmark
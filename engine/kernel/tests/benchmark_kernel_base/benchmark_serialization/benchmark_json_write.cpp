@@ -0,0 +1,75 @@
+// #my_engine_source_file
+#include "my/io/asset_pack.h"
+#include "my/io/memory_stream.h"
+#include "my/serialization/json.h"
+#include "my/serialization/runtime_value_builder.h"
+
+namespace my::benchmark
+{
+    namespace
+    {
+        io::AssetPackIndexData makeIndexData(size_t entriesCount)
+        {
+            io::AssetPackIndexData indexData{
+                .version = "1.0",
+                .description = "benchmark asset pack"};
+
+            size_t offset = sizeof(io::AssetPackHeader);
+            for (size_t i = 0; i < entriesCount; ++i)
+            {
+                const size_t size = 1024 + i * 16;
+                indexData.content.push_back(io::AssetPackFileEntry{
+                    .filePath = std::format("content/textures/group_{}/texture_{}.dds", i % 16, i),
+                    .contentCompression = i % 2 == 0 ? "zstd" : "",
+                    .clientSize = size * 2,
+                    .blobData = {.size = size, .offset = offset}});
+
+                offset += size;
+            }
+
+            return indexData;
+        }
+    }  // namespace
+
+    /**
+        Runtime value -> Json::Value tree -> jsoncpp stream writer.
+     */
+    static void BM_JsonWriteThroughJsonValue(::benchmark::State& state)
+    {
+        const io::AssetPackIndexData indexData = makeIndexData(static_cast<size_t>(state.range(0)));
+        const RuntimeValuePtr value = makeValueRef(indexData);
+        size_t bytesProcessed = 0;
+
+        for (auto _ : state)
+        {
+            io::MemoryStreamPtr stream = io::createMemoryStream();
+            serialization::jsonWrite(*stream, serialization::runtimeToJsonValue(value)).ignore();
+            bytesProcessed += stream->getPosition();
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(bytesProcessed));
+    }
+
+    /**
+        Runtime value -> stream by the blocks, no intermediate tree.
+     */
+    static void BM_JsonWriteStreaming(::benchmark::State& state)
+    {
+        const io::AssetPackIndexData indexData = makeIndexData(static_cast<size_t>(state.range(0)));
+        const RuntimeValuePtr value = makeValueRef(indexData);
+        size_t bytesProcessed = 0;
+
+        for (auto _ : state)
+        {
+            io::MemoryStreamPtr stream = io::createMemoryStream();
+            serialization::jsonWrite(*stream, value).ignore();
+            bytesProcessed += stream->getPosition();
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(bytesProcessed));
+    }
+
+    BENCHMARK(BM_JsonWriteThroughJsonValue)->ArgName("entries")->Arg(16)->Arg(1024);
+    BENCHMARK(BM_JsonWriteStreaming)->ArgName("entries")->Arg(16)->Arg(1024);
+
+}  // namespace my::benchmark
@@ -0,0 +1,150 @@
+// #my_engine_source_file
+#include "my/io/asset_pack.h"
+#include "my/io/memory_stream.h"
+#include "my/serialization/json.h"
+#include "my/serialization/json_codec.h"
+#include "my/serialization/msgpack.h"
+#include "my/serialization/runtime_value_builder.h"
+
+namespace my::benchmark
+{
+    namespace
+    {
+        io::AssetPackIndexData makeIndexData(size_t entriesCount)
+        {
+            io::AssetPackIndexData indexData{
+                .version = "1.0",
+                .description = "benchmark asset pack"};
+
+            size_t offset = sizeof(io::AssetPackHeader);
+            for (size_t i = 0; i < entriesCount; ++i)
+            {
+                const size_t size = 1024 + i * 16;
+                indexData.content.push_back(io::AssetPackFileEntry{
+                    .filePath = std::format("content/textures/group_{}/texture_{}.dds", i % 16, i),
+                    .contentCompression = i % 2 == 0 ? "zstd" : "",
+                    .clientSize = size * 2,
+                    .blobData = {.size = size, .offset = offset}});
+
+                offset += size;
+            }
+
+            return indexData;
+        }
+
+        Buffer writeMsgPack(const io::AssetPackIndexData& indexData)
+        {
+            io::MemoryStreamPtr stream = io::createMemoryStream();
+            serialization::MsgPackCodec::write(*stream, indexData).ignore();
+
+            return stream->as<io::WrittableMemoryStream&>().releaseBuffer();
+        }
+
+        std::string writeJson(const io::AssetPackIndexData& indexData)
+        {
+            return serialization::JsonCodec::stringify(indexData);
+        }
+    }  // namespace
+
+    static void BM_MsgPackWriteCodec(::benchmark::State& state)
+    {
+        const io::AssetPackIndexData indexData = makeIndexData(static_cast<size_t>(state.range(0)));
+        size_t bytesProcessed = 0;
+
+        for (auto _ : state)
+        {
+            io::MemoryStreamPtr stream = io::createMemoryStream();
+            serialization::MsgPackCodec::write(*stream, indexData).ignore();
+            bytesProcessed += stream->getPosition();
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(bytesProcessed));
+        state.counters["size"] = static_cast<double>(writeMsgPack(indexData).size());
+    }
+
+    static void BM_JsonWriteCodec(::benchmark::State& state)
+    {
+        const io::AssetPackIndexData indexData = makeIndexData(static_cast<size_t>(state.range(0)));
+        size_t bytesProcessed = 0;
+
+        for (auto _ : state)
+        {
+            io::MemoryStreamPtr stream = io::createMemoryStream();
+            serialization::JsonCodec::stringify(*stream, indexData).ignore();
+            bytesProcessed += stream->getPosition();
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(bytesProcessed));
+        state.counters["size"] = static_cast<double>(writeJson(indexData).size());
+    }
+
+    static void BM_MsgPackParseCodec(::benchmark::State& state)
+    {
+        const Buffer buffer = writeMsgPack(makeIndexData(static_cast<size_t>(state.range(0))));
+        const std::span<const std::byte> data{buffer.data(), buffer.size()};
+
+        for (auto _ : state)
+        {
+            auto indexData = serialization::MsgPackCodec::parse<io::AssetPackIndexData>(data);
+            ::benchmark::DoNotOptimize(indexData);
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+    }
+
+    static void BM_JsonParseCodec(::benchmark::State& state)
+    {
+        const std::string text = writeJson(makeIndexData(static_cast<size_t>(state.range(0))));
+
+        for (auto _ : state)
+        {
+            auto indexData = serialization::JsonCodec::parse<io::AssetPackIndexData>(text);
+            ::benchmark::DoNotOptimize(indexData);
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+    }
+
+    /**
+        Parse into the runtime values and assign to the native object.
+     */
+    static void BM_MsgPackParseRuntimeValue(::benchmark::State& state)
+    {
+        Buffer buffer = writeMsgPack(makeIndexData(static_cast<size_t>(state.range(0))));
+        const size_t size = buffer.size();
+        const ReadOnlyBuffer readOnlyBuffer = buffer.toReadOnly();
+
+        for (auto _ : state)
+        {
+            io::AssetPackIndexData indexData;
+            Result<RuntimeValuePtr> value = serialization::msgpackParse(readOnlyBuffer);
+            RuntimeValue::assign(makeValueRef(indexData), *value).ignore();
+            ::benchmark::DoNotOptimize(indexData);
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    }
+
+    static void BM_JsonParseRuntimeValue(::benchmark::State& state)
+    {
+        const std::string text = writeJson(makeIndexData(static_cast<size_t>(state.range(0))));
+
+        for (auto _ : state)
+        {
+            io::AssetPackIndexData indexData;
+            Result<RuntimeValuePtr> value = serialization::jsonParseString(text, serialization::JsonParser::Tape);
+            RuntimeValue::assign(makeValueRef(indexData), *value).ignore();
+            ::benchmark::DoNotOptimize(indexData);
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+    }
+
+    BENCHMARK(BM_MsgPackWriteCodec)->ArgName("entries")->Arg(16)->Arg(1024);
+    BENCHMARK(BM_JsonWriteCodec)->ArgName("entries")->Arg(16)->Arg(1024);
+    BENCHMARK(BM_MsgPackParseCodec)->ArgName("entries")->Arg(16)->Arg(1024);
+    BENCHMARK(BM_JsonParseCodec)->ArgName("entries")->Arg(16)->Arg(1024);
+    BENCHMARK(BM_MsgPackParseRuntimeValue)->ArgName("entries")->Arg(16)->Arg(1024);
+    BENCHMARK(BM_JsonParseRuntimeValue)->ArgName("entries")->Arg(16)->Arg(1024);
+
+}  // namespace my::benchmark
@@ -0,0 +1,43 @@
+// #my_engine_source_file
+#pragma once
+#include "my/memory/buffer.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace my::test {
+
+/**
+    Builds zip archive in memory (for the tests and benchmarks only).
+    Deflated entries are encoded with the fixed huffman codes: literals and short runs of the repeated bytes.
+ */
+class ZipArchiveBuilder
+{
+public:
+    enum class Method
+    {
+        Stored,
+        Deflated
+    };
+
+    ZipArchiveBuilder& addFile(std::string path, std::string_view content, Method method = Method::Stored);
+
+    ZipArchiveBuilder& addDirectory(std::string path);
+
+    Buffer build() const;
+
+private:
+    struct Entry
+    {
+        std::string path;
+        std::vector<std::byte> data;
+        size_t size;
+        uint32_t crc32;
+        uint16_t method;
+    };
+
+    std::vector<Entry> m_entries;
+};
+
+}  // namespace my::test
@@ -0,0 +1,236 @@
+// #my_engine_source_file
+
+#include "my/test/helpers/zip_archive_builder.h"
+
+#include <array>
+#include <cstring>
+
+namespace my::test {
+namespace {
+
+uint32_t computeCrc32(std::string_view data)
+{
+    static const std::array<uint32_t, 256> table = []
+    {
+        std::array<uint32_t, 256> values{};
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+            }
+            values[i] = value;
+        }
+        return values;
+    }();
+
+    uint32_t crc = ~0u;
+    for (const char c : data)
+    {
+        crc = table[(crc ^ static_cast<uint8_t>(c)) & 0xFF] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+class BitWriter
+{
+public:
+    void write(uint32_t value, unsigned count)
+    {
+        for (unsigned i = 0; i < count; ++i)
+        {
+            if (m_bitPos == 0)
+            {
+                m_data.push_back(std::byte{0});
+            }
+
+            m_data.back() |= static_cast<std::byte>(((value >> i) & 1) << m_bitPos);
+            m_bitPos = (m_bitPos + 1) % 8;
+        }
+    }
+
+    // huffman codes are packed starting from the most significant bit
+    void writeCode(uint32_t code, unsigned length)
+    {
+        for (unsigned i = length; i-- > 0;)
+        {
+            write((code >> i) & 1, 1);
+        }
+    }
+
+    std::vector<std::byte> takeData()
+    {
+        return std::move(m_data);
+    }
+
+private:
+    std::vector<std::byte> m_data;
+    unsigned m_bitPos = 0;
+};
+
+std::vector<std::byte> deflateFixed(std::string_view content)
+{
+    constexpr size_t MinRun = 3;
+    constexpr size_t MaxRun = 10;  // lengths 3..10 are encoded without extra bits
+
+    BitWriter writer;
+    writer.write(1, 1);  // final block
+    writer.write(1, 2);  // fixed huffman codes
+
+    const auto writeLiteral = [&writer](uint8_t literal)
+    {
+        if (literal < 144)
+        {
+            writer.writeCode(0x30 + literal, 8);
+        }
+        else
+        {
+            writer.writeCode(0x190 + (literal - 144), 9);
+        }
+    };
+
+    for (size_t i = 0; i < content.size();)
+    {
+        size_t run = 0;
+        while (i > 0 && run < MaxRun && i + run < content.size() && content[i + run] == content[i - 1])
+        {
+            ++run;
+        }
+
+        if (run >= MinRun)
+        {
+            writer.writeCode(static_cast<uint32_t>(run - MinRun + 1), 7);  // length symbols 257..264
+            writer.writeCode(0, 5);                                         // distance 1
+            i += run;
+        }
+        else
+        {
+            writeLiteral(static_cast<uint8_t>(content[i++]));
+        }
+    }
+
+    writer.writeCode(0, 7);  // end of block
+    return writer.takeData();
+}
+
+void append(Buffer& buffer, const void* data, size_t size)
+{
+    memcpy(buffer.append(size), data, size);
+}
+
+template <typename T>
+void appendValue(Buffer& buffer, T value)
+{
+    append(buffer, &value, sizeof(T));
+}
+
+}  // namespace
+
+ZipArchiveBuilder& ZipArchiveBuilder::addFile(std::string path, std::string_view content, Method method)
+{
+    Entry& entry = m_entries.emplace_back();
+    entry.path = std::move(path);
+    entry.size = content.size();
+    entry.crc32 = computeCrc32(content);
+
+    if (method == Method::Deflated)
+    {
+        entry.method = 8;
+        entry.data = deflateFixed(content);
+    }
+    else
+    {
+        entry.method = 0;
+        entry.data.resize(content.size());
+        memcpy(entry.data.data(), content.data(), content.size());
+    }
+
+    return *this;
+}
+
+ZipArchiveBuilder& ZipArchiveBuilder::addDirectory(std::string path)
+{
+    if (!path.ends_with('/'))
+    {
+        path.push_back('/');
+    }
+
+    Entry& entry = m_entries.emplace_back();
+    entry.path = std::move(path);
+    entry.size = 0;
+    entry.crc32 = 0;
+    entry.method = 0;
+
+    return *this;
+}
+
+Buffer ZipArchiveBuilder::build() const
+{
+    constexpr uint16_t DosTime = (12 << 11) | (30 << 5);        // 12:30:00
+    constexpr uint16_t DosDate = ((2024 - 1980) << 9) | (5 << 5) | 17;  // 2024-05-17
+
+    Buffer archive;
+    std::vector<uint32_t> localHeaderOffsets;
+
+    for (const Entry& entry : m_entries)
+    {
+        localHeaderOffsets.push_back(static_cast<uint32_t>(archive.size()));
+
+        appendValue<uint32_t>(archive, 0x04034B50);
+        appendValue<uint16_t>(archive, 20);  // version needed
+        appendValue<uint16_t>(archive, 0);   // flags
+        appendValue<uint16_t>(archive, entry.method);
+        appendValue<uint16_t>(archive, DosTime);
+        appendValue<uint16_t>(archive, DosDate);
+        appendValue<uint32_t>(archive, entry.crc32);
+        appendValue<uint32_t>(archive, static_cast<uint32_t>(entry.data.size()));
+        appendValue<uint32_t>(archive, static_cast<uint32_t>(entry.size));
+        appendValue<uint16_t>(archive, static_cast<uint16_t>(entry.path.size()));
+        appendValue<uint16_t>(archive, 0);  // extra field size
+        append(archive, entry.path.data(), entry.path.size());
+        append(archive, entry.data.data(), entry.data.size());
+    }
+
+    const uint32_t centralDirOffset = static_cast<uint32_t>(archive.size());
+    for (size_t i = 0; i < m_entries.size(); ++i)
+    {
+        const Entry& entry = m_entries[i];
+
+        appendValue<uint32_t>(archive, 0x02014B50);
+        appendValue<uint16_t>(archive, 20);  // version made by
+        appendValue<uint16_t>(archive, 20);  // version needed
+        appendValue<uint16_t>(archive, 0);   // flags
+        appendValue<uint16_t>(archive, entry.method);
+        appendValue<uint16_t>(archive, DosTime);
+        appendValue<uint16_t>(archive, DosDate);
+        appendValue<uint32_t>(archive, entry.crc32);
+        appendValue<uint32_t>(archive, static_cast<uint32_t>(entry.data.size()));
+        appendValue<uint32_t>(archive, static_cast<uint32_t>(entry.size));
+        appendValue<uint16_t>(archive, static_cast<uint16_t>(entry.path.size()));
+        appendValue<uint16_t>(archive, 0);  // extra field size
+        appendValue<uint16_t>(archive, 0);  // comment size
+        appendValue<uint16_t>(archive, 0);  // disk number
+        appendValue<uint16_t>(archive, 0);  // internal attributes
+        appendValue<uint32_t>(archive, 0);  // external attributes
+        appendValue<uint32_t>(archive, localHeaderOffsets[i]);
+        append(archive, entry.path.data(), entry.path.size());
+    }
+
+    const uint32_t centralDirSize = static_cast<uint32_t>(archive.size()) - centralDirOffset;
+    const uint16_t entriesCount = static_cast<uint16_t>(std::min<size_t>(m_entries.size(), 0xFFFF));
+
+    appendValue<uint32_t>(archive, 0x06054B50);
+    appendValue<uint16_t>(archive, 0);  // disk number
+    appendValue<uint16_t>(archive, 0);  // disk with central directory
+    appendValue<uint16_t>(archive, entriesCount);
+    appendValue<uint16_t>(archive, entriesCount);
+    appendValue<uint32_t>(archive, centralDirSize);
+    appendValue<uint32_t>(archive, centralDirOffset);
+    appendValue<uint16_t>(archive, 0);  // comment size
+
+    return archive;
+}
+
+}  // namespace my::test
@@ -358,4 +358,237 @@ TEST_F(TestPropertyContainer, CustomVarResolver)
     const auto str3 = *m_props->getValue<std::string>("prop3");
     EXPECT_EQ(str3, "AAA,$test1{value2},$test2{value1},BBB");
 }
+
+/**
+    Test: malformed variables are kept as is, the well formed one after them is expanded
+ */
+TEST_F(TestPropertyContainer, ExpandPropertyMalformed)
+{
+    m_props->setValue("/name_1", std::string{"N"}).ignore();
+    m_props->setValue("/prop1", std::string{"$ ${ $x{a b} $x{a ${/name_1}} ${/name_1"}).ignore();
+
+    const auto str = *m_props->getValue<std::string>("/prop1");
+    ASSERT_EQ(str, "$ ${ $x{a b} $x{a N} ${/name_1");
+}
+
+/**
+    Test: expanded strings are reevaluated when the referenced property or the resolvers are changed
+ */
+TEST_F(TestPropertyContainer, ExpandPropertyAfterChange)
+{
+    m_props->setValue("/name_1", std::string{"Name1Value"}).ignore();
+    m_props->setValue("/prop1", std::string{"Name:${/name_1},$test{value}"}).ignore();
+    ASSERT_EQ(*m_props->getValue<std::string>("/prop1"), "Name:Name1Value,$test{value}");
+
+    m_props->setValue("/name_1", std::string{"Name1Changed"}).ignore();
+    ASSERT_EQ(*m_props->getValue<std::string>("/prop1"), "Name:Name1Changed,$test{value}");
+
+    m_props->addVariableResolver("test", [](std::string_view) -> std::optional<std::string>
+    {
+        return std::string{"AAA"};
+    });
+    ASSERT_EQ(*m_props->getValue<std::string>("/prop1"), "Name:Name1Changed,AAA");
+
+    {
+        PropertyContainer::ModificationLock lock;
+        Result<RuntimeValuePtr> root = m_props->getModify("/", lock);
+        ASSERT_TRUE(root);
+        ASSERT_TRUE((*root)->as<Dictionary&>().setValue("name_1", makeValueCopy(std::string{"Name1Modified"})));
+    }
+    ASSERT_EQ(*m_props->getValue<std::string>("/prop1"), "Name:Name1Modified,AAA");
+}
+
+/**
+    Test: resolver results are not cached, also when the resolver is used by the referenced property
+ */
+TEST_F(TestPropertyContainer, ExpandPropertyWithNonPureResolver)
+{
+    auto counter = std::make_shared<int>(0);
+    m_props->addVariableResolver("counter", [counter](std::string_view) -> std::optional<std::string>
+    {
+        return std::to_string(++(*counter));
+    });
+
+    m_props->setValue("/prop1", std::string{"$counter{value}"}).ignore();
+    m_props->setValue("/prop2", std::string{"Ref:${/prop1}"}).ignore();
+
+    const std::string value1 = *m_props->getValue<std::string>("/prop1");
+    ASSERT_NE(*m_props->getValue<std::string>("/prop1"), value1);
+
+    const std::string value2 = *m_props->getValue<std::string>("/prop2");
+    ASSERT_TRUE(value2.starts_with("Ref:"));
+    ASSERT_NE(*m_props->getValue<std::string>("/prop2"), value2);
+}
+
+/**
+    Test: snapshot is not affected by the subsequent changes, unchanged sections are the same in both snapshots
+ */
+TEST_F(TestPropertyContainer, SnapshotIsImmutable)
+{
+    ASSERT_TRUE(mergeFromJson(*m_props, getPropsJson()));
+
+    const PropertySnapshotPtr snapshot = m_props->getSnapshot();
+    ASSERT_EQ(snapshot->getVersion(), m_props->getVersion());
+    ASSERT_EQ(snapshot->getValue<int>("prop_int1"), 1);
+    ASSERT_EQ(snapshot->getValue<std::string>("section_0/section_02/section_021/prop_text"), "section_021");
+
+    m_props->setValue("prop_int1", 10).ignore();
+    m_props->setValue("section_0/prop_new", std::string{"new"}).ignore();
+
+    const PropertySnapshotPtr newSnapshot = m_props->getSnapshot();
+    ASSERT_NE(newSnapshot->getVersion(), snapshot->getVersion());
+    ASSERT_EQ(newSnapshot->getValue<int>("prop_int1"), 10);
+    ASSERT_EQ(newSnapshot->getValue<std::string>("section_0/prop_new"), "new");
+    ASSERT_EQ(newSnapshot->getValue<int>("section_0/prop0"), 100);
+
+    ASSERT_EQ(snapshot->getValue<int>("prop_int1"), 1);
+    ASSERT_FALSE(snapshot->contains("section_0/prop_new"));
+
+    const auto data = newSnapshot->getValue<PropSectionData>("section_0/section_02");
+    ASSERT_TRUE(data);
+    ASSERT_TRUE(data->propBoolTrue);
+    ASSERT_EQ(data->subSection.propFloat, 77.f);
+
+    const RuntimeValuePtr section = newSnapshot->getRead("section_0");
+    ASSERT_TRUE(section);
+    ASSERT_FALSE(section->isMutable());
+    ASSERT_FALSE(section->as<ReadonlyDictionary&>().setValue("prop0", makeValueCopy(1)));
+}
+
+/**
+    Test: snapshot contains expanded strings, that are updated when the referenced property is changed
+ */
+TEST_F(TestPropertyContainer, SnapshotExpandedStrings)
+{
+    m_props->setValue("/name_1", std::string{"Name1Value"}).ignore();
+    m_props->setValue("/section/prop1", std::string{"Name:${/name_1}"}).ignore();
+    ASSERT_EQ(m_props->getSnapshot()->getValue<std::string>("/section/prop1"), "Name:Name1Value");
+
+    m_props->setValue("/name_1", std::string{"Name1Changed"}).ignore();
+    ASSERT_EQ(m_props->getSnapshot()->getValue<std::string>("/section/prop1"), "Name:Name1Changed");
+}
+
+/**
+    Test: the snapshot is updated partially, but the strings with variables (also within collections) are expanded again on each change
+ */
+TEST_F(TestPropertyContainer, SnapshotExpandedStringsPartialUpdate)
+{
+    m_props->setValue("/name_1", std::string{"A"}).ignore();
+    m_props->setValue("/section/list", std::vector<std::string>{"${/name_1}", "text"}).ignore();
+    m_props->setValue("/section/sub/prop", std::string{"${/name_1}-sub"}).ignore();
+    m_props->setValue("/other", 1).ignore();
+
+    PropertySnapshotPtr snapshot = m_props->getSnapshot();
+    ASSERT_THAT(*snapshot->getValue<std::vector<std::string>>("/section/list"), testing::ElementsAre("A", "text"));
+    ASSERT_EQ(snapshot->getValue<std::string>("/section/sub/prop"), "A-sub");
+
+    m_props->setValue("/name_1", std::string{"B"}).ignore();
+    snapshot = m_props->getSnapshot();
+    ASSERT_THAT(*snapshot->getValue<std::vector<std::string>>("/section/list"), testing::ElementsAre("B", "text"));
+    ASSERT_EQ(snapshot->getValue<std::string>("/section/sub/prop"), "B-sub");
+    ASSERT_EQ(snapshot->getValue<int>("/other"), 1);
+
+    m_props->setValue("/section/sub/prop", std::string{"plain"}).ignore();
+    m_props->setValue("/name_1", std::string{"C"}).ignore();
+    snapshot = m_props->getSnapshot();
+    ASSERT_THAT(*snapshot->getValue<std::vector<std::string>>("/section/list"), testing::ElementsAre("C", "text"));
+    ASSERT_EQ(snapshot->getValue<std::string>("/section/sub/prop"), "plain");
+}
+
+/**
+    Test: changes made through getModify() are published after the modification lock is released
+ */
+TEST_F(TestPropertyContainer, SnapshotAfterGetModify)
+{
+    const std::string_view propName = "/section_0/ids";
+    m_props->setValue(propName, std::vector<unsigned>{100, 200}).ignore();
+
+    {
+        PropertyContainer::ModificationLock lock;
+        Result<Ptr<Collection>> collection = *m_props->getModify(propName, lock);
+        ASSERT_TRUE(collection);
+        ASSERT_TRUE((*collection)->append(makeValueCopy(300u)));
+
+        // can not be rebuilt while modification lock is held: previous snapshot is returned
+        const PropertySnapshotPtr snapshot = m_props->getSnapshot();
+        ASSERT_NE(snapshot->getVersion(), m_props->getVersion());
+        ASSERT_EQ(snapshot->getValue<std::vector<unsigned>>(propName)->size(), 2);
+    }
+
+    const PropertySnapshotPtr snapshot = m_props->getSnapshot();
+    ASSERT_EQ(snapshot->getVersion(), m_props->getVersion());
+    ASSERT_THAT(*snapshot->getValue<std::vector<unsigned>>(propName), testing::ElementsAre(100, 200, 300));
+}
+
+/**
+    Test: handle value is updated on change
+ */
+TEST_F(TestPropertyContainer, PropertyHandle)
+{
+    PropertyHandle<int> handle{*m_props, "section/value"};
+    ASSERT_FALSE(handle.get());
+    ASSERT_EQ(handle.getOr(-1), -1);
+
+    m_props->setValue("section/value", 1).ignore();
+    ASSERT_EQ(handle.get(), 1);
+
+    m_props->setValue("section/other", 2).ignore();
+    ASSERT_EQ(handle.get(), 1);
+
+    m_props->setValue("section/value", 3).ignore();
+    ASSERT_EQ(handle.get(), 3);
+
+    PropertyHandle<PropSectionData::SubSection> sectionHandle{*m_props, "section_021"};
+    ASSERT_TRUE(mergeFromJson(*m_props, R"-({"section_021": {"prop_float": 1.5, "prop_text": "text"}})-"));
+    ASSERT_TRUE(sectionHandle.get());
+    ASSERT_EQ(sectionHandle.get()->propText, "text");
+}
+
+/**
+    Test: snapshot is consistent while the properties are changed concurrently
+ */
+TEST_F(TestPropertyContainer, SnapshotConcurrentReads)
+{
+    constexpr int IterationsCount = 200;
+
+    std::atomic<bool> isWriting = true;
+    std::thread writer([this, &isWriting]
+    {
+        rtstack_init(1_Mb);
+        for (int i = 0; i < IterationsCount; ++i)
+        {
+            mergeFromJson(*m_props, std::format(R"-({{"a": {0}, "section": {{"b": {0}}}}})-", i));
+        }
+
+        isWriting = false;
+    });
+
+    std::vector<std::thread> readers;
+    std::atomic<int> inconsistentReads = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([this, &isWriting, &inconsistentReads]
+        {
+            rtstack_init(1_Mb);
+            while (isWriting)
+            {
+                const PropertySnapshotPtr snapshot = m_props->getSnapshot();
+                if (snapshot->getValue<int>("a") != snapshot->getValue<int>("section/b"))
+                {
+                    ++inconsistentReads;
+                }
+            }
+        });
+    }
+
+    writer.join();
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    ASSERT_EQ(inconsistentReads, 0);
+    ASSERT_EQ(m_props->getSnapshot()->getValue<int>("section/b"), IterationsCount - 1);
+}
+
 }  // namespace my::test
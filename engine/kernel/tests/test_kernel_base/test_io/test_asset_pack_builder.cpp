@@ -0,0 +1,254 @@
+// #my_engine_source_file
+
+#include "my/io/asset_pack.h"
+#include "my/io/asset_pack_builder.h"
+#include "my/io/asset_pack_file_system.h"
+#include "my/io/memory_stream.h"
+#include "my/io/zip_archive_file_system.h"
+#include "my/serialization/json_utils.h"
+#include "my/test/helpers/zip_archive_builder.h"
+
+#include <fstream>
+
+using namespace testing;
+
+namespace my::test
+{
+    /**
+        Source content is provided by the zip archive file system, the built pack is opened with the asset pack file system.
+     */
+    class TestAssetPackBuilder : public testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            m_packPath = std::filesystem::temp_directory_path() / std::format("test_asset_pack_builder_{}.myap", ::testing::UnitTest::GetInstance()->random_seed());
+        }
+
+        void TearDown() override
+        {
+            std::error_code ec;
+            std::filesystem::remove(m_packPath, ec);
+        }
+
+        Result<io::AssetPackBuildResult> buildPack(const ZipArchiveBuilder& source, const io::AssetPackBuildSettings& settings = {}, const io::FsPath& root = "")
+        {
+            const io::FileSystemPtr sourceFs = io::createZipArchiveFileSystem(io::createMemoryStream(source.build(), io::AccessMode::Read));
+            if (!sourceFs)
+            {
+                return MakeError("Invalid source");
+            }
+
+            const io::MemoryStreamPtr output = io::createMemoryStream();
+            Result<io::AssetPackBuildResult> buildResult = io::buildAssetPack(*sourceFs, root, *output, settings);
+            CheckResult(buildResult);
+
+            const std::span<const std::byte> packData = output->getBufferAsSpan(0, std::nullopt);
+            m_packData.assign(reinterpret_cast<const char*>(packData.data()), packData.size());
+
+            std::ofstream stream{m_packPath, std::ios::binary | std::ios::trunc};
+            stream.write(m_packData.data(), m_packData.size());
+
+            return buildResult;
+        }
+
+        io::FileSystemPtr openPack(io::AssetPackFileSystemSettings settings = {}) const
+        {
+            return io::createAssetPackFileSystem(m_packPath.u8string(), settings);
+        }
+
+        io::AssetPackIndexData readIndex() const
+        {
+            io::AssetPackHeader header;
+            memcpy(&header, m_packData.data(), sizeof(header));
+
+            Result<io::AssetPackIndexData> index = serialization::JsonUtils::parse<io::AssetPackIndexData>(std::string_view{m_packData}.substr(header.indexOffset, header.indexSize));
+            return index ? std::move(*index) : io::AssetPackIndexData{};
+        }
+
+        static const io::AssetPackFileEntry* findEntry(const io::AssetPackIndexData& index, std::string_view path)
+        {
+            const auto iter = std::find_if(index.content.begin(), index.content.end(), [path](const io::AssetPackFileEntry& entry)
+            {
+                return entry.filePath == path;
+            });
+
+            return iter != index.content.end() ? &(*iter) : nullptr;
+        }
+
+        static std::string readContent(const io::FilePtr& file)
+        {
+            const io::StreamPtr stream = file->createStream(io::AccessMode::Read);
+            std::string result(file->getSize(), '\0');
+            const Result<size_t> readResult = copyFromStream(result.data(), result.size(), *stream);
+            return readResult ? result.substr(0, *readResult) : std::string{};
+        }
+
+        static std::string makeTextContent(size_t size)
+        {
+            std::string content;
+            for (size_t i = 0; content.size() < size; ++i)
+            {
+                content.append(std::format("text line [{}] of the asset content\n", i % 100));
+            }
+
+            content.resize(size);
+            return content;
+        }
+
+        std::filesystem::path m_packPath;
+        std::string m_packData;
+    };
+
+    TEST_F(TestAssetPackBuilder, BuildAndOpen)
+    {
+        const std::string textContent = makeTextContent(10'000);
+
+        ZipArchiveBuilder source;
+        source.addFile("config.json", "{\"value\": 1}");
+        source.addFile("data/text.txt", textContent);
+        source.addFile("data/nested/level.bin", "level content");
+        source.addDirectory("empty");
+
+        io::AssetPackBuildSettings settings;
+        settings.description = "test pack";
+
+        const Result<io::AssetPackBuildResult> buildResult = buildPack(source, settings);
+        ASSERT_TRUE(buildResult);
+        ASSERT_EQ(buildResult->filesCount, 3);
+        ASSERT_EQ(buildResult->uniqueBlobsCount, 3);
+        ASSERT_LT(buildResult->packSize, buildResult->sourceSize);
+
+        const io::AssetPackIndexData index = readIndex();
+        ASSERT_EQ(index.description, "test pack");
+        ASSERT_EQ(index.content.size(), 3);
+
+        const io::FileSystemPtr fs = openPack();
+        ASSERT_TRUE(fs);
+
+        ASSERT_EQ(readContent(fs->openFile("config.json", io::AccessMode::Read, io::OpenFileMode::OpenExisting)), "{\"value\": 1}");
+        ASSERT_EQ(readContent(fs->openFile("data/text.txt", io::AccessMode::Read, io::OpenFileMode::OpenExisting)), textContent);
+        ASSERT_EQ(readContent(fs->openFile("data/nested/level.bin", io::AccessMode::Read, io::OpenFileMode::OpenExisting)), "level content");
+    }
+
+    TEST_F(TestAssetPackBuilder, DeduplicateBlobs)
+    {
+        const std::string sharedContent = makeTextContent(5'000);
+
+        ZipArchiveBuilder source;
+        source.addFile("a/shared.txt", sharedContent);
+        source.addFile("b/shared_copy.txt", sharedContent);
+        source.addFile("c/other.txt", makeTextContent(4'999));
+
+        const Result<io::AssetPackBuildResult> buildResult = buildPack(source);
+        ASSERT_TRUE(buildResult);
+        ASSERT_EQ(buildResult->filesCount, 3);
+        ASSERT_EQ(buildResult->uniqueBlobsCount, 2);
+
+        const io::AssetPackIndexData index = readIndex();
+        const io::AssetPackFileEntry* const entry1 = findEntry(index, "a/shared.txt");
+        const io::AssetPackFileEntry* const entry2 = findEntry(index, "b/shared_copy.txt");
+        ASSERT_TRUE(entry1 && entry2);
+        ASSERT_EQ(entry1->blobData.offset, entry2->blobData.offset);
+
+        const io::FileSystemPtr fs = openPack();
+        ASSERT_TRUE(fs);
+        ASSERT_EQ(readContent(fs->openFile("b/shared_copy.txt", io::AccessMode::Read, io::OpenFileMode::OpenExisting)), sharedContent);
+    }
+
+    TEST_F(TestAssetPackBuilder, CompressionRules)
+    {
+        ZipArchiveBuilder source;
+        source.addFile("small.txt", "small");
+        source.addFile("text.txt", makeTextContent(10'000));
+        source.addFile("image.png", makeTextContent(10'001));
+
+        io::AssetPackBuildSettings settings;
+        settings.compressionByExtension["png"] = io::ContentCompression::None;
+
+        ASSERT_TRUE(buildPack(source, settings));
+
+        const io::AssetPackIndexData index = readIndex();
+        ASSERT_EQ(findEntry(index, "small.txt")->contentCompression, "");
+        ASSERT_EQ(findEntry(index, "text.txt")->contentCompression, "lz4");
+        ASSERT_EQ(findEntry(index, "image.png")->contentCompression, "");
+
+        const io::AssetPackFileEntry* const textEntry = findEntry(index, "text.txt");
+        ASSERT_LT(textEntry->blobData.size, textEntry->clientSize);
+    }
+
+    /**
+        Compression that does not reduce the size is discarded.
+     */
+    TEST_F(TestAssetPackBuilder, IncompressibleContentIsStored)
+    {
+        std::string randomContent(4'000, '\0');
+        uint32_t state = 0x9E3779B9u;
+        for (char& c : randomContent)
+        {
+            state = state * 1664525u + 1013904223u;
+            c = static_cast<char>(state >> 24);
+        }
+
+        ZipArchiveBuilder source;
+        source.addFile("random.bin", randomContent);
+
+        const Result<io::AssetPackBuildResult> buildResult = buildPack(source);
+        ASSERT_TRUE(buildResult);
+        ASSERT_EQ(buildResult->compressedBlobsCount, 0);
+        ASSERT_EQ(findEntry(readIndex(), "random.bin")->contentCompression, "");
+    }
+
+    /**
+        Files that are larger than the decompressed content cache are decompressed by the stream.
+     */
+    TEST_F(TestAssetPackBuilder, StreamLargeCompressedFile)
+    {
+        const std::string largeContent = makeTextContent(io::ContentCompressionChunkSize * 5 + 321);
+
+        ZipArchiveBuilder source;
+        source.addFile("large.txt", largeContent);
+        ASSERT_TRUE(buildPack(source));
+
+        const io::FileSystemPtr fs = openPack({.maxCacheSize = 1024});
+        ASSERT_TRUE(fs);
+
+        const io::FilePtr file = fs->openFile("large.txt", io::AccessMode::Read, io::OpenFileMode::OpenExisting);
+        ASSERT_TRUE(file);
+        ASSERT_FALSE(file->supports(io::IFile::FileFeature::MemoryMapping));
+        ASSERT_EQ(file->getSize(), largeContent.size());
+        ASSERT_EQ(readContent(file), largeContent);
+    }
+
+    TEST_F(TestAssetPackBuilder, BuildSubDirectory)
+    {
+        ZipArchiveBuilder source;
+        source.addFile("content/data/file.txt", "file content");
+        source.addFile("other/file.txt", "other content");
+
+        const Result<io::AssetPackBuildResult> buildResult = buildPack(source, {}, "content");
+        ASSERT_TRUE(buildResult);
+        ASSERT_EQ(buildResult->filesCount, 1);
+
+        const io::FileSystemPtr fs = openPack();
+        ASSERT_TRUE(fs);
+        ASSERT_EQ(readContent(fs->openFile("data/file.txt", io::AccessMode::Read, io::OpenFileMode::OpenExisting)), "file content");
+        ASSERT_FALSE(fs->exists("other/file.txt", std::nullopt));
+    }
+
+    TEST_F(TestAssetPackBuilder, UnavailableCompression)
+    {
+        if (io::isContentCompressionAvailable(io::ContentCompression::Zstd))
+        {
+            GTEST_SKIP() << "zstd is available";
+        }
+
+        ZipArchiveBuilder source;
+        source.addFile("file.txt", makeTextContent(1'000));
+
+        io::AssetPackBuildSettings settings;
+        settings.defaultCompression = io::ContentCompression::Zstd;
+
+        ASSERT_FALSE(buildPack(source, settings));
+    }
+}  // namespace my::test
@@ -0,0 +1,183 @@
+// #my_engine_source_file
+
+#include "my/io/asset_pack.h"
+#include "my/io/asset_pack_file_system.h"
+#include "my/io/memory_stream.h"
+#include "my/serialization/json_utils.h"
+
+#include <fstream>
+
+using namespace testing;
+
+namespace my::test
+{
+    class TestAssetPackFileSystem : public testing::Test
+    {
+    protected:
+        struct PackContent
+        {
+            std::string path;
+            std::string data;
+            std::string compression = {};
+        };
+
+        void SetUp() override
+        {
+            m_packPath = std::filesystem::temp_directory_path() / std::format("test_asset_pack_{}.myap", ::testing::UnitTest::GetInstance()->random_seed());
+        }
+
+        void TearDown() override
+        {
+            std::error_code ec;
+            std::filesystem::remove(m_packPath, ec);
+        }
+
+        void writePack(const std::vector<PackContent>& content)
+        {
+            io::AssetPackIndexData index{.version = "1", .description = "test"};
+            std::string blobs;
+
+            for (const PackContent& entry : content)
+            {
+                index.content.push_back(io::AssetPackFileEntry{
+                    .filePath = entry.path,
+                    .contentCompression = entry.compression,
+                    .clientSize = entry.data.size(),
+                    .blobData = {.size = entry.data.size(), .offset = sizeof(io::AssetPackHeader) + blobs.size()}});
+
+                blobs.append(entry.data);
+            }
+
+            const std::string indexString = serialization::JsonUtils::stringify(index);
+            const io::AssetPackHeader header{
+                .indexOffset = sizeof(io::AssetPackHeader) + blobs.size(),
+                .indexSize = indexString.size()};
+
+            std::ofstream stream{m_packPath, std::ios::binary | std::ios::trunc};
+            stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            stream.write(blobs.data(), blobs.size());
+            stream.write(indexString.data(), indexString.size());
+        }
+
+        io::FileSystemPtr openPack() const
+        {
+            return io::createAssetPackFileSystem(m_packPath.u8string());
+        }
+
+        static std::string readContent(const io::FilePtr& file)
+        {
+            const io::StreamPtr stream = file->createStream(io::AccessMode::Read);
+            std::string result(file->getSize(), '\0');
+            const Result<size_t> readResult = stream->read(reinterpret_cast<std::byte*>(result.data()), result.size());
+            return readResult ? result.substr(0, *readResult) : std::string{};
+        }
+
+        std::filesystem::path m_packPath;
+    };
+
+    TEST_F(TestAssetPackFileSystem, OpenFile)
+    {
+        writePack({
+            {"data/config.json", "{}"},
+            {"data/textures/stone.dds", "stone_texture"},
+            {"readme.txt", "readme"}
+        });
+
+        const io::FileSystemPtr fs = openPack();
+        ASSERT_TRUE(fs);
+        ASSERT_TRUE(fs->isReadOnly());
+
+        const io::FilePtr file = fs->openFile("data/textures/stone.dds", io::AccessMode::Read, io::OpenFileMode::OpenExisting);
+        ASSERT_TRUE(file);
+        ASSERT_EQ(file->getSize(), 13);
+        ASSERT_EQ(readContent(file), "stone_texture");
+
+        ASSERT_TRUE(fs->openFile("/readme.txt", io::AccessMode::Read, io::OpenFileMode::OpenExisting));
+        ASSERT_FALSE(fs->openFile("data/unknown.txt", io::AccessMode::Read, io::OpenFileMode::OpenExisting));
+    }
+
+    TEST_F(TestAssetPackFileSystem, ZeroCopyView)
+    {
+        writePack({
+            {"a.bin", "first"},
+            {"b.bin", "second"}
+        });
+
+        const io::FileSystemPtr fs = openPack();
+        ASSERT_TRUE(fs);
+
+        const io::FilePtr file = fs->openFile("b.bin", io::AccessMode::Read, io::OpenFileMode::OpenExisting);
+        ASSERT_TRUE(file);
+        ASSERT_TRUE(file->supports(io::IFile::FileFeature::MemoryMapping));
+
+        const void* const ptr = file->as<io::IMemoryMappableObject&>().memMap(0, file->getSize());
+        ASSERT_EQ(std::string_view(reinterpret_cast<const char*>(ptr), file->getSize()), "second");
+
+        // the file's stream refers to the same memory
+        const io::StreamPtr stream = file->createStream(io::AccessMode::Read);
+        const std::span<const std::byte> streamData = stream->as<io::MemoryStream&>().getBufferAsSpan(0, std::nullopt);
+        ASSERT_EQ(streamData.data(), ptr);
+    }
+
+    TEST_F(TestAssetPackFileSystem, Exists)
+    {
+        writePack({
+            {"data/config.json", "{}"},
+            {"data/textures/stone.dds", "stone"}
+        });
+
+        const io::FileSystemPtr fs = openPack();
+        ASSERT_TRUE(fs);
+
+        ASSERT_TRUE(fs->exists("data/config.json"));
+        ASSERT_TRUE(fs->exists("data/config.json", io::FsEntryKind::File));
+        ASSERT_FALSE(fs->exists("data/config.json", io::FsEntryKind::Directory));
+        ASSERT_TRUE(fs->exists("data/textures", io::FsEntryKind::Directory));
+        ASSERT_TRUE(fs->exists("/", io::FsEntryKind::Directory));
+        ASSERT_FALSE(fs->exists("data/text"));
+    }
+
+    TEST_F(TestAssetPackFileSystem, IterateDirectory)
+    {
+        writePack({
+            {"data/textures/stone.dds", "stone"},
+            {"data/config.json", "{}"},
+            {"data/textures/grass.dds", "grass"},
+            {"data/sounds/step.wav", "step"},
+            {"readme.txt", "readme"}
+        });
+
+        const io::FileSystemPtr fs = openPack();
+        ASSERT_TRUE(fs);
+
+        std::vector<std::string> entries;
+        io::DirectoryIterator dirIterator{fs, "data"};
+        for (const io::FsEntry& entry : dirIterator)
+        {
+            entries.push_back(std::format("{}:{}", entry.path.getString(), entry.kind == io::FsEntryKind::Directory ? "dir" : "file"));
+        }
+
+        ASSERT_THAT(entries, ElementsAre("data/config.json:file", "data/sounds:dir", "data/textures:dir"));
+    }
+
+    TEST_F(TestAssetPackFileSystem, UnsupportedCompression)
+    {
+        writePack({
+            {"packed.bin", "compressed_content", "unknown_codec"}
+        });
+
+        const io::FileSystemPtr fs = openPack();
+        ASSERT_TRUE(fs);
+        ASSERT_FALSE(fs->openFile("packed.bin", io::AccessMode::Read, io::OpenFileMode::OpenExisting));
+    }
+
+    TEST_F(TestAssetPackFileSystem, InvalidPack)
+    {
+        {
+            std::ofstream stream{m_packPath, std::ios::binary | std::ios::trunc};
+            stream << "not an asset pack content";
+        }
+
+        ASSERT_FALSE(openPack());
+    }
+}  // namespace my::test
@@ -0,0 +1,183 @@
+// #my_engine_source_file
+
+#include "my/io/content_compression.h"
+
+using namespace testing;
+
+namespace my::test
+{
+    namespace
+    {
+        std::string makeCompressibleContent(size_t size)
+        {
+            std::string content;
+            content.reserve(size);
+            for (size_t i = 0; content.size() < size; ++i)
+            {
+                content.append(std::format("line [{}]: some repeated text of the asset;\n", i % 1000));
+            }
+
+            content.resize(size);
+            return content;
+        }
+
+        std::string makeRandomContent(size_t size)
+        {
+            std::string content(size, '\0');
+            uint32_t state = 0x12345678u;
+            for (char& c : content)
+            {
+                state = state * 1664525u + 1013904223u;
+                c = static_cast<char>(state >> 24);
+            }
+
+            return content;
+        }
+
+        std::span<const std::byte> asBytes(const std::string& content)
+        {
+            return std::as_bytes(std::span{content});
+        }
+
+        std::string decompress(io::ContentCompression compression, const Buffer& compressedContent, size_t clientSize)
+        {
+            std::string result(clientSize, '\0');
+            const Result<> decompressResult = io::decompressContent(compression, {compressedContent.data(), compressedContent.size()}, std::as_writable_bytes(std::span{result}));
+            return decompressResult ? result : std::string{};
+        }
+
+        std::string readStream(io::IStream& stream, size_t count, size_t readBlockSize)
+        {
+            std::string result;
+            std::string block(readBlockSize, '\0');
+            while (result.size() < count)
+            {
+                const Result<size_t> readResult = stream.read(reinterpret_cast<std::byte*>(block.data()), std::min(readBlockSize, count - result.size()));
+                if (!readResult || *readResult == 0)
+                {
+                    break;
+                }
+
+                result.append(block.data(), *readResult);
+            }
+
+            return result;
+        }
+
+        std::vector<io::ContentCompression> getAvailableCompressions()
+        {
+            std::vector<io::ContentCompression> compressions{io::ContentCompression::Lz4};
+            if (io::isContentCompressionAvailable(io::ContentCompression::Zstd))
+            {
+                compressions.push_back(io::ContentCompression::Zstd);
+            }
+
+            return compressions;
+        }
+    }  // namespace
+
+    TEST(TestContentCompression, ParseName)
+    {
+        ASSERT_EQ(io::parseContentCompression(""), io::ContentCompression::None);
+        ASSERT_EQ(io::parseContentCompression("none"), io::ContentCompression::None);
+        ASSERT_EQ(io::parseContentCompression("LZ4"), io::ContentCompression::Lz4);
+        ASSERT_EQ(io::parseContentCompression("zstd"), io::ContentCompression::Zstd);
+        ASSERT_FALSE(io::parseContentCompression("unknown_codec"));
+
+        ASSERT_EQ(io::getContentCompressionName(io::ContentCompression::Lz4), "lz4");
+        ASSERT_TRUE(io::isContentCompressionAvailable(io::ContentCompression::Lz4));
+    }
+
+    /**
+        Content sizes around the chunk boundaries, incompressible chunks are stored as is.
+     */
+    TEST(TestContentCompression, Roundtrip)
+    {
+        constexpr size_t ChunkSize = io::ContentCompressionChunkSize;
+
+        for (const io::ContentCompression compression : getAvailableCompressions())
+        {
+            for (const size_t size : {size_t{0}, size_t{1}, size_t{13}, ChunkSize - 1, ChunkSize, ChunkSize + 1, ChunkSize * 3 + 517})
+            {
+                for (const std::string& content : {makeCompressibleContent(size), makeRandomContent(size)})
+                {
+                    Result<Buffer> compressedContent = io::compressContent(compression, asBytes(content));
+                    ASSERT_TRUE(compressedContent);
+                    ASSERT_EQ(decompress(compression, *compressedContent, content.size()), content) << io::getContentCompressionName(compression) << ": " << size;
+                }
+            }
+        }
+    }
+
+    TEST(TestContentCompression, CompressibleContentIsSmaller)
+    {
+        const std::string content = makeCompressibleContent(io::ContentCompressionChunkSize * 4);
+
+        for (const io::ContentCompression compression : getAvailableCompressions())
+        {
+            Result<Buffer> compressedContent = io::compressContent(compression, asBytes(content));
+            ASSERT_TRUE(compressedContent);
+            ASSERT_LT(compressedContent->size(), content.size() / 4);
+        }
+    }
+
+    TEST(TestContentCompression, CorruptedContent)
+    {
+        const std::string content = makeCompressibleContent(io::ContentCompressionChunkSize + 100);
+        Result<Buffer> compressedContent = io::compressContent(io::ContentCompression::Lz4, asBytes(content));
+        ASSERT_TRUE(compressedContent);
+
+        std::string output(content.size(), '\0');
+        const std::span<const std::byte> truncatedContent{compressedContent->data(), compressedContent->size() / 2};
+        ASSERT_FALSE(io::decompressContent(io::ContentCompression::Lz4, truncatedContent, std::as_writable_bytes(std::span{output})));
+
+        // wrong client size
+        output.resize(content.size() + 1);
+        ASSERT_FALSE(io::decompressContent(io::ContentCompression::Lz4, {compressedContent->data(), compressedContent->size()}, std::as_writable_bytes(std::span{output})));
+    }
+
+    TEST(TestContentCompression, StreamRead)
+    {
+        const std::string content = makeCompressibleContent(io::ContentCompressionChunkSize * 3 + 1234);
+
+        for (const io::ContentCompression compression : getAvailableCompressions())
+        {
+            Result<Buffer> compressedContent = io::compressContent(compression, asBytes(content));
+            ASSERT_TRUE(compressedContent);
+
+            // small blocks cross the chunk boundaries
+            for (const size_t readBlockSize : {size_t{1000}, size_t{4096}, io::ContentCompressionChunkSize * 2})
+            {
+                const io::StreamPtr stream = io::createDecompressionStream(compression, nullptr, {compressedContent->data(), compressedContent->size()}, content.size());
+                ASSERT_TRUE(stream);
+                ASSERT_TRUE(stream->canSeek());
+                ASSERT_FALSE(stream->canWrite());
+                ASSERT_EQ(readStream(*stream, content.size() + 100, readBlockSize), content);
+                ASSERT_EQ(stream->getPosition(), content.size());
+            }
+        }
+    }
+
+    TEST(TestContentCompression, StreamSeek)
+    {
+        const std::string content = makeCompressibleContent(io::ContentCompressionChunkSize * 3 + 1234);
+
+        for (const io::ContentCompression compression : getAvailableCompressions())
+        {
+            Result<Buffer> compressedContent = io::compressContent(compression, asBytes(content));
+            ASSERT_TRUE(compressedContent);
+
+            const io::StreamPtr stream = io::createDecompressionStream(compression, nullptr, {compressedContent->data(), compressedContent->size()}, content.size());
+            ASSERT_TRUE(stream);
+
+            for (const size_t offset : {io::ContentCompressionChunkSize * 2 + 10, size_t{5}, io::ContentCompressionChunkSize - 3, content.size() - 7})
+            {
+                ASSERT_EQ(stream->setPosition(io::OffsetOrigin::Begin, static_cast<int64_t>(offset)), offset);
+                ASSERT_EQ(readStream(*stream, 100, 100), content.substr(offset, 100)) << io::getContentCompressionName(compression) << ": " << offset;
+            }
+
+            stream->setPosition(io::OffsetOrigin::End, -10);
+            ASSERT_EQ(readStream(*stream, 100, 100), content.substr(content.size() - 10));
+        }
+    }
+}  // namespace my::test
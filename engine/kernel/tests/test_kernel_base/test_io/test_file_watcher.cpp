@@ -0,0 +1,156 @@
+// #my_engine_source_file
+
+#include <condition_variable>
+#include <fstream>
+
+#include "my/io/file_watcher.h"
+#include "my/test/helpers/runtime_guard.h"
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace my::test
+{
+    class TestFileWatcher : public testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            m_directory = std::filesystem::temp_directory_path() / std::format("test_file_watcher_{}", ::testing::UnitTest::GetInstance()->random_seed());
+            std::filesystem::remove_all(m_directory);
+            std::filesystem::create_directories(m_directory);
+        }
+
+        void TearDown() override
+        {
+            m_runtime.reset();
+
+            std::error_code ec;
+            std::filesystem::remove_all(m_directory, ec);
+        }
+
+        Result<io::FileWatcherPtr> watch(io::FileWatcherSettings settings = {})
+        {
+            return io::createNativeFileWatcher(m_directory, "/watched", [this](std::span<const io::FileChangeEvent> changes)
+            {
+                const std::lock_guard lock(m_mutex);
+                m_batches.emplace_back(changes.begin(), changes.end());
+                m_signal.notify_all();
+            }, settings);
+        }
+
+        /**
+            Waits for the change of the path, returns the batch that contains it.
+         */
+        std::vector<io::FileChangeEvent> waitForChange(std::string_view path, io::FileChangeKind kind, std::chrono::milliseconds timeout = 5s)
+        {
+            std::unique_lock lock(m_mutex);
+            std::vector<io::FileChangeEvent> result;
+
+            m_signal.wait_for(lock, timeout, [&]
+            {
+                for (const std::vector<io::FileChangeEvent>& batch : m_batches)
+                {
+                    const bool found = std::any_of(batch.begin(), batch.end(), [&](const io::FileChangeEvent& change)
+                    {
+                        return change.path == io::FsPath{path} && change.kind == kind;
+                    });
+
+                    if (found)
+                    {
+                        result = batch;
+                        return true;
+                    }
+                }
+
+                return false;
+            });
+
+            return result;
+        }
+
+        void writeFile(const std::filesystem::path& relativePath, std::string_view content)
+        {
+            std::ofstream stream{m_directory / relativePath, std::ios::binary | std::ios::app};
+            stream.write(content.data(), content.size());
+        }
+
+        RuntimeGuard::Ptr m_runtime = RuntimeGuard::create();
+        std::filesystem::path m_directory;
+        std::mutex m_mutex;
+        std::condition_variable m_signal;
+        std::vector<std::vector<io::FileChangeEvent>> m_batches;
+    };
+
+    TEST_F(TestFileWatcher, NotExistingPath)
+    {
+        const Result<io::FileWatcherPtr> watcher = io::createNativeFileWatcher(m_directory / "unknown", "/watched", [](std::span<const io::FileChangeEvent>)
+        {
+        });
+
+        ASSERT_FALSE(watcher);
+    }
+
+    TEST_F(TestFileWatcher, AddModifyRemove)
+    {
+        const Result<io::FileWatcherPtr> watcher = watch();
+        ASSERT_TRUE(watcher);
+        ASSERT_EQ((*watcher)->getPath(), io::FsPath{"/watched"});
+
+        writeFile("file.txt", "content");
+        ASSERT_FALSE(waitForChange("/watched/file.txt", io::FileChangeKind::Added).empty());
+
+        writeFile("file.txt", "more content");
+        ASSERT_FALSE(waitForChange("/watched/file.txt", io::FileChangeKind::Modified).empty());
+
+        std::filesystem::remove(m_directory / "file.txt");
+        ASSERT_FALSE(waitForChange("/watched/file.txt", io::FileChangeKind::Removed).empty());
+    }
+
+    /**
+        The burst of the writes is reported as the single change.
+     */
+    TEST_F(TestFileWatcher, CoalesceChanges)
+    {
+        const Result<io::FileWatcherPtr> watcher = watch({.debounceTimeout = 200ms, .maxDelay = 2s});
+        ASSERT_TRUE(watcher);
+
+        for (size_t i = 0; i < 20; ++i)
+        {
+            writeFile("file.txt", std::format("line {}\n", i));
+        }
+
+        const std::vector<io::FileChangeEvent> batch = waitForChange("/watched/file.txt", io::FileChangeKind::Added);
+        ASSERT_EQ(batch.size(), 1);
+
+        const std::lock_guard lock(m_mutex);
+        ASSERT_EQ(m_batches.size(), 1);
+    }
+
+    TEST_F(TestFileWatcher, WatchSubDirectories)
+    {
+        std::filesystem::create_directories(m_directory / "existing");
+
+        const Result<io::FileWatcherPtr> watcher = watch();
+        ASSERT_TRUE(watcher);
+
+        writeFile("existing/file.txt", "content");
+        ASSERT_FALSE(waitForChange("/watched/existing/file.txt", io::FileChangeKind::Added).empty());
+
+        std::filesystem::create_directories(m_directory / "created");
+        ASSERT_FALSE(waitForChange("/watched/created", io::FileChangeKind::Added).empty());
+
+        writeFile("created/file.txt", "content");
+        ASSERT_FALSE(waitForChange("/watched/created/file.txt", io::FileChangeKind::Added).empty());
+    }
+
+    TEST_F(TestFileWatcher, NoChangesAfterDispose)
+    {
+        const Result<io::FileWatcherPtr> watcher = watch({.debounceTimeout = 10ms});
+        ASSERT_TRUE(watcher);
+
+        (*watcher)->dispose();
+        writeFile("file.txt", "content");
+        ASSERT_TRUE(waitForChange("/watched/file.txt", io::FileChangeKind::Added, 500ms).empty());
+    }
+}  // namespace my::test
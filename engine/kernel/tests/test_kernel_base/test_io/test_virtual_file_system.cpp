@@ -0,0 +1,388 @@
+// #my_engine_source_file
+
+#include "my/io/memory_stream.h"
+#include "my/io/virtual_file_system.h"
+#include "my/io/zip_archive_file_system.h"
+#include "my/test/helpers/zip_archive_builder.h"
+
+using namespace testing;
+
+namespace my::test
+{
+    namespace
+    {
+        class StubFileWatcher final : public io::IFileWatcher
+        {
+            MY_REFCOUNTED_CLASS(my::test::StubFileWatcher, io::IFileWatcher)
+
+        public:
+            StubFileWatcher(io::FsPath path) :
+                m_path(std::move(path))
+            {
+            }
+
+            void dispose() override
+            {
+            }
+
+            io::FsPath getPath() const override
+            {
+                return m_path;
+            }
+
+        private:
+            const io::FsPath m_path;
+        };
+
+        /**
+            Forwards to the other file system and counts the directory reads.
+            Changes are reported manually with notifyChanges.
+         */
+        class DirReadCountingFileSystem final : public io::FileSystem
+        {
+            MY_REFCOUNTED_CLASS(my::test::DirReadCountingFileSystem, io::FileSystem)
+
+        public:
+            DirReadCountingFileSystem(io::FileSystemPtr fs) :
+                m_fs(std::move(fs))
+            {
+            }
+
+            bool isReadOnly() const override
+            {
+                return true;
+            }
+
+            bool exists(const io::FsPath& path, std::optional<io::FsEntryKind> kind) override
+            {
+                return m_fs->exists(path, kind);
+            }
+
+            size_t getLastWriteTime(const io::FsPath& path) override
+            {
+                return m_fs->getLastWriteTime(path);
+            }
+
+            io::FilePtr openFile(const io::FsPath& path, io::AccessModeFlag accessMode, io::OpenFileMode openMode) override
+            {
+                return m_fs->openFile(path, accessMode, openMode);
+            }
+
+            OpenDirResult openDirIterator(const io::FsPath& path) override
+            {
+                ++m_openDirCount;
+                return m_fs->openDirIterator(path);
+            }
+
+            void closeDirIterator(void* state) override
+            {
+                m_fs->closeDirIterator(state);
+            }
+
+            io::FsEntry incrementDirIterator(void* state) override
+            {
+                return m_fs->incrementDirIterator(state);
+            }
+
+            size_t readDirEntries(void* state, std::span<io::FsEntry> entries) override
+            {
+                return m_fs->readDirEntries(state, entries);
+            }
+
+            Result<io::FileWatcherPtr> watch(const io::FsPath& path, io::FileChangeCallback callback, io::FileWatcherSettings) override
+            {
+                m_watchPath = path;
+                m_watchCallback = std::move(callback);
+                return rtti::createInstance<StubFileWatcher, io::IFileWatcher>(path);
+            }
+
+            size_t getOpenDirCount() const
+            {
+                return m_openDirCount;
+            }
+
+            const io::FsPath& getWatchPath() const
+            {
+                return m_watchPath;
+            }
+
+            void notifyChanges(std::vector<io::FileChangeEvent> changes)
+            {
+                if (m_watchCallback)
+                {
+                    m_watchCallback(changes);
+                }
+            }
+
+        private:
+            const io::FileSystemPtr m_fs;
+            std::atomic<size_t> m_openDirCount = 0;
+            io::FsPath m_watchPath;
+            io::FileChangeCallback m_watchCallback;
+        };
+    }  // namespace
+
+    class TestVirtualFileSystem : public testing::Test
+    {
+    protected:
+        static io::FileSystemPtr makeFileSystem(const std::vector<std::pair<std::string, std::string>>& files)
+        {
+            ZipArchiveBuilder builder;
+            for (const auto& [path, content] : files)
+            {
+                builder.addFile(path, content);
+            }
+
+            return io::createZipArchiveFileSystem(io::createMemoryStream(builder.build(), io::AccessMode::Read));
+        }
+
+        static std::string readContent(const io::FilePtr& file)
+        {
+            if (!file)
+            {
+                return {};
+            }
+
+            const io::StreamPtr stream = file->createStream(io::AccessMode::Read);
+            std::string result(file->getSize(), '\0');
+            const Result<size_t> readResult = stream->read(reinterpret_cast<std::byte*>(result.data()), result.size());
+            return readResult ? result.substr(0, *readResult) : std::string{};
+        }
+
+        static std::vector<std::string> getDirectoryNames(io::FileSystem& fs, const io::FsPath& path)
+        {
+            std::vector<std::string> names;
+
+            auto openResult = fs.openDirIterator(path);
+            if (!openResult)
+            {
+                return names;
+            }
+
+            auto [iter, entry] = *openResult;
+            for (; entry; entry = fs.incrementDirIterator(iter))
+            {
+                names.emplace_back(entry.path.getName());
+            }
+
+            fs.closeDirIterator(iter);
+            std::sort(names.begin(), names.end());
+            return names;
+        }
+    };
+
+    TEST_F(TestVirtualFileSystem, MountAndOpen)
+    {
+        const io::VirtualFileSystemPtr vfs = io::createVirtualFileSystem();
+        ASSERT_TRUE(vfs->mount("/content/textures", makeFileSystem({{"stone.png", "stone"}, {"ui/button.png", "button"}})));
+        ASSERT_TRUE(vfs->mount("/content/scripts", makeFileSystem({{"main.lua", "main"}})));
+
+        ASSERT_TRUE(vfs->exists("/content", io::FsEntryKind::Directory));
+        ASSERT_TRUE(vfs->exists("/content/textures/ui/button.png", io::FsEntryKind::File));
+        ASSERT_FALSE(vfs->exists("/content/textures/unknown.png", std::nullopt));
+        ASSERT_FALSE(vfs->exists("/unknown/file.txt", std::nullopt));
+
+        ASSERT_EQ(readContent(vfs->openFile("/content/textures/stone.png", io::AccessMode::Read, io::OpenFileMode::OpenExisting)), "stone");
+        ASSERT_EQ(readContent(vfs->openFile("/content/scripts/main.lua", io::AccessMode::Read, io::OpenFileMode::OpenExisting)), "main");
+        ASSERT_FALSE(vfs->openFile("/content/main.lua", io::AccessMode::Read, io::OpenFileMode::OpenExisting));
+    }
+
+    TEST_F(TestVirtualFileSystem, IterateVirtualDirectory)
+    {
+        const io::VirtualFileSystemPtr vfs = io::createVirtualFileSystem();
+        for (const std::string_view name : {"b", "a", "c"})
+        {
+            ASSERT_TRUE(vfs->mount(std::format("/root/{}", name), makeFileSystem({{"file.txt", "content"}})));
+        }
+
+        ASSERT_EQ(getDirectoryNames(*vfs, "/root"), (std::vector<std::string>{"a", "b", "c"}));
+        ASSERT_EQ(getDirectoryNames(*vfs, "/root/b"), (std::vector<std::string>{"file.txt"}));
+    }
+
+    TEST_F(TestVirtualFileSystem, MountPriority)
+    {
+        const io::VirtualFileSystemPtr vfs = io::createVirtualFileSystem();
+        ASSERT_TRUE(vfs->mount("/content", makeFileSystem({{"file.txt", "low"}}), 1));
+        ASSERT_TRUE(vfs->mount("/content", makeFileSystem({{"file.txt", "high"}}), 10));
+        ASSERT_TRUE(vfs->mount("/content", makeFileSystem({{"file.txt", "middle"}}), 5));
+
+        ASSERT_EQ(readContent(vfs->openFile("/content/file.txt", io::AccessMode::Read, io::OpenFileMode::OpenExisting)), "high");
+    }
+
+    /**
+        Resolved paths are cached: mount and unmount must be visible for the paths that are already resolved.
+     */
+    TEST_F(TestVirtualFileSystem, MountUnmountInvalidatesResolvedPaths)
+    {
+        const io::VirtualFileSystemPtr vfs = io::createVirtualFileSystem();
+        ASSERT_FALSE(vfs->exists("/content/file.txt", std::nullopt));
+
+        const io::FileSystemPtr fs1 = makeFileSystem({{"file.txt", "fs1"}});
+        const io::FileSystemPtr fs2 = makeFileSystem({{"file.txt", "fs2"}});
+
+        ASSERT_TRUE(vfs->mount("/content", fs1, 1));
+        ASSERT_TRUE(vfs->exists("/content/file.txt", std::nullopt));
+        ASSERT_EQ(readContent(vfs->openFile("/content/file.txt", io::AccessMode::Read, io::OpenFileMode::OpenExisting)), "fs1");
+
+        ASSERT_TRUE(vfs->mount("/content", fs2, 2));
+        ASSERT_EQ(readContent(vfs->openFile("/content/file.txt", io::AccessMode::Read, io::OpenFileMode::OpenExisting)), "fs2");
+
+        vfs->unmount(fs2);
+        ASSERT_EQ(readContent(vfs->openFile("/content/file.txt", io::AccessMode::Read, io::OpenFileMode::OpenExisting)), "fs1");
+
+        vfs->unmount(fs1);
+        ASSERT_FALSE(vfs->exists("/content/file.txt", std::nullopt));
+    }
+
+    TEST_F(TestVirtualFileSystem, ReadDirEntriesByBatches)
+    {
+        constexpr size_t FilesCount = 100;
+
+        std::vector<std::pair<std::string, std::string>> files;
+        for (size_t i = 0; i < FilesCount; ++i)
+        {
+            files.emplace_back(std::format("dir/file_{:03}.txt", i), "content");
+        }
+
+        const io::VirtualFileSystemPtr vfs = io::createVirtualFileSystem();
+        ASSERT_TRUE(vfs->mount("/content", makeFileSystem({files.begin(), files.begin() + FilesCount / 2})));
+        ASSERT_TRUE(vfs->mount("/content", makeFileSystem({files.begin() + FilesCount / 2, files.end()})));
+
+        auto openResult = vfs->openDirIterator("/content/dir");
+        ASSERT_TRUE(openResult);
+        auto [iter, firstEntry] = *openResult;
+        ASSERT_TRUE(iter);
+
+        std::vector<std::string> names{std::string{firstEntry.path.getName()}};
+        std::array<io::FsEntry, 16> batch;
+        for (size_t count = vfs->readDirEntries(iter, batch); count > 0; count = vfs->readDirEntries(iter, batch))
+        {
+            for (const io::FsEntry& entry : std::span{batch}.first(count))
+            {
+                ASSERT_TRUE(entry.path.isAbsolute());
+                ASSERT_EQ(entry.kind, io::FsEntryKind::File);
+                names.emplace_back(entry.path.getName());
+            }
+        }
+
+        vfs->closeDirIterator(iter);
+
+        std::sort(names.begin(), names.end());
+        ASSERT_EQ(names.size(), FilesCount);
+        for (size_t i = 0; i < FilesCount; ++i)
+        {
+            ASSERT_EQ(names[i], std::format("file_{:03}.txt", i));
+        }
+    }
+
+    TEST_F(TestVirtualFileSystem, DirectoryContentCache)
+    {
+        auto fs = rtti::createInstance<DirReadCountingFileSystem>(makeFileSystem({{"dir/a.txt", "a"}, {"dir/b.txt", "b"}}));
+
+        const io::VirtualFileSystemPtr vfs = io::createVirtualFileSystem();
+        ASSERT_TRUE(vfs->mount("/content", fs, io::VfsMountSettings{.cacheDirectoryContent = true}));
+
+        const std::vector<std::string> expectedNames{"a.txt", "b.txt"};
+        ASSERT_EQ(getDirectoryNames(*vfs, "/content/dir"), expectedNames);
+        ASSERT_EQ(getDirectoryNames(*vfs, "/content/dir"), expectedNames);
+        ASSERT_EQ(fs->getOpenDirCount(), 1);
+
+        vfs->invalidateDirectoryCache("/content/dir/a.txt");
+        ASSERT_EQ(getDirectoryNames(*vfs, "/content/dir"), expectedNames);
+        ASSERT_EQ(fs->getOpenDirCount(), 2);
+
+        vfs->invalidateDirectoryCache("/content/dir");
+        ASSERT_EQ(getDirectoryNames(*vfs, "/content/dir"), expectedNames);
+        ASSERT_EQ(fs->getOpenDirCount(), 3);
+
+        // not existing directory is cached too
+        ASSERT_TRUE(getDirectoryNames(*vfs, "/content/unknown").empty());
+        ASSERT_TRUE(getDirectoryNames(*vfs, "/content/unknown").empty());
+        ASSERT_EQ(fs->getOpenDirCount(), 4);
+    }
+
+    /**
+        Changes of the mounted file systems are reported with the vfs paths and drop the cached directory content.
+     */
+    TEST_F(TestVirtualFileSystem, WatchMountedFileSystems)
+    {
+        auto texturesFs = rtti::createInstance<DirReadCountingFileSystem>(makeFileSystem({{"ui/button.png", "button"}}));
+        auto scriptsFs = rtti::createInstance<DirReadCountingFileSystem>(makeFileSystem({{"main.lua", "main"}}));
+
+        const io::VirtualFileSystemPtr vfs = io::createVirtualFileSystem();
+        ASSERT_TRUE(vfs->mount("/content/textures", texturesFs, io::VfsMountSettings{.cacheDirectoryContent = true}));
+        ASSERT_TRUE(vfs->mount("/content/scripts", scriptsFs));
+        ASSERT_TRUE(vfs->mount("/archives", makeFileSystem({{"file.txt", "content"}})));
+
+        std::vector<io::FileChangeEvent> changes;
+        const Result<io::FileWatcherPtr> watcher = vfs->watch("/content", [&changes](std::span<const io::FileChangeEvent> newChanges)
+        {
+            changes.insert(changes.end(), newChanges.begin(), newChanges.end());
+        });
+        ASSERT_TRUE(watcher);
+        ASSERT_TRUE(texturesFs->getWatchPath().isEmpty());
+        ASSERT_TRUE(scriptsFs->getWatchPath().isEmpty());
+
+        ASSERT_EQ(getDirectoryNames(*vfs, "/content/textures/ui"), std::vector<std::string>{"button.png"});
+        ASSERT_EQ(texturesFs->getOpenDirCount(), 1);
+
+        texturesFs->notifyChanges({{"ui/button.png", io::FileChangeKind::Modified}});
+        scriptsFs->notifyChanges({{"main.lua", io::FileChangeKind::Removed}});
+
+        ASSERT_EQ(changes.size(), 2);
+        ASSERT_EQ(changes[0].path, io::FsPath{"/content/textures/ui/button.png"});
+        ASSERT_EQ(changes[0].kind, io::FileChangeKind::Modified);
+        ASSERT_EQ(changes[1].path, io::FsPath{"/content/scripts/main.lua"});
+        ASSERT_EQ(changes[1].kind, io::FileChangeKind::Removed);
+
+        ASSERT_EQ(getDirectoryNames(*vfs, "/content/textures/ui"), std::vector<std::string>{"button.png"});
+        ASSERT_EQ(texturesFs->getOpenDirCount(), 2);
+
+        // the path within the mount point
+        ASSERT_TRUE(vfs->watch("/content/textures/ui", [](std::span<const io::FileChangeEvent>)
+        {
+        }));
+        ASSERT_EQ(texturesFs->getWatchPath(), io::FsPath{"ui"});
+
+        // archives can not be watched
+        ASSERT_FALSE(vfs->watch("/archives", [](std::span<const io::FileChangeEvent>)
+        {
+        }));
+    }
+
+    TEST_F(TestVirtualFileSystem, ParallelLookup)
+    {
+        constexpr size_t MountsCount = 64;
+        constexpr size_t ThreadsCount = 8;
+
+        const io::VirtualFileSystemPtr vfs = io::createVirtualFileSystem();
+        for (size_t i = 0; i < MountsCount; ++i)
+        {
+            ASSERT_TRUE(vfs->mount(std::format("/content/pack_{}", i), makeFileSystem({{"file.txt", std::format("content {}", i)}})));
+        }
+
+        std::atomic<size_t> failuresCount = 0;
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < ThreadsCount; ++t)
+        {
+            threads.emplace_back([&, t]
+            {
+                for (size_t i = 0; i < MountsCount * 16; ++i)
+                {
+                    const size_t index = (i + t) % MountsCount;
+                    if (readContent(vfs->openFile(std::format("/content/pack_{}/file.txt", index), io::AccessMode::Read, io::OpenFileMode::OpenExisting)) != std::format("content {}", index))
+                    {
+                        ++failuresCount;
+                    }
+                }
+            });
+        }
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        ASSERT_EQ(failuresCount, 0);
+    }
+}  // namespace my::test
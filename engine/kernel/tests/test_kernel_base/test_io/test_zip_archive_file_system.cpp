@@ -0,0 +1,255 @@
+// #my_engine_source_file
+
+#include "my/async/thread_pool_executor.h"
+#include "my/io/memory_stream.h"
+#include "my/io/zip_archive_file_system.h"
+#include "my/test/helpers/runtime_guard.h"
+#include "my/test/helpers/zip_archive_builder.h"
+
+using namespace testing;
+
+namespace my::test
+{
+    class TestZipArchiveFileSystem : public testing::Test
+    {
+    protected:
+        using Method = ZipArchiveBuilder::Method;
+
+        static io::FileSystemPtr openArchive(const ZipArchiveBuilder& builder, io::ZipArchiveFileSystemSettings settings = {})
+        {
+            return io::createZipArchiveFileSystem(io::createMemoryStream(builder.build(), io::AccessMode::Read), std::move(settings));
+        }
+
+        static std::string readContent(const io::FilePtr& file)
+        {
+            const io::StreamPtr stream = file->createStream(io::AccessMode::Read);
+            std::string result(file->getSize(), '\0');
+            const Result<size_t> readResult = stream->read(reinterpret_cast<std::byte*>(result.data()), result.size());
+            return readResult ? result.substr(0, *readResult) : std::string{};
+        }
+
+        static std::string makeContent(size_t index)
+        {
+            return std::format("content of the entry [{}]: aaaaaaaaaaaaaaaaaaaaa {}", index, std::string(index % 64, 'z'));
+        }
+    };
+
+    TEST_F(TestZipArchiveFileSystem, OpenStoredFile)
+    {
+        ZipArchiveBuilder builder;
+        builder.addFile("data/config.json", "{\"value\": 1}");
+        builder.addFile("readme.txt", "readme");
+
+        const io::FileSystemPtr fs = openArchive(builder);
+        ASSERT_TRUE(fs);
+        ASSERT_TRUE(fs->isReadOnly());
+
+        const io::FilePtr file = fs->openFile("data/config.json", io::AccessMode::Read, io::OpenFileMode::OpenExisting);
+        ASSERT_TRUE(file);
+        ASSERT_EQ(readContent(file), "{\"value\": 1}");
+        ASSERT_TRUE(file->supports(io::IFile::FileFeature::MemoryMapping));
+
+        ASSERT_TRUE(fs->openFile("/readme.txt", io::AccessMode::Read, io::OpenFileMode::OpenExisting));
+        ASSERT_FALSE(fs->openFile("data/unknown.txt", io::AccessMode::Read, io::OpenFileMode::OpenExisting));
+    }
+
+    /**
+        Stored entries must refer to the archive's memory.
+     */
+    TEST_F(TestZipArchiveFileSystem, StoredFileIsZeroCopy)
+    {
+        ZipArchiveBuilder builder;
+        builder.addFile("file.bin", "stored content");
+
+        const io::MemoryStreamPtr stream = io::createMemoryStream(builder.build(), io::AccessMode::Read);
+        const std::span<const std::byte> archiveData = stream->getBufferAsSpan(0, std::nullopt);
+
+        const io::FileSystemPtr fs = io::createZipArchiveFileSystem(stream, io::ZipArchiveFileSystemSettings{});
+        ASSERT_TRUE(fs);
+
+        const io::FilePtr file = fs->openFile("file.bin", io::AccessMode::Read, io::OpenFileMode::OpenExisting);
+        ASSERT_TRUE(file);
+
+        const auto* const ptr = reinterpret_cast<const std::byte*>(file->as<io::IMemoryMappableObject&>().memMap(0, file->getSize()));
+        ASSERT_GE(ptr, archiveData.data());
+        ASSERT_LE(ptr + file->getSize(), archiveData.data() + archiveData.size());
+    }
+
+    TEST_F(TestZipArchiveFileSystem, OpenDeflatedFile)
+    {
+        const std::string content = std::format("{}{}{}", std::string(1000, 'a'), "some text in the middle \xF0\x9F\x98\x80", std::string(100, 'b'));
+
+        ZipArchiveBuilder builder;
+        builder.addFile("compressed.txt", content, Method::Deflated);
+
+        const io::FileSystemPtr fs = openArchive(builder);
+        ASSERT_TRUE(fs);
+
+        for (int i = 0; i < 2; ++i)
+        {  // second open is served from the cache
+            const io::FilePtr file = fs->openFile("compressed.txt", io::AccessMode::Read, io::OpenFileMode::OpenExisting);
+            ASSERT_TRUE(file);
+            ASSERT_EQ(file->getSize(), content.size());
+            ASSERT_EQ(readContent(file), content);
+        }
+    }
+
+    TEST_F(TestZipArchiveFileSystem, CorruptedDeflatedFile)
+    {
+        ZipArchiveBuilder builder;
+        builder.addFile("compressed.txt", "some text that will be damaged", Method::Deflated);
+
+        Buffer archive = builder.build();
+        // local header (30 bytes) + name (14 bytes), then the deflated data
+        reinterpret_cast<uint8_t*>(archive.data())[30 + 14 + 3] ^= 0x55;
+
+        const io::FileSystemPtr fs = io::createZipArchiveFileSystem(io::createMemoryStream(std::move(archive), io::AccessMode::Read), io::ZipArchiveFileSystemSettings{});
+        ASSERT_TRUE(fs);
+        ASSERT_FALSE(fs->openFile("compressed.txt", io::AccessMode::Read, io::OpenFileMode::OpenExisting));
+    }
+
+    TEST_F(TestZipArchiveFileSystem, Exists)
+    {
+        ZipArchiveBuilder builder;
+        builder.addDirectory("empty_dir");
+        builder.addFile("data/textures/stone.dds", "stone");
+
+        const io::FileSystemPtr fs = openArchive(builder);
+        ASSERT_TRUE(fs);
+
+        ASSERT_TRUE(fs->exists("data/textures/stone.dds", io::FsEntryKind::File));
+        ASSERT_FALSE(fs->exists("data/textures/stone.dds", io::FsEntryKind::Directory));
+        ASSERT_TRUE(fs->exists("data/textures", io::FsEntryKind::Directory));
+        ASSERT_TRUE(fs->exists("empty_dir", io::FsEntryKind::Directory));
+        ASSERT_TRUE(fs->exists("/"));
+        ASSERT_FALSE(fs->exists("data/tex"));
+    }
+
+    TEST_F(TestZipArchiveFileSystem, IterateDirectory)
+    {
+        ZipArchiveBuilder builder;
+        builder.addFile("data/textures/stone.dds", "stone");
+        builder.addFile("data/config.json", "{}", Method::Deflated);
+        builder.addFile("data/textures/grass.dds", "grass");
+        builder.addFile("data/sounds/step.wav", "step");
+        builder.addFile("readme.txt", "readme");
+
+        const io::FileSystemPtr fs = openArchive(builder);
+        ASSERT_TRUE(fs);
+
+        std::vector<std::string> entries;
+        io::DirectoryIterator dirIterator{fs, "data"};
+        for (const io::FsEntry& entry : dirIterator)
+        {
+            entries.push_back(std::format("{}:{}", entry.path.getString(), entry.kind == io::FsEntryKind::Directory ? "dir" : "file"));
+        }
+
+        ASSERT_THAT(entries, ElementsAre("data/config.json:file", "data/sounds:dir", "data/textures:dir"));
+    }
+
+    TEST_F(TestZipArchiveFileSystem, LastWriteTime)
+    {
+        ZipArchiveBuilder builder;
+        builder.addFile("file.txt", "text");
+
+        const io::FileSystemPtr fs = openArchive(builder);
+        ASSERT_TRUE(fs);
+
+        using namespace std::chrono;
+        const auto expectedTime = sys_days{year{2024} / May / 17} + hours{12} + minutes{30};
+        ASSERT_EQ(fs->getLastWriteTime("file.txt"), static_cast<size_t>(duration_cast<seconds>(expectedTime.time_since_epoch()).count()));
+    }
+
+    TEST_F(TestZipArchiveFileSystem, BasePath)
+    {
+        ZipArchiveBuilder builder;
+        builder.addFile("content/data/config.json", "{}");
+        builder.addFile("content/readme.txt", "readme");
+        builder.addFile("other/file.txt", "other");
+
+        const io::FileSystemPtr fs = openArchive(builder, {.basePath = "content"});
+        ASSERT_TRUE(fs);
+
+        ASSERT_TRUE(fs->exists("data/config.json"));
+        ASSERT_TRUE(fs->exists("readme.txt"));
+        ASSERT_FALSE(fs->exists("other/file.txt"));
+        ASSERT_FALSE(fs->exists("content/readme.txt"));
+    }
+
+    TEST_F(TestZipArchiveFileSystem, Prefetch)
+    {
+        constexpr size_t EntriesCount = 200;
+
+        const RuntimeGuard::Ptr runtime = RuntimeGuard::create();
+
+        ZipArchiveBuilder builder;
+        std::vector<io::FsPath> paths;
+        for (size_t i = 0; i < EntriesCount; ++i)
+        {
+            paths.emplace_back(std::format("entries/entry_{}.txt", i));
+            builder.addFile(paths.back().getString(), makeContent(i), Method::Deflated);
+        }
+
+        const io::FileSystemPtr fs = openArchive(builder, {.inflateExecutor = async::createThreadPoolExecutor(4)});
+        ASSERT_TRUE(fs);
+        ASSERT_EQ(fs->as<io::IZipArchiveFileSystem&>().getEntriesCount(), EntriesCount + 1);
+
+        async::Task<> prefetchTask = fs->as<io::IZipArchiveFileSystem&>().prefetch(paths);
+        ASSERT_TRUE(async::wait(prefetchTask, std::chrono::seconds(10)));
+        ASSERT_FALSE(prefetchTask.isRejected());
+
+        for (size_t i = 0; i < EntriesCount; ++i)
+        {
+            const io::FilePtr file = fs->openFile(paths[i], io::AccessMode::Read, io::OpenFileMode::OpenExisting);
+            ASSERT_TRUE(file);
+            ASSERT_EQ(readContent(file), makeContent(i));
+        }
+    }
+
+    /**
+        Concurrent opening of the same deflated entries: every thread must get the valid content.
+     */
+    TEST_F(TestZipArchiveFileSystem, ConcurrentOpen)
+    {
+        constexpr size_t EntriesCount = 50;
+        constexpr size_t ThreadsCount = 8;
+
+        ZipArchiveBuilder builder;
+        for (size_t i = 0; i < EntriesCount; ++i)
+        {
+            builder.addFile(std::format("entry_{}.txt", i), makeContent(i), Method::Deflated);
+        }
+
+        const io::FileSystemPtr fs = openArchive(builder, {.maxCacheSize = 1024});
+        ASSERT_TRUE(fs);
+
+        std::atomic<size_t> failuresCount = 0;
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < ThreadsCount; ++t)
+        {
+            threads.emplace_back([&]
+            {
+                for (size_t i = 0; i < EntriesCount; ++i)
+                {
+                    const io::FilePtr file = fs->openFile(std::format("entry_{}.txt", i), io::AccessMode::Read, io::OpenFileMode::OpenExisting);
+                    if (!file || readContent(file) != makeContent(i))
+                    {
+                        ++failuresCount;
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        ASSERT_EQ(failuresCount, 0);
+    }
+
+    TEST_F(TestZipArchiveFileSystem, InvalidArchive)
+    {
+        ASSERT_FALSE(io::createZipArchiveFileSystem(io::createMemoryStream(fromStringView("not a zip archive"), io::AccessMode::Read), io::ZipArchiveFileSystemSettings{}));
+    }
+}  // namespace my::test
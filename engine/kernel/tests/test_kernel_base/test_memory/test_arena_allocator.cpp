@@ -0,0 +1,171 @@
+// #my_engine_source_file
+#include "my/async/task.h"
+#include "my/memory/arena_allocator.h"
+#include "my/memory/buffer.h"
+#include "my/serialization/runtime_value_builder.h"
+
+namespace my::test
+{
+    /**
+     */
+    TEST(TestArenaAllocator, AllocateAndReset)
+    {
+        const ArenaAllocatorPtr arena = createArenaAllocator();
+        ASSERT_TRUE(arena);
+
+        std::vector<void*> ptrs;
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            void* const ptr = arena->alloc(100 + i % 50);
+            ASSERT_NE(ptr, nullptr);
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % IAllocator::DefaultAlignment, 0);
+            memset(ptr, 0xAB, 100);
+            ptrs.push_back(ptr);
+        }
+
+        EXPECT_GE(arena->getUsedSize(), 100'000);
+
+        arena->reset();
+        EXPECT_EQ(arena->getUsedSize(), 0);
+
+        // Memory is reused after reset.
+        EXPECT_EQ(arena->alloc(100), ptrs.front());
+    }
+
+    /**
+     */
+    TEST(TestArenaAllocator, Alignment)
+    {
+        const ArenaAllocatorPtr arena = createArenaAllocator();
+
+        for (size_t align = 1; align <= arena->getMaxAlignment(); align *= 2)
+        {
+            [[maybe_unused]] void* const unaligned = arena->alloc(1, 1);
+            void* const ptr = arena->alloc(10, align);
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % align, 0);
+        }
+    }
+
+    /**
+     */
+    TEST(TestArenaAllocator, OversizedAllocation)
+    {
+        const ArenaAllocatorPtr arena = createArenaAllocator(Kilobyte(16));
+
+        void* const ptr = arena->alloc(Kilobyte(100));
+        ASSERT_NE(ptr, nullptr);
+        memset(ptr, 0, Kilobyte(100));
+
+        void* const smallPtr = arena->alloc(16);
+        ASSERT_NE(smallPtr, nullptr);
+
+        arena->reset();
+        EXPECT_EQ(arena->getUsedSize(), 0);
+    }
+
+    /**
+     */
+    TEST(TestArenaAllocator, Realloc)
+    {
+        const ArenaAllocatorPtr arena = createArenaAllocator();
+
+        void* ptr = arena->realloc(nullptr, 8);
+        memset(ptr, 0x11, 8);
+
+        // The most recent allocation grows in place.
+        void* const grownPtr = arena->realloc(ptr, 64);
+        EXPECT_EQ(grownPtr, ptr);
+
+        [[maybe_unused]] void* const otherPtr = arena->alloc(32);
+        void* const movedPtr = arena->realloc(grownPtr, 1024);
+        EXPECT_NE(movedPtr, grownPtr);
+
+        const auto* const bytes = reinterpret_cast<const uint8_t*>(movedPtr);
+        EXPECT_TRUE(std::all_of(bytes, bytes + 8, [](uint8_t b)
+        {
+            return b == 0x11;
+        }));
+    }
+
+    /**
+     */
+    TEST(TestArenaAllocator, StdContainer)
+    {
+        const ArenaAllocatorPtr arena = createArenaAllocator();
+
+        {
+            std::pmr::vector<std::pmr::string> container{arena->GetMemoryResource()};
+            for (size_t i = 0; i < 1000; ++i)
+            {
+                container.emplace_back(std::format("Test Text Long Enough To Not Fit Into The Small String Buffer [{}]", i));
+            }
+        }
+
+        arena->reset();
+    }
+
+    /**
+     */
+    TEST(TestArenaAllocator, Buffer)
+    {
+        const ArenaAllocatorPtr arena = createArenaAllocator();
+
+        {
+            Buffer buffer{100, arena.get()};
+            ASSERT_TRUE(buffer);
+            EXPECT_GT(arena->getUsedSize(), 100);
+
+            memset(buffer.data(), 0x22, buffer.size());
+            buffer.resize(10'000);
+            EXPECT_EQ(*reinterpret_cast<const uint8_t*>(buffer.data()), 0x22);
+            EXPECT_GT(arena->getUsedSize(), 10'000);
+
+            ReadOnlyBuffer readOnlyBuffer = buffer.toReadOnly();
+            EXPECT_EQ(readOnlyBuffer.size(), 10'000);
+        }
+
+        arena->reset();
+    }
+
+    /**
+     */
+    TEST(TestArenaAllocator, RuntimeValue)
+    {
+        const ArenaAllocatorPtr arena = createArenaAllocator();
+
+        {
+            const RuntimeValuePtr value = makeValueCopy(std::vector<unsigned>{1, 2, 3}, arena.get());
+            ASSERT_TRUE(value);
+            EXPECT_GT(arena->getUsedSize(), 0);
+
+            const auto result = runtimeValueCast<std::vector<unsigned>>(value);
+            ASSERT_TRUE(result);
+            EXPECT_EQ(result->size(), 3);
+        }
+
+        arena->reset();
+    }
+
+    /**
+     */
+    TEST(TestArenaAllocator, CoroutineFrame)
+    {
+        const ArenaAllocatorPtr arena = createArenaAllocator();
+
+        const auto handleRequest = [](std::allocator_arg_t, IAllocator& allocator) -> async::Task<size_t>
+        {
+            co_return static_cast<IArenaAllocator&>(allocator).getUsedSize();
+        };
+
+        async::Task<size_t> task = handleRequest(std::allocator_arg, *arena);
+        ASSERT_TRUE(task.isReady());
+
+        const Result<size_t> usedSizeWithinCoroutine = task.asResult();
+        ASSERT_TRUE(usedSizeWithinCoroutine);
+        EXPECT_GT(*usedSizeWithinCoroutine, 0);
+
+        task = nullptr;
+        arena->reset();
+    }
+
+}  // namespace my::test
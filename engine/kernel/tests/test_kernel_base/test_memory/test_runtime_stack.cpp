@@ -145,4 +145,161 @@ namespace my::test
         }
     }
 
+    TEST(TestRuntimeStack, ChainSegments)
+    {
+        const CheckGuard noAssert{};
+        constexpr size_t BlockSize = 1000;
+        constexpr size_t BlockCount = 1000;  // requires more than single 64Kb segment
+
+        rtstack_init(64_Kb);
+        auto& allocator = GetRtStackAllocator();
+
+        const uintptr_t initialOffset = allocator.as<const IStackAllocatorInfo&>().getAllocationOffset();
+        {
+            rtstack_scope;
+
+            std::vector<void*> ptrs;
+            for (size_t i = 0; i < BlockCount; ++i)
+            {
+                void* const ptr = allocator.alloc(BlockSize);
+                ASSERT_NE(ptr, nullptr);
+                memset(ptr, static_cast<int>(i & 0xFF), BlockSize);
+                ptrs.push_back(ptr);
+            }
+
+            for (size_t i = 0; i < BlockCount; ++i)
+            {
+                const auto* const bytes = reinterpret_cast<const uint8_t*>(ptrs[i]);
+                ASSERT_TRUE(std::all_of(bytes, bytes + BlockSize, [i](uint8_t b)
+                {
+                    return b == static_cast<uint8_t>(i & 0xFF);
+                }));
+            }
+
+            for (void* const ptr : ptrs)
+            {
+                allocator.free(ptr);
+            }
+        }
+
+        EXPECT_EQ(allocator.as<const IStackAllocatorInfo&>().getAllocationOffset(), initialOffset);
+        EXPECT_NE(allocator.alloc(BlockSize), nullptr);
+    }
+
+    TEST(TestRuntimeStack, OversizedAllocation)
+    {
+        const CheckGuard noAssert{};
+        constexpr size_t OversizedBlockSize = 1_Mb;
+
+        for (const bool heapFallback : {true, false})
+        {
+            const RuntimeStackGuard stackGuard{64_Kb, heapFallback};
+            auto& allocator = GetRtStackAllocator();
+            {
+                rtstack_scope;
+                void* const ptr = allocator.alloc(OversizedBlockSize);
+                ASSERT_NE(ptr, nullptr);
+                memset(ptr, 0, OversizedBlockSize);
+
+                void* const smallPtr = allocator.alloc(16);
+                ASSERT_NE(smallPtr, nullptr);
+
+                allocator.free(smallPtr);
+                allocator.free(ptr);
+            }
+
+            EXPECT_GE(allocator.as<const IStackAllocatorInfo&>().getHighWaterMark(), OversizedBlockSize);
+        }
+    }
+
+    TEST(TestRuntimeStack, ThreadHighWaterMark)
+    {
+        RuntimeStackGuard::resetThreadHighWaterMark();
+        EXPECT_EQ(RuntimeStackGuard::getThreadHighWaterMark(), 0);
+
+        {
+            rtstack_init(64_Kb);
+            void* const ptr = GetRtStackAllocator().alloc(10'000);
+            GetRtStackAllocator().free(ptr);
+        }
+
+        const size_t highWaterMark = RuntimeStackGuard::getThreadHighWaterMark();
+        EXPECT_GE(highWaterMark, 10'000);
+
+        {
+            rtstack_init(64_Kb);
+            void* const ptr = GetRtStackAllocator().alloc(100);
+            GetRtStackAllocator().free(ptr);
+        }
+
+        EXPECT_EQ(RuntimeStackGuard::getThreadHighWaterMark(), highWaterMark);
+
+        // high water mark is tracked per thread
+        std::thread([]
+        {
+            EXPECT_EQ(RuntimeStackGuard::getThreadHighWaterMark(), 0);
+        }).join();
+    }
+
+#if MY_DEBUG_ASSERT_ENABLED
+    TEST(TestRuntimeStack, TrackFreedAllocations)
+    {
+        const CheckGuard checkGuard;
+        {
+            rtstack_init(2_Mb);
+            void* const ptr0 = GetRtStackAllocator().alloc(32);
+            {
+                rtstack_scope;
+                void* const ptr1 = GetRtStackAllocator().alloc(100);
+                memset(ptr1, 0, 100);
+                GetRtStackAllocator().free(ptr1);
+
+                // Allocation of the outer scope can be freed within the nested one.
+                GetRtStackAllocator().free(ptr0);
+            }
+        }
+
+        EXPECT_TRUE(checkGuard.noFailures());
+    }
+
+    TEST(TestRuntimeStack, DetectLeak)
+    {
+        const CheckGuard checkGuard;
+        {
+            rtstack_init(2_Mb);
+            [[maybe_unused]] void* const ptr = GetRtStackAllocator().alloc(32);
+        }
+
+        EXPECT_FALSE(checkGuard.noFailures());
+    }
+
+    TEST(TestRuntimeStack, DetectDoubleFree)
+    {
+        const CheckGuard checkGuard;
+        {
+            rtstack_init(2_Mb);
+            void* const ptr = GetRtStackAllocator().alloc(32);
+            GetRtStackAllocator().free(ptr);
+            ASSERT_TRUE(checkGuard.noFailures());
+
+            GetRtStackAllocator().free(ptr);
+        }
+
+        EXPECT_FALSE(checkGuard.noFailures());
+    }
+
+    TEST(TestRuntimeStack, DetectOverrun)
+    {
+        const CheckGuard checkGuard;
+        {
+            rtstack_init(2_Mb);
+            void* const ptr = GetRtStackAllocator().alloc(30);
+            memset(ptr, 0, 31);
+            GetRtStackAllocator().free(ptr);
+        }
+
+        EXPECT_FALSE(checkGuard.noFailures());
+    }
+#endif
+
 }  // namespace my::test
@@ -0,0 +1,274 @@
+// #my_engine_source_file
+#include "my/memory/small_block_allocator.h"
+#include "my/threading/barrier.h"
+
+namespace my::test
+{
+    namespace
+    {
+        class CountingHostMemory final : public IHostMemory
+        {
+        public:
+            MemRegion allocPages(size_t size) override
+            {
+                ++m_allocatedCount;
+                return m_memory->allocPages(size);
+            }
+
+            void freePages(MemRegion&& pages) override
+            {
+                --m_allocatedCount;
+                m_memory->freePages(std::move(pages));
+            }
+
+            Byte getPageSize() const override
+            {
+                return m_memory->getPageSize();
+            }
+
+            Byte getAllocationGranularity() const override
+            {
+                return m_memory->getAllocationGranularity();
+            }
+
+            int64_t getAllocatedCount() const
+            {
+                return m_allocatedCount;
+            }
+
+        private:
+            const HostMemoryPtr m_memory = createCrtHostMemory(true);
+            std::atomic<int64_t> m_allocatedCount = 0;
+        };
+    }  // namespace
+
+    /**
+     */
+    TEST(TestSmallBlockAllocator, SimpleAllocation)
+    {
+        constexpr std::array BlockSize = {1, 8, 16, 100, 256, 1000, 4096, 20000, 32768, 100000};
+        constexpr size_t IterCount = 1'000;
+        constexpr size_t RequiredAlignment = 16;
+
+        const AllocatorPtr allocator = createSmallBlockAllocator();
+        ASSERT_NE(allocator, nullptr);
+        EXPECT_GE(allocator->getMaxAlignment(), RequiredAlignment);
+
+        for (size_t i = 0; i < IterCount; ++i)
+        {
+            std::array<void*, BlockSize.size()> ptrs;
+            for (size_t s = 0; s < BlockSize.size(); ++s)
+            {
+                void* const ptr = allocator->alloc(BlockSize[s]);
+                ASSERT_NE(ptr, nullptr);
+                EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % RequiredAlignment, 0);
+                memset(ptr, static_cast<int>(s), BlockSize[s]);
+                ptrs[s] = ptr;
+            }
+
+            for (size_t s = 0; s < BlockSize.size(); ++s)
+            {
+                const auto* const bytes = reinterpret_cast<const uint8_t*>(ptrs[s]);
+                ASSERT_TRUE(std::all_of(bytes, bytes + BlockSize[s], [s](uint8_t b)
+                {
+                    return b == static_cast<uint8_t>(s);
+                }));
+                allocator->free(ptrs[s]);
+            }
+        }
+    }
+
+    /**
+     */
+    TEST(TestSmallBlockAllocator, Realloc)
+    {
+        const AllocatorPtr allocator = createSmallBlockAllocator();
+
+        void* ptr = allocator->alloc(8);
+        memset(ptr, 0x5A, 8);
+
+        for (size_t size = 16; size <= 256 * 1024; size *= 2)
+        {
+            ptr = allocator->realloc(ptr, size);
+            ASSERT_NE(ptr, nullptr);
+
+            const auto* const bytes = reinterpret_cast<const uint8_t*>(ptr);
+            ASSERT_TRUE(std::all_of(bytes, bytes + 8, [](uint8_t b)
+            {
+                return b == 0x5A;
+            }));
+        }
+
+        ptr = allocator->realloc(ptr, 24);
+        ASSERT_NE(ptr, nullptr);
+        EXPECT_EQ(*reinterpret_cast<const uint8_t*>(ptr), 0x5A);
+
+        allocator->free(ptr);
+    }
+
+    /**
+     */
+    TEST(TestSmallBlockAllocator, StdContainer)
+    {
+        using Container = std::pmr::vector<std::pmr::string>;
+        constexpr size_t ContainerSize = 2'000;
+
+        const AllocatorPtr allocator = createSmallBlockAllocator();
+        std::pmr::memory_resource* const memResource = allocator->GetMemoryResource();
+        ASSERT_NE(memResource, nullptr);
+
+        Container container{memResource};
+        size_t counter = 0;
+        for (; container.size() < ContainerSize;)
+        {
+            container.emplace_back(std::format("Test Text Long Enough To Not Fit Into The Small String Buffer [{}]", ++counter));
+        }
+    }
+
+    /**
+        Blocks are allocated on one thread and released on another (remote free path).
+     */
+    TEST(TestSmallBlockAllocator, CrossThreadFree)
+    {
+        constexpr size_t ThreadCount = 8;
+        constexpr size_t IterationCount = 20'000;
+
+        const AllocatorPtr allocator = createSmallBlockAllocator();
+
+        std::vector<std::vector<void*>> threadBlocks(ThreadCount);
+        std::vector<std::thread> threads;
+        threading::Barrier barrier(ThreadCount);
+
+        for (size_t i = 0; i < ThreadCount; ++i)
+        {
+            threads.emplace_back([&, i]
+            {
+                barrier.enter();
+
+                std::vector<void*>& blocks = threadBlocks[i];
+                blocks.reserve(IterationCount);
+                for (size_t j = 0; j < IterationCount; ++j)
+                {
+                    const size_t size = 16 + (i * IterationCount + j) % 2048;
+                    void* const ptr = allocator->alloc(size);
+                    memset(ptr, 0, size);
+                    blocks.push_back(ptr);
+                }
+            });
+        }
+
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+
+        threads.clear();
+
+        for (size_t i = 0; i < ThreadCount; ++i)
+        {
+            threads.emplace_back([&allocator](std::vector<void*>& blocks)
+            {
+                for (void* const ptr : blocks)
+                {
+                    allocator->free(ptr);
+                }
+            }, std::ref(threadBlocks[(i + 1) % ThreadCount]));
+        }
+
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+
+        // Heaps of the finished threads must be reused (and remote frees reclaimed) by the new threads.
+        std::thread([&allocator]
+        {
+            for (size_t i = 0; i < IterationCount; ++i)
+            {
+                void* const ptr = allocator->alloc(64);
+                ASSERT_NE(ptr, nullptr);
+                allocator->free(ptr);
+            }
+        }).join();
+    }
+
+    /**
+        Empty spans and segments are returned back to the host memory.
+     */
+    TEST(TestSmallBlockAllocator, ReleaseToHostMemory)
+    {
+        constexpr size_t BlockCount = 10'000;
+        constexpr size_t BlockSize = 4096;
+
+        auto hostMemory = std::make_shared<CountingHostMemory>();
+        {
+            const AllocatorPtr allocator = createSmallBlockAllocator(hostMemory);
+
+            std::vector<void*> blocks;
+            for (size_t i = 0; i < BlockCount; ++i)
+            {
+                blocks.push_back(allocator->alloc(BlockSize));
+            }
+
+            const int64_t peakCount = hostMemory->getAllocatedCount();
+            ASSERT_GT(peakCount, 2);
+
+            for (void* const ptr : blocks)
+            {
+                allocator->free(ptr);
+            }
+
+            EXPECT_LT(hostMemory->getAllocatedCount(), peakCount);
+
+            const int64_t countBeforeLargeAlloc = hostMemory->getAllocatedCount();
+            void* const largePtr = allocator->alloc(1024 * 1024);
+            EXPECT_EQ(hostMemory->getAllocatedCount(), countBeforeLargeAlloc + 1);
+            allocator->free(largePtr);
+            EXPECT_EQ(hostMemory->getAllocatedCount(), countBeforeLargeAlloc);
+        }
+
+        EXPECT_EQ(hostMemory->getAllocatedCount(), 0);
+    }
+
+
+    /**
+        Fully unused segment is kept as the spare one and reused by the next span acquisition.
+     */
+    TEST(TestSmallBlockAllocator, ReuseSpareSegment)
+    {
+        // 64 blocks per 256 Kb span, 32 spans per segment: two segments are fully used.
+        constexpr size_t BlockCount = 2 * 32 * 64;
+        constexpr size_t BlockSize = 4096;
+
+        auto hostMemory = std::make_shared<CountingHostMemory>();
+        const AllocatorPtr allocator = createSmallBlockAllocator(hostMemory);
+
+        std::vector<void*> blocks;
+        for (size_t i = 0; i < BlockCount; ++i)
+        {
+            blocks.push_back(allocator->alloc(BlockSize));
+        }
+
+        ASSERT_EQ(hostMemory->getAllocatedCount(), 2);
+
+        for (void* const ptr : blocks)
+        {
+            allocator->free(ptr);
+        }
+
+        // one span per size class is kept by the thread heap, the other segment is the spare one
+        ASSERT_EQ(hostMemory->getAllocatedCount(), 2);
+
+        for (void*& ptr : blocks)
+        {
+            ptr = allocator->alloc(BlockSize);
+        }
+
+        ASSERT_EQ(hostMemory->getAllocatedCount(), 2);
+
+        for (void* const ptr : blocks)
+        {
+            allocator->free(ptr);
+        }
+    }
+}  // namespace my::test
@@ -0,0 +1,213 @@
+// #my_engine_source_file
+#include "my/async/task.h"
+#include "my/network/connection_pool.h"
+#include "my/test/helpers/runtime_guard.h"
+
+using namespace my::async;
+using namespace my::network;
+using namespace std::chrono_literals;
+
+namespace my::test {
+
+class TestConnectionPool : public testing::Test
+{
+protected:
+    static Address serverAddress()
+    {
+        return *AddressFromString("inet://127.0.0.1:8747");
+    }
+
+    static Task<> serveEcho(io::AsyncStreamPtr stream)
+    {
+        while (true)
+        {
+            Result<Buffer> data = co_await stream->read().doTry();
+            if (!data || data->size() == 0)
+            {
+                break;
+            }
+
+            if (!co_await stream->write(data->toReadOnly()).doTry())
+            {
+                break;
+            }
+        }
+    }
+
+    /**
+        Keeps every accepted connection so the test can close it from the server side.
+     */
+    static Task<> acceptLoop(Ptr<IListener> listener, std::shared_ptr<std::vector<io::AsyncStreamPtr>> accepted)
+    {
+        while (io::AsyncStreamPtr stream = co_await listener->accept())
+        {
+            accepted->push_back(stream);
+            serveEcho(stream).detach();
+        }
+    }
+
+    static Task<std::string> exchange(io::AsyncStreamPtr stream, std::string message)
+    {
+        co_await stream->write(fromStringView(message).toReadOnly());
+        Buffer data = co_await stream->read();
+        co_return std::string{asStringView(data)};
+    }
+
+    void SetUp() override
+    {
+        Result<Ptr<IListener>> listener = async::waitResult(network::listen(serverAddress()));
+        ASSERT_TRUE(listener);
+        m_listener = *listener;
+        acceptLoop(m_listener, m_accepted).detach();
+    }
+
+    void TearDown() override
+    {
+        if (m_pool)
+        {
+            m_pool->dispose();
+            m_pool.reset();
+        }
+
+        m_listener.reset();
+        m_runtime.reset();
+    }
+
+    io::AsyncStreamPtr acquire(Expiration expiration = Expiration::never())
+    {
+        Result<io::AsyncStreamPtr> stream = async::waitResult(m_pool->acquire(serverAddress(), std::move(expiration)));
+        return stream ? *stream : nullptr;
+    }
+
+    RuntimeGuard::Ptr m_runtime = RuntimeGuard::create();
+    Ptr<IListener> m_listener;
+    std::shared_ptr<std::vector<io::AsyncStreamPtr>> m_accepted = std::make_shared<std::vector<io::AsyncStreamPtr>>();
+    ConnectionPoolPtr m_pool;
+};
+
+TEST_F(TestConnectionPool, ReuseReleasedConnection)
+{
+    m_pool = createConnectionPool();
+
+    io::AsyncStreamPtr stream = acquire();
+    ASSERT_TRUE(stream);
+    ASSERT_EQ(*async::waitResult(exchange(stream, "first")), "first");
+    stream.reset();
+
+    const ConnectionPoolStats stats = m_pool->getStats(serverAddress());
+    ASSERT_EQ(stats.connectionsCount, 1);
+    ASSERT_EQ(stats.idleCount, 1);
+
+    stream = acquire();
+    ASSERT_TRUE(stream);
+    ASSERT_EQ(*async::waitResult(exchange(stream, "second")), "second");
+    ASSERT_EQ(m_accepted->size(), 1);
+}
+
+TEST_F(TestConnectionPool, WaitForReleasedConnection)
+{
+    m_pool = createConnectionPool({.maxConnectionsPerHost = 1});
+
+    io::AsyncStreamPtr stream = acquire();
+    ASSERT_TRUE(stream);
+
+    Task<io::AsyncStreamPtr> first = m_pool->acquire(serverAddress());
+    Task<io::AsyncStreamPtr> second = m_pool->acquire(serverAddress());
+    Task<bool> anyReady = whenAny(Expiration{20ms}, first, second);
+    async::wait(anyReady);
+    ASSERT_FALSE(first.isReady());
+    ASSERT_FALSE(second.isReady());
+    ASSERT_EQ(m_pool->getStats(serverAddress()).waitersCount, 2);
+
+    // waiters are served in the acquire() order
+    stream.reset();
+    async::wait(first);
+    ASSERT_FALSE(second.isReady());
+
+    stream = *first;
+    ASSERT_TRUE(stream);
+    ASSERT_EQ(*async::waitResult(exchange(stream, "data")), "data");
+
+    stream.reset();
+    stream = *async::waitResult(std::move(second));
+    ASSERT_TRUE(stream);
+    ASSERT_EQ(m_accepted->size(), 1);
+}
+
+TEST_F(TestConnectionPool, WaitExpiration)
+{
+    m_pool = createConnectionPool({.maxConnectionsPerHost = 1});
+
+    io::AsyncStreamPtr stream = acquire();
+    ASSERT_TRUE(stream);
+
+    Result<io::AsyncStreamPtr> expired = async::waitResult(m_pool->acquire(serverAddress(), Expiration{10ms}));
+    ASSERT_FALSE(expired);
+    ASSERT_EQ(m_pool->getStats(serverAddress()).waitersCount, 0);
+}
+
+TEST_F(TestConnectionPool, DisposeRejectsWaiters)
+{
+    m_pool = createConnectionPool({.maxConnectionsPerHost = 1});
+
+    io::AsyncStreamPtr stream = acquire();
+    ASSERT_TRUE(stream);
+
+    Task<io::AsyncStreamPtr> waiting = m_pool->acquire(serverAddress(), Expiration{50ms});
+    Task<bool> ready = whenAny(Expiration{10ms}, waiting);
+    async::wait(ready);
+    ASSERT_FALSE(waiting.isReady());
+
+    // the expiration must not reject the waiter that is already rejected by dispose
+    m_pool->dispose();
+    ASSERT_FALSE(async::waitResult(std::move(waiting)));
+
+    Task<> delay = []() -> Task<>
+    {
+        co_await 60ms;
+    }();
+    async::wait(delay);
+}
+
+TEST_F(TestConnectionPool, DisposedConnectionIsNotReused)
+{
+    m_pool = createConnectionPool();
+
+    io::AsyncStreamPtr stream = acquire();
+    ASSERT_TRUE(stream);
+    stream->as<IDisposable&>().dispose();
+    stream.reset();
+
+    ASSERT_EQ(m_pool->getStats(serverAddress()).connectionsCount, 0);
+
+    stream = acquire();
+    ASSERT_TRUE(stream);
+    ASSERT_EQ(*async::waitResult(exchange(stream, "data")), "data");
+    ASSERT_EQ(m_accepted->size(), 2);
+}
+
+TEST_F(TestConnectionPool, ClosedByServerIsNotReused)
+{
+    m_pool = createConnectionPool();
+
+    io::AsyncStreamPtr stream = acquire();
+    ASSERT_TRUE(stream);
+    ASSERT_EQ(*async::waitResult(exchange(stream, "data")), "data");
+    stream.reset();
+    ASSERT_EQ(m_pool->getStats(serverAddress()).idleCount, 1);
+
+    // close server side of the idle connection and give the pool time to observe it
+    m_accepted->front()->as<IDisposable&>().dispose();
+    Task<> delay = []() -> Task<>
+    {
+        co_await 20ms;
+    }();
+    async::wait(delay);
+
+    stream = acquire();
+    ASSERT_TRUE(stream);
+    ASSERT_EQ(*async::waitResult(exchange(stream, "data")), "data");
+    ASSERT_EQ(m_accepted->size(), 2);
+}
+
+}  // namespace my::test
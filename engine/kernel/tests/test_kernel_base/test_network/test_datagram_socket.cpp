@@ -0,0 +1,192 @@
+// #my_engine_source_file
+#include "my/network/network.h"
+#include "my/test/helpers/runtime_guard.h"
+
+using namespace my::async;
+using namespace my::network;
+
+namespace my::test {
+
+class TestDatagramSocket : public testing::Test
+{
+protected:
+    virtual void TearDown()
+    {
+        m_runtime.reset();
+    }
+
+    static Buffer makeDatagram(size_t size, uint8_t fill)
+    {
+        Buffer buffer{size};
+        memset(buffer.data(), fill, size);
+        return buffer;
+    }
+
+    static bool checkDatagram(const Buffer& buffer, size_t size, uint8_t fill)
+    {
+        const auto* const bytes = reinterpret_cast<const uint8_t*>(buffer.data());
+        return buffer.size() == size && std::all_of(bytes, bytes + size, [fill](uint8_t b)
+        {
+            return b == fill;
+        });
+    }
+
+    RuntimeGuard::Ptr m_runtime = RuntimeGuard::create();
+};
+
+TEST_F(TestDatagramSocket, Bind)
+{
+    Result<Ptr<IDatagramSocket>> socket = waitResult(bindDatagramSocket(*AddressFromString("inet://127.0.0.1:0")));
+    ASSERT_TRUE(socket);
+    ASSERT_TRUE(*socket);
+
+    EXPECT_TRUE((*socket)->getLocalAddress());
+}
+
+TEST_F(TestDatagramSocket, SendReceiveLoopback)
+{
+    auto task = []() -> Task<testing::AssertionResult>
+    {
+        Ptr<IDatagramSocket> receiver = co_await bindDatagramSocket(*AddressFromString("inet://127.0.0.1:0"));
+        Ptr<IDatagramSocket> sender = co_await bindDatagramSocket(*AddressFromString("inet://127.0.0.1:0"));
+
+        co_await sender->send(makeDatagram(100, 0x5A).toReadOnly(), receiver->getLocalAddress());
+
+        Datagram datagram = co_await receiver->receive();
+        if (!checkDatagram(datagram.data, 100, 0x5A))
+        {
+            co_return testing::AssertionFailure() << "Unexpected datagram content";
+        }
+
+        if (!datagram.address)
+        {
+            co_return testing::AssertionFailure() << "Sender address expected";
+        }
+
+        // reply to the sender
+        co_await receiver->send(makeDatagram(10, 0x11).toReadOnly(), datagram.address);
+        Datagram reply = co_await sender->receive();
+        if (!checkDatagram(reply.data, 10, 0x11))
+        {
+            co_return testing::AssertionFailure() << "Unexpected reply content";
+        }
+
+        co_return testing::AssertionSuccess();
+    }();
+
+    async::wait(task);
+    ASSERT_FALSE(task.isRejected());
+    ASSERT_TRUE(*task);
+}
+
+/**
+    Test: received datagram's buffer can grow beyond the maximum datagram size.
+ */
+TEST_F(TestDatagramSocket, AppendToReceivedDatagram)
+{
+    auto task = []() -> Task<testing::AssertionResult>
+    {
+        Ptr<IDatagramSocket> receiver = co_await bindDatagramSocket(*AddressFromString("inet://127.0.0.1:0"));
+        Ptr<IDatagramSocket> sender = co_await bindDatagramSocket(*AddressFromString("inet://127.0.0.1:0"));
+
+        co_await sender->send(makeDatagram(100, 0x5A).toReadOnly(), receiver->getLocalAddress());
+
+        Datagram datagram = co_await receiver->receive();
+        if (!checkDatagram(datagram.data, 100, 0x5A))
+        {
+            co_return testing::AssertionFailure() << "Unexpected datagram content";
+        }
+
+        constexpr size_t AppendSize = DatagramSocketOptions{}.maxDatagramSize * 4;
+        memset(datagram.data.append(AppendSize), 0x5A, AppendSize);
+        if (!checkDatagram(datagram.data, 100 + AppendSize, 0x5A))
+        {
+            co_return testing::AssertionFailure() << "Unexpected appended datagram content";
+        }
+
+        co_return testing::AssertionSuccess();
+    }();
+
+    async::wait(task);
+    ASSERT_FALSE(task.isRejected());
+    ASSERT_TRUE(*task);
+}
+
+TEST_F(TestDatagramSocket, BatchSend)
+{
+    constexpr size_t DatagramCount = 32;
+
+    auto task = []() -> Task<testing::AssertionResult>
+    {
+        Ptr<IDatagramSocket> receiver = co_await bindDatagramSocket(*AddressFromString("inet://127.0.0.1:0"));
+        Ptr<IDatagramSocket> sender = co_await bindDatagramSocket(*AddressFromString("inet://127.0.0.1:0"));
+
+        const Address receiverAddress = receiver->getLocalAddress();
+        std::vector<OutboundDatagram> datagrams;
+        for (size_t i = 0; i < DatagramCount; ++i)
+        {
+            datagrams.emplace_back(makeDatagram(100 + i, static_cast<uint8_t>(i)).toReadOnly(), receiverAddress);
+        }
+
+        co_await sender->send(std::move(datagrams));
+
+        for (size_t i = 0; i < DatagramCount; ++i)
+        {
+            Datagram datagram = co_await receiver->receive();
+            if (!checkDatagram(datagram.data, 100 + i, static_cast<uint8_t>(i)))
+            {
+                co_return testing::AssertionFailure() << std::format("Unexpected datagram ({})", i);
+            }
+        }
+
+        co_return testing::AssertionSuccess();
+    }();
+
+    async::wait(task);
+    ASSERT_FALSE(task.isRejected());
+    ASSERT_TRUE(*task);
+}
+
+TEST_F(TestDatagramSocket, DisposeWhileReceiving)
+{
+    Ptr<IDatagramSocket> socket = *waitResult(bindDatagramSocket(*AddressFromString("inet://127.0.0.1:0")));
+    ASSERT_TRUE(socket);
+
+    Task<Datagram> receiveTask = socket->receive();
+    socket->dispose();
+
+    async::wait(receiveTask);
+    ASSERT_TRUE(receiveTask.isRejected());
+}
+
+TEST_F(TestDatagramSocket, MulticastLoopback)
+{
+    Ptr<IDatagramSocket> receiver = *waitResult(bindDatagramSocket(*AddressFromString("inet://*:18745"), {.reuseAddress = true, .multicastLoopback = true}));
+    ASSERT_TRUE(receiver);
+
+    if (Result<> joinResult = waitResult(receiver->joinMulticastGroup(*AddressFromString("inet://239.255.43.21"))); !joinResult)
+    {
+        GTEST_SKIP() << "Multicast is not available";
+    }
+
+    auto task = [](IDatagramSocket& receiver) -> Task<testing::AssertionResult>
+    {
+        Ptr<IDatagramSocket> sender = co_await bindDatagramSocket(*AddressFromString("inet://*:0"));
+        co_await sender->send(makeDatagram(64, 0x77).toReadOnly(), *AddressFromString("inet://239.255.43.21:18745"));
+
+        Datagram datagram = co_await receiver.receive();
+        if (!checkDatagram(datagram.data, 64, 0x77))
+        {
+            co_return testing::AssertionFailure() << "Unexpected datagram content";
+        }
+
+        co_await receiver.leaveMulticastGroup(*AddressFromString("inet://239.255.43.21"));
+        co_return testing::AssertionSuccess();
+    }(*receiver);
+
+    ASSERT_TRUE(async::wait(task, std::chrono::seconds(5)));
+    ASSERT_FALSE(task.isRejected());
+    ASSERT_TRUE(*task);
+}
+
+}  // namespace my::test
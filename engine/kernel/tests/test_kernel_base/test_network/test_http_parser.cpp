@@ -267,4 +267,76 @@ TEST(TestHttpParser, FailParseHeaders)
     ASSERT_FALSE(parser);
 }
 
+
+TEST(TestHttpParser, StartLine)
+{
+    constexpr std::string_view buffer = "GET http://localhost:8080/path HTTP/1.1\r\nHost: localhost:8080\r\n\r\nbody";
+
+    const HttpParser parser(buffer);
+    ASSERT_TRUE(parser);
+    EXPECT_THAT(parser.getStartLine(), Eq("GET http://localhost:8080/path HTTP/1.1"));
+    EXPECT_THAT(parser.headersCount(), Eq(1));
+    EXPECT_THAT(parser["host"], Eq("localhost:8080"));
+    EXPECT_THAT(parser.headersLength(), Eq(buffer.size() - 4));
+}
+
+/**
+    Data is received by the parts and the receive buffer is reallocated: parsing must be resumed with the same result.
+ */
+TEST(TestHttpParser, IncrementalParse)
+{
+    const std::string head = std::format("POST /resource HTTP/1.1\r\nContent-Type: application/json\r\nX-Long: {}\r\nContent-Length: 48\r\n\r\n", std::string(100, 'x'));
+
+    for (const size_t step : {size_t{1}, size_t{5}, size_t{31}, size_t{64}})
+    {
+        HttpParser parser;
+        std::string received;
+        for (size_t offset = 0; offset < head.size(); offset += step)
+        {
+            received.append(head.substr(offset, step));
+            received.shrink_to_fit();
+
+            const HttpParser::ParseStatus status = parser.parse(received);
+            ASSERT_THAT(status, Eq(offset + step >= head.size() ? HttpParser::ParseStatus::Complete : HttpParser::ParseStatus::NeedMoreData));
+        }
+
+        ASSERT_TRUE(parser);
+        EXPECT_THAT(parser.getStartLine(), Eq("POST /resource HTTP/1.1"));
+        EXPECT_THAT(parser.headersCount(), Eq(3));
+        EXPECT_THAT(parser.headerAt(0).key, Eq("Content-Type"));
+        EXPECT_THAT(parser.headerAt(1).value, Eq(std::string(100, 'x')));
+        EXPECT_THAT(parser.contentLength(), Eq(48));
+        EXPECT_THAT(parser.headersLength(), Eq(head.size()));
+    }
+}
+
+TEST(TestHttpParser, FailParseInvalidHeaderLine)
+{
+    const HttpParser parser("GET / HTTP/1.1\r\nHost: localhost\r\nNot a header\r\n\r\n");
+    ASSERT_FALSE(parser);
+    ASSERT_THAT(parser.getStatus(), Eq(HttpParser::ParseStatus::Invalid));
+
+    const HttpParser foldedParser("GET / HTTP/1.1\r\nX-Folded: first\r\n second\r\n\r\n");
+    ASSERT_THAT(foldedParser.getStatus(), Eq(HttpParser::ParseStatus::Invalid));
+}
+
+/**
+    Content-Length defines the message framing: the value that can be read differently by the other http implementations is rejected.
+ */
+TEST(TestHttpParser, FailParseInvalidContentLength)
+{
+    for (const std::string_view value : {"abc", "12abc", "", "-1", "99999999999999999999999"})
+    {
+        const HttpParser parser(std::format("POST / HTTP/1.1\r\nContent-Length: {}\r\n\r\n", value));
+        EXPECT_THAT(parser.getStatus(), Eq(HttpParser::ParseStatus::Invalid)) << value;
+    }
+
+    const HttpParser conflictingParser("POST / HTTP/1.1\r\nContent-Length: 10\r\nContent-Length: 12\r\n\r\n");
+    EXPECT_THAT(conflictingParser.getStatus(), Eq(HttpParser::ParseStatus::Invalid));
+
+    const HttpParser duplicateParser("POST / HTTP/1.1\r\nContent-Length: 10\r\ncontent-length: 10\r\n\r\n");
+    ASSERT_TRUE(duplicateParser);
+    EXPECT_THAT(duplicateParser.contentLength(), Eq(10));
+}
+
 }  // namespace my::test
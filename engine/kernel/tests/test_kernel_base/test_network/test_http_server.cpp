@@ -0,0 +1,317 @@
+// #my_engine_source_file
+#include "my/async/task.h"
+#include "my/network/http_server.h"
+#include "my/test/helpers/runtime_guard.h"
+
+using namespace my::async;
+using namespace my::network;
+using namespace std::chrono_literals;
+
+namespace my::test {
+
+namespace {
+
+Address httpTestAddress()
+{
+    return *AddressFromString("inet://127.0.0.1:8746");
+}
+
+/**
+    Sends the raw request data and reads the response until the server closes the connection.
+ */
+Task<std::string> httpExchange(std::string requestData)
+{
+    io::AsyncStreamPtr client = co_await network::connect(httpTestAddress());
+    co_await client->write(fromStringView(requestData).toReadOnly());
+
+    std::string response;
+    while (true)
+    {
+        Buffer data = co_await client->read();
+        if (data.size() == 0)
+        {
+            break;
+        }
+
+        response.append(asStringView(data));
+    }
+
+    co_return response;
+}
+
+size_t countOccurrences(std::string_view str, std::string_view pattern)
+{
+    size_t count = 0;
+    for (size_t pos = str.find(pattern); pos != std::string_view::npos; pos = str.find(pattern, pos + pattern.size()))
+    {
+        ++count;
+    }
+
+    return count;
+}
+
+}  // namespace
+
+TEST(TestHttpRequestReader, SplitHead)
+{
+    constexpr std::string_view Request = "GET /path?x=1 HTTP/1.1\r\nHost: localhost\r\nX-Custom:  value \r\n\r\n";
+
+    HttpRequestReader reader;
+    for (size_t i = 0; i < Request.size() - 1; ++i)
+    {
+        reader.append(Request.substr(i, 1));
+        const Result<std::optional<HttpRequest>> request = reader.next();
+        ASSERT_TRUE(request);
+        ASSERT_FALSE(*request);
+    }
+
+    reader.append(Request.substr(Request.size() - 1));
+    Result<std::optional<HttpRequest>> request = reader.next();
+    ASSERT_TRUE(request);
+    ASSERT_TRUE(*request);
+
+    const HttpRequest& req = **request;
+    ASSERT_EQ(req.method, "GET");
+    ASSERT_EQ(req.target, "/path?x=1");
+    ASSERT_EQ(req.getPath(), "/path");
+    ASSERT_EQ(req.getQuery(), "x=1");
+    ASSERT_EQ(req.getHeader("host"), "localhost");
+    ASSERT_EQ(req.getHeader("X-CUSTOM"), "value");
+    ASSERT_TRUE(req.isKeepAlive());
+    ASSERT_FALSE(reader.hasPendingData());
+}
+
+TEST(TestHttpRequestReader, Pipelined)
+{
+    HttpRequestReader reader;
+    reader.append(
+        "POST /first HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello"
+        "GET /second HTTP/1.0\r\n\r\n"
+        "GET /third HTTP/1.1\r\nConnection: close\r\n\r\n");
+
+    Result<std::optional<HttpRequest>> first = reader.next();
+    ASSERT_TRUE(first && *first);
+    ASSERT_EQ((*first)->target, "/first");
+    ASSERT_EQ((*first)->getBodyAsString(), "hello");
+
+    Result<std::optional<HttpRequest>> second = reader.next();
+    ASSERT_TRUE(second && *second);
+    ASSERT_EQ((*second)->target, "/second");
+    ASSERT_EQ((*second)->versionMinor, 0);
+    ASSERT_FALSE((*second)->isKeepAlive());
+
+    Result<std::optional<HttpRequest>> third = reader.next();
+    ASSERT_TRUE(third && *third);
+    ASSERT_EQ((*third)->target, "/third");
+    ASSERT_FALSE((*third)->isKeepAlive());
+
+    Result<std::optional<HttpRequest>> none = reader.next();
+    ASSERT_TRUE(none);
+    ASSERT_FALSE(*none);
+}
+
+TEST(TestHttpRequestReader, ChunkedBody)
+{
+    constexpr std::string_view Request =
+        "POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+        "5\r\nhello\r\n"
+        "7;ext=1\r\n, world\r\n"
+        "0\r\nX-Trailer: done\r\n\r\n";
+
+    // feed with the different split sizes
+    for (const size_t step : {size_t{1}, size_t{3}, size_t{7}, Request.size()})
+    {
+        HttpRequestReader reader;
+        std::optional<HttpRequest> request;
+        for (size_t offset = 0; offset < Request.size() && !request; offset += step)
+        {
+            reader.append(Request.substr(offset, step));
+            Result<std::optional<HttpRequest>> next = reader.next();
+            ASSERT_TRUE(next);
+            request = std::move(*next);
+        }
+
+        ASSERT_TRUE(request);
+        ASSERT_EQ(request->getBodyAsString(), "hello, world");
+        ASSERT_EQ(request->getHeader("X-Trailer"), "done");
+    }
+}
+
+TEST(TestHttpRequestReader, ChunkedLinesAtEndOfRead)
+{
+    // each chunk size and trailer line is the last received data: the line is parsed after the whole buffer is consumed
+    HttpRequestReader reader;
+    const auto appendAndRead = [&reader](std::string_view data)
+    {
+        reader.append(data);
+        return reader.next();
+    };
+
+    Result<std::optional<HttpRequest>> next = appendAndRead("POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n");
+    ASSERT_TRUE(next && !*next);
+
+    for (const std::string_view data : {"5\r\n", "hello\r\n", "7;ext=1\r\n", ", world\r\n", "0\r\n", "X-Trailer: done\r\n"})
+    {
+        next = appendAndRead(data);
+        ASSERT_TRUE(next && !*next);
+    }
+
+    next = appendAndRead("\r\n");
+    ASSERT_TRUE(next && *next);
+    ASSERT_EQ((*next)->getBodyAsString(), "hello, world");
+    ASSERT_EQ((*next)->getHeader("X-Trailer"), "done");
+    ASSERT_FALSE(reader.hasPendingData());
+}
+
+TEST(TestHttpRequestReader, Errors)
+{
+    const auto readError = [](std::string_view data, HttpRequestReader::Limits limits = {}) -> unsigned
+    {
+        HttpRequestReader reader{limits};
+        reader.append(data);
+        return reader.next() ? 0 : reader.getErrorStatus();
+    };
+
+    ASSERT_EQ(readError("GET\r\n\r\n"), 400);
+    ASSERT_EQ(readError("GET / FTP/1.1\r\n\r\n"), 400);
+    ASSERT_EQ(readError("GET / HTTP/2.0\r\n\r\n"), 505);
+    ASSERT_EQ(readError("POST / HTTP/1.1\r\nContent-Length: abc\r\n\r\n"), 400);
+    ASSERT_EQ(readError("POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n"), 501);
+    ASSERT_EQ(readError("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nxyz\r\n"), 400);
+    ASSERT_EQ(readError("POST / HTTP/1.1\r\nContent-Length: 100\r\n\r\n", {.maxBodySize = 10}), 413);
+    ASSERT_EQ(readError(std::format("GET / HTTP/1.1\r\nX-Large: {}", std::string(256, 'x')), {.maxHeadersSize = 128}), 431);
+}
+
+TEST(TestHttpResponse, SerializeHead)
+{
+    HttpResponse response{200, "content"};
+    response.setHeader("X-Custom", "1");
+
+    const Buffer head = serializeHttpResponseHead(response, false);
+    const std::string_view headStr = asStringView(head);
+
+    ASSERT_TRUE(headStr.starts_with("HTTP/1.1 200 OK\r\n"));
+    ASSERT_NE(headStr.find("Content-Type: text/plain\r\n"), std::string_view::npos);
+    ASSERT_NE(headStr.find("X-Custom: 1\r\n"), std::string_view::npos);
+    ASSERT_NE(headStr.find("Content-Length: 7\r\n"), std::string_view::npos);
+    ASSERT_NE(headStr.find("Connection: close\r\n"), std::string_view::npos);
+    ASSERT_TRUE(headStr.ends_with("\r\n\r\n"));
+}
+
+class TestHttpServer : public testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        if (m_server)
+        {
+            m_server->dispose();
+        }
+
+        m_runtime.reset();
+    }
+
+    void startServer(HttpServerOptions options = {})
+    {
+        Result<Ptr<IHttpServer>> server = async::waitResult(startHttpServer(httpTestAddress(), options));
+        ASSERT_TRUE(server);
+        m_server = *server;
+
+        m_server->addRoute("GET", "/hello", [](HttpRequest) -> Task<HttpResponse>
+        {
+            co_return HttpResponse{200, "Hello"};
+        });
+
+        m_server->addRoute("POST", "/echo", [](HttpRequest request) -> Task<HttpResponse>
+        {
+            co_return HttpResponse{200, request.getBodyAsString()};
+        });
+
+        m_server->addRoute("", "/files/*", [](HttpRequest request) -> Task<HttpResponse>
+        {
+            co_return HttpResponse{200, request.getPath()};
+        });
+    }
+
+    RuntimeGuard::Ptr m_runtime = RuntimeGuard::create();
+    Ptr<IHttpServer> m_server;
+};
+
+TEST_F(TestHttpServer, Routes)
+{
+    ASSERT_NO_FATAL_FAILURE(startServer());
+
+    const std::string response = *async::waitResult(httpExchange("GET /hello HTTP/1.1\r\nConnection: close\r\n\r\n"));
+    ASSERT_TRUE(response.starts_with("HTTP/1.1 200 OK\r\n"));
+    ASSERT_TRUE(response.ends_with("\r\n\r\nHello"));
+
+    const std::string prefixResponse = *async::waitResult(httpExchange("DELETE /files/a/b HTTP/1.1\r\nConnection: close\r\n\r\n"));
+    ASSERT_TRUE(prefixResponse.ends_with("\r\n\r\n/files/a/b"));
+
+    const std::string notFound = *async::waitResult(httpExchange("GET /unknown HTTP/1.1\r\nConnection: close\r\n\r\n"));
+    ASSERT_TRUE(notFound.starts_with("HTTP/1.1 404 Not Found\r\n"));
+}
+
+TEST_F(TestHttpServer, PipelinedKeepAlive)
+{
+    ASSERT_NO_FATAL_FAILURE(startServer());
+
+    const std::string response = *async::waitResult(httpExchange(
+        "GET /hello HTTP/1.1\r\n\r\n"
+        "POST /echo HTTP/1.1\r\nContent-Length: 4\r\n\r\nping"
+        "POST /echo HTTP/1.1\r\nTransfer-Encoding: chunked\r\nConnection: close\r\n\r\n4\r\nlast\r\n0\r\n\r\n"));
+
+    ASSERT_EQ(countOccurrences(response, "HTTP/1.1 200 OK\r\n"), 3);
+
+    const size_t hello = response.find("Hello");
+    const size_t ping = response.find("ping");
+    const size_t last = response.find("last");
+    ASSERT_TRUE(hello < ping && ping < last && last != std::string::npos);
+}
+
+TEST_F(TestHttpServer, ChunkedResponse)
+{
+    ASSERT_NO_FATAL_FAILURE(startServer());
+
+    m_server->addRoute("GET", "/stream", [](HttpRequest) -> Task<HttpResponse>
+    {
+        HttpResponse response{200};
+        response.bodyStream = [counter = std::make_shared<size_t>(0)]() -> Task<ReadOnlyBuffer>
+        {
+            if (*counter == 3)
+            {
+                co_return ReadOnlyBuffer{};
+            }
+
+            co_return fromStringView(std::format("part{}", (*counter)++)).toReadOnly();
+        };
+
+        co_return response;
+    });
+
+    const std::string response = *async::waitResult(httpExchange("GET /stream HTTP/1.1\r\nConnection: close\r\n\r\n"));
+    ASSERT_NE(response.find("Transfer-Encoding: chunked\r\n"), std::string::npos);
+    ASSERT_TRUE(response.ends_with("\r\n\r\n5\r\npart0\r\n5\r\npart1\r\n5\r\npart2\r\n0\r\n\r\n"));
+}
+
+TEST_F(TestHttpServer, BadRequestClosesConnection)
+{
+    ASSERT_NO_FATAL_FAILURE(startServer({.maxBodySize = 16}));
+
+    const std::string badRequest = *async::waitResult(httpExchange("NOT A REQUEST\r\n\r\n"));
+    ASSERT_TRUE(badRequest.starts_with("HTTP/1.1 400 Bad Request\r\n"));
+
+    const std::string tooLarge = *async::waitResult(httpExchange("POST /echo HTTP/1.1\r\nContent-Length: 1000\r\n\r\n"));
+    ASSERT_TRUE(tooLarge.starts_with("HTTP/1.1 413 Content Too Large\r\n"));
+}
+
+TEST_F(TestHttpServer, IdleTimeout)
+{
+    ASSERT_NO_FATAL_FAILURE(startServer({.idleTimeout = 50ms}));
+
+    // request is never completed: connection must be closed by the server
+    const std::string response = *async::waitResult(httpExchange("GET /hello HTTP/1.1\r\n"));
+    ASSERT_TRUE(response.empty());
+}
+
+}  // namespace my::test
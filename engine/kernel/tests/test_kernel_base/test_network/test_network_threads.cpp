@@ -0,0 +1,160 @@
+// #my_engine_source_file
+#include "my/async/task.h"
+#include "my/network/network.h"
+#include "my/test/helpers/runtime_guard.h"
+
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace my::async;
+using namespace my::network;
+using namespace std::chrono_literals;
+
+namespace my::test {
+
+namespace {
+
+/**
+    Runs the invocations in place: continuations of the socket operations are resumed on the socket's loop thread.
+ */
+class InlineExecutor final : public Executor
+{
+    MY_REFCOUNTED_CLASS(my::test::InlineExecutor, Executor)
+
+public:
+    void waitAnyActivity() noexcept override
+    {
+    }
+
+    void scheduleInvocation(Invocation invocation) noexcept override
+    {
+        invoke(*this, std::move(invocation));
+    }
+};
+
+}  // namespace
+
+class TestNetworkThreads : public testing::TestWithParam<ConnectionDistribution>
+{
+protected:
+    static constexpr size_t ThreadsCount = 3;
+    static constexpr size_t ClientsCount = 16;
+
+    Task<> serveEcho(io::AsyncStreamPtr stream)
+    {
+        ASYNC_SWITCH_EXECUTOR(m_inlineExecutor);
+
+        while (true)
+        {
+            Result<Buffer> data = co_await stream->read().doTry();
+            if (!data || data->size() == 0)
+            {
+                break;
+            }
+
+            {
+                const std::lock_guard lock{m_servingThreadsMutex};
+                m_servingThreads.insert(std::this_thread::get_id());
+            }
+
+            if (!co_await stream->write(data->toReadOnly()).doTry())
+            {
+                break;
+            }
+        }
+    }
+
+    Task<> acceptLoop(Ptr<IListener> listener)
+    {
+        while (io::AsyncStreamPtr stream = co_await listener->accept())
+        {
+            serveEcho(stream).detach();
+        }
+    }
+
+    static Task<std::string> exchange(Address serverAddress, std::string message)
+    {
+        io::AsyncStreamPtr client = co_await network::connect(std::move(serverAddress));
+        co_await client->write(fromStringView(message).toReadOnly());
+
+        std::string response;
+        while (response.size() < message.size())
+        {
+            Buffer data = co_await client->read();
+            if (data.size() == 0)
+            {
+                break;
+            }
+
+            response.append(asStringView(data));
+        }
+
+        co_return response;
+    }
+
+    void SetUp() override
+    {
+        ASSERT_TRUE(async::waitResult(startNetworkThreads(ThreadsCount)));
+
+        Result<Ptr<IListener>> listener = async::waitResult(network::listen(*AddressFromString("inet://127.0.0.1:0"), {.distribution = GetParam()}));
+        ASSERT_TRUE(listener);
+        m_listener = *listener;
+        acceptLoop(m_listener).detach();
+    }
+
+    void TearDown() override
+    {
+        if (m_listener)
+        {
+            m_listener->dispose();
+            m_listener.reset();
+        }
+
+        m_runtime.reset();
+    }
+
+    RuntimeGuard::Ptr m_runtime = RuntimeGuard::create();
+    Ptr<IListener> m_listener;
+    ExecutorPtr m_inlineExecutor = rtti::createInstance<InlineExecutor, Executor>();
+    std::set<std::thread::id> m_servingThreads;
+    std::mutex m_servingThreadsMutex;
+};
+
+TEST_P(TestNetworkThreads, Exchange)
+{
+    std::vector<Task<std::string>> exchanges;
+    for (size_t i = 0; i < ClientsCount; ++i)
+    {
+        exchanges.emplace_back(exchange(m_listener->getLocalAddress(), std::format("message-{}", i)));
+    }
+
+    for (size_t i = 0; i < ClientsCount; ++i)
+    {
+        Result<std::string> response = async::waitResult(std::move(exchanges[i]));
+        ASSERT_TRUE(response);
+        ASSERT_EQ(*response, std::format("message-{}", i));
+    }
+
+    const std::lock_guard lock{m_servingThreadsMutex};
+    ASSERT_GT(m_servingThreads.size(), 1);
+}
+
+TEST_P(TestNetworkThreads, ListenOnAnyPort)
+{
+    const Address localAddress = m_listener->getLocalAddress();
+    ASSERT_TRUE(localAddress);
+
+    Result<Address> anyPortAddress = AddressFromString("inet://127.0.0.1:0");
+    ASSERT_TRUE(anyPortAddress);
+    ASSERT_FALSE(localAddress == *anyPortAddress);
+}
+
+TEST_P(TestNetworkThreads, StartTwiceFails)
+{
+    ASSERT_FALSE(async::waitResult(startNetworkThreads(1)));
+}
+
+INSTANTIATE_TEST_SUITE_P(Default, TestNetworkThreads, testing::Values(ConnectionDistribution::RoundRobin, ConnectionDistribution::ReusePort));
+
+}  // namespace my::test
@@ -0,0 +1,294 @@
+// #my_engine_source_file
+
+#include "my/app/property_container.h"
+#include "my/io/file_system.h"
+#include "my/io/memory_stream.h"
+#include "my/meta/class_info.h"
+#include "my/serialization/config_blob.h"
+#include "my/serialization/json.h"
+#include "my/serialization/runtime_value_builder.h"
+
+#include <fstream>
+
+using namespace ::testing;
+
+namespace my::test
+{
+    namespace
+    {
+        struct ConfigBlobLogEntry
+        {
+            std::string kind;
+            std::string path;
+            std::vector<std::string> filter;
+            std::optional<std::string> formatter;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(kind),
+                CLASS_FIELD(path),
+                CLASS_FIELD(filter),
+                CLASS_FIELD(formatter))
+
+            bool operator==(const ConfigBlobLogEntry&) const = default;
+        };
+
+        struct ConfigBlobApp
+        {
+            std::string name;
+            int64_t threads = 0;
+            uint64_t memoryLimit = 0;
+            double scale = 0.;
+            bool enabled = false;
+            std::vector<ConfigBlobLogEntry> log;
+            std::map<std::string, int> counters;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(name),
+                CLASS_FIELD(threads),
+                CLASS_FIELD(memoryLimit),
+                CLASS_FIELD(scale),
+                CLASS_FIELD(enabled),
+                CLASS_FIELD(log),
+                CLASS_FIELD(counters))
+
+            bool operator==(const ConfigBlobApp&) const = default;
+        };
+
+        ConfigBlobApp makeConfigBlobApp()
+        {
+            return ConfigBlobApp{
+                .name = "AppBasicSample",
+                .threads = -4,
+                .memoryLimit = std::numeric_limits<uint64_t>::max(),
+                .scale = 1.25,
+                .enabled = true,
+                .log = {{.kind = "file", .path = "c:/log.txt", .filter = {"core", "render"}, .formatter = ""}, {.kind = "console", .path = "file"}},
+                .counters = {{"zeta", 1}, {"alpha", 2}, {"mid", 3}}};
+        }
+
+        ReadOnlyBuffer writeConfigBlob(const RuntimeValuePtr& value)
+        {
+            io::MemoryStreamPtr stream = io::createMemoryStream();
+            EXPECT_TRUE(serialization::configBlobWrite(*stream, value));
+
+            const auto bytes = stream->getBufferAsSpan();
+            Buffer buffer{bytes.size()};
+            memcpy(buffer.data(), bytes.data(), bytes.size());
+
+            return buffer.toReadOnly();
+        }
+
+        /**
+            In-memory file that counts the mappings: the values opened from the mapping must keep the file mapped.
+         */
+        class ConfigBlobTestFile final : public io::IFile,
+                                         public io::IMemoryMappableObject
+        {
+            MY_REFCOUNTED_CLASS(my::test::ConfigBlobTestFile, io::IFile, io::IMemoryMappableObject)
+
+        public:
+            ConfigBlobTestFile(ReadOnlyBuffer content, bool isMappable) :
+                m_content(std::move(content)),
+                m_isMappable(isMappable)
+            {
+            }
+
+            bool supports(FileFeature feature) const override
+            {
+                return feature == FileFeature::MemoryMapping && m_isMappable;
+            }
+
+            bool isOpened() const override
+            {
+                return true;
+            }
+
+            io::StreamBasePtr createStream(std::optional<io::AccessModeFlag>) override
+            {
+                ++streamsCount;
+                return io::createReadonlyMemoryStream({m_content.data(), m_content.size()});
+            }
+
+            io::AccessModeFlag getAccessMode() const override
+            {
+                return io::AccessMode::Read;
+            }
+
+            size_t getSize() const override
+            {
+                return m_content.size();
+            }
+
+            io::FsPath getPath() const override
+            {
+                return "/config.mycfg";
+            }
+
+            void* memMap(size_t offset, size_t) override
+            {
+                ++mapCount;
+                return const_cast<std::byte*>(m_content.data() + offset);
+            }
+
+            void memUnmap(const void*) override
+            {
+                ++unmapCount;
+            }
+
+            size_t mapCount = 0;
+            size_t unmapCount = 0;
+            size_t streamsCount = 0;
+
+        private:
+            const ReadOnlyBuffer m_content;
+            const bool m_isMappable;
+        };
+    }  // namespace
+
+    TEST(TestConfigBlob, RoundTrip)
+    {
+        const ConfigBlobApp source = makeConfigBlobApp();
+
+        Result<RuntimeValuePtr> blobValue = serialization::configBlobOpen(writeConfigBlob(makeValueRef(source)));
+        ASSERT_TRUE(blobValue);
+
+        ConfigBlobApp parsed;
+        ASSERT_TRUE(RuntimeValue::assign(makeValueRef(parsed), *blobValue));
+        ASSERT_EQ(parsed, source);
+    }
+
+    TEST(TestConfigBlob, DictionaryLookup)
+    {
+        Result<RuntimeValuePtr> config = serialization::jsonParseString(R"-({"b": 1, "a": {"z": null, "y": "text"}, "c": [1, 2.5, false]})-");
+        ASSERT_TRUE(config);
+
+        Result<RuntimeValuePtr> blobValue = serialization::configBlobOpen(writeConfigBlob(*config));
+        ASSERT_TRUE(blobValue);
+
+        auto& root = (*blobValue)->as<ReadonlyDictionary&>();
+        ASSERT_FALSE(root.isMutable());
+        ASSERT_EQ(root.getSize(), 3);
+
+        // members are sorted by key
+        ASSERT_EQ(root.getKey(0), "a");
+        ASSERT_EQ(root.getKey(1), "b");
+        ASSERT_EQ(root.getKey(2), "c");
+
+        ASSERT_TRUE(root.containsKey("c"));
+        ASSERT_FALSE(root.containsKey("d"));
+        ASSERT_FALSE(root.getValue("d"));
+
+        ASSERT_EQ(root.getValue("b")->as<const IntegerValue&>().getInt64(), 1);
+
+        auto& child = root.getValue("a")->as<ReadonlyDictionary&>();
+        ASSERT_EQ(child.getValue("y")->as<const StringValue&>().getString(), "text");
+        ASSERT_FALSE(child.getValue("z")->as<const OptionalValue&>().hasValue());
+
+        auto& collection = root.getValue("c")->as<ReadonlyCollection&>();
+        ASSERT_EQ(collection.getSize(), 3);
+        ASSERT_EQ(collection.getAt(1)->as<const FloatValue&>().getDouble(), 2.5);
+        ASSERT_FALSE(collection.getAt(2)->as<const BooleanValue&>().getBool());
+
+        ASSERT_FALSE(root.setValue("b", makeValueCopy(2)));
+        ASSERT_FALSE(collection.setAt(0, makeValueCopy(2)));
+    }
+
+    TEST(TestConfigBlob, InvalidData)
+    {
+        const std::string_view json = R"-({"value": 1})-";
+        ASSERT_FALSE(serialization::isConfigBlob({reinterpret_cast<const std::byte*>(json.data()), json.size()}));
+
+        ReadOnlyBuffer blob = writeConfigBlob(makeValueCopy(makeConfigBlobApp()));
+        ASSERT_TRUE(serialization::isConfigBlob({blob.data(), blob.size()}));
+
+        Buffer corrupted{blob.size()};
+        memcpy(corrupted.data(), blob.data(), blob.size());
+        corrupted.data()[0] = std::byte{0};
+        ASSERT_FALSE(serialization::configBlobOpen(corrupted.toReadOnly()));
+
+        Buffer truncated{blob.size() / 2};
+        memcpy(truncated.data(), blob.data(), truncated.size());
+        ASSERT_FALSE(serialization::configBlobOpen(truncated.toReadOnly()));
+    }
+
+    TEST(TestConfigBlob, MergeProperties)
+    {
+        Result<RuntimeValuePtr> config = serialization::jsonParseString(R"-({"app": {"name": "AppBasicSample", "window": {"title": "Sample", "width": 800}}})-");
+        ASSERT_TRUE(config);
+
+        const ReadOnlyBuffer blob = writeConfigBlob(*config);
+        io::StreamPtr stream = io::createReadonlyMemoryStream({blob.data(), blob.size()});
+
+        std::unique_ptr<PropertyContainer> properties = createPropertyContainer();
+        ASSERT_TRUE(mergePropertiesFromStream(*properties, *stream, serialization::ConfigBlobContentType));
+        ASSERT_EQ(properties->getValue<std::string>("app/name"), "AppBasicSample");
+        ASSERT_EQ(properties->getValue<std::string>("app/window/title"), "Sample");
+        ASSERT_EQ(properties->getValue<int>("app/window/width"), 800);
+    }
+
+    TEST(TestConfigBlob, OpenMappedFile)
+    {
+        Result<RuntimeValuePtr> config = serialization::jsonParseString(R"-({"app": {"name": "AppBasicSample", "ids": [1, 2, 3]}})-");
+        ASSERT_TRUE(config);
+
+        auto file = rtti::createInstance<ConfigBlobTestFile>(writeConfigBlob(*config), true);
+
+        Result<RuntimeValuePtr> blobValue = serialization::configBlobOpenFile(*file);
+        ASSERT_TRUE(blobValue);
+        ASSERT_EQ(file->mapCount, 1);
+        ASSERT_EQ(file->streamsCount, 0);
+
+        RuntimeValuePtr root = *std::move(blobValue);
+        RuntimeValuePtr ids = root->as<ReadonlyDictionary&>().getValue("app")->as<ReadonlyDictionary&>().getValue("ids");
+        ASSERT_EQ(ids->as<ReadonlyCollection&>().getSize(), 3);
+
+        // the child value keeps the file mapped
+        root.reset();
+        ASSERT_EQ(file->unmapCount, 0);
+        ASSERT_EQ(ids->as<ReadonlyCollection&>().getAt(2)->as<const IntegerValue&>().getInt64(), 3);
+
+        ids.reset();
+        ASSERT_EQ(file->unmapCount, 1);
+    }
+
+    TEST(TestConfigBlob, OpenNonMappableFile)
+    {
+        Result<RuntimeValuePtr> config = serialization::jsonParseString(R"-({"app": {"name": "AppBasicSample"}})-");
+        ASSERT_TRUE(config);
+
+        auto file = rtti::createInstance<ConfigBlobTestFile>(writeConfigBlob(*config), false);
+
+        Result<RuntimeValuePtr> blobValue = serialization::configBlobOpenFile(*file);
+        ASSERT_TRUE(blobValue);
+        ASSERT_EQ(file->mapCount, 0);
+        ASSERT_EQ(file->streamsCount, 1);
+
+        // the content is read into the own buffer: the file is not needed any more
+        file.reset();
+        auto& app = (*blobValue)->as<ReadonlyDictionary&>().getValue("app")->as<ReadonlyDictionary&>();
+        ASSERT_EQ(app.getValue("name")->as<const StringValue&>().getString(), "AppBasicSample");
+    }
+
+    TEST(TestConfigBlob, MergePropertiesFromFile)
+    {
+        Result<RuntimeValuePtr> config = serialization::jsonParseString(R"-({"app": {"name": "AppBasicSample", "window": {"width": 800}}})-");
+        ASSERT_TRUE(config);
+
+        const std::filesystem::path filePath = std::filesystem::temp_directory_path() / std::format("test_config_blob_{}.mycfg", ::testing::UnitTest::GetInstance()->random_seed());
+        {
+            const ReadOnlyBuffer blob = writeConfigBlob(*config);
+            std::ofstream stream{filePath, std::ios::binary | std::ios::trunc};
+            stream.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+        }
+
+        std::unique_ptr<PropertyContainer> properties = createPropertyContainer();
+        const Result<> mergeResult = mergePropertiesFromFile(*properties, filePath);
+
+        std::error_code ec;
+        std::filesystem::remove(filePath, ec);
+
+        ASSERT_TRUE(mergeResult);
+        ASSERT_EQ(properties->getValue<std::string>("app/name"), "AppBasicSample");
+        ASSERT_EQ(properties->getValue<int>("app/window/width"), 800);
+    }
+}  // namespace my::test
@@ -0,0 +1,297 @@
+// #my_engine_source_file
+
+#include "my/meta/class_info.h"
+#include "my/serialization/json_codec.h"
+#include "my/serialization/json_utils.h"
+#include "my/utils/perfect_hash.h"
+
+using namespace ::testing;
+
+namespace my::test
+{
+    namespace
+    {
+        MY_DEFINE_ENUM_(CodecTestKind, First, Second, Third)
+
+        struct CodecPoint
+        {
+            int x = 0;
+            int y = 0;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(x),
+                CLASS_FIELD(y))
+
+            bool operator==(const CodecPoint&) const = default;
+        };
+
+        struct CodecBaseData
+        {
+            unsigned id = 0;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(id, serialization::RequiredFieldAttribute{}))
+
+            bool operator==(const CodecBaseData&) const = default;
+        };
+
+        struct CodecData : CodecBaseData
+        {
+            MY_CLASS_BASE(CodecBaseData)
+
+            std::string name;
+            float weight = 0.f;
+            double ratio = 0.;
+            bool enabled = false;
+            CodecTestKind kind = CodecTestKind::First;
+            std::optional<int> optionalValue;
+            std::vector<CodecPoint> points;
+            std::map<std::string, int> values;
+            std::list<std::string> tags;
+            std::array<int, 3> triple = {};
+            std::tuple<int, std::string> pair;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(name),
+                CLASS_FIELD(weight),
+                CLASS_FIELD(ratio),
+                CLASS_FIELD(enabled),
+                CLASS_FIELD(kind),
+                CLASS_FIELD(optionalValue),
+                CLASS_FIELD(points),
+                CLASS_FIELD(values),
+                CLASS_FIELD(tags),
+                CLASS_FIELD(triple),
+                CLASS_NAMED_FIELD(pair, "pairValue"))
+
+            bool operator==(const CodecData&) const = default;
+        };
+
+        struct CodecCoercionData
+        {
+            uint64_t intField = 0;
+            std::string strField;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(intField, serialization::TypeCoercion::Allow),
+                CLASS_FIELD(strField, serialization::TypeCoercion::Allow))
+        };
+
+        struct CodecStrictData
+        {
+            uint64_t intField = 0;
+            std::string strField;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(intField, serialization::TypeCoercion::Strict),
+                CLASS_FIELD(strField, serialization::TypeCoercion::Strict))
+        };
+
+        struct CodecIgnoreEmptyData
+        {
+            std::string text;
+            std::vector<int> items;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(text, serialization::IgnoreEmptyFieldAttribute{}),
+                CLASS_FIELD(items, serialization::IgnoreEmptyFieldAttribute{}))
+        };
+
+        constexpr std::string_view CodecDataJson = R"--(
+            {
+                // comments are allowed
+                "id": 75,
+                "name": "test \"name\" ф",
+                "weight": 1.5,
+                "ratio": -2.25e2,
+                "enabled": true,
+                "kind": "Third",
+                "optionalValue": 11,
+                "points": [{"x": 1, "y": 2}, {"x": 3, "y": 4}],
+                "values": {"one": 1, "two": 2},
+                "tags": ["a", "b", "c"],
+                "triple": [7, 8, 9],
+                "pairValue": [5, "five"],
+                "unknownField": {"nested": [1, 2, {"x": null}]},
+            }
+        )--";
+
+        CodecData makeExpectedData()
+        {
+            CodecData data;
+            data.id = 75;
+            data.name = "test \"name\" \xD1\x84";
+            data.weight = 1.5f;
+            data.ratio = -225.;
+            data.enabled = true;
+            data.kind = CodecTestKind::Third;
+            data.optionalValue = 11;
+            data.points = {{1, 2}, {3, 4}};
+            data.values = {{"one", 1}, {"two", 2}};
+            data.tags = {"a", "b", "c"};
+            data.triple = {7, 8, 9};
+            data.pair = {5, "five"};
+
+            return data;
+        }
+
+    }  // namespace
+
+    TEST(TestJsonCodec, ParseObject)
+    {
+        const Result<CodecData> data = serialization::JsonCodec::parse<CodecData>(CodecDataJson);
+        ASSERT_TRUE(data);
+        ASSERT_EQ(*data, makeExpectedData());
+    }
+
+    TEST(TestJsonCodec, SameAsRuntimeValuePath)
+    {
+        constexpr std::string_view Json = R"--({"id": 1, "name": "text", "weight": 2.5, "enabled": true, "points": [{"x": 10, "y": 20}], "values": {"k": 3}})--";
+
+        const Result<CodecData> codecData = serialization::JsonCodec::parse<CodecData>(Json);
+        const Result<CodecData> runtimeData = serialization::JsonUtils::parse<CodecData>(Json);
+        ASSERT_TRUE(codecData);
+        ASSERT_TRUE(runtimeData);
+        ASSERT_EQ(*codecData, *runtimeData);
+    }
+
+    TEST(TestJsonCodec, RoundTrip)
+    {
+        const CodecData data = makeExpectedData();
+
+        for (const bool pretty : {false, true})
+        {
+            const std::string json = serialization::JsonCodec::stringify(data, {.pretty = pretty});
+            const Result<CodecData> parsedData = serialization::JsonCodec::parse<CodecData>(json);
+            ASSERT_TRUE(parsedData);
+            ASSERT_EQ(*parsedData, data);
+        }
+    }
+
+    TEST(TestJsonCodec, ReadableByRuntimeValuePath)
+    {
+        const CodecData data = makeExpectedData();
+        const std::string json = serialization::JsonCodec::stringify(data);
+
+        const Result<CodecData> parsedData = serialization::JsonUtils::parse<CodecData>(json);
+        ASSERT_TRUE(parsedData);
+        ASSERT_EQ(parsedData->points, data.points);
+        ASSERT_EQ(parsedData->values, data.values);
+        ASSERT_EQ(parsedData->name, data.name);
+    }
+
+    TEST(TestJsonCodec, WriteNulls)
+    {
+        CodecData data;
+        ASSERT_THAT(serialization::JsonCodec::stringify(data), Not(HasSubstr("optionalValue")));
+        ASSERT_THAT(serialization::JsonCodec::stringify(data, {.writeNulls = true}), HasSubstr(R"("optionalValue":null)"));
+    }
+
+    TEST(TestJsonCodec, IgnoreEmptyField)
+    {
+        CodecIgnoreEmptyData data;
+        ASSERT_EQ(serialization::JsonCodec::stringify(data), "{}");
+
+        data.items = {1, 2};
+        ASSERT_EQ(serialization::JsonCodec::stringify(data), R"({"items":[1,2]})");
+    }
+
+    TEST(TestJsonCodec, RequiredFieldMissed)
+    {
+        const Result<CodecData> data = serialization::JsonCodec::parse<CodecData>(R"({"name": "text"})");
+        ASSERT_FALSE(data);
+        ASSERT_TRUE(data.getError()->is<serialization::RequiredFieldMissedError>());
+    }
+
+    TEST(TestJsonCodec, NullResetsOptional)
+    {
+        CodecData data = makeExpectedData();
+        ASSERT_TRUE(serialization::JsonCodec::parse(data, R"({"id": 1, "optionalValue": null, "tags": null})"));
+        ASSERT_FALSE(data.optionalValue);
+        ASSERT_TRUE(data.tags.empty());
+    }
+
+    TEST(TestJsonCodec, TypeCoercion)
+    {
+        const Result<CodecCoercionData> data = serialization::JsonCodec::parse<CodecCoercionData>(R"({"intField": "12345", "strField": 77})");
+        ASSERT_TRUE(data);
+        ASSERT_EQ(data->intField, 12345);
+        ASSERT_EQ(data->strField, "77");
+
+        ASSERT_FALSE(serialization::JsonCodec::parse<CodecCoercionData>(R"({"intField": ""})"));
+    }
+
+    TEST(TestJsonCodec, StrictTypeCoercion)
+    {
+        ASSERT_TRUE(serialization::JsonCodec::parse<CodecStrictData>(R"({"intField": 12345, "strField": "text"})"));
+        ASSERT_FALSE(serialization::JsonCodec::parse<CodecStrictData>(R"({"intField": "12345"})"));
+        ASSERT_FALSE(serialization::JsonCodec::parse<CodecStrictData>(R"({"strField": 976854})"));
+    }
+
+    TEST(TestJsonCodec, NumericOverflow)
+    {
+        const Result<uint8_t> value = serialization::JsonCodec::parse<uint8_t>("256");
+        ASSERT_FALSE(value);
+        ASSERT_TRUE(value.getError()->is<serialization::NumericOverflowError>());
+        ASSERT_FALSE(serialization::JsonCodec::parse<unsigned>("-1"));
+
+        // 2^63 and 2^64 are the first float values out of range
+        ASSERT_FALSE(serialization::JsonCodec::parse<int64_t>("9223372036854775808.0"));
+        ASSERT_FALSE(serialization::JsonCodec::parse<uint64_t>("18446744073709551616.0"));
+
+        const Result<int64_t> minValue = serialization::JsonCodec::parse<int64_t>("-9223372036854775808.0");
+        ASSERT_TRUE(minValue);
+        ASSERT_EQ(*minValue, std::numeric_limits<int64_t>::min());
+
+        const Result<int> maxValue = serialization::JsonCodec::parse<int>("2147483647.5");
+        ASSERT_TRUE(maxValue);
+        ASSERT_EQ(*maxValue, std::numeric_limits<int>::max());
+    }
+
+    TEST(TestJsonCodec, InvalidJson)
+    {
+        ASSERT_FALSE(serialization::JsonCodec::parse<CodecPoint>(""));
+        ASSERT_FALSE(serialization::JsonCodec::parse<CodecPoint>(R"({"x": 1 "y": 2})"));
+        ASSERT_FALSE(serialization::JsonCodec::parse<CodecPoint>(R"({"x": 1, "y": 2)"));
+        ASSERT_FALSE(serialization::JsonCodec::parse<CodecPoint>(R"({"x": 1} {})"));
+        ASSERT_FALSE(serialization::JsonCodec::parse<CodecPoint>(R"({"x": "\q"})"));
+
+        for (const std::string_view number : {"1.", "1.e5", "1e", "1E+", "-1e-", "-"})
+        {
+            ASSERT_FALSE(serialization::JsonCodec::parse<double>(number)) << number;
+        }
+    }
+
+    TEST(TestJsonCodec, StringEscapes)
+    {
+        const std::string text = "quote\" backslash\\ tab\t newline\n control\x01 utf8\xD1\x84";
+        const std::string json = serialization::JsonCodec::stringify(text);
+        ASSERT_EQ(json, R"("quote\" backslash\\ tab\t newline\n control\u0001 utf8)" "\xD1\x84\"");
+
+        const Result<std::string> parsedText = serialization::JsonCodec::parse<std::string>(json);
+        ASSERT_TRUE(parsedText);
+        ASSERT_EQ(*parsedText, text);
+
+        const Result<std::string> surrogatePair = serialization::JsonCodec::parse<std::string>(R"("\ud83d\ude00")");
+        ASSERT_TRUE(surrogatePair);
+        ASSERT_EQ(*surrogatePair, "\xF0\x9F\x98\x80");
+    }
+
+    TEST(TestJsonCodec, PerfectHash)
+    {
+        const std::array<std::string_view, 5> keys = {"id", "name", "Type", "data1", "data2"};
+
+        const StringPerfectHash hash{keys};
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            ASSERT_EQ(hash.find(keys[i]), i);
+        }
+        ASSERT_EQ(hash.find("type"), StringPerfectHash::NotFound);
+        ASSERT_EQ(hash.find("data3"), StringPerfectHash::NotFound);
+
+        const StringPerfectHash icaseHash{keys, true};
+        ASSERT_EQ(icaseHash.find("TYPE"), 2);
+        ASSERT_EQ(icaseHash.find("Name"), 1);
+    }
+
+}  // namespace my::test
@@ -0,0 +1,292 @@
+// #my_engine_source_file
+
+#include "my/io/memory_stream.h"
+#include "my/meta/class_info.h"
+#include "my/rtti/rtti_impl.h"
+#include "my/serialization/json.h"
+#include "my/serialization/runtime_value_builder.h"
+
+using namespace ::testing;
+
+namespace my::test
+{
+    namespace
+    {
+        struct TapeTestItem
+        {
+            std::string name;
+            std::vector<int> values;
+            std::optional<double> weight;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(name),
+                CLASS_FIELD(values),
+                CLASS_FIELD(weight))
+        };
+
+        struct TapeTestData
+        {
+            unsigned id = 0;
+            bool enabled = false;
+            std::vector<TapeTestItem> items;
+            std::map<std::string, int64_t> counters;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(id),
+                CLASS_FIELD(enabled),
+                CLASS_FIELD(items),
+                CLASS_FIELD(counters))
+        };
+
+        /**
+            Non seekable stream that returns the data by the small portions.
+         */
+        class ChunkedTestStream final : public io::IStream
+        {
+            MY_REFCOUNTED_CLASS(my::test::ChunkedTestStream, io::IStream)
+
+        public:
+            ChunkedTestStream(std::string_view text) :
+                m_text(text)
+            {
+            }
+
+            size_t getPosition() const override
+            {
+                return m_pos;
+            }
+
+            size_t setPosition([[maybe_unused]] io::OffsetOrigin origin, [[maybe_unused]] int64_t offset) override
+            {
+                return m_pos;
+            }
+
+            void flush() override
+            {
+            }
+
+            bool canSeek() const override
+            {
+                return false;
+            }
+
+            bool canRead() const override
+            {
+                return true;
+            }
+
+            bool canWrite() const override
+            {
+                return false;
+            }
+
+            Result<size_t> read(std::byte* buffer, size_t count) override
+            {
+                const size_t size = std::min({count, m_text.size() - m_pos, size_t{7}});
+                std::memcpy(buffer, m_text.data() + m_pos, size);
+                m_pos += size;
+                return size;
+            }
+
+        private:
+            const std::string_view m_text;
+            size_t m_pos = 0;
+        };
+
+        /**
+            Compares the values produced by the different parsers.
+            Values are compared by their json text, since the parsers can choose different integer types for the same number.
+         */
+        testing::AssertionResult parsersProduceSameValue(std::string_view text)
+        {
+            Result<RuntimeValuePtr> jsonCppValue = serialization::jsonParseString(text, serialization::JsonParser::JsonCpp);
+            Result<RuntimeValuePtr> tapeValue = serialization::jsonParseString(text, serialization::JsonParser::Tape);
+            if (!jsonCppValue || !tapeValue)
+            {
+                return testing::AssertionFailure() << "Parse failed: " << (jsonCppValue ? tapeValue.getError() : jsonCppValue.getError())->getMessage();
+            }
+
+            const std::string expected = serialization::runtimeToJsonValue(*jsonCppValue, {.writeNulls = true}).toStyledString();
+            const std::string actual = serialization::runtimeToJsonValue(*tapeValue, {.writeNulls = true}).toStyledString();
+            if (expected != actual)
+            {
+                return testing::AssertionFailure() << std::format("Values are different:\n{}\n{}", expected, actual);
+            }
+
+            return testing::AssertionSuccess();
+        }
+
+        constexpr std::string_view TapeTestJson = R"--(
+            {
+                "id": 17,
+                "enabled": true,
+                "items": [
+                    {"name": "first \"quoted\" name", "values": [1, -2, 3], "weight": 0.5},
+                    {"name": "second\\\\", "values": [], "weight": null},
+                    {"name": "{[,:]}", "values": [7]}
+                ],
+                "counters": {"a": -9223372036854775807, "b": 0},
+                "max": 9223372036854775807,
+                "large": 18446744073709551615,
+                "float": -1.25e-3,
+                "empty": {},
+                "nested": [[[[]]], [{}], "", null, false]
+            }
+        )--";
+    }  // namespace
+
+    TEST(TestJsonTape, SameAsJsonCpp)
+    {
+        ASSERT_TRUE(parsersProduceSameValue(TapeTestJson));
+        ASSERT_TRUE(parsersProduceSameValue("[]"));
+        ASSERT_TRUE(parsersProduceSameValue("{}"));
+        ASSERT_TRUE(parsersProduceSameValue("  [1, 2.5, \"text\", true, null]  "));
+        ASSERT_TRUE(parsersProduceSameValue(R"({"a": "\ud83d\ude00 \u0444 \u0041 \/ \b\f\n\r\t", "b": "ф"})"));
+    }
+
+    TEST(TestJsonTape, RootScalar)
+    {
+        Result<RuntimeValuePtr> value = serialization::jsonParseString("  12345 ", serialization::JsonParser::Tape);
+        ASSERT_TRUE(value);
+        ASSERT_EQ(*runtimeValueCast<int>(*value), 12345);
+
+        value = serialization::jsonParseString(R"("text")", serialization::JsonParser::Tape);
+        ASSERT_TRUE(value);
+        ASSERT_EQ(*runtimeValueCast<std::string>(*value), "text");
+    }
+
+    /**
+        Strings, escapes and backslash runs are placed across the 64 bytes block boundaries of the structural index.
+     */
+    TEST(TestJsonTape, BlockBoundaries)
+    {
+        for (size_t padding = 1; padding < 70; ++padding)
+        {
+            const std::string text = std::format(R"({{"{}": ["a\\\\", "b\"}}\\", "\\\"{{[", 1, {{"k": "{}"}}], "x": 2}})", std::string(padding, 'p'), std::string(padding % 7, '\\') + std::string(padding % 7, '\\'));
+            ASSERT_TRUE(parsersProduceSameValue(text)) << text;
+        }
+    }
+
+    TEST(TestJsonTape, Readonly)
+    {
+        Result<RuntimeValuePtr> value = serialization::jsonParseString(R"({"a": [1, 2], "b": null})", serialization::JsonParser::Tape);
+        ASSERT_TRUE(value);
+        ASSERT_FALSE((*value)->isMutable());
+
+        auto& dict = (*value)->as<ReadonlyDictionary&>();
+        ASSERT_EQ(dict.getSize(), 2);
+        ASSERT_EQ(dict.getKey(0), "a");
+        ASSERT_EQ(dict.getKey(1), "b");
+        ASSERT_TRUE(dict.containsKey("b"));
+        ASSERT_FALSE(dict.containsKey("c"));
+        ASSERT_FALSE(dict.getValue("c"));
+        ASSERT_FALSE(dict.setValue("a", makeValueCopy(1)));
+
+        const RuntimeValuePtr nullValue = dict.getValue("b");
+        ASSERT_TRUE(nullValue->is<OptionalValue>());
+        ASSERT_FALSE(nullValue->as<OptionalValue&>().hasValue());
+
+        const RuntimeValuePtr collection = dict.getValue("a");
+        ASSERT_EQ(collection->as<ReadonlyCollection&>().getSize(), 2);
+        ASSERT_FALSE(collection->as<ReadonlyCollection&>().setAt(0, makeValueCopy(1)));
+    }
+
+    /**
+        Object keys follow the jsoncpp semantics: keys are sorted, the last of the duplicate keys wins.
+     */
+    TEST(TestJsonTape, DuplicateKeys)
+    {
+        constexpr std::string_view Json = R"({"b": 1, "a": 2, "b": 3, "c": {"x": 1, "x": [2], "w": 0}})";
+        ASSERT_TRUE(parsersProduceSameValue(Json));
+
+        Result<RuntimeValuePtr> value = serialization::jsonParseString(Json, serialization::JsonParser::Tape);
+        ASSERT_TRUE(value);
+
+        auto& dict = (*value)->as<ReadonlyDictionary&>();
+        ASSERT_EQ(dict.getSize(), 3);
+        ASSERT_EQ(dict.getKey(0), "a");
+        ASSERT_EQ(dict.getKey(1), "b");
+        ASSERT_EQ(dict.getKey(2), "c");
+        ASSERT_EQ(*runtimeValueCast<int>(dict.getValue("b")), 3);
+
+        auto& nested = dict.getValue("c")->as<ReadonlyDictionary&>();
+        ASSERT_EQ(nested.getSize(), 2);
+        ASSERT_EQ(nested.getKey(0), "w");
+        ASSERT_EQ(nested.getValue("x")->as<ReadonlyCollection&>().getSize(), 1);
+    }
+
+    TEST(TestJsonTape, CastToNativeType)
+    {
+        Result<RuntimeValuePtr> value = serialization::jsonParseString(TapeTestJson, serialization::JsonParser::Tape);
+        ASSERT_TRUE(value);
+
+        const Result<TapeTestData> data = runtimeValueCast<TapeTestData>(*value);
+        ASSERT_TRUE(data);
+        ASSERT_EQ(data->id, 17);
+        ASSERT_TRUE(data->enabled);
+        ASSERT_EQ(data->items.size(), 3);
+        ASSERT_EQ(data->items[0].name, R"(first "quoted" name)");
+        ASSERT_THAT(data->items[0].values, ElementsAre(1, -2, 3));
+        ASSERT_EQ(data->items[0].weight, 0.5);
+        ASSERT_EQ(data->items[1].name, R"(second\\)");
+        ASSERT_FALSE(data->items[1].weight);
+        ASSERT_EQ(data->items[2].name, "{[,:]}");
+        ASSERT_EQ(data->counters.at("a"), -9223372036854775807);
+    }
+
+    TEST(TestJsonTape, ParseStream)
+    {
+        const std::string_view text = R"({"id": 1, "enabled": true, "items": [{"name": "item"}]})";
+
+        io::MemoryStreamPtr memoryStream = io::createReadonlyMemoryStream(std::span{reinterpret_cast<const std::byte*>(text.data()), text.size()});
+        Result<RuntimeValuePtr> value = serialization::jsonParse(*memoryStream, serialization::JsonParser::Tape);
+        ASSERT_TRUE(value);
+        ASSERT_EQ(memoryStream->getPosition(), text.size());
+        ASSERT_EQ(runtimeValueCast<TapeTestData>(*value)->items.size(), 1);
+
+        auto chunkedStream = rtti::createInstance<ChunkedTestStream>(text);
+        value = serialization::jsonParse(*chunkedStream, serialization::JsonParser::Tape);
+        ASSERT_TRUE(value);
+        ASSERT_EQ(runtimeValueCast<TapeTestData>(*value)->items[0].name, "item");
+    }
+
+    TEST(TestJsonTape, InvalidJson)
+    {
+        constexpr std::string_view InvalidTexts[] = {
+            "",
+            "   ",
+            R"({"a": "unterminated)",
+            R"({"a": "escaped quote\"})",
+            R"({"a": 1 "b": 2})",
+            R"({"a": 1, "b": 2)",
+            R"({"a" 1})",
+            R"({1: 1})",
+            R"({"a": 1} {})",
+            R"([1, 2] garbage)",
+            R"([tru])",
+            R"([truex])",
+            R"([nul])",
+            R"([12abc])",
+            R"([-])",
+            R"([1,, 2])",
+            R"([,])",
+            R"(["\q"])",
+            R"(["\ud83d"])",
+            R"(["\u12G4"])",
+            "[\"control\x01\"]",
+            "[1]]",
+            "{}}"};
+
+        for (const std::string_view text : InvalidTexts)
+        {
+            ASSERT_FALSE(serialization::jsonParseString(text, serialization::JsonParser::Tape)) << text;
+        }
+    }
+
+    TEST(TestJsonTape, MaxDepth)
+    {
+        ASSERT_TRUE(serialization::jsonParseString(std::string(256, '[') + std::string(256, ']'), serialization::JsonParser::Tape));
+        ASSERT_FALSE(serialization::jsonParseString(std::string(1024, '[') + std::string(1024, ']'), serialization::JsonParser::Tape));
+    }
+
+}  // namespace my::test
@@ -0,0 +1,206 @@
+// #my_engine_source_file
+
+#include "my/io/memory_stream.h"
+#include "my/meta/class_info.h"
+#include "my/rtti/rtti_impl.h"
+#include "my/serialization/json_codec.h"
+#include "my/serialization/json_utils.h"
+
+using namespace ::testing;
+
+namespace my::test
+{
+    namespace
+    {
+        struct WriterTestEntry
+        {
+            std::string path;
+            uint64_t size = 0;
+            double ratio = 0.;
+            std::optional<std::string> tag;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(path),
+                CLASS_FIELD(size),
+                CLASS_FIELD(ratio),
+                CLASS_FIELD(tag))
+
+            bool operator==(const WriterTestEntry&) const = default;
+        };
+
+        struct WriterTestData
+        {
+            std::string name;
+            std::vector<WriterTestEntry> entries;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(name),
+                CLASS_FIELD(entries))
+
+            bool operator==(const WriterTestData&) const = default;
+        };
+
+        WriterTestData makeWriterTestData(size_t entriesCount)
+        {
+            WriterTestData data{.name = "writer \"test\"\n"};
+            for (size_t i = 0; i < entriesCount; ++i)
+            {
+                data.entries.push_back(WriterTestEntry{
+                    .path = std::format("content/path_{}.bin", i),
+                    .size = i * 1024,
+                    .ratio = static_cast<double>(i) / 4.,
+                    .tag = i % 3 == 0 ? std::optional<std::string>{"tag"} : std::nullopt});
+            }
+
+            return data;
+        }
+
+        /**
+            Records the size of each write call.
+         */
+        class WriteRecorderStream final : public io::IStream
+        {
+            MY_REFCOUNTED_CLASS(my::test::WriteRecorderStream, io::IStream)
+
+        public:
+            WriteRecorderStream(bool failWrites = false) :
+                m_failWrites(failWrites)
+            {
+            }
+
+            size_t getPosition() const override
+            {
+                return text.size();
+            }
+
+            size_t setPosition([[maybe_unused]] io::OffsetOrigin origin, [[maybe_unused]] int64_t offset) override
+            {
+                return text.size();
+            }
+
+            void flush() override
+            {
+            }
+
+            bool canSeek() const override
+            {
+                return false;
+            }
+
+            bool canRead() const override
+            {
+                return false;
+            }
+
+            bool canWrite() const override
+            {
+                return true;
+            }
+
+            Result<size_t> write(const std::byte* buffer, size_t count) override
+            {
+                if (m_failWrites)
+                {
+                    return MakeError("Write failed");
+                }
+
+                writes.push_back(count);
+                text.append(reinterpret_cast<const char*>(buffer), count);
+                return count;
+            }
+
+            std::string text;
+            std::vector<size_t> writes;
+
+        private:
+            const bool m_failWrites;
+        };
+
+        std::string writeRuntimeValue(const RuntimeValuePtr& value, serialization::JsonSettings settings = {})
+        {
+            auto stream = rtti::createInstance<WriteRecorderStream>();
+            const Result<> result = serialization::jsonWrite(*stream, value, settings);
+            EXPECT_TRUE(result);
+
+            return stream->text;
+        }
+    }  // namespace
+
+    TEST(TestJsonWriter, WritesByBlocks)
+    {
+        const WriterTestData data = makeWriterTestData(2000);
+
+        auto stream = rtti::createInstance<WriteRecorderStream>();
+        ASSERT_TRUE(serialization::jsonWrite(*stream, makeValueRef(data)));
+        ASSERT_GT(stream->text.size(), 4 * ser_detail::JsonTextWriter::StreamBlockSize);
+
+        for (size_t i = 0; i + 1 < stream->writes.size(); ++i)
+        {
+            ASSERT_GE(stream->writes[i], ser_detail::JsonTextWriter::StreamBlockSize);
+        }
+        ASSERT_LE(stream->writes.size(), stream->text.size() / ser_detail::JsonTextWriter::StreamBlockSize + 1);
+
+        const Result<WriterTestData> parsedData = serialization::JsonCodec::parse<WriterTestData>(stream->text);
+        ASSERT_TRUE(parsedData);
+        ASSERT_EQ(*parsedData, data);
+    }
+
+    TEST(TestJsonWriter, SameAsCodecOutput)
+    {
+        const WriterTestData data = makeWriterTestData(500);
+
+        for (const bool pretty : {false, true})
+        {
+            const serialization::JsonSettings settings{.pretty = pretty};
+
+            auto stream = rtti::createInstance<WriteRecorderStream>();
+            ASSERT_TRUE(serialization::JsonCodec::stringify(*stream, data, settings));
+            ASSERT_EQ(stream->text, serialization::JsonCodec::stringify(data, settings));
+            ASSERT_EQ(writeRuntimeValue(makeValueRef(data), settings), stream->text);
+        }
+    }
+
+    TEST(TestJsonWriter, PrettyPrint)
+    {
+        const std::map<std::string, std::vector<int>> data = {{"a", {1, 2}}, {"b", {}}};
+        ASSERT_EQ(writeRuntimeValue(makeValueRef(data), {.pretty = true}), "{\n\t\"a\": [\n\t\t1,\n\t\t2\n\t],\n\t\"b\": []\n}");
+        ASSERT_EQ(writeRuntimeValue(makeValueRef(data)), R"({"a":[1,2],"b":[]})");
+    }
+
+    TEST(TestJsonWriter, Numbers)
+    {
+        ASSERT_EQ(serialization::JsonUtils::stringify(1.0), "1.0");
+        ASSERT_EQ(serialization::JsonUtils::stringify(0.1f), "0.1");
+        ASSERT_EQ(serialization::JsonUtils::stringify(-2.5e20), "-2.5e+20");
+        ASSERT_EQ(serialization::JsonUtils::stringify(std::numeric_limits<int64_t>::min()), "-9223372036854775808");
+        ASSERT_EQ(serialization::JsonUtils::stringify(std::numeric_limits<uint64_t>::max()), "18446744073709551615");
+        ASSERT_EQ(serialization::JsonUtils::stringify(std::numeric_limits<double>::quiet_NaN()), "null");
+    }
+
+    TEST(TestJsonWriter, WriteNulls)
+    {
+        const WriterTestEntry entry{.path = "path"};
+        ASSERT_THAT(writeRuntimeValue(makeValueRef(entry)), Not(HasSubstr("tag")));
+        ASSERT_THAT(writeRuntimeValue(makeValueRef(entry), {.writeNulls = true}), HasSubstr(R"("tag":null)"));
+    }
+
+    TEST(TestJsonWriter, ParsedValueRoundTrip)
+    {
+        constexpr std::string_view Json = R"({"a":[1,-2,3.5,"text"],"b":{"c":true,"d":null},"e":"\u0001"})";
+
+        Result<RuntimeValuePtr> value = serialization::jsonParseString(Json);
+        ASSERT_TRUE(value);
+        ASSERT_EQ(writeRuntimeValue(*value, {.writeNulls = true}), Json);
+
+        value = serialization::jsonParseString(Json, serialization::JsonParser::Tape);
+        ASSERT_TRUE(value);
+        ASSERT_EQ(writeRuntimeValue(*value, {.writeNulls = true}), Json);
+    }
+
+    TEST(TestJsonWriter, StreamError)
+    {
+        auto stream = rtti::createInstance<WriteRecorderStream>(true);
+        ASSERT_FALSE(serialization::jsonWrite(*stream, makeValueRef(makeWriterTestData(10))));
+    }
+
+}  // namespace my::test
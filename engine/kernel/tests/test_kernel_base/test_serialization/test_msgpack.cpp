@@ -0,0 +1,296 @@
+// #my_engine_source_file
+
+#include "my/io/memory_stream.h"
+#include "my/meta/class_info.h"
+#include "my/rtti/rtti_impl.h"
+#include "my/serialization/json.h"
+#include "my/serialization/msgpack.h"
+#include "my/serialization/runtime_value_builder.h"
+
+using namespace ::testing;
+
+namespace my::test
+{
+    namespace
+    {
+        struct MsgPackTestEntry
+        {
+            std::string path;
+            uint64_t size = 0;
+            int64_t delta = 0;
+            double ratio = 0.;
+            float scale = 1.f;
+            bool enabled = false;
+            std::optional<std::string> tag;
+            std::vector<uint8_t> payload;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(path),
+                CLASS_FIELD(size),
+                CLASS_FIELD(delta),
+                CLASS_FIELD(ratio),
+                CLASS_FIELD(scale),
+                CLASS_FIELD(enabled),
+                CLASS_FIELD(tag),
+                CLASS_FIELD(payload))
+
+            bool operator==(const MsgPackTestEntry&) const = default;
+        };
+
+        struct MsgPackTestData
+        {
+            std::string name;
+            std::vector<MsgPackTestEntry> entries;
+            std::map<std::string, int> counters;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(name),
+                CLASS_FIELD(entries),
+                CLASS_FIELD(counters))
+
+            bool operator==(const MsgPackTestData&) const = default;
+        };
+
+        struct MsgPackBinaryField
+        {
+            std::string name;
+            std::vector<std::byte> bytes;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(name),
+                CLASS_FIELD(bytes))
+
+            bool operator==(const MsgPackBinaryField&) const = default;
+        };
+
+        struct MsgPackRequiredField
+        {
+            int value = 0;
+            int requiredValue = 0;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(value),
+                CLASS_FIELD(requiredValue, serialization::RequiredFieldAttribute{}))
+        };
+
+        MsgPackTestData makeMsgPackTestData(size_t entriesCount)
+        {
+            MsgPackTestData data{.name = "msgpack \"test\"", .counters = {{"first", 1}, {"second", -70000}}};
+            for (size_t i = 0; i < entriesCount; ++i)
+            {
+                MsgPackTestEntry& entry = data.entries.emplace_back(MsgPackTestEntry{
+                    .path = std::format("content/path_{}.bin", i),
+                    .size = i * 1024,
+                    .delta = -static_cast<int64_t>(i * i * 1000),
+                    .ratio = static_cast<double>(i) / 4.,
+                    .scale = static_cast<float>(i) * 0.5f,
+                    .enabled = i % 2 == 0,
+                    .tag = i % 3 == 0 ? std::optional<std::string>{"tag"} : std::nullopt});
+
+                for (size_t j = 0; j < i % 7; ++j)
+                {
+                    entry.payload.push_back(static_cast<uint8_t>(i + j));
+                }
+            }
+
+            return data;
+        }
+
+        std::vector<std::byte> toBytes(std::initializer_list<int> values)
+        {
+            std::vector<std::byte> bytes;
+            for (const int value : values)
+            {
+                bytes.push_back(static_cast<std::byte>(value));
+            }
+
+            return bytes;
+        }
+
+        template <typename T>
+        std::vector<std::byte> writeWithCodec(const T& value)
+        {
+            io::MemoryStreamPtr stream = io::createMemoryStream();
+            EXPECT_TRUE(serialization::MsgPackCodec::write(*stream, value));
+
+            const auto bytes = stream->getBufferAsSpan();
+            return {bytes.begin(), bytes.end()};
+        }
+
+        std::vector<std::byte> writeRuntimeValue(const RuntimeValuePtr& value)
+        {
+            io::MemoryStreamPtr stream = io::createMemoryStream();
+            EXPECT_TRUE(serialization::msgpackWrite(*stream, value));
+
+            const auto bytes = stream->getBufferAsSpan();
+            return {bytes.begin(), bytes.end()};
+        }
+
+        Result<RuntimeValuePtr> parseBytes(std::span<const std::byte> bytes)
+        {
+            io::MemoryStreamPtr stream = io::createReadonlyMemoryStream(bytes);
+            return serialization::msgpackParse(*stream);
+        }
+    }  // namespace
+
+    TEST(TestMsgPack, IntegerEncoding)
+    {
+        ASSERT_EQ(writeWithCodec(0), toBytes({0x00}));
+        ASSERT_EQ(writeWithCodec(127), toBytes({0x7f}));
+        ASSERT_EQ(writeWithCodec(128), toBytes({0xcc, 0x80}));
+        ASSERT_EQ(writeWithCodec(-1), toBytes({0xff}));
+        ASSERT_EQ(writeWithCodec(-32), toBytes({0xe0}));
+        ASSERT_EQ(writeWithCodec(-33), toBytes({0xd0, 0xdf}));
+        ASSERT_EQ(writeWithCodec(uint16_t{0x1234}), toBytes({0xcd, 0x12, 0x34}));
+        ASSERT_EQ(writeWithCodec(std::numeric_limits<int64_t>::min()), toBytes({0xd3, 0x80, 0, 0, 0, 0, 0, 0, 0}));
+        ASSERT_EQ(writeWithCodec(std::numeric_limits<uint64_t>::max()), toBytes({0xcf, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}));
+        ASSERT_EQ(writeWithCodec(1.5f), toBytes({0xca, 0x3f, 0xc0, 0, 0}));
+        ASSERT_EQ(writeWithCodec(std::string{"abc"}), toBytes({0xa3, 'a', 'b', 'c'}));
+        ASSERT_EQ(writeWithCodec(std::vector<bool>{true, false}), toBytes({0x92, 0xc3, 0xc2}));
+    }
+
+    TEST(TestMsgPack, IntegerLimits)
+    {
+        for (const int64_t value : {std::numeric_limits<int64_t>::min(), int64_t{-129}, int64_t{-1}, int64_t{255}, int64_t{65536}, std::numeric_limits<int64_t>::max()})
+        {
+            const Result<int64_t> parsed = serialization::MsgPackCodec::parse<int64_t>(writeWithCodec(value));
+            ASSERT_TRUE(parsed);
+            ASSERT_EQ(*parsed, value);
+        }
+
+        ASSERT_FALSE(serialization::MsgPackCodec::parse<uint32_t>(writeWithCodec(-1)));
+        ASSERT_FALSE(serialization::MsgPackCodec::parse<int8_t>(writeWithCodec(128)));
+        ASSERT_FALSE(serialization::MsgPackCodec::parse<int64_t>(writeWithCodec(std::numeric_limits<uint64_t>::max())));
+    }
+
+    TEST(TestMsgPack, CodecRoundTrip)
+    {
+        const MsgPackTestData data = makeMsgPackTestData(100);
+
+        const Result<MsgPackTestData> parsedData = serialization::MsgPackCodec::parse<MsgPackTestData>(writeWithCodec(data));
+        ASSERT_TRUE(parsedData);
+        ASSERT_EQ(*parsedData, data);
+    }
+
+    TEST(TestMsgPack, CodecOutputMatchesRuntimeValueOutput)
+    {
+        const MsgPackTestData data = makeMsgPackTestData(20);
+        ASSERT_EQ(writeRuntimeValue(makeValueRef(data)), writeWithCodec(data));
+    }
+
+    TEST(TestMsgPack, RuntimeValueRoundTrip)
+    {
+        const MsgPackTestData data = makeMsgPackTestData(50);
+
+        Result<RuntimeValuePtr> value = parseBytes(writeWithCodec(data));
+        ASSERT_TRUE(value);
+
+        MsgPackTestData parsedData;
+        ASSERT_TRUE(RuntimeValue::assign(makeValueRef(parsedData), *value));
+        ASSERT_EQ(parsedData, data);
+
+        // parsed values are written back unchanged
+        ASSERT_EQ(writeRuntimeValue(*value), writeWithCodec(data));
+    }
+
+    TEST(TestMsgPack, ZeroCopyViews)
+    {
+        const MsgPackBinaryField source{.name = "content/file.bin", .bytes = toBytes({1, 2, 0xff})};
+        const std::vector<std::byte> bytes = writeWithCodec(source);
+        ASSERT_EQ(std::vector(bytes.end() - 5, bytes.end()), toBytes({0xc4, 3, 1, 2, 0xff}));
+
+        const Result<MsgPackBinaryField> parsedSource = serialization::MsgPackCodec::parse<MsgPackBinaryField>(bytes);
+        ASSERT_TRUE(parsedSource);
+        ASSERT_EQ(*parsedSource, source);
+
+        Buffer buffer{bytes.size()};
+        std::memcpy(buffer.data(), bytes.data(), bytes.size());
+        ReadOnlyBuffer readOnlyBuffer = buffer.toReadOnly();
+        const std::byte* const dataBegin = readOnlyBuffer.data();
+        const std::byte* const dataEnd = dataBegin + readOnlyBuffer.size();
+
+        Result<RuntimeValuePtr> value = serialization::msgpackParse(std::move(readOnlyBuffer));
+        ASSERT_TRUE(value);
+
+        ReadonlyDictionary& dict = (*value)->as<ReadonlyDictionary&>();
+        ASSERT_EQ(dict.getSize(), 2);
+        const std::string_view key = dict.getKey(0);
+        ASSERT_EQ(key, "name");
+        ASSERT_TRUE(reinterpret_cast<const std::byte*>(key.data()) >= dataBegin && reinterpret_cast<const std::byte*>(key.data()) < dataEnd);
+
+        const RuntimeValuePtr binaryValue = dict.getValue("bytes");
+        const auto* const binary = binaryValue->as<const serialization::MsgPackBinary*>();
+        ASSERT_TRUE(binary);
+        ASSERT_EQ(binary->getBytes().size(), 3);
+        ASSERT_TRUE(binary->getBytes().data() >= dataBegin && binary->getBytes().data() < dataEnd);
+
+        const RuntimeValuePtr name = dict.getValue("name");
+        ASSERT_EQ(name->as<const StringValue&>().getString(), "content/file.bin");
+
+        // binary is also a collection of bytes
+        std::vector<uint8_t> byteValues;
+        ASSERT_TRUE(RuntimeValue::assign(makeValueRef(byteValues), binaryValue));
+        ASSERT_THAT(byteValues, ElementsAre(1, 2, 0xff));
+
+        ASSERT_EQ(writeRuntimeValue(*value), bytes);
+    }
+
+    TEST(TestMsgPack, ParsedValueToJson)
+    {
+        constexpr std::string_view Json = R"({"a":[1,-2,3.5,"text"],"b":{"c":true,"d":null},"e":18446744073709551615})";
+
+        Result<RuntimeValuePtr> jsonValue = serialization::jsonParseString(Json, serialization::JsonParser::Tape);
+        ASSERT_TRUE(jsonValue);
+
+        Result<RuntimeValuePtr> value = parseBytes(writeRuntimeValue(*jsonValue));
+        ASSERT_TRUE(value);
+
+        io::MemoryStreamPtr stream = io::createMemoryStream();
+        ASSERT_TRUE(serialization::jsonWrite(*stream, *value, {.writeNulls = true}));
+        const auto text = stream->getBufferAsSpan();
+        ASSERT_EQ(std::string_view(reinterpret_cast<const char*>(text.data()), text.size()), Json);
+    }
+
+    TEST(TestMsgPack, UnknownAndRequiredFields)
+    {
+        const std::map<std::string, RuntimeValuePtr> source = {
+            {"value",         makeValueCopy(1)                      },
+            {"unknown",       makeValueCopy(std::vector<int>{1, 2})},
+            {"requiredValue", makeValueCopy(2)                      }
+        };
+        const std::vector<std::byte> bytes = writeWithCodec(source);
+
+        const Result<MsgPackRequiredField> parsed = serialization::MsgPackCodec::parse<MsgPackRequiredField>(bytes);
+        ASSERT_TRUE(parsed);
+        ASSERT_EQ(parsed->value, 1);
+        ASSERT_EQ(parsed->requiredValue, 2);
+
+        const Result<MsgPackRequiredField> missed = serialization::MsgPackCodec::parse<MsgPackRequiredField>(writeWithCodec(std::map<std::string, int>{{"value", 1}}));
+        ASSERT_FALSE(missed);
+        ASSERT_TRUE(missed.getError()->is<serialization::RequiredFieldMissedError>());
+    }
+
+    TEST(TestMsgPack, InvalidData)
+    {
+        // truncated string
+        ASSERT_FALSE(parseBytes(toBytes({0xa3, 'a'})));
+        // truncated array
+        ASSERT_FALSE(parseBytes(toBytes({0x92, 0x01})));
+        // non string key
+        ASSERT_FALSE(parseBytes(toBytes({0x81, 0x01, 0x02})));
+        // never used marker
+        ASSERT_FALSE(parseBytes(toBytes({0xc1})));
+        // trailing data
+        ASSERT_FALSE(parseBytes(toBytes({0x01, 0x02})));
+        // empty data
+        ASSERT_FALSE(parseBytes({}));
+
+        // too deep nesting
+        std::vector<std::byte> nested(ser_detail::MsgPackReader::MaxDepth + 2, std::byte{0x91});
+        nested.push_back(std::byte{0xc0});
+        ASSERT_FALSE(parseBytes(nested));
+
+        ASSERT_FALSE(serialization::MsgPackCodec::parse<std::string>(writeWithCodec(1)));
+    }
+
+}  // namespace my::test
@@ -408,6 +408,83 @@ namespace my::test
         ASSERT_EQ(obj.field1, ExpectedValue);
     }
 
+    TEST(TestRuntimeValue, ObjectValue_FieldLookupIgnoreCase)
+    {
+        FooObject1 obj;
+        auto runtimeObj = my::makeValueRef(obj);
+
+        ASSERT_TRUE(runtimeObj->containsKey("fieldArr"));
+        ASSERT_TRUE(runtimeObj->containsKey("FIELDARR"));
+        ASSERT_FALSE(runtimeObj->containsKey("fieldArr_"));
+        ASSERT_FALSE(runtimeObj->containsKey(""));
+        ASSERT_FALSE(runtimeObj->getValue("unknown"));
+        ASSERT_TRUE(runtimeObj->getValue("FieldObj"));
+    }
+
+    TEST(TestRuntimeValue, ObjectValue_FieldValueIsCached)
+    {
+        FooObject1 obj;
+        auto runtimeObj = my::makeValueRef(obj);
+
+        RuntimeValuePtr fieldValue = runtimeObj->getValue("fieldObj");
+        ASSERT_EQ(fieldValue.get(), runtimeObj->getValue("fieldObj").get());
+
+        ASSERT_TRUE(runtimeObj->setValue("field1", makeValueCopy(11)));
+        ASSERT_EQ(obj.field1, 11);
+    }
+
+    TEST(TestRuntimeValue, NativeValueAllocator)
+    {
+        const auto getValueAllocator = [](IntegerValue& value)
+        {
+            auto* const valueImpl = value.as<ser_detail::NativeIntegerValue<int>*>();
+            return valueImpl ? valueImpl->getRttiClassInstanceAllocator() : nullptr;
+        };
+
+        Ptr<IntegerValue> pooledValue = makeValueCopy(1);
+        ASSERT_EQ(getValueAllocator(*pooledValue), &ser_detail::getNativeValueAllocator());
+
+        Ptr<IntegerValue> value = makeValueCopy(2, &getDefaultAllocator());
+        ASSERT_EQ(getValueAllocator(*value), &getDefaultAllocator());
+    }
+
+    TEST(TestRuntimeValue, StringCopyInlineStorage)
+    {
+        const std::string shortString = "short";
+        const std::string longString(ser_detail::NativeInlineString::InlineCapacity * 2, 'x');
+
+        Ptr<StringValue> value = makeValueCopy(std::string_view{shortString});
+        ASSERT_EQ(value->getString(), shortString);
+
+        ASSERT_TRUE(value->setString(longString));
+        ASSERT_EQ(value->getString(), longString);
+
+        ASSERT_TRUE(value->setString(shortString));
+        ASSERT_EQ(value->getString(), shortString);
+
+        ASSERT_TRUE(value->setString(""));
+        ASSERT_TRUE(value->getString().empty());
+    }
+
+    TEST(TestRuntimeValue, NativeInlineString)
+    {
+        const std::string longString(ser_detail::NativeInlineString::InlineCapacity + 1, 'x');
+
+        ser_detail::NativeInlineString str{"text", 4};
+        ASSERT_TRUE(str.isInline());
+
+        str.assign(longString.data(), longString.size());
+        ASSERT_FALSE(str.isInline());
+        ASSERT_EQ(std::string_view(str.data(), str.size()), longString);
+
+        // assign own substring
+        str.assign(str.data() + 1, 3);
+        ASSERT_EQ(std::string_view(str.data(), str.size()), "xxx");
+
+        ser_detail::NativeInlineString movedStr = std::move(str);
+        ASSERT_EQ(std::string_view(movedStr.data(), movedStr.size()), "xxx");
+    }
+
     TEST(TestRuntimeValue, RuntimeValueRef)
     {
         FooObject1 obj;
@@ -0,0 +1,184 @@
+// #my_engine_source_file
+
+#include "my/io/memory_stream.h"
+#include "my/meta/class_info.h"
+#include "my/serialization/json.h"
+#include "my/serialization/msgpack.h"
+#include "my/serialization/runtime_value_builder.h"
+#include "my/serialization/runtime_value_delta.h"
+
+using namespace ::testing;
+
+namespace my::test
+{
+    namespace
+    {
+        struct DeltaTestChild
+        {
+            int x = 0;
+            std::string name;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(x),
+                CLASS_FIELD(name))
+
+            bool operator==(const DeltaTestChild&) const = default;
+        };
+
+        struct DeltaTestData
+        {
+            int value = 0;
+            std::string text;
+            std::vector<DeltaTestChild> entries;
+            std::map<std::string, DeltaTestChild> children;
+
+            MY_CLASS_FIELDS(
+                CLASS_FIELD(value),
+                CLASS_FIELD(text),
+                CLASS_FIELD(entries),
+                CLASS_FIELD(children))
+
+            bool operator==(const DeltaTestData&) const = default;
+        };
+
+        DeltaTestData makeDeltaTestData()
+        {
+            return DeltaTestData{
+                .value = 1,
+                .text = "text",
+                .entries = {{.x = 1, .name = "first"}, {.x = 2, .name = "second"}},
+                .children = {{"a", {.x = 10, .name = "a"}}, {"b/c", {.x = 20, .name = "b"}}}};
+        }
+
+        std::vector<std::string> getPatchPaths(Collection& patch)
+        {
+            std::vector<std::string> paths;
+            for (size_t i = 0; i < patch.getSize(); ++i)
+            {
+                auto& operation = patch.getAt(i)->as<ReadonlyDictionary&>();
+                paths.push_back(operation.getValue("path")->as<const StringValue&>().getString());
+            }
+
+            return paths;
+        }
+
+        RuntimeValuePtr getChild(const RuntimeValuePtr& value, std::string_view key)
+        {
+            return value->as<ReadonlyDictionary&>().getValue(key);
+        }
+    }  // namespace
+
+    TEST(TestRuntimeValueDelta, NoChanges)
+    {
+        DeltaTestData data = makeDeltaTestData();
+        serialization::RuntimeValueChangesTracker tracker{makeValueRef(data)};
+
+        ASSERT_FALSE(tracker.hasChanges());
+        ASSERT_EQ(tracker.makeJsonPatch()->getSize(), 0);
+    }
+
+    TEST(TestRuntimeValueDelta, CollectChangedPaths)
+    {
+        DeltaTestData data = makeDeltaTestData();
+        RuntimeValuePtr value = makeValueRef(data);
+        serialization::RuntimeValueChangesTracker tracker{value};
+
+        ASSERT_TRUE(value->as<RuntimeObject&>().setValue("value", makeValueCopy(77)));
+        ASSERT_TRUE(getChild(getChild(value, "children"), "a")->as<ReadonlyDictionary&>().setValue("x", makeValueCopy(11)));
+        ASSERT_TRUE(getChild(getChild(value, "children"), "b/c")->as<ReadonlyDictionary&>().setValue("name", makeValueCopy(std::string_view{"bc"})));
+        ASSERT_TRUE(value->as<ReadonlyDictionary&>().getValue("entries")->as<Collection&>().getAt(1)->as<ReadonlyDictionary&>().setValue("x", makeValueCopy(3)));
+
+        ASSERT_TRUE(tracker.hasChanges());
+        Ptr<Collection> patch = tracker.makeJsonPatch();
+        ASSERT_THAT(getPatchPaths(*patch), ElementsAre("/children/a/x", "/children/b~1c/name", "/entries/1/x", "/value"));
+
+        tracker.reset();
+        ASSERT_FALSE(tracker.hasChanges());
+    }
+
+    TEST(TestRuntimeValueDelta, ContainerChangeCoversChildChanges)
+    {
+        DeltaTestData data = makeDeltaTestData();
+        RuntimeValuePtr value = makeValueRef(data);
+        serialization::RuntimeValueChangesTracker tracker{value};
+
+        auto& entries = getChild(value, "entries")->as<Collection&>();
+        ASSERT_TRUE(entries.getAt(0)->as<ReadonlyDictionary&>().setValue("x", makeValueCopy(5)));
+        ASSERT_TRUE(entries.append(makeValueCopy(DeltaTestChild{.x = 3, .name = "third"})));
+        ASSERT_TRUE(entries.getAt(1)->as<ReadonlyDictionary&>().setValue("x", makeValueCopy(6)));
+
+        Ptr<Collection> patch = tracker.makeJsonPatch();
+        ASSERT_THAT(getPatchPaths(*patch), ElementsAre("/entries"));
+    }
+
+    TEST(TestRuntimeValueDelta, ApplyPatch)
+    {
+        DeltaTestData source = makeDeltaTestData();
+        DeltaTestData target = makeDeltaTestData();
+
+        RuntimeValuePtr value = makeValueRef(source);
+        serialization::RuntimeValueChangesTracker tracker{value};
+
+        ASSERT_TRUE(value->as<RuntimeObject&>().setValue("text", makeValueCopy(std::string_view{"changed"})));
+        ASSERT_TRUE(getChild(getChild(value, "children"), "a")->as<ReadonlyDictionary&>().setValue("x", makeValueCopy(42)));
+        ASSERT_TRUE(getChild(value, "children")->as<Dictionary&>().setValue("new", makeValueCopy(DeltaTestChild{.x = 7, .name = "new"})));
+        ASSERT_TRUE(getChild(value, "children")->as<Dictionary&>().erase("b/c"));
+        ASSERT_FALSE(source.children.contains("b/c"));
+        ASSERT_TRUE(getChild(value, "entries")->as<Collection&>().getAt(0)->as<ReadonlyDictionary&>().setValue("name", makeValueCopy(std::string_view{"renamed"})));
+
+        Ptr<Collection> patch = tracker.makeJsonPatch();
+        ASSERT_THAT(getPatchPaths(*patch), Contains("/children/b~1c"));
+        ASSERT_TRUE(serialization::applyJsonPatch(*makeValueRef(target), *patch));
+        ASSERT_FALSE(target.children.contains("b/c"));
+        ASSERT_EQ(target, source);
+
+        // the erased value can not be removed again
+        ASSERT_FALSE(serialization::applyJsonPatch(*makeValueRef(target), *patch));
+    }
+
+    TEST(TestRuntimeValueDelta, ApplyPatchFromMsgPack)
+    {
+        DeltaTestData source = makeDeltaTestData();
+        DeltaTestData target = makeDeltaTestData();
+
+        RuntimeValuePtr value = makeValueRef(source);
+        serialization::RuntimeValueChangesTracker tracker{value};
+        ASSERT_TRUE(value->as<RuntimeObject&>().setValue("value", makeValueCopy(100)));
+        ASSERT_TRUE(getChild(value, "entries")->as<Collection&>().getAt(1)->as<ReadonlyDictionary&>().setValue("x", makeValueCopy(200)));
+
+        io::MemoryStreamPtr stream = io::createMemoryStream();
+        ASSERT_TRUE(serialization::msgpackWrite(*stream, tracker.makeJsonPatch()));
+
+        io::MemoryStreamPtr readStream = io::createReadonlyMemoryStream(stream->getBufferAsSpan());
+        Result<RuntimeValuePtr> patch = serialization::msgpackParse(*readStream);
+        ASSERT_TRUE(patch);
+
+        ASSERT_TRUE(serialization::applyJsonPatch(*makeValueRef(target), (*patch)->as<ReadonlyCollection&>()));
+        ASSERT_EQ(target, source);
+    }
+
+    TEST(TestRuntimeValueDelta, ApplyPatchErrors)
+    {
+        DeltaTestData target = makeDeltaTestData();
+        RuntimeValuePtr value = makeValueRef(target);
+
+        auto makePatch = [](std::string_view op, std::string_view path)
+        {
+            Ptr<Dictionary> operation = serialization::jsonCreateDictionary();
+            operation->setValue("op", makeValueCopy(op)).ignore();
+            operation->setValue("path", makeValueCopy(path)).ignore();
+            operation->setValue("value", makeValueCopy(1)).ignore();
+
+            Ptr<Collection> patch = serialization::jsonCreateCollection();
+            patch->append(operation).ignore();
+            return patch;
+        };
+
+        ASSERT_FALSE(serialization::applyJsonPatch(*value, *makePatch("move", "/value")));
+        ASSERT_FALSE(serialization::applyJsonPatch(*value, *makePatch("replace", "/missing/x")));
+        ASSERT_FALSE(serialization::applyJsonPatch(*value, *makePatch("add", "/entries/0")));
+        ASSERT_FALSE(serialization::applyJsonPatch(*value, *makePatch("remove", "/entries/0")));
+        ASSERT_TRUE(serialization::applyJsonPatch(*value, *makePatch("replace", "/value")));
+        ASSERT_EQ(target.value, 1);
+    }
+}  // namespace my::test
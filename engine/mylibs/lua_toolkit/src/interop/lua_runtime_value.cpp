@@ -3,6 +3,7 @@
 
 #include "my/dispatch/closure_value.h"
 #include "my/memory/allocator.h"
+#include "my/serialization/native_runtime_value/native_value_base.h"
 #include "value_roots.h"
 
 namespace my::lua_detail
@@ -523,7 +524,7 @@ namespace my::lua
         const int type = lua_type(l, index);
         const bool isReference = lua_detail::isReferenceType(type);
         const bool keepValueOnStack = keepMode == ValueKeepMode::OnStack;
-        IAllocator* const allocator = keepValueOnStack ? GetRtStackAllocatorPtr() : getDefaultAllocatorPtr();
+        IAllocator* const allocator = keepValueOnStack ? GetRtStackAllocatorPtr() : &ser_detail::getNativeValueAllocator();
         LuaRootPtr root = isReference ? (keepValueOnStack ? LuaStackRoot::instance(l) : LuaGlobalRefRoot::instance(l)) : nullptr;
 
         ChildVariableKey childKey = root ? root->ref(index) : nullptr;
@@ -0,0 +1,154 @@
+// #my_engine_source_file
+
+#include "my/io/asset_pack_builder.h"
+#include "my/io/file_system.h"
+
+using namespace my;
+
+namespace
+{
+    constexpr std::string_view Usage =
+        "Usage: asset_pack_builder <source_dir> <output_pack> [options]\n"
+        "Options:\n"
+        "  --compression <none|lz4|zstd>     default content compression (lz4)\n"
+        "  --ext <extension>=<compression>   compression for the files with the extension, e.g. --ext png=none\n"
+        "  --min-size <bytes>                files smaller than this are stored uncompressed (256)\n"
+        "  --description <text>              asset pack description\n"
+        "  --version <text>                  asset pack version (1)\n";
+
+    struct BuilderOptions
+    {
+        std::filesystem::path sourceDir;
+        std::filesystem::path outputPath;
+        io::AssetPackBuildSettings settings;
+    };
+
+    Result<io::ContentCompression> parseCompression(std::string_view name)
+    {
+        const std::optional<io::ContentCompression> compression = io::parseContentCompression(name);
+        if (!compression)
+        {
+            return MakeError("Unknown compression ({})", name);
+        }
+
+        if (!io::isContentCompressionAvailable(*compression))
+        {
+            return MakeError("Compression ({}) is not available in this build", name);
+        }
+
+        return *compression;
+    }
+
+    Result<BuilderOptions> parseOptions(int argc, char** argv)
+    {
+        BuilderOptions options;
+        std::vector<std::string_view> positional;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            if (!arg.starts_with("--"))
+            {
+                positional.push_back(arg);
+                continue;
+            }
+
+            if (i + 1 >= argc)
+            {
+                return MakeError("Option ({}) requires a value", arg);
+            }
+
+            const std::string_view value = argv[++i];
+            if (arg == "--compression")
+            {
+                Result<io::ContentCompression> compression = parseCompression(value);
+                CheckResult(compression);
+                options.settings.defaultCompression = *compression;
+            }
+            else if (arg == "--ext")
+            {
+                const size_t separatorPos = value.find('=');
+                if (separatorPos == std::string_view::npos)
+                {
+                    return MakeError("Invalid extension rule ({}), expected <extension>=<compression>", value);
+                }
+
+                Result<io::ContentCompression> compression = parseCompression(value.substr(separatorPos + 1));
+                CheckResult(compression);
+                options.settings.compressionByExtension[std::string{value.substr(0, separatorPos)}] = *compression;
+            }
+            else if (arg == "--min-size")
+            {
+                const auto [ptr, error] = std::from_chars(value.data(), value.data() + value.size(), options.settings.minCompressionSize);
+                if (error != std::errc{} || ptr != value.data() + value.size())
+                {
+                    return MakeError("Invalid min size ({})", value);
+                }
+            }
+            else if (arg == "--description")
+            {
+                options.settings.description = value;
+            }
+            else if (arg == "--version")
+            {
+                options.settings.version = value;
+            }
+            else
+            {
+                return MakeError("Unknown option ({})", arg);
+            }
+        }
+
+        if (positional.size() != 2)
+        {
+            return MakeError("Expected source directory and output path");
+        }
+
+        options.sourceDir = positional[0];
+        options.outputPath = positional[1];
+
+        return options;
+    }
+
+    Result<io::AssetPackBuildResult> buildPack(const BuilderOptions& options)
+    {
+        const io::FileSystemPtr sourceFs = io::createNativeFileSystem(options.sourceDir);
+        if (!sourceFs)
+        {
+            return MakeError("Source directory ({}) not exists", options.sourceDir.string());
+        }
+
+        const io::StreamPtr output = io::createNativeFileStream(options.outputPath, io::AccessMode::Read | io::AccessMode::Write, io::OpenFileMode::CreateAlways);
+        if (!output)
+        {
+            return MakeError("Fail to create ({})", options.outputPath.string());
+        }
+
+        return io::buildAssetPack(*sourceFs, "/", *output, options.settings);
+    }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    Result<BuilderOptions> options = parseOptions(argc, argv);
+    if (!options)
+    {
+        std::cerr << options.getError()->getMessage() << "\n\n" << Usage;
+        return 1;
+    }
+
+    const Result<io::AssetPackBuildResult> buildResult = buildPack(*options);
+    if (!buildResult)
+    {
+        std::cerr << std::format("Fail to build asset pack: {}\n", buildResult.getError()->getMessage());
+        return 1;
+    }
+
+    const double ratio = buildResult->sourceSize > 0 ? static_cast<double>(buildResult->packSize) / static_cast<double>(buildResult->sourceSize) : 1.0;
+
+    std::cout << std::format("Asset pack ({}) is built:\n", options->outputPath.string());
+    std::cout << std::format("  files: {}, unique blobs: {}, compressed blobs: {}\n", buildResult->filesCount, buildResult->uniqueBlobsCount, buildResult->compressedBlobsCount);
+    std::cout << std::format("  source size: {}, pack size: {} ({:.1f}%)\n", buildResult->sourceSize, buildResult->packSize, ratio * 100.0);
+
+    return 0;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <charconv>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
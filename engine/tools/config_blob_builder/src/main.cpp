@@ -0,0 +1,64 @@
+// #my_engine_source_file
+
+#include "my/io/file_system.h"
+#include "my/serialization/config_blob.h"
+#include "my/serialization/json.h"
+
+using namespace my;
+
+namespace
+{
+    constexpr std::string_view Usage =
+        "Usage: config_blob_builder <source_config.json> <output.mycfg>\n"
+        "Compiles the json config into the read-only binary image that is loaded without parsing.\n";
+
+    Result<size_t> buildConfigBlob(const std::filesystem::path& sourcePath, const std::filesystem::path& outputPath)
+    {
+        const io::StreamPtr source = io::createNativeFileStream(sourcePath, io::AccessMode::Read, io::OpenFileMode::OpenExisting);
+        if (!source)
+        {
+            return MakeError("Fail to open ({})", sourcePath.string());
+        }
+
+        Result<RuntimeValuePtr> config = serialization::jsonParse(*source);
+        CheckResult(config);
+
+        if (!(*config)->is<ReadonlyDictionary>())
+        {
+            return MakeError("Config ({}) root must be an object", sourcePath.string());
+        }
+
+        const io::StreamPtr output = io::createNativeFileStream(outputPath, io::AccessMode::Read | io::AccessMode::Write, io::OpenFileMode::CreateAlways);
+        if (!output)
+        {
+            return MakeError("Fail to create ({})", outputPath.string());
+        }
+
+        CheckResult(serialization::configBlobWrite(*output, *config));
+
+        return output->getPosition();
+    }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << Usage;
+        return 1;
+    }
+
+    const std::filesystem::path sourcePath = argv[1];
+    const std::filesystem::path outputPath = argv[2];
+
+    const Result<size_t> blobSize = buildConfigBlob(sourcePath, outputPath);
+    if (!blobSize)
+    {
+        std::cerr << std::format("Fail to build config blob: {}\n", blobSize.getError()->getMessage());
+        return 1;
+    }
+
+    std::cout << std::format("Config blob ({}) is built: {} bytes\n", outputPath.string(), *blobSize);
+
+    return 0;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>